@@ -10,6 +10,7 @@
 #include <cvframe.h>
 #include <nap/logger.h>
 #include <mathutils.h>
+#include <pixelconversion.h>
 
 // nap::cvdisplaycapturecomponent run time class definition 
 RTTI_BEGIN_CLASS(nap::CaptureToTextureComponent)
@@ -70,8 +71,8 @@ namespace nap
 		if (!errorState.check(mBlobsUniform != nullptr, "%s: missing 'blobs' uniform", mID.c_str()))
 			return false;
 
-		// Add 1 matrix
-		mConversionFrame.addNew();
+		// Allocate RGBA conversion buffer
+		mConversionBuffer.resize(mRenderTexture->getDescriptor().getSizeInBytes());
 		return true;
 	}
 
@@ -128,10 +129,20 @@ namespace nap
 			return;
 		}
 		
-		// Convert to RGBA, required by the Texture2D
-		cv::cvtColor(cv_frame[mMatrixIndex], mConversionFrame[0], cv::COLOR_RGB2RGBA);
+		// Ensure frame holds 8 bit RGB pixels
+		cv::Mat source = cv_frame[mMatrixIndex].getMat(cv::ACCESS_READ);
+		if (source.type() != CV_8UC3)
+		{
+			nap::Logger::warn("%s: invalid format, expected 8 bit RGB", mID.c_str());
+			return;
+		}
+
+		// Convert to RGBA, required by the Texture2D, line by line because matrix rows can be padded
+		int target_pitch = mRenderTexture->getDescriptor().getPitch();
+		for (int y = 0; y < source.rows; y++)
+			pixel::addAlpha(source.ptr<uint8>(y), mConversionBuffer.data() + y * target_pitch, source.cols);
 
 		// Update texture on GPU
-		mRenderTexture->update(mConversionFrame[0].getMat(cv::ACCESS_READ).data, mRenderTexture->getDescriptor());
+		mRenderTexture->update(mConversionBuffer.data(), mRenderTexture->getDescriptor());
 	}
 }
\ No newline at end of file
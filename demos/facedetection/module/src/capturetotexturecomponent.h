@@ -90,6 +90,6 @@ namespace nap
 		int mMatrixIndex = 0;									///< OpenCV sample matrix, defaults to 0
 		UniformIntInstance* mBlobCountUniform = nullptr;		///< OpenCV blob count uniform
 		UniformStructArrayInstance* mBlobsUniform = nullptr;	///< Blobs uniform struct array
-		CVFrame mConversionFrame;
+		std::vector<uint8> mConversionBuffer;					///< Captured frame converted to RGBA
 	};
 }
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "convolutioncomponent.h"
+
+// Nap includes
+#include <entity.h>
+#include <nap/core.h>
+
+// Audio includes
+#include <audio/service/audioservice.h>
+
+// RTTI
+RTTI_BEGIN_CLASS(nap::audio::ConvolutionComponent)
+	RTTI_PROPERTY("Input", &nap::audio::ConvolutionComponent::mInput, nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("ImpulseResponse", &nap::audio::ConvolutionComponent::mImpulseResponse, nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("BackgroundProcessing", &nap::audio::ConvolutionComponent::mBackgroundProcessing, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MaxPartitionSize", &nap::audio::ConvolutionComponent::mMaxPartitionSize, nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::ConvolutionComponentInstance)
+	RTTI_CONSTRUCTOR(nap::EntityInstance &, nap::Component &)
+	RTTI_FUNCTION("getLateBlockCount", &nap::audio::ConvolutionComponentInstance::getLateBlockCount)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		bool ConvolutionComponentInstance::init(utility::ErrorState& errorState)
+		{
+			auto resource = getComponent<ConvolutionComponent>();
+			auto& nodeManager = getEntityInstance()->getCore()->getService<AudioService>()->getNodeManager();
+			
+			if (!errorState.check(mInput->getChannelCount() > 0, "%s: Input has no channels", resource->mID.c_str()))
+				return false;
+			
+			if (!errorState.check(resource->mImpulseResponse->getChannelCount() > 0, "%s: Impulse response has no channels", resource->mID.c_str()))
+				return false;
+			
+			if (!errorState.check(resource->mMaxPartitionSize > 0, "%s: MaxPartitionSize has to be larger than 0", resource->mID.c_str()))
+				return false;
+			
+			for (auto channel = 0; channel < resource->mImpulseResponse->getChannelCount(); ++channel)
+			{
+				auto node = nodeManager.makeSafe<ConvolutionNode>(nodeManager, resource->mImpulseResponse->getBuffer(), channel, resource->mBackgroundProcessing, resource->mMaxPartitionSize);
+				node->audioInput.connect(*mInput->getOutputForChannel(channel % mInput->getChannelCount()));
+				mNodes.emplace_back(std::move(node));
+			}
+			
+			return true;
+		}
+		
+		
+		int ConvolutionComponentInstance::getLateBlockCount() const
+		{
+			uint64 result = 0;
+			for (auto& node : mNodes)
+				result += node->getLateBlockCount();
+			return int(result);
+		}
+		
+	}
+}
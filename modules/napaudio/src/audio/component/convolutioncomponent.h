@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Nap includes
+#include <nap/resourceptr.h>
+#include <audio/utility/safeptr.h>
+
+// Audio includes
+#include <audio/component/audiocomponentbase.h>
+#include <audio/resource/audiobufferresource.h>
+#include <audio/node/convolutionnode.h>
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		class ConvolutionComponentInstance;
+		
+		
+		/**
+		 * Component that convolves the output of an @AudioComponentBase with a multichannel impulse response, for example loaded from an @AudioFileResource.
+		 * Every channel of the impulse response produces one output channel. Output channel c convolves input channel (c modulo the number of input channels),
+		 * so a mono input with a stereo impulse response results in a stereo reverb.
+		 */
+		class NAPAPI ConvolutionComponent : public AudioComponentBase
+		{
+			RTTI_ENABLE(AudioComponentBase)
+			DECLARE_COMPONENT(ConvolutionComponent, ConvolutionComponentInstance)
+			
+		public:
+			ConvolutionComponent() : AudioComponentBase() { }
+			
+			nap::ComponentPtr<AudioComponentBase> mInput; ///< property: 'Input' The component whose audio output will be convolved.
+			ResourcePtr<AudioBufferResource> mImpulseResponse = nullptr; ///< property: 'ImpulseResponse' Buffer containing the impulse response, one channel per output channel.
+			bool mBackgroundProcessing = true; ///< property: 'BackgroundProcessing' If set to true the tail of the impulse response is calculated on a worker thread.
+			int mMaxPartitionSize = 8192; ///< property: 'MaxPartitionSize' The largest partition size in samples used for the tail of the impulse response.
+		};
+		
+		
+		/**
+		 * Instance of @ConvolutionComponent
+		 */
+		class NAPAPI ConvolutionComponentInstance : public AudioComponentBaseInstance
+		{
+			RTTI_ENABLE(AudioComponentBaseInstance)
+		public:
+			ConvolutionComponentInstance(EntityInstance& entity, Component& resource) : AudioComponentBaseInstance(entity, resource) { }
+			
+			// Inherited from ComponentInstance
+			bool init(utility::ErrorState& errorState) override;
+			
+			// Inherited from AudioComponentBaseInstance
+			int getChannelCount() const override { return mNodes.size(); }
+			OutputPin* getOutputForChannel(int channel) override { return &mNodes[channel]->audioOutput; }
+			
+			/**
+			 * @return the total number of blocks of all channels where the tail of the impulse response was left out because the worker thread was late.
+			 */
+			int getLateBlockCount() const;
+			
+		private:
+			ComponentInstancePtr<AudioComponentBase> mInput = {this, &ConvolutionComponent::mInput}; // Pointer to component that outputs this components audio input
+			std::vector<SafeOwner<ConvolutionNode>> mNodes; // Node for each channel of the impulse response
+		};
+		
+	}
+}
@@ -0,0 +1,32 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "voicepoolcomponent.h"
+
+// Nap includes
+#include <entity.h>
+
+// RTTI
+RTTI_BEGIN_CLASS(nap::audio::VoicePoolComponent)
+	RTTI_PROPERTY("VoicePool", &nap::audio::VoicePoolComponent::mVoicePool, nap::rtti::EPropertyMetaData::Required)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::VoicePoolComponentInstance)
+	RTTI_CONSTRUCTOR(nap::EntityInstance &, nap::Component &)
+	RTTI_FUNCTION("getVoicePool", &nap::audio::VoicePoolComponentInstance::getVoicePool)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		bool VoicePoolComponentInstance::init(utility::ErrorState& errorState)
+		{
+			mVoicePool = getComponent<VoicePoolComponent>()->mVoicePool.get();
+			return true;
+		}
+		
+	}
+}
@@ -0,0 +1,64 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Nap includes
+#include <nap/resourceptr.h>
+
+// Audio includes
+#include <audio/component/audiocomponentbase.h>
+#include <audio/resource/voicepool.h>
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		class VoicePoolComponentInstance;
+		
+		
+		/**
+		 * Component that outputs the mixed voices of a @VoicePool.
+		 * Can be used as input to an @OutputComponent or @LevelMeterComponent.
+		 */
+		class NAPAPI VoicePoolComponent : public AudioComponentBase
+		{
+			RTTI_ENABLE(AudioComponentBase)
+			DECLARE_COMPONENT(VoicePoolComponent, VoicePoolComponentInstance)
+			
+		public:
+			VoicePoolComponent() : AudioComponentBase() { }
+			
+			ResourcePtr<VoicePool> mVoicePool = nullptr; ///< property: 'VoicePool' The voice pool whose output this component exposes
+		};
+		
+		
+		/**
+		 * Instance of @VoicePoolComponent
+		 */
+		class NAPAPI VoicePoolComponentInstance : public AudioComponentBaseInstance
+		{
+			RTTI_ENABLE(AudioComponentBaseInstance)
+		public:
+			VoicePoolComponentInstance(EntityInstance& entity, Component& resource) : AudioComponentBaseInstance(entity, resource) { }
+			
+			// Inherited from ComponentInstance
+			bool init(utility::ErrorState& errorState) override;
+			
+			// Inherited from AudioComponentBaseInstance
+			int getChannelCount() const override { return mVoicePool->getChannelCount(); }
+			OutputPin* getOutputForChannel(int channel) override { return mVoicePool->getOutputForChannel(channel); }
+			
+			/**
+			 * @return the voice pool, used to trigger and release voices.
+			 */
+			VoicePool& getVoicePool() { return *mVoicePool; }
+			
+		private:
+			VoicePool* mVoicePool = nullptr;
+		};
+		
+	}
+}
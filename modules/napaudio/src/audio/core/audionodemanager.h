@@ -23,6 +23,7 @@ namespace nap
 		
 		// Forward declarations
 		class Node;
+		class AudioProfiler;
 		
 		/**
 		 * The audio node manager represents a node system for audio processing.
@@ -178,6 +179,17 @@ namespace nap
 				return owner;
 			}
 			
+			/**
+			 * Sets the profiler that measures the time spent in the process() method of each process, nullptr disables profiling.
+			 * The profiler has to outlive the node manager or be removed before it is destroyed. Call before the audio stream is started.
+			 */
+			void setProfiler(AudioProfiler* profiler) { mProfiler = profiler; }
+			
+			/**
+			 * @return the profiler that measures the processes of this node manager, nullptr if there is none.
+			 */
+			AudioProfiler* getProfiler() const { return mProfiler; }
+			
 			/**
 			 * Returns the DeletionQueue that this node manager uses to construct and destruct nodes or other processes on the audio thread safely.
 			 */
@@ -235,6 +247,7 @@ namespace nap
 			
 			nap::TaskQueue mTaskQueue = { 256 }; // Queue with lambda functions to be executed before processing the next itnernal buffer.
 			DeletionQueue& mDeletionQueue; // Deletion queue used to safely create and destruct nodes in a threadsafe manner.
+			AudioProfiler* mProfiler = nullptr; // Optional profiler that measures the processes
 		};
 		
 	}
@@ -0,0 +1,161 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "audioprofiler.h"
+
+// Std includes
+#include <algorithm>
+
+// Audio includes
+#include <audio/core/process.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		namespace
+		{
+			// Weight of the last callback in the moving average of the load
+			constexpr float averageWeight = 0.05f;
+
+			int64 toMicroseconds(AudioProfiler::Clock::time_point time)
+			{
+				return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+			}
+		}
+
+
+		AudioProfiler::AudioProfiler(int maxProcessTimingCount) :
+			mProcessTimings(ProcessTimings { std::vector<ProcessTiming>(maxProcessTimingCount), 0 })
+		{
+		}
+
+
+		bool AudioProfiler::update()
+		{
+			if (mProcessTimings.update())
+			{
+				// Sum the timings per process and sort them from expensive to cheap
+				auto& timings = mProcessTimings.getReadBuffer();
+				mSortedProcessTimings.clear();
+				for (auto i = 0; i < timings.mCount; ++i)
+				{
+					auto& timing = timings.mTimings[i];
+					auto it = std::find_if(mSortedProcessTimings.begin(), mSortedProcessTimings.end(), [&](const ProcessTiming& entry) { return entry.mProcess == timing.mProcess; });
+					if (it == mSortedProcessTimings.end())
+						mSortedProcessTimings.emplace_back(timing);
+					else
+						it->mDuration += timing.mDuration;
+				}
+				std::sort(mSortedProcessTimings.begin(), mSortedProcessTimings.end(), [](const ProcessTiming& a, const ProcessTiming& b) { return a.mDuration > b.mDuration; });
+			}
+			return mStatistics.update();
+		}
+
+
+		double AudioProfiler::getTimeSinceLastCallback() const
+		{
+			auto lastCallbackTime = mLastCallbackTime.load();
+			if (lastCallbackTime == 0)
+				return -1.0;
+			return (toMicroseconds(Clock::now()) - lastCallbackTime) / 1000.0;
+		}
+
+
+		void AudioProfiler::beginCallback(unsigned long framesPerBuffer, float sampleRate)
+		{
+			mCallbackStart = Clock::now();
+
+			if (mResetRequested.exchange(false))
+			{
+				mCurrent = AudioStatistics();
+				mProfiledCallbackCounter = 0;
+			}
+			mCurrent.mPeriod = sampleRate > 0 ? 1000000.f * framesPerBuffer / sampleRate : 0.f;
+
+			// Decide whether to time the processes during this callback
+			auto interval = mProcessTimingInterval.load();
+			if (interval > 0 && (mProfiledCallbackCounter++ % interval) == 0)
+			{
+				mProcessTimingCount.store(0);
+				mTimingProcesses.store(true);
+			}
+		}
+
+
+		void AudioProfiler::endCallback()
+		{
+			auto end = Clock::now();
+			auto duration = std::chrono::duration<float, std::micro>(end - mCallbackStart).count();
+
+			if (mTimingProcesses.load())
+			{
+				mTimingProcesses.store(false);
+				auto& timings = mProcessTimings.getWriteBuffer();
+				timings.mCount = std::min<int>(mProcessTimingCount.load(), timings.mTimings.size());
+				mProcessTimings.publish();
+			}
+
+			auto load = mCurrent.mPeriod > 0.f ? duration / mCurrent.mPeriod : 0.f;
+			auto bucket = std::min(int(load * 10.f), AudioStatistics::histogramSize - 1);
+			mCurrent.mHistogram[bucket]++;
+			mCurrent.mCallbackCount++;
+			if (load >= 1.f)
+				mCurrent.mOverloadCount++;
+			mCurrent.mDuration = duration;
+			mCurrent.mLoad = load;
+			mCurrent.mAverageLoad = mCurrent.mCallbackCount == 1 ? load : mCurrent.mAverageLoad + averageWeight * (load - mCurrent.mAverageLoad);
+			mCurrent.mPeakLoad = std::max(mCurrent.mPeakLoad, load);
+
+			mStatistics.getWriteBuffer() = mCurrent;
+			mStatistics.publish();
+			mLastCallbackTime.store(toMicroseconds(end));
+		}
+
+
+		void AudioProfiler::countXRuns(bool inputUnderflow, bool inputOverflow, bool outputUnderflow, bool outputOverflow)
+		{
+			mCurrent.mInputUnderflowCount += inputUnderflow ? 1 : 0;
+			mCurrent.mInputOverflowCount += inputOverflow ? 1 : 0;
+			mCurrent.mOutputUnderflowCount += outputUnderflow ? 1 : 0;
+			mCurrent.mOutputOverflowCount += outputOverflow ? 1 : 0;
+		}
+
+
+		// Time spent in child processes of the process that is being measured on this thread, in microseconds
+		static thread_local float sChildTime = 0.f;
+
+
+		AudioProfiler::ProcessScope AudioProfiler::beginProcess()
+		{
+			ProcessScope scope;
+			scope.mOuterChildTime = sChildTime;
+			sChildTime = 0.f;
+			scope.mStart = Clock::now();
+			return scope;
+		}
+
+
+		void AudioProfiler::endProcess(const Process& process, const ProcessScope& scope)
+		{
+			auto duration = std::chrono::duration<float, std::micro>(Clock::now() - scope.mStart).count();
+			auto selfTime = std::max(0.f, duration - sChildTime);
+
+			// The total time of this process is child time of the enclosing process
+			sChildTime = scope.mOuterChildTime + duration;
+
+			auto& timings = mProcessTimings.getWriteBuffer();
+			auto index = mProcessTimingCount.fetch_add(1);
+			if (index < timings.mTimings.size())
+			{
+				auto& timing = timings.mTimings[index];
+				timing.mProcess = &process;
+				timing.mTypeName = process.get_type().get_name().data();
+				timing.mDuration = selfTime;
+			}
+		}
+
+	}
+}
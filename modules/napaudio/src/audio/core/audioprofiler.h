@@ -0,0 +1,199 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// Nap includes
+#include <utility/dllexport.h>
+#include <utility/triplebuffer.h>
+#include <nap/numeric.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		// Forward declarations
+		class Process;
+
+
+		/**
+		 * Snapshot of the performance of the audio callback, published by the AudioProfiler.
+		 * Loads are expressed as the duration of a callback divided by the duration of the audio it produces:
+		 * a load of 1 or more means the callback did not finish in time.
+		 */
+		struct NAPAPI AudioStatistics
+		{
+			static constexpr int histogramSize = 20;			///< Number of buckets of the load histogram, each bucket spans 10% load
+
+			std::array<uint64, histogramSize> mHistogram;		///< Number of callbacks per load bucket, the last bucket also holds all callbacks above its range
+			uint64 mCallbackCount = 0;							///< Total number of callbacks
+			uint64 mOverloadCount = 0;							///< Number of callbacks that took longer than the duration of their buffer
+			uint64 mInputUnderflowCount = 0;					///< Input underflows reported by the audio driver
+			uint64 mInputOverflowCount = 0;						///< Input overflows reported by the audio driver
+			uint64 mOutputUnderflowCount = 0;					///< Output underflows (dropouts) reported by the audio driver
+			uint64 mOutputOverflowCount = 0;					///< Output overflows reported by the audio driver
+			float mLoad = 0.f;									///< Load of the last callback
+			float mAverageLoad = 0.f;							///< Exponential moving average of the load
+			float mPeakLoad = 0.f;								///< Highest load since the last reset
+			float mDuration = 0.f;								///< Duration of the last callback in microseconds
+			float mPeriod = 0.f;								///< Duration of the audio produced by the last callback in microseconds
+
+			AudioStatistics() { mHistogram.fill(0); }
+
+			/**
+			 * @return the total number of xruns reported by the driver
+			 */
+			uint64 getXRunCount() const { return mInputUnderflowCount + mInputOverflowCount + mOutputUnderflowCount + mOutputOverflowCount; }
+		};
+
+
+		/**
+		 * Time spent in the process() method of a single node or process during one profiled callback.
+		 */
+		struct NAPAPI ProcessTiming
+		{
+			const Process* mProcess = nullptr;					///< Identifies the process, only to be used for comparison as the process might be destroyed
+			const char* mTypeName = "";							///< Name of the type of the process
+			float mDuration = 0.f;								///< Self time in microseconds, excluding the time spent updating the inputs that are pulled
+		};
+
+
+		/**
+		 * Measures the performance of the audio callback without locking or allocating on the audio thread.
+		 * The audio thread measures the duration of every callback and counts driver xruns,
+		 * every N callbacks it also measures the time spent in the process() method of every node.
+		 * Results are published as snapshots through lock-free triple buffers that are acquired on the main thread by calling update().
+		 * Only one thread is allowed to call the main thread methods.
+		 */
+		class NAPAPI AudioProfiler final
+		{
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			/**
+			 * @param maxProcessTimingCount maximum number of process timings recorded per profiled callback, further timings are dropped.
+			 */
+			AudioProfiler(int maxProcessTimingCount = 1024);
+
+			// --- Main thread --- //
+
+			/**
+			 * Acquires the latest snapshots published by the audio thread.
+			 * @return true if new statistics have been acquired
+			 */
+			bool update();
+
+			/**
+			 * @return the statistics acquired by the last call to update()
+			 */
+			const AudioStatistics& getStatistics() const { return mStatistics.getReadBuffer(); }
+
+			/**
+			 * @return the time spent per node during the last profiled callback acquired by update(), sorted by descending duration.
+			 * Timings of a node that is processed multiple times within one callback are summed.
+			 */
+			const std::vector<ProcessTiming>& getProcessTimings() const { return mSortedProcessTimings; }
+
+			/**
+			 * Enables per node timing every interval callbacks. Measuring adds a small overhead to profiled callbacks.
+			 * @param interval number of callbacks between two profiled callbacks, 0 disables per node timing.
+			 */
+			void setProcessTimingInterval(int interval) { mProcessTimingInterval.store(interval); }
+
+			/**
+			 * @return the number of callbacks between two profiled callbacks, 0 if per node timing is disabled.
+			 */
+			int getProcessTimingInterval() const { return mProcessTimingInterval.load(); }
+
+			/**
+			 * Clears all counters, the histogram and the peak load on the next callback.
+			 */
+			void reset() { mResetRequested.store(true); }
+
+			/**
+			 * @return time in milliseconds since the last callback finished, or -1 if no callback has finished yet.
+			 */
+			double getTimeSinceLastCallback() const;
+
+			// --- Audio thread --- //
+
+			/**
+			 * Call at the start of the audio callback.
+			 * @param framesPerBuffer number of frames processed by the callback
+			 * @param sampleRate the sample rate of the stream
+			 */
+			void beginCallback(unsigned long framesPerBuffer, float sampleRate);
+
+			/**
+			 * Call at the end of the audio callback, publishes the statistics.
+			 */
+			void endCallback();
+
+			/**
+			 * Counts the xruns reported by the audio driver for the current callback.
+			 */
+			void countXRuns(bool inputUnderflow, bool inputOverflow, bool outputUnderflow, bool outputOverflow);
+
+			/**
+			 * @return true if process timings have to be recorded during the current callback.
+			 */
+			bool isTimingProcesses() const { return mTimingProcesses.load(std::memory_order_relaxed); }
+
+			/**
+			 * Started measurement of a process, returned by beginProcess().
+			 */
+			struct ProcessScope
+			{
+				Clock::time_point mStart;						///< Time at which process() was called
+				float mOuterChildTime = 0.f;					///< Child time of the enclosing process, restored by endProcess()
+			};
+
+			/**
+			 * Starts measuring a process, call right before process().
+			 * Processes that are updated while this process runs, the inputs it pulls, are measured as children.
+			 * @return the scope to pass to endProcess()
+			 */
+			ProcessScope beginProcess();
+
+			/**
+			 * Records the self time of a process: the time since beginProcess() minus the time spent in its children.
+			 * Can be called from multiple threads of a parallel ParentProcess simultaneously.
+			 * Time a parallel parent spends waiting for its worker threads is counted as its own.
+			 * @param process the process that has been processed
+			 * @param scope the scope returned by beginProcess()
+			 */
+			void endProcess(const Process& process, const ProcessScope& scope);
+
+		private:
+			// Timings recorded during one profiled callback
+			struct ProcessTimings
+			{
+				std::vector<ProcessTiming> mTimings;
+				int mCount = 0;
+			};
+
+			utility::TripleBuffer<AudioStatistics> mStatistics;
+			utility::TripleBuffer<ProcessTimings> mProcessTimings;
+			std::vector<ProcessTiming> mSortedProcessTimings;		// Aggregated timings on the main thread
+
+			AudioStatistics mCurrent;								// Statistics accumulated on the audio thread
+			Clock::time_point mCallbackStart;
+			uint64 mProfiledCallbackCounter = 0;
+			std::atomic<bool> mTimingProcesses = { false };
+			std::atomic<int> mProcessTimingCount = { 0 };
+
+			std::atomic<int> mProcessTimingInterval = { 0 };
+			std::atomic<bool> mResetRequested = { false };
+			std::atomic<int64> mLastCallbackTime = { 0 };			// Time since the clock's epoch in microseconds, 0 before the first callback
+		};
+
+	}
+}
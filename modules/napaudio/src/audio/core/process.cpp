@@ -7,6 +7,7 @@
 #include <audio/core/audionode.h>
 #include <audio/core/audionodemanager.h>
 #include <audio/core/audiopin.h>
+#include <audio/core/audioprofiler.h>
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::Process)
 RTTI_END_CLASS
@@ -29,7 +30,15 @@ namespace nap
 		{
 			if (mLastCalculatedSample < getSampleTime())
 			{
-				process();
+				auto profiler = getNodeManager().getProfiler();
+				if (profiler != nullptr && profiler->isTimingProcesses())
+				{
+					auto scope = profiler->beginProcess();
+					process();
+					profiler->endProcess(*this, scope);
+				}
+				else
+					process();
 				mLastCalculatedSample = getSampleTime();
 			}
 		}
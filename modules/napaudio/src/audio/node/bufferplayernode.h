@@ -86,6 +86,11 @@ namespace nap
 			 * @return the current playback channel within the source buffer.
 			 */
 			int getChannel() const { return mChannel; }
+			
+			/**
+			 * @return whether the node is currently playing. Becomes false when the end of the buffer has been reached.
+			 */
+			bool isPlaying() const { return mPlaying; }
 		
 		private:
 			// Inherited from Node
@@ -19,7 +19,7 @@ namespace nap
 	namespace audio
 	{
 		
-		ControlNode::ControlNode(NodeManager& manager) : Node(manager)
+		ControlNode::ControlNode(NodeManager& manager, unsigned int eventQueueCapacity) : Node(manager), mEvents(eventQueueCapacity)
 		{
 			mValue.destinationReachedSignal.connect(mDestinationReachedSlot);
 		}
@@ -60,21 +60,72 @@ namespace nap
 		}
 		
 		
+		bool ControlNode::scheduleValue(ControllerValue value, DiscreteTimeValue time)
+		{
+			ParameterEvent event;
+			event.mTime = time;
+			event.mValue = value;
+			return mEvents.enqueue(event);
+		}
+		
+		
+		bool ControlNode::scheduleRamp(ControllerValue destination, TimeValue rampTime, DiscreteTimeValue time, RampMode mode)
+		{
+			ParameterEvent event;
+			event.mTime = time;
+			event.mValue = destination;
+			event.mStepCount = rampTime * getNodeManager().getSamplesPerMillisecond();
+			event.mMode = mode;
+			return mEvents.enqueue(event);
+		}
+		
+		
 		void ControlNode::process()
 		{
 			update();
+			mEvents.collect();
+			
 			auto& outputBuffer = getOutputBuffer(output);
+			auto size = int(outputBuffer.size());
+			auto sampleTime = getSampleTime();
+			
+			// Render the buffer in segments, applying scheduled events at the sample they are due.
+			auto position = 0;
+			while (position < size)
+			{
+				ParameterEvent event;
+				while (mEvents.popDueEvent(sampleTime + position, event))
+					applyEvent(event);
+				
+				auto end = position + mEvents.getSamplesUntilNextEvent(sampleTime + position, size - position);
+				render(outputBuffer, position, end);
+				position = end;
+			}
 			
+			mCurrentValue.store(mValue.getValue());
+		}
+		
+		
+		void ControlNode::render(SampleBuffer& outputBuffer, int begin, int end)
+		{
 			if (mTranslator != nullptr) {
-				for (auto i = 0; i < outputBuffer.size(); ++i) {
+				for (auto i = begin; i < end; ++i) {
 					outputBuffer[i] = mTranslator->translate(mValue.getNextValue());
 				}
 			} else {
-				for (auto i = 0; i < outputBuffer.size(); ++i) {
+				for (auto i = begin; i < end; ++i) {
 					outputBuffer[i] = mValue.getNextValue();
 				}
 			}
-			mCurrentValue.store(mValue.getValue());
+		}
+		
+		
+		void ControlNode::applyEvent(const ParameterEvent& event)
+		{
+			if (event.mStepCount > 0)
+				mValue.ramp(event.mValue, event.mStepCount, event.mMode);
+			else
+				mValue.setValue(event.mValue);
 		}
 		
 		
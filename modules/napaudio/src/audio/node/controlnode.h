@@ -14,6 +14,7 @@
 #include <audio/utility/rampedvalue.h>
 #include <audio/utility/translator.h>
 #include <audio/utility/safeptr.h>
+#include <audio/utility/parametereventqueue.h>
 #include <audio/core/audionode.h>
 #include <audio/core/audionodemanager.h>
 
@@ -26,6 +27,8 @@ namespace nap
 		 * Used to generate a control signal by ramping between different values.
 		 * Ramps can be either linear or exponential.
 		 * Optionally a lookup table can be used to shape the output signal.
+		 * Besides the immediate setValue() and ramp() calls, value changes can be scheduled at an absolute sample time using scheduleValue() and scheduleRamp().
+		 * Scheduled changes are passed to the audio thread through a preallocated lock-free queue and are applied at the exact sample.
 		 */
 		class NAPAPI ControlNode : public Node
 		{
@@ -35,7 +38,7 @@ namespace nap
 			/**
 			 * @param nodeManager NodeManager this node runs on
 			 */
-			ControlNode(NodeManager& manager);
+			ControlNode(NodeManager& manager, unsigned int eventQueueCapacity = 256);
 			
 			/**
 			 * The output signal pin
@@ -76,6 +79,26 @@ namespace nap
 			 */
 			void stop();
 			
+			/**
+			 * Schedules the output to jump to a value at an exact sample time.
+			 * Call from one control thread only, for example the main thread or a sequencer thread.
+			 * @param value the new value
+			 * @param time absolute sample time on the node manager's clock, see NodeManager::getSampleTime(). Times in the past are applied at the start of the next buffer.
+			 * @return false if the event queue is full and the event has been discarded.
+			 */
+			bool scheduleValue(ControllerValue value, DiscreteTimeValue time);
+			
+			/**
+			 * Schedules a ramp to start at an exact sample time.
+			 * Call from one control thread only, for example the main thread or a sequencer thread.
+			 * @param destination the destination value of the ramp
+			 * @param rampTime time in milliseconds to reach the destination
+			 * @param time absolute sample time on the node manager's clock at which the ramp starts.
+			 * @param mode choose between linear or exponential curvature
+			 * @return false if the event queue is full and the event has been discarded.
+			 */
+			bool scheduleRamp(ControllerValue destination, TimeValue rampTime, DiscreteTimeValue time, RampMode mode = RampMode::Linear);
+			
 			/**
 			 * Assign a translator to this node to shape the output value.
 			 */
@@ -96,6 +119,12 @@ namespace nap
 			
 			void update();
 			
+			// Renders the output in between two scheduled events
+			void render(SampleBuffer& outputBuffer, int begin, int end);
+			
+			// Applies a scheduled event on the audio thread
+			void applyEvent(const ParameterEvent& event);
+			
 			// Slot called internally when the destination of a ramp has been reached.
 			nap::Slot<ControllerValue> mDestinationReachedSlot = {this, &ControlNode::destinationReached};
 			
@@ -113,6 +142,7 @@ namespace nap
 			RampedValue<ControllerValue> mValue = {0.f}; // Current output value of the node.
 			std::atomic<ControllerValue> mCurrentValue = {0.f};
 			SafePtr<Translator<ControllerValue>> mTranslator = nullptr; // Helper object to apply a translation to the output value.
+			ParameterEventQueue mEvents; // Scheduled value changes, applied sample accurately in process()
 		};
 		
 	}
@@ -0,0 +1,95 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "convolutionnode.h"
+
+// Std includes
+#include <chrono>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::ConvolutionNode)
+	RTTI_PROPERTY("audioInput", &nap::audio::ConvolutionNode::audioInput, nap::rtti::EPropertyMetaData::Embedded)
+	RTTI_PROPERTY("audioOutput", &nap::audio::ConvolutionNode::audioOutput, nap::rtti::EPropertyMetaData::Embedded)
+	RTTI_FUNCTION("getLateBlockCount", &nap::audio::ConvolutionNode::getLateBlockCount)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+
+		ConvolutionNode::ConvolutionNode(NodeManager& manager, SafePtr<MultiSampleBuffer> impulseResponse, int channel, bool backgroundProcessing, int maxPartitionSize) :
+			Node(manager), mImpulseResponse(std::move(impulseResponse)), mChannel(channel), mBackgroundProcessing(backgroundProcessing), mMaxPartitionSize(maxPartitionSize)
+		{
+			assert(mImpulseResponse != nullptr && mChannel < mImpulseResponse->getChannelCount());
+
+			// The node manager has already passed the buffer size to the base class, so the convolver is created here
+			createConvolver(getBufferSize());
+
+			if (mBackgroundProcessing)
+			{
+				mRunning = true;
+				mThread = std::thread([&](){ runBackground(); });
+			}
+		}
+
+
+		ConvolutionNode::~ConvolutionNode()
+		{
+			if (mThread.joinable())
+			{
+				mRunning = false;
+				mCondition.notify_one();
+				mThread.join();
+			}
+		}
+
+
+		void ConvolutionNode::process()
+		{
+			auto& outputBuffer = getOutputBuffer(audioOutput);
+			SampleBuffer* inputBuffer = audioInput.pull();
+			if (inputBuffer == nullptr)
+				inputBuffer = &mSilence;
+
+			// Wake up the worker thread without taking the lock, a missed notification is picked up by its timeout
+			if (mConvolver->process(inputBuffer->data(), outputBuffer.data()))
+				mCondition.notify_one();
+
+			mLateBlockCount.store(mPreviousLateBlockCount + mConvolver->getLateBlockCount());
+		}
+
+
+		void ConvolutionNode::bufferSizeChanged(int bufferSize)
+		{
+			if (mConvolver != nullptr && mConvolver->getBlockSize() == bufferSize)
+				return;
+
+			// Wait for the worker thread to finish calculating before replacing the convolver
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mConvolver != nullptr)
+				mPreviousLateBlockCount += mConvolver->getLateBlockCount();
+			createConvolver(bufferSize);
+		}
+
+
+		void ConvolutionNode::createConvolver(int bufferSize)
+		{
+			mConvolver = std::make_unique<Convolver>((*mImpulseResponse)[mChannel], bufferSize, mBackgroundProcessing, mMaxPartitionSize);
+			mSilence.resize(bufferSize, 0.f);
+		}
+
+
+		void ConvolutionNode::runBackground()
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			while (mRunning)
+			{
+				// Keep calculating as long as there is work, the audio thread may have posted more while calculating
+				while (mConvolver->processBackground());
+				mCondition.wait_for(lock, std::chrono::milliseconds(1));
+			}
+		}
+
+	}
+}
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Nap includes
+#include <audio/utility/safeptr.h>
+
+// Audio includes
+#include <audio/core/audionode.h>
+#include <audio/core/audionodemanager.h>
+#include <audio/utility/convolver.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Convolves the input signal with one channel of an impulse response, for example to apply the reverb of a recorded room.
+		 * The output has no latency: the start of the impulse response is convolved within the audio callback using the buffer size of the node manager,
+		 * while the tail is divided into increasingly larger partitions. See @Convolver for a description of the algorithm.
+		 * When background processing is enabled the large partitions are calculated on a worker thread owned by the node,
+		 * which keeps the cost of the audio callback low and constant for impulse responses of several seconds.
+		 * If the worker thread can not keep up, the tail is left out for the blocks that were late and the late block count is increased.
+		 * The convolver is rebuilt when the buffer size changes, which allocates memory and transforms the impulse response.
+		 */
+		class NAPAPI ConvolutionNode : public Node
+		{
+			RTTI_ENABLE(Node)
+
+		public:
+			/**
+			 * @param manager the node manager
+			 * @param impulseResponse buffer containing the impulse response
+			 * @param channel channel of the impulse response buffer to convolve with
+			 * @param backgroundProcessing true to calculate the tail of the impulse response on a worker thread
+			 * @param maxPartitionSize the largest partition size in samples used for the tail of the impulse response
+			 */
+			ConvolutionNode(NodeManager& manager, SafePtr<MultiSampleBuffer> impulseResponse, int channel, bool backgroundProcessing = true, int maxPartitionSize = 8192);
+
+			// Stops the worker thread
+			~ConvolutionNode() override;
+
+			/**
+			 * The input signal to be convolved
+			 */
+			InputPin audioInput = {this};
+
+			/**
+			 * Outputs the convolved signal
+			 */
+			OutputPin audioOutput = {this};
+
+			/**
+			 * @return the number of blocks where the tail of the impulse response was left out because the worker thread was late.
+			 */
+			uint64 getLateBlockCount() const { return mLateBlockCount.load(); }
+
+			/**
+			 * @return true if the tail of the impulse response is calculated on a worker thread.
+			 */
+			bool isBackgroundProcessing() const { return mBackgroundProcessing; }
+
+		private:
+			// Inherited from Node
+			void process() override;
+			void bufferSizeChanged(int bufferSize) override;
+
+			// Creates the convolver for the given buffer size
+			void createConvolver(int bufferSize);
+
+			// Loop of the worker thread
+			void runBackground();
+
+			SafePtr<MultiSampleBuffer> mImpulseResponse = nullptr; // Buffer containing the impulse response
+			int mChannel = 0; // Channel of the impulse response
+			bool mBackgroundProcessing = true; // Whether the tail is calculated by the worker thread
+			int mMaxPartitionSize = 8192; // Largest partition size used by the convolver
+
+			std::unique_ptr<Convolver> mConvolver = nullptr; // Performs the actual convolution
+			SampleBuffer mSilence; // Used as input when the input pin is not connected
+			uint64 mPreviousLateBlockCount = 0; // Late blocks of convolvers replaced after a buffer size change
+			std::atomic<uint64> mLateBlockCount = { 0 }; // Total number of late blocks, updated on every process()
+
+			std::thread mThread; // Worker thread calculating the tail
+			std::mutex mMutex; // Held by the worker thread while calculating, and while the convolver is replaced
+			std::condition_variable mCondition; // Wakes up the worker thread when a partition of input is complete
+			std::atomic<bool> mRunning = { false };
+		};
+
+	}
+}
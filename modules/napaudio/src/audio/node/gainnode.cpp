@@ -22,14 +22,35 @@ namespace nap
 			auto& outputBuffer = getOutputBuffer(audioOutput);
 			auto inputBuffer = audioInput.pull();
 			
-			if (inputBuffer == nullptr) {
-				for (auto i = 0; i < outputBuffer.size(); ++i)
-					outputBuffer[i] = 0;
-				return;
-			}
+			// Also without input, so scheduled changes are applied on time
+			mEvents.collect();
+			auto size = int(outputBuffer.size());
+			auto sampleTime = getSampleTime();
 			
-			for (auto i = 0; i < outputBuffer.size(); ++i)
-				outputBuffer[i] = (*inputBuffer)[i] * mGain.getNextValue();
+			// Process the buffer in segments, applying scheduled gain changes at the sample they are due.
+			auto position = 0;
+			while (position < size)
+			{
+				ParameterEvent event;
+				while (mEvents.popDueEvent(sampleTime + position, event))
+					mGain.setValue(event.mValue, event.mStepCount);
+				
+				auto end = position + mEvents.getSamplesUntilNextEvent(sampleTime + position, size - position);
+				if (inputBuffer == nullptr)
+				{
+					for (auto i = position; i < end; ++i)
+					{
+						mGain.getNextValue();
+						outputBuffer[i] = 0;
+					}
+				}
+				else
+				{
+					for (auto i = position; i < end; ++i)
+						outputBuffer[i] = (*inputBuffer)[i] * mGain.getNextValue();
+				}
+				position = end;
+			}
 		}
 		
 		
@@ -40,5 +61,15 @@ namespace nap
 		}
 		
 		
+		bool GainNode::scheduleGain(ControllerValue gain, TimeValue smoothTime, DiscreteTimeValue time)
+		{
+			ParameterEvent event;
+			event.mTime = time;
+			event.mValue = gain;
+			event.mStepCount = smoothTime * getNodeManager().getSamplesPerMillisecond();
+			return mEvents.enqueue(event);
+		}
+		
+		
 	}
 }
@@ -11,6 +11,7 @@
 #include <audio/core/audionode.h>
 #include <audio/core/audionodemanager.h>
 #include <audio/utility/linearsmoothedvalue.h>
+#include <audio/utility/parametereventqueue.h>
 
 namespace nap
 {
@@ -19,13 +20,14 @@ namespace nap
 		
 		/**
 		 * Node to scale an audio signal
+		 * Gain changes can be applied immediately using setGain() or scheduled at an exact sample time using scheduleGain().
 		 */
 		class NAPAPI GainNode : public Node
 		{
 			RTTI_ENABLE(Node)
 		
 		public:
-			GainNode(NodeManager& manager, ControllerValue initValue = 1, unsigned int stepCount = 64) : Node(manager), mGain(initValue, stepCount) { }
+			GainNode(NodeManager& manager, ControllerValue initValue = 1, unsigned int stepCount = 64, unsigned int eventQueueCapacity = 256) : Node(manager), mGain(initValue, stepCount), mEvents(eventQueueCapacity) { }
 			
 			/**
 			 * The input to be scaled
@@ -44,6 +46,16 @@ namespace nap
 			 */
 			void setGain(ControllerValue gain, TimeValue smoothTime);
 			
+			/**
+			 * Schedules a gain change at an exact sample time.
+			 * Call from one control thread only, for example the main thread or a sequencer thread.
+			 * @param gain the new gain value
+			 * @param smoothTime smoothtime in milliseconds
+			 * @param time absolute sample time on the node manager's clock, see NodeManager::getSampleTime(). Times in the past are applied at the start of the next buffer.
+			 * @return false if the event queue is full and the event has been discarded.
+			 */
+			bool scheduleGain(ControllerValue gain, TimeValue smoothTime, DiscreteTimeValue time);
+			
 			/**
 			 * @return: the gain scaling factor
 			 */
@@ -56,6 +68,7 @@ namespace nap
 			void process() override;
 			
 			LinearSmoothedValue<ControllerValue> mGain; // Current multiplication factor of the output signal.
+			ParameterEventQueue mEvents; // Scheduled gain changes, applied sample accurately in process()
 		};
 		
 	}
@@ -0,0 +1,148 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "resamplenode.h"
+
+// Std includes
+#include <cmath>
+#include <cstring>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::ResampleNode)
+	RTTI_PROPERTY("audioOutput", &nap::audio::ResampleNode::audioOutput, nap::rtti::EPropertyMetaData::Embedded)
+	RTTI_FUNCTION("play", &nap::audio::ResampleNode::play)
+	RTTI_FUNCTION("stop", &nap::audio::ResampleNode::stop)
+	RTTI_FUNCTION("setChannel", &nap::audio::ResampleNode::setChannel)
+	RTTI_FUNCTION("setSpeed", &nap::audio::ResampleNode::setSpeed)
+	RTTI_FUNCTION("setPosition", &nap::audio::ResampleNode::setPosition)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+
+		ResampleNode::ResampleNode(NodeManager& manager, EResampleQuality quality, float maximumSpeed) : Node(manager)
+		{
+			// Kernels are spaced a sixth of an octave apart, so the passband is narrowed by at most 11% at any speed
+			const float step = std::pow(2.f, 1.f / 6.f);
+			float speed = 1.f;
+			auto maxTapCount = 0;
+			while (true)
+			{
+				mKernels.emplace_back(std::make_unique<ResampleKernel>(quality, 1.f / speed));
+				mKernelSpeeds.emplace_back(speed);
+				maxTapCount = std::max(maxTapCount, mKernels.back()->getTapCount());
+				if (speed >= maximumSpeed)
+					break;
+				speed = std::min(speed * step, maximumSpeed);
+			}
+			mScratch.resize(maxTapCount, 0.f);
+		}
+
+
+		void ResampleNode::play(int channel, DiscreteTimeValue position, ControllerValue speed)
+		{
+			mPlaying = true;
+			mChannel = channel;
+			mPosition = position;
+			mSpeed = speed;
+		}
+
+
+		void ResampleNode::stop()
+		{
+			mPlaying = false;
+		}
+
+
+		void ResampleNode::setChannel(int channel)
+		{
+			mChannel = channel;
+		}
+
+
+		void ResampleNode::setSpeed(ControllerValue speed)
+		{
+			mSpeed = speed;
+		}
+
+
+		void ResampleNode::setPosition(DiscreteTimeValue position)
+		{
+			mPosition = position;
+		}
+
+
+		void ResampleNode::setBuffer(SafePtr<MultiSampleBuffer> buffer)
+		{
+			assert(mPlaying == false); // It is not safe to do this while playing back!
+			mBuffer = std::move(buffer);
+		}
+
+
+		const ResampleKernel& ResampleNode::getKernel(ControllerValue speed) const
+		{
+			for (auto i = 0; i < mKernelSpeeds.size(); ++i)
+				if (speed <= mKernelSpeeds[i])
+					return *mKernels[i];
+			return *mKernels.back();
+		}
+
+
+		void ResampleNode::process()
+		{
+			auto& outputBuffer = getOutputBuffer(audioOutput);
+
+			auto playing = mPlaying.load();
+			auto channel = mChannel.load();
+			auto position = mPosition.load();
+			auto speed = mSpeed.load();
+
+			// If we're not playing, fill the buffer with 0's and bail out.
+			if (!playing || mBuffer == nullptr || channel >= mBuffer->getChannelCount())
+			{
+				std::memset(outputBuffer.data(), 0, sizeof(SampleValue) * outputBuffer.size());
+				return;
+			}
+
+			auto& kernel = getKernel(std::abs(speed));
+			auto tapCount = kernel.getTapCount();
+			auto latency = kernel.getLatency();
+			SampleBuffer& channelBuffer = (*mBuffer)[channel];
+			auto size = int64_t(channelBuffer.size());
+
+			for (auto i = 0; i < outputBuffer.size(); i++)
+			{
+				// Have we reached the end of the buffer?
+				if (position >= size || position < 0)
+				{
+					outputBuffer[i] = 0;
+					playing = false;
+					continue;
+				}
+
+				auto index = int64_t(position);
+				auto fraction = float(position - index);
+				auto first = index - latency;
+				if (first >= 0 && first + tapCount <= size)
+					outputBuffer[i] = kernel.interpolate(&channelBuffer[first], fraction);
+				else {
+					// Near the edges of the buffer: copy the available taps and pad with silence
+					for (auto tap = 0; tap < tapCount; ++tap)
+					{
+						auto source = first + tap;
+						mScratch[tap] = (source >= 0 && source < size) ? channelBuffer[source] : 0.f;
+					}
+					outputBuffer[i] = kernel.interpolate(mScratch.data(), fraction);
+				}
+
+				position += speed;
+			}
+
+			mPosition.store(position);
+			mPlaying.store(playing);
+		}
+
+	}
+}
@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Nap includes
+#include <audio/utility/safeptr.h>
+
+// Audio includes
+#include <audio/core/audionode.h>
+#include <audio/core/audionodemanager.h>
+#include <audio/utility/resampler.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Node to play back audio from a buffer at a variable speed using windowed-sinc interpolation.
+		 * Can be used instead of the BufferPlayerNode when pitch shifted material has to be free of aliasing and interpolation noise.
+		 * On construction a bank of kernels is calculated with cutoff frequencies for speeds up to the maximum speed,
+		 * so changing the speed while playing does not allocate memory or recalculate filter coefficients.
+		 * The CPU cost per sample is proportional to the number of taps of the selected kernel,
+		 * which grows linearly with the speed above 1.
+		 */
+		class NAPAPI ResampleNode : public Node
+		{
+			RTTI_ENABLE(Node)
+
+		public:
+			/**
+			 * @param manager the node manager
+			 * @param quality quality of the interpolation
+			 * @param maximumSpeed the highest playback speed that is filtered against aliasing. Higher speeds are played back with the kernel for this speed.
+			 */
+			ResampleNode(NodeManager& manager, EResampleQuality quality = EResampleQuality::Medium, float maximumSpeed = 4.f);
+
+			/**
+			 * The output to connect to other nodes
+			 */
+			OutputPin audioOutput = {this};
+
+			/**
+			 * Tells the node to start playback
+			 * @param channel: the channel within the buffer to be played
+			 * @param position: the starting position in the source buffer in samples
+			 * @param speed: the playback speed, 1.0 means 1 sample per sample, 2 means double speed, etc.
+			 */
+			void play(int channel = 0, DiscreteTimeValue position = 0, ControllerValue speed = 1.);
+
+			/**
+			 * Stops playback
+			 */
+			void stop();
+
+			/**
+			 * Set the playback speed
+			 * @param speed as a fraction of the original speed of the audio material in the buffer.
+			 */
+			void setSpeed(ControllerValue speed);
+
+			/**
+			 * Sets the current position of playback while playing.
+			 * @param position in samples
+			 */
+			void setPosition(DiscreteTimeValue position);
+
+			/**
+			 * Sets the current channel of playback while playing.
+			 * @param channel index of the channel
+			 */
+			void setChannel(int channel);
+
+			/**
+			 * Sets the buffer to be played back from. Can't be called while playing!
+			 * @param buffer SafePtr to a multichannel sample buffer
+			 */
+			void setBuffer(SafePtr<MultiSampleBuffer> buffer);
+
+			/**
+			 * @return the playback speed as a fraction of the original speed of the audio material in the buffer.
+			 */
+			ControllerValue getSpeed() const { return mSpeed; }
+
+			/**
+			 * @return the current playback position within the source buffer.
+			 */
+			DiscreteTimeValue getPosition() const { return mPosition; }
+
+			/**
+			 * @return the current playback channel within the source buffer.
+			 */
+			int getChannel() const { return mChannel; }
+
+			/**
+			 * @return whether the node is currently playing. Becomes false when the end of the buffer has been reached.
+			 */
+			bool isPlaying() const { return mPlaying; }
+
+		private:
+			// Inherited from Node
+			void process() override;
+
+			// Returns the kernel with the highest cutoff that does not alias at the given speed
+			const ResampleKernel& getKernel(ControllerValue speed) const;
+
+			std::vector<std::unique_ptr<ResampleKernel>> mKernels; // Kernels with decreasing cutoff frequency for increasing speeds
+			std::vector<float> mKernelSpeeds; // Maximum speed for each kernel
+			SampleBuffer mScratch; // Zero padded taps near the start and end of the buffer
+
+			std::atomic<bool> mPlaying = {false}; // Indicates wether the node is currently playing.
+			std::atomic<int> mChannel = {0}; // The channel within the buffer that is being played back.
+			std::atomic<double> mPosition = {0}; // Current position of playback in samples within the source buffer.
+			std::atomic<ControllerValue> mSpeed = {1.f}; // Playback speed as a fraction of the original speed.
+			SafePtr<MultiSampleBuffer> mBuffer = nullptr; // Pointer to the buffer with audio material being played back.
+		};
+
+	}
+}
@@ -0,0 +1,276 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "voicepoolnode.h"
+
+// Std includes
+#include <cmath>
+#include <cstring>
+
+RTTI_BEGIN_ENUM(nap::audio::EVoiceStealMode)
+	RTTI_ENUM_VALUE(nap::audio::EVoiceStealMode::Oldest,	"Oldest"),
+	RTTI_ENUM_VALUE(nap::audio::EVoiceStealMode::Quietest,	"Quietest")
+RTTI_END_ENUM
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::VoicePoolNode)
+	RTTI_FUNCTION("getActiveVoiceCount", &nap::audio::VoicePoolNode::getActiveVoiceCount)
+	RTTI_FUNCTION("getStolenVoiceCount", &nap::audio::VoicePoolNode::getStolenVoiceCount)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+
+		VoicePoolNode::VoicePoolNode(NodeManager& manager, int voiceCount, int channelCount, unsigned int commandQueueSize) :
+			Node(manager), mCommands(commandQueueSize)
+		{
+			for (auto channel = 0; channel < channelCount; ++channel)
+				mOutputs.emplace_back(std::make_unique<OutputPin>(this));
+
+			mFreeVoices.reserve(voiceCount);
+			for (auto i = 0; i < voiceCount; ++i)
+			{
+				auto voice = std::make_unique<Voice>();
+				for (auto channel = 0; channel < channelCount; ++channel)
+					voice->mPlayers.emplace_back(manager.makeSafe<BufferPlayerNode>(manager));
+				mVoices.emplace_back(std::move(voice));
+			}
+
+			// Voices are popped from the back, so the first voice is used first
+			for (auto i = voiceCount - 1; i >= 0; --i)
+				mFreeVoices.emplace_back(i);
+
+			mEnvelopeBuffer.resize(getBufferSize(), 0.f);
+		}
+
+
+		int VoicePoolNode::addBuffer(SafePtr<MultiSampleBuffer> buffer)
+		{
+			mBuffers.emplace_back(std::move(buffer));
+			return int(mBuffers.size()) - 1;
+		}
+
+
+		bool VoicePoolNode::trigger(VoiceHandle handle, int bufferIndex, ControllerValue gain, ControllerValue speed, DiscreteTimeValue position, TimeValue attackTime)
+		{
+			assert(bufferIndex >= 0 && bufferIndex < mBuffers.size());
+			Command command;
+			command.mType = Command::EType::Trigger;
+			command.mHandle = handle;
+			command.mBufferIndex = bufferIndex;
+			command.mGain = gain;
+			command.mSpeed = speed;
+			command.mPosition = position;
+			command.mStepCount = attackTime * getNodeManager().getSamplesPerMillisecond();
+			return mCommands.tryEnqueue(command);
+		}
+
+
+		bool VoicePoolNode::release(VoiceHandle handle, TimeValue releaseTime)
+		{
+			Command command;
+			command.mType = Command::EType::Release;
+			command.mHandle = handle;
+			command.mStepCount = releaseTime * getNodeManager().getSamplesPerMillisecond();
+			return mCommands.tryEnqueue(command);
+		}
+
+
+		bool VoicePoolNode::releaseAll(TimeValue releaseTime)
+		{
+			Command command;
+			command.mType = Command::EType::ReleaseAll;
+			command.mStepCount = releaseTime * getNodeManager().getSamplesPerMillisecond();
+			return mCommands.tryEnqueue(command);
+		}
+
+
+		void VoicePoolNode::process()
+		{
+			Command command;
+			while (mCommands.tryDequeue(command))
+				handleCommand(command);
+
+			auto bufferSize = getBufferSize();
+			for (auto& output : mOutputs)
+			{
+				auto& outputBuffer = getOutputBuffer(*output);
+				std::memset(outputBuffer.data(), 0, sizeof(SampleValue) * outputBuffer.size());
+			}
+
+			auto activeCount = 0;
+			for (auto index = 0; index < mVoices.size(); ++index)
+			{
+				auto& voice = *mVoices[index];
+				if (!voice.mActive)
+					continue;
+
+				// Calculate the envelope once for all channels of the voice
+				for (auto i = 0; i < bufferSize; ++i)
+					mEnvelopeBuffer[i] = voice.mEnvelope.getNextValue();
+
+				for (auto channel = 0; channel < mOutputs.size(); ++channel)
+				{
+					auto& outputBuffer = getOutputBuffer(*mOutputs[channel]);
+					auto& inputBuffer = *voice.mPlayers[channel]->audioOutput.pull();
+					for (auto i = 0; i < bufferSize; ++i)
+						outputBuffer[i] += inputBuffer[i] * mEnvelopeBuffer[i];
+				}
+
+				// Recycle the voice when it has been faded out or when the end of the buffer has been reached
+				// A stolen voice starts its pending trigger instead
+				if ((voice.mReleasing && !voice.mEnvelope.isRamping()) || !voice.mPlayers[0]->isPlaying())
+				{
+					if (voice.mHasPending)
+					{
+						voice.mHasPending = false;
+						playVoice(voice, voice.mPending);
+						activeCount++;
+					}
+					else
+					{
+						stopVoice(index);
+					}
+				}
+				else
+				{
+					activeCount++;
+				}
+			}
+
+			mActiveVoiceCount.store(activeCount);
+		}
+
+
+		void VoicePoolNode::bufferSizeChanged(int bufferSize)
+		{
+			mEnvelopeBuffer.resize(bufferSize, 0.f);
+		}
+
+
+		void VoicePoolNode::handleCommand(const Command& command)
+		{
+			switch (command.mType)
+			{
+				case Command::EType::Trigger:
+					startVoice(command);
+					break;
+
+				case Command::EType::Release:
+					for (auto& voice : mVoices)
+						if (voice->mActive && voice->mHandle == command.mHandle)
+						{
+							// A pending trigger is dropped, the stolen voice keeps fading out
+							if (voice->mHasPending)
+								voice->mHasPending = false;
+							else
+								releaseVoice(*voice, command.mStepCount);
+							break;
+						}
+					break;
+
+				case Command::EType::ReleaseAll:
+					for (auto& voice : mVoices)
+						if (voice->mActive)
+						{
+							if (voice->mHasPending)
+								voice->mHasPending = false;
+							else
+								releaseVoice(*voice, command.mStepCount);
+						}
+					break;
+			}
+		}
+
+
+		void VoicePoolNode::startVoice(const Command& command)
+		{
+			auto& voice = *mVoices[allocateVoice()];
+			if (voice.mActive)
+			{
+				// Fade out the stolen voice to avoid a click, the trigger starts when the fade out is done
+				voice.mPending = command;
+				voice.mHasPending = true;
+				voice.mHandle = command.mHandle;
+				voice.mTriggerIndex = mTriggerCounter++;
+				releaseVoice(voice, int(mStealFadeTime.load() * getNodeManager().getSamplesPerMillisecond()));
+				return;
+			}
+			playVoice(voice, command);
+		}
+
+
+		void VoicePoolNode::playVoice(Voice& voice, const Command& command)
+		{
+			auto& buffer = mBuffers[command.mBufferIndex];
+			auto bufferChannelCount = int(buffer->getChannelCount());
+
+			for (auto channel = 0; channel < voice.mPlayers.size(); ++channel)
+			{
+				auto& player = voice.mPlayers[channel];
+				player->stop();
+				player->setBuffer(buffer);
+				player->play(channel % bufferChannelCount, command.mPosition, command.mSpeed);
+			}
+
+			voice.mEnvelope.setValue(0.f);
+			voice.mEnvelope.ramp(command.mGain, command.mStepCount);
+			voice.mHandle = command.mHandle;
+			voice.mTriggerIndex = mTriggerCounter++;
+			voice.mActive = true;
+			voice.mReleasing = false;
+		}
+
+
+		void VoicePoolNode::releaseVoice(Voice& voice, int stepCount)
+		{
+			voice.mEnvelope.ramp(0.f, stepCount);
+			voice.mReleasing = true;
+		}
+
+
+		void VoicePoolNode::stopVoice(int index)
+		{
+			auto& voice = *mVoices[index];
+			for (auto& player : voice.mPlayers)
+				player->stop();
+			voice.mActive = false;
+			voice.mReleasing = false;
+			mFreeVoices.emplace_back(index);
+		}
+
+
+		int VoicePoolNode::allocateVoice()
+		{
+			if (!mFreeVoices.empty())
+			{
+				auto index = mFreeVoices.back();
+				mFreeVoices.pop_back();
+				return index;
+			}
+
+			// All voices are in use: steal one, voices that are already stolen and fading out are only stolen again when all are
+			auto stolen = -1;
+			auto stealMode = mStealMode.load();
+			auto isCandidate = [&](int i)
+			{
+				if (stolen < 0 || (mVoices[stolen]->mHasPending && !mVoices[i]->mHasPending))
+					return true;
+				if (mVoices[i]->mHasPending && !mVoices[stolen]->mHasPending)
+					return false;
+				if (stealMode == EVoiceStealMode::Oldest)
+					return mVoices[i]->mTriggerIndex < mVoices[stolen]->mTriggerIndex;
+				return std::abs(mVoices[i]->mEnvelope.getValue()) < std::abs(mVoices[stolen]->mEnvelope.getValue());
+			};
+			for (auto i = 0; i < mVoices.size(); ++i)
+				if (isCandidate(i))
+					stolen = i;
+
+			mStolenVoiceCount++;
+			return stolen;
+		}
+
+	}
+}
@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Nap includes
+#include <utility/spscqueue.h>
+
+// Audio includes
+#include <audio/core/audionode.h>
+#include <audio/core/audionodemanager.h>
+#include <audio/node/bufferplayernode.h>
+#include <audio/utility/rampedvalue.h>
+#include <audio/utility/safeptr.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Unique identifier of a triggered voice, used to release it again. 0 is never a valid handle.
+		 */
+		using VoiceHandle = nap::uint64;
+
+
+		/**
+		 * Determines which voice is stolen when all voices are in use and a new voice is triggered.
+		 */
+		enum class EVoiceStealMode : int
+		{
+			Oldest,			///< Steal the voice that has been triggered first
+			Quietest		///< Steal the voice with the lowest envelope gain
+		};
+
+
+		/**
+		 * Node that plays back a fixed number of preallocated voices and mixes them to its outputs.
+		 * Each voice consists of a BufferPlayerNode for every output channel and a gain envelope.
+		 * All nodes and buffers are created on construction: triggering and releasing voices happens through a preallocated lock-free queue
+		 * and voices are recycled on the audio thread using a free-list, so no memory is allocated and no node is registered or connected at runtime.
+		 * Only active voices are processed.
+		 * Triggers and releases are applied at the start of the next internal buffer.
+		 * A stolen voice is faded out over the steal fade time first to avoid clicks, the new trigger starts when the fade out is done.
+		 * trigger(), release() and releaseAll() can be called from one control thread only.
+		 */
+		class NAPAPI VoicePoolNode : public Node
+		{
+			RTTI_ENABLE(Node)
+		public:
+			/**
+			 * @param manager the node manager this node runs on
+			 * @param voiceCount the number of preallocated voices
+			 * @param channelCount the number of output channels
+			 * @param commandQueueSize the maximum number of triggers and releases that can be pending per buffer
+			 */
+			VoicePoolNode(NodeManager& manager, int voiceCount, int channelCount, unsigned int commandQueueSize = 256);
+
+			/**
+			 * Adds a buffer that voices can play back. Has to be called before any voice is triggered.
+			 * @param buffer the multichannel buffer
+			 * @return the index of the buffer, used when triggering a voice
+			 */
+			int addBuffer(SafePtr<MultiSampleBuffer> buffer);
+
+			/**
+			 * Triggers a voice. If no voice is free, a voice is stolen according to the steal mode.
+			 * @param handle unique handle for the voice, used to release it
+			 * @param bufferIndex index of the buffer to play, as returned by addBuffer()
+			 * @param gain gain of the voice
+			 * @param speed playback speed, 1.0 means one buffer sample per output sample
+			 * @param position start position in the buffer in samples
+			 * @param attackTime time in milliseconds for the voice to fade in
+			 * @return false if the command queue is full and the trigger has been discarded.
+			 */
+			bool trigger(VoiceHandle handle, int bufferIndex, ControllerValue gain, ControllerValue speed, DiscreteTimeValue position, TimeValue attackTime);
+
+			/**
+			 * Fades out and recycles the voice with the given handle, if it is still playing.
+			 * @param handle the handle passed to trigger()
+			 * @param releaseTime time in milliseconds for the voice to fade out
+			 * @return false if the command queue is full and the release has been discarded.
+			 */
+			bool release(VoiceHandle handle, TimeValue releaseTime);
+
+			/**
+			 * Fades out and recycles all playing voices.
+			 * @param releaseTime time in milliseconds for the voices to fade out
+			 * @return false if the command queue is full and the release has been discarded.
+			 */
+			bool releaseAll(TimeValue releaseTime);
+
+			/**
+			 * Sets the strategy used to select a voice to steal when all voices are in use.
+			 */
+			void setStealMode(EVoiceStealMode mode) { mStealMode.store(mode); }
+
+			/**
+			 * Sets the time a stolen voice takes to fade out before the new trigger starts.
+			 * @param time fade out time in milliseconds
+			 */
+			void setStealFadeTime(TimeValue time) { mStealFadeTime.store(time); }
+
+			/**
+			 * @return the output pin for the given channel
+			 */
+			OutputPin& getOutput(int channel) { return *mOutputs[channel]; }
+
+			/**
+			 * @return the number of output channels
+			 */
+			int getChannelCount() const { return int(mOutputs.size()); }
+
+			/**
+			 * @return the number of preallocated voices
+			 */
+			int getVoiceCount() const { return int(mVoices.size()); }
+
+			/**
+			 * @return the number of voices that were playing during the last processed buffer
+			 */
+			int getActiveVoiceCount() const { return mActiveVoiceCount.load(); }
+
+			/**
+			 * @return the total number of voices that have been stolen
+			 */
+			int getStolenVoiceCount() const { return mStolenVoiceCount.load(); }
+
+		private:
+			/*
+			 * Command passed from the control thread to the audio thread.
+			 */
+			struct Command
+			{
+				enum class EType : int { Trigger, Release, ReleaseAll };
+				EType mType = EType::Trigger;
+				VoiceHandle mHandle = 0;
+				int mBufferIndex = 0;
+				ControllerValue mGain = 0;
+				ControllerValue mSpeed = 1.f;
+				DiscreteTimeValue mPosition = 0;
+				int mStepCount = 0;
+			};
+
+			/*
+			 * A preallocated voice. All members except the nodes are only accessed on the audio thread.
+			 */
+			struct Voice
+			{
+				Voice() : mEnvelope(0.f) { }
+				std::vector<SafeOwner<BufferPlayerNode>> mPlayers; // One player for each output channel
+				RampedValue<ControllerValue> mEnvelope; // Gain envelope of the voice
+				VoiceHandle mHandle = 0; // Handle of the current trigger
+				nap::uint64 mTriggerIndex = 0; // Used to determine the oldest voice
+				bool mActive = false;
+				bool mReleasing = false;
+				Command mPending; // Trigger that starts when a stolen voice has faded out
+				bool mHasPending = false;
+			};
+
+			// Inherited from Node
+			void process() override;
+
+			// Inherited from Process
+			void bufferSizeChanged(int bufferSize) override;
+
+			void handleCommand(const Command& command);
+			void startVoice(const Command& command);
+			void playVoice(Voice& voice, const Command& command);
+			void releaseVoice(Voice& voice, int stepCount);
+			void stopVoice(int index);
+			int allocateVoice();
+
+			std::vector<std::unique_ptr<OutputPin>> mOutputs; // Mixed output of all voices per channel
+			std::vector<std::unique_ptr<Voice>> mVoices; // All preallocated voices
+			std::vector<int> mFreeVoices; // Stack of indices of voices that are not playing, capacity is reserved on construction
+			std::vector<SafePtr<MultiSampleBuffer>> mBuffers; // Buffers that the voices can play back
+			std::vector<ControllerValue> mEnvelopeBuffer; // Scratch buffer holding the envelope of the voice being mixed
+			nap::uint64 mTriggerCounter = 0; // Incremented on every trigger, audio thread only
+
+			utility::SPSCQueue<Command> mCommands; // Commands from the control thread
+			std::atomic<EVoiceStealMode> mStealMode = { EVoiceStealMode::Oldest };
+			std::atomic<TimeValue> mStealFadeTime = { 5.f }; // Fade out time of a stolen voice in milliseconds
+			std::atomic<int> mActiveVoiceCount = { 0 };
+			std::atomic<int> mStolenVoiceCount = { 0 };
+		};
+
+	}
+}
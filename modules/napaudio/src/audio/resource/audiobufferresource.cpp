@@ -16,11 +16,22 @@ namespace nap
 	namespace audio
 	{
 		
-		AudioBufferResource::AudioBufferResource(AudioService& service)
+		AudioBufferResource::AudioBufferResource(AudioService& service) : mService(service)
 		{
 			mBuffer = service.getNodeManager().makeSafe<MultiSampleBuffer>();
 		}
 		
+		
+		void AudioBufferResource::convertToServiceSampleRate(EResampleQuality quality)
+		{
+			auto serviceSampleRate = mService.getNodeManager().getSampleRate();
+			if (mSampleRate <= 0 || serviceSampleRate <= 0 || mSampleRate == serviceSampleRate)
+				return;
+			
+			resample(*mBuffer, mSampleRate, serviceSampleRate, quality);
+			mSampleRate = serviceSampleRate;
+		}
+		
 	}
 }
 
@@ -12,6 +12,7 @@
 
 // Audio includes
 #include <audio/utility/audiotypes.h>
+#include <audio/utility/resampler.h>
 
 namespace nap
 {
@@ -66,8 +67,16 @@ namespace nap
 			 * Sets the sample rate at which the audio material in the buffer was sampled.
 			 */
 			void setSampleRate(float sampleRate) { mSampleRate = sampleRate; }
+			
+			/**
+			 * Converts the audio material in the buffer to the sample rate of the audio service, if it differs.
+			 * Call after the buffer has been filled and its sample rate has been set.
+			 * @param quality quality of the resampler
+			 */
+			void convertToServiceSampleRate(EResampleQuality quality);
 		
 		private:
+			AudioService& mService;
 			float mSampleRate = 0;
 			SafeOwner<MultiSampleBuffer> mBuffer = nullptr;
 		};
@@ -12,11 +12,15 @@
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::AudioFileResource)
 	RTTI_CONSTRUCTOR(nap::audio::AudioService &)
 	RTTI_PROPERTY_FILELINK("AudioFilePath", &nap::audio::AudioFileResource::mAudioFilePath, nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::Audio)
+	RTTI_PROPERTY("Resample", &nap::audio::AudioFileResource::mResample, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ResampleQuality", &nap::audio::AudioFileResource::mResampleQuality, nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::MultiAudioFileResource)
 	RTTI_CONSTRUCTOR(nap::audio::AudioService &)
 	RTTI_PROPERTY("AudioFilePaths", &nap::audio::MultiAudioFileResource::mAudioFilePaths, nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Resample", &nap::audio::MultiAudioFileResource::mResample, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ResampleQuality", &nap::audio::MultiAudioFileResource::mResampleQuality, nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 namespace nap
@@ -30,6 +34,8 @@ namespace nap
 			if (readAudioFile(mAudioFilePath, *getBuffer(), sampleRate, errorState))
 			{
 				setSampleRate(sampleRate);
+				if (mResample)
+					convertToServiceSampleRate(mResampleQuality);
 				return true;
 			}
 			return false;
@@ -62,6 +68,9 @@ namespace nap
 					return false;
 			}
 			
+			if (mResample)
+				convertToServiceSampleRate(mResampleQuality);
+			
 			return true;
 		}
 		
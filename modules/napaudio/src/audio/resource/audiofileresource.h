@@ -33,6 +33,8 @@ namespace nap
 		
 		public:
 			std::string mAudioFilePath = ""; ///< property: 'AudioFilePath' The path to the audio file on disk
+			bool mResample = false; ///< property: 'Resample' Converts the file to the sample rate of the audio service on load, off by default
+			EResampleQuality mResampleQuality = EResampleQuality::High; ///< property: 'ResampleQuality' Quality of the sample rate conversion on load
 		};
 		
 		
@@ -52,6 +54,8 @@ namespace nap
 		
 		public:
 			std::vector<std::string> mAudioFilePaths; ///< property: 'AudioFilePaths' The paths to the audio files on disk
+			bool mResample = false; ///< property: 'Resample' Converts the files to the sample rate of the audio service on load, off by default
+			EResampleQuality mResampleQuality = EResampleQuality::High; ///< property: 'ResampleQuality' Quality of the sample rate conversion on load
 		};
 		
 		
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "voicepool.h"
+
+// Nap includes
+#include <nap/logger.h>
+
+// Audio includes
+#include <audio/service/audioservice.h>
+
+// RTTI
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::VoicePool)
+	RTTI_CONSTRUCTOR(nap::audio::AudioService &)
+	RTTI_PROPERTY("Buffers", &nap::audio::VoicePool::mBuffers, nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("VoiceCount", &nap::audio::VoicePool::mVoiceCount, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ChannelCount", &nap::audio::VoicePool::mChannelCount, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("AttackTime", &nap::audio::VoicePool::mAttackTime, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ReleaseTime", &nap::audio::VoicePool::mReleaseTime, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("StealMode", &nap::audio::VoicePool::mStealMode, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("StealFadeTime", &nap::audio::VoicePool::mStealFadeTime, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("CommandQueueSize", &nap::audio::VoicePool::mCommandQueueSize, nap::rtti::EPropertyMetaData::Default)
+	RTTI_FUNCTION("trigger", &nap::audio::VoicePool::trigger)
+	RTTI_FUNCTION("release", &nap::audio::VoicePool::release)
+	RTTI_FUNCTION("releaseAll", &nap::audio::VoicePool::releaseAll)
+	RTTI_FUNCTION("getActiveVoiceCount", &nap::audio::VoicePool::getActiveVoiceCount)
+RTTI_END_CLASS
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		VoicePool::VoicePool(AudioService& service) : mService(service)
+		{
+		}
+		
+		
+		bool VoicePool::init(utility::ErrorState& errorState)
+		{
+			if (!errorState.check(mVoiceCount > 0, "%s: VoiceCount has to be at least 1", mID.c_str()))
+				return false;
+			
+			if (!errorState.check(mChannelCount > 0, "%s: ChannelCount has to be at least 1", mID.c_str()))
+				return false;
+			
+			if (!errorState.check(!mBuffers.empty(), "%s: At least one buffer is required", mID.c_str()))
+				return false;
+			
+			auto& nodeManager = mService.getNodeManager();
+			mNode = nodeManager.makeSafe<VoicePoolNode>(nodeManager, mVoiceCount, mChannelCount, mCommandQueueSize);
+			mNode->setStealMode(mStealMode);
+			mNode->setStealFadeTime(mStealFadeTime);
+			
+			for (auto& buffer : mBuffers)
+			{
+				if (!errorState.check(buffer->getChannelCount() > 0, "%s: Buffer %s is empty", mID.c_str(), buffer->mID.c_str()))
+					return false;
+				mNode->addBuffer(buffer->getBuffer());
+			}
+			
+			return true;
+		}
+		
+		
+		VoiceHandle VoicePool::trigger(int bufferIndex, ControllerValue gain, ControllerValue pitch, TimeValue startPosition)
+		{
+			if (bufferIndex < 0 || bufferIndex >= mBuffers.size())
+			{
+				nap::Logger::warn("%s: buffer index %i out of bounds", mID.c_str(), bufferIndex);
+				return 0;
+			}
+			
+			auto& buffer = *mBuffers[bufferIndex];
+			ControllerValue speed = pitch * buffer.getSampleRate() / mService.getNodeManager().getSampleRate();
+			auto handle = mNextHandle++;
+			if (!mNode->trigger(handle, bufferIndex, gain, speed, buffer.toSamples(startPosition), mAttackTime))
+			{
+				mDroppedCommandCount++;
+				return 0;
+			}
+			return handle;
+		}
+		
+		
+		void VoicePool::release(VoiceHandle handle)
+		{
+			if (!mNode->release(handle, mReleaseTime))
+				mDroppedCommandCount++;
+		}
+		
+		
+		void VoicePool::releaseAll()
+		{
+			if (!mNode->releaseAll(mReleaseTime))
+				mDroppedCommandCount++;
+		}
+		
+	}
+}
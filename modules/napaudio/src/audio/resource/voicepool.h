@@ -0,0 +1,103 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Nap includes
+#include <nap/resource.h>
+#include <nap/resourceptr.h>
+#include <rtti/factory.h>
+
+// Audio includes
+#include <audio/core/multichannel.h>
+#include <audio/node/voicepoolnode.h>
+#include <audio/resource/audiobufferresource.h>
+#include <audio/utility/safeptr.h>
+
+namespace nap
+{
+	namespace audio
+	{
+		
+		// Forward declarations
+		class AudioService;
+		
+		/**
+		 * Pool of preallocated voices that play back one-shots from a set of audio buffers.
+		 * All voice graphs are built on initialization from the properties of the pool, triggering a voice afterwards does not allocate memory,
+		 * does not register or connect nodes and does not go through the node manager's task queue.
+		 * When all voices are in use the oldest or quietest voice is stolen, see @EVoiceStealMode.
+		 * Triggers and releases are passed to the audio thread through a lock-free queue, call them from one thread only (typically the main thread).
+		 * Use a @VoicePoolComponent to route the mixed output of the pool to an @OutputComponent.
+		 */
+		class NAPAPI VoicePool : public Resource, public IMultiChannelOutput
+		{
+			RTTI_ENABLE(Resource)
+		public:
+			VoicePool(AudioService& service);
+			
+			// Inherited from Resource
+			bool init(utility::ErrorState& errorState) override;
+			
+			// Inherited from IMultiChannelOutput
+			int getChannelCount() const override { return mChannelCount; }
+			OutputPin* getOutputForChannel(int channel) override { return &mNode->getOutput(channel); }
+			
+			/**
+			 * Triggers a voice that plays back one of the buffers.
+			 * @param bufferIndex index of the buffer in the Buffers property
+			 * @param gain gain of the voice
+			 * @param pitch pitch as a fraction of the original pitch of the audio material in the buffer
+			 * @param startPosition start position in the buffer in milliseconds
+			 * @return handle of the voice that can be used to release it, 0 if the trigger could not be enqueued.
+			 */
+			VoiceHandle trigger(int bufferIndex, ControllerValue gain = 1.f, ControllerValue pitch = 1.f, TimeValue startPosition = 0.f);
+			
+			/**
+			 * Fades out the voice with the given handle over the release time, if it is still playing.
+			 * @param handle handle returned by trigger()
+			 */
+			void release(VoiceHandle handle);
+			
+			/**
+			 * Fades out all playing voices over the release time.
+			 */
+			void releaseAll();
+			
+			/**
+			 * @return the number of voices playing during the last processed audio buffer.
+			 */
+			int getActiveVoiceCount() const { return mNode->getActiveVoiceCount(); }
+			
+			/**
+			 * @return the total number of voices that have been stolen.
+			 */
+			int getStolenVoiceCount() const { return mNode->getStolenVoiceCount(); }
+			
+			/**
+			 * @return the number of triggers and releases that were discarded because the command queue was full.
+			 */
+			int getDroppedCommandCount() const { return mDroppedCommandCount; }
+			
+		public:
+			std::vector<ResourcePtr<AudioBufferResource>> mBuffers;		///< property: 'Buffers' The buffers that can be played back by the voices
+			int mVoiceCount = 32;										///< property: 'VoiceCount' The number of preallocated voices
+			int mChannelCount = 2;										///< property: 'ChannelCount' The number of output channels, buffer channels are repeated when a buffer has less channels
+			TimeValue mAttackTime = 2.f;								///< property: 'AttackTime' Fade in time of a triggered voice in milliseconds
+			TimeValue mReleaseTime = 20.f;								///< property: 'ReleaseTime' Fade out time of a released voice in milliseconds
+			EVoiceStealMode mStealMode = EVoiceStealMode::Oldest;		///< property: 'StealMode' Determines which voice is stolen when all voices are in use
+			TimeValue mStealFadeTime = 5.f;								///< property: 'StealFadeTime' Fade out time of a stolen voice in milliseconds, the new trigger starts after the fade out
+			int mCommandQueueSize = 256;								///< property: 'CommandQueueSize' Maximum number of triggers and releases that can be pending per audio buffer
+			
+		private:
+			AudioService& mService;
+			SafeOwner<VoicePoolNode> mNode = nullptr;
+			VoiceHandle mNextHandle = 1;
+			int mDroppedCommandCount = 0;
+		};
+		
+		using VoicePoolObjectCreator = rtti::ObjectCreator<VoicePool, AudioService>;
+		
+	}
+}
@@ -13,6 +13,7 @@
 #include "audioservice.h"
 #include <audio/resource/audiobufferresource.h>
 #include <audio/resource/audiofileresource.h>
+#include <audio/resource/voicepool.h>
 
 // Third party includes
 #include <mpg123.h>
@@ -43,6 +44,10 @@ RTTI_BEGIN_CLASS(nap::audio::AudioServiceConfiguration)
 		              nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("InternalBufferSize", &nap::audio::AudioServiceConfiguration::mInternalBufferSize,
 		              nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ProcessTimingInterval", &nap::audio::AudioServiceConfiguration::mProcessTimingInterval,
+		              nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("WatchdogTimeout", &nap::audio::AudioServiceConfiguration::mWatchdogTimeout,
+		              nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::audio::AudioService)
@@ -68,7 +73,7 @@ namespace nap
 			float** in = (float**) inputBuffer;
 			
 			AudioService* service = (AudioService*) userData;
-			service->onAudioCallback(in, out, framesPerBuffer);
+			service->onAudioCallback(in, out, framesPerBuffer, statusFlags);
 			
 			return 0;
 		}
@@ -77,6 +82,7 @@ namespace nap
 		AudioService::AudioService(ServiceConfiguration* configuration) :
 				Service(configuration), mNodeManager(mDeletionQueue)
 		{
+			mNodeManager.setProfiler(&mProfiler);
 		}
 		
 		
@@ -85,6 +91,7 @@ namespace nap
 			factory.addObjectCreator(std::make_unique<AudioBufferResourceObjectCreator>(*this));
 			factory.addObjectCreator(std::make_unique<AudioFileResourceObjectCreator>(*this));
 			factory.addObjectCreator(std::make_unique<MultiAudioFileResourceObjectCreator>(*this));
+			factory.addObjectCreator(std::make_unique<VoicePoolObjectCreator>(*this));
 		}
 		
 		
@@ -100,6 +107,7 @@ namespace nap
 			int outputDeviceIndex = -1;
 			int inputChannelCount = 0;
 			int outputChannelCount = 0;
+			mProfiler.setProcessTimingInterval(std::max(configuration->mProcessTimingInterval, 0));
 			
 			// Initialize the portaudio library
 			PaError error = Pa_Initialize();
@@ -239,6 +247,30 @@ namespace nap
 		}
 
 
+		void AudioService::update(double deltaTime)
+		{
+			mProfiler.update();
+			
+			// Report when a running stream stops calling back, for example when the driver hangs
+			auto timeout = getConfiguration<AudioServiceConfiguration>()->mWatchdogTimeout;
+			if (timeout <= 0.f || mStream == nullptr || !isActive())
+				return;
+			
+			auto timeSinceLastCallback = mProfiler.getTimeSinceLastCallback();
+			if (timeSinceLastCallback > timeout)
+			{
+				if (!mStalled)
+					Logger::warn("AudioService: no audio callback for %.0f ms, the audio thread is stalled", timeSinceLastCallback);
+				mStalled = true;
+			}
+			else if (mStalled && timeSinceLastCallback >= 0)
+			{
+				Logger::info("AudioService: audio thread resumed");
+				mStalled = false;
+			}
+		}
+		
+		
 		NodeManager& AudioService::getNodeManager()
 		{
 			return mNodeManager;
@@ -458,13 +490,19 @@ namespace nap
 		}
 		
 		
-		void AudioService::onAudioCallback(float** inputBuffer, float** outputBuffer, unsigned long framesPerBuffer)
+		void AudioService::onAudioCallback(float** inputBuffer, float** outputBuffer, unsigned long framesPerBuffer, PaStreamCallbackFlags statusFlags)
 		{
+			mProfiler.beginCallback(framesPerBuffer, mNodeManager.getSampleRate());
+			if (statusFlags != 0)
+				mProfiler.countXRuns(statusFlags & paInputUnderflow, statusFlags & paInputOverflow, statusFlags & paOutputUnderflow, statusFlags & paOutputOverflow);
+			
 			// process the node manager
 			mNodeManager.process(inputBuffer, outputBuffer, framesPerBuffer);
 			
 			// clean the trash bin with nodes and resources that are no longer used and scheduled for destruction
 			mDeletionQueue.clear();
+			
+			mProfiler.endCallback();
 		}
 		
 		
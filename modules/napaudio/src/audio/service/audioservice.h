@@ -6,6 +6,7 @@
 
 // Audio includes
 #include <audio/core/audionodemanager.h>
+#include <audio/core/audioprofiler.h>
 #include <audio/utility/safeptr.h>
 
 // Nap includes
@@ -101,6 +102,16 @@ namespace nap
 			 * Lowering this can improve timing precision in the case that the node manager performs internal event scheduling, however will increase performance load.
 			 */
 			int mInternalBufferSize = 1024;
+			
+			/**
+			 * Number of audio callbacks between two measurements of the time spent in each node. 0 disables per node timing.
+			 */
+			int mProcessTimingInterval = 0;
+			
+			/**
+			 * Time in milliseconds without a finished audio callback after which a running stream is reported as stalled. 0 disables the watchdog.
+			 */
+			float mWatchdogTimeout = 500.f;
 		};
 		
 		/**
@@ -130,11 +141,21 @@ namespace nap
 			 * Called on shutdown of the service. Closes portaudio stream and shuts down portaudio.
 			 */
 			 void shutdown() override;
+			
+			/**
+			 * Acquires the latest audio performance statistics and checks if the audio thread is stalled.
+			 */
+			void update(double deltaTime) override;
 
 			/**
 			 * @return the audio node manager owned by the audio service. The @NodeManager contains a node system that performs all the DSP.
 			 */
 			NodeManager& getNodeManager();
+			
+			/**
+			 * @return the profiler that measures the audio callback. Its statistics are updated on every update() of the service.
+			 */
+			AudioProfiler& getProfiler() { return mProfiler; }
 
 			/**
 			 * @return: returns wether we will allow input and output channel numbers that exceed the current device's maximum channel counts. If so zero signals will be returned for non-existing input channel numbers. If not initialization will fail.
@@ -281,8 +302,9 @@ namespace nap
              * @param inputBuffer: an array of float arrays, representing one sample buffer for every channel
              * @param outputBuffer: an array of float arrays, representing one sample buffer for every channel
              * @param framesPerBuffer: the number of samples that has to be processed per channel
+             * @param statusFlags: portaudio flags indicating xruns that occurred since the previous callback
              */
-			void onAudioCallback(float** inputBuffer, float** outputBuffer, unsigned long framesPerBuffer);
+			void onAudioCallback(float** inputBuffer, float** outputBuffer, unsigned long framesPerBuffer, PaStreamCallbackFlags statusFlags = 0);
 			
 			/**
 			 * Enqueue a task to be executed within the process() method for thread safety
@@ -319,6 +341,9 @@ namespace nap
 			// DeletionQueue with nodes that are no longer used and that can be cleared and destructed safely on the next audio callback.
 			// Clearing is performed on the audio callback to make sure the node can not be destructed while it is being processed.
 			DeletionQueue mDeletionQueue;
+			
+			AudioProfiler mProfiler; // Measures the duration of the audio callbacks and counts xruns.
+			bool mStalled = false; // Set when the watchdog has reported a stalled audio thread, to report it only once.
 		};
 	}
 }
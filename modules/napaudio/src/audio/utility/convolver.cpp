@@ -0,0 +1,269 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "convolver.h"
+
+// Std includes
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Uniformly partitioned overlap-save convolution of one segment of the impulse response.
+		 * The first stage is calculated directly within process() on every block.
+		 * Later stages collect a full partition of input, which is then convolved by processPending() on the background thread,
+		 * and mix the result into the output two partitions later, matching the offset of their segment within the impulse response.
+		 * The background thread reads the partition it calculates and the one before it from the input ring,
+		 * so the audio thread drops a partition of input instead of overwriting either of them when the background thread falls too far behind.
+		 */
+		class Convolver::Stage
+		{
+		public:
+			Stage(const SampleValue* impulseResponse, std::size_t length, int partitionSize, int blockSize, bool direct) :
+				mFFT(getFFTSize(partitionSize)), mPartitionSize(partitionSize), mBlockSize(blockSize), mDirect(direct)
+			{
+				auto fftSize = mFFT.getSize();
+				auto binCount = mFFT.getBinCount();
+				mPartitionCount = int((length + partitionSize - 1) / partitionSize);
+
+				// Transform every partition of the impulse response
+				std::vector<float> padded(fftSize, 0.f);
+				mFilters.resize(mPartitionCount * binCount);
+				for (auto partition = 0; partition < mPartitionCount; ++partition)
+				{
+					std::fill(padded.begin(), padded.end(), 0.f);
+					auto begin = std::size_t(partition) * partitionSize;
+					auto count = std::min<std::size_t>(partitionSize, length - begin);
+					std::copy(impulseResponse + begin, impulseResponse + begin + count, padded.begin());
+					mFFT.forward(padded.data(), &mFilters[partition * binCount]);
+				}
+
+				mDelayLine.resize(mPartitionCount * binCount);
+				mAccumulator.resize(binCount);
+				mWindow.resize(fftSize, 0.f);
+				mTimeBuffer.resize(fftSize, 0.f);
+				if (!mDirect)
+				{
+					mInputRing.resize(4 * partitionSize, 0.f);
+					mOutputRing.resize(2 * partitionSize, 0.f);
+					for (auto& slot : mInputSlots)
+						slot.store(0);
+				}
+			}
+
+			/**
+			 * Direct stage: convolves one block, the partition size equals the block size.
+			 */
+			void processDirect(const SampleValue* input, SampleValue* output)
+			{
+				// Slide the window by one block
+				std::memmove(mWindow.data(), mWindow.data() + mBlockSize, sizeof(float) * mBlockSize);
+				std::memcpy(mWindow.data() + mBlockSize, input, sizeof(float) * mBlockSize);
+				convolve();
+				std::memcpy(output, mTimeBuffer.data() + mBlockSize, sizeof(float) * mBlockSize);
+			}
+
+			/**
+			 * Delayed stage: stores the input, mixes the output calculated before and posts a new partition when complete.
+			 * @return true if a new partition has been posted
+			 */
+			bool processDelayed(const SampleValue* input, SampleValue* output, std::atomic<uint64>& lateBlockCount, std::atomic<uint64>& droppedPartitionCount)
+			{
+				auto blocksPerPartition = mPartitionSize / mBlockSize;
+				auto partition = int64_t(mBlockCounter / blocksPerPartition);
+				auto offset = int((mBlockCounter % blocksPerPartition) * mBlockSize);
+
+				// Mix the result of the partition that was posted two partitions ago
+				auto result = partition - 2;
+				if (result >= 0)
+				{
+					if (mProcessedCount.load(std::memory_order_acquire) > uint64(result))
+					{
+						auto source = &mOutputRing[(result % 2) * mPartitionSize + offset];
+						for (auto i = 0; i < mBlockSize; ++i)
+							output[i] += source[i];
+					}
+					else
+						lateBlockCount++;
+				}
+
+				// The background thread reads the partitions from the oldest unprocessed one minus one up to the last posted one.
+				// Writing the new partition into the ring is safe when it lies at most two partitions ahead of the oldest unprocessed one.
+				// The background thread only moves forward, so the check is done once at the start of the partition.
+				if (offset == 0)
+				{
+					mDropping = uint64(partition) > mProcessedCount.load(std::memory_order_acquire) + 2;
+					if (mDropping)
+						droppedPartitionCount++;
+				}
+
+				// Store the input
+				if (!mDropping)
+					std::memcpy(&mInputRing[(partition % 4) * mPartitionSize + offset], input, sizeof(float) * mBlockSize);
+				mBlockCounter++;
+
+				// Post the partition when it is complete, a dropped partition leaves the slot tagged with the previous partition
+				if (mBlockCounter % blocksPerPartition == 0)
+				{
+					if (!mDropping)
+						mInputSlots[partition % 4].store(partition + 1, std::memory_order_release);
+					mPostedCount.store(partition + 1, std::memory_order_release);
+					return true;
+				}
+				return false;
+			}
+
+			/**
+			 * Convolves all partitions that have been posted but not processed yet.
+			 * @return true if any work has been done
+			 */
+			bool processPending()
+			{
+				auto posted = mPostedCount.load(std::memory_order_acquire);
+				auto processed = mProcessedCount.load(std::memory_order_relaxed);
+				if (processed >= posted)
+					return false;
+
+				while (processed < posted)
+				{
+					// The window holds the previous and the current partition of input, dropped partitions are silent
+					copyPartition(int64_t(processed) - 1, mWindow.data());
+					copyPartition(int64_t(processed), mWindow.data() + mPartitionSize);
+					convolve();
+					std::memcpy(&mOutputRing[(processed % 2) * mPartitionSize], mTimeBuffer.data() + mPartitionSize, sizeof(float) * mPartitionSize);
+					processed++;
+					mProcessedCount.store(processed, std::memory_order_release);
+				}
+				return true;
+			}
+
+		private:
+			static int getFFTSize(int partitionSize)
+			{
+				auto size = 4;
+				while (size < 2 * partitionSize)
+					size <<= 1;
+				return size;
+			}
+
+			// Copies a partition of input from the ring, or silence when the partition has been dropped.
+			// The partition before the first one is silent as well.
+			void copyPartition(int64_t partition, float* destination)
+			{
+				auto slot = partition % 4;
+				if (partition >= 0 && mInputSlots[slot].load(std::memory_order_acquire) == uint64(partition + 1))
+					std::memcpy(destination, &mInputRing[slot * mPartitionSize], sizeof(float) * mPartitionSize);
+				else
+					std::fill(destination, destination + mPartitionSize, 0.f);
+			}
+
+			// Transforms the window into the frequency domain delay line and multiplies the delay line with the filter partitions.
+			// The valid output samples are at mPartitionSize up to 2 * mPartitionSize in mTimeBuffer.
+			void convolve()
+			{
+				auto binCount = mFFT.getBinCount();
+				mFFT.forward(mWindow.data(), &mDelayLine[mHead * binCount]);
+
+				std::fill(mAccumulator.begin(), mAccumulator.end(), FFT::Complex(0.f, 0.f));
+				auto accumulator = reinterpret_cast<float*>(mAccumulator.data());
+				for (auto partition = 0; partition < mPartitionCount; ++partition)
+				{
+					auto slot = (mHead + mPartitionCount - partition) % mPartitionCount;
+					auto x = reinterpret_cast<const float*>(&mDelayLine[slot * binCount]);
+					auto h = reinterpret_cast<const float*>(&mFilters[partition * binCount]);
+					for (auto bin = 0; bin < 2 * binCount; bin += 2)
+					{
+						accumulator[bin] += x[bin] * h[bin] - x[bin + 1] * h[bin + 1];
+						accumulator[bin + 1] += x[bin] * h[bin + 1] + x[bin + 1] * h[bin];
+					}
+				}
+				mHead = (mHead + 1) % mPartitionCount;
+
+				mFFT.inverse(mAccumulator.data(), mTimeBuffer.data());
+			}
+
+			FFT mFFT;
+			int mPartitionSize = 0;
+			int mBlockSize = 0;
+			int mPartitionCount = 0;
+			bool mDirect = true;
+
+			std::vector<FFT::Complex> mFilters;			// Spectrum of every partition of the impulse response
+			std::vector<FFT::Complex> mDelayLine;		// Spectra of the most recent input windows, one for every partition
+			std::vector<FFT::Complex> mAccumulator;		// Sum of the products of the delay line and the filters
+			std::vector<float> mWindow;					// Previous and current partition of input, zero padded to the fft size
+			std::vector<float> mTimeBuffer;				// Result of the inverse transform
+			int mHead = 0;								// Position of the most recent spectrum in the delay line
+
+			// Delayed stages only
+			std::vector<float> mInputRing;				// The last four partitions of input, written by the audio thread
+			std::vector<float> mOutputRing;				// The last two calculated partitions of output, written by the background thread
+			std::atomic<uint64> mInputSlots[4];			// Partition stored in every slot of the input ring plus one, 0 when empty
+			uint64 mBlockCounter = 0;					// Number of blocks processed by the audio thread
+			bool mDropping = false;						// True when the input of the current partition is dropped
+			std::atomic<uint64> mPostedCount = { 0 };	// Number of complete input partitions
+			std::atomic<uint64> mProcessedCount = { 0 };	// Number of calculated output partitions
+		};
+
+
+		Convolver::Convolver(const SampleBuffer& impulseResponse, int blockSize, bool background, int maxPartitionSize) :
+			mBlockSize(blockSize), mBackground(background)
+		{
+			assert(blockSize > 0);
+
+			// Partition sizes have to be multiples of the block size
+			auto maxSize = std::max(blockSize, (maxPartitionSize / blockSize) * blockSize);
+			auto length = std::max<std::size_t>(impulseResponse.size(), 1);
+			SampleBuffer padded(impulseResponse);
+			padded.resize(length, 0.f);
+
+			std::size_t offset = 0;
+			auto size = blockSize;
+			while (offset < length)
+			{
+				// A stage with partition size N starts at 2N, the last stage covers the rest of the impulse response
+				auto next = std::min(size * 8, maxSize);
+				auto end = next > size ? std::min<std::size_t>(length, 2 * std::size_t(next)) : length;
+				mStages.emplace_back(std::make_unique<Stage>(&padded[offset], end - offset, size, blockSize, offset == 0));
+				offset = end;
+				size = next;
+			}
+		}
+
+
+		Convolver::~Convolver() = default;
+
+
+		bool Convolver::process(const SampleValue* input, SampleValue* output)
+		{
+			mStages[0]->processDirect(input, output);
+
+			auto posted = false;
+			for (auto i = 1; i < mStages.size(); ++i)
+				posted |= mStages[i]->processDelayed(input, output, mLateBlockCount, mDroppedPartitionCount);
+
+			if (posted && !mBackground)
+			{
+				processBackground();
+				return false;
+			}
+			return posted;
+		}
+
+
+		bool Convolver::processBackground()
+		{
+			auto processed = false;
+			for (auto i = 1; i < mStages.size(); ++i)
+				processed |= mStages[i]->processPending();
+			return processed;
+		}
+
+	}
+}
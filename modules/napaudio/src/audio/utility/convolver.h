@@ -0,0 +1,91 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Audio includes
+#include <audio/utility/audiotypes.h>
+#include <audio/utility/fft.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Zero latency convolution of a signal with a long impulse response using non-uniformly partitioned FFT convolution.
+		 * The impulse response is split into stages of increasing partition size. Each stage performs uniformly partitioned overlap-save convolution
+		 * with a frequency domain delay line. The first stage uses the block size of the caller, so the output has no latency,
+		 * and the partition size grows by a factor of 8 for every following stage up to the maximum partition size.
+		 * A stage with partition size N starts at 2N samples into the impulse response, which leaves a full partition of time to calculate it.
+		 * In background mode the stages after the first one are calculated by calling processBackground() from another thread,
+		 * so the cost of the audio callback is bounded by the first stage only.
+		 * All memory is allocated on construction.
+		 */
+		class NAPAPI Convolver
+		{
+		public:
+			/**
+			 * @param impulseResponse the impulse response, copied on construction
+			 * @param blockSize number of samples passed to every call to process()
+			 * @param background true if the later stages are calculated by calling processBackground() from another thread,
+			 * false to calculate everything within process()
+			 * @param maxPartitionSize the largest partition size, bounding the latency of the calculation of the tail and the memory per stage
+			 */
+			Convolver(const SampleBuffer& impulseResponse, int blockSize, bool background, int maxPartitionSize = 8192);
+
+			~Convolver();
+
+			/**
+			 * Convolves one block of input. Call from the audio thread.
+			 * @param input blockSize input samples
+			 * @param output receives blockSize output samples
+			 * @return true if a background stage has new work to do and processBackground() has to be called.
+			 */
+			bool process(const SampleValue* input, SampleValue* output);
+
+			/**
+			 * Calculates the pending partitions of the background stages. Call from one background thread only.
+			 * @return true if any work has been done
+			 */
+			bool processBackground();
+
+			/**
+			 * @return the block size of process()
+			 */
+			int getBlockSize() const { return mBlockSize; }
+
+			/**
+			 * @return the number of stages the impulse response is divided into
+			 */
+			int getStageCount() const { return int(mStages.size()); }
+
+			/**
+			 * @return the number of blocks that could not be mixed in time because the background thread was late.
+			 */
+			uint64 getLateBlockCount() const { return mLateBlockCount.load(); }
+
+			/**
+			 * @return the number of partitions of input that have been left out of the background stages
+			 * because the background thread was more than two partitions behind.
+			 */
+			uint64 getDroppedPartitionCount() const { return mDroppedPartitionCount.load(); }
+
+		private:
+			class Stage;
+
+			int mBlockSize = 0;
+			bool mBackground = false;
+			std::vector<std::unique_ptr<Stage>> mStages;
+			std::atomic<uint64> mLateBlockCount = { 0 };
+			std::atomic<uint64> mDroppedPartitionCount = { 0 };
+		};
+
+	}
+}
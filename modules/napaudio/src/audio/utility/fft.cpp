@@ -0,0 +1,123 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "fft.h"
+
+// Std includes
+#include <cassert>
+#include <cmath>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		namespace
+		{
+			// Complex multiplication without the overflow and NaN handling of std::complex
+			inline FFT::Complex multiply(const FFT::Complex& a, const FFT::Complex& b)
+			{
+				return FFT::Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+			}
+		}
+
+
+		FFT::FFT(int size) : mSize(size)
+		{
+			assert(size >= 4 && (size & (size - 1)) == 0);
+			auto half = size / 2;
+
+			mTwiddles.resize(half / 2);
+			for (auto i = 0; i < half / 2; ++i)
+				mTwiddles[i] = std::polar(1.0, -2.0 * M_PI * i / half);
+
+			mRealTwiddles.resize(half);
+			for (auto i = 0; i < half; ++i)
+				mRealTwiddles[i] = std::polar(1.0, -2.0 * M_PI * i / size);
+
+			auto bits = 0;
+			while ((1 << bits) < half)
+				bits++;
+			mBitReversal.resize(half);
+			for (auto i = 0; i < half; ++i)
+			{
+				auto reversed = 0;
+				for (auto bit = 0; bit < bits; ++bit)
+					if (i & (1 << bit))
+						reversed |= 1 << (bits - 1 - bit);
+				mBitReversal[i] = reversed;
+			}
+
+			mBuffer.resize(half);
+		}
+
+
+		void FFT::forward(const float* input, Complex* output)
+		{
+			// Pack the even samples in the real part and the odd samples in the imaginary part
+			auto half = mSize / 2;
+			for (auto i = 0; i < half; ++i)
+				mBuffer[mBitReversal[i]] = Complex(input[2 * i], input[2 * i + 1]);
+			transform(mBuffer.data(), false);
+
+			// Split the spectra of the even and odd samples and combine them into the spectrum of the real signal
+			output[0] = Complex(mBuffer[0].real() + mBuffer[0].imag(), 0.f);
+			output[half] = Complex(mBuffer[0].real() - mBuffer[0].imag(), 0.f);
+			for (auto k = 1; k < half; ++k)
+			{
+				auto a = mBuffer[k];
+				auto b = std::conj(mBuffer[half - k]);
+				auto even = (a + b) * 0.5f;
+				auto difference = (a - b) * 0.5f;
+				auto odd = Complex(difference.imag(), -difference.real());
+				output[k] = even + multiply(mRealTwiddles[k], odd);
+			}
+		}
+
+
+		void FFT::inverse(const Complex* input, float* output)
+		{
+			auto half = mSize / 2;
+			for (auto k = 0; k < half; ++k)
+			{
+				auto a = input[k];
+				auto b = std::conj(input[half - k]);
+				auto even = (a + b) * 0.5f;
+				auto odd = multiply((a - b) * 0.5f, std::conj(mRealTwiddles[k]));
+				mBuffer[mBitReversal[k]] = even + Complex(-odd.imag(), odd.real());
+			}
+			transform(mBuffer.data(), true);
+
+			auto scale = 1.f / half;
+			for (auto i = 0; i < half; ++i)
+			{
+				output[2 * i] = mBuffer[i].real() * scale;
+				output[2 * i + 1] = mBuffer[i].imag() * scale;
+			}
+		}
+
+
+		void FFT::transform(Complex* data, bool inverse)
+		{
+			auto half = mSize / 2;
+			for (auto length = 2; length <= half; length <<= 1)
+			{
+				auto step = half / length;
+				auto span = length / 2;
+				for (auto start = 0; start < half; start += length)
+				{
+					for (auto j = 0; j < span; ++j)
+					{
+						auto twiddle = inverse ? std::conj(mTwiddles[j * step]) : mTwiddles[j * step];
+						auto u = data[start + j];
+						auto v = multiply(data[start + j + span], twiddle);
+						data[start + j] = u + v;
+						data[start + j + span] = u - v;
+					}
+				}
+			}
+		}
+
+	}
+}
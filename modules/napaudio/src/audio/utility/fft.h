@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <complex>
+#include <vector>
+
+// Nap includes
+#include <utility/dllexport.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Fast Fourier transform of real signals with a power of two size.
+		 * Twiddle factors and the bit reversal table are calculated on construction,
+		 * transforms do not allocate memory so they can be performed on the audio thread.
+		 * The real transform is calculated as a complex transform of half the size.
+		 * An instance is not thread safe because it uses an internal scratch buffer.
+		 */
+		class NAPAPI FFT
+		{
+		public:
+			using Complex = std::complex<float>;
+
+			/**
+			 * @param size number of real samples per transform, has to be a power of two and at least 4.
+			 */
+			FFT(int size);
+
+			/**
+			 * Transforms a real signal to its spectrum.
+			 * @param input getSize() real samples
+			 * @param output receives getBinCount() complex bins, from DC up to and including the Nyquist frequency.
+			 */
+			void forward(const float* input, Complex* output);
+
+			/**
+			 * Transforms a spectrum back to a real signal. The output is scaled so that inverse(forward(x)) equals x.
+			 * @param input getBinCount() complex bins
+			 * @param output receives getSize() real samples
+			 */
+			void inverse(const Complex* input, float* output);
+
+			/**
+			 * @return the number of real samples per transform
+			 */
+			int getSize() const { return mSize; }
+
+			/**
+			 * @return the number of complex bins in a spectrum
+			 */
+			int getBinCount() const { return mSize / 2 + 1; }
+
+		private:
+			// In place complex transform of mSize / 2 points, input has to be in bit reversed order
+			void transform(Complex* data, bool inverse);
+
+			int mSize = 0;
+			std::vector<Complex> mTwiddles;					// Twiddle factors of the half size complex transform
+			std::vector<Complex> mRealTwiddles;				// Twiddle factors to split the half size transform into the real spectrum
+			std::vector<int> mBitReversal;					// Bit reversed index for each point of the half size transform
+			std::vector<Complex> mBuffer;					// Scratch buffer for the half size transform
+		};
+
+	}
+}
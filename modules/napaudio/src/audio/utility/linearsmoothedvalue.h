@@ -36,7 +36,25 @@ namespace nap
 			 * Start a ramp
 			 * @param destination: the finishing value
 			 */
-			void setValue(const T& destination) { mNewDestination = destination; }
+			void setValue(const T& destination)
+			{
+				mNewStepCount = -1;
+				mNewDestination = destination;
+			}
+			
+			/**
+			 * Start a ramp with a step count that only applies to this ramp.
+			 * Later ramps use the step count set by setStepCount() again.
+			 * @param destination: the finishing value
+			 * @param stepCount: number of steps of this ramp
+			 */
+			void setValue(const T& destination, int stepCount)
+			{
+				if (destination == mNewDestination)
+					return;
+				mNewStepCount = stepCount;
+				mNewDestination = destination;
+			}
 			
 			/**
 			 * Take the next step in the current ramp.
@@ -47,11 +65,12 @@ namespace nap
 				if (mNewDestination != mDestination)
 				{
 					mDestination = mNewDestination;
-					mStepCounter = mStepCount;
+					mStepCounter = mNewStepCount >= 0 ? mNewStepCount : mStepCount;
+					mNewStepCount = -1;
 					if (mStepCounter == 0)
 						mValue = mDestination;
 					else
-						mIncrement = (mDestination - mValue) / T(mStepCount);
+						mIncrement = (mDestination - mValue) / T(mStepCounter);
 				}
 				
 				if (mStepCounter > 0)
@@ -86,6 +105,7 @@ namespace nap
 			T mIncrement; // Increment value per step of the current ramp when mode is linear.
 			T mDestination = 0; // Destination value of the current ramp.
 			int mStepCount = 0; // Number of steps in the ramp.
+			int mNewStepCount = -1; // Number of steps of the next ramp only, -1 to use mStepCount
 			int mStepCounter = 0; // Current step index, 0 means at destination
 		};
 		
@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <vector>
+
+// Nap includes
+#include <utility/spscqueue.h>
+
+// Audio includes
+#include <audio/utility/audiotypes.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * A timestamped parameter change that is applied by a node on the audio thread at an exact sample.
+		 */
+		struct NAPAPI ParameterEvent
+		{
+			DiscreteTimeValue mTime = 0; // Absolute sample time at which the event is applied, see NodeManager::getSampleTime()
+			ControllerValue mValue = 0; // The new value or the destination value of a ramp
+			int mStepCount = 0; // Duration of the ramp towards the value in samples, 0 means the value is set immediately
+			RampMode mMode = RampMode::Linear; // Curvature of the ramp
+		};
+
+
+		/**
+		 * Preallocated queue of timestamped parameter events owned by a node.
+		 * Events are enqueued from one control thread (main thread, sequencer thread, OSC handler) and consumed on the audio thread.
+		 * Neither side allocates memory or takes a lock, the audio thread keeps the received events sorted by time
+		 * so they can be applied sample accurately within the node's process() method.
+		 * Only one thread is allowed to enqueue events into the same queue.
+		 */
+		class NAPAPI ParameterEventQueue
+		{
+		public:
+			/**
+			 * @param capacity maximum number of events that can be pending at the same time.
+			 */
+			ParameterEventQueue(unsigned int capacity = 256) : mIncoming(capacity)
+			{
+				mPending.reserve(capacity);
+			}
+
+			/**
+			 * Enqueue an event. Call from the control thread.
+			 * @param event the event to schedule
+			 * @return false if the queue is full and the event has been discarded.
+			 */
+			bool enqueue(const ParameterEvent& event) { return mIncoming.tryEnqueue(event); }
+
+			/**
+			 * Moves all newly enqueued events into the time sorted list of pending events.
+			 * Call from the audio thread once at the start of a process() call.
+			 */
+			void collect()
+			{
+				ParameterEvent* event = mIncoming.peek();
+				while (event != nullptr && mPending.size() < mPending.capacity())
+				{
+					// The pending list is sorted in descending order of time so the first due event can be popped from the back.
+					// Events of equal time keep the order in which they were enqueued.
+					auto it = mPending.end();
+					while (it != mPending.begin() && (it - 1)->mTime <= event->mTime)
+						--it;
+					mPending.insert(it, *event);
+					mIncoming.pop();
+					event = mIncoming.peek();
+				}
+			}
+
+			/**
+			 * Pops the first pending event that is due at or before the given time. Call from the audio thread.
+			 * @param time the current sample time
+			 * @param event receives the popped event
+			 * @return false if no event is due.
+			 */
+			bool popDueEvent(DiscreteTimeValue time, ParameterEvent& event)
+			{
+				if (mPending.empty() || mPending.back().mTime > time)
+					return false;
+				event = mPending.back();
+				mPending.pop_back();
+				return true;
+			}
+
+			/**
+			 * Returns the number of samples from the given time until the next pending event, limited to a maximum.
+			 * Call from the audio thread.
+			 * @param time the current sample time
+			 * @param maximum the value that is returned when there is no pending event within maximum samples.
+			 * @return samples until the next event
+			 */
+			int getSamplesUntilNextEvent(DiscreteTimeValue time, int maximum) const
+			{
+				if (mPending.empty())
+					return maximum;
+				auto next = mPending.back().mTime;
+				if (next <= time)
+					return 0;
+				return (next - time) < DiscreteTimeValue(maximum) ? int(next - time) : maximum;
+			}
+
+			/**
+			 * Discards all pending events. Call from the audio thread.
+			 */
+			void clear()
+			{
+				ParameterEvent event;
+				while (mIncoming.tryDequeue(event));
+				mPending.clear();
+			}
+
+		private:
+			utility::SPSCQueue<ParameterEvent> mIncoming; // Events handed over from the control thread
+			std::vector<ParameterEvent> mPending; // Received events sorted by descending time, capacity is reserved on construction
+		};
+
+	}
+}
@@ -0,0 +1,196 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "resampler.h"
+
+// Std includes
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// SSE is available on all x64 targets
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define NAP_AUDIO_RESAMPLER_SSE
+	#include <xmmintrin.h>
+#endif
+
+RTTI_BEGIN_ENUM(nap::audio::EResampleQuality)
+	RTTI_ENUM_VALUE(nap::audio::EResampleQuality::Low,		"Low"),
+	RTTI_ENUM_VALUE(nap::audio::EResampleQuality::Medium,	"Medium"),
+	RTTI_ENUM_VALUE(nap::audio::EResampleQuality::High,		"High")
+RTTI_END_ENUM
+
+namespace nap
+{
+	namespace audio
+	{
+
+		namespace
+		{
+			// Number of tabulated fractional phases between two input samples
+			constexpr int phaseCount = 256;
+
+			/**
+			 * Dot product of two float arrays, count has to be a multiple of 4.
+			 */
+			inline float dotProduct(const float* a, const float* b, int count)
+			{
+#ifdef NAP_AUDIO_RESAMPLER_SSE
+				__m128 sum = _mm_setzero_ps();
+				for (auto i = 0; i < count; i += 4)
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+				sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+				sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+				return _mm_cvtss_f32(sum);
+#else
+				float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+				for (auto i = 0; i < count; i += 4)
+				{
+					sum0 += a[i] * b[i];
+					sum1 += a[i + 1] * b[i + 1];
+					sum2 += a[i + 2] * b[i + 2];
+					sum3 += a[i + 3] * b[i + 3];
+				}
+				return (sum0 + sum1) + (sum2 + sum3);
+#endif
+			}
+
+
+			/**
+			 * Double precision fallback, used when SampleValue is defined as double.
+			 */
+			inline double dotProduct(const double* a, const double* b, int count)
+			{
+				double sum = 0;
+				for (auto i = 0; i < count; ++i)
+					sum += a[i] * b[i];
+				return sum;
+			}
+
+
+			/**
+			 * Zeroth order modified Bessel function of the first kind, used to calculate the Kaiser window.
+			 */
+			double besselI0(double x)
+			{
+				double sum = 1.0;
+				double term = 1.0;
+				double halfX = x / 2.0;
+				for (auto k = 1; k < 50; ++k)
+				{
+					term *= (halfX / k) * (halfX / k);
+					sum += term;
+					if (term < sum * 1e-12)
+						break;
+				}
+				return sum;
+			}
+		}
+
+
+		ResampleKernel::ResampleKernel(EResampleQuality quality, float cutoff) : mCutoff(std::min(std::max(cutoff, 0.01f), 1.f))
+		{
+			// Zero crossings on each side of the sinc and Kaiser window shape for each quality
+			int zeroCrossings = 8;
+			double beta = 7.0;
+			switch (quality)
+			{
+				case EResampleQuality::Low:
+					zeroCrossings = 4;
+					beta = 5.0;
+					break;
+				case EResampleQuality::Medium:
+					zeroCrossings = 8;
+					beta = 7.0;
+					break;
+				case EResampleQuality::High:
+					zeroCrossings = 16;
+					beta = 9.0;
+					break;
+			}
+
+			// Lowering the cutoff widens the kernel in the input domain
+			double halfWidth = zeroCrossings / mCutoff;
+			mTapCount = 2 * int(std::ceil(halfWidth));
+			mTapCount = (mTapCount + 3) & ~3;
+			mLatency = mTapCount / 2 - 1;
+
+			// Tabulate one row of taps for each phase, including the phase at fraction 1 to interpolate towards
+			mTable.resize((phaseCount + 1) * mTapCount, 0.f);
+			double windowNormalization = 1.0 / besselI0(beta);
+			for (auto phase = 0; phase <= phaseCount; ++phase)
+			{
+				double fraction = double(phase) / phaseCount;
+				auto row = &mTable[phase * mTapCount];
+				for (auto tap = 0; tap < mTapCount; ++tap)
+				{
+					double t = (tap - mLatency) - fraction;
+					double x = t / halfWidth;
+					if (std::abs(x) >= 1.0)
+						continue;
+
+					double argument = M_PI * mCutoff * t;
+					double sinc = std::abs(argument) < 1e-9 ? 1.0 : std::sin(argument) / argument;
+					double window = besselI0(beta * std::sqrt(1.0 - x * x)) * windowNormalization;
+					row[tap] = SampleValue(mCutoff * sinc * window);
+				}
+			}
+		}
+
+
+		SampleValue ResampleKernel::interpolate(const SampleValue* input, float fraction) const
+		{
+			auto phase = fraction * phaseCount;
+			auto row = std::min(int(phase), phaseCount - 1);
+			auto weight = phase - row;
+
+			auto first = &mTable[row * mTapCount];
+			auto a = dotProduct(first, input, mTapCount);
+			auto b = dotProduct(first + mTapCount, input, mTapCount);
+			return a + weight * (b - a);
+		}
+
+
+		void resample(const SampleBuffer& input, SampleBuffer& output, float sourceSampleRate, float destinationSampleRate, EResampleQuality quality)
+		{
+			assert(sourceSampleRate > 0 && destinationSampleRate > 0);
+			if (sourceSampleRate == destinationSampleRate)
+			{
+				output = input;
+				return;
+			}
+
+			// Filter below the Nyquist frequency of the destination when downsampling
+			ResampleKernel kernel(quality, std::min(1.f, destinationSampleRate / sourceSampleRate));
+			auto tapCount = kernel.getTapCount();
+			auto latency = kernel.getLatency();
+
+			// Pad the input with silence so every output sample can read a full set of taps
+			SampleBuffer padded(latency + input.size() + tapCount, 0.f);
+			std::copy(input.begin(), input.end(), padded.begin() + latency);
+
+			double step = double(sourceSampleRate) / destinationSampleRate;
+			auto outputSize = std::size_t(std::floor(double(input.size()) * destinationSampleRate / sourceSampleRate));
+			output.resize(outputSize);
+			for (auto i = 0; i < outputSize; ++i)
+			{
+				double position = i * step;
+				auto index = std::size_t(position);
+				output[i] = kernel.interpolate(&padded[index], float(position - index));
+			}
+		}
+
+
+		void resample(MultiSampleBuffer& buffer, float sourceSampleRate, float destinationSampleRate, EResampleQuality quality)
+		{
+			SampleBuffer converted;
+			for (auto& channel : buffer.channels)
+			{
+				resample(channel, converted, sourceSampleRate, destinationSampleRate, quality);
+				channel.swap(converted);
+			}
+		}
+
+	}
+}
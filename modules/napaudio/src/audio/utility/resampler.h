@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Std includes
+#include <vector>
+
+// Nap includes
+#include <rtti/typeinfo.h>
+
+// Audio includes
+#include <audio/utility/audiotypes.h>
+
+namespace nap
+{
+	namespace audio
+	{
+
+		/**
+		 * Quality of a windowed-sinc resampler. Higher quality uses more filter taps, resulting in a steeper anti-aliasing filter at a higher CPU cost.
+		 */
+		enum class EResampleQuality : int
+		{
+			Low,			///< 8 taps, suitable for realtime playback of many voices
+			Medium,			///< 16 taps
+			High			///< 32 taps, suitable for offline conversion
+		};
+
+
+		/**
+		 * Polyphase windowed-sinc interpolation kernel.
+		 * The Kaiser windowed sinc is tabulated on construction for a fixed number of fractional phases,
+		 * interpolating a sample at a fractional position takes two SIMD dot products and a linear interpolation between adjacent phases.
+		 * The cutoff frequency is specified relative to the Nyquist frequency of the input:
+		 * when downsampling by a factor, the cutoff has to be 1 / factor to prevent aliasing, which widens the kernel by the same factor.
+		 */
+		class NAPAPI ResampleKernel
+		{
+		public:
+			/**
+			 * @param quality determines the number of taps and the window shape
+			 * @param cutoff cutoff frequency of the lowpass filter relative to the Nyquist frequency of the input, between 0 and 1.
+			 */
+			ResampleKernel(EResampleQuality quality, float cutoff = 1.f);
+
+			/**
+			 * Interpolates the input at a fractional position.
+			 * @param input pointer to the first of getTapCount() input samples. The sample at the integer part of the position is at index getLatency().
+			 * @param fraction fractional part of the position, between 0 and 1.
+			 * @return the interpolated sample
+			 */
+			SampleValue interpolate(const SampleValue* input, float fraction) const;
+
+			/**
+			 * @return the number of input samples used to interpolate one output sample. Always a multiple of 4.
+			 */
+			int getTapCount() const { return mTapCount; }
+
+			/**
+			 * @return the number of input samples preceding the interpolated position within the taps.
+			 */
+			int getLatency() const { return mLatency; }
+
+			/**
+			 * @return the cutoff frequency relative to the Nyquist frequency of the input
+			 */
+			float getCutoff() const { return mCutoff; }
+
+		private:
+			std::vector<SampleValue> mTable; // Kernel coefficients, one row of mTapCount taps for each phase
+			int mTapCount = 0;
+			int mLatency = 0;
+			float mCutoff = 1.f;
+		};
+
+
+		/**
+		 * Converts the sample rate of a buffer using a windowed-sinc resampler.
+		 * @param input buffer at the source sample rate
+		 * @param output receives the resampled material, resized to the new length
+		 * @param sourceSampleRate sample rate of the input
+		 * @param destinationSampleRate sample rate of the output
+		 * @param quality quality of the resampler
+		 */
+		void NAPAPI resample(const SampleBuffer& input, SampleBuffer& output, float sourceSampleRate, float destinationSampleRate, EResampleQuality quality);
+
+
+		/**
+		 * Converts the sample rate of all channels of a multichannel buffer in place.
+		 * @param buffer the buffer to convert
+		 * @param sourceSampleRate sample rate of the buffer
+		 * @param destinationSampleRate the sample rate to convert to
+		 * @param quality quality of the resampler
+		 */
+		void NAPAPI resample(MultiSampleBuffer& buffer, float sourceSampleRate, float destinationSampleRate, EResampleQuality quality);
+
+	}
+}
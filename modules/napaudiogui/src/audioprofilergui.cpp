@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <audioprofilergui.h>
+#include <nap/core.h>
+#include <imgui/imgui.h>
+#include <algorithm>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::AudioProfilerGUI)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY("ProcessTimingInterval",	&nap::AudioProfilerGUI::mProcessTimingInterval,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MaxProcessCount",		&nap::AudioProfilerGUI::mMaxProcessCount,		nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+namespace nap
+{
+	AudioProfilerGUI::AudioProfilerGUI(nap::Core& core) :
+		mAudioService(*core.getService<audio::AudioService>())
+	{ }
+
+
+	bool AudioProfilerGUI::init(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mProcessTimingInterval >= 0, "%s: ProcessTimingInterval can not be negative", mID.c_str()))
+			return false;
+
+		if (mProcessTimingInterval > 0)
+			mAudioService.getProfiler().setProcessTimingInterval(mProcessTimingInterval);
+		return true;
+	}
+
+
+	void AudioProfilerGUI::show(bool newWindow)
+	{
+		if (newWindow)
+			ImGui::Begin("Audio Profiler");
+
+		showStatistics();
+		showProcessTimings();
+
+		if (newWindow)
+			ImGui::End();
+	}
+
+
+	void AudioProfilerGUI::showStatistics()
+	{
+		auto& profiler = mAudioService.getProfiler();
+		const audio::AudioStatistics& statistics = profiler.getStatistics();
+
+		ImGui::Text("DSP load: %.1f%% (average %.1f%%, peak %.1f%%)", statistics.mLoad * 100.f, statistics.mAverageLoad * 100.f, statistics.mPeakLoad * 100.f);
+		ImGui::ProgressBar(statistics.mAverageLoad, ImVec2(-1, 0));
+		ImGui::Text("Callback: %.0f us of %.0f us", statistics.mDuration, statistics.mPeriod);
+		ImGui::Text("Callbacks: %llu, overloads: %llu", (unsigned long long)statistics.mCallbackCount, (unsigned long long)statistics.mOverloadCount);
+		ImGui::Text("Output underflows: %llu, overflows: %llu", (unsigned long long)statistics.mOutputUnderflowCount, (unsigned long long)statistics.mOutputOverflowCount);
+		ImGui::Text("Input underflows: %llu, overflows: %llu", (unsigned long long)statistics.mInputUnderflowCount, (unsigned long long)statistics.mInputOverflowCount);
+
+		// Histogram of the callback load in buckets of 10%
+		float histogram[audio::AudioStatistics::histogramSize];
+		for (auto i = 0; i < audio::AudioStatistics::histogramSize; ++i)
+			histogram[i] = float(statistics.mHistogram[i]);
+		ImGui::PlotHistogram("Load", histogram, audio::AudioStatistics::histogramSize, 0, "0% - 200%", 0.f, FLT_MAX, ImVec2(0, 80));
+
+		if (ImGui::Button("Reset"))
+			profiler.reset();
+	}
+
+
+	void AudioProfilerGUI::showProcessTimings()
+	{
+		auto& profiler = mAudioService.getProfiler();
+		if (!ImGui::CollapsingHeader("Nodes"))
+			return;
+
+		int interval = profiler.getProcessTimingInterval();
+		if (ImGui::InputInt("Interval", &interval))
+			profiler.setProcessTimingInterval(std::max(interval, 0));
+
+		if (interval == 0)
+		{
+			ImGui::Text("Node timing is disabled");
+			return;
+		}
+
+		ImGui::Columns(2, "nodes");
+		ImGui::Text("Node");
+		ImGui::NextColumn();
+		ImGui::Text("Self time (us)");
+		ImGui::NextColumn();
+		ImGui::Separator();
+
+		auto& timings = profiler.getProcessTimings();
+		auto count = std::min<int>(timings.size(), mMaxProcessCount);
+		for (auto i = 0; i < count; ++i)
+		{
+			ImGui::Text("%s", timings[i].mTypeName);
+			ImGui::NextColumn();
+			ImGui::Text("%.1f", timings[i].mDuration);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+	}
+}
@@ -0,0 +1,49 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <utility/dllexport.h>
+#include <nap/resource.h>
+#include <audio/service/audioservice.h>
+
+namespace nap
+{
+	/**
+	 * Shows an ImGUI window with the performance statistics of the audio callback:
+	 * the DSP load, a histogram of the callback durations, the xruns reported by the driver
+	 * and, when per node timing is enabled, the most expensive nodes.
+	 * Call show() every frame on update(). The statistics are acquired by the audio service on its update.
+	 */
+	class NAPAPI AudioProfilerGUI : public Resource
+	{
+		RTTI_ENABLE(Resource)
+	public:
+		AudioProfilerGUI(nap::Core& core);
+
+		/**
+		 * Display the statistics as UI elements. Should be called each frame on update().
+		 * When 'newWindow' is set to true a new window will be created.
+		 * When 'newWindow' is disabled the statistics will be added to the currently active GUI window.
+		 * @param newWindow if the statistics should be added to a new window.
+		 */
+		void show(bool newWindow = true);
+
+		/**
+		 * Initializes the profiler GUI
+		 * @param errorState contains the error if initialization failed
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		int mProcessTimingInterval = 0;			///< Property: 'ProcessTimingInterval' number of callbacks between two measurements of the nodes, 0 leaves the interval of the audio service untouched.
+		int mMaxProcessCount = 16;				///< Property: 'MaxProcessCount' maximum number of nodes listed, starting with the most expensive one.
+
+	private:
+		void showStatistics();
+		void showProcessTimings();
+
+		audio::AudioService& mAudioService;		///< The audio service
+	};
+}
@@ -9,6 +9,9 @@
 #include <rtti/object.h>
 #include <glm/glm.hpp>
 #include <nap/resource.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace nap
 {
@@ -131,6 +134,23 @@ namespace nap
 			 */
 			V evaluate(const T& t);
 
+			/**
+			 * Evaluate this curve at multiple points in time.
+			 * Faster than evaluating every time separately when the times are in ascending order:
+			 * a curve segment is prepared once for all consecutive times that fall within it.
+			 * @param times points in time to get the interpolated curve values for
+			 * @param outValues receives the evaluated values, must hold at least count values
+			 * @param count number of times to evaluate
+			 */
+			void evaluate(const T* times, V* outValues, int count);
+
+			/**
+			 * Evaluate this curve at multiple points in time.
+			 * @param times points in time to get the interpolated curve values for
+			 * @param outValues the evaluated values, resized to match the number of times
+			 */
+			void evaluate(const std::vector<T>& times, std::vector<V>& outValues);
+
 			/**
 			 * Mark curve as dirty and ensure points are sorted on next evaluation
 			 */
@@ -142,23 +162,56 @@ namespace nap
 			std::vector<FCurvePoint<T, V>> mPoints;
 
 		private:
+			/**
+			 * Curve segment in between two points, prepared for evaluation
+			 */
+			struct Segment
+			{
+				FComplex<T, V>	mPoints[4];			///< Control points, tangents limited to the segment
+				T				mCoefficients[4];	///< Time polynomial: x(t) = ((a * t + b) * t + c) * t + d
+				ECurveInterp	mInterp;			///< Interpolation of the segment
+			};
+
+			/**
+			 * Prepares the segment that starts at the given sorted point for evaluation
+			 * @param index index of the sorted point the segment starts at
+			 * @param outSegment the prepared segment
+			 */
+			void prepareSegment(int index, Segment& outSegment);
+
+			/**
+			 * Evaluates a prepared segment at time x
+			 * @param segment the prepared segment
+			 * @param x time input value in cartesian space
+			 * @return vertical component of the evaluated curve segment at time x
+			 */
+			V evalSegment(const Segment& segment, T x);
+
             /**
              * Evaluate a clamped bezier curve at time t
              */
             FComplex<T, V>  bezier(const FComplex<T, V> (& pts)[4], T t);
 
             /**
-             * Do a binary search on a curve for the t value at position x
-             * ie. Convert a time value in cartesian space into a parametric t value.
-             * @tparam P 2D point, its components should be of type U
-             * @tparam T floating point
-             * @param pts The curve points to evaluate
+             * Convert a time value in cartesian space into a parametric t value.
+             * Uses Newton-Raphson iteration on the time polynomial of the segment, starting at the linear estimate.
+             * When that fails to converge, the cubic is solved analytically, with a binary search as last resort.
+             * @param segment The prepared curve segment
              * @param x Time input value in cartesian space
              * @param threshold The desired precision of the result
-             * @param maxIterations Max number of tries to get to the desired precision
-             * @return
+             * @param maxIterations Max number of binary search iterations to get to the desired precision
+             * @return parametric t value at x
              */
-            T tForX(const FComplex<T, V> (& pts)[4], T x, T threshold = 0.0001, int maxIterations = 100);
+            T tForX(const Segment& segment, T x, T threshold = 0.0001, int maxIterations = 100);
+
+			/**
+			 * Finds the root of x(t) = x in the range 0-1, using the closed form solution of the cubic
+			 * @param coefficients time polynomial coefficients of the segment
+			 * @param x time input value in cartesian space
+			 * @param outT the parametric t value at x
+			 * @return if a root in range was found
+			 */
+			static bool solveCubic(const T (&coefficients)[4], T x, T& outT);
 
 			/**
 			 * linear interpolate value a to b using a value of t (0-1)
@@ -172,13 +225,11 @@ namespace nap
             /**
              * Evaluate a curve segment using cubic bezier interpolation
              *
-             * @tparam P 2D point, its components should be of type U
-             * @tparam T floating point
-             * @param pts The curve points to evaluate
+             * @param segment The prepared curve segment
              * @param x Time input value in cartesian space
              * @return Vertical component of the evaluated curve segment at time x
              */
-            V evalCurveSegmentBezier(const nap::math::FComplex<T, V> (& pts)[4], T x);
+            V evalCurveSegmentBezier(const Segment& segment, T x);
 
 			/**
 			 * Evaluate a curve segment using linear interpolation
@@ -293,28 +344,103 @@ namespace nap
 			if (t >= lastPoint->mPos.mTime)
 				return lastPoint->mPos.mValue;
 
-			int idx = pointIndexAtTime(t);
-			const FCurvePoint<T, V>* curr = mSortedPoints[idx];
-			const FCurvePoint<T, V>* next = mSortedPoints[idx + 1];
+			Segment segment;
+			prepareSegment(pointIndexAtTime(t), segment);
+			return evalSegment(segment, t);
+		}
 
-			auto a = curr->mPos;
-			auto b = a + curr->mOutTan;
-			auto d = next->mPos;
-			auto c = d + next->mInTan;
+		template<typename T, typename V>
+		void nap::math::FCurve<T, V>::evaluate(const T* times, V* outValues, int count)
+		{
+			if (mPoints.empty())
+			{
+				std::fill(outValues, outValues + count, V());
+				return;
+			}
+
+			// Ensure points are sorted before evaluation
+			if (!mPointsSorted)
+			{
+				sortPoints();
+				mPointsSorted = true;
+			}
+
+			const FCurvePoint<T, V>* firstPoint = mSortedPoints[0];
+			const FCurvePoint<T, V>* lastPoint = mSortedPoints[mSortedPoints.size() - 1];
 
-			limitOverhangPoints(a, b, c, d);
-			switch (curr->mInterp)
+			Segment segment;
+			int current = -1;
+			for (int i = 0; i < count; i++)
+			{
+				const T& t = times[i];
+				if (t < firstPoint->mPos.mTime)
+				{
+					outValues[i] = firstPoint->mPos.mValue;
+					continue;
+				}
+
+				if (t >= lastPoint->mPos.mTime)
+				{
+					outValues[i] = lastPoint->mPos.mValue;
+					continue;
+				}
+
+				// Only prepare a new segment when time leaves the current one
+				if (current < 0 || t < mSortedPoints[current]->mPos.mTime || t >= mSortedPoints[current + 1]->mPos.mTime)
+				{
+					current = pointIndexAtTime(t);
+					prepareSegment(current, segment);
+				}
+				outValues[i] = evalSegment(segment, t);
+			}
+		}
+
+		template<typename T, typename V>
+		void nap::math::FCurve<T, V>::evaluate(const std::vector<T>& times, std::vector<V>& outValues)
+		{
+			outValues.resize(times.size());
+			evaluate(times.data(), outValues.data(), static_cast<int>(times.size()));
+		}
+
+		template<typename T, typename V>
+		void nap::math::FCurve<T, V>::prepareSegment(int index, Segment& outSegment)
+		{
+			const FCurvePoint<T, V>* curr = mSortedPoints[index];
+			const FCurvePoint<T, V>* next = mSortedPoints[index + 1];
+
+			FComplex<T, V>* pts = outSegment.mPoints;
+			pts[0] = curr->mPos;
+			pts[1] = pts[0] + curr->mOutTan;
+			pts[3] = next->mPos;
+			pts[2] = pts[3] + next->mInTan;
+			limitOverhangPoints(pts[0], pts[1], pts[2], pts[3]);
+			outSegment.mInterp = curr->mInterp;
+
+			// Power basis of the time component, evaluated using Horner's method
+			T x0 = pts[0].mTime;
+			T x1 = pts[1].mTime;
+			T x2 = pts[2].mTime;
+			T x3 = pts[3].mTime;
+			outSegment.mCoefficients[0] = x3 - 3 * x2 + 3 * x1 - x0;
+			outSegment.mCoefficients[1] = 3 * (x2 - 2 * x1 + x0);
+			outSegment.mCoefficients[2] = 3 * (x1 - x0);
+			outSegment.mCoefficients[3] = x0;
+		}
+
+		template<typename T, typename V>
+		V nap::math::FCurve<T, V>::evalSegment(const Segment& segment, T x)
+		{
+			switch (segment.mInterp)
 			{
 			case ECurveInterp::Bezier:
-				return evalCurveSegmentBezier({ a, b, c, d }, t);
+				return evalCurveSegmentBezier(segment, x);
 			case ECurveInterp::Linear:
-				return evalCurveSegmentLinear({ a, b, c, d }, t);
+				return evalCurveSegmentLinear(segment.mPoints, x);
 			case ECurveInterp::Stepped:
-				return evalCurveSegmentStepped({ a, b, c, d }, t);
+				return evalCurveSegmentStepped(segment.mPoints, x);
 			default:
 				assert(false);
 			}
-
 			return V();
 		}
 
@@ -331,23 +457,131 @@ namespace nap
 
 
 		template<typename T, typename V>
-		T nap::math::FCurve<T, V>::tForX(const FComplex<T, V>(&pts)[4], T x, T threshold /*= 0.0001*/, int maxIterations /*= 100*/)
+		T nap::math::FCurve<T, V>::tForX(const Segment& segment, T x, T threshold /*= 0.0001*/, int maxIterations /*= 100*/)
 		{
-			T depth = 0.5;
-			T t = 0.5;
+			const T (&c)[4] = segment.mCoefficients;
+			auto time_at = [&c](T t) { return ((c[0] * t + c[1]) * t + c[2]) * t + c[3]; };
+
+			// Newton-Raphson, starting at the linear estimate, converges in a couple of iterations
+			T x0 = segment.mPoints[0].mTime;
+			T x3 = segment.mPoints[3].mTime;
+			T t = x3 > x0 ? (x - x0) / (x3 - x0) : static_cast<T>(0.5);
+			for (int i = 0; i < 8; i++)
+			{
+				T dx = time_at(t) - x;
+				T slope = (3 * c[0] * t + 2 * c[1]) * t + c[2];
+				if (std::abs(slope) < static_cast<T>(1e-6))
+				{
+					if (std::abs(dx) <= threshold)
+						return t;
+					break;
+				}
+
+				// The step taken after reaching the threshold refines the result at little cost
+				T next = t - dx / slope;
+				if (std::abs(dx) <= threshold)
+					return next >= 0 && next <= 1 ? next : t;
+
+				if (next < 0 || next > 1)
+					break;
+				t = next;
+			}
+
+			// Flat or ill-conditioned, solve analytically
+			if (solveCubic(c, x, t) && std::abs(time_at(t) - x) <= threshold)
+				return t;
+
+			// Binary search, time is monotonic within a segment
+			T lower = 0;
+			T upper = 1;
+			t = static_cast<T>(0.5);
 			for (int i = 0; i < maxIterations; i++)
 			{
-				auto dx = x - bezier(pts, t).mTime;
-				auto adx = std::abs(dx);
-				if (adx <= threshold)
+				T dx = time_at(t) - x;
+				if (std::abs(dx) <= threshold)
 					break;
 
-				depth *= 0.5;
-				t += (dx > 0) ? depth : -depth;
+				if (dx < 0)
+					lower = t;
+				else
+					upper = t;
+				t = (lower + upper) * static_cast<T>(0.5);
 			}
 			return t;
 		}
 
+		template<typename T, typename V>
+		bool nap::math::FCurve<T, V>::solveCubic(const T (&coefficients)[4], T x, T& outT)
+		{
+			// Solved in double precision, the closed form is sensitive to cancellation
+			const double epsilon = 1e-9;
+			double a = static_cast<double>(coefficients[0]);
+			double b = static_cast<double>(coefficients[1]);
+			double c = static_cast<double>(coefficients[2]);
+			double d = static_cast<double>(coefficients[3]) - static_cast<double>(x);
+
+			double roots[3];
+			int count = 0;
+			if (std::abs(a) < epsilon)
+			{
+				if (std::abs(b) < epsilon)
+				{
+					// Linear
+					if (std::abs(c) < epsilon)
+						return false;
+					roots[count++] = -d / c;
+				}
+				else
+				{
+					// Quadratic
+					double discriminant = c * c - 4.0 * b * d;
+					if (discriminant < 0.0)
+						return false;
+					double root = std::sqrt(discriminant);
+					roots[count++] = (-c + root) / (2.0 * b);
+					roots[count++] = (-c - root) / (2.0 * b);
+				}
+			}
+			else
+			{
+				// Depressed cubic y^3 + py + q = 0, where t = y - b / 3a
+				double A = b / a;
+				double B = c / a;
+				double C = d / a;
+				double p = B - A * A / 3.0;
+				double q = 2.0 * A * A * A / 27.0 - A * B / 3.0 + C;
+				double offset = -A / 3.0;
+				double discriminant = q * q / 4.0 + p * p * p / 27.0;
+				if (discriminant >= 0.0)
+				{
+					// Single real root (Cardano)
+					double root = std::sqrt(discriminant);
+					roots[count++] = std::cbrt(-q / 2.0 + root) + std::cbrt(-q / 2.0 - root) + offset;
+				}
+				else
+				{
+					// Three real roots (trigonometric)
+					double r = std::sqrt(-p / 3.0);
+					double phi = std::acos(std::max(-1.0, std::min(1.0, -q / (2.0 * r * r * r))));
+					const double pi = 3.14159265358979323846;
+					for (int k = 0; k < 3; k++)
+						roots[count++] = 2.0 * r * std::cos((phi + 2.0 * pi * k) / 3.0) + offset;
+				}
+			}
+
+			// Accept the first root within the segment
+			const double tolerance = 1e-6;
+			for (int i = 0; i < count; i++)
+			{
+				if (roots[i] >= -tolerance && roots[i] <= 1.0 + tolerance)
+				{
+					outT = static_cast<T>(std::max(0.0, std::min(1.0, roots[i])));
+					return true;
+				}
+			}
+			return false;
+		}
+
 		template<typename T, typename V>
 		V nap::math::FCurve<T, V>::lerp(const V& a, const V& b, const T& t)
 		{
@@ -355,10 +589,10 @@ namespace nap
 		}
 
 		template<typename T, typename V>
-		V nap::math::FCurve<T, V>::evalCurveSegmentBezier(const nap::math::FComplex<T, V>(&pts)[4], T x)
+		V nap::math::FCurve<T, V>::evalCurveSegmentBezier(const Segment& segment, T x)
 		{
-			T t = tForX(pts, x);
-			return bezier(pts, t).mValue;
+			T t = tForX(segment, x);
+			return bezier(segment.mPoints, t).mValue;
 		}
 
 		template<typename T, typename V>
@@ -394,17 +628,13 @@ namespace nap
 		template<typename T, typename V>
 		int nap::math::FCurve<T, V>::pointIndexAtTime(const T& t) const
 		{
-			for (size_t i = 0, len = mSortedPoints.size(); i < len; i++)
+			// First point after t
+			auto it = std::upper_bound(mSortedPoints.begin(), mSortedPoints.end(), t, [](const T& time, const FCurvePoint<T, V>* point)
 			{
-				if (t < mSortedPoints[i]->mPos.mTime)
-				{
-					if (i == 0)
-						return 0;
-					return static_cast<int>(i - 1);
-				}
-			}
-			assert(false);
-			return -1;
+				return time < point->mPos.mTime;
+			});
+			assert(it != mSortedPoints.end());
+			return it == mSortedPoints.begin() ? 0 : static_cast<int>(it - mSortedPoints.begin()) - 1;
 		}
 
 		template<typename T, typename V>
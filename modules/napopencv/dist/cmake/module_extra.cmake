@@ -9,11 +9,15 @@ if(NOT TARGET OpenCV)
     endif()
 endif()
 
+# find FFmpeg package, used to receive low latency network streams
+find_package(FFmpeg REQUIRED)
+
 # add includes
 add_include_to_interface_target(mod_napopencv ${OpenCV_INCLUDE_DIRS})
+add_include_to_interface_target(mod_napopencv ${FFMPEG_INCLUDE_DIR})
 
 # add libraries
-set(MODULE_NAME_EXTRA_LIBS ${OpenCV_LIBS})
+set(MODULE_NAME_EXTRA_LIBS ${OpenCV_LIBS} ${FFMPEG_LIBRARIES})
 
 # Copy over opencv dll's to build directory 
 if(WIN32)
@@ -33,6 +37,17 @@ if(WIN32)
     file(GLOB CV_FFMPEG_DLLS ${THIRDPARTY_DIR}/opencv/x64/vc14/bin/opencv_videoio_ffmpeg*${CMAKE_SHARED_LIBRARY_SUFFIX}*)
     copy_files_to_bin(${CV_FFMPEG_DLLS})
 
+    # copy ffmpeg for the stream receiver
+    get_filename_component(FFMPEG_LIB_DIR ${FFMPEG_LIBAVCODEC} DIRECTORY)
+    file(GLOB FFMPEG_DLLS ${FFMPEG_LIB_DIR}/../bin/*.dll)
+    foreach (SINGLE_DLL ${FFMPEG_DLLS})
+        add_custom_command(
+            TARGET ${PROJECT_NAME}
+            POST_BUILD
+            COMMAND ${CMAKE_COMMAND} -E copy ${SINGLE_DLL} $<TARGET_FILE_DIR:${PROJECT_NAME}>
+        )
+    endforeach()
+
     # Install OpenCV license into packaged project
     install(FILES ${THIRDPARTY_DIR}/opencv/LICENSE DESTINATION licenses/opencv)
 
@@ -52,22 +52,24 @@ namespace nap
 
 	bool CVAdapter::isOpen() const
 	{
-		return mCaptureDevice.isOpened();
+		return mOpen;
 	}
 
 
 	bool CVAdapter::open(utility::ErrorState& errorState)
 	{
-		return onOpen(mCaptureDevice, static_cast<int>(mAPIPreference), errorState);
+		mOpen = onOpen(mCaptureDevice, static_cast<int>(mAPIPreference), errorState);
+		return mOpen;
 	}
 
 
 	void CVAdapter::close()
 	{
-		if (mCaptureDevice.isOpened())
+		if (mOpen)
 		{
 			mCaptureDevice.release();
 			onClose();
+			mOpen = false;
 		}
 	}
 
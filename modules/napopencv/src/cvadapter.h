@@ -7,6 +7,7 @@
 // Local Includes
 #include "cvcaptureapi.h"
 #include "cvframe.h"
+#include "cvframepool.h"
 #include "cvcaptureerror.h"
 
 // External Includes
@@ -132,6 +133,14 @@ namespace nap
 		 */
 		virtual CVFrame onRetrieve(cv::VideoCapture& captureDevice, utility::ErrorState& error) = 0;
 
+		/**
+		 * Grabs the next frame, the frame is decoded in onRetrieve().
+		 * Can be implemented in a derived class that doesn't capture frames using the OpenCV capture device.
+		 * @param captureDevice the device to grab the frame from.
+		 * @return if a new frame is grabbed.
+		 */
+		virtual bool onGrab(cv::VideoCapture& captureDevice)		{ return captureDevice.grab(); }
+
 		/**
 		 * Called right after the frame is stored. Can be implemented in a derived class.
 		 */
@@ -152,6 +161,14 @@ namespace nap
 		 */
 		CVCaptureDevice& getParent() const;
 
+		/**
+		 * Returns the pool used to recycle captured frames.
+		 * Derived classes should return a copy from the pool in onRetrieve() instead of a clone,
+		 * which avoids a new allocation for every captured frame.
+		 * @return the pool used to recycle captured frames.
+		 */
+		CVFramePool& getFramePool()								{ return mFramePool; }
+
 	private:
 		friend class CVCaptureDevice;
 
@@ -167,6 +184,12 @@ namespace nap
 		 */
 		virtual void close() final;
 
+		/**
+		 * Called by the capture device to grab the next frame.
+		 * @return if a new frame is grabbed.
+		 */
+		bool grab()												{ return onGrab(mCaptureDevice); }
+
 		/**
 		 * Called by the capture device to retrieve recently grabbed frame.
 		 * @param error contains the error if the operation fails
@@ -181,5 +204,7 @@ namespace nap
 
 		CVCaptureDevice*	mParent;				///< The nap parent capture device
 		cv::VideoCapture	mCaptureDevice;			///< The open-cv video capture device
+		CVFramePool			mFramePool;				///< Recycles the frames returned by onRetrieve()
+		bool				mOpen = false;			///< If the adapter is open
 	};
 }
@@ -197,7 +197,7 @@ namespace nap
 		else
 			mOutputFrame[0] = mCaptureFrame[0];
 
-		// Clone frame
-		return mOutputFrame.clone();
+		// Copy into a recycled frame
+		return getFramePool().copy(mOutputFrame);
 	}
 }
\ No newline at end of file
@@ -284,7 +284,7 @@ namespace nap
 				
 				// Attempt to grab frame, close adapter is operation fails.
 				// Closing the adapter ensures it is skipped on the next capture operation
-				if (!cur_adapter->getCaptureDevice().grab())
+				if (!cur_adapter->grab())
 				{
 					if (cur_adapter->mCloseOnCaptureError)
 						cur_adapter->close();
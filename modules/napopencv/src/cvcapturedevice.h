@@ -78,6 +78,8 @@ namespace nap
 		/*
 		 * Grabs the last captured frame. The result is copied over into the given target.
 		 * This call performs a reference based copy operation by default that is thread safe.
+		 * Captured frames are recycled by a nap::CVFramePool and never written to while referenced,
+		 * a deep copy is therefore only required when the content of the frame is modified.
 		 * Set the 'copy' flag to true when a deep copy of the last frame is required.
 		 * use newFrame() to figure out if a new frame is available before grabbing it.
 		 * 
@@ -175,8 +177,9 @@ namespace nap
 		/**
 		 * Occurs when a new frame is captured on the background thread.
 		 * Listen to this signal when you want to process frame data on a background thread.
+		 * Use a nap::CVPipeline to run multiple analysis stages concurrently on the captured frames.
 		 * Use the CVFrameEvent::copyTo() or CVFrameEvent::clone() method to duplicate 
-		 * the actual content of a frame when received.
+		 * the actual content of a frame when it needs to be modified.
 		 */
 		nap::Signal<const CVFrameEvent&> frameCaptured;
 
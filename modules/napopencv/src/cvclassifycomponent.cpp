@@ -7,13 +7,24 @@
 // External Includes
 #include <entity.h>
 #include <nap/logger.h>
+#include <opencv2/core/utility.hpp>
+#include <chrono>
+#include <cmath>
 
 // nap::cascadeclassifycomponent run time class definition 
 RTTI_BEGIN_CLASS(nap::CVClassifyComponent)
 	RTTI_PROPERTY("CaptureComponent",	&nap::CVClassifyComponent::mCaptureComponent,	nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("Adapter",			&nap::CVClassifyComponent::mAdapter,			nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("MatrixIndex",		&nap::CVClassifyComponent::mMatrixIndex,		nap::rtti::EPropertyMetaData::Default)
-	RTTI_PROPERTY("Path",				&nap::CVClassifyComponent::mPath,				nap::rtti::EPropertyMetaData::Required | nap::rtti::EPropertyMetaData::FileLink)
+	RTTI_PROPERTY("Path",				&nap::CVClassifyComponent::mPath,				nap::rtti::EPropertyMetaData::Default | nap::rtti::EPropertyMetaData::FileLink)
+	RTTI_PROPERTY("Pipeline",			&nap::CVClassifyComponent::mPipeline,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Network",			&nap::CVClassifyComponent::mNetwork,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Threads",			&nap::CVClassifyComponent::mThreads,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ScaleFactor",		&nap::CVClassifyComponent::mScaleFactor,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MinNeighbors",		&nap::CVClassifyComponent::mMinNeighbors,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MinSize",			&nap::CVClassifyComponent::mMinSize,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("DetectInterval",		&nap::CVClassifyComponent::mDetectInterval,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TrackScore",			&nap::CVClassifyComponent::mTrackScore,			nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 // nap::cascadeclassifycomponentInstance run time class definition 
@@ -29,6 +40,13 @@ namespace nap
 
 	CVClassifyComponentInstance::~CVClassifyComponentInstance()
 	{
+		// Stop receiving frames from the pipeline
+		if (mPipeline != nullptr)
+		{
+			mPipeline->removeStage(*this);
+			return;
+		}
+
 		{
 			// Stop detection thread and notify worker
 			std::lock_guard<std::mutex> lock(mClassifyMutex);
@@ -61,11 +79,48 @@ namespace nap
 			mAdapter->mID.c_str(), mAdapter->getMatrixCount()))
 			return false;
 
-		// Load the cascade
-		if (!errorState.check(mClassifier.load(resource->mPath), "%s: unable to load cascade: %s",
-			this->mID.c_str(), resource->mPath.c_str()))
+		// Validate detection settings
+		if (!errorState.check(resource->mThreads > 0, "%s: thread count must be at least 1", resource->mID.c_str()))
+			return false;
+
+		if (!errorState.check(resource->mScaleFactor > 1.0f, "%s: scale factor must be higher than 1", resource->mID.c_str()))
+			return false;
+
+		if (!errorState.check(resource->mDetectInterval > 0, "%s: detect interval must be at least 1", resource->mID.c_str()))
 			return false;
 
+		mScaleFactor = resource->mScaleFactor;
+		mMinNeighbors = resource->mMinNeighbors;
+		mMinSize = resource->mMinSize;
+		mDetectInterval = resource->mDetectInterval;
+		mTracker.mMinScore = resource->mTrackScore;
+		mNetwork = resource->mNetwork.get();
+
+		// Load a cascade for every thread when no network is given, classifiers can't be shared between threads
+		if (mNetwork == nullptr)
+		{
+			mClassifiers.resize(resource->mThreads);
+			for (auto& classifier : mClassifiers)
+			{
+				if (!errorState.check(classifier.load(resource->mPath), "%s: unable to load cascade: %s",
+					this->mID.c_str(), resource->mPath.c_str()))
+					return false;
+			}
+		}
+
+		// Run as a stage of the pipeline when given, the pipeline must process frames of the same adapter
+		if (resource->mPipeline != nullptr)
+		{
+			if (!errorState.check(resource->mPipeline->mAdapter.get() == mAdapter && resource->mPipeline->mMatrixIndex == mMatrixIndex,
+				"%s: pipeline: %s does not process matrix %d of adapter: %s", resource->mID.c_str(),
+				resource->mPipeline->mID.c_str(), mMatrixIndex, mAdapter->mID.c_str()))
+				return false;
+
+			mPipeline = resource->mPipeline.get();
+			mPipeline->addStage(*this);
+			return true;
+		}
+
 		// Assign slot when new frame is captured
 		mCaptureComponent->frameReceived.connect(mCaptureSlot);
 
@@ -85,33 +140,53 @@ namespace nap
 	}
 
 
+	CVDetectionStatistics CVClassifyComponentInstance::getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(mObjectMutex);
+		return mStatistics;
+	}
+
+
 	void CVClassifyComponentInstance::onFrameCaptured(const CVFrameEvent& frameEvent)
 	{
 		const CVFrame* frame = frameEvent.findFrame(*mAdapter);
 		if (frame == nullptr)
 			return;
 
-		// Store frame for processing
+		// Store frame for processing, replaces the previous frame if it hasn't been processed yet
+		bool dropped = false;
 		{
 			std::lock_guard<std::mutex> lock(mClassifyMutex);
+			dropped = mClassify;
 			mCapturedFrame = *frame;
+			mCaptureTime = HighResolutionClock::now();
 			mClassify = true;
 		}
 		mClassifyCondition.notify_one();
+
+		if (dropped)
+		{
+			std::lock_guard<std::mutex> lock(mObjectMutex);
+			mStatistics.mDropped++;
+		}
 	}
 
 
-	void CVClassifyComponentInstance::detectTask()
+	void CVClassifyComponentInstance::process(const CVFrame& frame, const CVFrame& converted)
 	{
-		CVFrame process_frame, gray_frame;
-		gray_frame.addNew();
-		std::vector<cv::Rect> cv_objects;
-		std::vector<math::Rect> na_objects;
+		classify(frame[mMatrixIndex], converted[0], HighResolutionClock::now());
+	}
 
+
+	void CVClassifyComponentInstance::detectTask()
+	{
+		CVFrame process_frame;
+		HighResTimeStamp capture_time;
 		while (!mStopClassification)
 		{
 			// Wait for the detect condition to be true.
-			// When this happens copy all the properties to set in order to release lock
+			// When this happens take a reference to the frame to release the lock.
+			// Captured frames are never written to while referenced, no copy is required.
 			{
 				std::unique_lock<std::mutex> lock(mClassifyMutex);
 				mClassifyCondition.wait(lock, [this]()
@@ -123,25 +198,113 @@ namespace nap
 				if (mStopClassification)
 					break;
 
-				// Copy and clear
-				mCapturedFrame.copyTo(process_frame);
+				// Take and clear
+				process_frame = std::move(mCapturedFrame);
+				capture_time = mCaptureTime;
 				mClassify = false;
 			}
 
-			// Convert to grey scale and equalize history
-			cvtColor(process_frame[0], gray_frame[0], cv::COLOR_BGR2GRAY);
-			equalizeHist(gray_frame[0], gray_frame[0]);
+			classify(process_frame[mMatrixIndex], process_frame[mMatrixIndex], capture_time);
+			process_frame.clear();
+		}
+	}
 
-			// Detect and store
-			mClassifier.detectMultiScale(gray_frame[0], cv_objects);
 
-			// Copy over rects
-			na_objects.clear();
-			for (auto& rect : cv_objects)
-				na_objects.emplace_back(math::Rect(rect.x, rect.y, rect.width, rect.height));
+	void CVClassifyComponentInstance::classify(const cv::UMat& matrix, const cv::UMat& converted, const HighResTimeStamp& receiveTime)
+	{
+		// Run the full detector every 'DetectInterval' frames, track objects in between
+		bool detect = (mFrameCount++ % mDetectInterval) == 0;
+		bool track = mDetectInterval > 1;
 
-			std::lock_guard<std::mutex> lock(mObjectMutex);
-			mObjects = na_objects;
+		// Gray scale, equalized version of the frame for the cascade classifier and tracker.
+		// The input frames are shared, the result is always written to a matrix owned by this component.
+		cv::Mat gray;
+		if (mNetwork == nullptr || track)
+		{
+			const cv::UMat& source = converted.channels() == 1 ? converted : matrix;
+			if (source.channels() == 1)
+				equalizeHist(source, mGrayMatrix);
+			else
+			{
+				cvtColor(source, mGrayMatrix, source.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+				equalizeHist(mGrayMatrix, mGrayMatrix);
+			}
+			gray = mGrayMatrix.getMat(cv::ACCESS_READ);
 		}
+
+		// Detect or track
+		if (detect)
+		{
+			if (mNetwork != nullptr)
+				mNetwork->detect(matrix, mAdapter, mCVObjects);
+			else
+				detectCascade(gray);
+
+			if (track)
+				mTracker.reset(gray, mCVObjects);
+		}
+		else
+		{
+			mTracker.update(gray, mCVObjects);
+		}
+
+		// Copy over rects
+		std::vector<math::Rect> na_objects;
+		na_objects.reserve(mCVObjects.size());
+		for (auto& rect : mCVObjects)
+			na_objects.emplace_back(math::Rect(rect.x, rect.y, rect.width, rect.height));
+
+		HighResTimeStamp time = HighResolutionClock::now();
+		std::lock_guard<std::mutex> lock(mObjectMutex);
+		mObjects = std::move(na_objects);
+		mStatistics.record(std::chrono::duration<double, std::milli>(time - receiveTime).count(), time);
+		if (detect)
+			mStatistics.mDetected++;
+		else
+			mStatistics.mTracked++;
+	}
+
+
+	void CVClassifyComponentInstance::detectCascade(const cv::Mat& gray)
+	{
+		// Range of object scales, relative to the cascade window
+		int count = static_cast<int>(mClassifiers.size());
+		cv::Size window = mClassifiers[0].getOriginalWindowSize();
+		float min_scale = std::max(1.0f, static_cast<float>(mMinSize) / static_cast<float>(std::min(window.width, window.height)));
+		float max_scale = std::min(static_cast<float>(gray.cols) / window.width, static_cast<float>(gray.rows) / window.height);
+		cv::Size min_size(static_cast<int>(window.width * min_scale), static_cast<int>(window.height * min_scale));
+
+		// Single range
+		if (count == 1 || max_scale <= min_scale)
+		{
+			mClassifiers[0].detectMultiScale(gray, mCVObjects, mScaleFactor, mMinNeighbors, 0, min_size);
+			return;
+		}
+
+		// Split the pyramid in ranges that cost about the same to evaluate.
+		// The cost of a single level is proportional to the number of windows: 1 / scale^2, levels are spaced geometrically.
+		// The cost up to scale s is therefore proportional to: 1 / min^2 - 1 / s^2, which is inverted to find the range boundaries.
+		// Adjacent ranges overlap 2 levels, so that objects near a boundary still have enough neighbours.
+		float min_cost = 1.0f / (min_scale * min_scale);
+		float max_cost = 1.0f / (max_scale * max_scale);
+		float overlap = mScaleFactor * mScaleFactor;
+		mRangeObjects.resize(count);
+		cv::parallel_for_(cv::Range(0, count), [&](const cv::Range& range)
+		{
+			for (int i = range.start; i < range.end; i++)
+			{
+				float lower = 1.0f / std::sqrt(min_cost - (min_cost - max_cost) * i / count);
+				float upper = 1.0f / std::sqrt(min_cost - (min_cost - max_cost) * (i + 1) / count) * overlap;
+				cv::Size lower_size(static_cast<int>(window.width * lower), static_cast<int>(window.height * lower));
+				cv::Size upper_size = i == count - 1 ? cv::Size() : cv::Size(static_cast<int>(window.width * upper), static_cast<int>(window.height * upper));
+				mClassifiers[i].detectMultiScale(gray, mRangeObjects[i], mScaleFactor, mMinNeighbors, 0, lower_size, upper_size);
+			}
+		});
+
+		// Gather and remove objects that are detected in multiple ranges
+		mCVObjects.clear();
+		for (const auto& objects : mRangeObjects)
+			mCVObjects.insert(mCVObjects.end(), objects.begin(), objects.end());
+		mergeDetections(mCVObjects);
 	}
-}
\ No newline at end of file
+}
@@ -10,6 +10,9 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/objdetect.hpp>
 #include <cvcapturecomponent.h>
+#include <cvpipeline.h>
+#include <cvdnndetector.h>
+#include <cvdetection.h>
 #include <rect.h>
 
 namespace nap
@@ -19,6 +22,13 @@ namespace nap
 	/**
 	 * OpenCV Cascade Classifier, can be used to detect objects in a frame using a HaarCascade profile. 
 	 * The 'Path' property is a file-link that should point to a valid HaarCascade profile on disk.
+	 * Alternatively a neural network is used for detection when a 'Network' is given, 'Path' can be empty in that case.
+	 * When a 'Pipeline' is given, classification runs as a stage of that pipeline, concurrently with the other stages.
+	 *
+	 * The cascade classifier splits the image pyramid in 'Threads' ranges of object sizes, 
+	 * every range is classified on a separate thread. The ranges are chosen so that every thread performs about the same amount of work.
+	 * Set 'DetectInterval' to a value higher than 1 to only run the full detector every N frames,
+	 * objects are tracked in the frames in between.
 	 */
 	class NAPAPI CVClassifyComponent : public Component
 	{
@@ -29,16 +39,26 @@ namespace nap
 		nap::ComponentPtr<CVCaptureComponent> mCaptureComponent = nullptr;	///< Property: 'CaptureComponent' the component that receives the captured frames
 		nap::ResourcePtr<CVAdapter> mAdapter = nullptr;						///< Property: 'Adapter' the adapter to run the classification algorithm on
 		int mMatrixIndex = 0;												///< Property: 'MatrixIndex' the OpenCV matrix index, defaults to 0
-		std::string mPath;													///< Property: 'Path' path to cascade classifier file
+		std::string mPath;													///< Property: 'Path' path to cascade classifier file, not required when a network is given
+		nap::ResourcePtr<CVPipeline> mPipeline = nullptr;					///< Property: 'Pipeline' optional pipeline to run the classification on, uses a dedicated thread when not set
+		nap::ResourcePtr<CVDNNDetector> mNetwork = nullptr;					///< Property: 'Network' optional neural network detector, used instead of the cascade classifier
+		int mThreads = 1;													///< Property: 'Threads' number of threads the cascade classifier runs on
+		float mScaleFactor = 1.1f;											///< Property: 'ScaleFactor' cascade classifier image pyramid scale step, must be higher than 1
+		int mMinNeighbors = 3;												///< Property: 'MinNeighbors' number of overlapping cascade detections required for an object
+		int mMinSize = 0;													///< Property: 'MinSize' min object size in pixels, 0 = cascade window size
+		int mDetectInterval = 1;											///< Property: 'DetectInterval' run the full detector every N frames, objects are tracked in between
+		float mTrackScore = 0.6f;											///< Property: 'TrackScore' min match score (0-1) for a tracked object to be found
 	};
 
 
 	/**
-	 * Detects objects in a frame using a HaarCascade profile.
-	 * Classification is performed on a background thread when the 'CaptureComponent' receives a new frame. 
+	 * Detects objects in a frame using a HaarCascade profile or neural network.
+	 * Classification is performed on a background thread when the 'CaptureComponent' receives a new frame,
+	 * or as a stage of the 'Pipeline' when one is given. 
 	 * Call 'getObjects' to get a list of classified (detected) objects.
+	 * Call 'getStatistics' to get the latency and throughput of the classification for the capture device.
 	 */
-	class NAPAPI CVClassifyComponentInstance : public ComponentInstance
+	class NAPAPI CVClassifyComponentInstance : public ComponentInstance, public CVPipelineStage
 	{
 		RTTI_ENABLE(ComponentInstance)
 	public:
@@ -61,6 +81,25 @@ namespace nap
 		 */
 		std::vector<math::Rect> getObjects() const;
 
+		/**
+		 * Returns the latency and throughput of the classification. This call is thread safe.
+		 * The latency is the time between receiving a frame and storing the classified objects.
+		 * @return latency and throughput of the classification.
+		 */
+		CVDetectionStatistics getStatistics() const;
+
+		/**
+		 * Classifies the converted frame, called by the pipeline on a worker thread.
+		 * @param frame the captured frame
+		 * @param converted the converted matrix of the captured frame
+		 */
+		virtual void process(const CVFrame& frame, const CVFrame& converted) override;
+
+		/**
+		 * @return name of the pipeline stage
+		 */
+		virtual std::string getStageName() const override				{ return mID; }
+
 		// Resolved link to the OpenCV capture component.
 		nap::ComponentInstancePtr<CVCaptureComponent> mCaptureComponent = { this, &CVClassifyComponent::mCaptureComponent };
 
@@ -68,9 +107,16 @@ namespace nap
 		void onFrameCaptured(const CVFrameEvent& frameEvent);
 		nap::Slot<const CVFrameEvent&> mCaptureSlot =					{ this, &CVClassifyComponentInstance::onFrameCaptured };
 		
-		cv::CascadeClassifier mClassifier;								///< OpenCV cascade classifier
+		std::vector<cv::CascadeClassifier> mClassifiers;				///< OpenCV cascade classifier for every thread
 		nap::CVAdapter* mAdapter = nullptr;								///< OpenCV capture adapter
+		nap::CVPipeline* mPipeline = nullptr;							///< Pipeline the classification runs on, nullptr when classifying on a dedicated thread
+		nap::CVDNNDetector* mNetwork = nullptr;							///< Network detector, nullptr when the cascade classifier is used
 		int mMatrixIndex = 0;											///< OpenCV matrix index
+		float mScaleFactor = 1.1f;										///< Cascade image pyramid scale step
+		int mMinNeighbors = 3;											///< Cascade detections required for an object
+		int mMinSize = 0;												///< Min object size
+		int mDetectInterval = 1;										///< Full detection interval in frames
+		int mFrameCount = 0;											///< Number of frames classified
 
 		std::future<void> mClassifyTask;								///< The task that performs classification
 		std::mutex mClassifyMutex;										///< The mutex that safe guards the capture thread
@@ -78,12 +124,33 @@ namespace nap
 		bool mStopClassification = false;								///< If the detection should stop
 		bool mClassify = false;											///< Proceed to next frame
 		CVFrame mCapturedFrame;											///< Latest frame that is captured
+		HighResTimeStamp mCaptureTime;									///< Time the latest frame was received
 		std::vector<math::Rect> mObjects;								///< All detected objects
+		CVDetectionStatistics mStatistics;								///< Latency and throughput of the classification
 		mutable std::mutex mObjectMutex;								///< The mutex that safe guards the capture thread
 
+		cv::UMat mGrayMatrix;											///< Gray scale version of the frame that is classified
+		std::vector<cv::Rect> mCVObjects;								///< Objects detected in the last frame
+		std::vector<std::vector<cv::Rect>> mRangeObjects;				///< Objects detected by every thread
+		CVTemplateTracker mTracker;										///< Tracks objects in between detections
+
 		/**
          * Classification task runs in the background.
 		 */
 		void detectTask();
+
+		/**
+		 * Detects or tracks objects in the given matrix and stores the result.
+		 * @param matrix the matrix to classify, either BGR or gray scale
+		 * @param converted converted version of the matrix, used instead of the matrix when it's gray scale
+		 * @param receiveTime time the frame was received
+		 */
+		void classify(const cv::UMat& matrix, const cv::UMat& converted, const HighResTimeStamp& receiveTime);
+
+		/**
+		 * Runs the cascade classifier on all threads, every thread handles a range of object sizes.
+		 * @param gray the gray scale image to classify
+		 */
+		void detectCascade(const cv::Mat& gray);
 	};
 }
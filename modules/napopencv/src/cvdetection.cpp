@@ -0,0 +1,114 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "cvdetection.h"
+
+// External Includes
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace nap
+{
+	void CVDetectionStatistics::record(double latency, const HighResTimeStamp& time)
+	{
+		// Running averages, the first measurement initializes the average
+		constexpr double weight = 0.1;
+		mLatency = latency;
+		mAverageLatency = mProcessed == 0 ? latency : mAverageLatency + (latency - mAverageLatency) * weight;
+		if (mProcessed > 0)
+		{
+			double interval = std::chrono::duration<double>(time - mLastTime).count();
+			if (interval > 0.0)
+				mThroughput = mProcessed == 1 ? 1.0 / interval : mThroughput + (1.0 / interval - mThroughput) * weight;
+		}
+		mLastTime = time;
+		mProcessed++;
+	}
+
+
+	void CVTemplateTracker::reset(const cv::Mat& gray, const std::vector<cv::Rect>& objects)
+	{
+		cv::Rect image_bounds(0, 0, gray.cols, gray.rows);
+		mTargets.clear();
+		mTargets.reserve(objects.size());
+		for (const auto& object : objects)
+		{
+			cv::Rect bounds = object & image_bounds;
+			if (bounds.area() == 0)
+				continue;
+
+			// Store a copy of the patch, the frame is released after detection
+			mTargets.emplace_back();
+			gray(bounds).copyTo(mTargets.back().mTemplate);
+			mTargets.back().mBounds = bounds;
+		}
+	}
+
+
+	void CVTemplateTracker::update(const cv::Mat& gray, std::vector<cv::Rect>& outObjects)
+	{
+		outObjects.clear();
+		cv::Rect image_bounds(0, 0, gray.cols, gray.rows);
+		auto it = mTargets.begin();
+		while (it != mTargets.end())
+		{
+			// Search area around the last known position, centered on the object
+			cv::Rect& bounds = it->mBounds;
+			int margin_x = static_cast<int>(bounds.width * (mSearchScale - 1.0f) * 0.5f);
+			int margin_y = static_cast<int>(bounds.height * (mSearchScale - 1.0f) * 0.5f);
+			cv::Rect search(bounds.x - margin_x, bounds.y - margin_y, bounds.width + margin_x * 2, bounds.height + margin_y * 2);
+			search &= image_bounds;
+
+			// Lost when the search area no longer fits the object
+			if (search.width < it->mTemplate.cols || search.height < it->mTemplate.rows)
+			{
+				it = mTargets.erase(it);
+				continue;
+			}
+
+			// Find best match
+			double score = 0.0;
+			cv::Point location;
+			cv::matchTemplate(gray(search), it->mTemplate, mScores, cv::TM_CCOEFF_NORMED);
+			cv::minMaxLoc(mScores, nullptr, &score, nullptr, &location);
+			if (score < mMinScore)
+			{
+				it = mTargets.erase(it);
+				continue;
+			}
+
+			bounds.x = search.x + location.x;
+			bounds.y = search.y + location.y;
+			outObjects.emplace_back(bounds);
+			++it;
+		}
+	}
+
+
+	void mergeDetections(std::vector<cv::Rect>& objects, float threshold)
+	{
+		// Largest first, smaller duplicates are discarded
+		std::sort(objects.begin(), objects.end(), [](const cv::Rect& a, const cv::Rect& b)
+		{
+			return a.area() > b.area();
+		});
+
+		std::vector<cv::Rect> merged;
+		merged.reserve(objects.size());
+		for (const auto& object : objects)
+		{
+			bool duplicate = std::any_of(merged.begin(), merged.end(), [&object, threshold](const cv::Rect& kept)
+			{
+				float intersection = static_cast<float>((kept & object).area());
+				float area_union = static_cast<float>(kept.area() + object.area()) - intersection;
+				return area_union > 0.0f && intersection / area_union > threshold;
+			});
+			if (!duplicate)
+				merged.emplace_back(object);
+		}
+		objects.swap(merged);
+	}
+}
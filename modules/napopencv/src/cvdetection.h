@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <nap/numeric.h>
+#include <nap/datetime.h>
+#include <opencv2/core/mat.hpp>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Latency and throughput of an object detector for a single capture device.
+	 * All times are in milliseconds, the averages are weighted towards the most recent frames.
+	 */
+	struct NAPAPI CVDetectionStatistics
+	{
+		double			mLatency = 0.0;					///< Time between receiving and completing the last frame
+		double			mAverageLatency = 0.0;			///< Average time between receiving and completing a frame
+		double			mThroughput = 0.0;				///< Average number of frames completed per second
+		uint64			mProcessed = 0;					///< Number of frames completed
+		uint64			mDropped = 0;					///< Number of frames skipped because the detector was still busy
+		uint64			mDetected = 0;					///< Number of frames that ran the full detector
+		uint64			mTracked = 0;					///< Number of frames where objects were tracked instead of detected
+
+		/**
+		 * Adds a completed frame to the statistics.
+		 * @param latency time in milliseconds between receiving and completing the frame
+		 * @param time point in time the frame completed
+		 */
+		void record(double latency, const HighResTimeStamp& time);
+
+	private:
+		HighResTimeStamp mLastTime;						///< Time the previous frame completed
+	};
+
+
+	/**
+	 * Follows previously detected objects in subsequent frames, allowing the (expensive) detector to run less often.
+	 * Every object is tracked by matching the image patch of the object at detection time
+	 * against a search area around its last known position. Objects that can't be matched are lost.
+	 */
+	class NAPAPI CVTemplateTracker final
+	{
+	public:
+		/**
+		 * Replaces all tracked objects with newly detected objects.
+		 * @param gray single channel image the objects were detected in.
+		 * @param objects bounds of the detected objects.
+		 */
+		void reset(const cv::Mat& gray, const std::vector<cv::Rect>& objects);
+
+		/**
+		 * Locates all tracked objects in a new frame. Objects that can't be found anymore are removed.
+		 * @param gray single channel image to locate the objects in.
+		 * @param outObjects bounds of all objects that are still tracked.
+		 */
+		void update(const cv::Mat& gray, std::vector<cv::Rect>& outObjects);
+
+		/**
+		 * @return number of tracked objects
+		 */
+		int getCount() const								{ return static_cast<int>(mTargets.size()); }
+
+		float mSearchScale = 2.0f;							///< Size of the search area relative to the object
+		float mMinScore = 0.6f;								///< Min normalized correlation for an object to be found
+
+	private:
+		struct Target
+		{
+			cv::Mat		mTemplate;							///< Image patch of the object at detection time
+			cv::Rect	mBounds;							///< Last known bounds of the object
+		};
+		std::vector<Target> mTargets;						///< All tracked objects
+		cv::Mat mScores;									///< Match scores of the search area
+	};
+
+
+	/**
+	 * Removes duplicate detections of the same object.
+	 * When two rectangles overlap more than the given threshold (intersection over union) only the largest is kept.
+	 * @param objects the detections to merge, updated in place
+	 * @param threshold min intersection over union for two detections to be considered the same object
+	 */
+	NAPAPI void mergeDetections(std::vector<cv::Rect>& objects, float threshold = 0.3f);
+}
@@ -0,0 +1,268 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "cvdnndetector.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+
+RTTI_BEGIN_ENUM(nap::ECVDNNTarget)
+	RTTI_ENUM_VALUE(nap::ECVDNNTarget::CPU,			"CPU"),
+	RTTI_ENUM_VALUE(nap::ECVDNNTarget::OpenCL,		"OpenCL"),
+	RTTI_ENUM_VALUE(nap::ECVDNNTarget::OpenCLFP16,	"OpenCL FP16"),
+	RTTI_ENUM_VALUE(nap::ECVDNNTarget::CUDA,		"CUDA"),
+	RTTI_ENUM_VALUE(nap::ECVDNNTarget::CUDAFP16,	"CUDA FP16")
+RTTI_END_ENUM
+
+// nap::CVDNNDetector run time class definition
+RTTI_BEGIN_CLASS(nap::CVDNNDetector)
+	RTTI_PROPERTY("ModelPath",		&nap::CVDNNDetector::mModelPath,		nap::rtti::EPropertyMetaData::Required | nap::rtti::EPropertyMetaData::FileLink)
+	RTTI_PROPERTY("ConfigPath",		&nap::CVDNNDetector::mConfigPath,		nap::rtti::EPropertyMetaData::Default | nap::rtti::EPropertyMetaData::FileLink)
+	RTTI_PROPERTY("Target",			&nap::CVDNNDetector::mTarget,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("InputSize",		&nap::CVDNNDetector::mInputSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Mean",			&nap::CVDNNDetector::mMean,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Scale",			&nap::CVDNNDetector::mScale,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("SwapRB",			&nap::CVDNNDetector::mSwapRB,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Confidence",		&nap::CVDNNDetector::mConfidence,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Class",			&nap::CVDNNDetector::mClass,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MaxBatchSize",	&nap::CVDNNDetector::mMaxBatchSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("BatchTimeout",	&nap::CVDNNDetector::mBatchTimeout,		nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+
+namespace nap
+{
+	bool CVDNNDetector::init(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mMaxBatchSize > 0, "%s: max batch size must be at least 1", mID.c_str()))
+			return false;
+
+		if (!errorState.check(mInputSize.x > 0 && mInputSize.y > 0, "%s: invalid input size", mID.c_str()))
+			return false;
+
+		// Load network
+		try
+		{
+			mNet = cv::dnn::readNet(mModelPath, mConfigPath);
+		}
+		catch (const cv::Exception& exception)
+		{
+			errorState.fail("%s: unable to load network: %s, %s", mID.c_str(), mModelPath.c_str(), exception.what());
+			return false;
+		}
+
+		if (!errorState.check(!mNet.empty(), "%s: unable to load network: %s", mID.c_str(), mModelPath.c_str()))
+			return false;
+
+		// Select device
+		switch (mTarget)
+		{
+		case ECVDNNTarget::CPU:
+			mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+			mNet.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+			break;
+		case ECVDNNTarget::OpenCL:
+			mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+			mNet.setPreferableTarget(cv::dnn::DNN_TARGET_OPENCL);
+			break;
+		case ECVDNNTarget::OpenCLFP16:
+			mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+			mNet.setPreferableTarget(cv::dnn::DNN_TARGET_OPENCL_FP16);
+			break;
+		case ECVDNNTarget::CUDA:
+			mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+			mNet.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA);
+			break;
+		case ECVDNNTarget::CUDAFP16:
+			mNet.setPreferableBackend(cv::dnn::DNN_BACKEND_CUDA);
+			mNet.setPreferableTarget(cv::dnn::DNN_TARGET_CUDA_FP16);
+			break;
+		}
+		return true;
+	}
+
+
+	bool CVDNNDetector::start(utility::ErrorState& errorState)
+	{
+		mStop = false;
+		mDetectTask = std::async(std::launch::async, std::bind(&CVDNNDetector::detectTask, this));
+		return true;
+	}
+
+
+	void CVDNNDetector::stop()
+	{
+		// Stop detection thread and notify worker
+		{
+			std::lock_guard<std::mutex> lock(mRequestMutex);
+			mStop = true;
+		}
+		mRequestCondition.notify_one();
+
+		// Wait till exit
+		if (mDetectTask.valid())
+			mDetectTask.wait();
+	}
+
+
+	bool CVDNNDetector::detect(const cv::UMat& image, const CVAdapter* source, std::vector<cv::Rect>& outObjects)
+	{
+		outObjects.clear();
+		if (image.empty())
+			return false;
+
+		// The network always receives 3 channel images.
+		// The image is only mapped to host memory when no conversion is required, the caller blocks until completion.
+		Request request;
+		request.mSource = source;
+		request.mObjects = &outObjects;
+		request.mTime = HighResolutionClock::now();
+		switch (image.channels())
+		{
+		case 1:
+			cv::cvtColor(image, request.mImage, cv::COLOR_GRAY2BGR);
+			break;
+		case 4:
+			cv::cvtColor(image, request.mImage, cv::COLOR_BGRA2BGR);
+			break;
+		default:
+			request.mImage = image.getMat(cv::ACCESS_READ);
+			break;
+		}
+
+		// Submit and wait for the batch to complete
+		std::future<bool> result = request.mResult.get_future();
+		{
+			std::lock_guard<std::mutex> lock(mRequestMutex);
+			if (mStop)
+				return false;
+			mRequests.emplace_back(&request);
+		}
+		mRequestCondition.notify_one();
+		return result.get();
+	}
+
+
+	CVDetectionStatistics CVDNNDetector::getStatistics(const CVAdapter* source) const
+	{
+		std::lock_guard<std::mutex> lock(mStatisticsMutex);
+		auto it = mStatistics.find(source);
+		return it != mStatistics.end() ? it->second : CVDetectionStatistics();
+	}
+
+
+	void CVDNNDetector::detectTask()
+	{
+		std::vector<Request*> batch;
+		batch.reserve(mMaxBatchSize);
+		while (true)
+		{
+			// Wait for the first request, after that wait for the batch to fill up or the timeout to expire.
+			// Requests of other capture devices typically arrive within a couple of milliseconds.
+			{
+				std::unique_lock<std::mutex> lock(mRequestMutex);
+				mRequestCondition.wait(lock, [this]()
+				{
+					return mStop || !mRequests.empty();
+				});
+
+				auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+					std::chrono::duration<float, std::milli>(mBatchTimeout));
+				mRequestCondition.wait_until(lock, deadline, [this]()
+				{
+					return mStop || static_cast<int>(mRequests.size()) >= mMaxBatchSize;
+				});
+
+				// Exit loop when exit has been triggered
+				if (mStop)
+					break;
+
+				// Take batch
+				auto count = std::min<size_t>(mRequests.size(), mMaxBatchSize);
+				batch.assign(mRequests.begin(), mRequests.begin() + count);
+				mRequests.erase(mRequests.begin(), mRequests.begin() + count);
+			}
+			runBatch(batch);
+		}
+
+		// Release threads that are still waiting
+		std::lock_guard<std::mutex> lock(mRequestMutex);
+		for (auto& request : mRequests)
+			request->mResult.set_value(false);
+		mRequests.clear();
+	}
+
+
+	void CVDNNDetector::runBatch(std::vector<Request*>& batch)
+	{
+		// Run network once for all images
+		mBatchImages.clear();
+		for (const auto& request : batch)
+			mBatchImages.emplace_back(request->mImage);
+
+		cv::Mat output;
+		try
+		{
+			cv::Mat blob = cv::dnn::blobFromImages(mBatchImages, mScale, cv::Size(mInputSize.x, mInputSize.y),
+				cv::Scalar(mMean.x, mMean.y, mMean.z), mSwapRB, false);
+			mNet.setInput(blob);
+			output = mNet.forward();
+		}
+		catch (const cv::Exception& exception)
+		{
+			nap::Logger::error("%s: %s", mID.c_str(), exception.what());
+		}
+
+		// Ensure output is in SSD format: [1, 1, N, 7]
+		bool valid = output.dims == 4 && output.size[3] == 7;
+		if (!valid && !output.empty())
+			nap::Logger::error("%s: network output is not in SSD format", mID.c_str());
+
+		// Every detection contains: image index, class, confidence, left, top, right, bottom
+		if (valid)
+		{
+			cv::Mat detections(output.size[2], output.size[3], CV_32F, output.ptr<float>());
+			for (int i = 0; i < detections.rows; i++)
+			{
+				const float* detection = detections.ptr<float>(i);
+				int index = static_cast<int>(detection[0]);
+				if (index < 0 || index >= static_cast<int>(batch.size()) || detection[2] < mConfidence)
+					continue;
+
+				if (mClass >= 0 && static_cast<int>(detection[1]) != mClass)
+					continue;
+
+				const cv::Mat& image = batch[index]->mImage;
+				cv::Point min(static_cast<int>(detection[3] * image.cols), static_cast<int>(detection[4] * image.rows));
+				cv::Point max(static_cast<int>(detection[5] * image.cols), static_cast<int>(detection[6] * image.rows));
+				cv::Rect bounds = cv::Rect(min, max) & cv::Rect(0, 0, image.cols, image.rows);
+				if (bounds.area() > 0)
+					batch[index]->mObjects->emplace_back(bounds);
+			}
+		}
+
+		// Update statistics and release waiting threads
+		HighResTimeStamp time = HighResolutionClock::now();
+		{
+			std::lock_guard<std::mutex> lock(mStatisticsMutex);
+			for (const auto& request : batch)
+			{
+				CVDetectionStatistics& statistics = mStatistics[request->mSource];
+				statistics.record(std::chrono::duration<double, std::milli>(time - request->mTime).count(), time);
+				statistics.mDetected++;
+			}
+		}
+
+		mBatchImages.clear();
+		for (auto& request : batch)
+			request->mResult.set_value(valid);
+		batch.clear();
+	}
+}
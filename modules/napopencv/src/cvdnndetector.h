@@ -0,0 +1,133 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "cvadapter.h"
+#include "cvdetection.h"
+
+// External Includes
+#include <nap/device.h>
+#include <opencv2/dnn.hpp>
+#include <glm/glm.hpp>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace nap
+{
+	/**
+	 * Device the network of a nap::CVDNNDetector runs on.
+	 */
+	enum class ECVDNNTarget : int
+	{
+		CPU			= 0,		///< CPU
+		OpenCL		= 1,		///< OpenCL device, falls back to the CPU when OpenCL is not available
+		OpenCLFP16	= 2,		///< OpenCL device using half precision floats
+		CUDA		= 3,		///< CUDA device, requires OpenCV to be build with CUDA support
+		CUDAFP16	= 4			///< CUDA device using half precision floats
+	};
+
+
+	/**
+	 * Detects objects using a neural network that is loaded by the OpenCV DNN module.
+	 *
+	 * The network must output detections in the SSD format: a [1, 1, N, 7] blob where every detection
+	 * contains the image index in the batch, the class, the confidence and the normalized bounds.
+	 * The default settings match the OpenCV res10 SSD face detector.
+	 *
+	 * A single detector can be shared by multiple classify components, for example one for every capture device.
+	 * Images that are submitted by different threads at (about) the same time are combined into one batch,
+	 * which runs the network once for all of them. Set 'MaxBatchSize' to the number of capture devices that share the detector.
+	 * Call getStatistics() to get the latency and throughput of the detector for a specific capture device.
+	 */
+	class NAPAPI CVDNNDetector : public Device
+	{
+		RTTI_ENABLE(Device)
+	public:
+		/**
+		 * Loads the network
+		 * @param errorState contains the error if the network can't be loaded
+		 * @return if the network loaded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Starts the thread that runs the network.
+		 * @param errorState contains the error if the detector can't be started
+		 * @return if the detector started
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Stops the thread that runs the network, pending detections return without objects.
+		 */
+		virtual void stop() override;
+
+		/**
+		 * Detects objects in the given image. Blocks until the batch that contains the image completed.
+		 * Can be called from multiple threads at the same time.
+		 * @param image the image to detect objects in, BGR or gray scale.
+		 * @param source the adapter that captured the image, used for the statistics.
+		 * @param outObjects the bounds of all detected objects in image coordinates.
+		 * @return if detection succeeded
+		 */
+		bool detect(const cv::UMat& image, const CVAdapter* source, std::vector<cv::Rect>& outObjects);
+
+		/**
+		 * Returns the latency and throughput of the detector for images of the given adapter. Thread safe.
+		 * The latency includes the time the image waited for the batch to be completed.
+		 * @param source the adapter that captured the images.
+		 * @return the detection statistics of the given adapter
+		 */
+		CVDetectionStatistics getStatistics(const CVAdapter* source) const;
+
+		std::string		mModelPath;								///< Property: 'ModelPath' path to the trained network weights
+		std::string		mConfigPath;							///< Property: 'ConfigPath' path to the network description, can be empty when the model contains it
+		ECVDNNTarget	mTarget = ECVDNNTarget::CPU;			///< Property: 'Target' the device the network runs on
+		glm::ivec2		mInputSize = { 300, 300 };				///< Property: 'InputSize' size in pixels of the network input
+		glm::vec3		mMean = { 104.0f, 177.0f, 123.0f };		///< Property: 'Mean' value subtracted from every (BGR) pixel
+		float			mScale = 1.0f;							///< Property: 'Scale' multiplier applied to every pixel after mean subtraction
+		bool			mSwapRB = false;						///< Property: 'SwapRB' if the network expects RGB instead of BGR input
+		float			mConfidence = 0.5f;						///< Property: 'Confidence' min confidence of a detection
+		int				mClass = -1;							///< Property: 'Class' only report objects of this class, -1 reports all classes
+		int				mMaxBatchSize = 1;						///< Property: 'MaxBatchSize' max number of images that are processed together
+		float			mBatchTimeout = 5.0f;					///< Property: 'BatchTimeout' max time in milliseconds to wait for a batch to fill up
+
+	private:
+		/**
+		 * Single image waiting to be processed
+		 */
+		struct Request
+		{
+			cv::Mat							mImage;				///< Image in host memory
+			const CVAdapter*				mSource = nullptr;	///< Adapter that captured the image
+			HighResTimeStamp				mTime;				///< Time the image was submitted
+			std::promise<bool>				mResult;			///< Fulfilled when the batch completed
+			std::vector<cv::Rect>*			mObjects = nullptr;	///< Receives the detected objects
+		};
+
+		/**
+		 * Runs batches of requests until stopped
+		 */
+		void detectTask();
+
+		/**
+		 * Runs the network for the given batch and completes the requests
+		 */
+		void runBatch(std::vector<Request*>& batch);
+
+		cv::dnn::Net							mNet;						///< The network
+		std::vector<cv::Mat>					mBatchImages;				///< Network input images of the batch
+		std::vector<Request*>					mRequests;					///< Requests waiting to be processed
+		std::mutex								mRequestMutex;				///< Guards the requests
+		std::condition_variable					mRequestCondition;			///< Signalled when a request is added
+		bool									mStop = true;				///< If the detector is stopped
+		std::future<void>						mDetectTask;				///< Task that runs the network
+		std::unordered_map<const CVAdapter*, CVDetectionStatistics> mStatistics;	///< Statistics per adapter
+		mutable std::mutex						mStatisticsMutex;			///< Guards the statistics
+	};
+}
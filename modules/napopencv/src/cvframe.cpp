@@ -14,6 +14,7 @@ namespace nap
 		// Steal data
 		mMatrices = std::move(other.mMatrices);
 		mSource = other.mSource;
+		mTimestamp = other.mTimestamp;
 		other.mSource = nullptr;
 	}
 
@@ -34,6 +35,7 @@ namespace nap
 	{
 		mMatrices = std::move(other.mMatrices);
 		mSource = other.mSource;
+		mTimestamp = other.mTimestamp;
 		other.mSource = nullptr;
 		return *this;
 	}
@@ -66,6 +68,7 @@ namespace nap
 			mMatrices[i].copyTo(outFrame.mMatrices[i]);
 		}
 		outFrame.mSource = mSource;
+		outFrame.mTimestamp = mTimestamp;
 	}
 
 
@@ -78,6 +81,7 @@ namespace nap
 			clone.mMatrices.emplace_back(matrix.clone());
 		}
 		clone.mSource = mSource;
+		clone.mTimestamp = mTimestamp;
 		return clone;
 	}
 
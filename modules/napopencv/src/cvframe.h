@@ -139,8 +139,26 @@ namespace nap
 		 */
 		CVAdapter* getSource()									{ return mSource; }
 
+		/**
+		 * Sets the source that created this frame.
+		 * @param source the source that created this frame, nullptr when there is no source.
+		 */
+		void setSource(CVAdapter* source)						{ mSource = source; }
+
+		/**
+		 * @return presentation time of this frame in seconds, as reported by the source. 0 when unknown.
+		 */
+		double getTimestamp() const								{ return mTimestamp; }
+
+		/**
+		 * Sets the presentation time of this frame.
+		 * @param timestamp presentation time of this frame in seconds.
+		 */
+		void setTimestamp(double timestamp)						{ mTimestamp = timestamp; }
+
 	private:
 		std::vector<cv::UMat> mMatrices;	///< All OpenCV matrices associated with the frame
 		CVAdapter* mSource = nullptr;		///< The source that created this frame.
+		double mTimestamp = 0.0;			///< Presentation time of the frame in seconds
 	};
 }
\ No newline at end of file
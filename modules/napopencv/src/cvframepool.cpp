@@ -0,0 +1,93 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "cvframepool.h"
+
+// External Includes
+#include <algorithm>
+
+namespace nap
+{
+	CVFramePool::CVFramePool(int maxSize) : mMaxSize(maxSize)
+	{
+		mFrames.reserve(maxSize);
+	}
+
+
+	CVFrame CVFramePool::copy(const CVFrame& source)
+	{
+		return create([&source](CVFrame& target)
+		{
+			source.copyTo(target);
+		});
+	}
+
+
+	CVFrame CVFramePool::create(const std::function<void(CVFrame&)>& writer)
+	{
+		// Find a frame that isn't referenced by anyone else, allocate a new one if there is none.
+		// The frame is written inside the lock, otherwise another thread could claim the same frame.
+		std::lock_guard<std::mutex> lock(mMutex);
+		auto it = std::find_if(mFrames.begin(), mFrames.end(), [](const auto& frame)
+		{
+			return isExclusive(frame);
+		});
+
+		if (it != mFrames.end())
+		{
+			writer(*it);
+			return *it;
+		}
+
+		if (static_cast<int>(mFrames.size()) < mMaxSize)
+		{
+			mFrames.emplace_back();
+			writer(mFrames.back());
+			return mFrames.back();
+		}
+
+		// Pool is exhausted, consumers are holding on to too many frames
+		CVFrame frame;
+		writer(frame);
+		return frame;
+	}
+
+
+	int CVFramePool::getSize() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return static_cast<int>(mFrames.size());
+	}
+
+
+	int CVFramePool::getAvailable() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return static_cast<int>(std::count_if(mFrames.begin(), mFrames.end(), [](const auto& frame)
+		{
+			return isExclusive(frame);
+		}));
+	}
+
+
+	void CVFramePool::clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFrames.clear();
+	}
+
+
+	bool CVFramePool::isExclusive(const CVFrame& frame)
+	{
+		// A matrix is shared when another UMat header points to the same data,
+		// or when the data is mapped into host memory by a cv::Mat.
+		for (int i = 0; i < frame.getCount(); i++)
+		{
+			const cv::UMatData* data = frame[i].u;
+			if (data != nullptr && (data->urefcount > 1 || data->refcount > 0))
+				return false;
+		}
+		return true;
+	}
+}
@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "cvframe.h"
+
+// External Includes
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Recycles the matrix memory of captured frames.
+	 *
+	 * A frame that is handed out by the pool references matrices owned by the pool.
+	 * Consumers can hold on to (copy) that frame for as long as they like without copying the actual content:
+	 * the pool never writes into a frame that is still referenced outside of the pool.
+	 * Frames handed out by the pool must therefore be treated as read-only.
+	 * Once all external references are released the storage is re-used for the next frame,
+	 * removing the allocation (and deep copy) that is otherwise performed for every captured frame.
+	 *
+	 * The pool grows when all of its frames are in use and never holds more than 'maxSize' frames.
+	 * When the pool is full a newly allocated frame is returned that is not recycled.
+	 */
+	class NAPAPI CVFramePool final
+	{
+	public:
+		/**
+		 * @param maxSize max number of frames that are recycled.
+		 */
+		CVFramePool(int maxSize = 8);
+
+		/**
+		 * Copies the content of the given frame into a free frame of the pool.
+		 * The returned frame references storage owned by the pool and should not be modified.
+		 * This call is thread safe.
+		 * @param source the frame to copy
+		 * @return read-only frame that contains a copy of the source
+		 */
+		CVFrame copy(const CVFrame& source);
+
+		/**
+		 * Writes a new frame into a free frame of the pool.
+		 * The writer receives the storage owned by the pool and is called while the pool is locked.
+		 * Matrices that are written with the same size and type as before are not re-allocated.
+		 * The returned frame references storage owned by the pool and should not be modified.
+		 * This call is thread safe.
+		 * @param writer function that writes the content of the frame
+		 * @return read-only frame that contains the written content
+		 */
+		CVFrame create(const std::function<void(CVFrame&)>& writer);
+
+		/**
+		 * @return number of frames currently allocated by the pool.
+		 */
+		int getSize() const;
+
+		/**
+		 * @return number of allocated frames that are not referenced outside of the pool.
+		 */
+		int getAvailable() const;
+
+		/**
+		 * Releases all frames owned by the pool. Frames that are still referenced remain valid.
+		 */
+		void clear();
+
+		/**
+		 * @return if the given frame is not referenced outside of the pool.
+		 */
+		static bool isExclusive(const CVFrame& frame);
+
+	private:
+		std::vector<CVFrame> mFrames;		///< All frames owned by the pool
+		int mMaxSize = 8;					///< Max number of frames recycled by the pool
+		mutable std::mutex mMutex;			///< Guards the frames
+	};
+}
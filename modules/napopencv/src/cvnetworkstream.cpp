@@ -8,11 +8,27 @@
 #include <nap/logger.h>
 #include <mathutils.h>
 
+RTTI_BEGIN_ENUM(nap::ECVStreamTransport)
+	RTTI_ENUM_VALUE(nap::ECVStreamTransport::Auto,	"Auto"),
+	RTTI_ENUM_VALUE(nap::ECVStreamTransport::TCP,	"TCP"),
+	RTTI_ENUM_VALUE(nap::ECVStreamTransport::UDP,	"UDP")
+RTTI_END_ENUM
+
 // nap::cvvideoadapter run time class definition 
 RTTI_BEGIN_CLASS(nap::CVNetworkStream)
 	RTTI_PROPERTY("Resize",			&nap::CVNetworkStream::mResize,			nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("Size",			&nap::CVNetworkStream::mSize,			nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("Link",			&nap::CVNetworkStream::mLink,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("LowLatency",		&nap::CVNetworkStream::mLowLatency,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Transport",		&nap::CVNetworkStream::mTransport,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("BufferSize",		&nap::CVNetworkStream::mBufferSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("JitterDelay",	&nap::CVNetworkStream::mJitterDelay,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("SkipToLatest",	&nap::CVNetworkStream::mSkipToLatest,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Timeout",		&nap::CVNetworkStream::mTimeout,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ReconnectDelay",	&nap::CVNetworkStream::mReconnectDelay,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MaxReconnectDelay", &nap::CVNetworkStream::mMaxReconnectDelay, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("GrabTimeout",	&nap::CVNetworkStream::mGrabTimeout,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PaceInput",		&nap::CVNetworkStream::mPaceInput,		nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 //////////////////////////////////////////////////////////////////////////
@@ -28,13 +44,25 @@ namespace nap
 
 	int CVNetworkStream::getWidth() const
 	{
-		return static_cast<int>(getProperty(cv::CAP_PROP_FRAME_WIDTH));
+		return mLowLatency ? mReceiver.getWidth() : static_cast<int>(getProperty(cv::CAP_PROP_FRAME_WIDTH));
 	}
 
 
 	int CVNetworkStream::getHeight() const
 	{
-		return static_cast<int>(getProperty(cv::CAP_PROP_FRAME_HEIGHT));
+		return mLowLatency ? mReceiver.getHeight() : static_cast<int>(getProperty(cv::CAP_PROP_FRAME_HEIGHT));
+	}
+
+
+	CVStreamStatistics CVNetworkStream::getStatistics() const
+	{
+		return mReceiver.getStatistics();
+	}
+
+
+	std::string CVNetworkStream::getLastError() const
+	{
+		return mReceiver.getLastError();
 	}
 
 
@@ -46,25 +74,70 @@ namespace nap
 
 	bool CVNetworkStream::onOpen(cv::VideoCapture& captureDevice, int api, nap::utility::ErrorState& error)
 	{
-		if (!error.check(captureDevice.open(mLink, api), "%s: Unable to open network stream: %s", mID.c_str(), mLink.c_str()))
-			return false;
-
 		// Reset some internally managed variables
 		mCaptureFrame	= CVFrame(1, this);
 		mOutputFrame	= CVFrame(1, this);
 
-		return true;
+		// Start receiving in the background, the connection is made (and restored) by the receiver
+		if (mLowLatency)
+		{
+			CVStreamSettings settings;
+			settings.mLink = mLink;
+			settings.mTransport = mTransport;
+			settings.mBufferSize = mBufferSize;
+			settings.mJitterDelay = mJitterDelay;
+			settings.mSkipToLatest = mSkipToLatest;
+			settings.mTimeout = mTimeout;
+			settings.mReconnectDelay = mReconnectDelay;
+			settings.mMaxReconnectDelay = mMaxReconnectDelay;
+			settings.mPaceInput = mPaceInput;
+			mReceiver.start(settings);
+			return true;
+		}
+
+		return error.check(captureDevice.open(mLink, api), "%s: Unable to open network stream: %s", mID.c_str(), mLink.c_str());
+	}
+
+
+	void CVNetworkStream::onClose()
+	{
+		mReceiver.stop();
+		mGrabbedFrame = {};
+	}
+
+
+	bool CVNetworkStream::onGrab(cv::VideoCapture& captureDevice)
+	{
+		if (!mLowLatency)
+			return captureDevice.grab();
+		return mReceiver.pop(mGrabbedFrame, mGrabTimeout);
 	}
 
 
 	CVFrame CVNetworkStream::onRetrieve(cv::VideoCapture& captureDevice, utility::ErrorState& error)
 	{
+		// Take the frame grabbed from the receiver, the matrix references the host memory of the grabbed frame
+		if (mLowLatency)
+		{
+			if (mGrabbedFrame.mImage.empty())
+			{
+				error.fail("%s: No new frame available", mID.c_str());
+				return CVFrame();
+			}
+			mCaptureFrame[0] = mGrabbedFrame.mImage.getUMat(cv::ACCESS_READ);
+			mOutputFrame.setTimestamp(mGrabbedFrame.mTimestamp);
+		}
+
 		// Retrieve currently stored frame
-		if (!captureDevice.retrieve(mCaptureFrame[0]))
+		else if (!captureDevice.retrieve(mCaptureFrame[0]))
 		{
 			error.fail("%s: No new frame available", mID.c_str());
 			return CVFrame();
 		}
+		else
+		{
+			mOutputFrame.setTimestamp(captureDevice.get(cv::CAP_PROP_POS_MSEC) / 1000.0);
+		}
 
 		// Resize frame if required
 		// Otherwise simply copy mat reference (no actual data copy takes place)
@@ -73,6 +146,15 @@ namespace nap
 		else
 			mOutputFrame[0] = mCaptureFrame[0];
 
-		return mOutputFrame.clone();
+		// Copy into a recycled frame, release the reference to the grabbed frame before it is replaced
+		CVFrame frame = getFramePool().copy(mOutputFrame);
+		if (mLowLatency)
+		{
+			if (mOutputFrame[0].u == mCaptureFrame[0].u)
+				mOutputFrame[0] = cv::UMat();
+			mCaptureFrame[0] = cv::UMat();
+			mGrabbedFrame.mImage.release();
+		}
+		return frame;
 	}
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 // Local Includes
 #include "cvadapter.h"
+#include "cvstreamreceiver.h"
 
 // External Includes
 #include <nap/resource.h>
@@ -18,6 +19,12 @@ namespace nap
 	 * Captures frames from a video streamed over the network.
 	 * The captured video frame is stored on the GPU when hardware acceleration is available (OpenCL).
 	 *
+	 * By default the stream is opened using the OpenCV capture device, which buffers frames internally
+	 * and blocks the capture thread when the network stalls. Turn on 'LowLatency' to receive the stream
+	 * using a nap::CVStreamReceiver instead: frames are received in the background into a small jitter buffer,
+	 * the most recent frame is captured, a network stall never blocks capture longer than the 'GrabTimeout'
+	 * and the connection is restored automatically when lost. Every frame is timestamped with the presentation time of the stream.
+	 *
 	 * Add this device to a nap::CVCaptureDevice to capture frames from a video streamed over the network, in a background thread.
 	 * Note that this object should only be added once to a nap::CVCaptureDevice!
 	 */
@@ -51,9 +58,31 @@ namespace nap
 		 */
 		bool reconnect(utility::ErrorState& error);
 
+		/**
+		 * Returns receive statistics, only available when 'LowLatency' is turned on. Thread safe.
+		 * @return receive statistics
+		 */
+		CVStreamStatistics getStatistics() const;
+
+		/**
+		 * Returns the last connection or decode error, only available when 'LowLatency' is turned on. Thread safe.
+		 * @return the last receive error
+		 */
+		std::string getLastError() const;
+
 		std::string		mLink;									///< Property: 'Link' link to the web stream.
 		bool			mResize = false;						///< Property: 'Resize' if the frame is resized to the specified 'Size' after capture
 		glm::ivec2		mSize = { 1280, 720 };					///< Property: 'Size' frame size, only used when 'Resize' is turned on.
+		bool			mLowLatency = false;					///< Property: 'LowLatency' if the stream is received using FFmpeg directly, instead of the OpenCV capture device
+		ECVStreamTransport mTransport = ECVStreamTransport::TCP;///< Property: 'Transport' RTSP transport protocol, low latency only
+		int				mBufferSize = 4;						///< Property: 'BufferSize' max number of frames in the jitter buffer, low latency only
+		float			mJitterDelay = 0.0f;					///< Property: 'JitterDelay' time in ms frames are held back to smooth out irregular arrival, low latency only
+		bool			mSkipToLatest = true;					///< Property: 'SkipToLatest' if only the most recent frame is captured, low latency only
+		float			mTimeout = 2000.0f;						///< Property: 'Timeout' time in ms without data after which the connection is restored, low latency only
+		float			mReconnectDelay = 250.0f;				///< Property: 'ReconnectDelay' time in ms before the first reconnection attempt, low latency only
+		float			mMaxReconnectDelay = 5000.0f;			///< Property: 'MaxReconnectDelay' max time in ms in between reconnection attempts, low latency only
+		float			mGrabTimeout = 500.0f;					///< Property: 'GrabTimeout' max time in ms the capture thread waits for a new frame, low latency only
+		bool			mPaceInput = false;						///< Property: 'PaceInput' if a file is read at the rate of the video, used to simulate a live stream, low latency only
 
 	protected:
 		
@@ -70,6 +99,18 @@ namespace nap
 		 */
 		virtual bool onOpen(cv::VideoCapture& captureDevice, int api, nap::utility::ErrorState& error) override;
 
+		/**
+		 * Called by the capture device. Stops receiving when 'LowLatency' is turned on.
+		 */
+		virtual void onClose() override;
+
+		/**
+		 * Grabs the next frame. Waits for the next frame of the receiver when 'LowLatency' is turned on.
+		 * @param captureDevice the device to grab the frame from.
+		 * @return if a new frame is grabbed.
+		 */
+		virtual bool onGrab(cv::VideoCapture& captureDevice) override;
+
 		/**
 		 * This method decodes and returns the just grabbed frame.
 		 * @param captureDevice the device to capture the frame from.
@@ -81,5 +122,7 @@ namespace nap
 	private:
 		CVFrame					mCaptureFrame					{ 1 };
 		CVFrame					mOutputFrame					{ 1 };
+		CVStreamReceiver		mReceiver;						///< Receives the stream when 'LowLatency' is turned on
+		CVStreamFrame			mGrabbedFrame;					///< Last frame grabbed from the receiver
 	};
 }
@@ -0,0 +1,262 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "cvpipeline.h"
+
+// External Includes
+#include <utility/threading.h>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+
+RTTI_BEGIN_ENUM(nap::ECVConversion)
+	RTTI_ENUM_VALUE(nap::ECVConversion::None,	"None"),
+	RTTI_ENUM_VALUE(nap::ECVConversion::Gray,	"Gray"),
+	RTTI_ENUM_VALUE(nap::ECVConversion::RGB,	"RGB"),
+	RTTI_ENUM_VALUE(nap::ECVConversion::RGBA,	"RGBA")
+RTTI_END_ENUM
+
+// nap::CVPipeline run time class definition
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::CVPipeline)
+	RTTI_CONSTRUCTOR(nap::CVService&)
+	RTTI_PROPERTY("Device",			&nap::CVPipeline::mDevice,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Adapter",		&nap::CVPipeline::mAdapter,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("MatrixIndex",	&nap::CVPipeline::mMatrixIndex,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Conversion",		&nap::CVPipeline::mConversion,		nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+
+namespace nap
+{
+	/**
+	 * @return elapsed time in milliseconds between two points in time
+	 */
+	static double getMilliseconds(const HighResTimeStamp& start, const HighResTimeStamp& end)
+	{
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+
+	CVPipeline::CVPipeline(CVService& service)
+	{
+		mService = &service;
+	}
+
+
+	bool CVPipeline::init(utility::ErrorState& errorState)
+	{
+		// Ensure adapter is part of capture device
+		if (!errorState.check(mDevice->manages(*mAdapter), "%s: adapter: %s not part of %s",
+			mID.c_str(), mAdapter->mID.c_str(), mDevice->mID.c_str()))
+			return false;
+
+		// Ensure matrix index is in range
+		if (!errorState.check(mMatrixIndex < mAdapter->getMatrixCount(),
+			"%s: matrix index out of range, adapter: %s has only %d matrices available", mID.c_str(),
+			mAdapter->mID.c_str(), mAdapter->getMatrixCount()))
+			return false;
+
+		mConversionStatistics.mName = "Conversion";
+		return true;
+	}
+
+
+	bool CVPipeline::start(utility::ErrorState& errorState)
+	{
+		mDevice->frameCaptured.connect(mCaptureSlot);
+		return true;
+	}
+
+
+	void CVPipeline::stop()
+	{
+		// Stop receiving frames and wait for scheduled stages to complete
+		mDevice->frameCaptured.disconnect(mCaptureSlot);
+		std::unique_lock<std::mutex> lock(mStageMutex);
+		for (auto& stage : mStages)
+			stage->mPending = false;
+		waitIdle(lock, nullptr);
+	}
+
+
+	void CVPipeline::addStage(CVPipelineStage& stage)
+	{
+		auto new_stage = std::make_unique<Stage>();
+		new_stage->mStage = &stage;
+		new_stage->mStatistics.mName = stage.getStageName();
+
+		std::lock_guard<std::mutex> lock(mStageMutex);
+		mStages.emplace_back(std::move(new_stage));
+	}
+
+
+	void CVPipeline::removeStage(CVPipelineStage& stage)
+	{
+		std::unique_lock<std::mutex> lock(mStageMutex);
+		auto found_it = std::find_if(mStages.begin(), mStages.end(), [&](const auto& it)
+		{
+			return it->mStage == &stage;
+		});
+		assert(found_it != mStages.end());
+
+		// Drop pending frame and wait for the stage to complete before removal.
+		// The lock is released while waiting, find the stage again afterwards.
+		Stage* removed_stage = found_it->get();
+		removed_stage->mPending = false;
+		waitIdle(lock, removed_stage);
+		mStages.erase(std::find_if(mStages.begin(), mStages.end(), [removed_stage](const auto& it)
+		{
+			return it.get() == removed_stage;
+		}));
+	}
+
+
+	std::vector<CVStageStatistics> CVPipeline::getStatistics() const
+	{
+		std::vector<CVStageStatistics> statistics;
+		std::lock_guard<std::mutex> lock(mStageMutex);
+		statistics.reserve(mStages.size());
+		for (const auto& stage : mStages)
+			statistics.emplace_back(stage->mStatistics);
+		return statistics;
+	}
+
+
+	CVStageStatistics CVPipeline::getConversionStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(mStageMutex);
+		return mConversionStatistics;
+	}
+
+
+	void CVPipeline::onFrameCaptured(const CVFrameEvent& frameEvent)
+	{
+		// Find frame of adapter
+		const CVFrame* frame = frameEvent.findFrame(*mAdapter);
+		if (frame == nullptr)
+			return;
+
+		// Don't convert when no one is listening
+		{
+			std::lock_guard<std::mutex> lock(mStageMutex);
+			if (mStages.empty())
+				return;
+		}
+
+		// Convert once for all stages, the result is written into recycled storage.
+		// Without conversion the stages share the captured matrix.
+		HighResTimeStamp capture_time = HighResolutionClock::now();
+		const cv::UMat& source = (*frame)[mMatrixIndex];
+		CVFrame converted;
+		if (mConversion == ECVConversion::None)
+		{
+			converted.add(source);
+			converted.setSource(mAdapter.get());
+		}
+		else
+		{
+			int code = mConversion == ECVConversion::Gray ? cv::COLOR_BGR2GRAY :
+				mConversion == ECVConversion::RGB ? cv::COLOR_BGR2RGB : cv::COLOR_BGR2RGBA;
+
+			converted = mConvertPool.create([&](CVFrame& target)
+			{
+				if (target.empty())
+					target.addNew();
+				cv::cvtColor(source, target[0], code);
+				target.setSource(mAdapter.get());
+			});
+		}
+		HighResTimeStamp convert_time = HighResolutionClock::now();
+
+		// Hand the frame to every stage, schedule stages that are idle.
+		// Busy stages pick up the most recent frame when done.
+		std::lock_guard<std::mutex> lock(mStageMutex);
+		double convert_duration = getMilliseconds(capture_time, convert_time);
+		record(mConversionStatistics, convert_duration, convert_duration);
+		for (auto& stage : mStages)
+		{
+			if (stage->mPending)
+				stage->mStatistics.mDropped++;
+
+			stage->mFrame = *frame;
+			stage->mConverted = converted;
+			stage->mCaptureTime = capture_time;
+			stage->mPending = true;
+			if (stage->mBusy)
+				continue;
+
+			stage->mBusy = true;
+			Stage* scheduled_stage = stage.get();
+			mService->getThreadPool().execute([this, scheduled_stage]()
+			{
+				runStage(*scheduled_stage);
+			});
+		}
+	}
+
+
+	void CVPipeline::runStage(Stage& stage)
+	{
+		CVFrame frame, converted;
+		HighResTimeStamp capture_time;
+		while (true)
+		{
+			// Take the pending frame, mark stage idle when there is none
+			{
+				std::lock_guard<std::mutex> lock(mStageMutex);
+				if (!stage.mPending)
+				{
+					stage.mBusy = false;
+					mIdleCondition.notify_all();
+					return;
+				}
+				frame = std::move(stage.mFrame);
+				converted = std::move(stage.mConverted);
+				capture_time = stage.mCaptureTime;
+				stage.mPending = false;
+			}
+
+			// Process
+			HighResTimeStamp start_time = HighResolutionClock::now();
+			stage.mStage->process(frame, converted);
+			HighResTimeStamp end_time = HighResolutionClock::now();
+
+			// Release frames before the next one is taken, allows the storage to be recycled
+			frame.clear();
+			converted.clear();
+
+			std::lock_guard<std::mutex> lock(mStageMutex);
+			record(stage.mStatistics, getMilliseconds(start_time, end_time), getMilliseconds(capture_time, end_time));
+		}
+	}
+
+
+	void CVPipeline::waitIdle(std::unique_lock<std::mutex>& lock, const Stage* stage)
+	{
+		mIdleCondition.wait(lock, [this, stage]()
+		{
+			return std::none_of(mStages.begin(), mStages.end(), [stage](const auto& it)
+			{
+				return it->mBusy && (stage == nullptr || it.get() == stage);
+			});
+		});
+	}
+
+
+	void CVPipeline::record(CVStageStatistics& statistics, double duration, double latency)
+	{
+		// Running average, the first measurement initializes the average
+		constexpr double weight = 0.1;
+		bool first = statistics.mProcessed == 0;
+		statistics.mDuration = duration;
+		statistics.mLatency = latency;
+		statistics.mAverageDuration = first ? duration : statistics.mAverageDuration + (duration - statistics.mAverageDuration) * weight;
+		statistics.mAverageLatency = first ? latency : statistics.mAverageLatency + (latency - statistics.mAverageLatency) * weight;
+		statistics.mMaxDuration = std::max(statistics.mMaxDuration, duration);
+		statistics.mProcessed++;
+	}
+}
@@ -0,0 +1,197 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "cvcapturedevice.h"
+#include "cvframepool.h"
+
+// External Includes
+#include <nap/device.h>
+#include <nap/resourceptr.h>
+#include <nap/signalslot.h>
+#include <nap/datetime.h>
+#include <nap/numeric.h>
+#include <rtti/factory.h>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+
+namespace nap
+{
+	/**
+	 * Color conversion applied once by a nap::CVPipeline before a frame is handed to the stages.
+	 * Captured frames are expected to be in BGR order.
+	 */
+	enum class ECVConversion : int
+	{
+		None	= 0,		///< No conversion, stages receive the captured matrix
+		Gray	= 1,		///< BGR to single channel gray scale
+		RGB		= 2,		///< BGR to RGB
+		RGBA	= 3			///< BGR to RGBA
+	};
+
+
+	/**
+	 * Timing information of a single step in a nap::CVPipeline. All times are in milliseconds.
+	 * The averages are running averages, weighted towards the most recent frames.
+	 */
+	struct NAPAPI CVStageStatistics
+	{
+		std::string		mName;								///< Name of the stage
+		double			mDuration = 0.0;					///< Time spent processing the last frame
+		double			mAverageDuration = 0.0;				///< Average time spent processing a frame
+		double			mMaxDuration = 0.0;					///< Longest time spent processing a frame
+		double			mLatency = 0.0;						///< Time between capture and completion of the last frame
+		double			mAverageLatency = 0.0;				///< Average time between capture and completion of a frame
+		uint64			mProcessed = 0;						///< Number of frames processed
+		uint64			mDropped = 0;						///< Number of frames skipped because the stage was still busy
+	};
+
+
+	/**
+	 * Interface of a single analysis stage of a nap::CVPipeline.
+	 * Register a stage with a pipeline using CVPipeline::addStage().
+	 * process() is called on a worker thread of the nap::CVService, every stage runs concurrently with the other stages.
+	 * A stage never processes more than one frame at a time: when a stage can't keep up, frames are skipped.
+	 */
+	class NAPAPI CVPipelineStage
+	{
+	public:
+		virtual ~CVPipelineStage() = default;
+
+		/**
+		 * Called on a worker thread when a new frame is available for this stage.
+		 * Both frames are shared with the other stages and must not be modified.
+		 * The frames remain valid for as long as the stage holds on to (a copy of) them, without copying the content.
+		 * @param frame the captured frame, contains all matrices of the adapter.
+		 * @param converted single matrix frame that contains the converted 'MatrixIndex' matrix of the captured frame.
+		 */
+		virtual void process(const CVFrame& frame, const CVFrame& converted) = 0;
+
+		/**
+		 * @return name of the stage, used to identify the stage in the statistics.
+		 */
+		virtual std::string getStageName() const = 0;
+	};
+
+
+	/**
+	 * Runs frames captured by a nap::CVCaptureDevice through a set of concurrent analysis stages.
+	 *
+	 * Every frame of the 'Adapter' is first converted on the capture thread, according to the 'Conversion' property.
+	 * The captured and converted frames are then handed to every registered nap::CVPipelineStage.
+	 * The stages run on the worker threads of the nap::CVService, all stages receive the same read-only frame.
+	 * This allows, for example, face detection, blob tracking and a texture upload to run at the same time on the same capture,
+	 * without any of them copying the frame.
+	 *
+	 * A stage that is still busy when a new frame arrives only receives the most recent frame when it's done.
+	 * Call getStatistics() to get the processing time and latency of every stage.
+	 */
+	class NAPAPI CVPipeline : public Device
+	{
+		RTTI_ENABLE(Device)
+	public:
+		/**
+		 * Constructor
+		 * @param service the service that runs the stages.
+		 */
+		CVPipeline(CVService& service);
+
+		/**
+		 * Ensures the adapter is part of the capture device.
+		 * @param errorState contains the error if initialization fails
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Starts receiving frames from the capture device.
+		 * @param errorState contains the error if the pipeline can't be started
+		 * @return if the pipeline started
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Stops receiving frames and waits for all stages to complete.
+		 */
+		virtual void stop() override;
+
+		/**
+		 * Adds a stage to this pipeline, the stage receives the next captured frame.
+		 * @param stage the stage to add
+		 */
+		void addStage(CVPipelineStage& stage);
+
+		/**
+		 * Removes a stage from this pipeline, waits until the stage completed processing.
+		 * @param stage the stage to remove
+		 */
+		void removeStage(CVPipelineStage& stage);
+
+		/**
+		 * Returns the timing information of all stages, in the order the stages were added. Thread safe.
+		 * @return timing information of all stages
+		 */
+		std::vector<CVStageStatistics> getStatistics() const;
+
+		/**
+		 * Returns the timing information of the conversion step. Thread safe.
+		 * The latency of the conversion is the time between retrieving the frame and the end of the conversion.
+		 * @return timing information of the conversion step
+		 */
+		CVStageStatistics getConversionStatistics() const;
+
+		nap::ResourcePtr<CVCaptureDevice>	mDevice;							///< Property: 'Device' the device that captures the frames
+		nap::ResourcePtr<CVAdapter>			mAdapter;							///< Property: 'Adapter' the adapter to process frames of
+		int									mMatrixIndex = 0;					///< Property: 'MatrixIndex' the matrix that is converted, defaults to 0
+		ECVConversion						mConversion = ECVConversion::None;	///< Property: 'Conversion' color conversion applied before the frame is handed to the stages
+
+	private:
+		/**
+		 * State of a single registered stage
+		 */
+		struct Stage
+		{
+			CVPipelineStage*		mStage = nullptr;		///< The stage
+			CVFrame					mFrame;					///< Next captured frame to process
+			CVFrame					mConverted;				///< Next converted frame to process
+			HighResTimeStamp		mCaptureTime;			///< Time the next frame was captured
+			bool					mPending = false;		///< If there is a frame to process
+			bool					mBusy = false;			///< If the stage is scheduled or processing
+			CVStageStatistics		mStatistics;			///< Stage timing information
+		};
+
+		/**
+		 * Called on the capture thread when a new frame is captured
+		 */
+		void onFrameCaptured(const CVFrameEvent& frameEvent);
+		nap::Slot<const CVFrameEvent&> mCaptureSlot = { this, &CVPipeline::onFrameCaptured };
+
+		/**
+		 * Processes all pending frames of a stage, runs on a worker thread
+		 */
+		void runStage(Stage& stage);
+
+		/**
+		 * Blocks until the given stage or all stages (nullptr) are idle, lock must be owned
+		 */
+		void waitIdle(std::unique_lock<std::mutex>& lock, const Stage* stage);
+
+		/**
+		 * Adds a timing measurement to the statistics
+		 */
+		static void record(CVStageStatistics& statistics, double duration, double latency);
+
+		CVService*								mService = nullptr;			///< OpenCV service, owns the worker threads
+		CVFramePool								mConvertPool;				///< Recycles converted frames
+		std::vector<std::unique_ptr<Stage>>		mStages;					///< All registered stages
+		mutable std::mutex						mStageMutex;				///< Guards the stages and statistics
+		std::condition_variable					mIdleCondition;				///< Signalled when a stage becomes idle
+		CVStageStatistics						mConversionStatistics;		///< Conversion timing information
+	};
+
+	using CVPipelineObjectCreator = rtti::ObjectCreator<CVPipeline, CVService>;
+}
@@ -7,14 +7,18 @@
 #include "cvcapturedevice.h"
 #include "cvevent.h"
 #include "cvcapturecomponent.h"
+#include "cvpipeline.h"
 
 // external includes
 #include <opencv2/core/ocl.hpp>
 #include <nap/logger.h>
+#include <utility/threading.h>
+#include <thread>
 #include <unordered_map>
 
 RTTI_BEGIN_CLASS(nap::CVServiceConfiguration)
-	RTTI_PROPERTY("ThreadCount", &nap::CVServiceConfiguration::mThreadCount, nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("ThreadCount",		&nap::CVServiceConfiguration::mThreadCount,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PipelineThreads",	&nap::CVServiceConfiguration::mPipelineThreads,	nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::CVService)
@@ -45,10 +49,30 @@ namespace nap
 	{
 		int thread_count = getConfiguration<CVServiceConfiguration>()->mThreadCount;
 		cv::setNumThreads(thread_count);
+
+		// Create the workers that run the pipeline stages
+		int pipeline_threads = getConfiguration<CVServiceConfiguration>()->mPipelineThreads;
+		if (pipeline_threads <= 0)
+			pipeline_threads = std::max<int>(std::thread::hardware_concurrency(), 1);
+		mThreadPool = std::make_unique<ThreadPool>(pipeline_threads);
 		return true;
 	}
 
 
+	void CVService::shutdown()
+	{
+		if (mThreadPool != nullptr)
+			mThreadPool->shutDown();
+	}
+
+
+	ThreadPool& CVService::getThreadPool()
+	{
+		assert(mThreadPool != nullptr);
+		return *mThreadPool;
+	}
+
+
 	void CVService::update(double deltaTime)
 	{
 		// Iterate over every capture device, if any capture component
@@ -89,6 +113,7 @@ namespace nap
 	void CVService::registerObjectCreators(rtti::Factory& factory)
 	{
 		factory.addObjectCreator(std::make_unique<CVCaptureDeviceObjectCreator>(*this));
+		factory.addObjectCreator(std::make_unique<CVPipelineObjectCreator>(*this));
 	}
 
 
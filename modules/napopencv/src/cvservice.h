@@ -7,6 +7,7 @@
 // Nap Includes
 #include <nap/service.h>
 #include <nap/signalslot.h>
+#include <memory>
 
 namespace nap
 {
@@ -15,6 +16,7 @@ namespace nap
 	class CVFrameEvent;
 	class CVCaptureComponentInstance;
 	class CVService;
+	class ThreadPool;
 
 	/**
 	 * Configurable OpenCV library parameters.
@@ -25,6 +27,7 @@ namespace nap
 	public:
 		virtual rtti::TypeInfo getServiceType() override	{ return RTTI_OF(CVService); }
 		int mThreadCount = -1;								///< Property: 'ThreadCount' max number of threads to use, -1 = default
+		int mPipelineThreads = 2;							///< Property: 'PipelineThreads' number of worker threads that run the stages of all pipelines, 0 = number of hardware threads
 	};
 
 	/**
@@ -60,6 +63,13 @@ namespace nap
 		 */
 		int getThreadCount() const;
 
+		/**
+		 * Returns the worker threads that run the stages of every nap::CVPipeline.
+		 * Tasks can be added from any thread. Only valid after initialization.
+		 * @return the worker threads shared by all pipelines.
+		 */
+		ThreadPool& getThreadPool();
+
 	protected:
 
 		/**
@@ -78,6 +88,11 @@ namespace nap
 		 */
 		virtual void update(double deltaTime) override;
 
+		/**
+		 * Stops the pipeline worker threads
+		 */
+		virtual void shutdown() override;
+
 		/**
 		 *	Object creators associated with video module
 		 */
@@ -109,5 +124,8 @@ namespace nap
 
 		// All the capture components currently registered in the system
 		std::vector<CVCaptureComponentInstance*> mCaptureComponents;
+
+		// Worker threads that run the pipeline stages
+		std::unique_ptr<ThreadPool> mThreadPool;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,432 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "cvstreamreceiver.h"
+
+// External Includes
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+	#include <libavutil/pixfmt.h>
+}
+
+namespace nap
+{
+	/**
+	 * @return current time in nanoseconds, used to detect network timeouts
+	 */
+	static int64 getNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(HighResolutionClock::now().time_since_epoch()).count();
+	}
+
+
+	/**
+	 * @return the given number of seconds as clock duration
+	 */
+	static HighResolutionClock::duration toDuration(double seconds)
+	{
+		return std::chrono::duration_cast<HighResolutionClock::duration>(std::chrono::duration<double>(seconds));
+	}
+
+
+	/**
+	 * @return FFmpeg error code as string
+	 */
+	static std::string getErrorString(int error)
+	{
+		char buffer[AV_ERROR_MAX_STRING_SIZE];
+		av_strerror(error, buffer, sizeof(buffer));
+		return buffer;
+	}
+
+
+	/**
+	 * Copies a (strided) image plane into tightly packed memory
+	 */
+	static void copyPlane(const uint8* source, int stride, int width, int rows, uint8* target)
+	{
+		cv::Mat(rows, width, CV_8UC1, const_cast<uint8*>(source), stride).copyTo(cv::Mat(rows, width, CV_8UC1, target));
+	}
+
+
+	CVStreamReceiver::~CVStreamReceiver()
+	{
+		stop();
+	}
+
+
+	void CVStreamReceiver::start(const CVStreamSettings& settings)
+	{
+		// Register all formats and protocols once
+		static std::once_flag registered;
+		std::call_once(registered, []()
+		{
+			av_register_all();
+			avcodec_register_all();
+			avformat_network_init();
+		});
+
+		stop();
+		mSettings = settings;
+		mSettings.mBufferSize = std::max(mSettings.mBufferSize, 1);
+		mStatistics = {};
+		mLastError.clear();
+		mFrames.clear();
+		mClockStarted = false;
+		mStop = false;
+		mReceiveTask = std::async(std::launch::async, std::bind(&CVStreamReceiver::receiveTask, this));
+	}
+
+
+	void CVStreamReceiver::stop()
+	{
+		// Blocking network calls are interrupted by the interrupt callback
+		{
+			std::lock_guard<std::mutex> lock(mFrameMutex);
+			mStop = true;
+		}
+		mFrameCondition.notify_all();
+
+		if (mReceiveTask.valid())
+			mReceiveTask.wait();
+	}
+
+
+	bool CVStreamReceiver::pop(CVStreamFrame& outFrame, float timeout)
+	{
+		std::unique_lock<std::mutex> lock(mFrameMutex);
+		auto deadline = HighResolutionClock::now() + toDuration(timeout / 1000.0);
+		auto due_time = [this](const CVStreamFrame& frame)
+		{
+			return mSettings.mJitterDelay <= 0.0f ? frame.mReceiveTime :
+				mClockStart + toDuration(frame.mTimestamp - mClockBase + mSettings.mJitterDelay / 1000.0);
+		};
+
+		while (true)
+		{
+			// Find the last frame that is due, frames are ordered by time
+			HighResTimeStamp now = HighResolutionClock::now();
+			int due = -1;
+			for (int i = 0; i < static_cast<int>(mFrames.size()) && due_time(mFrames[i]) <= now; i++)
+				due = i;
+
+			// Release the oldest or most recent frame that is due
+			if (due >= 0)
+			{
+				int index = mSettings.mSkipToLatest ? due : 0;
+				outFrame = std::move(mFrames[index]);
+				mFrames.erase(mFrames.begin(), mFrames.begin() + index + 1);
+				mStatistics.mDropped += index;
+				mStatistics.mBuffered = static_cast<int>(mFrames.size());
+				mStatistics.mLatency = std::chrono::duration<double, std::milli>(now - outFrame.mReceiveTime).count();
+				return true;
+			}
+
+			// Wait for a new frame, the next frame to become due or the timeout
+			if (mStop || now >= deadline)
+				return false;
+
+			mFrameCondition.wait_until(lock, mFrames.empty() ? deadline : std::min(deadline, due_time(mFrames.front())));
+		}
+	}
+
+
+	std::string CVStreamReceiver::getLastError() const
+	{
+		std::lock_guard<std::mutex> lock(mFrameMutex);
+		return mLastError;
+	}
+
+
+	CVStreamStatistics CVStreamReceiver::getStatistics() const
+	{
+		std::lock_guard<std::mutex> lock(mFrameMutex);
+		return mStatistics;
+	}
+
+
+	void CVStreamReceiver::receiveTask()
+	{
+		float delay = mSettings.mReconnectDelay;
+		while (!mStop)
+		{
+			// Connect and receive until the connection is lost
+			utility::ErrorState error;
+			uint64 received = getStatistics().mReceived;
+			if (connect(error))
+			{
+				mConnected = true;
+				while (!mStop && receive(error)) { }
+				mConnected = false;
+			}
+			disconnect();
+
+			if (mStop)
+				break;
+
+			if (error.hasErrors())
+				setError(error.toString());
+
+			// Reset back-off when frames were received, double it otherwise
+			delay = getStatistics().mReceived > received ? mSettings.mReconnectDelay :
+				std::min(delay * 2.0f, mSettings.mMaxReconnectDelay);
+
+			{
+				std::lock_guard<std::mutex> lock(mFrameMutex);
+				mStatistics.mReconnects++;
+			}
+
+			if (!waitReconnect(delay))
+				break;
+		}
+	}
+
+
+	bool CVStreamReceiver::connect(utility::ErrorState& error)
+	{
+		// Low latency options: don't buffer input, limit stream analysis and time out when no data arrives
+		AVDictionary* options = nullptr;
+		if (mSettings.mTransport != ECVStreamTransport::Auto)
+			av_dict_set(&options, "rtsp_transport", mSettings.mTransport == ECVStreamTransport::TCP ? "tcp" : "udp", 0);
+		av_dict_set(&options, "fflags", "nobuffer", 0);
+		av_dict_set(&options, "flags", "low_delay", 0);
+		av_dict_set(&options, "analyzeduration", "500000", 0);
+		av_dict_set(&options, "probesize", "500000", 0);
+
+		// Open stream, the interrupt callback aborts when stopped or timed out
+		mFormatContext = avformat_alloc_context();
+		mFormatContext->interrupt_callback.callback = &CVStreamReceiver::interrupt;
+		mFormatContext->interrupt_callback.opaque = this;
+		mLastActivity = getNanoseconds();
+		int result = avformat_open_input(&mFormatContext, mSettings.mLink.c_str(), nullptr, &options);
+		av_dict_free(&options);
+		if (!error.check(result >= 0, "Unable to open stream: %s, %s", mSettings.mLink.c_str(), getErrorString(result).c_str()))
+			return false;
+
+		mLastActivity = getNanoseconds();
+		result = avformat_find_stream_info(mFormatContext, nullptr);
+		if (!error.check(result >= 0, "Unable to read stream info: %s, %s", mSettings.mLink.c_str(), getErrorString(result).c_str()))
+			return false;
+
+		// Find video stream and decoder
+		AVCodec* codec = nullptr;
+		mStreamIndex = av_find_best_stream(mFormatContext, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+		if (!error.check(mStreamIndex >= 0 && codec != nullptr, "No decodable video stream in: %s", mSettings.mLink.c_str()))
+			return false;
+
+		// Open decoder, slice threading doesn't add frames of latency
+		AVStream* stream = mFormatContext->streams[mStreamIndex];
+		mCodecContext = avcodec_alloc_context3(codec);
+		avcodec_parameters_to_context(mCodecContext, stream->codecpar);
+		mCodecContext->flags |= AV_CODEC_FLAG_LOW_DELAY;
+		mCodecContext->thread_type = FF_THREAD_SLICE;
+		AVDictionary* codec_options = nullptr;
+		av_dict_set(&codec_options, "threads", "auto", 0);
+		result = avcodec_open2(mCodecContext, codec, &codec_options);
+		av_dict_free(&codec_options);
+		if (!error.check(result >= 0, "Unable to open decoder: %s", getErrorString(result).c_str()))
+			return false;
+
+		mTimeBase = av_q2d(stream->time_base);
+		mWidth = mCodecContext->width;
+		mHeight = mCodecContext->height;
+		mFrame = av_frame_alloc();
+		mPacket = av_packet_alloc();
+		mPaceStarted = false;
+		return true;
+	}
+
+
+	void CVStreamReceiver::disconnect()
+	{
+		if (mPacket != nullptr)
+			av_packet_free(&mPacket);
+
+		if (mFrame != nullptr)
+			av_frame_free(&mFrame);
+
+		if (mCodecContext != nullptr)
+			avcodec_free_context(&mCodecContext);
+
+		if (mFormatContext != nullptr)
+			avformat_close_input(&mFormatContext);
+
+		mStreamIndex = -1;
+	}
+
+
+	bool CVStreamReceiver::receive(utility::ErrorState& error)
+	{
+		// Read next packet, fails when the connection is lost, timed out or the end of the file is reached
+		mLastActivity = getNanoseconds();
+		int result = av_read_frame(mFormatContext, mPacket);
+		if (result < 0)
+		{
+			if (result != AVERROR_EOF && !mStop)
+				error.fail("Connection lost: %s, %s", mSettings.mLink.c_str(), getErrorString(result).c_str());
+			return false;
+		}
+
+		// Skip other streams
+		if (mPacket->stream_index != mStreamIndex)
+		{
+			av_packet_unref(mPacket);
+			return true;
+		}
+
+		// Decode, corrupt packets are skipped
+		result = avcodec_send_packet(mCodecContext, mPacket);
+		av_packet_unref(mPacket);
+		if (result < 0 && result != AVERROR(EAGAIN))
+			return true;
+
+		while (avcodec_receive_frame(mCodecContext, mFrame) == 0)
+		{
+			bool pushed = push(error);
+			av_frame_unref(mFrame);
+			if (!pushed)
+				return false;
+		}
+		return true;
+	}
+
+
+	bool CVStreamReceiver::push(utility::ErrorState& error)
+	{
+		// Timestamp, falls back to the local clock when the stream has none
+		HighResTimeStamp receive_time = HighResolutionClock::now();
+		int64_t pts = av_frame_get_best_effort_timestamp(mFrame);
+		double timestamp = pts != AV_NOPTS_VALUE ? static_cast<double>(pts) * mTimeBase :
+			std::chrono::duration<double>(receive_time.time_since_epoch()).count();
+
+		// Read at the rate of the stream when pacing input, used to play back a file as if it's live
+		if (mSettings.mPaceInput)
+		{
+			double offset = timestamp - mPaceBase;
+			if (!mPaceStarted || offset < 0.0 || offset > 1.0 + std::chrono::duration<double>(receive_time - mPaceStart).count())
+			{
+				mPaceStarted = true;
+				mPaceStart = receive_time;
+				mPaceBase = timestamp;
+			}
+			std::this_thread::sleep_until(mPaceStart + toDuration(timestamp - mPaceBase));
+			receive_time = HighResolutionClock::now();
+		}
+
+		// Convert to BGR, the planes are packed for the OpenCV conversion
+		int width = mFrame->width;
+		int height = mFrame->height;
+		CVStreamFrame frame;
+		frame.mImage.create(height, width, CV_8UC3);
+		switch (mFrame->format)
+		{
+		case AV_PIX_FMT_YUV420P:
+		case AV_PIX_FMT_YUVJ420P:
+		{
+			if (!error.check(width % 2 == 0 && height % 2 == 0, "Unsupported frame size: %dx%d", width, height))
+				return false;
+			mYUV.create(height + height / 2, width, CV_8UC1);
+			uint8* target = mYUV.data;
+			copyPlane(mFrame->data[0], mFrame->linesize[0], width, height, target);
+			copyPlane(mFrame->data[1], mFrame->linesize[1], width / 2, height / 2, target + width * height);
+			copyPlane(mFrame->data[2], mFrame->linesize[2], width / 2, height / 2, target + width * height + (width / 2) * (height / 2));
+			cv::cvtColor(mYUV, frame.mImage, cv::COLOR_YUV2BGR_I420);
+			break;
+		}
+		case AV_PIX_FMT_NV12:
+		{
+			if (!error.check(width % 2 == 0 && height % 2 == 0, "Unsupported frame size: %dx%d", width, height))
+				return false;
+			mYUV.create(height + height / 2, width, CV_8UC1);
+			copyPlane(mFrame->data[0], mFrame->linesize[0], width, height, mYUV.data);
+			copyPlane(mFrame->data[1], mFrame->linesize[1], width, height / 2, mYUV.data + width * height);
+			cv::cvtColor(mYUV, frame.mImage, cv::COLOR_YUV2BGR_NV12);
+			break;
+		}
+		case AV_PIX_FMT_BGR24:
+			cv::Mat(height, width, CV_8UC3, mFrame->data[0], mFrame->linesize[0]).copyTo(frame.mImage);
+			break;
+		case AV_PIX_FMT_RGB24:
+			cv::cvtColor(cv::Mat(height, width, CV_8UC3, mFrame->data[0], mFrame->linesize[0]), frame.mImage, cv::COLOR_RGB2BGR);
+			break;
+		case AV_PIX_FMT_BGR0:
+		case AV_PIX_FMT_BGRA:
+			cv::cvtColor(cv::Mat(height, width, CV_8UC4, mFrame->data[0], mFrame->linesize[0]), frame.mImage, cv::COLOR_BGRA2BGR);
+			break;
+		default:
+			error.fail("Unsupported pixel format: %d", mFrame->format);
+			return false;
+		}
+		frame.mTimestamp = timestamp;
+		frame.mReceiveTime = receive_time;
+
+		// Add to buffer
+		{
+			std::lock_guard<std::mutex> lock(mFrameMutex);
+
+			// Restart the playout clock on discontinuities (reconnect, end of file), older frames are discarded
+			if (!mClockStarted || timestamp < mLastTimestamp || timestamp - mLastTimestamp > 1.0)
+			{
+				mStatistics.mDropped += mFrames.size();
+				mFrames.clear();
+				mClockStarted = true;
+				mClockStart = receive_time;
+				mClockBase = timestamp;
+			}
+
+			// Frame arrived later than it should have been played: delay the clock, so the following frames are buffered again
+			HighResTimeStamp due = mClockStart + toDuration(timestamp - mClockBase);
+			if (receive_time > due)
+				mClockStart += receive_time - due;
+
+			// Drop the oldest frame when the buffer is full
+			if (static_cast<int>(mFrames.size()) >= mSettings.mBufferSize)
+			{
+				mFrames.pop_front();
+				mStatistics.mDropped++;
+			}
+
+			mFrames.emplace_back(std::move(frame));
+			mLastTimestamp = timestamp;
+			mStatistics.mReceived++;
+			mStatistics.mBuffered = static_cast<int>(mFrames.size());
+		}
+		mFrameCondition.notify_all();
+		return true;
+	}
+
+
+	bool CVStreamReceiver::waitReconnect(float delay)
+	{
+		std::unique_lock<std::mutex> lock(mFrameMutex);
+		return !mFrameCondition.wait_for(lock, std::chrono::duration<float, std::milli>(delay), [this]()
+		{
+			return mStop.load();
+		});
+	}
+
+
+	void CVStreamReceiver::setError(const std::string& error)
+	{
+		std::lock_guard<std::mutex> lock(mFrameMutex);
+		mLastError = error;
+	}
+
+
+	int CVStreamReceiver::interrupt(void* receiver)
+	{
+		// Abort when stopped or when no data arrived within the timeout
+		CVStreamReceiver* self = static_cast<CVStreamReceiver*>(receiver);
+		double elapsed = static_cast<double>(getNanoseconds() - self->mLastActivity) / 1000000.0;
+		return (self->mStop || elapsed > self->mSettings.mTimeout) ? 1 : 0;
+	}
+}
@@ -0,0 +1,220 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <nap/datetime.h>
+#include <opencv2/core/mat.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+
+// Forward Declares
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+
+namespace nap
+{
+	/**
+	 * Network protocol used to receive RTSP streams.
+	 */
+	enum class ECVStreamTransport : int
+	{
+		Auto	= 0,			///< Decided by FFmpeg, tries UDP first
+		TCP		= 1,			///< Interleaved in the RTSP connection, reliable
+		UDP		= 2				///< Separate UDP connection, lowest latency but packets can be lost
+	};
+
+
+	/**
+	 * Settings of a nap::CVStreamReceiver. All times are in milliseconds.
+	 */
+	struct NAPAPI CVStreamSettings
+	{
+		std::string			mLink;												///< Link to the stream, any url or file FFmpeg can open
+		ECVStreamTransport	mTransport = ECVStreamTransport::TCP;				///< RTSP transport
+		int					mBufferSize = 4;									///< Max number of decoded frames in the jitter buffer
+		float				mJitterDelay = 0.0f;								///< Time a frame is held back to smooth out irregular arrival, 0 = no delay
+		bool				mSkipToLatest = true;								///< If all frames that are due are skipped except the most recent one
+		float				mTimeout = 2000.0f;									///< Time without data after which the connection is considered lost
+		float				mReconnectDelay = 250.0f;							///< Time to wait before the first reconnection attempt
+		float				mMaxReconnectDelay = 5000.0f;						///< Max time to wait in between reconnection attempts, the delay doubles after every failed attempt
+		bool				mPaceInput = false;									///< If packets are read at the rate of the stream, use this to play back a file as if it's live
+	};
+
+
+	/**
+	 * Single decoded frame of a nap::CVStreamReceiver
+	 */
+	struct NAPAPI CVStreamFrame
+	{
+		cv::Mat				mImage;												///< BGR image
+		double				mTimestamp = 0.0;									///< Presentation time in seconds, as reported by the stream
+		HighResTimeStamp	mReceiveTime;										///< Time the frame was decoded
+	};
+
+
+	/**
+	 * Receive statistics of a nap::CVStreamReceiver
+	 */
+	struct NAPAPI CVStreamStatistics
+	{
+		uint64				mReceived = 0;										///< Number of frames decoded
+		uint64				mDropped = 0;										///< Number of frames skipped or dropped because the buffer was full
+		uint64				mReconnects = 0;									///< Number of times the connection was lost or could not be established
+		int					mBuffered = 0;										///< Number of frames currently in the buffer
+		double				mLatency = 0.0;										///< Time in milliseconds the last frame spent in the buffer
+	};
+
+
+	/**
+	 * Receives and decodes a (network) video stream on a background thread using FFmpeg directly.
+	 *
+	 * Decoded frames are placed in a jitter buffer of limited size, when the buffer is full the oldest frame is dropped.
+	 * Frames are released from the buffer at the rate they were sent: a frame is due 'JitterDelay' milliseconds
+	 * after its presentation time, relative to the first frame. With 'SkipToLatest' enabled only the most recent frame that is due is released.
+	 * A slow consumer therefore never falls behind the stream and a network hiccup never blocks the consumer longer than the given timeout.
+	 *
+	 * When the connection is lost, or can't be established, the receiver reconnects automatically.
+	 * The time in between attempts doubles after every failed attempt, up to a maximum.
+	 * Reaching the end of a file also triggers a reconnect, allowing a local file to be used as a stand-in for a live stream.
+	 */
+	class NAPAPI CVStreamReceiver final
+	{
+	public:
+		// Default constructor
+		CVStreamReceiver() = default;
+
+		// Stops receiving
+		~CVStreamReceiver();
+
+		// Copy is not allowed
+		CVStreamReceiver(const CVStreamReceiver&) = delete;
+		CVStreamReceiver& operator=(const CVStreamReceiver&) = delete;
+
+		/**
+		 * Starts receiving the stream on a background thread.
+		 * The connection is made in the background, this call doesn't block.
+		 * @param settings receive settings
+		 */
+		void start(const CVStreamSettings& settings);
+
+		/**
+		 * Stops receiving and closes the connection, blocks until the background thread exits.
+		 */
+		void stop();
+
+		/**
+		 * Waits for the next frame that is due, for a maximum amount of time.
+		 * @param outFrame the next frame, valid when this call returns true
+		 * @param timeout max time to wait in milliseconds
+		 * @return if a frame is available
+		 */
+		bool pop(CVStreamFrame& outFrame, float timeout);
+
+		/**
+		 * @return if the receiver is currently connected to the stream
+		 */
+		bool isConnected() const										{ return mConnected; }
+
+		/**
+		 * @return frame width in pixels of the stream, 0 when unknown
+		 */
+		int getWidth() const											{ return mWidth; }
+
+		/**
+		 * @return frame height in pixels of the stream, 0 when unknown
+		 */
+		int getHeight() const											{ return mHeight; }
+
+		/**
+		 * @return the last connection or decode error, thread safe
+		 */
+		std::string getLastError() const;
+
+		/**
+		 * @return receive statistics, thread safe
+		 */
+		CVStreamStatistics getStatistics() const;
+
+	private:
+		/**
+		 * Connects, receives and reconnects until stopped
+		 */
+		void receiveTask();
+
+		/**
+		 * Opens the stream and decoder
+		 */
+		bool connect(utility::ErrorState& error);
+
+		/**
+		 * Closes the stream and decoder
+		 */
+		void disconnect();
+
+		/**
+		 * Reads and decodes the next packet, returns false when the connection is lost
+		 */
+		bool receive(utility::ErrorState& error);
+
+		/**
+		 * Converts the decoded frame to BGR and adds it to the buffer
+		 */
+		bool push(utility::ErrorState& error);
+
+		/**
+		 * Waits before reconnecting, returns false when stopped while waiting
+		 */
+		bool waitReconnect(float delay);
+
+		/**
+		 * Stores an error
+		 */
+		void setError(const std::string& error);
+
+		/**
+		 * Called by FFmpeg while blocking, aborts blocking operations when stopped or timed out
+		 */
+		static int interrupt(void* receiver);
+
+		CVStreamSettings			mSettings;								///< Receive settings
+		std::future<void>			mReceiveTask;							///< Background receive thread
+		std::atomic<bool>			mStop = { true };						///< If the receiver should stop
+		std::atomic<bool>			mConnected = { false };					///< If connected to the stream
+		std::atomic<int>			mWidth = { 0 };							///< Frame width
+		std::atomic<int>			mHeight = { 0 };						///< Frame height
+		std::atomic<int64>			mLastActivity = { 0 };					///< Time of the last network activity, in nanoseconds
+
+		AVFormatContext*			mFormatContext = nullptr;				///< Demuxer
+		AVCodecContext*				mCodecContext = nullptr;				///< Decoder
+		AVFrame*					mFrame = nullptr;						///< Decoded frame
+		AVPacket*					mPacket = nullptr;						///< Received packet
+		int							mStreamIndex = -1;						///< Video stream index
+		double						mTimeBase = 0.0;						///< Seconds per stream time unit
+		cv::Mat						mYUV;									///< Packed planes of the decoded frame
+		bool						mPaceStarted = false;					///< If pacing started
+		HighResTimeStamp			mPaceStart;								///< Time pacing started
+		double						mPaceBase = 0.0;						///< Timestamp pacing started
+
+		std::deque<CVStreamFrame>	mFrames;								///< Jitter buffer
+		mutable std::mutex			mFrameMutex;							///< Guards the buffer, statistics and error
+		std::condition_variable		mFrameCondition;						///< Signalled when a frame is added or the receiver stops
+		bool						mClockStarted = false;					///< If the playout clock started
+		HighResTimeStamp			mClockStart;							///< Local time of the playout clock base
+		double						mClockBase = 0.0;						///< Stream time of the playout clock base
+		double						mLastTimestamp = 0.0;					///< Timestamp of the last frame added
+		CVStreamStatistics			mStatistics;							///< Receive statistics
+		std::string					mLastError;								///< Last error
+	};
+}
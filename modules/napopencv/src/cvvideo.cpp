@@ -126,7 +126,7 @@ namespace nap
 		else
 			mOutputFrame[0] = mCaptureFrame[0];
 
-		return mOutputFrame.clone();
+		return getFramePool().copy(mOutputFrame);
 	}
 
 
@@ -0,0 +1,282 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "oscaddresstrie.h"
+
+// External Includes
+#include <algorithm>
+#include <cassert>
+
+namespace nap
+{
+	/**
+	 * Expands the first '{}' list of alternatives in the pattern, recursively.
+	 * An unterminated list is taken literally.
+	 */
+	static void expandAlternatives(const std::string& pattern, std::vector<std::string>& outPatterns)
+	{
+		size_t open = pattern.find('{');
+		size_t close = open == std::string::npos ? std::string::npos : pattern.find('}', open);
+		if (close == std::string::npos)
+		{
+			outPatterns.emplace_back(pattern);
+			return;
+		}
+
+		std::string prefix = pattern.substr(0, open);
+		std::string suffix = pattern.substr(close + 1);
+		size_t start = open + 1;
+		while (true)
+		{
+			size_t end = std::min(pattern.find(',', start), close);
+			expandAlternatives(prefix + pattern.substr(start, end - start) + suffix, outPatterns);
+			if (end == close)
+				break;
+			start = end + 1;
+		}
+	}
+
+
+	/**
+	 * Parses the contents of a '[]' character set, excluding the brackets.
+	 */
+	static std::bitset<256> parseCharacterSet(const std::string& contents)
+	{
+		std::bitset<256> characters;
+		bool negate = !contents.empty() && contents[0] == '!';
+		for (size_t i = negate ? 1 : 0; i < contents.size(); i++)
+		{
+			unsigned char first = static_cast<unsigned char>(contents[i]);
+			if (i + 2 < contents.size() && contents[i + 1] == '-')
+			{
+				unsigned char last = static_cast<unsigned char>(contents[i + 2]);
+				for (int c = first; c <= last; c++)
+					characters.set(c);
+				i += 2;
+				continue;
+			}
+			characters.set(first);
+		}
+
+		// The separator never matches
+		if (negate)
+			characters.flip();
+		characters.reset('/');
+		return characters;
+	}
+
+
+	OSCAddressTrie::OSCAddressTrie()
+	{
+		clear();
+	}
+
+
+	void OSCAddressTrie::clear()
+	{
+		mNodes.clear();
+		addNode(false);
+		clearStates();
+	}
+
+
+	void OSCAddressTrie::add(const std::string& pattern, int subscriber)
+	{
+		assert(subscriber >= 0);
+		std::vector<std::string> patterns;
+		expandAlternatives(pattern, patterns);
+		for (const auto& expanded : patterns)
+			insert(expanded, subscriber);
+		clearStates();
+	}
+
+
+	const std::vector<int>& OSCAddressTrie::match(const std::string& address)
+	{
+		if (static_cast<int>(mStates.size()) > maxStateCount)
+			clearStates();
+
+		// Create start state
+		if (mStates.empty())
+		{
+			mNodeBuffer.clear();
+			mMatchBuffer.clear();
+			addClosure(0, mNodeBuffer, mMatchBuffer);
+			findState(mNodeBuffer, mMatchBuffer);
+		}
+
+		// Walk until the address ends or no pattern is active anymore
+		int state = 0;
+		for (char character : address)
+		{
+			if (mStates[state].mNodes.empty())
+				break;
+			state = step(state, static_cast<unsigned char>(character));
+		}
+		return mStates[state].mMatched;
+	}
+
+
+	void OSCAddressTrie::insert(const std::string& pattern, int subscriber)
+	{
+		int node = 0;
+		size_t i = 0;
+		while (i < pattern.size())
+		{
+			char character = pattern[i];
+
+			// Zero or more characters, consecutive stars are the same as one
+			if (character == '*')
+			{
+				if (!mNodes[node].mLoops)
+				{
+					if (mNodes[node].mStar < 0)
+					{
+						int star = addNode(true);
+						mNodes[node].mStar = star;
+					}
+					node = mNodes[node].mStar;
+				}
+				i++;
+				continue;
+			}
+
+			// Single character out of a set
+			size_t close = character == '[' ? pattern.find(']', i + 1) : std::string::npos;
+			if (character == '?' || close != std::string::npos)
+			{
+				size_t length = character == '?' ? 1 : close - i + 1;
+				std::string token = pattern.substr(i, length);
+				auto found = std::find_if(mNodes[node].mSets.begin(), mNodes[node].mSets.end(), [&token](const CharacterSet& set)
+				{
+					return set.mToken == token;
+				});
+
+				if (found != mNodes[node].mSets.end())
+				{
+					node = found->mTarget;
+				}
+				else
+				{
+					CharacterSet set;
+					set.mCharacters = character == '?' ? parseCharacterSet("!") : parseCharacterSet(pattern.substr(i + 1, length - 2));
+					set.mToken = token;
+					set.mTarget = addNode(false);
+					int target = set.mTarget;
+					mNodes[node].mSets.emplace_back(std::move(set));
+					node = target;
+				}
+				i += length;
+				continue;
+			}
+
+			// Literal character
+			auto found = mNodes[node].mLiterals.find(character);
+			if (found != mNodes[node].mLiterals.end())
+			{
+				node = found->second;
+			}
+			else
+			{
+				int target = addNode(false);
+				mNodes[node].mLiterals.emplace(character, target);
+				node = target;
+			}
+			i++;
+		}
+
+		auto& subscribers = mNodes[node].mSubscribers;
+		if (std::find(subscribers.begin(), subscribers.end(), subscriber) == subscribers.end())
+			subscribers.emplace_back(subscriber);
+	}
+
+
+	int OSCAddressTrie::addNode(bool loops)
+	{
+		mNodes.emplace_back();
+		mNodes.back().mLoops = loops;
+		return static_cast<int>(mNodes.size()) - 1;
+	}
+
+
+	void OSCAddressTrie::addClosure(int node, std::vector<int>& outNodes, std::vector<int>& outMatched) const
+	{
+		// Follow the '*' nodes, they are entered without consuming a character
+		while (node >= 0)
+		{
+			outNodes.emplace_back(node);
+			const auto& subscribers = mNodes[node].mSubscribers;
+			outMatched.insert(outMatched.end(), subscribers.begin(), subscribers.end());
+			node = mNodes[node].mStar;
+		}
+	}
+
+
+	int OSCAddressTrie::findState(std::vector<int>& nodes, std::vector<int>& matched)
+	{
+		std::sort(nodes.begin(), nodes.end());
+		nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+		std::sort(matched.begin(), matched.end());
+		matched.erase(std::unique(matched.begin(), matched.end()), matched.end());
+
+		// Key is the nodes, a separator and the matches
+		std::vector<int> key(nodes);
+		key.emplace_back(-1);
+		key.insert(key.end(), matched.begin(), matched.end());
+		auto found = mStateLookup.find(key);
+		if (found != mStateLookup.end())
+			return found->second;
+
+		State state;
+		state.mNodes = nodes;
+		state.mMatched = matched;
+		state.mNext.fill(-1);
+		mStates.emplace_back(std::move(state));
+
+		int index = static_cast<int>(mStates.size()) - 1;
+		mStateLookup.emplace(std::move(key), index);
+		return index;
+	}
+
+
+	int OSCAddressTrie::step(int state, unsigned char character)
+	{
+		int next = mStates[state].mNext[character];
+		if (next >= 0)
+			return next;
+
+		// Matches are kept, a pattern matches the start of an address
+		mNodeBuffer.clear();
+		mMatchBuffer = mStates[state].mMatched;
+		for (int node : mStates[state].mNodes)
+		{
+			const Node& current = mNodes[node];
+			auto literal = current.mLiterals.find(static_cast<char>(character));
+			if (literal != current.mLiterals.end())
+				addClosure(literal->second, mNodeBuffer, mMatchBuffer);
+
+			for (const auto& set : current.mSets)
+			{
+				if (set.mCharacters.test(character))
+					addClosure(set.mTarget, mNodeBuffer, mMatchBuffer);
+			}
+
+			if (current.mLoops && character != '/')
+				addClosure(node, mNodeBuffer, mMatchBuffer);
+		}
+
+		// Creating the state can grow the list of states, store the transition afterwards
+		next = findState(mNodeBuffer, mMatchBuffer);
+		mStates[state].mNext[character] = next;
+		return next;
+	}
+
+
+	void OSCAddressTrie::clearStates()
+	{
+		mStates.clear();
+		mStateLookup.clear();
+	}
+}
@@ -0,0 +1,119 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <array>
+#include <bitset>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Routes OSC addresses to subscribers, based on the address patterns the subscribers registered.
+	 *
+	 * Patterns support the OSC 1.0 address pattern syntax:
+	 * '?' matches any single character, '*' matches any sequence of zero or more characters,
+	 * '[abc]' matches one of the listed characters, '[a-z]' a range, '[!a-z]' any character not in the range
+	 * and '{foo,bar}' matches one of the listed strings. None of them match the '/' separator.
+	 * A pattern matches an address when it matches the start of the address, a pattern without wildcards
+	 * therefore matches every address that starts with it. An empty pattern matches every address.
+	 *
+	 * All patterns are compiled into a trie, literal characters of patterns share nodes.
+	 * Matching walks the trie for all patterns at once, the result of every step is cached as a single state:
+	 * once warmed up an address is routed in time proportional to its length, independent of the number of patterns.
+	 * The trie has to be rebuilt when the patterns change: clear() and add() all patterns again.
+	 */
+	class NAPAPI OSCAddressTrie final
+	{
+	public:
+		// Constructor
+		OSCAddressTrie();
+
+		/**
+		 * Removes all patterns
+		 */
+		void clear();
+
+		/**
+		 * Adds an address pattern for the given subscriber. A subscriber can add multiple patterns.
+		 * @param pattern the OSC address pattern
+		 * @param subscriber id of the subscriber, must be 0 or higher
+		 */
+		void add(const std::string& pattern, int subscriber);
+
+		/**
+		 * Returns all subscribers with a pattern that matches the address, sorted by id.
+		 * Every subscriber is listed once, also when multiple patterns of the subscriber match.
+		 * @param address the address to route
+		 * @return the matching subscribers, valid until the next call to match(), add() or clear()
+		 */
+		const std::vector<int>& match(const std::string& address);
+
+		/**
+		 * @return the number of cached match states
+		 */
+		int getStateCount() const											{ return static_cast<int>(mStates.size()); }
+
+		/**
+		 * Max number of cached match states, the cache is cleared when it grows beyond this number.
+		 */
+		static constexpr int maxStateCount = 4096;
+
+	private:
+		// Edge that matches one character out of a set
+		struct CharacterSet
+		{
+			std::bitset<256> mCharacters;									///< Characters that match
+			std::string mToken;												///< Pattern text of the set, edges with the same text are shared
+			int mTarget = -1;												///< Target node
+		};
+
+		// Node of the pattern trie
+		struct Node
+		{
+			std::map<char, int> mLiterals;									///< Literal character edges
+			std::vector<CharacterSet> mSets;								///< '?' and '[]' edges
+			int mStar = -1;													///< Node that follows a '*', entered without consuming a character
+			bool mLoops = false;											///< If this node follows a '*' and consumes any character except '/'
+			std::vector<int> mSubscribers;									///< Subscribers with a pattern that ends here
+		};
+
+		// Cached set of active nodes, after walking part of an address
+		struct State
+		{
+			std::vector<int> mNodes;										///< Active nodes, sorted
+			std::vector<int> mMatched;										///< Subscribers matched so far, sorted
+			std::array<int, 256> mNext;										///< Next state per character, -1 when not computed yet
+		};
+
+		// Adds a pattern without alternatives
+		void insert(const std::string& pattern, int subscriber);
+
+		// Adds a node and returns its index
+		int addNode(bool loops);
+
+		// Adds a node and all nodes reachable without consuming a character
+		void addClosure(int node, std::vector<int>& outNodes, std::vector<int>& outMatched) const;
+
+		// Returns the state for the given nodes and matches, creates it when it doesn't exist
+		int findState(std::vector<int>& nodes, std::vector<int>& matched);
+
+		// Returns the state after consuming a character
+		int step(int state, unsigned char character);
+
+		// Removes all cached states
+		void clearStates();
+
+		std::vector<Node> mNodes;											///< Pattern trie, the first node is the root
+		std::vector<State> mStates;											///< Cached states, the first state is the start state
+		std::map<std::vector<int>, int> mStateLookup;						///< Finds a state based on its nodes and matches
+		std::vector<int> mNodeBuffer;										///< Scratch buffer for nodes of a new state
+		std::vector<int> mMatchBuffer;										///< Scratch buffer for matches of a new state
+	};
+}
@@ -61,7 +61,7 @@ RTTI_END_CLASS
 
 namespace nap
 {
-	OSCBlob::OSCBlob(const void* data, int size) : mSize(size)
+	OSCBlob::OSCBlob(const void* data, int size) : mSize(size), mCapacity(size)
 	{
         mData = malloc(size);
 		memcpy(mData, data, size);
@@ -81,6 +81,19 @@ namespace nap
 	}
 
 
+	void OSCBlob::assign(const void* data, int size)
+	{
+		if (size > mCapacity)
+		{
+			free(mData);
+			mData = malloc(size);
+			mCapacity = size;
+		}
+		memcpy(mData, data, size);
+		mSize = size;
+	}
+
+
 	void OSCBlob::add(osc::OutboundPacketStream& outPacket) const
 	{
 		outPacket << osc::Blob(mData, mSize);
@@ -102,14 +115,14 @@ namespace nap
 	float OSCArgument::asFloat() const
 	{
 		assert(isFloat());
-		return static_cast<const OSCValue<float>*>(this->mValue.get())->mValue;
+		return static_cast<const OSCValue<float>*>(this->mValue)->mValue;
 	}
 
 
 	int OSCArgument::asInt() const
 	{
 		assert(isInt());
-		return static_cast<const OSCValue<int>*>(this->mValue.get())->mValue;
+		return static_cast<const OSCValue<int>*>(this->mValue)->mValue;
 	}
 
 
@@ -121,7 +134,7 @@ namespace nap
 	bool OSCArgument::asBool() const
 	{
 		assert(isBool());
-		return static_cast<const OSCValue<bool>*>(this->mValue.get())->mValue;
+		return static_cast<const OSCValue<bool>*>(this->mValue)->mValue;
 	}
 
 
@@ -134,7 +147,7 @@ namespace nap
 	const std::string& OSCArgument::asString() const
 	{
 		assert(isString());
-		return static_cast<const OSCString*>(this->mValue.get())->mString;
+		return static_cast<const OSCString*>(this->mValue)->mString;
 	}
 
 
@@ -147,7 +160,7 @@ namespace nap
 	double OSCArgument::asDouble() const
 	{
 		assert(isDouble());
-		return static_cast<const OSCValue<double>*>(this->mValue.get())->mValue;
+		return static_cast<const OSCValue<double>*>(this->mValue)->mValue;
 	}
 
 
@@ -160,7 +173,7 @@ namespace nap
 	char OSCArgument::asChar() const
 	{
 		assert(isChar());
-		return static_cast<const OSCValue<char>*>(this->mValue.get())->mValue;
+		return static_cast<const OSCValue<char>*>(this->mValue)->mValue;
 	}
 
 
@@ -182,10 +195,26 @@ namespace nap
 	}
 
 
-	OSCArgument::OSCArgument(OSCValuePtr value) : mValue(std::move(value))
+	OSCArgument::OSCArgument(OSCValuePtr value) : mValue(value.get()), mHeapValue(std::move(value))
 	{	}
 
 
+	OSCArgument::~OSCArgument()
+	{
+		reset();
+	}
+
+
+	void OSCArgument::reset()
+	{
+		// Values that are not owned by the heap pointer are constructed in place
+		if (mValue != nullptr && mHeapValue == nullptr)
+			mValue->~OSCBaseValue();
+		mHeapValue = nullptr;
+		mValue = nullptr;
+	}
+
+
 	void OSCArgument::add(osc::OutboundPacketStream& outPacket) const
 	{
 		mValue->add(outPacket);
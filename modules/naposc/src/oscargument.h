@@ -10,6 +10,9 @@
 #include <glm/glm.hpp>
 #include <osc/OscOutboundPacketStream.h>
 #include <sstream>
+#include <cstddef>
+#include <new>
+#include <type_traits>
 
 namespace nap
 {
@@ -21,17 +24,44 @@ namespace nap
 	 * This class offers some utility methods to quickly work with the most common OSC values.
 	 * For other / more complex OSC Value types you can ask for the value using the get<T> function.
 	 * Note that this argument owns the value.
+	 *
+	 * Values that fit are constructed in place, in storage that is part of the argument:
+	 * all basic types, strings and blobs are stored without a separate heap allocation.
+	 * Use emplace() to (re)construct the value of an existing argument.
 	 */
 	class NAPAPI OSCArgument final
 	{
 		RTTI_ENABLE()
 	public:
+		// Number of bytes available to store a value in place
+		static constexpr std::size_t inlineSize = 48;
+
 		// Default Constructor
         OSCArgument() = default;
 		OSCArgument(OSCValuePtr value);
 
-		// Default Destructor
-		~OSCArgument() = default;
+		// Destroys the value
+		~OSCArgument();
+
+		/**
+		 * Replaces the value of this argument with a new value of type T, constructed using the given arguments.
+		 * The value is constructed in place when it fits, otherwise it is allocated on the heap.
+		 * @param args the arguments that are used for constructing the specified OSCValue.
+		 * @return the new value
+		 */
+		template<typename T, typename... Args>
+		T& emplace(Args&&... args);
+
+		/**
+		 * @return if this argument holds a value
+		 */
+		bool hasValue() const												{ return mValue != nullptr; }
+
+		/**
+		 * @return if this argument holds a value of type T
+		 */
+		template<typename T>
+		bool holds() const;
 
 		/**
 		 * @return the value as type T, nullptr if the type doesn't match
@@ -139,7 +169,14 @@ namespace nap
 		std::size_t size() const;
 
 	private:
-		OSCValuePtr mValue = nullptr;
+		using Storage = std::aligned_storage<inlineSize, alignof(std::max_align_t)>::type;
+
+		// Destroys the current value
+		void reset();
+
+		OSCBaseValue* mValue = nullptr;			// The value, stored in place or owned by mHeapValue
+		OSCValuePtr mHeapValue = nullptr;		// Owns the value when it doesn't fit in place
+		Storage mStorage;						// Storage for values that are constructed in place
 	};
 
 
@@ -282,6 +319,14 @@ namespace nap
 		 */
 		void* getCopy();
 
+		/**
+		 * Copies the given data block in to mData.
+		 * The current data block is reused when it is large enough.
+		 * @param sourceData the osc data associated with the blob
+		 * @param size the size of the blob in bytes
+		 */
+		void assign(const void* sourceData, int size);
+
 		/**
 		 * @return an empty string
 		 */
@@ -296,6 +341,9 @@ namespace nap
 	protected:
 		virtual void add(osc::OutboundPacketStream& outPacket) const override;
 		virtual size_t size() const override									{ return mSize; }
+
+	private:
+		int mCapacity = 0;		// Size of the allocated data block in bytes
 	};
 
 
@@ -344,7 +392,7 @@ namespace nap
 			assert(false);
 			return nullptr;
 		}
-		return static_cast<const T*>(mValue.get());
+		return static_cast<const T*>(mValue);
 	}
 
 
@@ -356,7 +404,33 @@ namespace nap
 			assert(false);
 			return nullptr;
 		}
-		return static_cast<T*>(mValue.get());
+		return static_cast<T*>(mValue);
+	}
+
+
+	template<typename T>
+	bool nap::OSCArgument::holds() const
+	{
+		return mValue != nullptr && mValue->get_type().is_derived_from(RTTI_OF(T));
+	}
+
+
+	template<typename T, typename... Args>
+	T& nap::OSCArgument::emplace(Args&&... args)
+	{
+		static_assert(std::is_base_of<OSCBaseValue, T>::value, "T must be an OSC value");
+		reset();
+		if (sizeof(T) <= sizeof(Storage) && alignof(T) <= alignof(Storage))
+		{
+			T* value = new (&mStorage) T(std::forward<Args>(args)...);
+			mValue = value;
+			return *value;
+		}
+
+		std::unique_ptr<T> value = std::make_unique<T>(std::forward<Args>(args)...);
+		mValue = value.get();
+		mHeapValue = std::move(value);
+		return *static_cast<T*>(mValue);
 	}
 
 
@@ -41,6 +41,62 @@ namespace nap
 	}
 
 
+	nap::OSCArgument* OSCEvent::addString(const char* string)
+	{
+		OSCArgument* argument = acquireArgument();
+		if (argument->holds<OSCString>())
+			argument->get<OSCString>()->mString.assign(string);
+		else
+			argument->emplace<OSCString>(string);
+		return argument;
+	}
+
+
+	nap::OSCArgument* OSCEvent::addBlob(const void* data, int size)
+	{
+		OSCArgument* argument = acquireArgument();
+		if (argument->holds<OSCBlob>())
+			argument->get<OSCBlob>()->assign(data, size);
+		else
+			argument->emplace<OSCBlob>(data, size);
+		return argument;
+	}
+
+
+	void OSCEvent::clear()
+	{
+		// Reverse order, the first argument is reused first
+		for (auto it = mArguments.rbegin(); it != mArguments.rend(); ++it)
+			mSpareArguments.emplace_back(std::move(*it));
+		mArguments.clear();
+	}
+
+
+	void OSCEvent::reserve(int argumentCount, int addressLength)
+	{
+		mArguments.reserve(argumentCount);
+		mSpareArguments.reserve(argumentCount);
+		int spare = argumentCount - static_cast<int>(mArguments.size() + mSpareArguments.size());
+		for (int i = 0; i < spare; i++)
+			mSpareArguments.emplace_back(std::make_unique<OSCArgument>());
+		mAddress.reserve(addressLength);
+	}
+
+
+	nap::OSCArgument* OSCEvent::acquireArgument()
+	{
+		if (mSpareArguments.empty())
+		{
+			mArguments.emplace_back(std::make_unique<OSCArgument>());
+			return mArguments.back().get();
+		}
+
+		mArguments.emplace_back(std::move(mSpareArguments.back()));
+		mSpareArguments.pop_back();
+		return mArguments.back().get();
+	}
+
+
 	const OSCArgument* OSCEvent::getArgument(int index) const
 	{
 		assert(index < mArguments.size() && index >= 0);
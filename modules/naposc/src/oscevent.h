@@ -21,6 +21,9 @@ namespace nap
 	 * This event can be constructed by a client to be send over or evaluated when received.
 	 * When constructing this event, the given address must start with a '/' character!
 	 * Use the array [] overload to access the individual osc arguments.
+	 *
+	 * Events can be reused: clear() keeps the arguments and the storage of their values around for the next set
+	 * of arguments. A reused event that receives a similar message does not allocate any memory.
 	 */
 	class NAPAPI OSCEvent : public Event
 	{
@@ -82,6 +85,42 @@ namespace nap
 		 */
 		OSCArgument* addString(const std::string& string);
 
+		/**
+		 * Adds an OSCArgument that holds a string.
+		 * Reuses the string of a previously cleared argument when available.
+		 * @param string the string to give to the argument
+		 * @return the newly created and added argument.
+		 */
+		OSCArgument* addString(const char* string);
+
+		/**
+		 * Adds an OSCArgument that holds a blob of data, the data is copied.
+		 * Reuses the data block of a previously cleared argument when available.
+		 * @param data the blob data
+		 * @param size the size of the blob in bytes
+		 * @return the newly created and added argument.
+		 */
+		OSCArgument* addBlob(const void* data, int size);
+
+		/**
+		 * Changes the address of this event, reuses the memory of the current address when possible.
+		 * @param address the new address, must start with a '/' character
+		 */
+		void setAddress(const char* address)								{ mAddress.assign(address); }
+
+		/**
+		 * Removes all arguments. The arguments are kept around and reused when new arguments are added.
+		 */
+		void clear();
+
+		/**
+		 * Ensures arguments can be added and the address can be set without allocating memory,
+		 * up to the given number of arguments and address length.
+		 * @param argumentCount number of arguments to reserve
+		 * @param addressLength number of address characters to reserve
+		 */
+		void reserve(int argumentCount, int addressLength = 0);
+
 		/**
 		 * @return the number of arguments associated with this event
 		 */
@@ -123,7 +162,11 @@ namespace nap
 		const OSCArgument& operator[](std::size_t idx) const				{ return *getArgument(static_cast<int>(idx)); }
 
 	private:
+		// Returns a new argument, reuses a cleared argument when available
+		OSCArgument* acquireArgument();
+
 		OSCArgumentList mArguments;							// All the arguments associated with the event
+		OSCArgumentList mSpareArguments;					// Cleared arguments, reused when new arguments are added
 		std::string mAddress;								// The osc event address
 	};
 
@@ -135,15 +178,11 @@ namespace nap
 	OSCArgument* nap::OSCEvent::addArgument(Args&&... args)
 	{
 		assert(RTTI_OF(T).is_derived_from(RTTI_OF(nap::OSCBaseValue)));
-		
-		// Create value
-		std::unique_ptr<T> value = std::make_unique<T>(std::forward<Args>(args)...);
-		
-		// Create argument and move value
-		std::unique_ptr<OSCArgument> argument = std::make_unique<OSCArgument>(std::move(value));
-		
-		mArguments.emplace_back(std::move(argument));
-		return mArguments.back().get();
+
+		// Construct value in place
+		OSCArgument* argument = acquireArgument();
+		argument->emplace<T>(std::forward<Args>(args)...);
+		return argument;
 	}
 
 
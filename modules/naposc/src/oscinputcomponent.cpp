@@ -45,6 +45,14 @@ namespace nap
 	}
 
 
+	void OSCInputComponentInstance::setAddressFilter(const std::vector<std::string>& addressFilter)
+	{
+		mAddressFilter = addressFilter;
+		if (mService != nullptr)
+			mService->invalidateFilters();
+	}
+
+
 	void OSCInputComponentInstance::trigger(const nap::OSCEvent& oscEvent)
 	{
 		messageReceived(oscEvent);
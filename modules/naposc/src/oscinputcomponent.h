@@ -21,8 +21,9 @@ namespace nap
 
 	/**
 	 * Resource part of the OSCInputComponent, receives osc events based on the address filter.
-	 * The address filter is a list of strings that represent individual osc addresses.
-	 * The osc service forwards an event when one of the names in the address filter starts with the address of the received osc event.
+	 * The address filter is a list of strings that represent individual osc addresses or address patterns.
+	 * The osc service forwards an event when one of the patterns in the address filter matches the start of the address of the received osc event.
+	 * Patterns support the OSC 1.0 wildcards: '?', '*', '[]' and '{}', for example: '/mixer/channel/[1-8]/{fader,mute}'.
 	 * If that's the case the instance of this component receives an osc event. 
 	 * When the address filter is empty all events are forwarded.
 	 */
@@ -40,7 +41,7 @@ namespace nap
 	 * Instance part of the OSCInputComponent, receives osc events based on the address filter.
 	 * This component will forward any received osc messages to listening components.
 	 * Listen to the messageReceived signal to receive osc events that match the address pattern.
-	 * The osc service forwards an event when one of the names in the address filter starts with the address of the received osc event.
+	 * The osc service forwards an event when one of the patterns in the address filter matches the start of the address of the received osc event.
 	 * When the address filter is empty all events are forwarded.
 	 */
 	class NAPAPI OSCInputComponentInstance : public ComponentInstance
@@ -61,7 +62,18 @@ namespace nap
 		 */
 		virtual bool init(utility::ErrorState& errorState) override;
 
-		std::vector<std::string>		mAddressFilter;			///< List of available osc addresses, when empty all osc events are forwarded
+		/**
+		 * Changes the address filter, the filter of the service is updated before the next event is forwarded.
+		 * @param addressFilter list of osc address patterns, when empty all osc events are forwarded
+		 */
+		void setAddressFilter(const std::vector<std::string>& addressFilter);
+
+		/**
+		 * @return list of osc address patterns, when empty all osc events are forwarded
+		 */
+		const std::vector<std::string>& getAddressFilter() const		{ return mAddressFilter; }
+
+		std::vector<std::string>		mAddressFilter;			///< List of available osc address patterns, when empty all osc events are forwarded. Use setAddressFilter() to change it at runtime
 		Signal<const OSCEvent&>			messageReceived;		///< Triggered when the component receives an osc message
         
 		/**
@@ -20,8 +20,11 @@ namespace nap
 
 	void OSCPacketListener::ProcessMessage(const osc::ReceivedMessage& m, const IpEndpointName& remoteEndpoint)
 	{
-		// Make our event
-		OSCEventPtr event = std::make_unique<OSCEvent>(m.AddressPattern());
+		// Take an event from the pool, drop the message when all events are in use
+		OSCEvent* event = mReceiver.acquireEvent();
+		if (event == nullptr)
+			return;
+		event->setAddress(m.AddressPattern());
 
 		// Process argument stream
 		osc::ReceivedMessage::const_iterator arg = m.ArgumentsBegin();
@@ -96,7 +99,7 @@ namespace nap
 				(arg++)->AsBlobUnchecked(blob_data, size);
 
 				// Add blob
-				event->addArgument<OSCBlob>(blob_data, size);
+				event->addBlob(blob_data, static_cast<int>(size));
 				continue;
 			}
 
@@ -107,8 +110,8 @@ namespace nap
 		if (mDebugOutput)
 			displayMessage(*event);
 
-		// Add event to receiver
-		mReceiver.addEvent(std::move(event));
+		// Hand event over to the main thread
+		mReceiver.pushEvent(*event);
 	}
 
 
@@ -18,10 +18,15 @@ RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::OSCReceiver)
 	RTTI_PROPERTY("Port",				&nap::OSCReceiver::mPort,			nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("EnableDebugOutput",	&nap::OSCReceiver::mDebugOutput,	nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("AllowPortReuse",		&nap::OSCReceiver::mAllowPortReuse,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("QueueSize",			&nap::OSCReceiver::mQueueSize,		nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 namespace nap
 {
+	// Number of arguments and address characters reserved for every pooled event
+	static constexpr int reservedArgumentCount = 8;
+	static constexpr int reservedAddressLength = 64;
+
 	//////////////////////////////////////////////////////////////////////////
 	// OscReceiver
 	//////////////////////////////////////////////////////////////////////////
@@ -35,6 +40,23 @@ namespace nap
 	 */
 	bool OSCReceiver::start(utility::ErrorState& errorState)
 	{
+		if (!errorState.check(mQueueSize > 0, "%s: queue size must be greater than 0", mID.c_str()))
+			return false;
+
+		// Create the event pool, all events start out free
+		mEventPool.clear();
+		mReceivedEvents = std::make_unique<utility::SPSCQueue<OSCEvent*>>(mQueueSize);
+		mFreeEvents = std::make_unique<utility::SPSCQueue<OSCEvent*>>(mQueueSize);
+		for (int i = 0; i < mQueueSize; i++)
+		{
+			mEventPool.emplace_back(std::make_unique<OSCEvent>("/"));
+			mEventPool.back()->reserve(reservedArgumentCount, reservedAddressLength);
+			mFreeEvents->tryEnqueue(mEventPool.back().get());
+		}
+		mReceivedCount = 0;
+		mDroppedCount = 0;
+		mReportedDropCount = 0;
+
 		// Register the receiver
 		mService->registerReceiver(*this);
 
@@ -80,16 +102,48 @@ namespace nap
 		mEvents.emplace(std::move(event));
 	}
 
+	OSCEvent* OSCReceiver::acquireEvent()
+	{
+		mReceivedCount.fetch_add(1, std::memory_order_relaxed);
+		OSCEvent* event = nullptr;
+		if (!mFreeEvents->tryDequeue(event))
+		{
+			mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		return event;
+	}
+
+
+	void OSCReceiver::pushEvent(OSCEvent& event)
+	{
+		// Never fails, the queue holds every event in the pool
+		if (!mReceivedEvents->tryEnqueue(&event))
+			assert(false);
+	}
+
+
+	OSCEvent* OSCReceiver::popEvent()
+	{
+		OSCEvent* event = nullptr;
+		return mReceivedEvents->tryDequeue(event) ? event : nullptr;
+	}
+
+
+	void OSCReceiver::releaseEvent(OSCEvent& event)
+	{
+		event.clear();
+		if (!mFreeEvents->tryEnqueue(&event))
+			assert(false);
+	}
+
+
 	void OSCReceiver::consumeEvents(std::queue<OSCEventPtr>& outEvents)
 	{
+		// Swap events, the (empty) queue of the caller is reused
+		assert(outEvents.empty());
 		std::lock_guard<std::mutex> lock(mEventMutex);
-
-		// Swap events
 		outEvents.swap(mEvents);
-
-		// Clear current queue
-        std::queue<OSCEventPtr> empty_queue;;
-		mEvents.swap(empty_queue);
 	}
 
 
@@ -8,8 +8,10 @@
 #include <nap/device.h>
 #include <rtti/factory.h>
 #include <utility/dllexport.h>
+#include <utility/spscqueue.h>
 #include <thread>
 #include <queue>
+#include <atomic>
 
 // Local Includes
 #include "oscpacketlistener.h"
@@ -30,10 +32,17 @@ namespace nap
 	 * All received messages are consumed by the nap::OSCService and dispatched on the main thread 
 	 * to a valid nap::OSCInputComponent. Listen to the messageReceived signal of the OSC input component 
 	 * to receive OSC events in the running application.
+	 *
+	 * Received messages are stored in a pool of 'QueueSize' preallocated events, handed over to the main thread through 
+	 * a lock-free queue and recycled by the service after they are dispatched. Receiving does not lock and, once the 
+	 * events are warmed up, does not allocate memory. Messages that arrive when all events are in use are dropped:
+	 * increase the 'QueueSize' when messages are dropped. Received events are only valid while they are dispatched,
+	 * copy the values of interest instead of holding on to the event.
 	 */
 	class NAPAPI OSCReceiver : public Device
 	{
 		friend class OSCService;
+		friend class OSCPacketListener;
 		RTTI_ENABLE(Device)
 	public:
 		// Constructor used by factory
@@ -54,6 +63,7 @@ namespace nap
 		int mPort = 7000;				///< Property: 'Port' The port that is opened and used to receive osc messages
 		bool mDebugOutput = false;		///< Property: 'EnableDebugOutput' when enabled this objects prints all received osc messages
 		bool mAllowPortReuse = false;	///< Property: 'AllowPortReuse' enables / disables multiple listeners for a single port on the same network interface
+		int mQueueSize = 4096;			///< Property: 'QueueSize' max number of received messages waiting to be dispatched, additional messages are dropped
 
 		/**
 		 * Adds an event to the queue
@@ -61,21 +71,72 @@ namespace nap
 		 */
 		void addEvent(OSCEventPtr event);
 
+		/**
+		 * @return total number of messages received since start, including dropped messages
+		 */
+		nap::uint64 getReceivedCount() const							{ return mReceivedCount.load(std::memory_order_relaxed); }
+
+		/**
+		 * @return total number of messages dropped since start because all events were in use
+		 */
+		nap::uint64 getDroppedCount() const								{ return mDroppedCount.load(std::memory_order_relaxed); }
+
 	private:
 		// Runs in the background
 		void eventThread(int port);
 
 		/**
-		* Consumes all received OSC events and moves them to outEvents
+		 * Returns a free event from the pool, called from the receive thread.
+		 * @return a cleared event, nullptr if all events are in use
+		 */
+		OSCEvent* acquireEvent();
+
+		/**
+		 * Hands over a filled event to the main thread, called from the receive thread.
+		 * @param event the event acquired using acquireEvent()
+		 */
+		void pushEvent(OSCEvent& event);
+
+		/**
+		 * Returns the next received event, called from the main thread.
+		 * The event must be given back using releaseEvent() after it is dispatched.
+		 * @return the next received event, nullptr if there are no more events
+		 */
+		OSCEvent* popEvent();
+
+		/**
+		 * Returns a dispatched event to the pool, called from the main thread.
+		 * @param event the event returned by popEvent()
+		 */
+		void releaseEvent(OSCEvent& event);
+
+		/**
+		* Consumes all events added using addEvent() and moves them to outEvents
 		* Calling this will clear the internal queue and transfers ownership of the events to the caller
-		* @param outEvents will hold the transferred osc events
+		* @param outEvents will hold the transferred osc events, must be empty
 		*/
 		void consumeEvents(std::queue<OSCEventPtr>& outEvents);
 
 		// The socket used for receiving messages
 		std::unique_ptr<OSCReceivingSocket> mSocket = nullptr;
 
-		// Queue that holds all the consumed events
+		// All pooled events
+		std::vector<OSCEventPtr> mEventPool;
+
+		// Received events, from the receive thread to the main thread
+		std::unique_ptr<utility::SPSCQueue<OSCEvent*>> mReceivedEvents;
+
+		// Free events, from the main thread back to the receive thread
+		std::unique_ptr<utility::SPSCQueue<OSCEvent*>> mFreeEvents;
+
+		// Receive statistics, written by the receive thread
+		std::atomic<nap::uint64> mReceivedCount = { 0 };
+		std::atomic<nap::uint64> mDroppedCount = { 0 };
+
+		// Number of dropped events reported by the service
+		nap::uint64 mReportedDropCount = 0;
+
+		// Queue that holds all events added using addEvent()
 		std::queue<OSCEventPtr> mEvents;
 
 		// Mutex associated with setting / getting events
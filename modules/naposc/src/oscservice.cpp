@@ -12,7 +12,6 @@
 #include <nap/resourcemanager.h>
 #include <nap/logger.h>
 #include <iostream>
-#include <utility/stringutils.h>
 
 // Local Includes
 #include "oscservice.h"
@@ -42,39 +41,59 @@ namespace nap
 
 	void OSCService::update(double deltaTime)
 	{
-		std::queue<OSCEventPtr> events;
-
 		// Forward every event to every input component of interest
 		for (auto& receiver : mReceivers)
 		{
-			receiver->consumeEvents(events);
+			// Dispatch received events and return them to the pool
+			OSCEvent* event = receiver->popEvent();
+			while (event != nullptr)
+			{
+				dispatch(*event);
+				receiver->releaseEvent(*event);
+				event = receiver->popEvent();
+			}
+
+			// Report dropped messages
+			nap::uint64 dropped = receiver->getDroppedCount();
+			if (dropped != receiver->mReportedDropCount)
+			{
+				nap::Logger::warn("%s: dropped %d OSC messages, increase the queue size",
+					receiver->mID.c_str(), static_cast<int>(dropped - receiver->mReportedDropCount));
+				receiver->mReportedDropCount = dropped;
+			}
+
+			// Keep forwarding events added by the application until the queue runs out
+			receiver->consumeEvents(mEvents);
+			while (!(mEvents.empty()))
+			{
+				dispatch(*(mEvents.front()));
+				mEvents.pop();
+			}
+		}
+	}
+
 
-			// Keep forwarding events until the queue runs out
-			while (!(events.empty()))
+	void OSCService::dispatch(const OSCEvent& event)
+	{
+		// Compile the filters of all input components, components can be added or removed by a previous event
+		if (mFiltersChanged)
+		{
+			mFilterTrie.clear();
+			for (int i = 0; i < static_cast<int>(mInputs.size()); i++)
 			{
-				OSCEvent& osc_event = *(events.front());
-				for (const auto& input_comp : mInputs)
-				{
-					// Empty (no specified address) always receives the message
-					if (input_comp->mAddressFilter.empty())
-					{
-						input_comp->trigger(osc_event);
-						continue;
-					}
-
-					// Try to match the address
-					for (const auto& address : input_comp->mAddressFilter)
-					{
-						if (nap::utility::startsWith(osc_event.getAddress(), address))
-						{
-							input_comp->trigger(osc_event);
-							break;
-						}
-					}
-				}
-				events.pop();
+				// Empty (no specified address) always receives the message
+				if (mInputs[i]->mAddressFilter.empty())
+					mFilterTrie.add("", i);
+
+				for (const auto& address : mInputs[i]->mAddressFilter)
+					mFilterTrie.add(address, i);
 			}
+			mFiltersChanged = false;
 		}
+
+		// Matches are sorted, components are triggered in order of registration
+		for (int index : mFilterTrie.match(event.getAddress()))
+			mInputs[index]->trigger(event);
 	}
 
 
@@ -104,6 +123,7 @@ namespace nap
 	void OSCService::registerInputComponent(OSCInputComponentInstance& input)
 	{
 		mInputs.emplace_back(&input);
+		invalidateFilters();
 	}
 
 
@@ -115,5 +135,6 @@ namespace nap
 		});
 		assert(found_it != mInputs.end());
 		mInputs.erase(found_it);
+		invalidateFilters();
 	}
 }
@@ -6,11 +6,13 @@
 
 // Local Includes
 #include "oscevent.h"
+#include "oscaddresstrie.h"
 
 // External Includes
 #include <nap/service.h>
 #include <entity.h>
 #include <nap/datetime.h>
+#include <queue>
 
 namespace nap
 {
@@ -21,7 +23,9 @@ namespace nap
 	 * Main interface for processing OSC messages in NAP
 	 * All osc components and receivers are registered and de-registered with this service on initialization and destruction
 	 * This service consumes all received osc messages and forwards them to all registered osc components.
-	 * Events are only forwarded to a component if an individual address in the filter starts with the address of an osc event.
+	 * Events are only forwarded to a component if an individual address pattern in the filter matches the start of the address of an osc event.
+	 * The patterns support the OSC 1.0 wildcards, see nap::OSCAddressTrie. The filters of all components are compiled
+	 * into a single trie, which is rebuilt when a component registers, unregisters or changes its filter.
 	 * Components that don't have any filter entries are forwarded all osc events
 	 * Processing is handled automatically every frame
 	 */
@@ -52,6 +56,7 @@ namespace nap
 		/**
 		* Processes all received osc events from all registered osc receivers
 		* The events are forwarded to all the the registered osc components
+		* and returned to the event pool of the receiver afterwards.
 		* This function is called automatically by the application loop
 		* @param deltaTime time in between calls in seconds
 		*/
@@ -78,10 +83,29 @@ namespace nap
 		 */
 		void removeInputComponent(OSCInputComponentInstance& input);
 
+		/**
+		 * Rebuilds the trie from the filters of all input components on the next update
+		 */
+		void invalidateFilters()								{ mFiltersChanged = true; }
+
+		/**
+		 * Forwards an event to every input component of interest
+		 */
+		void dispatch(const OSCEvent& event);
+
 		// All the osc receivers currently registered in the system
 		std::vector<OSCReceiver*> mReceivers;
 
 		// All the osc components currently available to the system
 		std::vector<OSCInputComponentInstance*> mInputs;
+
+		// Events added by the application, consumed from a receiver
+		std::queue<OSCEventPtr> mEvents;
+
+		// Routes addresses to input components, subscribers are indices in mInputs
+		OSCAddressTrie mFilterTrie;
+
+		// If the trie needs to be rebuilt
+		bool mFiltersChanged = true;
 	};
 }
\ No newline at end of file
@@ -9,8 +9,6 @@
 #include <entity.h>
 #include <nap/core.h>
 #include <mathutils.h>
-#include <rtti/jsonreader.h>
-#include <rtti/defaultlinkresolver.h>
 #include <nap/logger.h>
 
 // nap::blendparameterscomponent run time class definition 
@@ -19,6 +17,7 @@ RTTI_BEGIN_CLASS(nap::ParameterBlendComponent)
 	RTTI_PROPERTY("BlendGroup",			&nap::ParameterBlendComponent::mBlendGroup,	nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("PresetIndex",		&nap::ParameterBlendComponent::mPresetIndex,		nap::rtti::EPropertyMetaData::Required)
 	RTTI_PROPERTY("PresetBlendTime",	&nap::ParameterBlendComponent::mPresetBlendTime,	nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Notification",		&nap::ParameterBlendComponent::mNotification,		nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 // nap::blendparameterscomponentInstance run time class definition 
@@ -34,8 +33,9 @@ namespace nap
 	ParameterBlendComponentInstance::~ParameterBlendComponentInstance()
 	{
 		mBlenders.clear();
+		mBlendEngine.clear();
 		mPresets.clear();
-		mPresetGroups.clear();
+		mTargets.clear();
 		mPresetData.clear();
 	}
 
@@ -54,6 +54,7 @@ namespace nap
 		mPresetBlendTime = resource->mPresetBlendTime.get();
 		mBlendParameters = resource->mBlendGroup.get();
 		mEnableBlending = resource->mEnableBlending;
+		mNotification = resource->mNotification;
 
 		// Source presets
 		if (!sourcePresets(errorState))
@@ -63,8 +64,14 @@ namespace nap
 		if (!createBlenders(errorState))
 			return false;
 
+		// Bind preset values to blenders
+		bindPresets();
+
 		// Called when the preset index changes
 		mPresetIndex->valueChanged.connect(mIndexChangedSlot);
+
+		// Called when a preset is recompiled
+		mParameterService->presetChanged.connect(mPresetChangedSlot);
 		changePreset(mPresetIndex->mValue);
 
 		return true;
@@ -81,6 +88,10 @@ namespace nap
 		mElapsedTime += deltaTime;
 		float lerpv = math::smoothStep<float>(getBlendValue(), 0.0f, 1.0f);
 
+		// Blend default parameter types in batches
+		mChangedParameters.clear();
+		mBlendEngine.blend(lerpv, mNotification, mChangedParameters);
+
 		// Update blenders
 		for (auto& blender : mBlenders)
 		{
@@ -89,6 +100,10 @@ namespace nap
 			blender->blend(lerpv);
 		}
 
+		// Announce all changes at once
+		if (mNotification == EParameterBlendNotification::Group && !mChangedParameters.empty())
+			parametersBlended(mChangedParameters);
+
 		if (mElapsedTime >= mPresetBlendTime->mValue)
 		{
 			mElapsedTime = 0.0;
@@ -117,9 +132,10 @@ namespace nap
 
 	bool ParameterBlendComponentInstance::reload(nap::utility::ErrorState& error)
 	{
-		// First source presets from disk
+		// First source presets from disk, presets that changed are recompiled
 		if (!sourcePresets(error))
 			return false;
+		bindPresets();
 
 		// Since target parameters changed, update blenders to point to current preset
 		changePreset(mPresetIndex->mValue);
@@ -131,55 +147,29 @@ namespace nap
 	{
 		std::vector<std::string> presets = mParameterService->getPresets(*(mBlendParameters->mRootGroup));
 
-		mPresetGroups.clear();
-		mPresetGroups.reserve(presets.size());
-
 		mPresetData.clear();
 		mPresetData.reserve(presets.size());
 
 		mPresets.clear();
 		mPresets.reserve(presets.size());
 			
-		// Load all presets
-		nap::rtti::Factory& factory = getEntityInstance()->getCore()->getResourceManager()->getFactory();
+		// Compile all presets, the service caches the result
 		for (const auto& preset : presets)
 		{
-			// Get path to preset
-			std::string preset_path = mParameterService->getPresetPath(mBlendParameters->mRootGroup->mID, preset);
-
-			// Create object that will hold de-serialization results
-			std::unique_ptr<rtti::DeserializeResult> deserialize_result = std::make_unique<rtti::DeserializeResult>();
-
-			// Load the parameters from the preset
-			if (!rtti::deserializeJSONFile(preset_path, rtti::EPropertyValidationMode::DisallowMissingProperties, rtti::EPointerPropertyMode::NoRawPointers, factory, *deserialize_result, error))
-				return false;
-
-			// Resolve links
-			if (!rtti::DefaultLinkResolver::sResolveLinks(deserialize_result->mReadObjects, deserialize_result->mUnresolvedPointers, error))
-				return false;
-
-			// Find root group in read objects, the preset needs to have a matching group
-			bool preset_group_found = false;
-			for (auto& object : deserialize_result->mReadObjects)
-			{
-				if (object->get_type().is_derived_from<ParameterGroup>() && object->mID == mBlendParameters->mRootGroup->mID)
-				{
-					// Valid entry, add as valid preset
-					mPresetData.emplace_back(std::move(deserialize_result));
-					mPresetGroups.emplace_back(rtti_cast<ParameterGroup>(object.get()));
-					mPresets.emplace_back(preset);
-					preset_group_found = true;
-					break;
-				}
-			}
+			utility::ErrorState preset_error;
+			const ParameterPreset* compiled = mParameterService->getPreset(*(mBlendParameters->mRootGroup), preset, preset_error);
 
 			// All good, preset added
-			if (preset_group_found)
+			if (compiled != nullptr)
+			{
+				mPresetData.emplace_back(compiled);
+				mPresets.emplace_back(preset);
 				continue;
+			}
 
-			nap::Logger::warn("%s: No parameter group with id: %s found in preset: %s",
+			nap::Logger::warn("%s: Unable to use preset: %s, %s",
 				getComponent<ParameterBlendComponent>()->mID.c_str(),
-				mBlendParameters->mRootGroup->mID.c_str(), preset.c_str());
+				preset.c_str(), preset_error.toString().c_str());
 		}
 
 		// Update range
@@ -191,10 +181,15 @@ namespace nap
 	bool ParameterBlendComponentInstance::createBlenders(nap::utility::ErrorState& error)
 	{
 		mBlenders.clear();
-		mBlenders.reserve(mBlendParameters->mParameters.size());
+		mBlendEngine.clear();
+		mChangedParameters.reserve(mBlendParameters->mParameters.size());
 
 		for (auto& source_parameter : mBlendParameters->mParameters)
 		{
+			// Blend in batches when supported
+			if (mBlendEngine.add(*source_parameter) >= 0)
+				continue;
+
 			// Create new blender
 			std::unique_ptr<BaseParameterBlender> new_blender = getParameterBlender(*source_parameter);
 			if (new_blender == nullptr)
@@ -213,39 +208,91 @@ namespace nap
 
 	void ParameterBlendComponentInstance::changePreset(int index)
 	{
-		// Nothing to update without presets
-		if (mPresetGroups.empty())
+		// Nothing to update without presets, or while presets are being bound
+		size_t stride = mBlendEngine.getCount() + mBlenders.size();
+		if (mPresetData.empty() || mTargets.size() != mPresetData.size() * stride)
 			return;
 
-		// Get de-serialized result for preset
-		assert(index < mPresetGroups.size());
-		ParameterGroup& preset_group = *(mPresetGroups[index]);
+		// Targets of every parameter in the engine, followed by the blender targets
+		assert(index < mPresetData.size());
+		const Parameter* const* targets = mTargets.data() + index * stride;
 
-		// Now update every blender, where for every blender a matching target is found
-		for (auto& blender : mBlenders)
-		{
-			// Get source parameter
-			const nap::Parameter& source_param = blender->getParameter();
+		// Now update every parameter in the engine, without a matching target the parameter is not updated
+		for (int i = 0; i < mBlendEngine.getCount(); i++)
+			mBlendEngine.setTarget(i, targets[i]);
 
-			// Find matching target parameter in preset
-			ResourcePtr<Parameter> found_param = preset_group.findParameterRecursive(source_param.mID);
-			
-			// If no parameter with a matching id is found, notify and clear
+		// And every blender, where for every blender a matching target is found
+		targets += mBlendEngine.getCount();
+		for (int i = 0; i < mBlenders.size(); i++)
+		{
+			// If no matching target is found, clear
 			// This ensures the blender is not updated
-			if (found_param == nullptr)
+			if (targets[i] == nullptr)
 			{
-				nap::Logger::warn("%s: Unable to find parameter with id: %s in preset: %s",
-					getComponent<ParameterBlendComponent>()->mID.c_str(),
-					source_param.mID.c_str(), mPresets[index].c_str());
-				blender->clearTarget();
+				mBlenders[i]->clearTarget();
 				continue;
 			}
 
 			// Set target
-			blender->setTarget(found_param.get());
+			mBlenders[i]->setTarget(targets[i]);
 		}
 
 		mElapsedTime = 0.0;
 		mBlending = true;
 	}
+
+
+	void ParameterBlendComponentInstance::bindPresets()
+	{
+		mTargets.assign(mPresetData.size() * (mBlendEngine.getCount() + mBlenders.size()), nullptr);
+		for (int i = 0; i < mPresetData.size(); i++)
+			bindPreset(i);
+	}
+
+
+	void ParameterBlendComponentInstance::bindPreset(int index)
+	{
+		size_t stride = mBlendEngine.getCount() + mBlenders.size();
+		assert(mTargets.size() == mPresetData.size() * stride);
+		const ParameterPreset& preset = *mPresetData[index];
+		const Parameter** targets = mTargets.data() + index * stride;
+
+		// Find the value of every parameter in the preset, once
+		auto bind = [&](const Parameter& parameter, const Parameter*& outTarget)
+		{
+			outTarget = preset.findValue(parameter);
+			if (outTarget == nullptr)
+			{
+				nap::Logger::warn("%s: Unable to find parameter with id: %s in preset: %s",
+					getComponent<ParameterBlendComponent>()->mID.c_str(),
+					parameter.mID.c_str(), mPresets[index].c_str());
+			}
+		};
+
+		for (int i = 0; i < mBlendEngine.getCount(); i++)
+			bind(mBlendEngine.getParameter(i), targets[i]);
+
+		targets += mBlendEngine.getCount();
+		for (int i = 0; i < mBlenders.size(); i++)
+			bind(mBlenders[i]->getParameter(), targets[i]);
+	}
+
+
+	void ParameterBlendComponentInstance::presetChanged(const ParameterPreset& preset)
+	{
+		// Values of the preset moved, rebind and retarget when it's the current preset
+		size_t stride = mBlendEngine.getCount() + mBlenders.size();
+		if (mTargets.size() != mPresetData.size() * stride)
+			return;
+
+		for (int i = 0; i < mPresetData.size(); i++)
+		{
+			if (mPresetData[i] != &preset)
+				continue;
+
+			bindPreset(i);
+			if (i == mPresetIndex->mValue)
+				changePreset(i);
+		}
+	}
 }
@@ -7,12 +7,13 @@
 // Local Includes
 #include "parameterblendgroup.h"
 #include "parameterblender.h"
+#include "parameterblendengine.h"
+#include "parameterpreset.h"
 
 // External Includes
 #include <component.h>
 #include <parameternumeric.h>
 #include <parameterservice.h>
-#include <rtti/deserializeresult.h>
 #include <nap/signalslot.h>
 
 namespace nap
@@ -32,6 +33,10 @@ namespace nap
 	 * The system issues a warning on initialization when there is no blender available for a specific parameter.
 	 * By default float, double, vec2, vec3 and color parameters are supported.
 	 * If a preset does not contain a specific parameter a warning is issued.
+	 *
+	 * The default parameter types are blended in batches by a nap::ParameterBlendEngine.
+	 * Set 'Notification' to 'Group' to update changed parameters without raising their signals,
+	 * and receive a single ParameterBlendComponentInstance::parametersBlended signal per update instead.
 	 */
 	class NAPAPI ParameterBlendComponent : public Component
 	{
@@ -43,6 +48,7 @@ namespace nap
 		nap::ResourcePtr<ParameterInt>	mPresetIndex = nullptr;					///< Property: 'PresetIndex' index of the preset to blend to
 		nap::ResourcePtr<ParameterFloat> mPresetBlendTime = nullptr;			///< Property: 'PresetBlendTime' time it takes to blend parameters (seconds)
 		bool mEnableBlending = false;											///< Property: 'If blending is enabled or not
+		EParameterBlendNotification mNotification = EParameterBlendNotification::Parameter;	///< Property: 'Notification' how blended parameters announce changes
 	};
 
 
@@ -70,8 +76,9 @@ namespace nap
 
 		/**
 		 * Initializes the component.
-		 * All presets associated with the 'RootGroup' of the 'BlendGroup' are sourced from disk.
+		 * All presets associated with the 'RootGroup' of the 'BlendGroup' are compiled by the parameter service.
 		 * A blender is created for every parameter and stored for future use on update.
+		 * The values of every preset are bound to the blended parameters up front: changing presets doesn't read or look up anything.
 		 * @param errorState contains the error message if initialization fails.
 		 * @return if initialization succeeded.
 		 */
@@ -123,6 +130,11 @@ namespace nap
 		 */
 		bool hasPresets() const													{ return !(mPresets.empty()); }
 
+		/**
+		 * Raised once per update with all parameters that changed, when 'Notification' is set to 'Group'.
+		 */
+		Signal<const std::vector<Parameter*>&> parametersBlended;
+
 	private:
 		ParameterBlendGroup* mBlendParameters = nullptr;						///< Parameters that are blended over time
 		ParameterInt* mPresetIndex = nullptr;									///< Current preset blend index
@@ -130,23 +142,25 @@ namespace nap
 		bool mEnableBlending = false;											///< Blending toggle
 		ParameterService* mParameterService = nullptr;							///< The parameter service
 		std::vector<std::string> mPresets;										///< All available preset names
-		std::vector<std::unique_ptr<rtti::DeserializeResult>> mPresetData;		///< All available preset data 
-		std::vector<ParameterGroup*> mPresetGroups;								///< Cached preset groups
-		std::vector<std::unique_ptr<BaseParameterBlender>> mBlenders;			///< Individual parameter blenders
+		std::vector<const ParameterPreset*> mPresetData;						///< All available compiled presets, owned by the service
+		std::vector<const Parameter*> mTargets;									///< Target of every blended parameter, for every preset
+		std::vector<std::unique_ptr<BaseParameterBlender>> mBlenders;			///< Individual blenders of parameters the engine doesn't support
+		ParameterBlendEngine mBlendEngine;										///< Blends all default parameter types in batches
+		std::vector<Parameter*> mChangedParameters;								///< Parameters changed by the last blend
+		EParameterBlendNotification mNotification = EParameterBlendNotification::Parameter;	///< How changes are announced
 		double mElapsedTime = 0.0;												///< Current elapsed time in seconds
 		bool mBlending = false;													///< If the component is currently blending values
 
 		/**
-		 * Sources all the presets from disk.
+		 * Compiles all the presets, presets that fail to compile are skipped.
 		 * @param error contains the error if sourcing fails.
 		 * @return if sourcing succeeded.
 		 */
 		bool sourcePresets(nap::utility::ErrorState& error);
 
 		/**
-		 * Creates a blender for every parameter in the blend group, if a blender is available.
-		 * Parameters that do not have a blender available for their type are ignored. 
-		 * A warning is issued.
+		 * Adds every parameter in the blend group to the blend engine,
+		 * or creates a blender for it when the engine doesn't support the type.
 		 * @param error contains the error if the operation fails.
 		 * @return if the operation succeeded.
 		 */
@@ -158,9 +172,31 @@ namespace nap
 		 */
 		void changePreset(int index);
 
+		/**
+		 * Binds the values of all presets to the blended parameters.
+		 */
+		void bindPresets();
+
+		/**
+		 * Binds the values of a single preset to the blended parameters.
+		 * @param index index of the preset
+		 */
+		void bindPreset(int index);
+
+		/**
+		 * Called when the service recompiled a preset, rebinds the preset when in use.
+		 * @param preset the preset that changed
+		 */
+		void presetChanged(const ParameterPreset& preset);
+
 		/**
 		 * Slot which is called when the preset index changes
 		 */
 		nap::Slot<int> mIndexChangedSlot = { this, &ParameterBlendComponentInstance::changePreset };
+
+		/**
+		 * Slot which is called when the service recompiled a preset
+		 */
+		nap::Slot<const ParameterPreset&> mPresetChangedSlot = { this, &ParameterBlendComponentInstance::presetChanged };
 	};
 }
@@ -0,0 +1,421 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parameterblendengine.h"
+#include "parameternumeric.h"
+#include "parametervec.h"
+#include "parametercolor.h"
+
+// External Includes
+#include <mathutils.h>
+#include <limits>
+#include <type_traits>
+
+// SSE2 is available on all x64 targets
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define NAP_PARAMETER_BLEND_SSE
+	#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	#define NAP_PARAMETER_BLEND_NEON
+	#include <arm_neon.h>
+#endif
+
+RTTI_BEGIN_ENUM(nap::EParameterBlendNotification)
+	RTTI_ENUM_VALUE(nap::EParameterBlendNotification::Parameter,	"Parameter"),
+	RTTI_ENUM_VALUE(nap::EParameterBlendNotification::Group,		"Group")
+RTTI_END_ENUM
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Blend kernels
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * output = clamp(source * (1 - value) + target * value, minimum, maximum).
+	 * Lands exactly on the target when value is 1, matching math::lerp().
+	 */
+	static void blendValues(const float* source, const float* target, const float* minimum, const float* maximum, float* output, size_t count, float value)
+	{
+		size_t i = 0;
+		float inverse = 1.0f - value;
+#if defined(NAP_PARAMETER_BLEND_SSE)
+		const __m128 v = _mm_set1_ps(value);
+		const __m128 iv = _mm_set1_ps(inverse);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(source + i), iv), _mm_mul_ps(_mm_loadu_ps(target + i), v));
+			r = _mm_min_ps(_mm_max_ps(r, _mm_loadu_ps(minimum + i)), _mm_loadu_ps(maximum + i));
+			_mm_storeu_ps(output + i, r);
+		}
+#elif defined(NAP_PARAMETER_BLEND_NEON)
+		const float32x4_t v = vdupq_n_f32(value);
+		const float32x4_t iv = vdupq_n_f32(inverse);
+		for (; i + 4 <= count; i += 4)
+		{
+			float32x4_t r = vaddq_f32(vmulq_f32(vld1q_f32(source + i), iv), vmulq_f32(vld1q_f32(target + i), v));
+			r = vminq_f32(vmaxq_f32(r, vld1q_f32(minimum + i)), vld1q_f32(maximum + i));
+			vst1q_f32(output + i, r);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			float r = source[i] * inverse + target[i] * value;
+			output[i] = math::min<float>(math::max<float>(r, minimum[i]), maximum[i]);
+		}
+	}
+
+
+	/**
+	 * Double precision version of blendValues()
+	 */
+	static void blendValues(const double* source, const double* target, const double* minimum, const double* maximum, double* output, size_t count, float value)
+	{
+		size_t i = 0;
+		double dvalue = static_cast<double>(value);
+		double inverse = 1.0 - dvalue;
+#if defined(NAP_PARAMETER_BLEND_SSE)
+		const __m128d v = _mm_set1_pd(dvalue);
+		const __m128d iv = _mm_set1_pd(inverse);
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128d r = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(source + i), iv), _mm_mul_pd(_mm_loadu_pd(target + i), v));
+			r = _mm_min_pd(_mm_max_pd(r, _mm_loadu_pd(minimum + i)), _mm_loadu_pd(maximum + i));
+			_mm_storeu_pd(output + i, r);
+		}
+#endif
+		for (; i < count; i++)
+		{
+			double r = source[i] * inverse + target[i] * dvalue;
+			output[i] = math::min<double>(math::max<double>(r, minimum[i]), maximum[i]);
+		}
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// Parameter access
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * Describes how the values of a parameter type map to blend lanes.
+	 * Every specialization provides the scalar type and number of lanes, reads the value and range of a parameter
+	 * into lanes and writes lanes back, returning if the value changed.
+	 */
+	template<typename ParamType>
+	struct BlendLanes;
+
+
+	/**
+	 * Numeric parameters, always clamped
+	 */
+	template<typename T>
+	struct NumericBlendLanes
+	{
+		using Scalar = T;
+		using ParamType = ParameterNumeric<T>;
+		static constexpr int sCount = 1;
+
+		static void read(const ParamType& parameter, Scalar* outValues)	{ outValues[0] = parameter.mValue; }
+		static void range(const ParamType& parameter, Scalar* outMinimum, Scalar* outMaximum)
+		{
+			outMinimum[0] = parameter.mMinimum;
+			outMaximum[0] = parameter.mMaximum;
+		}
+		static bool write(ParamType& parameter, const Scalar* values)
+		{
+			if (parameter.mValue == values[0])
+				return false;
+			parameter.mValue = values[0];
+			return true;
+		}
+	};
+
+	template<> struct BlendLanes<ParameterFloat> : public NumericBlendLanes<float> { };
+	template<> struct BlendLanes<ParameterDouble> : public NumericBlendLanes<double> { };
+
+
+	/**
+	 * Vector parameters, clamped when the parameter is
+	 */
+	template<typename T, int Components>
+	struct VecBlendLanes
+	{
+		using Scalar = float;
+		using ParamType = ParameterVec<T>;
+		static constexpr int sCount = Components;
+
+		static void read(const ParamType& parameter, Scalar* outValues)
+		{
+			for (int i = 0; i < sCount; i++)
+				outValues[i] = parameter.mValue[i];
+		}
+		static void range(const ParamType& parameter, Scalar* outMinimum, Scalar* outMaximum)
+		{
+			for (int i = 0; i < sCount; i++)
+			{
+				outMinimum[i] = parameter.mClamp ? parameter.mMinimum : std::numeric_limits<float>::lowest();
+				outMaximum[i] = parameter.mClamp ? parameter.mMaximum : std::numeric_limits<float>::max();
+			}
+		}
+		static bool write(ParamType& parameter, const Scalar* values)
+		{
+			T value;
+			for (int i = 0; i < sCount; i++)
+				value[i] = values[i];
+			if (parameter.mValue == value)
+				return false;
+			parameter.mValue = value;
+			return true;
+		}
+	};
+
+	template<> struct BlendLanes<ParameterVec2> : public VecBlendLanes<glm::vec2, 2> { };
+	template<> struct BlendLanes<ParameterVec3> : public VecBlendLanes<glm::vec3, 3> { };
+
+
+	/**
+	 * Color parameters, blended as float. 8 bit channels are clamped to 0-255 and truncated, as the 8 bit color blenders do.
+	 */
+	template<typename ColorType, typename T, int Channels>
+	struct ColorBlendLanes
+	{
+		using Scalar = float;
+		using ParamType = ParameterSimple<ColorType>;
+		static constexpr int sCount = Channels;
+
+		static void read(const ParamType& parameter, Scalar* outValues)
+		{
+			for (int i = 0; i < sCount; i++)
+				outValues[i] = static_cast<float>(parameter.mValue[i]);
+		}
+		static void range(const ParamType& parameter, Scalar* outMinimum, Scalar* outMaximum)
+		{
+			bool is_float = std::is_floating_point<T>::value;
+			for (int i = 0; i < sCount; i++)
+			{
+				outMinimum[i] = is_float ? std::numeric_limits<float>::lowest() : static_cast<float>(std::numeric_limits<T>::min());
+				outMaximum[i] = is_float ? std::numeric_limits<float>::max() : static_cast<float>(std::numeric_limits<T>::max());
+			}
+		}
+		static bool write(ParamType& parameter, const Scalar* values)
+		{
+			bool changed = false;
+			for (int i = 0; i < sCount; i++)
+			{
+				T value = static_cast<T>(values[i]);
+				changed |= parameter.mValue[i] != value;
+				parameter.mValue[i] = value;
+			}
+			return changed;
+		}
+	};
+
+	template<> struct BlendLanes<ParameterRGBColorFloat> : public ColorBlendLanes<RGBColorFloat, float, 3> { };
+	template<> struct BlendLanes<ParameterRGBAColorFloat> : public ColorBlendLanes<RGBAColorFloat, float, 4> { };
+	template<> struct BlendLanes<ParameterRGBColor8> : public ColorBlendLanes<RGBColor8, uint8, 3> { };
+	template<> struct BlendLanes<ParameterRGBAColor8> : public ColorBlendLanes<RGBAColor8, uint8, 4> { };
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// Groups
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * All parameters of a single type
+	 */
+	class ParameterBlendEngine::Group
+	{
+	public:
+		virtual ~Group() = default;
+		virtual int add(Parameter& parameter) = 0;
+		virtual Parameter& getParameter(int index) const = 0;
+		virtual void setTarget(int index, const Parameter* target) = 0;
+		virtual void sync() = 0;
+		virtual void blend(float value, bool notify, std::vector<Parameter*>& outChanged) = 0;
+	};
+
+
+	/**
+	 * Stores the lanes of all parameters of a single type contiguously, parameter i occupies lanes [i * count, (i + 1) * count).
+	 */
+	template<typename ParamType>
+	class ParameterBlendEngine::TypedGroup : public ParameterBlendEngine::Group
+	{
+	public:
+		using Lanes = BlendLanes<ParamType>;
+		using Scalar = typename Lanes::Scalar;
+
+		int add(Parameter& parameter) override
+		{
+			assert(parameter.get_type() == RTTI_OF(ParamType));
+			mParameters.emplace_back(static_cast<ParamType*>(&parameter));
+			mTargets.emplace_back(nullptr);
+			for (auto* lanes : { &mSource, &mTarget, &mMinimum, &mMaximum, &mOutput })
+				lanes->resize(lanes->size() + Lanes::sCount, Scalar(0));
+
+			int index = static_cast<int>(mParameters.size()) - 1;
+			syncLanes(index);
+			return index;
+		}
+
+		Parameter& getParameter(int index) const override
+		{
+			return *mParameters[index];
+		}
+
+		void setTarget(int index, const Parameter* target) override
+		{
+			assert(target == nullptr || target->get_type().is_derived_from(RTTI_OF(ParamType)));
+			mTargets[index] = static_cast<const ParamType*>(target);
+			syncLanes(index);
+		}
+
+		void sync() override
+		{
+			for (int i = 0; i < mParameters.size(); i++)
+				syncLanes(i);
+		}
+
+		void blend(float value, bool notify, std::vector<Parameter*>& outChanged) override
+		{
+			// Compute all lanes at once, lanes without target resolve to the source value and are skipped below
+			blendValues(mSource.data(), mTarget.data(), mMinimum.data(), mMaximum.data(), mOutput.data(), mOutput.size(), value);
+
+			// Write back parameters that changed
+			for (int i = 0; i < mParameters.size(); i++)
+			{
+				if (mTargets[i] == nullptr)
+					continue;
+
+				ParamType& parameter = *mParameters[i];
+				if (!Lanes::write(parameter, &mOutput[i * Lanes::sCount]))
+					continue;
+
+				if (notify)
+					parameter.valueChanged(parameter.mValue);
+				outChanged.emplace_back(&parameter);
+			}
+		}
+
+	private:
+		// Captures source value, target value and range of a parameter
+		void syncLanes(int index)
+		{
+			size_t first = static_cast<size_t>(index) * Lanes::sCount;
+			const ParamType& parameter = *mParameters[index];
+			Lanes::read(parameter, &mSource[first]);
+			Lanes::read(mTargets[index] != nullptr ? *mTargets[index] : parameter, &mTarget[first]);
+			Lanes::range(parameter, &mMinimum[first], &mMaximum[first]);
+		}
+
+		std::vector<ParamType*>			mParameters;	///< All parameters in the group
+		std::vector<const ParamType*>	mTargets;		///< Target of every parameter, nullptr when not blended
+		std::vector<Scalar>				mSource;		///< Source lanes
+		std::vector<Scalar>				mTarget;		///< Target lanes
+		std::vector<Scalar>				mMinimum;		///< Lower bound of every lane
+		std::vector<Scalar>				mMaximum;		///< Upper bound of every lane
+		std::vector<Scalar>				mOutput;		///< Blended lanes
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterBlendEngine
+	//////////////////////////////////////////////////////////////////////////
+
+	ParameterBlendEngine::ParameterBlendEngine()
+	{ }
+
+
+	ParameterBlendEngine::~ParameterBlendEngine()
+	{ }
+
+
+	std::unique_ptr<ParameterBlendEngine::Group> ParameterBlendEngine::createGroup(const rtti::TypeInfo& type)
+	{
+		if (type == RTTI_OF(ParameterFloat))			return std::make_unique<TypedGroup<ParameterFloat>>();
+		if (type == RTTI_OF(ParameterDouble))			return std::make_unique<TypedGroup<ParameterDouble>>();
+		if (type == RTTI_OF(ParameterVec2))				return std::make_unique<TypedGroup<ParameterVec2>>();
+		if (type == RTTI_OF(ParameterVec3))				return std::make_unique<TypedGroup<ParameterVec3>>();
+		if (type == RTTI_OF(ParameterRGBColorFloat))	return std::make_unique<TypedGroup<ParameterRGBColorFloat>>();
+		if (type == RTTI_OF(ParameterRGBAColorFloat))	return std::make_unique<TypedGroup<ParameterRGBAColorFloat>>();
+		if (type == RTTI_OF(ParameterRGBColor8))		return std::make_unique<TypedGroup<ParameterRGBColor8>>();
+		if (type == RTTI_OF(ParameterRGBAColor8))		return std::make_unique<TypedGroup<ParameterRGBAColor8>>();
+		return nullptr;
+	}
+
+
+	bool ParameterBlendEngine::supports(const rtti::TypeInfo& type)
+	{
+		return createGroup(type) != nullptr;
+	}
+
+
+	int ParameterBlendEngine::add(Parameter& parameter)
+	{
+		// Find or create group for type
+		rtti::TypeInfo type = parameter.get_type();
+		auto it = mGroupMap.find(type);
+		if (it == mGroupMap.end())
+		{
+			std::unique_ptr<Group> group = createGroup(type);
+			if (group == nullptr)
+				return -1;
+			it = mGroupMap.emplace(type, group.get()).first;
+			mGroups.emplace_back(std::move(group));
+		}
+
+		Entry entry;
+		entry.mGroup = it->second;
+		entry.mIndex = entry.mGroup->add(parameter);
+		mEntries.emplace_back(entry);
+		return static_cast<int>(mEntries.size()) - 1;
+	}
+
+
+	void ParameterBlendEngine::clear()
+	{
+		mEntries.clear();
+		mGroupMap.clear();
+		mGroups.clear();
+	}
+
+
+	const Parameter& ParameterBlendEngine::getParameter(int index) const
+	{
+		assert(index < mEntries.size());
+		const Entry& entry = mEntries[index];
+		return entry.mGroup->getParameter(entry.mIndex);
+	}
+
+
+	void ParameterBlendEngine::setTarget(int index, const Parameter* target)
+	{
+		assert(index < mEntries.size());
+		const Entry& entry = mEntries[index];
+
+		// Ensure target is derived from parameter
+		if (target != nullptr && !target->get_type().is_derived_from(entry.mGroup->getParameter(entry.mIndex).get_type()))
+		{
+			assert(false);
+			return;
+		}
+		entry.mGroup->setTarget(entry.mIndex, target);
+	}
+
+
+	void ParameterBlendEngine::sync()
+	{
+		for (auto& group : mGroups)
+			group->sync();
+	}
+
+
+	void ParameterBlendEngine::blend(float value, EParameterBlendNotification notification, std::vector<Parameter*>& outChanged)
+	{
+		float clamped = math::clamp<float>(value, 0.0f, 1.0f);
+		bool notify = notification == EParameterBlendNotification::Parameter;
+		for (auto& group : mGroups)
+			group->blend(clamped, notify, outChanged);
+	}
+}
@@ -0,0 +1,118 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "parameter.h"
+
+// External Includes
+#include <rtti/typeinfo.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * How parameters that change while blending are announced
+	 */
+	enum class EParameterBlendNotification : int
+	{
+		Parameter	= 0,		///< Every parameter that changed raises its own 'valueChanged' signal
+		Group		= 1			///< Changed parameters are updated silently and announced together, once per blend
+	};
+
+
+	/**
+	 * Blends many parameters at once towards a target.
+	 * Parameters are grouped by type, the values of every group are stored in contiguous source, target and output arrays.
+	 * A blend computes all values of a group in one pass using SIMD, followed by a single pass that writes back
+	 * the values that actually changed. Clamping is part of the blend: the range of a parameter is captured when its target is set.
+	 * Supports float, double, vec2, vec3 and float and 8 bit color parameters.
+	 * Use a nap::BaseParameterBlender for all other types.
+	 */
+	class NAPAPI ParameterBlendEngine final
+	{
+	public:
+		// Constructor
+		ParameterBlendEngine();
+
+		// Destructor
+		~ParameterBlendEngine();
+
+		/**
+		 * @param type parameter type
+		 * @return if parameters of the given type can be blended by the engine
+		 */
+		static bool supports(const rtti::TypeInfo& type);
+
+		/**
+		 * Adds a parameter to blend, the parameter has no target until setTarget() is called.
+		 * @param parameter the parameter to add, must be supported.
+		 * @return index of the parameter in the engine, -1 if the type of parameter is not supported.
+		 */
+		int add(Parameter& parameter);
+
+		/**
+		 * Removes all parameters
+		 */
+		void clear();
+
+		/**
+		 * @return number of parameters in the engine
+		 */
+		int getCount() const																{ return static_cast<int>(mEntries.size()); }
+
+		/**
+		 * @param index index of the parameter
+		 * @return the parameter at the given index
+		 */
+		const Parameter& getParameter(int index) const;
+
+		/**
+		 * Sets the value to blend towards. The current value of the parameter becomes the blend source.
+		 * Parameters without target are not updated.
+		 * @param index index of the parameter
+		 * @param target parameter to blend towards, must be of the same type as the parameter. nullptr clears the target.
+		 */
+		void setTarget(int index, const Parameter* target);
+
+		/**
+		 * Ensures that subsequent calls to blend() are computed relative to the current parameter values.
+		 */
+		void sync();
+
+		/**
+		 * Blends all parameters that have a target, based on the given value (0-1).
+		 * @param value normalized blend value
+		 * @param notification if every changed parameter raises its signal, or none at all
+		 * @param outChanged receives the parameters that changed
+		 */
+		void blend(float value, EParameterBlendNotification notification, std::vector<Parameter*>& outChanged);
+
+	private:
+		class Group;
+		template<typename ParamType>
+		class TypedGroup;
+
+		/**
+		 * @return new group for parameters of the given type, nullptr if the type is not supported
+		 */
+		static std::unique_ptr<Group> createGroup(const rtti::TypeInfo& type);
+
+		/**
+		 * Position of a parameter in the engine
+		 */
+		struct Entry
+		{
+			Group*	mGroup = nullptr;		///< Group the parameter belongs to
+			int		mIndex = 0;				///< Index of the parameter in the group
+		};
+
+		std::vector<std::unique_ptr<Group>> mGroups;					///< All groups, one per type of parameter
+		std::unordered_map<rtti::TypeInfo, Group*> mGroupMap;			///< Group for every type of parameter
+		std::vector<Entry> mEntries;									///< All parameters in order of addition
+	};
+}
@@ -0,0 +1,115 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parameterpreset.h"
+
+// External Includes
+#include <rtti/jsonreader.h>
+#include <rtti/defaultlinkresolver.h>
+#include <utility/fileutils.h>
+#include <nap/logger.h>
+
+namespace nap
+{
+	bool ParameterPreset::compile(ParameterGroup& group, const std::string& path, rtti::Factory& factory, utility::ErrorState& errorState)
+	{
+		// Capture modification time before reading, a write while reading triggers a new compile
+		uint64 modification_time = 0;
+		utility::getFileModificationTime(path, modification_time);
+
+		// Load the parameters from the preset
+		rtti::DeserializeResult deserialize_result;
+		if (!rtti::deserializeJSONFile(path, rtti::EPropertyValidationMode::DisallowMissingProperties, rtti::EPointerPropertyMode::NoRawPointers, factory, deserialize_result, errorState))
+			return false;
+
+		// Resolve links
+		if (!rtti::DefaultLinkResolver::sResolveLinks(deserialize_result.mReadObjects, deserialize_result.mUnresolvedPointers, errorState))
+			return false;
+
+		// Find the root parameter group in the preset file and bind the values
+		const ParameterGroup* preset_group = nullptr;
+		for (auto& object : deserialize_result.mReadObjects)
+		{
+			if (object->get_type().is_derived_from<ParameterGroup>() && object->mID == group.mID)
+			{
+				preset_group = rtti_cast<ParameterGroup>(object.get());
+				break;
+			}
+		}
+
+		if (!errorState.check(preset_group != nullptr, "The preset file %s does not contain a ParameterGroup with name %s", path.c_str(), group.mID.c_str()))
+			return false;
+
+		// All good, replace current state
+		mPath = path;
+		std::vector<Binding> bindings;
+		bindRecursive(*preset_group, group, bindings);
+
+		mGroupID = group.mID;
+		mGroup = &group;
+		mModificationTime = modification_time;
+		mObjects = std::move(deserialize_result.mReadObjects);
+		mBindings = std::move(bindings);
+		mValueMap.clear();
+		for (const auto& binding : mBindings)
+			mValueMap.emplace(binding.mParameter, binding.mValue);
+		return true;
+	}
+
+
+	void ParameterPreset::clear()
+	{
+		mBindings.clear();
+		mValueMap.clear();
+		mObjects.clear();
+		mGroup = nullptr;
+	}
+
+
+	void ParameterPreset::apply() const
+	{
+		for (const auto& binding : mBindings)
+			binding.mParameter->setValue(*binding.mValue);
+	}
+
+
+	const Parameter* ParameterPreset::findValue(const Parameter& parameter) const
+	{
+		auto it = mValueMap.find(&parameter);
+		return it != mValueMap.end() ? it->second : nullptr;
+	}
+
+
+	void ParameterPreset::bindRecursive(const ParameterGroup& source, ParameterGroup& destination, std::vector<Binding>& outBindings)
+	{
+		// Note that it's not considered an error if a parameter is present in the source, but not in the destination.
+		// This is to ensure that changes in the parameter structure for a project don't invalidate entire presets; they just invalidate the changed parts.
+		for (auto& param : destination.mParameters)
+		{
+			const ResourcePtr<Parameter>& value = source.findParameter(param->mID);
+			if (value == nullptr)
+				continue;
+
+			if (!value->get_type().is_derived_from(param->get_type()))
+			{
+				nap::Logger::warn("%s: value of parameter %s is of type %s, expected %s", mPath.c_str(), param->mID.c_str(),
+					value->get_type().get_name().to_string().c_str(), param->get_type().get_name().to_string().c_str());
+				continue;
+			}
+
+			Binding binding;
+			binding.mParameter = param.get();
+			binding.mValue = value.get();
+			outBindings.emplace_back(binding);
+		}
+
+		// Recursively bind the parameters of all child groups
+		for (auto& dest_child : destination.mChildren)
+		{
+			const ResourcePtr<ParameterGroup>& source_child = source.findChild(dest_child->mID);
+			if (source_child != nullptr)
+				bindRecursive(*source_child, *dest_child, outBindings);
+		}
+	}
+}
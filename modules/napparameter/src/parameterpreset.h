@@ -0,0 +1,102 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "parameter.h"
+
+// External Includes
+#include <rtti/deserializeresult.h>
+#include <rtti/factory.h>
+#include <nap/numeric.h>
+#include <unordered_map>
+
+namespace nap
+{
+	/**
+	 * A preset compiled against a parameter group.
+	 * Compiling reads the preset from disk once and binds every value in the preset to the parameter it applies to.
+	 * Applying the preset walks the flat list of bindings: no parsing, string lookups or allocations.
+	 * Values are matched by id, recursively, the same way ParameterService::loadPreset() does.
+	 * Values that don't match the type of the parameter they apply to are ignored.
+	 */
+	class NAPAPI ParameterPreset final
+	{
+	public:
+		/**
+		 * Value of a preset bound to the parameter it applies to
+		 */
+		struct Binding
+		{
+			Parameter*			mParameter = nullptr;	///< The parameter to apply the value to
+			const Parameter*	mValue = nullptr;		///< The value in the preset, of the same type as the parameter
+		};
+
+		/**
+		 * Reads the preset at the given path and binds the values to the parameters in the group.
+		 * On failure the preset keeps its current bindings.
+		 * @param group the parameter group the preset applies to
+		 * @param path path to the preset file
+		 * @param factory factory used to create the objects in the preset
+		 * @param errorState contains the error if compilation fails
+		 * @return if the preset compiled
+		 */
+		bool compile(ParameterGroup& group, const std::string& path, rtti::Factory& factory, utility::ErrorState& errorState);
+
+		/**
+		 * Removes all bindings and values
+		 */
+		void clear();
+
+		/**
+		 * Applies all values of the preset to the parameters they are bound to.
+		 */
+		void apply() const;
+
+		/**
+		 * Returns the value the preset holds for the given parameter, without string lookups.
+		 * @param parameter the parameter to find the value for
+		 * @return the value for the given parameter, nullptr if the preset has no value for it
+		 */
+		const Parameter* findValue(const Parameter& parameter) const;
+
+		/**
+		 * @return all values bound to their parameter
+		 */
+		const std::vector<Binding>& getBindings() const								{ return mBindings; }
+
+		/**
+		 * @return path to the preset file
+		 */
+		const std::string& getPath() const											{ return mPath; }
+
+		/**
+		 * @return id of the group the preset applies to
+		 */
+		const std::string& getGroupID() const										{ return mGroupID; }
+
+		/**
+		 * @return the group the preset is bound to, nullptr when not compiled
+		 */
+		const ParameterGroup* getGroup() const										{ return mGroup; }
+
+		/**
+		 * @return modification time of the file when the preset was compiled
+		 */
+		uint64 getModificationTime() const											{ return mModificationTime; }
+
+	private:
+		// Binds all values in source to the parameters in destination
+		void bindRecursive(const ParameterGroup& source, ParameterGroup& destination, std::vector<Binding>& outBindings);
+
+		std::string mPath;														///< Path to the preset file
+		std::string mGroupID;													///< Group the preset applies to
+		const ParameterGroup* mGroup = nullptr;									///< Group the values are bound to
+		uint64 mModificationTime = 0;											///< Modification time of the file when compiled
+		rtti::OwnedObjectList mObjects;											///< Objects read from the preset, owns all values
+		std::vector<Binding> mBindings;											///< All values bound to their parameter
+		std::unordered_map<const Parameter*, const Parameter*> mValueMap;		///< Value for every bound parameter
+	};
+}
@@ -4,11 +4,11 @@
 
 #include <parameterservice.h>
 #include <parameter.h>
+#include <parameterpreset.h>
 #include <nap/core.h>
-#include <rtti/jsonreader.h>
-#include <rtti/defaultlinkresolver.h>
 #include <rtti/jsonwriter.h>
 #include <utility/fileutils.h>
+#include <nap/logger.h>
 #include <fstream>
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParameterService)
@@ -17,6 +17,7 @@ RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS(nap::ParameterServiceConfiguration)
 	RTTI_PROPERTY("PresetsDirectory",		&nap::ParameterServiceConfiguration::mPresetsDirectory,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PresetWatchInterval",	&nap::ParameterServiceConfiguration::mPresetWatchInterval,	nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 namespace nap
@@ -26,6 +27,10 @@ namespace nap
 	{ }
 
 
+	ParameterService::~ParameterService()
+	{ }
+
+
 	ParameterService::PresetFileList ParameterService::getPresets(const ParameterGroup& group) const
 	{
 		const std::string presetDir = getGroupPresetDirectory(group.mID);
@@ -85,32 +90,46 @@ namespace nap
 	}
 
 
-	bool ParameterService::loadPreset(ParameterGroup& group, const std::string& presetFile, utility::ErrorState& errorState)
+	const ParameterPreset* ParameterService::getPreset(ParameterGroup& group, const std::string& presetFile, utility::ErrorState& errorState)
 	{
+		// Return cached version when up to date and bound to the same group
 		std::string preset_path = getPresetPath(group.mID, presetFile);
+		auto it = mPresetCache.find(preset_path);
+		if (it != mPresetCache.end())
+		{
+			ParameterPreset& preset = *it->second;
+			uint64 modification_time = 0;
+			bool changed = utility::getFileModificationTime(preset_path, modification_time) && modification_time != preset.getModificationTime();
+			if (!changed && preset.getGroup() == &group)
+				return &preset;
+
+			// Changed on disk or requested for another group with the same id
+			if (!preset.compile(group, preset_path, getCore().getResourceManager()->getFactory(), errorState))
+				return nullptr;
+			presetChanged(preset);
+			return &preset;
+		}
 
-		// Load the parameters from the preset
-		rtti::DeserializeResult deserialize_result;
-		if (!rtti::deserializeJSONFile(preset_path, rtti::EPropertyValidationMode::DisallowMissingProperties, rtti::EPointerPropertyMode::NoRawPointers, getCore().getResourceManager()->getFactory(), deserialize_result, errorState))
-			return false;
+		// Compile and cache
+		auto preset = std::make_unique<ParameterPreset>();
+		if (!preset->compile(group, preset_path, getCore().getResourceManager()->getFactory(), errorState))
+			return nullptr;
 
-		// Resolve links
-		if (!rtti::DefaultLinkResolver::sResolveLinks(deserialize_result.mReadObjects, deserialize_result.mUnresolvedPointers, errorState))
-			return false;
+		const ParameterPreset* result = preset.get();
+		mPresetCache.emplace(preset_path, std::move(preset));
+		return result;
+	}
 
-		// Find the root parameter group in the preset file and apply parameters
-		for (auto& object : deserialize_result.mReadObjects)
-		{
-			if (object->get_type().is_derived_from<ParameterGroup>() && object->mID == group.mID)
-			{
-				setParametersRecursive(*rtti_cast<ParameterGroup>(object.get()), group);
-				presetLoaded();
-				return true;
-			}
-		}
 
-		errorState.fail("The preset file %s does not contain a ParameterGroup with name %s", presetFile.c_str(), group.mID.c_str());
-		return false;
+	bool ParameterService::loadPreset(ParameterGroup& group, const std::string& presetFile, utility::ErrorState& errorState)
+	{
+		const ParameterPreset* preset = getPreset(group, presetFile, errorState);
+		if (preset == nullptr)
+			return false;
+
+		preset->apply();
+		presetLoaded();
+		return true;
 	}
 
 
@@ -134,6 +153,12 @@ namespace nap
 		// Write to disk
 		std::string json = writer.GetJSON();
 		output.write(json.data(), json.size());
+		output.close();
+
+		// Update compiled version
+		auto it = mPresetCache.find(preset_path);
+		if (it != mPresetCache.end())
+			recompile(*it->second, group);
 
 		return true;
 	}
@@ -141,28 +166,60 @@ namespace nap
 
 	void ParameterService::postResourcesLoaded()
 	{
+		// Parameters are replaced when resources are reloaded, bind presets to the new parameters
+		for (auto& entry : mPresetCache)
+		{
+			ParameterPreset& preset = *entry.second;
+			rtti::ObjectPtr<ParameterGroup> group = getCore().getResourceManager()->findObject<ParameterGroup>(preset.getGroupID());
+			if (group == nullptr)
+			{
+				preset.clear();
+				presetChanged(preset);
+				continue;
+			}
+			recompile(preset, *group);
+		}
 		fileLoaded();
 	}
 
 
-	void ParameterService::setParametersRecursive(const ParameterGroup& sourceParameters, ParameterGroup& destinationParameters)
+	void ParameterService::update(double deltaTime)
 	{
-		// Apply all parameters in the source to the destination. 
-		// Note that it's not considered an error if a parameter is preset in the source, but not in the destination. 
-		// This is to ensure that changes in the parameter structure for a project don't invalidate entire presets; they just invalidate the changed parts.
-		for (auto& param : destinationParameters.mParameters)
+		// Poll modification time of compiled presets at a fixed interval
+		float interval = getConfiguration<ParameterServiceConfiguration>()->mPresetWatchInterval;
+		if (interval <= 0.0f || mPresetCache.empty())
+			return;
+
+		mWatchTime += deltaTime;
+		if (mWatchTime < interval)
+			return;
+		mWatchTime = 0.0;
+
+		for (auto& entry : mPresetCache)
 		{
-			const ResourcePtr<Parameter>& new_param = sourceParameters.findParameter(param->mID);
-			if (new_param != nullptr)
-				param->setValue(*new_param);
+			ParameterPreset& preset = *entry.second;
+			uint64 modification_time = 0;
+			if (!utility::getFileModificationTime(preset.getPath(), modification_time) || modification_time == preset.getModificationTime())
+				continue;
+
+			rtti::ObjectPtr<ParameterGroup> group = getCore().getResourceManager()->findObject<ParameterGroup>(preset.getGroupID());
+			if (group != nullptr)
+			{
+				nap::Logger::info("Detected change to preset %s, recompiling", preset.getPath().c_str());
+				recompile(preset, *group);
+			}
 		}
+	}
 
-		// Recursively apply the parameters of all child groups
-		for (auto& dest_child : destinationParameters.mChildren)
+
+	void ParameterService::recompile(ParameterPreset& preset, ParameterGroup& group)
+	{
+		utility::ErrorState error_state;
+		if (!preset.compile(group, preset.getPath(), getCore().getResourceManager()->getFactory(), error_state))
 		{
-			const ResourcePtr<ParameterGroup>& source_child = sourceParameters.findChild(dest_child->mID);
-			if (source_child != nullptr)
-				setParametersRecursive(*source_child, *dest_child);
+			nap::Logger::warn("Failed to compile preset %s: %s", preset.getPath().c_str(), error_state.toString().c_str());
+			return;
 		}
+		presetChanged(preset);
 	}
 }
@@ -8,13 +8,17 @@
 #include <nap/service.h>
 #include <nap/resourceptr.h>
 #include <nap/signalslot.h>
+#include <unordered_map>
 
 namespace nap
 {
 	class ParameterGroup;
+	class ParameterPreset;
 
 	/**
 	 * The ParameterService manages the Parameters for a project. It provides support for loading/saving presets of Parameters
+	 *
+	 * Presets are compiled once and cached: see getPreset(). Cached presets are watched for changes on disk and recompiled when modified.
 	 */
 	class NAPAPI ParameterService : public Service
 	{
@@ -24,15 +28,34 @@ namespace nap
 		using PresetFileList = std::vector<std::string>;
 		ParameterService(ServiceConfiguration* configuration);
 
+		// Destructor
+		~ParameterService() override;
+
 		/**
 		 * Get a list of all available preset files for the specified group.
 		 * @return The list of presets
 		 */
 		PresetFileList getPresets(const ParameterGroup& group) const;
 
+		/**
+		 * Returns the compiled version of a preset, compiled on first use.
+		 * The returned preset remains valid for the lifetime of the service, it is recompiled in place
+		 * when the file changes on disk, resources are reloaded or the preset is requested for another group,
+		 * after which presetChanged is raised.
+		 * Compiling a preset reads it from disk, applying a compiled preset does not.
+		 *
+		 * @param group the parameter group.
+		 * @param presetFile The preset file to compile
+		 * @param errorState Detailed error information when compilation fails
+		 *
+		 * @return The compiled preset, nullptr if the preset could not be compiled
+		 */
+		const ParameterPreset* getPreset(ParameterGroup& group, const std::string& presetFile, utility::ErrorState& errorState);
+
 		/**
 		 * Load a preset from the specified file. The parameters in the Preset will be automatically applied.
 		 * The list of available presets files can be retrieved through getPresets()
+		 * The preset is compiled on first use, subsequent loads apply the compiled preset.
 		 *
 		 * @param group the parameter group.
 		 * @param presetFile The path to the the preset file to load
@@ -80,21 +103,35 @@ namespace nap
 		 */
 		nap::Signal<> fileLoaded;
 
+		/**
+		 * Signal that is emitted when a compiled preset is recompiled, either because the file changed or resources were reloaded.
+		 * Previously obtained values from the preset are invalid and need to be queried again.
+		 */
+		nap::Signal<const ParameterPreset&> presetChanged;
+
 	protected:
 		/**
 		 * Called when a json file has been (re)loaded. Used to re-apply the presets.
+		 * Recompiles all cached presets against the reloaded parameters.
 		 */
 		virtual void postResourcesLoaded() override;
 
-	private:
+		/**
+		 * Recompiles cached presets that changed on disk.
+		 * @param deltaTime time in between frames in seconds
+		 */
+		virtual void update(double deltaTime) override;
 
-		/** 
-		 * Helper function to recursively apply parameters from a preset to the current active set of parameters
-		 *
-		 * @param sourceParameters The parameter group that contains the parameters which should be applied
-		 * @param destinationParameters The parameter group that contains the destination parameters which should be overwritten with data from the preset
+	private:
+		/**
+		 * Recompiles a cached preset, raises presetChanged on success.
+		 * @param preset the preset to recompile
+		 * @param group the group to bind the preset to
 		 */
-		void setParametersRecursive(const ParameterGroup& sourceParameters, ParameterGroup& destinationParameters);
+		void recompile(ParameterPreset& preset, ParameterGroup& group);
+
+		std::unordered_map<std::string, std::unique_ptr<ParameterPreset>> mPresetCache;	///< All compiled presets by path
+		double mWatchTime = 0.0;														///< Time since presets were last checked for changes
 	};
 
 
@@ -117,5 +154,6 @@ namespace nap
 
 	public:
 		std::string mPresetsDirectory		= "Presets";	///< Property: 'PresetsDirectory' The directory where presets should be saved to/loaded from
+		float mPresetWatchInterval			= 1.0f;			///< Property: 'PresetWatchInterval' Seconds in between checks for changes to compiled presets on disk, 0 disables watching
 	};
 }
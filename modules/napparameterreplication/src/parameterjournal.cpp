@@ -0,0 +1,87 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parameterjournal.h"
+
+// External Includes
+#include <algorithm>
+#include <assert.h>
+
+namespace nap
+{
+	void ParameterJournal::init(int capacity, int parameterCount)
+	{
+		assert(capacity > 0);
+		mEntries.resize(capacity);
+		mMarks.assign(parameterCount, 0);
+		mStamp = 0;
+		clear();
+	}
+
+
+	void ParameterJournal::clear()
+	{
+		mHead = 0;
+		mCount = 0;
+		mEvicted = 0;
+		mHasEvicted = false;
+	}
+
+
+	void ParameterJournal::record(uint32 sequence, int index)
+	{
+		assert(!mEntries.empty());
+		assert(index < mMarks.size());
+
+		// Overwrite oldest when full
+		Entry& entry = mEntries[mHead];
+		if (mCount == mEntries.size())
+		{
+			mEvicted = entry.mSequence;
+			mHasEvicted = true;
+		}
+		else
+		{
+			mCount++;
+		}
+
+		entry.mSequence = sequence;
+		entry.mIndex = index;
+		mHead = (mHead + 1) % mEntries.size();
+	}
+
+
+	bool ParameterJournal::collect(uint32 sequence, std::vector<int>& outIndices)
+	{
+		outIndices.clear();
+
+		// Changes the peer needs have been overwritten
+		if (mHasEvicted && isSequenceNewer(mEvicted, sequence))
+			return false;
+
+		// New stamp, reset all marks when it wraps
+		if (++mStamp == 0)
+		{
+			std::fill(mMarks.begin(), mMarks.end(), 0);
+			mStamp = 1;
+		}
+
+		// Walk back from the newest entry until we reach the given sequence
+		size_t capacity = mEntries.size();
+		for (size_t i = 0; i < mCount; i++)
+		{
+			const Entry& entry = mEntries[(mHead + capacity - 1 - i) % capacity];
+			if (!isSequenceNewer(entry.mSequence, sequence))
+				break;
+
+			if (mMarks[entry.mIndex] != mStamp)
+			{
+				mMarks[entry.mIndex] = mStamp;
+				outIndices.emplace_back(entry.mIndex);
+			}
+		}
+		std::sort(outIndices.begin(), outIndices.end());
+		return true;
+	}
+}
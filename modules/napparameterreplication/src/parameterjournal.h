@@ -0,0 +1,88 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <nap/numeric.h>
+#include <utility/dllexport.h>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Compares two sequence numbers, taking wrap around into account.
+	 * @param a the sequence to compare
+	 * @param b the sequence to compare against
+	 * @return if sequence a is newer than sequence b
+	 */
+	inline bool isSequenceNewer(uint32 a, uint32 b)
+	{
+		return static_cast<int32>(a - b) > 0;
+	}
+
+
+	/**
+	 * Ring buffer of parameter changes, tagged with the sequence number they were sent with.
+	 * Used by a nap::ParameterReplicator to resend only the parameters a peer missed, instead of a full snapshot.
+	 * The journal holds a fixed number of entries, recording never allocates after init().
+	 * When a peer asks for changes older than the oldest entry the journal can't answer and a full snapshot is required.
+	 */
+	class NAPAPI ParameterJournal final
+	{
+	public:
+		/**
+		 * Allocates the ring buffer and clears all entries.
+		 * @param capacity max number of changes to remember
+		 * @param parameterCount number of parameters that are journaled
+		 */
+		void init(int capacity, int parameterCount);
+
+		/**
+		 * Removes all entries.
+		 */
+		void clear();
+
+		/**
+		 * Records a change of a parameter, overwrites the oldest entry when the journal is full.
+		 * Changes must be recorded in sequence order.
+		 * @param sequence sequence number the change was sent with
+		 * @param index index of the parameter that changed
+		 */
+		void record(uint32 sequence, int index);
+
+		/**
+		 * Collects every parameter that changed after the given sequence, in ascending index order without duplicates.
+		 * @param sequence the last sequence the peer received
+		 * @param outIndices the indices of all parameters that changed after the given sequence
+		 * @return false if changes after the given sequence are no longer in the journal
+		 */
+		bool collect(uint32 sequence, std::vector<int>& outIndices);
+
+		/**
+		 * @return number of changes in the journal
+		 */
+		int getCount() const											{ return static_cast<int>(mCount); }
+
+		/**
+		 * @return max number of changes in the journal
+		 */
+		int getCapacity() const											{ return static_cast<int>(mEntries.size()); }
+
+	private:
+		struct Entry
+		{
+			uint32	mSequence = 0;
+			int		mIndex = 0;
+		};
+
+		std::vector<Entry> mEntries;			///< Ring buffer
+		size_t mHead = 0;						///< Where the next change is written
+		size_t mCount = 0;						///< Number of valid entries
+		uint32 mEvicted = 0;					///< Sequence of the last overwritten entry
+		bool mHasEvicted = false;				///< If an entry has been overwritten
+		std::vector<uint32> mMarks;				///< Per parameter collect stamp, used to skip duplicates
+		uint32 mStamp = 0;						///< Current collect stamp
+	};
+}
@@ -0,0 +1,129 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parametermulticasttransport.h"
+
+// External Includes
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <asio/ip/multicast.hpp>
+
+RTTI_BEGIN_CLASS(nap::ParameterMulticastTransport)
+	RTTI_PROPERTY("Address",	&nap::ParameterMulticastTransport::mAddress,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Port",		&nap::ParameterMulticastTransport::mPort,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Interface",	&nap::ParameterMulticastTransport::mInterface,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TTL",		&nap::ParameterMulticastTransport::mTTL,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Loopback",	&nap::ParameterMulticastTransport::mLoopback,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+namespace nap
+{
+	/**
+	 * Keeps asio out of the header
+	 */
+	struct ParameterMulticastTransport::Socket
+	{
+		Socket() : mSocket(mContext)		{ }
+
+		asio::io_context			mContext;
+		asio::ip::udp::socket		mSocket;
+		asio::ip::udp::endpoint		mGroup;
+		asio::ip::udp::endpoint		mSender;
+	};
+
+
+	ParameterMulticastTransport::ParameterMulticastTransport()
+	{ }
+
+
+	ParameterMulticastTransport::~ParameterMulticastTransport()
+	{ }
+
+
+	bool ParameterMulticastTransport::start(utility::ErrorState& errorState)
+	{
+		asio::error_code error;
+		asio::ip::address address = asio::ip::make_address(mAddress, error);
+		if (!errorState.check(!error && address.is_multicast(), "%s: invalid multicast address: %s", mID.c_str(), mAddress.c_str()))
+			return false;
+
+		asio::ip::address interface_address = address.is_v4() ?
+			asio::ip::address(asio::ip::address_v4::any()) :
+			asio::ip::address(asio::ip::address_v6::any());
+		if (!mInterface.empty())
+		{
+			interface_address = asio::ip::make_address(mInterface, error);
+			if (!errorState.check(!error && interface_address.is_v4() == address.is_v4(), "%s: invalid interface address: %s", mID.c_str(), mInterface.c_str()))
+				return false;
+		}
+
+		// Bind to the group port on all interfaces, allow other processes to do the same
+		auto socket = std::make_unique<Socket>();
+		socket->mGroup = asio::ip::udp::endpoint(address, static_cast<unsigned short>(mPort));
+		asio::ip::udp::endpoint listen(address.is_v4() ? asio::ip::udp::v4() : asio::ip::udp::v6(), static_cast<unsigned short>(mPort));
+		socket->mSocket.open(listen.protocol(), error);
+		if (!error) socket->mSocket.set_option(asio::ip::udp::socket::reuse_address(true), error);
+		if (!error) socket->mSocket.bind(listen, error);
+		if (!errorState.check(!error, "%s: unable to bind to port %d: %s", mID.c_str(), mPort, error.message().c_str()))
+			return false;
+
+		// Join the group and configure outgoing packets
+		if (address.is_v4() && !mInterface.empty())
+		{
+			socket->mSocket.set_option(asio::ip::multicast::join_group(address.to_v4(), interface_address.to_v4()), error);
+			if (!error) socket->mSocket.set_option(asio::ip::multicast::outbound_interface(interface_address.to_v4()), error);
+		}
+		else
+		{
+			socket->mSocket.set_option(asio::ip::multicast::join_group(address), error);
+		}
+		if (!error) socket->mSocket.set_option(asio::ip::multicast::hops(mTTL), error);
+		if (!error) socket->mSocket.set_option(asio::ip::multicast::enable_loopback(mLoopback), error);
+		if (!error) socket->mSocket.non_blocking(true, error);
+		if (!errorState.check(!error, "%s: unable to join multicast group %s: %s", mID.c_str(), mAddress.c_str(), error.message().c_str()))
+			return false;
+
+		mReceiveBuffer.resize(65536);
+		mSocket = std::move(socket);
+		return true;
+	}
+
+
+	void ParameterMulticastTransport::stop()
+	{
+		if (mSocket == nullptr)
+			return;
+
+		asio::error_code error;
+		mSocket->mSocket.close(error);
+		mSocket.reset();
+	}
+
+
+	bool ParameterMulticastTransport::sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mSocket != nullptr, "%s: not started", mID.c_str()))
+			return false;
+
+		asio::error_code error;
+		mSocket->mSocket.send_to(asio::buffer(data, length), mSocket->mGroup, 0, error);
+		return errorState.check(!error, "%s: unable to send packet: %s", mID.c_str(), error.message().c_str());
+	}
+
+
+	bool ParameterMulticastTransport::receivePacket(std::vector<uint8>& outPacket)
+	{
+		if (mSocket == nullptr)
+			return false;
+
+		// Would block when there's nothing to receive
+		asio::error_code error;
+		size_t length = mSocket->mSocket.receive_from(asio::buffer(mReceiveBuffer), mSocket->mSender, 0, error);
+		if (error)
+			return false;
+
+		outPacket.assign(mReceiveBuffer.begin(), mReceiveBuffer.begin() + length);
+		return true;
+	}
+}
@@ -0,0 +1,72 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "parameterreplicationtransport.h"
+
+// External Includes
+#include <nap/device.h>
+#include <memory>
+
+namespace nap
+{
+	/**
+	 * Sends and receives replication packets over UDP multicast.
+	 * Every process that uses the same address and port joins the same multicast group:
+	 * packets sent by one process are received by all others, without having to know about each other.
+	 * The socket is non-blocking and drained on the main thread by the nap::ParameterReplicator, no background thread is used.
+	 * Enable 'Loopback' to run multiple processes on the same machine.
+	 */
+	class NAPAPI ParameterMulticastTransport : public Device, public IParameterReplicationTransport
+	{
+		RTTI_ENABLE(Device)
+	public:
+		// Default constructor
+		ParameterMulticastTransport();
+
+		// Destructor
+		virtual ~ParameterMulticastTransport() override;
+
+		/**
+		 * Opens the socket and joins the multicast group.
+		 * @param errorState contains the error if the socket can't be opened
+		 * @return if the socket is open
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Leaves the multicast group and closes the socket.
+		 */
+		virtual void stop() override;
+
+		/**
+		 * Sends a packet to the multicast group.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 * @param errorState contains the error if the packet can't be sent
+		 * @return if the packet is sent
+		 */
+		virtual bool sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState) override;
+
+		/**
+		 * Reads the next packet from the socket, doesn't block.
+		 * @param outPacket holds the packet, the buffer is re-used
+		 * @return if a packet was received
+		 */
+		virtual bool receivePacket(std::vector<uint8>& outPacket) override;
+
+		std::string mAddress = "239.255.42.99";		///< Property: 'Address' multicast group address
+		int mPort = 52100;							///< Property: 'Port' port of the multicast group
+		std::string mInterface = "";				///< Property: 'Interface' address of the network interface to use, all interfaces when empty
+		int mTTL = 1;								///< Property: 'TTL' number of router hops, 1 keeps packets on the local network
+		bool mLoopback = true;						///< Property: 'Loopback' if processes on this machine receive sent packets
+
+	private:
+		struct Socket;
+		std::unique_ptr<Socket> mSocket;			///< Socket, created on start
+		std::vector<uint8> mReceiveBuffer;			///< Largest possible datagram
+	};
+}
@@ -0,0 +1,470 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parameterreplicationformat.h"
+
+// External Includes
+#include <parameternumeric.h>
+#include <parametersimple.h>
+#include <parametervec.h>
+#include <parametercolor.h>
+#include <parameterquat.h>
+#include <parameterenum.h>
+#include <nap/logger.h>
+#include <cstring>
+#include <limits>
+
+namespace nap
+{
+	constexpr uint32 ParameterPacketHeader::magic;
+	constexpr uint8 ParameterPacketHeader::version;
+	constexpr size_t ParameterPacketHeader::size;
+	constexpr size_t ParameterReplicationLayout::maxValueSize;
+
+	//////////////////////////////////////////////////////////////////////////
+	// Codecs
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * Parameters that wrap a trivially copyable value: numbers, vectors and quaternions
+	 */
+	template<typename ParamType>
+	struct ValueCodec
+	{
+		using ValueType = decltype(ParamType::mValue);
+		static constexpr size_t size = sizeof(ValueType);
+
+		static void encode(const Parameter& parameter, uint8* output)
+		{
+			std::memcpy(output, &static_cast<const ParamType&>(parameter).mValue, size);
+		}
+
+		static void decode(Parameter& parameter, const uint8* input)
+		{
+			ValueType value;
+			std::memcpy(&value, input, size);
+			static_cast<ParamType&>(parameter).setValue(value);
+		}
+	};
+
+
+	/**
+	 * Booleans are written as a single byte, reading arbitrary bytes into a bool is undefined
+	 */
+	struct BoolCodec
+	{
+		static constexpr size_t size = 1;
+
+		static void encode(const Parameter& parameter, uint8* output)
+		{
+			output[0] = static_cast<const ParameterBool&>(parameter).mValue ? 1 : 0;
+		}
+
+		static void decode(Parameter& parameter, const uint8* input)
+		{
+			static_cast<ParameterBool&>(parameter).setValue(input[0] != 0);
+		}
+	};
+
+
+	/**
+	 * Colors are polymorphic, only the channel values are written
+	 */
+	template<typename ParamType, typename ElementType, int Channels>
+	struct ColorCodec
+	{
+		static constexpr size_t size = sizeof(ElementType) * Channels;
+
+		static void encode(const Parameter& parameter, uint8* output)
+		{
+			std::memcpy(output, static_cast<const ParamType&>(parameter).mValue.getData(), size);
+		}
+
+		static void decode(Parameter& parameter, const uint8* input)
+		{
+			auto& color_param = static_cast<ParamType&>(parameter);
+			auto value = color_param.mValue;
+			std::memcpy(value.getData(), input, size);
+			color_param.setValue(value);
+		}
+	};
+
+
+	/**
+	 * Enums are written as their integer value
+	 */
+	struct EnumCodec
+	{
+		static constexpr size_t size = sizeof(int32);
+
+		static void encode(const Parameter& parameter, uint8* output)
+		{
+			int32 value = static_cast<int32>(static_cast<const ParameterEnumBase&>(parameter).getValue());
+			std::memcpy(output, &value, size);
+		}
+
+		static void decode(Parameter& parameter, const uint8* input)
+		{
+			int32 value;
+			std::memcpy(&value, input, size);
+			static_cast<ParameterEnumBase&>(parameter).setValue(static_cast<int>(value));
+		}
+	};
+
+
+	/**
+	 * Variable length unsigned integer, 7 bits per byte, high bit set when more bytes follow
+	 */
+	static size_t getVarintSize(uint32 value)
+	{
+		size_t size = 1;
+		while (value >= 0x80)
+		{
+			value >>= 7;
+			size++;
+		}
+		return size;
+	}
+
+
+	static uint8* writeVarint(uint32 value, uint8* output)
+	{
+		while (value >= 0x80)
+		{
+			*output++ = static_cast<uint8>(value | 0x80);
+			value >>= 7;
+		}
+		*output++ = static_cast<uint8>(value);
+		return output;
+	}
+
+
+	static bool readVarint(const uint8*& cursor, const uint8* end, uint32& outValue)
+	{
+		outValue = 0;
+		for (int shift = 0; shift < 35 && cursor < end; shift += 7)
+		{
+			uint8 byte = *cursor++;
+			outValue |= static_cast<uint32>(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+		return false;
+	}
+
+
+	static void hash(uint32& value, const std::string& data)
+	{
+		// FNV-1a, terminated so that adjacent strings can't alias
+		for (char c : data)
+			value = (value ^ static_cast<uint8>(c)) * 16777619u;
+		value = (value ^ 0xFF) * 16777619u;
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterPacketHeader
+	//////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	static uint8* writeField(const T& value, uint8* output)
+	{
+		std::memcpy(output, &value, sizeof(T));
+		return output + sizeof(T);
+	}
+
+
+	template<typename T>
+	static const uint8* readField(const uint8* input, T& outValue)
+	{
+		std::memcpy(&outValue, input, sizeof(T));
+		return input + sizeof(T);
+	}
+
+
+	void ParameterPacketHeader::write(uint8* output) const
+	{
+		output = writeField(magic, output);
+		output = writeField(version, output);
+		output = writeField(static_cast<uint8>(mKind), output);
+		output = writeField(mCount, output);
+		output = writeField(mLayout, output);
+		output = writeField(mSession, output);
+		output = writeField(mSequence, output);
+		output = writeField(mBase, output);
+		output = writeField(mPart, output);
+		output = writeField(mPartCount, output);
+	}
+
+
+	bool ParameterPacketHeader::read(const uint8* data, size_t length)
+	{
+		if (length < size)
+			return false;
+
+		uint32 packet_magic;
+		uint8 packet_version, kind;
+		data = readField(data, packet_magic);
+		data = readField(data, packet_version);
+		if (packet_magic != magic || packet_version != version)
+			return false;
+
+		data = readField(data, kind);
+		if (kind > static_cast<uint8>(EParameterPacket::ResyncRequest))
+			return false;
+		mKind = static_cast<EParameterPacket>(kind);
+
+		data = readField(data, mCount);
+		data = readField(data, mLayout);
+		data = readField(data, mSession);
+		data = readField(data, mSequence);
+		data = readField(data, mBase);
+		data = readField(data, mPart);
+		data = readField(data, mPartCount);
+		return mPart < mPartCount;
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterReplicationLayout
+	//////////////////////////////////////////////////////////////////////////
+
+	template<typename CodecType>
+	const ParameterReplicationLayout::Codec* ParameterReplicationLayout::getCodec()
+	{
+		static_assert(CodecType::size <= maxValueSize, "Value exceeds max value size");
+		static const Codec codec = { CodecType::size, &CodecType::encode, &CodecType::decode };
+		return &codec;
+	}
+
+
+	const ParameterReplicationLayout::Codec* ParameterReplicationLayout::findCodec(const rtti::TypeInfo& type)
+	{
+		const Codec* codec = nullptr;
+		if		(type == RTTI_OF(ParameterFloat))			codec = getCodec<ValueCodec<ParameterFloat>>();
+		else if (type == RTTI_OF(ParameterInt))				codec = getCodec<ValueCodec<ParameterInt>>();
+		else if (type == RTTI_OF(ParameterChar))			codec = getCodec<ValueCodec<ParameterChar>>();
+		else if (type == RTTI_OF(ParameterByte))			codec = getCodec<ValueCodec<ParameterByte>>();
+		else if (type == RTTI_OF(ParameterDouble))			codec = getCodec<ValueCodec<ParameterDouble>>();
+		else if (type == RTTI_OF(ParameterLong))			codec = getCodec<ValueCodec<ParameterLong>>();
+		else if (type == RTTI_OF(ParameterVec2))			codec = getCodec<ValueCodec<ParameterVec2>>();
+		else if (type == RTTI_OF(ParameterVec3))			codec = getCodec<ValueCodec<ParameterVec3>>();
+		else if (type == RTTI_OF(ParameterIVec2))			codec = getCodec<ValueCodec<ParameterIVec2>>();
+		else if (type == RTTI_OF(ParameterIVec3))			codec = getCodec<ValueCodec<ParameterIVec3>>();
+		else if (type == RTTI_OF(ParameterQuat))			codec = getCodec<ValueCodec<ParameterQuat>>();
+		else if (type == RTTI_OF(ParameterBool))			codec = getCodec<BoolCodec>();
+		else if (type == RTTI_OF(ParameterRGBColorFloat))	codec = getCodec<ColorCodec<ParameterRGBColorFloat, float, 3>>();
+		else if (type == RTTI_OF(ParameterRGBAColorFloat))	codec = getCodec<ColorCodec<ParameterRGBAColorFloat, float, 4>>();
+		else if (type == RTTI_OF(ParameterRGBColor8))		codec = getCodec<ColorCodec<ParameterRGBColor8, uint8, 3>>();
+		else if (type == RTTI_OF(ParameterRGBAColor8))		codec = getCodec<ColorCodec<ParameterRGBAColor8, uint8, 4>>();
+		else if (type.is_derived_from<ParameterEnumBase>())	codec = getCodec<EnumCodec>();
+		return codec;
+	}
+
+
+	bool ParameterReplicationLayout::supports(const rtti::TypeInfo& type)
+	{
+		return findCodec(type) != nullptr;
+	}
+
+
+	bool ParameterReplicationLayout::init(const ParameterGroup& group, utility::ErrorState& errorState)
+	{
+		mEntries.clear();
+		mHash = 2166136261u;
+		hash(mHash, group.mID);
+		addRecursive(group);
+
+		if (!errorState.check(mEntries.size() <= std::numeric_limits<uint16>::max(), "%s: too many parameters to replicate", group.mID.c_str()))
+			return false;
+
+		size_t offset = 0;
+		for (auto& entry : mEntries)
+		{
+			entry.mOffset = offset;
+			offset += entry.mCodec->mSize;
+		}
+		mValues.assign(offset, 0);
+		capture();
+		return true;
+	}
+
+
+	size_t ParameterReplicationLayout::getValueSize(int index) const
+	{
+		assert(index < mEntries.size());
+		return mEntries[index].mCodec->mSize;
+	}
+
+
+	void ParameterReplicationLayout::encode(int index, uint8* output) const
+	{
+		assert(index < mEntries.size());
+		const Entry& entry = mEntries[index];
+		entry.mCodec->mEncode(*entry.mParameter, output);
+	}
+
+
+	void ParameterReplicationLayout::capture()
+	{
+		for (const auto& entry : mEntries)
+			entry.mCodec->mEncode(*entry.mParameter, mValues.data() + entry.mOffset);
+	}
+
+
+	void ParameterReplicationLayout::collectChanges(std::vector<int>& outIndices)
+	{
+		outIndices.clear();
+		uint8 value[maxValueSize];
+		for (int i = 0; i < mEntries.size(); i++)
+		{
+			const Entry& entry = mEntries[i];
+			entry.mCodec->mEncode(*entry.mParameter, value);
+			uint8* replicated = mValues.data() + entry.mOffset;
+			if (std::memcmp(value, replicated, entry.mCodec->mSize) != 0)
+			{
+				std::memcpy(replicated, value, entry.mCodec->mSize);
+				outIndices.emplace_back(i);
+			}
+		}
+	}
+
+
+	bool ParameterReplicationLayout::apply(const uint8* values, size_t length, int count, utility::ErrorState& errorState)
+	{
+		// Validate all values first, a malformed packet is never partially applied
+		const uint8* end = values + length;
+		const uint8* cursor = values;
+		int64 index = -1;
+		for (int i = 0; i < count; i++)
+		{
+			uint32 gap;
+			if (!errorState.check(readVarint(cursor, end, gap), "Packet truncated"))
+				return false;
+
+			index += static_cast<int64>(gap) + 1;
+			if (!errorState.check(index < static_cast<int64>(mEntries.size()), "Parameter index out of range: %d", static_cast<int>(index)))
+				return false;
+
+			size_t size = mEntries[index].mCodec->mSize;
+			if (!errorState.check(static_cast<size_t>(end - cursor) >= size, "Packet truncated"))
+				return false;
+			cursor += size;
+		}
+
+		// Decode, raises the value changed signal of every parameter that changed
+		cursor = values;
+		index = -1;
+		for (int i = 0; i < count; i++)
+		{
+			uint32 gap;
+			readVarint(cursor, end, gap);
+			index += static_cast<int64>(gap) + 1;
+
+			// Store as replicated, a receiver that turns into a sender doesn't echo received values
+			Entry& entry = mEntries[index];
+			entry.mCodec->mDecode(*entry.mParameter, cursor);
+			entry.mCodec->mEncode(*entry.mParameter, mValues.data() + entry.mOffset);
+			cursor += entry.mCodec->mSize;
+		}
+		return true;
+	}
+
+
+	void ParameterReplicationLayout::addRecursive(const ParameterGroup& group)
+	{
+		for (const auto& parameter : group.mParameters)
+		{
+			rtti::TypeInfo type = parameter->get_type();
+			const Codec* codec = findCodec(type);
+			if (codec == nullptr)
+			{
+				nap::Logger::warn("%s: parameter %s of type %s can't be replicated", group.mID.c_str(), parameter->mID.c_str(), type.get_name().to_string().c_str());
+				continue;
+			}
+
+			Entry entry;
+			entry.mParameter = parameter.get();
+			entry.mCodec = codec;
+			mEntries.emplace_back(entry);
+
+			hash(mHash, parameter->mID);
+			hash(mHash, type.get_name().to_string());
+		}
+
+		for (const auto& child : group.mChildren)
+		{
+			hash(mHash, child->mID);
+			addRecursive(*child);
+		}
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterPacketWriter
+	//////////////////////////////////////////////////////////////////////////
+
+	void ParameterPacketWriter::init(size_t maxPacketSize)
+	{
+		mMaxPacketSize = maxPacketSize;
+		mPackets.clear();
+		mPacketCount = 0;
+	}
+
+
+	ParameterPacketWriter::Packet& ParameterPacketWriter::beginPacket(size_t first)
+	{
+		if (mPacketCount == mPackets.size())
+		{
+			mPackets.emplace_back();
+			mPackets.back().mData.reserve(mMaxPacketSize);
+		}
+
+		Packet& packet = mPackets[mPacketCount++];
+		packet.mData.resize(ParameterPacketHeader::size);
+		packet.mRange = { first, first };
+		return packet;
+	}
+
+
+	void ParameterPacketWriter::write(const ParameterReplicationLayout& layout, const std::vector<int>& indices)
+	{
+		assert(mMaxPacketSize >= ParameterPacketHeader::size + 5 + ParameterReplicationLayout::maxValueSize);
+		mPacketCount = 0;
+		Packet* packet = &beginPacket(0);
+		int previous = -1;
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			// Start a new packet when the value doesn't fit, every packet starts at index 0
+			int index = indices[i];
+			size_t value_size = layout.getValueSize(index);
+			size_t entry_size = getVarintSize(static_cast<uint32>(index - previous - 1)) + value_size;
+			if (packet->mData.size() + entry_size > mMaxPacketSize || packet->mRange.second - packet->mRange.first == std::numeric_limits<uint16>::max())
+			{
+				packet = &beginPacket(i);
+				previous = -1;
+				entry_size = getVarintSize(static_cast<uint32>(index)) + value_size;
+			}
+
+			size_t offset = packet->mData.size();
+			packet->mData.resize(offset + entry_size);
+			uint8* cursor = writeVarint(static_cast<uint32>(index - previous - 1), packet->mData.data() + offset);
+			layout.encode(index, cursor);
+			packet->mRange.second = i + 1;
+			previous = index;
+		}
+	}
+
+
+	const std::vector<uint8>& ParameterPacketWriter::finish(size_t packet, ParameterPacketHeader header)
+	{
+		assert(packet < mPacketCount);
+		Packet& entry = mPackets[packet];
+		header.mCount = static_cast<uint16>(entry.mRange.second - entry.mRange.first);
+		header.mPart = static_cast<uint16>(packet);
+		header.mPartCount = static_cast<uint16>(mPacketCount);
+		header.write(entry.mData.data());
+		return entry.mData;
+	}
+}
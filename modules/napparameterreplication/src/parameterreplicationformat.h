@@ -0,0 +1,229 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <parameter.h>
+#include <nap/numeric.h>
+#include <utility/errorstate.h>
+#include <assert.h>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Type of replication packet
+	 */
+	enum class EParameterPacket : uint8
+	{
+		Delta				= 0,	///< Parameters that changed since the previous packet
+		Snapshot			= 1,	///< Every parameter in the group, might be split over multiple parts
+		Resync				= 2,	///< Every parameter that changed since the base sequence, might be split over multiple parts
+		SnapshotRequest		= 3,	///< Asks the sender for a snapshot
+		ResyncRequest		= 4		///< Asks the sender for all changes since the base sequence
+	};
+
+
+	/**
+	 * Fixed size header in front of every replication packet.
+	 * All fields are written in host byte order, all platforms NAP runs on are little endian.
+	 *
+	 * The header is followed by 'count' values. Every value starts with the gap to the index of the previous value
+	 * in the packet as a variable length integer, followed by the value of the parameter at that index.
+	 * The size of a value follows from the type of the parameter, which is why both ends must agree on the layout.
+	 */
+	struct NAPAPI ParameterPacketHeader
+	{
+		static constexpr uint32 magic = 0x5052504E;				///< 'NPRP'
+		static constexpr uint8 version = 1;						///< Current version of the format
+		static constexpr size_t size = 28;						///< Size of the header in bytes
+
+		EParameterPacket	mKind = EParameterPacket::Delta;	///< Packet type
+		uint16				mCount = 0;							///< Number of values in this packet
+		uint32				mLayout = 0;						///< Hash of the layout of the parameter group
+		uint32				mSession = 0;						///< Id of the sender session, changes when the sender restarts
+		uint32				mSequence = 0;						///< Sequence number of the sender after this packet
+		uint32				mBase = 0;							///< Sequence the receiver must be at to apply this packet as a delta
+		uint16				mPart = 0;							///< Index of this part, for snapshots and resyncs
+		uint16				mPartCount = 1;						///< Total number of parts, for snapshots and resyncs
+
+		/**
+		 * Writes the header, output must hold at least ParameterPacketHeader::size bytes.
+		 * @param output where to write the header to
+		 */
+		void write(uint8* output) const;
+
+		/**
+		 * Reads the header of a packet.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 * @return if the packet starts with a valid header
+		 */
+		bool read(const uint8* data, size_t length);
+	};
+
+
+	/**
+	 * Flat, ordered view of all the parameters in a group that can be replicated.
+	 * Parameters are ordered depth first: the parameters of a group before the parameters of its children.
+	 * Two processes that load the same group from json produce the same layout, which is verified using the layout hash.
+	 * Parameters of a type that can't be replicated are skipped.
+	 *
+	 * The layout keeps the last replicated value of every parameter, this is how changes are detected without
+	 * hooking into the value changed signal of every parameter type.
+	 */
+	class NAPAPI ParameterReplicationLayout final
+	{
+	public:
+		static constexpr size_t maxValueSize = 16;					///< Largest value in bytes (vec4, quat)
+
+		/**
+		 * @param type parameter type
+		 * @return if parameters of the given type can be replicated
+		 */
+		static bool supports(const rtti::TypeInfo& type);
+
+		/**
+		 * Builds the layout for the given group.
+		 * @param group the group to replicate
+		 * @param errorState contains the error when the layout can't be created
+		 * @return if the layout is created
+		 */
+		bool init(const ParameterGroup& group, utility::ErrorState& errorState);
+
+		/**
+		 * @return number of replicated parameters
+		 */
+		int getCount() const														{ return static_cast<int>(mEntries.size()); }
+
+		/**
+		 * @param index parameter index
+		 * @return the parameter at the given index
+		 */
+		Parameter& getParameter(int index) const									{ assert(index < mEntries.size()); return *mEntries[index].mParameter; }
+
+		/**
+		 * @param index parameter index
+		 * @return size of the value of the parameter at the given index in bytes
+		 */
+		size_t getValueSize(int index) const;
+
+		/**
+		 * @return hash of the ids and types of all replicated parameters, in order
+		 */
+		uint32 getHash() const														{ return mHash; }
+
+		/**
+		 * Writes the current value of a parameter.
+		 * @param index parameter index
+		 * @param output where to write the value to, must hold at least getValueSize(index) bytes
+		 */
+		void encode(int index, uint8* output) const;
+
+		/**
+		 * Stores the current value of every parameter as replicated.
+		 */
+		void capture();
+
+		/**
+		 * Collects all parameters whose value changed since the last call to capture() or collectChanges().
+		 * The new values are stored as replicated.
+		 * @param outIndices indices of all parameters that changed, in ascending order
+		 */
+		void collectChanges(std::vector<int>& outIndices);
+
+		/**
+		 * Applies all values in a packet. The packet is validated before anything is applied.
+		 * @param values the values, directly after the header
+		 * @param length number of bytes in values
+		 * @param count number of values
+		 * @param errorState contains the error if the values are malformed
+		 * @return if the values are applied
+		 */
+		bool apply(const uint8* values, size_t length, int count, utility::ErrorState& errorState);
+
+	private:
+		/**
+		 * Reads and writes the value of a specific parameter type
+		 */
+		struct Codec
+		{
+			size_t	mSize;
+			void	(*mEncode)(const Parameter&, uint8*);
+			void	(*mDecode)(Parameter&, const uint8*);
+		};
+
+		struct Entry
+		{
+			Parameter*		mParameter = nullptr;
+			const Codec*	mCodec = nullptr;
+			size_t			mOffset = 0;							///< Offset of replicated value
+		};
+
+		template<typename CodecType>
+		static const Codec* getCodec();
+		static const Codec* findCodec(const rtti::TypeInfo& type);
+		void addRecursive(const ParameterGroup& group);
+
+		std::vector<Entry> mEntries;								///< All replicated parameters
+		std::vector<uint8> mValues;									///< Last replicated value of all parameters
+		uint32 mHash = 0;											///< Layout hash
+	};
+
+
+	/**
+	 * Splits the values of a set of parameters over one or more packets of limited size.
+	 * Every packet can be decoded on its own, which allows for packet loss.
+	 * Packet buffers are re-used, writing doesn't allocate once all buffers reached their capacity.
+	 */
+	class NAPAPI ParameterPacketWriter final
+	{
+	public:
+		/**
+		 * @param maxPacketSize max size of a single packet in bytes, including the header
+		 */
+		void init(size_t maxPacketSize);
+
+		/**
+		 * Writes the values of the given parameters.
+		 * Always produces at least one packet, even when there are no values.
+		 * @param layout the layout the indices refer to
+		 * @param indices parameter indices in ascending order
+		 */
+		void write(const ParameterReplicationLayout& layout, const std::vector<int>& indices);
+
+		/**
+		 * @return number of packets written
+		 */
+		size_t getPacketCount() const											{ return mPacketCount; }
+
+		/**
+		 * @param packet packet index
+		 * @return the first and one past the last index in the list of indices written to the given packet
+		 */
+		std::pair<size_t, size_t> getRange(size_t packet) const					{ assert(packet < mPacketCount); return mPackets[packet].mRange; }
+
+		/**
+		 * Writes the header of a packet, count, part and part count are filled in.
+		 * @param packet packet index
+		 * @param header the header of the packet
+		 * @return the complete packet
+		 */
+		const std::vector<uint8>& finish(size_t packet, ParameterPacketHeader header);
+
+	private:
+		struct Packet
+		{
+			std::vector<uint8>			mData;
+			std::pair<size_t, size_t>	mRange;
+		};
+
+		Packet& beginPacket(size_t first);
+
+		std::vector<Packet> mPackets;
+		size_t mPacketCount = 0;
+		size_t mMaxPacketSize = 0;
+	};
+}
@@ -0,0 +1,132 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "parameterreplicationservice.h"
+#include "parameterreplicator.h"
+#include "parameterwebsocket.h"
+
+// External Includes
+#include <nap/core.h>
+#include <algorithm>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParameterReplicationService)
+	RTTI_CONSTRUCTOR(nap::ServiceConfiguration*)
+RTTI_END_CLASS
+
+namespace nap
+{
+	ParameterReplicationService::ParameterReplicationService(ServiceConfiguration* configuration) :
+		Service(configuration)
+	{
+	}
+
+
+	WebSocketService& ParameterReplicationService::getWebSocketService()
+	{
+		assert(mWebSocketService != nullptr);
+		return *mWebSocketService;
+	}
+
+
+	const WebSocketService& ParameterReplicationService::getWebSocketService() const
+	{
+		assert(mWebSocketService != nullptr);
+		return *mWebSocketService;
+	}
+
+
+	void ParameterReplicationService::registerObjectCreators(rtti::Factory& factory)
+	{
+		factory.addObjectCreator(std::make_unique<ParameterReplicatorObjectCreator>(*this));
+		factory.addObjectCreator(std::make_unique<ParameterWebSocketServerObjectCreator>(*this));
+		factory.addObjectCreator(std::make_unique<ParameterWebSocketClientObjectCreator>(*this));
+	}
+
+
+	void ParameterReplicationService::getDependentServices(std::vector<rtti::TypeInfo>& dependencies)
+	{
+		dependencies.emplace_back(RTTI_OF(WebSocketService));
+	}
+
+
+	void ParameterReplicationService::created()
+	{
+		mWebSocketService = getCore().getService<WebSocketService>();
+		assert(mWebSocketService != nullptr);
+	}
+
+
+	void ParameterReplicationService::update(double deltaTime)
+	{
+		// Drain every transport once, replicators can share a transport
+		for (auto it = mReplicators.begin(); it != mReplicators.end(); it++)
+		{
+			IParameterReplicationTransport* transport = (*it)->mTransportInterface;
+			bool drained = std::any_of(mReplicators.begin(), it, [transport](const auto& replicator)
+			{
+				return replicator->mTransportInterface == transport;
+			});
+			if (!drained)
+				receive(*transport);
+		}
+
+		for (auto& replicator : mReplicators)
+			replicator->update(deltaTime);
+	}
+
+
+	void ParameterReplicationService::postUpdate(double deltaTime)
+	{
+		for (auto& replicator : mReplicators)
+			replicator->flush(deltaTime);
+	}
+
+
+	void ParameterReplicationService::registerReplicator(ParameterReplicator& replicator)
+	{
+		mReplicators.emplace_back(&replicator);
+	}
+
+
+	void ParameterReplicationService::removeReplicator(ParameterReplicator& replicator)
+	{
+		auto found_it = std::find_if(mReplicators.begin(), mReplicators.end(), [&](const auto& it)
+		{
+			return it == &replicator;
+		});
+		assert(found_it != mReplicators.end());
+		mReplicators.erase(found_it);
+	}
+
+
+	void ParameterReplicationService::receive(IParameterReplicationTransport& transport)
+	{
+		while (transport.receivePacket(mPacket))
+		{
+			ParameterPacketHeader header;
+			if (!header.read(mPacket.data(), mPacket.size()))
+				continue;
+
+			bool handled = false;
+			for (auto& replicator : mReplicators)
+			{
+				if (replicator->mTransportInterface == &transport && replicator->getLayout().getHash() == header.mLayout)
+				{
+					replicator->receive(header, mPacket);
+					handled = true;
+				}
+			}
+
+			if (handled)
+				continue;
+
+			for (auto& replicator : mReplicators)
+			{
+				if (replicator->mTransportInterface == &transport)
+					replicator->receiveUnknownLayout();
+			}
+		}
+	}
+}
@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <nap/service.h>
+#include <websocketservice.h>
+
+namespace nap
+{
+	// Forward Declares
+	class ParameterReplicator;
+	class IParameterReplicationTransport;
+
+	/**
+	 * Replicates parameter groups across processes.
+	 * All started nap::ParameterReplicator objects are registered with this service.
+	 * Received packets are applied on update, before the application updates. Every transport is drained once,
+	 * packets are handed to the replicators on that transport with the layout of the packet.
+	 * Changes are sent on post update, after the application updated.
+	 * The service depends on the nap::WebSocketService, for the web-socket transports.
+	 */
+	class NAPAPI ParameterReplicationService : public Service
+	{
+		friend class ParameterReplicator;
+		RTTI_ENABLE(Service)
+	public:
+		// Constructor
+		ParameterReplicationService(ServiceConfiguration* configuration);
+
+		/**
+		 * @return the web-socket service
+		 */
+		WebSocketService& getWebSocketService();
+
+		/**
+		 * @return the web-socket service
+		 */
+		const WebSocketService& getWebSocketService() const;
+
+	protected:
+		/**
+		 * Registers all objects that need a specific way of construction.
+		 * @param factory the factory to register the object creators with.
+		 */
+		virtual void registerObjectCreators(rtti::Factory& factory) override;
+
+		/**
+		 * This service depends on the web-socket service
+		 */
+		virtual void getDependentServices(std::vector<rtti::TypeInfo>& dependencies) override;
+
+		// Creation
+		virtual void created() override;
+
+		/**
+		 * Applies all received packets.
+		 * @param deltaTime time in between calls in seconds
+		 */
+		virtual void update(double deltaTime) override;
+
+		/**
+		 * Sends all changes made this frame.
+		 * @param deltaTime time in between calls in seconds
+		 */
+		virtual void postUpdate(double deltaTime) override;
+
+	private:
+		/**
+		 * Registers a replicator with the service
+		 */
+		void registerReplicator(ParameterReplicator& replicator);
+
+		/**
+		 * Removes a replicator from the service
+		 */
+		void removeReplicator(ParameterReplicator& replicator);
+
+		/**
+		 * Receives all packets of a transport and hands them to the replicators of that transport
+		 */
+		void receive(IParameterReplicationTransport& transport);
+
+		WebSocketService* mWebSocketService = nullptr;
+		std::vector<ParameterReplicator*> mReplicators;		///< All started replicators
+		std::vector<uint8> mPacket;							///< Received packet
+	};
+}
@@ -0,0 +1,47 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "parameterreplicationtransport.h"
+
+namespace nap
+{
+	void ParameterPacketQueue::push(const void* data, size_t length)
+	{
+		const uint8* bytes = reinterpret_cast<const uint8*>(data);
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mFree.empty())
+		{
+			mPackets.emplace_back(bytes, bytes + length);
+			return;
+		}
+
+		mPackets.emplace_back(std::move(mFree.back()));
+		mFree.pop_back();
+		mPackets.back().assign(bytes, bytes + length);
+	}
+
+
+	bool ParameterPacketQueue::pop(std::vector<uint8>& outPacket)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mPackets.empty())
+			return false;
+
+		outPacket.swap(mPackets.front());
+		mFree.emplace_back(std::move(mPackets.front()));
+		mPackets.pop_front();
+		return true;
+	}
+
+
+	void ParameterPacketQueue::clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		while (!mPackets.empty())
+		{
+			mFree.emplace_back(std::move(mPackets.front()));
+			mPackets.pop_front();
+		}
+	}
+}
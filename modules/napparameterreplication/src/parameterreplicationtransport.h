@@ -0,0 +1,76 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <nap/numeric.h>
+#include <utility/dllexport.h>
+#include <utility/errorstate.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Interface of a resource that moves replication packets between processes.
+	 * Implemented by the nap::ParameterMulticastTransport, nap::ParameterWebSocketServer and nap::ParameterWebSocketClient.
+	 * Packets are sent and received on the main thread by a nap::ParameterReplicator.
+	 */
+	class NAPAPI IParameterReplicationTransport
+	{
+	public:
+		virtual ~IParameterReplicationTransport() = default;
+
+		/**
+		 * Sends a packet to all peers.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 * @param errorState contains the error if the packet can't be sent
+		 * @return if the packet is sent
+		 */
+		virtual bool sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState) = 0;
+
+		/**
+		 * Pops the oldest received packet.
+		 * @param outPacket holds the packet, the buffer is re-used
+		 * @return if a packet was received
+		 */
+		virtual bool receivePacket(std::vector<uint8>& outPacket) = 0;
+	};
+
+
+	/**
+	 * Thread safe queue of packets, used by transports that receive packets on a background thread.
+	 * Packet buffers are recycled: once warmed up, pushing and popping doesn't allocate.
+	 */
+	class NAPAPI ParameterPacketQueue final
+	{
+	public:
+		/**
+		 * Adds a packet to the queue, called from any thread.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 */
+		void push(const void* data, size_t length);
+
+		/**
+		 * Pops the oldest packet, swapping buffers with the given packet.
+		 * @param outPacket holds the packet, its previous buffer is recycled
+		 * @return if a packet was popped
+		 */
+		bool pop(std::vector<uint8>& outPacket);
+
+		/**
+		 * Removes all packets
+		 */
+		void clear();
+
+	private:
+		std::deque<std::vector<uint8>> mPackets;	///< Received packets
+		std::vector<std::vector<uint8>> mFree;		///< Recycled buffers
+		std::mutex mMutex;
+	};
+}
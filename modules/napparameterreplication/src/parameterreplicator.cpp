@@ -0,0 +1,318 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "parameterreplicator.h"
+#include "parameterreplicationservice.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <chrono>
+#include <numeric>
+
+RTTI_BEGIN_ENUM(nap::EParameterReplicationRole)
+	RTTI_ENUM_VALUE(nap::EParameterReplicationRole::Sender,		"Sender"),
+	RTTI_ENUM_VALUE(nap::EParameterReplicationRole::Receiver,	"Receiver")
+RTTI_END_ENUM
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParameterReplicator)
+	RTTI_CONSTRUCTOR(nap::ParameterReplicationService&)
+	RTTI_PROPERTY("Group",				&nap::ParameterReplicator::mGroup,				nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Transport",			&nap::ParameterReplicator::mTransport,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Role",				&nap::ParameterReplicator::mRole,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("JournalSize",		&nap::ParameterReplicator::mJournalSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("MaxPacketSize",		&nap::ParameterReplicator::mMaxPacketSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("SnapshotInterval",	&nap::ParameterReplicator::mSnapshotInterval,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("RequestInterval",	&nap::ParameterReplicator::mRequestInterval,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+namespace nap
+{
+	ParameterReplicator::ParameterReplicator(ParameterReplicationService& service) :
+		mService(&service)
+	{
+	}
+
+
+	bool ParameterReplicator::init(utility::ErrorState& errorState)
+	{
+		mTransportInterface = dynamic_cast<IParameterReplicationTransport*>(mTransport.get());
+		if (!errorState.check(mTransportInterface != nullptr, "%s: transport %s is not a replication transport", mID.c_str(), mTransport->mID.c_str()))
+			return false;
+
+		if (!errorState.check(mJournalSize > 0, "%s: journal size must be greater than 0", mID.c_str()))
+			return false;
+
+		size_t min_packet_size = ParameterPacketHeader::size + 5 + ParameterReplicationLayout::maxValueSize;
+		if (!errorState.check(mMaxPacketSize >= static_cast<int>(min_packet_size), "%s: max packet size must be at least %d bytes", mID.c_str(), static_cast<int>(min_packet_size)))
+			return false;
+
+		if (!mLayout.init(*mGroup, errorState))
+			return false;
+
+		mJournal.init(mJournalSize, mLayout.getCount());
+		mWriter.init(mMaxPacketSize);
+		mAllIndices.resize(mLayout.getCount());
+		std::iota(mAllIndices.begin(), mAllIndices.end(), 0);
+		return true;
+	}
+
+
+	bool ParameterReplicator::start(utility::ErrorState& errorState)
+	{
+		// Reset replication state
+		mJournal.clear();
+		mLayout.capture();
+		mSequence = 0;
+		mNewest = 0;
+		mHasNewest = false;
+		mPartsReceived = 0;
+		mSnapshotRequested = false;
+		mResyncRequested = false;
+		mSnapshotTime = 0.0;
+		mSendFailed = false;
+		mLayoutMismatch = false;
+
+		if (mRole == EParameterReplicationRole::Sender)
+		{
+			// Receivers recognize a restarted sender by its session
+			mSession = static_cast<uint32>(std::chrono::steady_clock::now().time_since_epoch().count()) ^ static_cast<uint32>(reinterpret_cast<uintptr_t>(this));
+			mSynchronized = true;
+		}
+		else
+		{
+			mSession = 0;
+			mSynchronized = false;
+			mRequestTime = 0.0;
+			sendRequest(EParameterPacket::SnapshotRequest, 0);
+		}
+
+		mService->registerReplicator(*this);
+		return true;
+	}
+
+
+	void ParameterReplicator::stop()
+	{
+		mService->removeReplicator(*this);
+	}
+
+
+	void ParameterReplicator::receive(const ParameterPacketHeader& header, const std::vector<uint8>& packet)
+	{
+		assert(header.mLayout == mLayout.getHash());
+		if (mRole == EParameterReplicationRole::Sender)
+		{
+			// Coalesce requests, answered once on flush. Other packets are our own, looped back by the transport.
+			if (header.mKind == EParameterPacket::SnapshotRequest)
+			{
+				mSnapshotRequested = true;
+			}
+			else if (header.mKind == EParameterPacket::ResyncRequest)
+			{
+				if (!mResyncRequested || isSequenceNewer(mResyncBase, header.mBase))
+					mResyncBase = header.mBase;
+				mResyncRequested = true;
+			}
+			return;
+		}
+
+		// Receivers ignore requests of other receivers
+		if (header.mKind != EParameterPacket::SnapshotRequest && header.mKind != EParameterPacket::ResyncRequest)
+			apply(header, packet);
+	}
+
+
+	void ParameterReplicator::receiveUnknownLayout()
+	{
+		// Packets of groups that aren't replicated in this process, warn once
+		if (!mLayoutMismatch)
+			nap::Logger::warn("%s: received packet for a different layout of group %s", mID.c_str(), mGroup->mID.c_str());
+		mLayoutMismatch = true;
+	}
+
+
+	void ParameterReplicator::update(double deltaTime)
+	{
+		if (mRole == EParameterReplicationRole::Sender)
+			return;
+
+		// Ask for a snapshot until synchronized, ask for missed changes when a packet is lost
+		mRequestTime += deltaTime;
+		if (!isSynchronized() && mRequestTime >= mRequestInterval)
+		{
+			if (!mSynchronized)
+				sendRequest(EParameterPacket::SnapshotRequest, 0);
+			else
+				sendRequest(EParameterPacket::ResyncRequest, mSequence);
+			mRequestTime = 0.0;
+		}
+	}
+
+
+	void ParameterReplicator::flush(double deltaTime)
+	{
+		if (mRole != EParameterReplicationRole::Sender)
+			return;
+
+		// Send the changes of this frame
+		mLayout.collectChanges(mIndices);
+		if (!mIndices.empty())
+			sendDelta();
+
+		// Answer resync requests from the journal, when it still covers the requested sequence
+		if (mResyncRequested && !mSnapshotRequested)
+		{
+			if (!isSequenceNewer(mResyncBase, mSequence) && mJournal.collect(mResyncBase, mIndices))
+				sendValues(EParameterPacket::Resync, mResyncBase, mIndices);
+			else
+				mSnapshotRequested = true;
+		}
+		mResyncRequested = false;
+
+		// Send snapshot when requested or periodically
+		mSnapshotTime += deltaTime;
+		if (mSnapshotRequested || (mSnapshotInterval > 0.0f && mSnapshotTime >= mSnapshotInterval))
+		{
+			sendValues(EParameterPacket::Snapshot, mSequence, mAllIndices);
+			mSnapshotRequested = false;
+			mSnapshotTime = 0.0;
+		}
+	}
+
+
+	void ParameterReplicator::apply(const ParameterPacketHeader& header, const std::vector<uint8>& packet)
+	{
+		// A new sender session invalidates all state
+		if (header.mSession != mSession)
+		{
+			mSession = header.mSession;
+			mSynchronized = false;
+			mHasNewest = false;
+			mPartsReceived = 0;
+		}
+
+		const uint8* values = packet.data() + ParameterPacketHeader::size;
+		size_t length = packet.size() - ParameterPacketHeader::size;
+		utility::ErrorState error_state;
+
+		if (header.mKind == EParameterPacket::Delta)
+		{
+			// Values of deltas are absolute: apply everything newer than what we have, also after a gap
+			if (mHasNewest && !isSequenceNewer(header.mSequence, mNewest))
+				return;
+
+			if (!mLayout.apply(values, length, header.mCount, error_state))
+			{
+				nap::Logger::warn("%s: invalid delta: %s", mID.c_str(), error_state.toString().c_str());
+				return;
+			}
+
+			// Only advance the in order sequence when nothing was missed
+			if (mSynchronized && header.mBase == mSequence && mSequence == mNewest)
+				mSequence = header.mSequence;
+			mNewest = header.mSequence;
+			mHasNewest = true;
+			return;
+		}
+
+		// Snapshot or resync: skip when a newer delta has been applied, the request is repeated
+		if (mHasNewest && isSequenceNewer(mNewest, header.mSequence))
+			return;
+
+		// A resync is relative to the base sequence, only applies when we are at or past it
+		if (header.mKind == EParameterPacket::Resync && (!mSynchronized || isSequenceNewer(header.mBase, mSequence)))
+			return;
+
+		if (!mLayout.apply(values, length, header.mCount, error_state))
+		{
+			nap::Logger::warn("%s: invalid snapshot: %s", mID.c_str(), error_state.toString().c_str());
+			return;
+		}
+
+		// Track parts, the state is complete when all parts of the same sequence are applied
+		if (mPartsReceived == 0 || mPartKind != header.mKind || mPartSequence != header.mSequence || mParts.size() != header.mPartCount)
+		{
+			mParts.assign(header.mPartCount, 0);
+			mPartKind = header.mKind;
+			mPartSequence = header.mSequence;
+			mPartsReceived = 0;
+		}
+
+		if (mParts[header.mPart] == 0)
+		{
+			mParts[header.mPart] = 1;
+			mPartsReceived++;
+		}
+
+		if (mPartsReceived == header.mPartCount)
+		{
+			mSequence = header.mSequence;
+			mNewest = header.mSequence;
+			mHasNewest = true;
+			mSynchronized = true;
+			mPartsReceived = 0;
+		}
+	}
+
+
+	void ParameterReplicator::sendDelta()
+	{
+		// Every packet gets its own sequence, so every packet can be applied on its own
+		mWriter.write(mLayout, mIndices);
+		for (size_t i = 0; i < mWriter.getPacketCount(); i++)
+		{
+			uint32 sequence = mSequence + 1;
+			std::pair<size_t, size_t> range = mWriter.getRange(i);
+			for (size_t j = range.first; j < range.second; j++)
+				mJournal.record(sequence, mIndices[j]);
+
+			send(mWriter.finish(i, createHeader(EParameterPacket::Delta, sequence, mSequence)));
+			mSequence = sequence;
+		}
+	}
+
+
+	void ParameterReplicator::sendValues(EParameterPacket kind, uint32 base, const std::vector<int>& indices)
+	{
+		mWriter.write(mLayout, indices);
+		for (size_t i = 0; i < mWriter.getPacketCount(); i++)
+			send(mWriter.finish(i, createHeader(kind, mSequence, base)));
+	}
+
+
+	void ParameterReplicator::sendRequest(EParameterPacket kind, uint32 base)
+	{
+		mIndices.clear();
+		mWriter.write(mLayout, mIndices);
+		send(mWriter.finish(0, createHeader(kind, mSequence, base)));
+	}
+
+
+	void ParameterReplicator::send(const std::vector<uint8>& packet)
+	{
+		// Log the first failure only, a client that isn't connected fails every frame
+		utility::ErrorState error_state;
+		if (!mTransportInterface->sendPacket(packet.data(), packet.size(), error_state))
+		{
+			if (!mSendFailed)
+				nap::Logger::warn("%s: %s", mID.c_str(), error_state.toString().c_str());
+			mSendFailed = true;
+			return;
+		}
+		mSendFailed = false;
+	}
+
+
+	ParameterPacketHeader ParameterReplicator::createHeader(EParameterPacket kind, uint32 sequence, uint32 base) const
+	{
+		ParameterPacketHeader header;
+		header.mKind = kind;
+		header.mLayout = mLayout.getHash();
+		header.mSession = mSession;
+		header.mSequence = sequence;
+		header.mBase = base;
+		return header;
+	}
+}
@@ -0,0 +1,150 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "parameterjournal.h"
+#include "parameterreplicationformat.h"
+#include "parameterreplicationtransport.h"
+
+// External Includes
+#include <nap/device.h>
+#include <nap/resourceptr.h>
+#include <rtti/factory.h>
+
+namespace nap
+{
+	// Forward Declares
+	class ParameterReplicationService;
+
+	/**
+	 * Role of a replicator
+	 */
+	enum class EParameterReplicationRole : int
+	{
+		Sender		= 0,	///< Sends changes to the parameters in the group, the operator
+		Receiver	= 1		///< Applies changes received from the sender, the render nodes
+	};
+
+
+	/**
+	 * Mirrors the parameters of a group across processes.
+	 *
+	 * Every frame the sender collects the parameters that changed, records them in a ring buffered journal
+	 * and sends them as one or more delta packets, each with the next sequence number.
+	 * Only changed parameters are sent: values are prefixed by the gap to the previous index in the packet.
+	 * Receivers apply deltas in order and detect lost packets using the sequence numbers. A receiver that misses
+	 * packets asks for the parameters it missed: the sender answers from the journal, or with a full snapshot
+	 * when the journal no longer covers the gap. Late joiners ask for a full snapshot on start.
+	 * The sender also sends a snapshot every 'SnapshotInterval' seconds, for transports without a return channel.
+	 *
+	 * Both processes must load the same parameter group, this is verified using a hash of the layout of the group.
+	 * Packets are moved by the 'Transport': a nap::ParameterMulticastTransport, nap::ParameterWebSocketServer or nap::ParameterWebSocketClient.
+	 * Replicators of different groups can share a transport, the service routes received packets by the layout hash.
+	 * Received packets are applied on update, changes are sent after the application updated: changes made
+	 * in the application are sent in the same frame.
+	 */
+	class NAPAPI ParameterReplicator : public Device
+	{
+		friend class ParameterReplicationService;
+		RTTI_ENABLE(Device)
+	public:
+		/**
+		 * Constructor
+		 * @param service the replication service
+		 */
+		ParameterReplicator(ParameterReplicationService& service);
+
+		/**
+		 * Creates the layout of the group and ensures the transport is valid.
+		 * @param errorState contains the error if initialization fails
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Registers the replicator with the service and resets the replication state.
+		 * A receiver requests a snapshot.
+		 * @param errorState contains the error if the replicator can't be started
+		 * @return if the replicator started
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Unregisters the replicator from the service.
+		 */
+		virtual void stop() override;
+
+		/**
+		 * @return if a receiver received a complete snapshot and didn't miss any packet since. Always true for a sender.
+		 */
+		bool isSynchronized() const										{ return mSynchronized && mSequence == mNewest; }
+
+		/**
+		 * @return the last sequence sent by a sender, or the last sequence applied in order by a receiver
+		 */
+		uint32 getSequence() const										{ return mSequence; }
+
+		/**
+		 * @return layout of the replicated group
+		 */
+		const ParameterReplicationLayout& getLayout() const				{ return mLayout; }
+
+		ResourcePtr<ParameterGroup> mGroup;										///< Property: 'Group' the parameter group to replicate
+		ResourcePtr<Resource> mTransport;										///< Property: 'Transport' resource that moves the packets, must implement nap::IParameterReplicationTransport
+		EParameterReplicationRole mRole = EParameterReplicationRole::Sender;	///< Property: 'Role' send or receive the parameters of the group
+		int mJournalSize = 4096;												///< Property: 'JournalSize' number of changes a sender remembers to answer resync requests
+		int mMaxPacketSize = 1400;												///< Property: 'MaxPacketSize' max packet size in bytes, below the network MTU for UDP
+		float mSnapshotInterval = 2.0f;											///< Property: 'SnapshotInterval' seconds between snapshots sent by the sender, 0 to disable
+		float mRequestInterval = 0.5f;											///< Property: 'RequestInterval' seconds between snapshot or resync requests of a receiver
+
+	private:
+		// Handles a packet received for the layout of this replicator, called by the service on update
+		void receive(const ParameterPacketHeader& header, const std::vector<uint8>& packet);
+
+		// Called by the service when a packet is received on the transport that no replicator handles
+		void receiveUnknownLayout();
+
+		// Sends requests when out of sync, called by the service on update after all packets are received
+		void update(double deltaTime);
+
+		// Sends changes and answers requests, called by the service on post update
+		void flush(double deltaTime);
+
+		void apply(const ParameterPacketHeader& header, const std::vector<uint8>& packet);
+		void sendDelta();
+		void sendValues(EParameterPacket kind, uint32 base, const std::vector<int>& indices);
+		void sendRequest(EParameterPacket kind, uint32 base);
+		void send(const std::vector<uint8>& packet);
+		ParameterPacketHeader createHeader(EParameterPacket kind, uint32 sequence, uint32 base) const;
+
+		ParameterReplicationService* mService = nullptr;
+		IParameterReplicationTransport* mTransportInterface = nullptr;
+		ParameterReplicationLayout mLayout;					///< All replicated parameters
+		ParameterJournal mJournal;							///< Changes sent by the sender
+		ParameterPacketWriter mWriter;						///< Writes outgoing packets
+		std::vector<int> mIndices;							///< Changed parameter indices
+		std::vector<int> mAllIndices;						///< Every parameter index, for snapshots
+		std::vector<uint8> mParts;							///< Received parts of a snapshot or resync
+		int mPartsReceived = 0;								///< Number of parts received
+		EParameterPacket mPartKind = EParameterPacket::Snapshot;	///< Type of the parts being received
+		uint32 mPartSequence = 0;							///< Sequence of the parts being received
+		uint32 mSession = 0;								///< Id of the sender session, changes when the sender restarts
+		uint32 mSequence = 0;								///< Sender: last sequence sent. Receiver: last sequence applied in order
+		uint32 mNewest = 0;									///< Receiver: newest sequence applied
+		bool mHasNewest = false;							///< Receiver: if any sequence has been applied in this session
+		bool mSynchronized = false;							///< Receiver: if a complete snapshot was applied in this session
+		bool mSnapshotRequested = false;					///< Sender: if a snapshot is requested
+		bool mResyncRequested = false;						///< Sender: if a resync is requested
+		uint32 mResyncBase = 0;								///< Sender: oldest sequence a resync is requested for
+		double mSnapshotTime = 0.0;							///< Sender: time since last snapshot
+		double mRequestTime = 0.0;							///< Receiver: time since last request
+		bool mSendFailed = false;							///< If the last packet failed to send, only the first failure is logged
+		bool mLayoutMismatch = false;						///< If a packet with a different layout was received, only logged once
+	};
+
+	// Object creator used for constructing the replicator
+	using ParameterReplicatorObjectCreator = rtti::ObjectCreator<ParameterReplicator, ParameterReplicationService>;
+}
@@ -0,0 +1,133 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "parameterwebsocket.h"
+#include "parameterreplicationservice.h"
+
+// External Includes
+#include <nap/logger.h>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParameterWebSocketServer)
+	RTTI_CONSTRUCTOR(nap::ParameterReplicationService&)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::ParameterWebSocketClient)
+	RTTI_CONSTRUCTOR(nap::ParameterReplicationService&)
+RTTI_END_CLASS
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterWebSocketServer
+	//////////////////////////////////////////////////////////////////////////
+
+	ParameterWebSocketServer::ParameterWebSocketServer(ParameterReplicationService& service) :
+		IWebSocketServer(service.getWebSocketService())
+	{
+	}
+
+
+	bool ParameterWebSocketServer::init(utility::ErrorState& errorState)
+	{
+		if (!IWebSocketServer::init(errorState))
+			return false;
+
+		mEndPoint->registerListener(*this);
+		return true;
+	}
+
+
+	void ParameterWebSocketServer::onDestroy()
+	{
+		mEndPoint->unregisterListener(*this);
+	}
+
+
+	bool ParameterWebSocketServer::sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState)
+	{
+		return mEndPoint->broadcast(data, static_cast<int>(length), EWebSocketOPCode::Binary, errorState);
+	}
+
+
+	bool ParameterWebSocketServer::receivePacket(std::vector<uint8>& outPacket)
+	{
+		return mPackets.pop(outPacket);
+	}
+
+
+	void ParameterWebSocketServer::onMessageReceived(const WebSocketConnection& connection, const WebSocketMessage& message)
+	{
+		if (message.getCode() == EWebSocketOPCode::Binary)
+			mPackets.push(message.getPayload().data(), message.getPayload().size());
+	}
+
+
+	void ParameterWebSocketServer::onConnectionOpened(const WebSocketConnection& connection)
+	{
+		// Clients request a snapshot themselves when connected
+	}
+
+
+	void ParameterWebSocketServer::onConnectionClosed(const WebSocketConnection& connection, int code, const std::string& reason)
+	{
+	}
+
+
+	void ParameterWebSocketServer::onConnectionFailed(const WebSocketConnection& connection, int code, const std::string& reason)
+	{
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// ParameterWebSocketClient
+	//////////////////////////////////////////////////////////////////////////
+
+	ParameterWebSocketClient::ParameterWebSocketClient(ParameterReplicationService& service) :
+		IWebSocketClient(service.getWebSocketService())
+	{
+	}
+
+
+	bool ParameterWebSocketClient::sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(isConnected(), "%s: client not connected to: %s", mID.c_str(), mURI.c_str()))
+			return false;
+
+		return mEndPoint->send(mConnection, data, static_cast<int>(length), EWebSocketOPCode::Binary, errorState);
+	}
+
+
+	bool ParameterWebSocketClient::receivePacket(std::vector<uint8>& outPacket)
+	{
+		return mPackets.pop(outPacket);
+	}
+
+
+	void ParameterWebSocketClient::onConnectionOpened()
+	{
+		nap::Logger::info("%s: connected to: %s", mID.c_str(), mURI.c_str());
+	}
+
+
+	void ParameterWebSocketClient::onConnectionClosed(int code, const std::string& reason)
+	{
+		// Packets of the previous connection are of no use
+		mPackets.clear();
+		nap::Logger::info("%s: connection closed: %s", mID.c_str(), reason.c_str());
+	}
+
+
+	void ParameterWebSocketClient::onConnectionFailed(int code, const std::string& reason)
+	{
+		nap::Logger::warn("%s: unable to connect to: %s, %s", mID.c_str(), mURI.c_str(), reason.c_str());
+	}
+
+
+	void ParameterWebSocketClient::onMessageReceived(const WebSocketMessage& msg)
+	{
+		if (msg.getCode() == EWebSocketOPCode::Binary)
+			mPackets.push(msg.getPayload().data(), msg.getPayload().size());
+	}
+}
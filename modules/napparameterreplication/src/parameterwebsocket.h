@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "parameterreplicationtransport.h"
+
+// External Includes
+#include <websocketserver.h>
+#include <websocketclient.h>
+#include <rtti/factory.h>
+
+namespace nap
+{
+	// Forward Declares
+	class ParameterReplicationService;
+
+	/**
+	 * Web-socket server that sends and receives replication packets as binary messages.
+	 * Packets are broadcast to all connected clients. Received packets are queued on the
+	 * endpoint thread and drained on the main thread by the nap::ParameterReplicator.
+	 * Use this transport when the network doesn't route multicast traffic, or when peers are not on the same network.
+	 */
+	class NAPAPI ParameterWebSocketServer : public IWebSocketServer, public IParameterReplicationTransport
+	{
+		RTTI_ENABLE(IWebSocketServer)
+	public:
+		/**
+		 * Constructor
+		 * @param service the replication service
+		 */
+		ParameterWebSocketServer(ParameterReplicationService& service);
+
+		/**
+		 * Registers the server with the endpoint.
+		 * @param errorState contains the error if initialization fails.
+		 * @return if initialization succeeded.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Unregisters the server from the endpoint.
+		 */
+		virtual void onDestroy() override;
+
+		/**
+		 * Broadcasts a packet to all connected clients.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 * @param errorState contains the error if the packet can't be sent
+		 * @return if the packet is sent
+		 */
+		virtual bool sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState) override;
+
+		/**
+		 * Pops the oldest packet received from a client.
+		 * @param outPacket holds the packet, the buffer is re-used
+		 * @return if a packet was received
+		 */
+		virtual bool receivePacket(std::vector<uint8>& outPacket) override;
+
+	private:
+		virtual void onMessageReceived(const WebSocketConnection& connection, const WebSocketMessage& message) override;
+		virtual void onConnectionOpened(const WebSocketConnection& connection) override;
+		virtual void onConnectionClosed(const WebSocketConnection& connection, int code, const std::string& reason) override;
+		virtual void onConnectionFailed(const WebSocketConnection& connection, int code, const std::string& reason) override;
+
+		ParameterPacketQueue mPackets;		///< Received packets
+	};
+
+
+	/**
+	 * Web-socket client that sends and receives replication packets as binary messages.
+	 * Received packets are queued on the endpoint thread and drained on the main thread by the nap::ParameterReplicator.
+	 */
+	class NAPAPI ParameterWebSocketClient : public IWebSocketClient, public IParameterReplicationTransport
+	{
+		RTTI_ENABLE(IWebSocketClient)
+	public:
+		/**
+		 * Constructor
+		 * @param service the replication service
+		 */
+		ParameterWebSocketClient(ParameterReplicationService& service);
+
+		/**
+		 * Sends a packet to the server.
+		 * @param data packet data
+		 * @param length number of bytes in the packet
+		 * @param errorState contains the error if the client isn't connected or the packet can't be sent
+		 * @return if the packet is sent
+		 */
+		virtual bool sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState) override;
+
+		/**
+		 * Pops the oldest packet received from the server.
+		 * @param outPacket holds the packet, the buffer is re-used
+		 * @return if a packet was received
+		 */
+		virtual bool receivePacket(std::vector<uint8>& outPacket) override;
+
+	protected:
+		virtual void onConnectionOpened() override;
+		virtual void onConnectionClosed(int code, const std::string& reason) override;
+		virtual void onConnectionFailed(int code, const std::string& reason) override;
+		virtual void onMessageReceived(const WebSocketMessage& msg) override;
+
+	private:
+		ParameterPacketQueue mPackets;		///< Received packets
+	};
+
+	// Object creators used for constructing the web-socket server and client
+	using ParameterWebSocketServerObjectCreator = rtti::ObjectCreator<ParameterWebSocketServer, ParameterReplicationService>;
+	using ParameterWebSocketClientObjectCreator = rtti::ObjectCreator<ParameterWebSocketClient, ParameterReplicationService>;
+}
@@ -9,9 +9,12 @@
 #include <rtti/typeinfo.h>
 #include <texture2d.h>
 #include "copyimagedata.h"
+#include "pixelconversion.h"
 
 // External includes
 #include <FreeImage.h>
+#include <algorithm>
+#include <cmath>
 
 #undef BYTE
 
@@ -155,6 +158,27 @@ namespace nap
 
 
 	bool Bitmap::initFromFile(const std::string& path, nap::utility::ErrorState& errorState)
+	{
+		return initFromFile(path, 0, errorState);
+	}
+
+
+	glm::ivec2 Bitmap::getScaledSize(int width, int height, int maxSize)
+	{
+		int largest = std::max(width, height);
+		if (maxSize <= 0 || largest <= maxSize)
+			return { width, height };
+
+		double scale = static_cast<double>(maxSize) / static_cast<double>(largest);
+		return
+		{
+			std::max(1, static_cast<int>(std::lround(width * scale))),
+			std::max(1, static_cast<int>(std::lround(height * scale)))
+		};
+	}
+
+
+	bool Bitmap::initFromFile(const std::string& path, int maxSize, nap::utility::ErrorState& errorState)
 	{
 		if (!errorState.check(utility::fileExists(path), "unable to load image: %s, file does not exist: %s", path.c_str(), mID.c_str()))
 			return false;
@@ -164,14 +188,26 @@ namespace nap
 		if (!errorState.check(fi_img_format != FIF_UNKNOWN, "Unable to determine image format of file: %s", path.c_str()))
 			return false;
 
-		// Load
-		FIBITMAP* fi_bitmap = FreeImage_Load(fi_img_format, path.c_str());
+		// Load, JPEG files can be decoded at a reduced scale: the requested size is passed in the upper 16 bits of the flags
+		int load_flags = (fi_img_format == FIF_JPEG && maxSize > 0) ? (maxSize << 16) : 0;
+		FIBITMAP* fi_bitmap = FreeImage_Load(fi_img_format, path.c_str(), load_flags);
 		if (!errorState.check(fi_bitmap != nullptr, "Unable to load bitmap: %s", path.c_str()))
 		{
 			FreeImage_Unload(fi_bitmap);
 			return false;
 		}
 
+		// Scale down to the requested size
+		glm::ivec2 scaled_size = getScaledSize(FreeImage_GetWidth(fi_bitmap), FreeImage_GetHeight(fi_bitmap), maxSize);
+		if (scaled_size.x != FreeImage_GetWidth(fi_bitmap) || scaled_size.y != FreeImage_GetHeight(fi_bitmap))
+		{
+			FIBITMAP* scaled_bitmap = FreeImage_Rescale(fi_bitmap, scaled_size.x, scaled_size.y, FILTER_BOX);
+			FreeImage_Unload(fi_bitmap);
+			if (!errorState.check(scaled_bitmap != nullptr, "Unable to scale bitmap: %s", path.c_str()))
+				return false;
+			fi_bitmap = scaled_bitmap;
+		}
+
 		// Get associated bitmap type for free image type
 		FREE_IMAGE_TYPE fi_bitmap_type = FreeImage_GetImageType(fi_bitmap);
 
@@ -199,11 +235,18 @@ namespace nap
 		
 		// Get color type
 		FREE_IMAGE_COLOR_TYPE fi_bitmap_color_type = FreeImage_GetColorType(fi_bitmap);
+		bool add_alpha = false;
 		if (fi_bitmap_color_type == FIC_RGB)
 		{
-			FIBITMAP* converted_bitmap = FreeImage_ConvertTo32Bits(fi_bitmap);
-			FreeImage_Unload(fi_bitmap);
-			fi_bitmap = converted_bitmap;
+			// 24 bit, 3 channel 16 bit and 3 channel float bitmaps get an alpha channel while copying the pixels.
+			// Other bitmaps are converted by FreeImage, which only converts to 8 bit channels.
+			add_alpha = (fi_bitmap_type == FIT_BITMAP && FreeImage_GetBPP(fi_bitmap) == 24) || fi_bitmap_type == FIT_RGB16 || fi_bitmap_type == FIT_RGBF;
+			if (!add_alpha)
+			{
+				FIBITMAP* converted_bitmap = FreeImage_ConvertTo32Bits(fi_bitmap);
+				FreeImage_Unload(fi_bitmap);
+				fi_bitmap = converted_bitmap;
+			}
 			fi_bitmap_color_type = FIC_RGBALPHA;
 		}
 
@@ -234,7 +277,35 @@ namespace nap
 		mSurfaceDescriptor = SurfaceDescriptor(width, height, data_type, channels);
 		updatePixelFormat();
 		mData.resize(getSizeInBytes());
-		copyImageData(FreeImage_GetBits(fi_bitmap), FreeImage_GetPitch(fi_bitmap), channels, mData.data(), mSurfaceDescriptor.getPitch(), mSurfaceDescriptor.getChannels(), getWidth(), getHeight());
+		if (add_alpha)
+		{
+			// Copy line by line, FreeImage rows are padded
+			const uint8_t* source_line = FreeImage_GetBits(fi_bitmap);
+			uint8_t* target_line = mData.data();
+			unsigned int source_pitch = FreeImage_GetPitch(fi_bitmap);
+			unsigned int target_pitch = mSurfaceDescriptor.getPitch();
+			for (int y = 0; y < height; ++y)
+			{
+				switch (data_type)
+				{
+				case ESurfaceDataType::BYTE:
+					pixel::addAlpha(source_line, target_line, width);
+					break;
+				case ESurfaceDataType::USHORT:
+					pixel::addAlpha(reinterpret_cast<const uint16*>(source_line), reinterpret_cast<uint16*>(target_line), width);
+					break;
+				case ESurfaceDataType::FLOAT:
+					pixel::addAlpha(reinterpret_cast<const float*>(source_line), reinterpret_cast<float*>(target_line), width);
+					break;
+				}
+				source_line += source_pitch;
+				target_line += target_pitch;
+			}
+		}
+		else
+		{
+			copyImageData(FreeImage_GetBits(fi_bitmap), FreeImage_GetPitch(fi_bitmap), channels, mData.data(), mSurfaceDescriptor.getPitch(), mSurfaceDescriptor.getChannels(), getWidth(), getHeight());
+		}
 		FreeImage_Unload(fi_bitmap);
 		return true;
 	}
@@ -11,6 +11,7 @@
 #include <nap/resource.h>
 #include <utility/dllexport.h>
 #include "surfacedescriptor.h"
+#include <glm/glm.hpp>
 
 namespace nap
 {
@@ -51,6 +52,26 @@ namespace nap
 		 */
 		virtual bool initFromFile(const std::string& path, nap::utility::ErrorState& errorState);
 
+		/**
+		 * Initializes this bitmap from file, scaled down when the image is larger than the given size.
+		 * The aspect ratio is preserved: the largest side of the bitmap is at most 'maxSize' pixels.
+		 * JPEG files are decoded at a reduced scale directly, which is a lot faster than decoding the full image.
+		 * @param path the path to the image on disk to load
+		 * @param maxSize max width or height of the bitmap in pixels, 0 = original size
+		 * @param errorState contains the error if the image could not be loaded
+		 * @return if the bitmap loaded successfully
+		 */
+		bool initFromFile(const std::string& path, int maxSize, nap::utility::ErrorState& errorState);
+
+		/**
+		 * Returns the size of an image after it is scaled down to the given max size, as done by initFromFile().
+		 * @param width width of the image in pixels
+		 * @param height height of the image in pixels
+		 * @param maxSize max width or height of the image in pixels, 0 = original size
+		 * @return the scaled size, the original size when the image is not larger than maxSize
+		 */
+		static glm::ivec2 getScaledSize(int width, int height, int maxSize);
+
 		/**
 		 * Initializes this bitmap based on the provided settings. 
 		 * Memory is allocated but the GPU pixel data is NOT copied over
@@ -0,0 +1,628 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "blockcompression.h"
+
+// External Includes
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+
+namespace nap
+{
+	namespace bc
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// Static
+		//////////////////////////////////////////////////////////////////////////
+
+		using Texels = uint8[16][4];
+
+		// BC7 interpolation weights of 4 bit indices
+		static const int sBC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+		/**
+		 * Writes bits into a block, least significant bit first
+		 */
+		class BitWriter
+		{
+		public:
+			BitWriter(uint8* target, int size) : mTarget(target)		{ std::memset(target, 0, size); }
+
+			void write(uint32 value, int count)
+			{
+				for (int i = 0; i < count; i++, mPosition++)
+				{
+					if ((value >> i) & 1)
+						mTarget[mPosition >> 3] |= static_cast<uint8>(1 << (mPosition & 7));
+				}
+			}
+
+		private:
+			uint8* mTarget;
+			int mPosition = 0;
+		};
+
+
+		/**
+		 * Reads bits from a block, least significant bit first
+		 */
+		class BitReader
+		{
+		public:
+			BitReader(const uint8* source) : mSource(source)			{ }
+
+			uint32 read(int count)
+			{
+				uint32 value = 0;
+				for (int i = 0; i < count; i++, mPosition++)
+					value |= static_cast<uint32>((mSource[mPosition >> 3] >> (mPosition & 7)) & 1) << i;
+				return value;
+			}
+
+		private:
+			const uint8* mSource;
+			int mPosition = 0;
+		};
+
+
+		/**
+		 * Copies a 4x4 block of texels, texels outside of the image repeat the edge.
+		 */
+		static void loadBlock(const uint8* source, int width, int height, int pitch, int x, int y, Texels& texels)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				const uint8* line = source + static_cast<size_t>(std::min(y + row, height - 1)) * pitch;
+				for (int column = 0; column < 4; column++)
+					std::memcpy(texels[row * 4 + column], line + std::min(x + column, width - 1) * 4, 4);
+			}
+		}
+
+
+		/**
+		 * Copies a 4x4 block of texels to the image, texels outside of the image are skipped.
+		 */
+		static void storeBlock(const Texels& texels, int width, int height, int x, int y, uint8* target, int pitch)
+		{
+			int rows = std::min(4, height - y);
+			int columns = std::min(4, width - x);
+			for (int row = 0; row < rows; row++)
+				std::memcpy(target + static_cast<size_t>(y + row) * pitch + x * 4, texels[row * 4], columns * 4);
+		}
+
+
+		static uint16 toRGB565(int r, int g, int b)
+		{
+			return static_cast<uint16>(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+		}
+
+
+		static void fromRGB565(uint16 color, int* rgb)
+		{
+			int r = (color >> 11) & 31;
+			int g = (color >> 5) & 63;
+			int b = color & 31;
+			rgb[0] = (r << 3) | (r >> 2);
+			rgb[1] = (g << 2) | (g >> 4);
+			rgb[2] = (b << 3) | (b >> 2);
+		}
+
+
+		/**
+		 * Finds the corners of the bounding box of the given channels that lie on the main diagonal of the texels.
+		 * The channel with the largest range is the reference, channels that decrease along the reference are flipped.
+		 * @param inset if the corners are moved inwards by 1/16th of the range, reduces the error of linear gradients
+		 */
+		static void getEndpoints(const Texels& texels, int channels, bool inset, int* low, int* high)
+		{
+			int reference = 0;
+			for (int c = 0; c < channels; c++)
+			{
+				low[c] = 255;
+				high[c] = 0;
+				for (int i = 0; i < 16; i++)
+				{
+					low[c] = std::min<int>(low[c], texels[i][c]);
+					high[c] = std::max<int>(high[c], texels[i][c]);
+				}
+				if (high[c] - low[c] > high[reference] - low[reference])
+					reference = c;
+			}
+
+			// Flip channels that correlate negatively with the reference
+			for (int c = 0; c < channels; c++)
+			{
+				if (c == reference)
+					continue;
+
+				int covariance = 0;
+				int center_reference = low[reference] + high[reference];
+				int center = low[c] + high[c];
+				for (int i = 0; i < 16; i++)
+					covariance += (texels[i][reference] * 2 - center_reference) * (texels[i][c] * 2 - center);
+
+				if (covariance < 0)
+					std::swap(low[c], high[c]);
+			}
+
+			if (!inset)
+				return;
+
+			for (int c = 0; c < channels; c++)
+			{
+				int offset = (high[c] - low[c]) / 16;
+				low[c] += offset;
+				high[c] -= offset;
+			}
+		}
+
+
+		/**
+		 * Encodes the color of a BC1 block, always uses 4 color (opaque) mode.
+		 */
+		static void encodeColorBlock(const Texels& texels, uint8* target)
+		{
+			int low[3], high[3];
+			getEndpoints(texels, 3, true, low, high);
+
+			uint16 color0 = toRGB565(high[0], high[1], high[2]);
+			uint16 color1 = toRGB565(low[0], low[1], low[2]);
+			if (color0 < color1)
+				std::swap(color0, color1);
+
+			int palette[4][3];
+			fromRGB565(color0, palette[0]);
+			fromRGB565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			// All texels use the first color when the endpoints are equal
+			uint32 indices = 0;
+			if (color0 != color1)
+			{
+				for (int i = 0; i < 16; i++)
+				{
+					int best_index = 0;
+					int best_error = INT_MAX;
+					for (int p = 0; p < 4; p++)
+					{
+						int error = 0;
+						for (int c = 0; c < 3; c++)
+						{
+							int delta = texels[i][c] - palette[p][c];
+							error += delta * delta;
+						}
+						if (error < best_error)
+						{
+							best_error = error;
+							best_index = p;
+						}
+					}
+					indices |= static_cast<uint32>(best_index) << (i * 2);
+				}
+			}
+
+			std::memcpy(target + 0, &color0, 2);
+			std::memcpy(target + 2, &color1, 2);
+			std::memcpy(target + 4, &indices, 4);
+		}
+
+
+		static void decodeColorBlock(const uint8* source, bool opaque, bool alpha, Texels& texels)
+		{
+			uint16 color0, color1;
+			uint32 indices;
+			std::memcpy(&color0, source + 0, 2);
+			std::memcpy(&color1, source + 2, 2);
+			std::memcpy(&indices, source + 4, 4);
+
+			int palette[4][4];
+			fromRGB565(color0, palette[0]);
+			fromRGB565(color1, palette[1]);
+			palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+			for (int c = 0; c < 3; c++)
+			{
+				if (opaque || color0 > color1)
+				{
+					palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+					palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+				}
+				else
+				{
+					palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+					palette[3][c] = 0;
+				}
+			}
+			if (!opaque && color0 <= color1 && alpha)
+				palette[3][3] = 0;
+
+			for (int i = 0; i < 16; i++)
+			{
+				int index = (indices >> (i * 2)) & 3;
+				for (int c = 0; c < 4; c++)
+					texels[i][c] = static_cast<uint8>(palette[index][c]);
+			}
+		}
+
+
+		/**
+		 * Encodes a single channel of a block, as used by BC3 (alpha), BC4 and BC5. Always uses 8 value mode.
+		 */
+		static void encodeChannelBlock(const Texels& texels, int channel, uint8* target)
+		{
+			int low = 255, high = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				low = std::min<int>(low, texels[i][channel]);
+				high = std::max<int>(high, texels[i][channel]);
+			}
+
+			int palette[8] = { high, low };
+			for (int p = 2; p < 8; p++)
+				palette[p] = ((8 - p) * high + (p - 1) * low) / 7;
+
+			// All texels use the first value when the endpoints are equal
+			uint64 indices = 0;
+			if (high != low)
+			{
+				for (int i = 0; i < 16; i++)
+				{
+					int best_index = 0;
+					int best_error = INT_MAX;
+					for (int p = 0; p < 8; p++)
+					{
+						int error = std::abs(texels[i][channel] - palette[p]);
+						if (error < best_error)
+						{
+							best_error = error;
+							best_index = p;
+						}
+					}
+					indices |= static_cast<uint64>(best_index) << (i * 3);
+				}
+			}
+
+			target[0] = static_cast<uint8>(high);
+			target[1] = static_cast<uint8>(low);
+			for (int b = 0; b < 6; b++)
+				target[2 + b] = static_cast<uint8>(indices >> (b * 8));
+		}
+
+
+		static void decodeChannelBlock(const uint8* source, int channel, Texels& texels)
+		{
+			int palette[8] = { source[0], source[1] };
+			if (palette[0] > palette[1])
+			{
+				for (int p = 2; p < 8; p++)
+					palette[p] = ((8 - p) * palette[0] + (p - 1) * palette[1]) / 7;
+			}
+			else
+			{
+				for (int p = 2; p < 6; p++)
+					palette[p] = ((6 - p) * palette[0] + (p - 1) * palette[1]) / 5;
+				palette[6] = 0;
+				palette[7] = 255;
+			}
+
+			uint64 indices = 0;
+			for (int b = 0; b < 6; b++)
+				indices |= static_cast<uint64>(source[2 + b]) << (b * 8);
+
+			for (int i = 0; i < 16; i++)
+				texels[i][channel] = static_cast<uint8>(palette[(indices >> (i * 3)) & 7]);
+		}
+
+
+		static int interpolateBC7(int e0, int e1, int weight)
+		{
+			return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+		}
+
+
+		/**
+		 * BC7 mode 6 endpoints: 7 bits per channel and a p-bit per endpoint, that is shared by all channels.
+		 */
+		struct BC7Endpoints
+		{
+			int mQuantized[2][4];		///< 7 bit values
+			int mPBits[2];				///< P-bit of every endpoint
+			int mValues[2][4];			///< Decoded 8 bit values
+		};
+
+
+		/**
+		 * Quantizes the given endpoints, choosing the p-bit with the lowest error.
+		 */
+		static void quantizeBC7Endpoints(const int (&corners)[2][4], BC7Endpoints& endpoints)
+		{
+			for (int e = 0; e < 2; e++)
+			{
+				int best_error = INT_MAX;
+				for (int p = 0; p < 2; p++)
+				{
+					int error = 0;
+					int values[4];
+					for (int c = 0; c < 4; c++)
+					{
+						values[c] = std::min(127, std::max(0, (corners[e][c] - p + 1) / 2));
+						int delta = ((values[c] << 1) | p) - corners[e][c];
+						error += delta * delta;
+					}
+					if (error < best_error)
+					{
+						best_error = error;
+						endpoints.mPBits[e] = p;
+						std::memcpy(endpoints.mQuantized[e], values, sizeof(values));
+					}
+				}
+				for (int c = 0; c < 4; c++)
+					endpoints.mValues[e][c] = (endpoints.mQuantized[e][c] << 1) | endpoints.mPBits[e];
+			}
+		}
+
+
+		/**
+		 * Selects the closest interpolated value for every texel.
+		 * @return the total squared error
+		 */
+		static int findBC7Indices(const Texels& texels, const BC7Endpoints& endpoints, int (&indices)[16])
+		{
+			int total_error = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				int best_error = INT_MAX;
+				for (int w = 0; w < 16; w++)
+				{
+					int error = 0;
+					for (int c = 0; c < 4; c++)
+					{
+						int delta = texels[i][c] - interpolateBC7(endpoints.mValues[0][c], endpoints.mValues[1][c], sBC7Weights[w]);
+						error += delta * delta;
+					}
+					if (error < best_error)
+					{
+						best_error = error;
+						indices[i] = w;
+					}
+				}
+				total_error += best_error;
+			}
+			return total_error;
+		}
+
+
+		/**
+		 * Encodes a BC7 block using mode 6: a single subset, 7 bit RGBA endpoints with a p-bit each and 4 bit indices.
+		 * The endpoints of the bounding box are refined once with a least squares fit to the selected indices.
+		 */
+		static void encodeBC7Block(const Texels& texels, uint8* target)
+		{
+			int corners[2][4];
+			getEndpoints(texels, 4, false, corners[0], corners[1]);
+
+			BC7Endpoints endpoints;
+			int indices[16];
+			quantizeBC7Endpoints(corners, endpoints);
+			int error = findBC7Indices(texels, endpoints, indices);
+
+			// Solve the endpoints that minimize the error for the selected weights
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+			float ax[4] = { 0.0f }, bx[4] = { 0.0f };
+			for (int i = 0; i < 16; i++)
+			{
+				float b = sBC7Weights[indices[i]] / 64.0f;
+				float a = 1.0f - b;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (int c = 0; c < 4; c++)
+				{
+					ax[c] += a * texels[i][c];
+					bx[c] += b * texels[i][c];
+				}
+			}
+
+			float determinant = aa * bb - ab * ab;
+			if (error > 0 && std::abs(determinant) > 1e-6f)
+			{
+				int refined_corners[2][4];
+				for (int c = 0; c < 4; c++)
+				{
+					float e0 = (ax[c] * bb - bx[c] * ab) / determinant;
+					float e1 = (bx[c] * aa - ax[c] * ab) / determinant;
+					refined_corners[0][c] = std::min(255, std::max(0, static_cast<int>(e0 + 0.5f)));
+					refined_corners[1][c] = std::min(255, std::max(0, static_cast<int>(e1 + 0.5f)));
+				}
+
+				BC7Endpoints refined;
+				int refined_indices[16];
+				quantizeBC7Endpoints(refined_corners, refined);
+				if (findBC7Indices(texels, refined, refined_indices) < error)
+				{
+					endpoints = refined;
+					std::memcpy(indices, refined_indices, sizeof(indices));
+				}
+			}
+
+			// The most significant bit of the first index is implicitly 0, swap the endpoints when it isn't.
+			// The weights are symmetric, so inverting the indices gives the exact same result.
+			if (indices[0] & 8)
+			{
+				std::swap(endpoints.mQuantized[0], endpoints.mQuantized[1]);
+				std::swap(endpoints.mPBits[0], endpoints.mPBits[1]);
+				for (int& index : indices)
+					index = 15 - index;
+			}
+
+			BitWriter writer(target, 16);
+			writer.write(1 << 6, 7);
+			for (int c = 0; c < 4; c++)
+			{
+				writer.write(endpoints.mQuantized[0][c], 7);
+				writer.write(endpoints.mQuantized[1][c], 7);
+			}
+			writer.write(endpoints.mPBits[0], 1);
+			writer.write(endpoints.mPBits[1], 1);
+			writer.write(indices[0], 3);
+			for (int i = 1; i < 16; i++)
+				writer.write(indices[i], 4);
+		}
+
+
+		static bool decodeBC7Block(const uint8* source, Texels& texels)
+		{
+			BitReader reader(source);
+			int mode = 0;
+			while (mode < 8 && reader.read(1) == 0)
+				mode++;
+			if (mode != 6)
+				return false;
+
+			int endpoints[2][4];
+			for (int c = 0; c < 4; c++)
+			{
+				endpoints[0][c] = reader.read(7) << 1;
+				endpoints[1][c] = reader.read(7) << 1;
+			}
+			uint32 pbit0 = reader.read(1);
+			uint32 pbit1 = reader.read(1);
+			for (int c = 0; c < 4; c++)
+			{
+				endpoints[0][c] |= pbit0;
+				endpoints[1][c] |= pbit1;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int weight = sBC7Weights[reader.read(i == 0 ? 3 : 4)];
+				for (int c = 0; c < 4; c++)
+					texels[i][c] = static_cast<uint8>(interpolateBC7(endpoints[0][c], endpoints[1][c], weight));
+			}
+			return true;
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// Block Compression
+		//////////////////////////////////////////////////////////////////////////
+
+		int getBlockSize(EBlockFormat format)
+		{
+			switch (format)
+			{
+			case EBlockFormat::BC1:
+			case EBlockFormat::BC1A:
+			case EBlockFormat::BC4:
+				return 8;
+			case EBlockFormat::BC3:
+			case EBlockFormat::BC5:
+			case EBlockFormat::BC7:
+				return 16;
+			default:
+				assert(false);
+				return 0;
+			}
+		}
+
+
+		uint64 getCompressedSize(EBlockFormat format, int width, int height)
+		{
+			uint64 blocks_x = static_cast<uint64>((width + 3) / 4);
+			uint64 blocks_y = static_cast<uint64>((height + 3) / 4);
+			return blocks_x * blocks_y * static_cast<uint64>(getBlockSize(format));
+		}
+
+
+		void compress(const uint8* source, int width, int height, int pitch, EBlockFormat format, uint8* target)
+		{
+			int block_size = getBlockSize(format);
+			Texels texels;
+			for (int y = 0; y < height; y += 4)
+			{
+				for (int x = 0; x < width; x += 4, target += block_size)
+				{
+					loadBlock(source, width, height, pitch, x, y, texels);
+					switch (format)
+					{
+					case EBlockFormat::BC1:
+					case EBlockFormat::BC1A:
+						encodeColorBlock(texels, target);
+						break;
+					case EBlockFormat::BC3:
+						encodeChannelBlock(texels, 3, target);
+						encodeColorBlock(texels, target + 8);
+						break;
+					case EBlockFormat::BC4:
+						encodeChannelBlock(texels, 0, target);
+						break;
+					case EBlockFormat::BC5:
+						encodeChannelBlock(texels, 0, target);
+						encodeChannelBlock(texels, 1, target + 8);
+						break;
+					case EBlockFormat::BC7:
+						encodeBC7Block(texels, target);
+						break;
+					default:
+						assert(false);
+						break;
+					}
+				}
+			}
+		}
+
+
+		bool decompress(const uint8* source, int width, int height, EBlockFormat format, uint8* target, int pitch)
+		{
+			int block_size = getBlockSize(format);
+			Texels texels;
+			for (int y = 0; y < height; y += 4)
+			{
+				for (int x = 0; x < width; x += 4, source += block_size)
+				{
+					switch (format)
+					{
+					case EBlockFormat::BC1:
+						decodeColorBlock(source, false, false, texels);
+						break;
+					case EBlockFormat::BC1A:
+						decodeColorBlock(source, false, true, texels);
+						break;
+					case EBlockFormat::BC3:
+						decodeColorBlock(source + 8, true, false, texels);
+						decodeChannelBlock(source, 3, texels);
+						break;
+					case EBlockFormat::BC4:
+					case EBlockFormat::BC5:
+						std::memset(texels, 0, sizeof(texels));
+						for (auto& texel : texels)
+							texel[3] = 255;
+						decodeChannelBlock(source, 0, texels);
+						if (format == EBlockFormat::BC5)
+							decodeChannelBlock(source + 8, 1, texels);
+						break;
+					case EBlockFormat::BC7:
+						if (!decodeBC7Block(source, texels))
+							return false;
+						break;
+					default:
+						assert(false);
+						return false;
+					}
+					storeBlock(texels, width, height, x, y, target, pitch);
+				}
+			}
+			return true;
+		}
+	}
+}
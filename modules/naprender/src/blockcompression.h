@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <nap/numeric.h>
+
+namespace nap
+{
+	/**
+	 * Supported block compressed texture formats.
+	 * Every format stores 4x4 texels in a fixed size block, which the GPU decodes while sampling.
+	 */
+	enum class EBlockFormat : int
+	{
+		BC1		= 0,		///< RGB, 8 bytes per block
+		BC1A	= 1,		///< RGB with 1 bit alpha, 8 bytes per block
+		BC3		= 2,		///< RGBA, 16 bytes per block
+		BC4		= 3,		///< Single channel (R), 8 bytes per block
+		BC5		= 4,		///< Two channels (RG), 16 bytes per block, used for normal maps
+		BC7		= 5			///< High quality RGBA, 16 bytes per block
+	};
+
+	namespace bc
+	{
+		/**
+		 * @param format the block format
+		 * @return size in bytes of a single 4x4 block
+		 */
+		NAPAPI int getBlockSize(EBlockFormat format);
+
+		/**
+		 * @param format the block format
+		 * @param width width of the image in texels
+		 * @param height height of the image in texels
+		 * @return size in bytes of the compressed image, partial blocks at the edges are rounded up
+		 */
+		NAPAPI uint64 getCompressedSize(EBlockFormat format, int width, int height);
+
+		/**
+		 * Compresses 8 bit RGBA pixels into blocks.
+		 * BC4 only stores the red channel, BC5 the red and green channel.
+		 * BC1 and BC1A blocks are always opaque, BC7 blocks are encoded using a single subset (mode 6).
+		 * The encoder is meant for offline conversion, it favours speed over the quality of an exhaustive search.
+		 * @param source RGBA pixels
+		 * @param width width of the image in pixels
+		 * @param height height of the image in pixels
+		 * @param pitch size in bytes of a single row of source pixels
+		 * @param format the block format to compress to
+		 * @param target receives the blocks, must be getCompressedSize() bytes
+		 */
+		NAPAPI void compress(const uint8* source, int width, int height, int pitch, EBlockFormat format, uint8* target);
+
+		/**
+		 * Decompresses blocks into 8 bit RGBA pixels.
+		 * BC4 decodes to red, BC5 to red and green, the remaining channels are 0 and alpha is 255.
+		 * Only BC7 blocks that use mode 6 can be decoded, the mode written by compress().
+		 * @param source the blocks
+		 * @param width width of the image in pixels
+		 * @param height height of the image in pixels
+		 * @param format the block format of the source
+		 * @param target RGBA pixels
+		 * @param pitch size in bytes of a single row of target pixels
+		 * @return if all blocks are decoded
+		 */
+		NAPAPI bool decompress(const uint8* source, int width, int height, EBlockFormat format, uint8* target, int pitch);
+	}
+}
@@ -0,0 +1,33 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "compressedimagefromfile.h"
+#include "compressedtexture.h"
+
+// External Includes
+#include <nap/core.h>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::CompressedImageFromFile)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("ImagePath",		&nap::CompressedImageFromFile::mImagePath,		nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::Image)
+RTTI_END_CLASS
+
+namespace nap
+{
+	CompressedImageFromFile::CompressedImageFromFile(Core& core) :
+		Texture2D(core)
+	{ }
+
+
+	bool CompressedImageFromFile::init(utility::ErrorState& errorState)
+	{
+		// The blocks are only kept in memory until they are copied into the staging buffer
+		CompressedTextureData data;
+		if (!loadCompressedTexture(mImagePath, data, errorState))
+			return false;
+
+		return Texture2D::init(data, errorState);
+	}
+}
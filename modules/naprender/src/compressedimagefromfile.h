@@ -0,0 +1,41 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "texture2d.h"
+
+// External Includes
+#include <rtti/factory.h>
+
+namespace nap
+{
+	/**
+	 * 2D image that is loaded from a block compressed .ktx2 or .dds file.
+	 * The BC1, BC3, BC4, BC5 or BC7 blocks, including all mip levels, are uploaded to the GPU as is.
+	 * Compared to a nap::ImageFromFile this uses 4 to 8 times less GPU memory and upload bandwidth, and requires no decoding on the CPU.
+	 * Use the 'texturecompressor' tool to convert images to .ktx2 files.
+	 * The GPU must support block compressed textures, see RenderService::getBlockCompressionSupported().
+	 * The texture usage must be 'Static'.
+	 */
+	class NAPAPI CompressedImageFromFile : public Texture2D
+	{
+		RTTI_ENABLE(Texture2D)
+	public:
+		/**
+		 * @param core the core instance
+		 */
+		CompressedImageFromFile(Core& core);
+
+		/**
+		 * Loads the compressed image from disk and schedules the upload to the GPU on success.
+		 * @param errorState contains the error when initialization fails
+		 * @return true when successful, otherwise false.
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		std::string				mImagePath;								///< Property: 'ImagePath' Path to the .ktx2 or .dds file on disk to load
+	};
+}
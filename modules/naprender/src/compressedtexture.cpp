@@ -0,0 +1,431 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "compressedtexture.h"
+
+// External Includes
+#include <utility/fileutils.h>
+#include <vulkan/vulkan_core.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Static
+	//////////////////////////////////////////////////////////////////////////
+
+	// KTX2 file identifier
+	static const uint8 sKTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	// Size of the KTX2 identifier, header and index, after which the level index starts
+	static constexpr size_t sKTX2LevelIndexOffset = 80;
+
+	// Size of a single entry in the KTX2 level index
+	static constexpr size_t sKTX2LevelIndexSize = 24;
+
+	// Size of the DDS magic number and header, after which the DX10 header or data starts
+	static constexpr size_t sDDSHeaderSize = 128;
+
+	// Size of the DDS DX10 header
+	static constexpr size_t sDDSDX10HeaderSize = 20;
+
+	// Khronos data format descriptor color models
+	static constexpr uint8 sDFDModelBC1A = 128;
+	static constexpr uint8 sDFDModelBC3 = 130;
+	static constexpr uint8 sDFDModelBC4 = 131;
+	static constexpr uint8 sDFDModelBC5 = 132;
+	static constexpr uint8 sDFDModelBC7 = 134;
+
+
+	static constexpr uint32 makeFourCC(char a, char b, char c, char d)
+	{
+		return static_cast<uint32>(a) | static_cast<uint32>(b) << 8 | static_cast<uint32>(c) << 16 | static_cast<uint32>(d) << 24;
+	}
+
+
+	template<typename T>
+	static T read(const std::string& data, size_t offset)
+	{
+		T value;
+		std::memcpy(&value, data.data() + offset, sizeof(T));
+		return value;
+	}
+
+
+	template<typename T>
+	static void write(std::string& data, T value)
+	{
+		data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+
+	static bool getBlockFormat(uint32 vkFormat, EBlockFormat& outFormat, EColorSpace& outColorSpace)
+	{
+		switch (vkFormat)
+		{
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:		outFormat = EBlockFormat::BC1;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:		outFormat = EBlockFormat::BC1;	outColorSpace = EColorSpace::sRGB;		return true;
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:	outFormat = EBlockFormat::BC1A;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:		outFormat = EBlockFormat::BC1A;	outColorSpace = EColorSpace::sRGB;		return true;
+		case VK_FORMAT_BC3_UNORM_BLOCK:			outFormat = EBlockFormat::BC3;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC3_SRGB_BLOCK:			outFormat = EBlockFormat::BC3;	outColorSpace = EColorSpace::sRGB;		return true;
+		case VK_FORMAT_BC4_UNORM_BLOCK:			outFormat = EBlockFormat::BC4;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC5_UNORM_BLOCK:			outFormat = EBlockFormat::BC5;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC7_UNORM_BLOCK:			outFormat = EBlockFormat::BC7;	outColorSpace = EColorSpace::Linear;	return true;
+		case VK_FORMAT_BC7_SRGB_BLOCK:			outFormat = EBlockFormat::BC7;	outColorSpace = EColorSpace::sRGB;		return true;
+		default:
+			return false;
+		}
+	}
+
+
+	static uint32 getVulkanFormat(EBlockFormat format, EColorSpace colorSpace)
+	{
+		bool srgb = colorSpace == EColorSpace::sRGB;
+		switch (format)
+		{
+		case EBlockFormat::BC1:		return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+		case EBlockFormat::BC1A:	return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case EBlockFormat::BC3:		return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+		case EBlockFormat::BC4:		return VK_FORMAT_BC4_UNORM_BLOCK;
+		case EBlockFormat::BC5:		return VK_FORMAT_BC5_UNORM_BLOCK;
+		case EBlockFormat::BC7:		return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+		default:
+			assert(false);
+			return VK_FORMAT_UNDEFINED;
+		}
+	}
+
+
+	/**
+	 * Returns the number of levels in a full mip chain of the given dimensions: floor(log2(max(width, height))) + 1.
+	 */
+	static uint32 getMaxLevelCount(uint32 width, uint32 height)
+	{
+		uint32 count = 1;
+		for (uint32 size = std::max(width, height); size > 1; size >>= 1)
+			count++;
+		return count;
+	}
+
+
+	/**
+	 * Returns if the range [offset, offset + size) lies within the file, without overflowing.
+	 */
+	static bool inRange(const std::string& file, uint64 offset, uint64 size)
+	{
+		return offset <= file.size() && size <= file.size() - offset;
+	}
+
+
+	/**
+	 * Adds all levels of a file, the levels must be tightly packed and the data must be in range.
+	 */
+	static bool addLevels(const std::string& file, size_t offset, uint32 count, CompressedTextureData& outData, utility::ErrorState& errorState)
+	{
+		for (uint32 i = 0; i < count; i++)
+		{
+			uint32 level = static_cast<uint32>(outData.mLevels.size());
+			uint64 size = bc::getCompressedSize(outData.mFormat, std::max(1u, outData.mWidth >> level), std::max(1u, outData.mHeight >> level));
+			if (!errorState.check(inRange(file, offset, size), "mip level %d out of range", level))
+				return false;
+
+			outData.addLevel(reinterpret_cast<const uint8*>(file.data() + offset));
+			offset += size;
+		}
+		return true;
+	}
+
+
+	static bool loadKTX2(const std::string& file, CompressedTextureData& outData, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(file.size() >= sKTX2LevelIndexOffset, "invalid KTX2 header"))
+			return false;
+
+		uint32 vk_format		= read<uint32>(file, 12);
+		uint32 width			= read<uint32>(file, 20);
+		uint32 height			= read<uint32>(file, 24);
+		uint32 depth			= read<uint32>(file, 28);
+		uint32 layers			= read<uint32>(file, 32);
+		uint32 faces			= read<uint32>(file, 36);
+		uint32 levels			= std::max(1u, read<uint32>(file, 40));
+		uint32 supercompression = read<uint32>(file, 44);
+
+		if (!errorState.check(getBlockFormat(vk_format, outData.mFormat, outData.mColorSpace), "unsupported KTX2 format: %d, only BC1, BC3, BC4, BC5 and BC7 are supported", vk_format))
+			return false;
+
+		if (!errorState.check(depth == 0 && layers <= 1 && faces == 1 && width > 0 && height > 0, "KTX2 file must contain a single 2D image"))
+			return false;
+
+		if (!errorState.check(supercompression == 0, "KTX2 supercompression is not supported"))
+			return false;
+
+		if (!errorState.check(levels <= getMaxLevelCount(width, height), "invalid KTX2 level count: %d", levels))
+			return false;
+
+		if (!errorState.check(file.size() >= sKTX2LevelIndexOffset + levels * sKTX2LevelIndexSize, "invalid KTX2 level index"))
+			return false;
+
+		outData.mWidth = width;
+		outData.mHeight = height;
+		outData.mLevels.clear();
+		outData.mData.clear();
+
+		// Levels are not guaranteed to be adjacent, add them one by one
+		for (uint32 level = 0; level < levels; level++)
+		{
+			size_t entry = sKTX2LevelIndexOffset + level * sKTX2LevelIndexSize;
+			uint64 offset = read<uint64>(file, entry);
+			uint64 length = read<uint64>(file, entry + 8);
+			uint64 size = bc::getCompressedSize(outData.mFormat, std::max(1u, width >> level), std::max(1u, height >> level));
+			if (!errorState.check(length == size && inRange(file, offset, length), "invalid KTX2 mip level: %d", level))
+				return false;
+
+			if (!addLevels(file, offset, 1, outData, errorState))
+				return false;
+		}
+		return true;
+	}
+
+
+	static bool loadDDS(const std::string& file, CompressedTextureData& outData, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(file.size() >= sDDSHeaderSize && read<uint32>(file, 4) == 124, "invalid DDS header"))
+			return false;
+
+		uint32 flags			= read<uint32>(file, 8);
+		uint32 height			= read<uint32>(file, 12);
+		uint32 width			= read<uint32>(file, 16);
+		uint32 levels			= (flags & 0x20000) != 0 ? std::max(1u, read<uint32>(file, 28)) : 1;
+		uint32 pixel_flags		= read<uint32>(file, 80);
+		uint32 four_cc			= read<uint32>(file, 84);
+		uint32 caps2			= read<uint32>(file, 112);
+
+		// Cube maps and volumes are not supported
+		if (!errorState.check((caps2 & (0x200 | 0x200000)) == 0 && width > 0 && height > 0, "DDS file must contain a single 2D image"))
+			return false;
+
+		if (!errorState.check((pixel_flags & 0x4) != 0, "DDS file is not block compressed"))
+			return false;
+
+		if (!errorState.check(levels <= getMaxLevelCount(width, height), "invalid DDS mip map count: %d", levels))
+			return false;
+
+		size_t offset = sDDSHeaderSize;
+		outData.mColorSpace = EColorSpace::Linear;
+		switch (four_cc)
+		{
+		case makeFourCC('D', 'X', 'T', '1'):
+			outData.mFormat = EBlockFormat::BC1A;
+			break;
+		case makeFourCC('D', 'X', 'T', '5'):
+			outData.mFormat = EBlockFormat::BC3;
+			break;
+		case makeFourCC('A', 'T', 'I', '1'):
+		case makeFourCC('B', 'C', '4', 'U'):
+			outData.mFormat = EBlockFormat::BC4;
+			break;
+		case makeFourCC('A', 'T', 'I', '2'):
+		case makeFourCC('B', 'C', '5', 'U'):
+			outData.mFormat = EBlockFormat::BC5;
+			break;
+		case makeFourCC('D', 'X', '1', '0'):
+		{
+			if (!errorState.check(file.size() >= sDDSHeaderSize + sDDSDX10HeaderSize, "invalid DDS DX10 header"))
+				return false;
+
+			uint32 dxgi_format	= read<uint32>(file, 128);
+			uint32 dimension	= read<uint32>(file, 132);
+			uint32 misc			= read<uint32>(file, 136);
+			uint32 array_size	= read<uint32>(file, 140);
+			if (!errorState.check(dimension == 3 && (misc & 0x4) == 0 && array_size <= 1, "DDS file must contain a single 2D image"))
+				return false;
+
+			switch (dxgi_format)
+			{
+			case 71: outData.mFormat = EBlockFormat::BC1A;	break;
+			case 72: outData.mFormat = EBlockFormat::BC1A;	outData.mColorSpace = EColorSpace::sRGB; break;
+			case 77: outData.mFormat = EBlockFormat::BC3;	break;
+			case 78: outData.mFormat = EBlockFormat::BC3;	outData.mColorSpace = EColorSpace::sRGB; break;
+			case 80: outData.mFormat = EBlockFormat::BC4;	break;
+			case 83: outData.mFormat = EBlockFormat::BC5;	break;
+			case 98: outData.mFormat = EBlockFormat::BC7;	break;
+			case 99: outData.mFormat = EBlockFormat::BC7;	outData.mColorSpace = EColorSpace::sRGB; break;
+			default:
+				errorState.fail("unsupported DDS DXGI format: %d, only BC1, BC3, BC4, BC5 and BC7 are supported", dxgi_format);
+				return false;
+			}
+			offset += sDDSDX10HeaderSize;
+			break;
+		}
+		default:
+			errorState.fail("unsupported DDS format, only BC1, BC3, BC4, BC5 and BC7 are supported");
+			return false;
+		}
+
+		outData.mWidth = width;
+		outData.mHeight = height;
+		outData.mLevels.clear();
+		outData.mData.clear();
+		return addLevels(file, offset, levels, outData, errorState);
+	}
+
+
+	/**
+	 * Creates the Khronos basic data format descriptor of a block format, required by KTX2.
+	 */
+	static std::string createDataFormatDescriptor(EBlockFormat format, EColorSpace colorSpace)
+	{
+		// Sample: channel id, bit offset and bit length
+		struct Sample { uint8 mChannel; uint16 mOffset; uint16 mLength; };
+		std::vector<Sample> samples;
+		uint8 model = 0;
+		switch (format)
+		{
+		case EBlockFormat::BC1:		model = sDFDModelBC1A;	samples = { { 0, 0, 64 } }; break;
+		case EBlockFormat::BC1A:	model = sDFDModelBC1A;	samples = { { 15, 0, 64 } }; break;
+		case EBlockFormat::BC3:		model = sDFDModelBC3;	samples = { { 15, 0, 64 }, { 0, 64, 64 } }; break;
+		case EBlockFormat::BC4:		model = sDFDModelBC4;	samples = { { 0, 0, 64 } }; break;
+		case EBlockFormat::BC5:		model = sDFDModelBC5;	samples = { { 0, 0, 64 }, { 1, 64, 64 } }; break;
+		case EBlockFormat::BC7:		model = sDFDModelBC7;	samples = { { 0, 0, 128 } }; break;
+		default:
+			assert(false);
+			break;
+		}
+
+		bool srgb = colorSpace == EColorSpace::sRGB;
+		uint16 block_size = static_cast<uint16>(24 + 16 * samples.size());
+
+		std::string descriptor;
+		write<uint32>(descriptor, 4 + block_size);					// Total size
+		write<uint32>(descriptor, 0);								// Vendor and descriptor type: Khronos basic
+		write<uint16>(descriptor, 2);								// Version
+		write<uint16>(descriptor, block_size);						// Block size
+		write<uint8>(descriptor, model);							// Color model
+		write<uint8>(descriptor, 1);								// Primaries: BT709
+		write<uint8>(descriptor, srgb ? 2 : 1);						// Transfer: sRGB or linear
+		write<uint8>(descriptor, 0);								// Flags: straight alpha
+		write<uint32>(descriptor, 0x00000303);						// Texel block dimensions: 4x4
+		write<uint8>(descriptor, static_cast<uint8>(bc::getBlockSize(format)));
+		descriptor.append(7, '\0');									// Bytes of remaining planes
+
+		for (const Sample& sample : samples)
+		{
+			// Alpha is always linear
+			uint8 qualifiers = srgb && sample.mChannel == 15 ? 0x10 : 0;
+			write<uint16>(descriptor, sample.mOffset);
+			write<uint8>(descriptor, static_cast<uint8>(sample.mLength - 1));
+			write<uint8>(descriptor, sample.mChannel | qualifiers);
+			write<uint32>(descriptor, 0);							// Sample position
+			write<uint32>(descriptor, 0);							// Lower
+			write<uint32>(descriptor, 0xFFFFFFFF);					// Upper
+		}
+		return descriptor;
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// CompressedTextureData
+	//////////////////////////////////////////////////////////////////////////
+
+	void CompressedTextureData::addLevel(const uint8* blocks)
+	{
+		uint32 index = static_cast<uint32>(mLevels.size());
+		CompressedMipLevel level;
+		level.mWidth = std::max(1u, mWidth >> index);
+		level.mHeight = std::max(1u, mHeight >> index);
+		level.mOffset = mData.size();
+		level.mSize = bc::getCompressedSize(mFormat, level.mWidth, level.mHeight);
+		mData.insert(mData.end(), blocks, blocks + level.mSize);
+		mLevels.emplace_back(level);
+	}
+
+
+	bool loadCompressedTexture(const std::string& path, CompressedTextureData& outData, utility::ErrorState& errorState)
+	{
+		std::string file;
+		if (!utility::readFileToString(path, file, errorState))
+			return false;
+
+		bool loaded = false;
+		if (file.size() >= sizeof(sKTX2Identifier) && std::memcmp(file.data(), sKTX2Identifier, sizeof(sKTX2Identifier)) == 0)
+			loaded = loadKTX2(file, outData, errorState);
+		else if (file.size() >= 4 && read<uint32>(file, 0) == makeFourCC('D', 'D', 'S', ' '))
+			loaded = loadDDS(file, outData, errorState);
+		else
+			errorState.fail("not a KTX2 or DDS file");
+
+		return errorState.check(loaded, "unable to load compressed texture: %s", path.c_str());
+	}
+
+
+	bool saveKTX2(const std::string& path, const CompressedTextureData& data, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(!data.mLevels.empty(), "%s: no mip levels to save", path.c_str()))
+			return false;
+
+		uint32 level_count = static_cast<uint32>(data.mLevels.size());
+		std::string descriptor = createDataFormatDescriptor(data.mFormat, data.mColorSpace);
+		size_t descriptor_offset = sKTX2LevelIndexOffset + level_count * sKTX2LevelIndexSize;
+
+		// Levels are stored smallest first, every level is aligned to the block size
+		size_t alignment = static_cast<size_t>(bc::getBlockSize(data.mFormat));
+		std::vector<uint64> level_offsets(level_count);
+		size_t offset = descriptor_offset + descriptor.size();
+		for (int level = static_cast<int>(level_count) - 1; level >= 0; level--)
+		{
+			offset = (offset + alignment - 1) / alignment * alignment;
+			level_offsets[level] = offset;
+			offset += data.mLevels[level].mSize;
+		}
+
+		// Identifier and header
+		std::string file(reinterpret_cast<const char*>(sKTX2Identifier), sizeof(sKTX2Identifier));
+		write<uint32>(file, getVulkanFormat(data.mFormat, data.mColorSpace));
+		write<uint32>(file, 1);										// Type size
+		write<uint32>(file, data.mWidth);
+		write<uint32>(file, data.mHeight);
+		write<uint32>(file, 0);										// Depth
+		write<uint32>(file, 0);										// Layers
+		write<uint32>(file, 1);										// Faces
+		write<uint32>(file, level_count);
+		write<uint32>(file, 0);										// Supercompression
+
+		// Index
+		write<uint32>(file, static_cast<uint32>(descriptor_offset));
+		write<uint32>(file, static_cast<uint32>(descriptor.size()));
+		write<uint32>(file, 0);										// Key value data offset
+		write<uint32>(file, 0);										// Key value data size
+		write<uint64>(file, 0);										// Supercompression global data offset
+		write<uint64>(file, 0);										// Supercompression global data size
+
+		// Level index
+		for (uint32 level = 0; level < level_count; level++)
+		{
+			write<uint64>(file, level_offsets[level]);
+			write<uint64>(file, data.mLevels[level].mSize);
+			write<uint64>(file, data.mLevels[level].mSize);
+		}
+		file.append(descriptor);
+
+		// Level data
+		for (int level = static_cast<int>(level_count) - 1; level >= 0; level--)
+		{
+			const CompressedMipLevel& mip = data.mLevels[level];
+			file.resize(level_offsets[level], '\0');
+			file.append(reinterpret_cast<const char*>(data.mData.data() + mip.mOffset), mip.mSize);
+		}
+
+		std::ofstream stream(path, std::ios::out | std::ios::binary);
+		if (!errorState.check(stream.good(), "unable to open file for writing: %s", path.c_str()))
+			return false;
+
+		stream.write(file.data(), file.size());
+		return errorState.check(stream.good(), "unable to write file: %s", path.c_str());
+	}
+}
@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "blockcompression.h"
+#include "surfacedescriptor.h"
+
+// External Includes
+#include <utility/errorstate.h>
+#include <string>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * Location of a single mip level in CompressedTextureData::mData.
+	 */
+	struct NAPAPI CompressedMipLevel
+	{
+		uint32		mWidth = 0;						///< Width of the level in texels
+		uint32		mHeight = 0;					///< Height of the level in texels
+		uint64		mOffset = 0;					///< Offset in bytes of the level in the data
+		uint64		mSize = 0;						///< Size in bytes of the level
+	};
+
+
+	/**
+	 * Block compressed 2D image, including all mip levels, as stored in a KTX2 or DDS file.
+	 * The levels are tightly packed in 'mData', largest level first.
+	 */
+	struct NAPAPI CompressedTextureData
+	{
+		EBlockFormat						mFormat = EBlockFormat::BC1;			///< Block format of all levels
+		EColorSpace							mColorSpace = EColorSpace::Linear;		///< Color space of the texels
+		uint32								mWidth = 0;								///< Width of the first level in texels
+		uint32								mHeight = 0;							///< Height of the first level in texels
+		std::vector<CompressedMipLevel>		mLevels;								///< All mip levels, largest first
+		std::vector<uint8>					mData;									///< Blocks of all levels
+
+		/**
+		 * Adds a mip level, the size of the level is derived from the level index and format.
+		 * @param blocks the compressed blocks of the level, copied
+		 */
+		void addLevel(const uint8* blocks);
+	};
+
+
+	/**
+	 * Loads a block compressed image from a .ktx2 or .dds file.
+	 * KTX2 files must contain a single 2D image without supercompression.
+	 * DDS files can use the 'DXT1', 'DXT5', 'ATI1', 'ATI2', 'BC4U', 'BC5U' or 'DX10' format.
+	 * The color space of legacy DDS files is always linear.
+	 * @param path path to the file
+	 * @param outData receives the image
+	 * @param errorState contains the error if the file can't be loaded
+	 * @return if the image is loaded
+	 */
+	NAPAPI bool loadCompressedTexture(const std::string& path, CompressedTextureData& outData, utility::ErrorState& errorState);
+
+	/**
+	 * Saves a block compressed image as a .ktx2 file.
+	 * @param path path to the file
+	 * @param data the image to save
+	 * @param errorState contains the error if the file can't be written
+	 * @return if the image is saved
+	 */
+	NAPAPI bool saveKTX2(const std::string& path, const CompressedTextureData& data, utility::ErrorState& errorState);
+}
@@ -3,19 +3,47 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "copyimagedata.h"
+#include "pixelconversion.h"
 
 namespace nap
 {
-	void copyImageData(const uint8_t* source, unsigned int sourcePitch, ESurfaceChannels sourceChannels, uint8_t* target, unsigned int targetPitch, ESurfaceChannels targetChannels, int width, int height)
+	/**
+	 * Swaps the first and third channel of a row of 4 channel pixels, for channels wider than 8 bit
+	 */
+	template<typename T>
+	static void swapRBRow(const uint8_t* source, uint8_t* target, int width)
+	{
+		const T* source_pixel = reinterpret_cast<const T*>(source);
+		T* target_pixel = reinterpret_cast<T*>(target);
+		for (int x = 0; x < width; ++x, source_pixel += 4, target_pixel += 4)
+		{
+			T r = source_pixel[0];
+			T b = source_pixel[2];
+			target_pixel[0] = b;
+			target_pixel[1] = source_pixel[1];
+			target_pixel[2] = r;
+			target_pixel[3] = source_pixel[3];
+		}
+	}
+
+
+	void copyImageData(const uint8_t* source, unsigned int sourcePitch, ESurfaceChannels sourceChannels, uint8_t* target, unsigned int targetPitch, ESurfaceChannels targetChannels, int width, int height, bool swapRB)
 	{
 		assert(targetPitch <= sourcePitch);
 
+		// Get the amount of bytes every pixel occupies
+		int source_stride = sourcePitch / width;
+		int target_stride = targetPitch / width;
+
+		// Swapping red and blue is only supported between 4 channel pixels of the same size
+		assert(!swapRB || (source_stride == target_stride && sourceChannels != ESurfaceChannels::R && targetChannels != ESurfaceChannels::R));
+
 		// If the dest & source pitches are the same, we can do a straight memcpy (most common/efficient case)
-		if (targetPitch == sourcePitch)
+		if (targetPitch == sourcePitch && !swapRB)
 		{
 			memcpy(target, source, sourcePitch * height);
 		}
-		else if (sourceChannels == targetChannels)
+		else if (!swapRB && sourceChannels == targetChannels)
 		{
 			// If the pitch of the source & destination buffers are different, we need to copy the image data line by line (happens for weirdly-sized images)
 			const uint8_t* source_line = source;
@@ -28,30 +56,61 @@ namespace nap
 				target_line += targetPitch;
 			}
 		}
+		else if (swapRB)
+		{
+			// Swap line by line, 8 bit channels use the vectorized kernel
+			const uint8_t* source_line = source;
+			uint8_t* target_line = target;
+
+			for (int y = 0; y < height; ++y)
+			{
+				switch (target_stride)
+				{
+				case 4:
+					pixel::swapRB(source_line, target_line, width);
+					break;
+				case 8:
+					swapRBRow<uint16_t>(source_line, target_line, width);
+					break;
+				default:
+					assert(target_stride == 16);
+					swapRBRow<uint32_t>(source_line, target_line, width);
+					break;
+				}
+				source_line += sourcePitch;
+				target_line += targetPitch;
+			}
+		}
 		else
 		{
 			// If the pitch of the source & destination buffers are different, we need to copy the image data line by line (happens for weirdly-sized images)
 			const uint8_t* source_line = source;
 			uint8_t* target_line = target;
 
-			// Get the amount of bytes every pixel occupies
-			int source_stride = sourcePitch / width;
-			int target_stride = targetPitch / width;
-
 			for (int y = 0; y < height; ++y)
 			{
 				const uint8_t* source_loc = source_line;
 				uint8_t* target_loc = target_line;
-				for (int x = 0; x < width; ++x)
+
+				// Extracting a single 8 bit channel is common enough to avoid a memcpy per pixel
+				if (target_stride == 1)
 				{
-					memcpy(target_loc, source_loc, target_stride);
-					target_loc += target_stride;
-					source_loc += source_stride;
+					for (int x = 0; x < width; ++x, source_loc += source_stride)
+						target_loc[x] = *source_loc;
+				}
+				else
+				{
+					for (int x = 0; x < width; ++x)
+					{
+						memcpy(target_loc, source_loc, target_stride);
+						target_loc += target_stride;
+						source_loc += source_stride;
+					}
 				}
 
 				source_line += sourcePitch;
 				target_line += targetPitch;
 			}
-		}		
+		}
 	}
 }
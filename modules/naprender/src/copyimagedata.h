@@ -23,6 +23,8 @@ namespace nap
 	 * @param targetChannels number of channels per pixel
 	 * @param width width of the image in pixels
 	 * @param height height of the image in pixels
+	 * @param swapRB if the red and blue channel are swapped while copying, for example to copy from BGRA to RGBA.
+	 * Only supported when source and target have 4 channels of the same size.
 	 */
-	NAPAPI void copyImageData(const uint8_t* source, unsigned int sourcePitch, ESurfaceChannels sourceChannels, uint8_t* target, unsigned int targetPitch, ESurfaceChannels targetChannels, int width, int height);
+	NAPAPI void copyImageData(const uint8_t* source, unsigned int sourcePitch, ESurfaceChannels sourceChannels, uint8_t* target, unsigned int targetPitch, ESurfaceChannels targetChannels, int width, int height, bool swapRB = false);
 }
\ No newline at end of file
@@ -166,6 +166,7 @@ namespace nap
 				imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 				imageInfo.imageView = texture.getImageView();
 				imageInfo.sampler = vk_sampler;
+				mSamplerTextures[imageStartIndex + index] = &texture;
 			}
 		}
 		else
@@ -176,6 +177,7 @@ namespace nap
 			imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 			imageInfo.imageView = sampler_2d->getTexture().getImageView();
 			imageInfo.sampler = vk_sampler;
+			mSamplerTextures[imageStartIndex] = &sampler_2d->getTexture();
 		}
 	}
 
@@ -214,6 +216,7 @@ namespace nap
 		imageInfo.sampler = sampler;
 
 		mSamplerWriteDescriptors.push_back(imageInfo);
+		mSamplerTextures.push_back(&texture2D);
 	}
 
 	bool MaterialInstance::initSamplers(utility::ErrorState& errorState)
@@ -370,6 +373,14 @@ namespace nap
 		for (VkWriteDescriptorSet& write_descriptor : mSamplerWriteDescriptorSets)
 			write_descriptor.dstSet = descriptorSet.mSet;
 
+		// The image of a texture can change when it is re-initialized at a different resolution, always bind the current view.
+		// Textures are marked as bound, which allows streaming textures to find out if they are in use.
+		for (int index = 0; index < mSamplerTextures.size(); ++index)
+		{
+			mSamplerWriteDescriptors[index].imageView = mSamplerTextures[index]->getImageView();
+			mSamplerTextures[index]->mBound = true;
+		}
+
 		vkUpdateDescriptorSets(mDevice, mSamplerWriteDescriptorSets.size(), mSamplerWriteDescriptorSets.data(), 0, nullptr);
 	}
 
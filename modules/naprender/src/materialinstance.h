@@ -174,6 +174,7 @@ namespace nap
 		std::vector<UniformBufferObject>		mUniformBufferObjects;					// List of all UBO instances
 		std::vector<VkWriteDescriptorSet>		mSamplerWriteDescriptorSets;			// List of sampler descriptors, used to update Descriptor Sets
 		std::vector<VkDescriptorImageInfo>		mSamplerWriteDescriptors;				// List of sampler images, used to update Descriptor Sets.
+		std::vector<const Texture2D*>			mSamplerTextures;						// Texture of every sampler image, the image view is refreshed on update
 		bool									mUniformsCreated = false;				// Set when a uniform instance is created in between draws
 	};
 
@@ -0,0 +1,1068 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "pixelconversion.h"
+
+// External Includes
+#include <cstring>
+#include <initializer_list>
+
+// Every x86 kernel is compiled for its own instruction set and selected at runtime,
+// the module itself is built for the baseline instruction set of the platform.
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define NAP_PIXEL_X86
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define NAP_PIXEL_TARGET(instructionSet)
+	#else
+		#define NAP_PIXEL_TARGET(instructionSet) __attribute__((target(instructionSet)))
+	#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+	#define NAP_PIXEL_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace nap
+{
+	namespace pixel
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// Scalar kernels, also used for the remaining pixels of all vectorized kernels
+		//////////////////////////////////////////////////////////////////////////
+
+		namespace scalar
+		{
+			static inline uint8 clampByte(int value)
+			{
+				return static_cast<uint8>(value < 0 ? 0 : (value > 255 ? 255 : value));
+			}
+
+			static inline float clampUnit(float value)
+			{
+				// Written so that NaN results in 0, the same as the vectorized kernels
+				value = value > 0.0f ? value : 0.0f;
+				return value < 1.0f ? value : 1.0f;
+			}
+
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				for (size_t i = 0; i < count; i++, source += 3, target += 4)
+				{
+					target[0] = source[0];
+					target[1] = source[1];
+					target[2] = source[2];
+					target[3] = alpha;
+				}
+			}
+
+			static void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				for (size_t i = 0; i < count; i++, source += 3, target += 4)
+				{
+					target[0] = source[2];
+					target[1] = source[1];
+					target[2] = source[0];
+					target[3] = alpha;
+				}
+			}
+
+			static void removeAlpha(const uint8* source, uint8* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++, source += 4, target += 3)
+				{
+					target[0] = source[0];
+					target[1] = source[1];
+					target[2] = source[2];
+				}
+			}
+
+			static void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++, source += 4, target += 3)
+				{
+					target[0] = source[2];
+					target[1] = source[1];
+					target[2] = source[0];
+				}
+			}
+
+			static void swapRB(const uint8* source, uint8* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++, source += 4, target += 4)
+				{
+					uint8 r = source[0];
+					uint8 b = source[2];
+					target[0] = b;
+					target[1] = source[1];
+					target[2] = r;
+					target[3] = source[3];
+				}
+			}
+
+			static void u8ToU16(const uint8* source, uint16* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<uint16>(source[i] * 257);
+			}
+
+			static void u16ToU8(const uint16* source, uint8* target, size_t count)
+			{
+				// Equals round(value / 257) for all 16 bit values
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<uint8>((source[i] * 255u + 32895u) >> 16);
+			}
+
+			static void u8ToFloat(const uint8* source, float* target, size_t count)
+			{
+				const float scale = 1.0f / 255.0f;
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<float>(source[i]) * scale;
+			}
+
+			static void floatToU8(const float* source, uint8* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<uint8>(static_cast<int>(clampUnit(source[i]) * 255.0f + 0.5f));
+			}
+
+			static void u16ToFloat(const uint16* source, float* target, size_t count)
+			{
+				const float scale = 1.0f / 65535.0f;
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<float>(source[i]) * scale;
+			}
+
+			static void floatToU16(const float* source, uint16* target, size_t count)
+			{
+				for (size_t i = 0; i < count; i++)
+					target[i] = static_cast<uint16>(static_cast<int>(clampUnit(source[i]) * 65535.0f + 0.5f));
+			}
+
+			/**
+			 * BT.709 limited range YUV to RGB with 8 bit fixed point coefficients.
+			 * The vectorized kernels use the exact same arithmetic.
+			 */
+			static inline void yuvPixel(int y, int u, int v, uint8* target)
+			{
+				int c = y - 16;
+				int d = u - 128;
+				int e = v - 128;
+				target[0] = clampByte((298 * c + 459 * e + 128) >> 8);
+				target[1] = clampByte((298 * c - 55 * d - 136 * e + 128) >> 8);
+				target[2] = clampByte((298 * c + 541 * d + 128) >> 8);
+				target[3] = 255;
+			}
+
+			static void yuvRow(const uint8* y, const uint8* u, const uint8* v, uint8* target, int start, int width)
+			{
+				for (int x = start; x < width; x++)
+					yuvPixel(y[x], u[x / 2], v[x / 2], target + x * 4);
+			}
+
+			static void yuvRow(const uint8* y, const uint8* u, const uint8* v, uint8* target, int width)
+			{
+				yuvRow(y, u, v, target, 0, width);
+			}
+		}
+
+
+#ifdef NAP_PIXEL_X86
+		//////////////////////////////////////////////////////////////////////////
+		// SSE2 kernels
+		//////////////////////////////////////////////////////////////////////////
+
+		namespace sse2
+		{
+			NAP_PIXEL_TARGET("sse2")
+			static void swapRB(const uint8* source, uint8* target, size_t count)
+			{
+				const __m128i mask_ag = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+				const __m128i mask_byte = _mm_set1_epi32(0xFF);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+					__m128i ag = _mm_and_si128(p, mask_ag);
+					__m128i r = _mm_slli_epi32(_mm_and_si128(p, mask_byte), 16);
+					__m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), mask_byte);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_or_si128(ag, _mm_or_si128(r, b)));
+				}
+				scalar::swapRB(source + i * 4, target + i * 4, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void u8ToU16(const uint8* source, uint16* target, size_t count)
+			{
+				// Interleaving a byte with itself multiplies it by 257
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_unpacklo_epi8(v, v));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i + 8), _mm_unpackhi_epi8(v, v));
+				}
+				scalar::u8ToU16(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void u16ToU8(const uint16* source, uint8* target, size_t count)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i rounding = _mm_set1_epi32(32895);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+					__m128i lo = _mm_unpacklo_epi16(v, zero);
+					__m128i hi = _mm_unpackhi_epi16(v, zero);
+
+					// value * 255 = (value << 8) - value
+					lo = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(lo, 8), lo), rounding), 16);
+					hi = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(hi, 8), hi), rounding), 16);
+					__m128i packed = _mm_packs_epi32(lo, hi);
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(target + i), _mm_packus_epi16(packed, packed));
+				}
+				scalar::u16ToU8(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void u8ToFloat(const uint8* source, float* target, size_t count)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+					__m128i lo = _mm_unpacklo_epi8(v, zero);
+					__m128i hi = _mm_unpackhi_epi8(v, zero);
+					_mm_storeu_ps(target + i + 0,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+					_mm_storeu_ps(target + i + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+					_mm_storeu_ps(target + i + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+					_mm_storeu_ps(target + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+				}
+				scalar::u8ToFloat(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static inline __m128i floatToInt(__m128 value, __m128 scale)
+			{
+				// max returns the second operand when the first is NaN
+				value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+				return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), _mm_set1_ps(0.5f)));
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void floatToU8(const float* source, uint8* target, size_t count)
+			{
+				const __m128 scale = _mm_set1_ps(255.0f);
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					__m128i a = floatToInt(_mm_loadu_ps(source + i + 0),  scale);
+					__m128i b = floatToInt(_mm_loadu_ps(source + i + 4),  scale);
+					__m128i c = floatToInt(_mm_loadu_ps(source + i + 8),  scale);
+					__m128i d = floatToInt(_mm_loadu_ps(source + i + 12), scale);
+					__m128i packed = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), packed);
+				}
+				scalar::floatToU8(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void u16ToFloat(const uint16* source, float* target, size_t count)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+					_mm_storeu_ps(target + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)), scale));
+					_mm_storeu_ps(target + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)), scale));
+				}
+				scalar::u16ToFloat(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void floatToU16(const float* source, uint16* target, size_t count)
+			{
+				// SSE2 can only pack to signed 16 bit, offset the range and flip the sign bit back afterwards
+				const __m128 scale = _mm_set1_ps(65535.0f);
+				const __m128i offset = _mm_set1_epi32(32768);
+				const __m128i sign = _mm_set1_epi16(static_cast<short>(0x8000));
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m128i a = _mm_sub_epi32(floatToInt(_mm_loadu_ps(source + i + 0), scale), offset);
+					__m128i b = _mm_sub_epi32(floatToInt(_mm_loadu_ps(source + i + 4), scale), offset);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_xor_si128(_mm_packs_epi32(a, b), sign));
+				}
+				scalar::floatToU16(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("sse2")
+			static void yuvRow(const uint8* y, const uint8* u, const uint8* v, uint8* target, int width)
+			{
+				const __m128i zero = _mm_setzero_si128();
+				const __m128i y_offset = _mm_set1_epi16(16);
+				const __m128i uv_offset = _mm_set1_epi16(128);
+				const __m128i rounding = _mm_set1_epi32(128);
+				const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+
+				// Coefficients are multiplied in pairs by madd, see scalar::yuvPixel
+				const __m128i coeff_ce_r = _mm_set_epi16(459, 298, 459, 298, 459, 298, 459, 298);
+				const __m128i coeff_cd_g = _mm_set_epi16(-55, 298, -55, 298, -55, 298, -55, 298);
+				const __m128i coeff_e_g  = _mm_set_epi16(0, -136, 0, -136, 0, -136, 0, -136);
+				const __m128i coeff_cd_b = _mm_set_epi16(541, 298, 541, 298, 541, 298, 541, 298);
+
+				int x = 0;
+				for (; x + 8 <= width; x += 8)
+				{
+					// 8 luma and 4 chroma samples, every chroma sample is used for 2 pixels
+					int32 u_samples, v_samples;
+					std::memcpy(&u_samples, u + x / 2, sizeof(int32));
+					std::memcpy(&v_samples, v + x / 2, sizeof(int32));
+					__m128i u8 = _mm_cvtsi32_si128(u_samples);
+					__m128i v8 = _mm_cvtsi32_si128(v_samples);
+					__m128i c = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(y + x)), zero), y_offset);
+					__m128i d = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(u8, u8), zero), uv_offset);
+					__m128i e = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_unpacklo_epi8(v8, v8), zero), uv_offset);
+
+					__m128i ce_lo = _mm_unpacklo_epi16(c, e);
+					__m128i ce_hi = _mm_unpackhi_epi16(c, e);
+					__m128i cd_lo = _mm_unpacklo_epi16(c, d);
+					__m128i cd_hi = _mm_unpackhi_epi16(c, d);
+					__m128i e_lo  = _mm_unpacklo_epi16(e, zero);
+					__m128i e_hi  = _mm_unpackhi_epi16(e, zero);
+
+					__m128i r_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_lo, coeff_ce_r), rounding), 8);
+					__m128i r_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(ce_hi, coeff_ce_r), rounding), 8);
+					__m128i g_lo = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, coeff_cd_g), _mm_madd_epi16(e_lo, coeff_e_g)), rounding), 8);
+					__m128i g_hi = _mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, coeff_cd_g), _mm_madd_epi16(e_hi, coeff_e_g)), rounding), 8);
+					__m128i b_lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_lo, coeff_cd_b), rounding), 8);
+					__m128i b_hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(cd_hi, coeff_cd_b), rounding), 8);
+
+					// Saturating packs clamp to 0-255
+					__m128i r = _mm_packs_epi32(r_lo, r_hi);
+					__m128i g = _mm_packs_epi32(g_lo, g_hi);
+					__m128i b = _mm_packs_epi32(b_lo, b_hi);
+					__m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+					__m128i ba = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), alpha);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + x * 4), _mm_unpacklo_epi16(rg, ba));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + x * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+				}
+				scalar::yuvRow(y, u, v, target, x, width);
+			}
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// SSSE3 kernels, byte shuffles for 3 channel layouts
+		//////////////////////////////////////////////////////////////////////////
+
+		namespace ssse3
+		{
+			NAP_PIXEL_TARGET("ssse3")
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha, __m128i mask)
+			{
+				// Every load reads 16 bytes of which 12 are used, stop when the load would read past the end
+				const __m128i alpha_v = _mm_set1_epi32(static_cast<int>(static_cast<uint32>(alpha) << 24));
+				size_t i = 0;
+				for (; i + 6 <= count; i += 4)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha_v));
+				}
+				scalar::addAlpha(source + i * 3, target + i * 4, count - i, alpha);
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				addAlpha(source, target, count, alpha, _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				// The scalar remainder is handled separately, the shared kernel does not swap
+				size_t vector_count = count >= 6 ? ((count - 6) / 4 + 1) * 4 : 0;
+				const __m128i alpha_v = _mm_set1_epi32(static_cast<int>(static_cast<uint32>(alpha) << 24));
+				const __m128i mask = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+				for (size_t i = 0; i < vector_count; i += 4)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha_v));
+				}
+				scalar::addAlphaSwapRB(source + vector_count * 3, target + vector_count * 4, count - vector_count, alpha);
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static inline void store12(uint8* target, __m128i value)
+			{
+				_mm_storel_epi64(reinterpret_cast<__m128i*>(target), value);
+				int32 last = _mm_cvtsi128_si32(_mm_srli_si128(value, 8));
+				std::memcpy(target + 8, &last, sizeof(int32));
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static void removeAlpha(const uint8* source, uint8* target, size_t count)
+			{
+				const __m128i mask = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+					store12(target + i * 3, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4)), mask));
+				scalar::removeAlpha(source + i * 4, target + i * 3, count - i);
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count)
+			{
+				const __m128i mask = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+					store12(target + i * 3, _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4)), mask));
+				scalar::removeAlphaSwapRB(source + i * 4, target + i * 3, count - i);
+			}
+
+			NAP_PIXEL_TARGET("ssse3")
+			static void swapRB(const uint8* source, uint8* target, size_t count)
+			{
+				const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+				size_t i = 0;
+				for (; i + 4 <= count; i += 4)
+				{
+					__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_shuffle_epi8(v, mask));
+				}
+				scalar::swapRB(source + i * 4, target + i * 4, count - i);
+			}
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// AVX2 kernels, shuffles operate per 128 bit lane
+		//////////////////////////////////////////////////////////////////////////
+
+		namespace avx2
+		{
+			NAP_PIXEL_TARGET("avx2")
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha, __m256i mask, void (*remainder)(const uint8*, uint8*, size_t, uint8))
+			{
+				// Every lane loads 16 bytes of which 12 are used, the second load ends 28 bytes after the first pixel
+				const __m256i alpha_v = _mm256_set1_epi32(static_cast<int>(static_cast<uint32>(alpha) << 24));
+				size_t i = 0;
+				for (; i + 10 <= count; i += 8)
+				{
+					__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3));
+					__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 3 + 12));
+					__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(v, mask), alpha_v));
+				}
+				remainder(source + i * 3, target + i * 4, count - i, alpha);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				const __m256i mask = _mm256_setr_epi8(
+					0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+					0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+				addAlpha(source, target, count, alpha, mask, ssse3::addAlpha);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				const __m256i mask = _mm256_setr_epi8(
+					2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+					2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+				addAlpha(source, target, count, alpha, mask, ssse3::addAlphaSwapRB);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void removeAlpha(const uint8* source, uint8* target, size_t count, __m256i mask, void (*remainder)(const uint8*, uint8*, size_t))
+			{
+				// Move the 12 valid bytes of both lanes next to each other
+				const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+					v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, mask), pack);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 3), _mm256_castsi256_si128(v));
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(target + i * 3 + 16), _mm256_extracti128_si256(v, 1));
+				}
+				remainder(source + i * 4, target + i * 3, count - i);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void removeAlpha(const uint8* source, uint8* target, size_t count)
+			{
+				const __m256i mask = _mm256_setr_epi8(
+					0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+					0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+				removeAlpha(source, target, count, mask, ssse3::removeAlpha);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count)
+			{
+				const __m256i mask = _mm256_setr_epi8(
+					2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+					2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+				removeAlpha(source, target, count, mask, ssse3::removeAlphaSwapRB);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void swapRB(const uint8* source, uint8* target, size_t count)
+			{
+				const __m256i mask = _mm256_setr_epi8(
+					2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+					2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 4), _mm256_shuffle_epi8(v, mask));
+				}
+				ssse3::swapRB(source + i * 4, target + i * 4, count - i);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void u8ToU16(const uint8* source, uint16* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					__m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), _mm256_or_si256(v, _mm256_slli_epi16(v, 8)));
+				}
+				scalar::u8ToU16(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void u8ToFloat(const uint8* source, float* target, size_t count)
+			{
+				const __m256 scale = _mm256_set1_ps(1.0f / 255.0f);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					__m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + i)));
+					_mm256_storeu_ps(target + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+				}
+				scalar::u8ToFloat(source + i, target + i, count - i);
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static inline __m256i floatToInt(__m256 value, __m256 scale)
+			{
+				value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+				return _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(value, scale), _mm256_set1_ps(0.5f)));
+			}
+
+			NAP_PIXEL_TARGET("avx2")
+			static void floatToU8(const float* source, uint8* target, size_t count)
+			{
+				const __m256 scale = _mm256_set1_ps(255.0f);
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					// Packing operates per lane, restore the order of the 64 bit blocks before the final pack
+					__m256i a = floatToInt(_mm256_loadu_ps(source + i), scale);
+					__m256i b = floatToInt(_mm256_loadu_ps(source + i + 8), scale);
+					__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+					__m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(packed), _mm256_extracti128_si256(packed, 1));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), bytes);
+				}
+				sse2::floatToU8(source + i, target + i, count - i);
+			}
+		}
+#endif // NAP_PIXEL_X86
+
+
+#ifdef NAP_PIXEL_NEON
+		//////////////////////////////////////////////////////////////////////////
+		// NEON kernels, interleaved loads and stores handle all channel layouts
+		//////////////////////////////////////////////////////////////////////////
+
+		namespace neon
+		{
+			static void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16x3_t s = vld3q_u8(source + i * 3);
+					uint8x16x4_t t = { { s.val[0], s.val[1], s.val[2], vdupq_n_u8(alpha) } };
+					vst4q_u8(target + i * 4, t);
+				}
+				scalar::addAlpha(source + i * 3, target + i * 4, count - i, alpha);
+			}
+
+			static void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16x3_t s = vld3q_u8(source + i * 3);
+					uint8x16x4_t t = { { s.val[2], s.val[1], s.val[0], vdupq_n_u8(alpha) } };
+					vst4q_u8(target + i * 4, t);
+				}
+				scalar::addAlphaSwapRB(source + i * 3, target + i * 4, count - i, alpha);
+			}
+
+			static void removeAlpha(const uint8* source, uint8* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16x4_t s = vld4q_u8(source + i * 4);
+					uint8x16x3_t t = { { s.val[0], s.val[1], s.val[2] } };
+					vst3q_u8(target + i * 3, t);
+				}
+				scalar::removeAlpha(source + i * 4, target + i * 3, count - i);
+			}
+
+			static void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16x4_t s = vld4q_u8(source + i * 4);
+					uint8x16x3_t t = { { s.val[2], s.val[1], s.val[0] } };
+					vst3q_u8(target + i * 3, t);
+				}
+				scalar::removeAlphaSwapRB(source + i * 4, target + i * 3, count - i);
+			}
+
+			static void swapRB(const uint8* source, uint8* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16x4_t s = vld4q_u8(source + i * 4);
+					uint8x16x4_t t = { { s.val[2], s.val[1], s.val[0], s.val[3] } };
+					vst4q_u8(target + i * 4, t);
+				}
+				scalar::swapRB(source + i * 4, target + i * 4, count - i);
+			}
+
+			static void u8ToU16(const uint8* source, uint16* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 16 <= count; i += 16)
+				{
+					uint8x16_t v = vld1q_u8(source + i);
+					uint8x16x2_t z = vzipq_u8(v, v);
+					vst1q_u16(target + i, vreinterpretq_u16_u8(z.val[0]));
+					vst1q_u16(target + i + 8, vreinterpretq_u16_u8(z.val[1]));
+				}
+				scalar::u8ToU16(source + i, target + i, count - i);
+			}
+
+			static void u16ToU8(const uint16* source, uint8* target, size_t count)
+			{
+				const uint32x4_t rounding = vdupq_n_u32(32895);
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					uint16x8_t v = vld1q_u16(source + i);
+					uint32x4_t lo = vmlaq_n_u32(rounding, vmovl_u16(vget_low_u16(v)), 255);
+					uint32x4_t hi = vmlaq_n_u32(rounding, vmovl_u16(vget_high_u16(v)), 255);
+					vst1_u8(target + i, vmovn_u16(vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16))));
+				}
+				scalar::u16ToU8(source + i, target + i, count - i);
+			}
+
+			static void u8ToFloat(const uint8* source, float* target, size_t count)
+			{
+				const float scale = 1.0f / 255.0f;
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					uint16x8_t v = vmovl_u8(vld1_u8(source + i));
+					vst1q_f32(target + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale));
+					vst1q_f32(target + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), scale));
+				}
+				scalar::u8ToFloat(source + i, target + i, count - i);
+			}
+
+			static inline uint32x4_t floatToInt(float32x4_t value, float scale)
+			{
+				value = vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(1.0f));
+				return vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(value, scale), vdupq_n_f32(0.5f)));
+			}
+
+			static void floatToU8(const float* source, uint8* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					uint16x4_t lo = vmovn_u32(floatToInt(vld1q_f32(source + i), 255.0f));
+					uint16x4_t hi = vmovn_u32(floatToInt(vld1q_f32(source + i + 4), 255.0f));
+					vst1_u8(target + i, vmovn_u16(vcombine_u16(lo, hi)));
+				}
+				scalar::floatToU8(source + i, target + i, count - i);
+			}
+
+			static void u16ToFloat(const uint16* source, float* target, size_t count)
+			{
+				const float scale = 1.0f / 65535.0f;
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					uint16x8_t v = vld1q_u16(source + i);
+					vst1q_f32(target + i, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))), scale));
+					vst1q_f32(target + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))), scale));
+				}
+				scalar::u16ToFloat(source + i, target + i, count - i);
+			}
+
+			static void floatToU16(const float* source, uint16* target, size_t count)
+			{
+				size_t i = 0;
+				for (; i + 8 <= count; i += 8)
+				{
+					uint16x4_t lo = vmovn_u32(floatToInt(vld1q_f32(source + i), 65535.0f));
+					uint16x4_t hi = vmovn_u32(floatToInt(vld1q_f32(source + i + 4), 65535.0f));
+					vst1q_u16(target + i, vcombine_u16(lo, hi));
+				}
+				scalar::floatToU16(source + i, target + i, count - i);
+			}
+
+			static inline uint8x8_t yuvChannel(int32x4_t lo, int32x4_t hi)
+			{
+				// Rounding shift adds 128 before shifting, the saturating narrows clamp to 0-255
+				return vqmovun_s16(vcombine_s16(vqmovn_s32(vrshrq_n_s32(lo, 8)), vqmovn_s32(vrshrq_n_s32(hi, 8))));
+			}
+
+			static void yuvRow(const uint8* y, const uint8* u, const uint8* v, uint8* target, int width)
+			{
+				int x = 0;
+				for (; x + 8 <= width; x += 8)
+				{
+					// 8 luma and 4 chroma samples, every chroma sample is used for 2 pixels
+					uint32 u_samples, v_samples;
+					std::memcpy(&u_samples, u + x / 2, sizeof(uint32));
+					std::memcpy(&v_samples, v + x / 2, sizeof(uint32));
+					uint8x8_t u8 = vcreate_u8(u_samples);
+					uint8x8_t v8 = vcreate_u8(v_samples);
+					u8 = vzip_u8(u8, u8).val[0];
+					v8 = vzip_u8(v8, v8).val[0];
+
+					int16x8_t c = vreinterpretq_s16_u16(vsubl_u8(vld1_u8(y + x), vdup_n_u8(16)));
+					int16x8_t d = vreinterpretq_s16_u16(vsubl_u8(u8, vdup_n_u8(128)));
+					int16x8_t e = vreinterpretq_s16_u16(vsubl_u8(v8, vdup_n_u8(128)));
+
+					int32x4_t c_lo = vmull_n_s16(vget_low_s16(c), 298);
+					int32x4_t c_hi = vmull_n_s16(vget_high_s16(c), 298);
+					int32x4_t r_lo = vmlal_n_s16(c_lo, vget_low_s16(e), 459);
+					int32x4_t r_hi = vmlal_n_s16(c_hi, vget_high_s16(e), 459);
+					int32x4_t g_lo = vmlal_n_s16(vmlal_n_s16(c_lo, vget_low_s16(d), -55), vget_low_s16(e), -136);
+					int32x4_t g_hi = vmlal_n_s16(vmlal_n_s16(c_hi, vget_high_s16(d), -55), vget_high_s16(e), -136);
+					int32x4_t b_lo = vmlal_n_s16(c_lo, vget_low_s16(d), 541);
+					int32x4_t b_hi = vmlal_n_s16(c_hi, vget_high_s16(d), 541);
+
+					uint8x8x4_t pixels = { { yuvChannel(r_lo, r_hi), yuvChannel(g_lo, g_hi), yuvChannel(b_lo, b_hi), vdup_n_u8(255) } };
+					vst4_u8(target + x * 4, pixels);
+				}
+				scalar::yuvRow(y, u, v, target, x, width);
+			}
+		}
+#endif // NAP_PIXEL_NEON
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// Dispatch
+		//////////////////////////////////////////////////////////////////////////
+
+		/**
+		 * All kernels of a single instruction set
+		 */
+		struct Kernels
+		{
+			void (*mAddAlpha)(const uint8*, uint8*, size_t, uint8);
+			void (*mAddAlphaSwapRB)(const uint8*, uint8*, size_t, uint8);
+			void (*mRemoveAlpha)(const uint8*, uint8*, size_t);
+			void (*mRemoveAlphaSwapRB)(const uint8*, uint8*, size_t);
+			void (*mSwapRB)(const uint8*, uint8*, size_t);
+			void (*mU8ToU16)(const uint8*, uint16*, size_t);
+			void (*mU16ToU8)(const uint16*, uint8*, size_t);
+			void (*mU8ToFloat)(const uint8*, float*, size_t);
+			void (*mFloatToU8)(const float*, uint8*, size_t);
+			void (*mU16ToFloat)(const uint16*, float*, size_t);
+			void (*mFloatToU16)(const float*, uint16*, size_t);
+			void (*mYUVRow)(const uint8*, const uint8*, const uint8*, uint8*, int);
+		};
+
+
+		/**
+		 * Every instruction set uses the kernels of the instruction sets it extends, when it has no specific implementation
+		 */
+		static Kernels createKernels(EInstructionSet instructionSet)
+		{
+			Kernels kernels =
+			{
+				scalar::addAlpha, scalar::addAlphaSwapRB, scalar::removeAlpha, scalar::removeAlphaSwapRB, scalar::swapRB,
+				scalar::u8ToU16, scalar::u16ToU8, scalar::u8ToFloat, scalar::floatToU8, scalar::u16ToFloat, scalar::floatToU16,
+				scalar::yuvRow
+			};
+
+#ifdef NAP_PIXEL_X86
+			bool x86 = instructionSet == EInstructionSet::SSE2 || instructionSet == EInstructionSet::SSSE3 || instructionSet == EInstructionSet::AVX2;
+			if (x86)
+			{
+				kernels.mSwapRB = sse2::swapRB;
+				kernels.mU8ToU16 = sse2::u8ToU16;
+				kernels.mU16ToU8 = sse2::u16ToU8;
+				kernels.mU8ToFloat = sse2::u8ToFloat;
+				kernels.mFloatToU8 = sse2::floatToU8;
+				kernels.mU16ToFloat = sse2::u16ToFloat;
+				kernels.mFloatToU16 = sse2::floatToU16;
+				kernels.mYUVRow = sse2::yuvRow;
+			}
+			if (x86 && instructionSet != EInstructionSet::SSE2)
+			{
+				kernels.mAddAlpha = ssse3::addAlpha;
+				kernels.mAddAlphaSwapRB = ssse3::addAlphaSwapRB;
+				kernels.mRemoveAlpha = ssse3::removeAlpha;
+				kernels.mRemoveAlphaSwapRB = ssse3::removeAlphaSwapRB;
+				kernels.mSwapRB = ssse3::swapRB;
+			}
+			if (instructionSet == EInstructionSet::AVX2)
+			{
+				kernels.mAddAlpha = avx2::addAlpha;
+				kernels.mAddAlphaSwapRB = avx2::addAlphaSwapRB;
+				kernels.mRemoveAlpha = avx2::removeAlpha;
+				kernels.mRemoveAlphaSwapRB = avx2::removeAlphaSwapRB;
+				kernels.mSwapRB = avx2::swapRB;
+				kernels.mU8ToU16 = avx2::u8ToU16;
+				kernels.mU8ToFloat = avx2::u8ToFloat;
+				kernels.mFloatToU8 = avx2::floatToU8;
+			}
+#endif // NAP_PIXEL_X86
+
+#ifdef NAP_PIXEL_NEON
+			if (instructionSet == EInstructionSet::NEON)
+			{
+				kernels =
+				{
+					neon::addAlpha, neon::addAlphaSwapRB, neon::removeAlpha, neon::removeAlphaSwapRB, neon::swapRB,
+					neon::u8ToU16, neon::u16ToU8, neon::u8ToFloat, neon::floatToU8, neon::u16ToFloat, neon::floatToU16,
+					neon::yuvRow
+				};
+			}
+#endif // NAP_PIXEL_NEON
+
+			return kernels;
+		}
+
+
+		/**
+		 * Selected instruction set and its kernels, initialized to the best supported instruction set on first use
+		 */
+		struct Dispatch
+		{
+			Dispatch()
+			{
+				for (EInstructionSet set : { EInstructionSet::NEON, EInstructionSet::AVX2, EInstructionSet::SSSE3, EInstructionSet::SSE2 })
+				{
+					if (isInstructionSetSupported(set))
+					{
+						mInstructionSet = set;
+						break;
+					}
+				}
+				mKernels = createKernels(mInstructionSet);
+			}
+
+			EInstructionSet	mInstructionSet = EInstructionSet::Scalar;
+			Kernels			mKernels;
+		};
+
+
+		static Dispatch& getDispatch()
+		{
+			static Dispatch dispatch;
+			return dispatch;
+		}
+
+
+		static const Kernels& getKernels()
+		{
+			return getDispatch().mKernels;
+		}
+
+
+		EInstructionSet getInstructionSet()
+		{
+			return getDispatch().mInstructionSet;
+		}
+
+
+		bool isInstructionSetSupported(EInstructionSet instructionSet)
+		{
+			switch (instructionSet)
+			{
+			case EInstructionSet::Scalar:
+				return true;
+#ifdef NAP_PIXEL_X86
+	#ifdef _MSC_VER
+			case EInstructionSet::SSE2:
+			case EInstructionSet::SSSE3:
+			case EInstructionSet::AVX2:
+			{
+				int info[4];
+				__cpuid(info, 0);
+				int max_leaf = info[0];
+				__cpuid(info, 1);
+				if (instructionSet == EInstructionSet::SSE2)
+					return (info[3] & (1 << 26)) != 0;
+				if (instructionSet == EInstructionSet::SSSE3)
+					return (info[2] & (1 << 9)) != 0;
+
+				// AVX2 requires the OS to save the 256 bit registers
+				bool os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+				if (!os_avx || max_leaf < 7)
+					return false;
+				__cpuidex(info, 7, 0);
+				return (info[1] & (1 << 5)) != 0;
+			}
+	#else
+			case EInstructionSet::SSE2:
+				return __builtin_cpu_supports("sse2");
+			case EInstructionSet::SSSE3:
+				return __builtin_cpu_supports("ssse3");
+			case EInstructionSet::AVX2:
+				return __builtin_cpu_supports("avx2");
+	#endif
+#endif // NAP_PIXEL_X86
+#ifdef NAP_PIXEL_NEON
+			case EInstructionSet::NEON:
+				return true;
+#endif // NAP_PIXEL_NEON
+			default:
+				return false;
+			}
+		}
+
+
+		bool setInstructionSet(EInstructionSet instructionSet)
+		{
+			if (!isInstructionSetSupported(instructionSet))
+				return false;
+
+			Dispatch& dispatch = getDispatch();
+			dispatch.mInstructionSet = instructionSet;
+			dispatch.mKernels = createKernels(instructionSet);
+			return true;
+		}
+
+
+		void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha)
+		{
+			getKernels().mAddAlpha(source, target, count, alpha);
+		}
+
+
+		void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha)
+		{
+			getKernels().mAddAlphaSwapRB(source, target, count, alpha);
+		}
+
+
+		void addAlpha(const uint16* source, uint16* target, size_t count, uint16 alpha)
+		{
+			// Simple enough for the compiler to vectorize
+			for (size_t i = 0; i < count; i++, source += 3, target += 4)
+			{
+				target[0] = source[0];
+				target[1] = source[1];
+				target[2] = source[2];
+				target[3] = alpha;
+			}
+		}
+
+
+		void addAlpha(const float* source, float* target, size_t count, float alpha)
+		{
+			for (size_t i = 0; i < count; i++, source += 3, target += 4)
+			{
+				target[0] = source[0];
+				target[1] = source[1];
+				target[2] = source[2];
+				target[3] = alpha;
+			}
+		}
+
+
+		void removeAlpha(const uint8* source, uint8* target, size_t count)
+		{
+			getKernels().mRemoveAlpha(source, target, count);
+		}
+
+
+		void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count)
+		{
+			getKernels().mRemoveAlphaSwapRB(source, target, count);
+		}
+
+
+		void swapRB(const uint8* source, uint8* target, size_t count)
+		{
+			getKernels().mSwapRB(source, target, count);
+		}
+
+
+		void convert(const uint8* source, uint16* target, size_t count)
+		{
+			getKernels().mU8ToU16(source, target, count);
+		}
+
+
+		void convert(const uint16* source, uint8* target, size_t count)
+		{
+			getKernels().mU16ToU8(source, target, count);
+		}
+
+
+		void convert(const uint8* source, float* target, size_t count)
+		{
+			getKernels().mU8ToFloat(source, target, count);
+		}
+
+
+		void convert(const float* source, uint8* target, size_t count)
+		{
+			getKernels().mFloatToU8(source, target, count);
+		}
+
+
+		void convert(const uint16* source, float* target, size_t count)
+		{
+			getKernels().mU16ToFloat(source, target, count);
+		}
+
+
+		void convert(const float* source, uint16* target, size_t count)
+		{
+			getKernels().mFloatToU16(source, target, count);
+		}
+
+
+		void yuv420ToRGBA(const uint8* y, int yPitch, const uint8* u, const uint8* v, int uvPitch, uint8* target, int targetPitch, int width, int height)
+		{
+			const Kernels& kernels = getKernels();
+			for (int row = 0; row < height; row++)
+			{
+				int uv_offset = (row / 2) * uvPitch;
+				kernels.mYUVRow(y + row * yPitch, u + uv_offset, v + uv_offset, target + row * targetPitch, width);
+			}
+		}
+	}
+}
@@ -0,0 +1,171 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <nap/numeric.h>
+#include <cstddef>
+
+namespace nap
+{
+	namespace pixel
+	{
+		/**
+		 * Instruction sets the pixel conversion kernels are implemented for.
+		 * The best supported instruction set is selected on first use, based on the capabilities of the CPU.
+		 */
+		enum class EInstructionSet : int
+		{
+			Scalar		= 0,		///< Plain C++, always available
+			SSE2		= 1,		///< x86 SSE2
+			SSSE3		= 2,		///< x86 SSSE3, adds byte shuffles
+			AVX2		= 3,		///< x86 AVX2, 256 bit
+			NEON		= 4			///< ARM NEON
+		};
+
+		/**
+		 * @return the instruction set that is used by all conversion functions
+		 */
+		NAPAPI EInstructionSet getInstructionSet();
+
+		/**
+		 * @param instructionSet the instruction set to check
+		 * @return if the instruction set is supported by this CPU and build
+		 */
+		NAPAPI bool isInstructionSetSupported(EInstructionSet instructionSet);
+
+		/**
+		 * Forces the conversion functions to use a specific instruction set, used to compare and benchmark implementations.
+		 * Not thread safe: do not call while other threads are converting pixels.
+		 * @param instructionSet the instruction set to use
+		 * @return if the instruction set is supported and selected
+		 */
+		NAPAPI bool setInstructionSet(EInstructionSet instructionSet);
+
+		/**
+		 * Adds an alpha channel to 3 channel 8 bit pixels: RGB to RGBA or BGR to BGRA.
+		 * @param source 3 channel pixels
+		 * @param target 4 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 * @param alpha value of the alpha channel
+		 */
+		NAPAPI void addAlpha(const uint8* source, uint8* target, size_t count, uint8 alpha = 255);
+
+		/**
+		 * Adds an alpha channel to 3 channel 8 bit pixels and swaps red and blue: RGB to BGRA or BGR to RGBA.
+		 * @param source 3 channel pixels
+		 * @param target 4 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 * @param alpha value of the alpha channel
+		 */
+		NAPAPI void addAlphaSwapRB(const uint8* source, uint8* target, size_t count, uint8 alpha = 255);
+
+		/**
+		 * Adds an alpha channel to 3 channel 16 bit pixels: RGB to RGBA or BGR to BGRA.
+		 * @param source 3 channel pixels
+		 * @param target 4 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 * @param alpha value of the alpha channel
+		 */
+		NAPAPI void addAlpha(const uint16* source, uint16* target, size_t count, uint16 alpha = 65535);
+
+		/**
+		 * Adds an alpha channel to 3 channel float pixels: RGB to RGBA or BGR to BGRA.
+		 * @param source 3 channel pixels
+		 * @param target 4 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 * @param alpha value of the alpha channel
+		 */
+		NAPAPI void addAlpha(const float* source, float* target, size_t count, float alpha = 1.0f);
+
+		/**
+		 * Removes the alpha channel of 4 channel 8 bit pixels: RGBA to RGB or BGRA to BGR.
+		 * @param source 4 channel pixels
+		 * @param target 3 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 */
+		NAPAPI void removeAlpha(const uint8* source, uint8* target, size_t count);
+
+		/**
+		 * Removes the alpha channel of 4 channel 8 bit pixels and swaps red and blue: RGBA to BGR or BGRA to RGB.
+		 * @param source 4 channel pixels
+		 * @param target 3 channel pixels, can't overlap with source
+		 * @param count number of pixels
+		 */
+		NAPAPI void removeAlphaSwapRB(const uint8* source, uint8* target, size_t count);
+
+		/**
+		 * Swaps red and blue of 4 channel 8 bit pixels: RGBA to BGRA or BGRA to RGBA.
+		 * @param source 4 channel pixels
+		 * @param target 4 channel pixels, can be the same as source
+		 * @param count number of pixels
+		 */
+		NAPAPI void swapRB(const uint8* source, uint8* target, size_t count);
+
+		/**
+		 * Converts 8 bit values to 16 bit values, 255 maps to 65535.
+		 * @param source 8 bit values
+		 * @param target 16 bit values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const uint8* source, uint16* target, size_t count);
+
+		/**
+		 * Converts 16 bit values to 8 bit values, rounded to nearest.
+		 * @param source 16 bit values
+		 * @param target 8 bit values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const uint16* source, uint8* target, size_t count);
+
+		/**
+		 * Converts 8 bit values to normalized float values, 255 maps to 1.0
+		 * @param source 8 bit values
+		 * @param target float values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const uint8* source, float* target, size_t count);
+
+		/**
+		 * Converts normalized float values to 8 bit values, clamped to 0-1 and rounded to nearest.
+		 * @param source float values
+		 * @param target 8 bit values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const float* source, uint8* target, size_t count);
+
+		/**
+		 * Converts 16 bit values to normalized float values, 65535 maps to 1.0
+		 * @param source 16 bit values
+		 * @param target float values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const uint16* source, float* target, size_t count);
+
+		/**
+		 * Converts normalized float values to 16 bit values, clamped to 0-1 and rounded to nearest.
+		 * @param source float values
+		 * @param target 16 bit values
+		 * @param count number of values, pixels * channels
+		 */
+		NAPAPI void convert(const float* source, uint16* target, size_t count);
+
+		/**
+		 * Converts a planar YUV 4:2:0 image to RGBA8, using BT.709 coefficients in limited range.
+		 * The U and V planes are half the width and height of the Y plane, rounded up.
+		 * @param y the Y plane
+		 * @param yPitch number of bytes in a row of the Y plane
+		 * @param u the U plane
+		 * @param v the V plane
+		 * @param uvPitch number of bytes in a row of the U and V plane
+		 * @param target RGBA8 pixels
+		 * @param targetPitch number of bytes in a row of the target
+		 * @param width width of the image in pixels
+		 * @param height height of the image in pixels
+		 */
+		NAPAPI void yuv420ToRGBA(const uint8* y, int yPitch, const uint8* u, const uint8* v, int uvPitch, uint8* target, int targetPitch, int width, int height);
+	}
+}
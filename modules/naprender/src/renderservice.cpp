@@ -14,6 +14,7 @@
 #include "depthsorter.h"
 #include "vertexbuffer.h"
 #include "texture2d.h"
+#include "texturestreamer.h"
 #include "descriptorsetcache.h"
 #include "descriptorsetallocator.h"
 #include "sdlhelpers.h"
@@ -49,6 +50,10 @@ RTTI_BEGIN_CLASS(nap::RenderServiceConfiguration)
 	RTTI_PROPERTY("ShowLayers",			&nap::RenderServiceConfiguration::mPrintAvailableLayers,		nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("ShowExtensions",		&nap::RenderServiceConfiguration::mPrintAvailableExtensions,	nap::rtti::EPropertyMetaData::Default)
 	RTTI_PROPERTY("AnisotropicSamples",	&nap::RenderServiceConfiguration::mAnisotropicFilterSamples,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TextureStreamingBudget",			&nap::RenderServiceConfiguration::mTextureStreamingBudget,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TextureStreamingHostBudget",		&nap::RenderServiceConfiguration::mTextureStreamingHostBudget,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TextureStreamingUploadBudget",	&nap::RenderServiceConfiguration::mTextureStreamingUploadBudget,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TextureStreamingThreads",		&nap::RenderServiceConfiguration::mTextureStreamingThreads,			nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::RenderService)
@@ -595,6 +600,7 @@ namespace nap
 		device_features.samplerAnisotropy = physicalDevice.getFeatures().samplerAnisotropy;
 		device_features.largePoints = physicalDevice.getFeatures().largePoints;
 		device_features.wideLines = physicalDevice.getFeatures().wideLines;
+		device_features.textureCompressionBC = physicalDevice.getFeatures().textureCompressionBC;
 
 		// Device creation information	
 		VkDeviceCreateInfo create_info = { };
@@ -1064,6 +1070,7 @@ namespace nap
 	// Shut down render service
 	RenderService::~RenderService()
 	{
+		mTextureStreamer.reset();
 		mEmptyTexture.reset();
 	}
 
@@ -1295,6 +1302,8 @@ namespace nap
 		nap::Logger::info("Wide lines: %s", mWideLinesSupported ? "Supported" : "Not Supported");
 		mLargePointsSupported = mPhysicalDevice.getFeatures().largePoints > 0;
 		nap::Logger::info("Large points: %s", mLargePointsSupported ? "Supported" : "Not Supported");
+		mBlockCompressionSupported = mPhysicalDevice.getFeatures().textureCompressionBC > 0;
+		nap::Logger::info("Block compressed textures: %s", mBlockCompressionSupported ? "Supported" : "Not Supported");
 
 		// Get extensions that are required for NAP render engine to function.
 		std::vector<std::string> required_ext_names = getRequiredDeviceExtensionNames();
@@ -1359,6 +1368,15 @@ namespace nap
 				return false;
 		}
 
+		// Start streaming textures, budgets are specified in megabytes
+		const uint64 mb = 1024 * 1024;
+		nap::RenderServiceConfiguration* streaming_config = getConfiguration<RenderServiceConfiguration>();
+		mTextureStreamer = std::make_unique<TextureStreamer>(
+			static_cast<uint64>(streaming_config->mTextureStreamingBudget) * mb,
+			static_cast<uint64>(streaming_config->mTextureStreamingHostBudget) * mb,
+			static_cast<uint64>(streaming_config->mTextureStreamingUploadBudget) * mb,
+			streaming_config->mTextureStreamingThreads);
+
 		mInitialized = true;
 		return true;
 	}
@@ -1374,7 +1392,10 @@ namespace nap
 		// Now that we know the device is idle, we can destroy any currently queued vulkan objects, since they're
 		// guaranteed to no longer be in use
 		for (int frameIndex = 0; frameIndex < mFramesInFlight.size(); ++frameIndex)
+		{
+			processFrameCompletedCallbacks(frameIndex);
 			processVulkanDestructors(frameIndex);
+		}
 
 		// Since we know the device is idle at this point, we can destroy vulkan objects without going
 		// through the queue. This is reset when beginFrame is called again.
@@ -1472,6 +1493,7 @@ namespace nap
 		for (Frame& frame : mFramesInFlight)
 		{
 			assert(frame.mQueuedVulkanObjectDestructors.empty());
+			assert(frame.mFrameCompletedCallbacks.empty());
 			vkFreeCommandBuffers(mDevice, mCommandPool, 1, &frame.mHeadlessCommandBuffers);
 			vkFreeCommandBuffers(mDevice, mCommandPool, 1, &frame.mUploadCommandBuffer);
 			vkFreeCommandBuffers(mDevice, mCommandPool, 1, &frame.mDownloadCommandBuffers);
@@ -1479,6 +1501,7 @@ namespace nap
 		}
 
 		mFramesInFlight.clear();
+		mTextureStreamer.reset();
 		mEmptyTexture.reset();
 		mDescriptorSetCaches.clear();
 		mDescriptorSetAllocator.reset();
@@ -1612,6 +1635,29 @@ namespace nap
 	}
 
 
+	void RenderService::updateFrameCompletedCallbacks()
+	{
+		// Like texture downloads, callbacks of every frame that has been completed on the GPU are called, not only the ones of the current frame.
+		// The fence of the current frame is still signaled at this point, the callbacks queued on it belong to its previous cycle.
+		for (int frame_index = 0; frame_index != mFramesInFlight.size(); ++frame_index)
+		{
+			Frame& frame = mFramesInFlight[frame_index];
+			if (!frame.mFrameCompletedCallbacks.empty() && vkGetFenceStatus(mDevice, frame.mFence) == VK_SUCCESS)
+				processFrameCompletedCallbacks(frame_index);
+		}
+	}
+
+
+	void RenderService::processFrameCompletedCallbacks(int frameIndex)
+	{
+		// Callbacks are moved out first, a callback is allowed to queue new callbacks
+		FrameCompletedCallbackList callbacks;
+		callbacks.swap(mFramesInFlight[frameIndex].mFrameCompletedCallbacks);
+		for (FrameCompletedCallback& callback : callbacks)
+			callback();
+	}
+
+
 	void RenderService::processVulkanDestructors(int frameIndex)
 	{
 		for (VulkanObjectDestructor& destructor : mFramesInFlight[frameIndex].mQueuedVulkanObjectDestructors)
@@ -1643,6 +1689,10 @@ namespace nap
 		// of the fence.
 		updateTextureDownloads();
 
+		// Hand back resources that were in use by frames that have been completed. This is done before uploading,
+		// uploads of this frame queue new callbacks on the current frame.
+		updateFrameCompletedCallbacks();
+
 		// Release the DescriptorSets that were used for this frame index. This ensures that the DescriptorSets
 		// can be re-allocated as part of this frame's rendering.
 		for (auto& kvp : mDescriptorSetCaches)
@@ -1754,12 +1804,32 @@ namespace nap
 	}
 
 
+	void RenderService::queueFrameCompletedCallback(const FrameCompletedCallback& callback)
+	{
+		// Nothing is in flight when the device is idle
+		if (mCanDestroyVulkanObjectsImmediately)
+		{
+			callback();
+			return;
+		}
+
+		// Work recorded during a frame completes with the current frame, outside of a frame the last submitted frame is used
+		assert(isInitialized());
+		int frame_index = mIsRenderingFrame ? mCurrentFrameIndex : mCurrentFrameIndex - 1;
+		if (frame_index < 0)
+			frame_index = mFramesInFlight.size() - 1;
+
+		mFramesInFlight[frame_index].mFrameCompletedCallbacks.emplace_back(callback);
+	}
+
+
 	void RenderService::update(double deltaTime)
 	{
 		for (const auto& window : mWindows)
 		{
 			window->processEvents();
 		}
+		mTextureStreamer->update();
 	}
 
 
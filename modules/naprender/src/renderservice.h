@@ -29,6 +29,7 @@ namespace nap
 	class IMesh;
 	class MaterialInstance;
 	class Texture2D;
+	class TextureStreamer;
 	class GPUBuffer;
 
 	//////////////////////////////////////////////////////////////////////////
@@ -63,6 +64,10 @@ namespace nap
 		bool						mPrintAvailableLayers = false;									///< Property: 'ShowLayers' If all the available Vulkan layers are printed to console
 		bool						mPrintAvailableExtensions = false;								///< Property: 'ShowExtensions' If all the available Vulkan extensions are printed to console
 		uint32						mAnisotropicFilterSamples = 8;									///< Property: 'AnisotropicSamples' Default max number of anisotropic filter samples, can be overridden by a sampler if required.
+		uint32						mTextureStreamingBudget = 1024;									///< Property: 'TextureStreamingBudget' Max GPU memory in MB used by all streaming images.
+		uint32						mTextureStreamingHostBudget = 512;								///< Property: 'TextureStreamingHostBudget' Max memory in MB of decoded images waiting to be uploaded.
+		uint32						mTextureStreamingUploadBudget = 64;								///< Property: 'TextureStreamingUploadBudget' Max number of MB of streaming images uploaded every frame.
+		int							mTextureStreamingThreads = 2;									///< Property: 'TextureStreamingThreads' Number of threads that decode streaming images.
 		virtual rtti::TypeInfo		getServiceType() override										{ return RTTI_OF(RenderService); }
 	};
 
@@ -166,6 +171,7 @@ namespace nap
 	public:
 		using SortFunction = std::function<void(std::vector<RenderableComponentInstance*>&, const CameraComponentInstance&)>;
 		using VulkanObjectDestructor = std::function<void(RenderService&)>;
+		using FrameCompletedCallback = std::function<void()>;
 		
 		/**
 		 * Binds a pipeline and pipeline layout together.
@@ -440,6 +446,15 @@ namespace nap
 		 */
 		void queueVulkanObjectDestructor(const VulkanObjectDestructor& function);
 
+		/**
+		 * Queues a function that is called on the main thread once the GPU has completed all work of the frame.
+		 * Use this to hand back resources that are read by commands recorded in the current frame, for example
+		 * a staging buffer that is uploaded from. When called outside of a frame, the function is called once
+		 * the previously submitted frame has completed, or immediately when the device is known to be idle.
+		 * @param callback function to call when the frame has completed
+		 */
+		void queueFrameCompletedCallback(const FrameCompletedCallback& callback);
+
 		/**
 		 * Returns a descriptor set cache based on the given layout.
 		 * The cache is used to acquire descriptor sets.
@@ -558,6 +573,12 @@ namespace nap
 		 */
 		bool getLargePointsSupported() const										{ return mLargePointsSupported; }
 
+		/**
+		 * Returns if BC1-BC7 block compressed texture formats are supported.
+		 * @return if block compressed textures are supported.
+		 */
+		bool getBlockCompressionSupported() const									{ return mBlockCompressionSupported; }
+
 		/**
 		 * Returns the (system default) number of anisotropic filter samples. 
 		 * The output is always 1 when anisotropic filtering is not supported.
@@ -602,6 +623,12 @@ namespace nap
 		 */
 		Texture2D& getEmptyTexture() const											{ return *mEmptyTexture; }
 
+		/**
+		 * Returns the streamer that loads all nap::StreamingImage resources in the background.
+		 * @return the texture streamer
+		 */
+		TextureStreamer& getTextureStreamer() const									{ return *mTextureStreamer; }
+
 		/**
 		 * Returns an existing or new material for the given type of shader that can be shared.
 		 * This only works for hard coded shader types that can be initialized without input arguments.
@@ -825,6 +852,17 @@ namespace nap
 		 * Textures for which the download has completed are notified.
 		 */
 		void updateTextureDownloads();
+
+		/**
+		 * Calls the frame completed callbacks of all frames that have been completed on the GPU.
+		 */
+		void updateFrameCompletedCallbacks();
+
+		/**
+		 * Calls all frame completed callbacks of a frame.
+		 * @param frameIndex index of the frame to call the callbacks for.
+		 */
+		void processFrameCompletedCallbacks(int frameIndex);
 		
 		/**
 		 * Called by the render engine at the appropriate time to delete all queued Vulkan resources.
@@ -846,6 +884,7 @@ namespace nap
 		using TextureSet = std::unordered_set<Texture2D*>;
 		using BufferSet = std::unordered_set<GPUBuffer*>;
 		using VulkanObjectDestructorList = std::vector<VulkanObjectDestructor>;
+		using FrameCompletedCallbackList = std::vector<FrameCompletedCallback>;
 		using UniqueMaterialCache = std::unordered_map<rtti::TypeInfo, std::unique_ptr<UniqueMaterial>>;
 
 		/**
@@ -859,6 +898,7 @@ namespace nap
 			VkCommandBuffer						mDownloadCommandBuffers;			///< Command buffer used to download data from GPU to CPU
 			VkCommandBuffer						mHeadlessCommandBuffers;			///< Command buffer used to record operations not associated with a window.
 			VulkanObjectDestructorList			mQueuedVulkanObjectDestructors;		///< All Vulkan resources queued for destruction
+			FrameCompletedCallbackList			mFrameCompletedCallbacks;			///< All functions to call when the frame has been completed on the GPU
 		};
 
 		/**
@@ -879,12 +919,14 @@ namespace nap
 		bool									mAnisotropicFilteringSupported = false;
 		bool									mWideLinesSupported = false;
 		bool									mLargePointsSupported = false;
+		bool									mBlockCompressionSupported = false;
 		uint32									mAnisotropicSamples = 1;
 		WindowList								mWindows;												
 		SceneService*							mSceneService = nullptr;								
 		bool									mIsRenderingFrame = false;
 		bool									mCanDestroyVulkanObjectsImmediately = true;
 		std::unique_ptr<Texture2D>				mEmptyTexture;
+		std::unique_ptr<TextureStreamer>		mTextureStreamer;
 		TextureSet								mTexturesToUpload;
 		BufferSet								mBuffersToUpload;
 
@@ -0,0 +1,151 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "streamingimage.h"
+#include "texturestreamer.h"
+#include "renderservice.h"
+#include "bitmap.h"
+
+// External Includes
+#include <nap/core.h>
+#include <utility/fileutils.h>
+#include <FreeImage.h>
+#include <algorithm>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::StreamingImage)
+	RTTI_CONSTRUCTOR(nap::Core&)
+	RTTI_PROPERTY_FILELINK("ImagePath",		&nap::StreamingImage::mImagePath,		nap::rtti::EPropertyMetaData::Required, nap::rtti::EPropertyFileType::Image)
+	RTTI_PROPERTY("GenerateLods",			&nap::StreamingImage::mGenerateLods,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("TailSize",				&nap::StreamingImage::mTailSize,		nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+
+namespace nap
+{
+	/**
+	 * Returns the number of bytes per pixel of the texture that is created for an image of the given type, 0 if not supported.
+	 * Matches the conversion done by Bitmap::initFromFile(): color bitmaps always get an alpha channel.
+	 */
+	static int getBytesPerPixel(FREE_IMAGE_TYPE type, FREE_IMAGE_COLOR_TYPE colorType)
+	{
+		bool grey = colorType == FIC_MINISBLACK;
+		switch (type)
+		{
+		case FIT_BITMAP:
+			return grey ? 1 : 4;
+		case FIT_UINT16:
+			return 2;
+		case FIT_RGB16:
+		case FIT_RGBA16:
+			return 8;
+		case FIT_FLOAT:
+			return 4;
+		case FIT_RGBF:
+		case FIT_RGBAF:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+
+	StreamingImage::StreamingImage(Core& core) :
+		Texture2D(core)
+	{ }
+
+
+	StreamingImage::~StreamingImage()
+	{
+		if (mStreamer != nullptr)
+			mStreamer->remove(*this);
+	}
+
+
+	bool StreamingImage::init(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mUsage == ETextureUsage::Static, "%s: usage must be 'Static'", mID.c_str()))
+			return false;
+
+		if (!errorState.check(mTailSize > 0, "%s: 'TailSize' must be greater than 0", mID.c_str()))
+			return false;
+
+		if (!errorState.check(utility::fileExists(mImagePath), "%s: file does not exist: %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		// Only read the header, the pixels are decoded by the streamer
+		FREE_IMAGE_FORMAT format = FreeImage_GetFIFFromFilename(mImagePath.c_str());
+		if (!errorState.check(format != FIF_UNKNOWN, "%s: unable to determine image format of file: %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		FIBITMAP* header = FreeImage_Load(format, mImagePath.c_str(), FIF_LOAD_NOPIXELS);
+		if (!errorState.check(header != nullptr, "%s: unable to read image header: %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		mFullWidth = static_cast<int>(FreeImage_GetWidth(header));
+		mFullHeight = static_cast<int>(FreeImage_GetHeight(header));
+		mBytesPerPixel = getBytesPerPixel(FreeImage_GetImageType(header), FreeImage_GetColorType(header));
+		FreeImage_Unload(header);
+
+		if (!errorState.check(mBytesPerPixel > 0, "%s: unsupported pixel format: %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		if (!errorState.check(mFullWidth > 0 && mFullHeight > 0, "%s: invalid image size: %s", mID.c_str(), mImagePath.c_str()))
+			return false;
+
+		// The tail is the first level that fits within the tail size
+		mTailLevel = 0;
+		while (getLevelMaxSize(mTailLevel) > mTailSize)
+			mTailLevel++;
+
+		// Create placeholder, the texture is re-initialized when the tail is decoded
+		SurfaceDescriptor placeholder(1, 1, ESurfaceDataType::BYTE, ESurfaceChannels::RGBA);
+		if (!Texture2D::init(placeholder, false, EClearMode::FillWithZero, 0, errorState))
+			return false;
+		mLevel = -1;
+
+		mStreamer = &mRenderService->getTextureStreamer();
+		mStreamer->add(*this);
+		return true;
+	}
+
+
+	glm::ivec2 StreamingImage::getLevelSize(int level) const
+	{
+		return Bitmap::getScaledSize(mFullWidth, mFullHeight, getLevelMaxSize(level));
+	}
+
+
+	uint64 StreamingImage::getLevelSizeInBytes(int level) const
+	{
+		// A full mip chain adds a third
+		glm::ivec2 size = getLevelSize(level);
+		uint64 bytes = static_cast<uint64>(size.x) * static_cast<uint64>(size.y) * static_cast<uint64>(mBytesPerPixel);
+		return mGenerateLods ? bytes + bytes / 3 : bytes;
+	}
+
+
+	int StreamingImage::getLevelMaxSize(int level) const
+	{
+		return std::max(1, std::max(mFullWidth, mFullHeight) >> level);
+	}
+
+
+	bool StreamingImage::setLevel(int level, Bitmap& bitmap, utility::ErrorState& errorState)
+	{
+		// The previous image is destroyed when the GPU no longer uses it
+		release();
+		if (!Texture2D::init(bitmap.mSurfaceDescriptor, mGenerateLods, bitmap.getData(), 0, errorState))
+		{
+			mLevel = -1;
+			return false;
+		}
+
+		mLevel = level;
+		levelChanged(*this);
+		return true;
+	}
+}
@@ -0,0 +1,121 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "texture2d.h"
+
+// External Includes
+#include <nap/signalslot.h>
+#include <memory>
+
+namespace nap
+{
+	// Forward Declares
+	class Bitmap;
+	class TextureStreamer;
+
+	/**
+	 * 2D image that is loaded from disk in the background, at a resolution that depends on use and available memory.
+	 * Use this instead of a nap::ImageFromFile for large collections of (high resolution) images,
+	 * initialization only reads the image header and never blocks on decoding the image.
+	 *
+	 * The image is streamed by the nap::TextureStreamer of the render service, in levels: level 0 is the full resolution,
+	 * every next level halves the width and height. Directly after initialization the texture is 1x1 and transparent black.
+	 * The streamer first loads the 'tail': the level where the largest side is at most 'TailSize' pixels, which is kept in memory.
+	 * When the image is bound to a material instance, the highest level that fits within the GPU memory budget is streamed in.
+	 * Under memory pressure, images that are no longer bound are evicted back to their tail.
+	 *
+	 * The size of the texture and its Vulkan image change when a different level becomes resident, listen to 'levelChanged' to be notified.
+	 * Material instances bind the current image automatically, use getFullWidth() and getFullHeight() for the size of the image on disk.
+	 * Displaying a streaming image using the IMGui service is not supported, it caches the image of a texture.
+	 * The texture usage must be 'Static'.
+	 */
+	class NAPAPI StreamingImage : public Texture2D
+	{
+		friend class TextureStreamer;
+		RTTI_ENABLE(Texture2D)
+	public:
+		/**
+		 * @param core the core instance
+		 */
+		StreamingImage(Core& core);
+
+		/**
+		 * Stops streaming the image
+		 */
+		virtual ~StreamingImage();
+
+		/**
+		 * Reads the image header, creates the placeholder texture and starts streaming the image.
+		 * @param errorState contains the error when initialization fails
+		 * @return if initialization succeeded
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * @return width of the image on disk in pixels
+		 */
+		int getFullWidth() const									{ return mFullWidth; }
+
+		/**
+		 * @return height of the image on disk in pixels
+		 */
+		int getFullHeight() const									{ return mFullHeight; }
+
+		/**
+		 * @return the resident level, 0 is full resolution, -1 when only the placeholder is resident
+		 */
+		int getLevel() const										{ return mLevel; }
+
+		/**
+		 * @return the lowest resolution level that is loaded, the largest side is at most 'TailSize' pixels
+		 */
+		int getTailLevel() const									{ return mTailLevel; }
+
+		/**
+		 * @return if the image is resident at full resolution
+		 */
+		bool isFullResolution() const								{ return mLevel == 0; }
+
+		/**
+		 * @param level the level, 0 is full resolution
+		 * @return size of the given level in pixels
+		 */
+		glm::ivec2 getLevelSize(int level) const;
+
+		/**
+		 * @param level the level, 0 is full resolution
+		 * @return number of bytes of GPU memory the given level occupies, including mip-maps
+		 */
+		uint64 getLevelSizeInBytes(int level) const;
+
+		nap::Signal<StreamingImage&> levelChanged;					///< Called on the main thread when a different level became resident
+
+		std::string		mImagePath;									///< Property: 'ImagePath' Path to the image on disk to stream
+		bool			mGenerateLods = true;						///< Property: 'GenerateLods' If LODs are generated for every level
+		int				mTailSize = 256;							///< Property: 'TailSize' Max width or height in pixels of the lowest resolution, which is always in memory
+
+	private:
+		/**
+		 * Re-initializes the texture with the pixels of a decoded level, called by the streamer.
+		 */
+		bool setLevel(int level, Bitmap& bitmap, utility::ErrorState& errorState);
+
+		/**
+		 * @return max width or height of the given level
+		 */
+		int getLevelMaxSize(int level) const;
+
+		TextureStreamer*			mStreamer = nullptr;			///< Streamer this image is added to
+		uint64						mStreamID = 0;					///< ID of this image in the streamer
+		std::unique_ptr<Bitmap>		mTail;							///< Decoded tail, uploaded again when the image is evicted
+		int							mFullWidth = 0;					///< Width of the image on disk
+		int							mFullHeight = 0;				///< Height of the image on disk
+		int							mBytesPerPixel = 4;				///< Bytes per pixel of the texture
+		int							mTailLevel = 0;					///< Level of the tail
+		int							mLevel = -1;					///< Resident level, -1 = placeholder
+	};
+}
@@ -7,6 +7,7 @@
 #include "bitmap.h"
 #include "renderservice.h"
 #include "copyimagedata.h"
+#include "compressedtexture.h"
 
 // External Includes
 #include <nap/core.h>
@@ -30,10 +31,10 @@ namespace nap
 	// Static
 	//////////////////////////////////////////////////////////////////////////
 
-	static void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+	static void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, VkImage image, uint32_t width, uint32_t height)
 	{
 		VkBufferImageCopy region = {};
-		region.bufferOffset = 0;
+		region.bufferOffset = offset;
 		region.bufferRowLength = 0;
 		region.bufferImageHeight = 0;
 		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -124,6 +125,30 @@ namespace nap
 	}
 
 
+	static VkFormat getCompressedTextureFormat(EBlockFormat format, EColorSpace colorSpace)
+	{
+		bool srgb = colorSpace == EColorSpace::sRGB;
+		switch (format)
+		{
+			case EBlockFormat::BC1:
+				return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+			case EBlockFormat::BC1A:
+				return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+			case EBlockFormat::BC3:
+				return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+			case EBlockFormat::BC4:
+				return VK_FORMAT_BC4_UNORM_BLOCK;
+			case EBlockFormat::BC5:
+				return VK_FORMAT_BC5_UNORM_BLOCK;
+			case EBlockFormat::BC7:
+				return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			default:
+				assert(false);
+		}
+		return VK_FORMAT_UNDEFINED;
+	}
+
+
 	static int getNumStagingBuffers(int inMaxFramesInFlight, ETextureUsage textureUsage)
 	{
 		switch (textureUsage)
@@ -255,10 +280,17 @@ namespace nap
 
 	Texture2D::~Texture2D()
 	{	
+		release();
+	}
+
+
+	void Texture2D::release()
+	{
 		// Remove all previously made requests and queue buffers for destruction.
 		// If the service is not running, all objects are destroyed immediately.
 		// Otherwise they are destroyed when they are guaranteed not to be in use by the GPU.
 		mRenderService->removeTextureRequests(*this);
+		releaseExternalStagingBuffer();
 		mRenderService->queueVulkanObjectDestructor([imageData = mImageData, stagingBuffers = mStagingBuffers](RenderService& renderService)
 		{
 			destroyImageAndView(imageData, renderService.getDevice(), renderService.getVulkanAllocator());
@@ -267,6 +299,22 @@ namespace nap
 				destroyBuffer(renderService.getVulkanAllocator(), buffer);
 			}
 		});
+
+		// Reset, allows the texture to be initialized again
+		mImageData = ImageData();
+		mStagingBuffers.clear();
+		mReadCallbacks.clear();
+		mCurrentStagingBufferIndex = -1;
+		mMipLevels = 1;
+		mCompressedRegions.clear();
+	}
+
+
+	bool Texture2D::checkAndResetBound()
+	{
+		bool bound = mBound;
+		mBound = false;
+		return bound;
 	}
 
 
@@ -338,8 +386,13 @@ namespace nap
 				VMA_MEMORY_USAGE_GPU_TO_CPU : 
 				VMA_MEMORY_USAGE_CPU_TO_GPU;
 
+			// When written frequently, the buffer is mapped once and stays mapped for the lifetime of the texture
+			VmaAllocationCreateFlags allocation_flags = mUsage == ETextureUsage::DynamicWrite ? 
+				VMA_ALLOCATION_CREATE_MAPPED_BIT : 
+				0;
+
 			// Create staging buffer
-			if (!createBuffer(vulkan_allocator, mImageSizeInBytes, buffer_usage, memory_usage, 0, staging_buffer, errorState))
+			if (!createBuffer(vulkan_allocator, mImageSizeInBytes, buffer_usage, memory_usage, allocation_flags, staging_buffer, errorState))
 			{
 				errorState.fail("%s: Unable to create staging buffer for texture", mID.c_str());
 				return false;
@@ -411,6 +464,79 @@ namespace nap
 	}
 
 
+	bool Texture2D::init(const CompressedTextureData& data, utility::ErrorState& errorState)
+	{
+		// Compressed textures are uploaded once and never read back
+		if (!errorState.check(mUsage == ETextureUsage::Static, "%s: usage of a compressed texture must be 'Static'", mID.c_str()))
+			return false;
+
+		if (!errorState.check(!data.mLevels.empty(), "%s: compressed texture has no mip levels", mID.c_str()))
+			return false;
+
+		// Ensure the GPU can sample the format
+		mFormat = getCompressedTextureFormat(data.mFormat, data.mColorSpace);
+		VkFormatProperties format_properties;
+		mRenderService->getFormatProperties(mFormat, format_properties);
+		VkFormatFeatureFlags required_features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+		if (!errorState.check(mRenderService->getBlockCompressionSupported() && (format_properties.optimalTilingFeatures & required_features) == required_features,
+			"%s: block compressed texture format is not supported by the GPU", mID.c_str()))
+			return false;
+
+		// Single staging buffer that holds all levels, destroyed after upload
+		VmaAllocator vulkan_allocator = mRenderService->getVulkanAllocator();
+		mImageSizeInBytes = data.mData.size();
+		mStagingBuffers.resize(1);
+		if (!createBuffer(vulkan_allocator, mImageSizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, 0, mStagingBuffers[0], errorState))
+		{
+			errorState.fail("%s: Unable to create staging buffer for texture", mID.c_str());
+			return false;
+		}
+
+		// Create GPU image and view, mip levels are uploaded instead of generated
+		mMipLevels = static_cast<uint32>(data.mLevels.size());
+		if (!create2DImage(vulkan_allocator, data.mWidth, data.mHeight, mFormat, mMipLevels,
+			VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY, 
+			mImageData.mTextureImage, mImageData.mTextureAllocation, mImageData.mTextureAllocationInfo, errorState))
+			return false;
+
+		if (!create2DImageView(mRenderService->getDevice(), mImageData.mTextureImage, mFormat, mMipLevels, VK_IMAGE_ASPECT_COLOR_BIT, mImageData.mTextureView, errorState))
+			return false;
+
+		// Copy region of every level
+		mCompressedRegions.resize(data.mLevels.size());
+		for (int level = 0; level < data.mLevels.size(); level++)
+		{
+			const CompressedMipLevel& mip = data.mLevels[level];
+			VkBufferImageCopy& region = mCompressedRegions[level];
+			region = {};
+			region.bufferOffset = mip.mOffset;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = static_cast<uint32>(level);
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { mip.mWidth, mip.mHeight, 1 };
+		}
+
+		mCurrentStagingBufferIndex = 0;
+		mDescriptor = SurfaceDescriptor(data.mWidth, data.mHeight, ESurfaceDataType::BYTE, 
+			data.mFormat == EBlockFormat::BC4 ? ESurfaceChannels::R : ESurfaceChannels::RGBA, data.mColorSpace);
+
+		// Copy the blocks into the staging buffer
+		BufferData& buffer = mStagingBuffers[0];
+		void* mapped_memory = nullptr;
+		VkResult result = vmaMapMemory(vulkan_allocator, buffer.mAllocation, &mapped_memory);
+		if (!errorState.check(result == VK_SUCCESS, "%s: Unable to map staging buffer", mID.c_str()))
+			return false;
+		memcpy(mapped_memory, data.mData.data(), data.mData.size());
+		vmaUnmapMemory(vulkan_allocator, buffer.mAllocation);
+
+		// Notify the RenderService that it should upload the texture contents during rendering
+		mRenderService->requestTextureUpload(*this);
+		return true;
+	}
+
+
 	const glm::vec2 Texture2D::getSize() const
 	{
 		return glm::vec2(getWidth(), getHeight());
@@ -437,10 +563,17 @@ namespace nap
 
 	void Texture2D::upload(VkCommandBuffer commandBuffer)
 	{
-		assert(mCurrentStagingBufferIndex != -1);
-		BufferData& buffer = mStagingBuffers[mCurrentStagingBufferIndex];
-		assert(buffer.mAllocation != VK_NULL_HANDLE);
-		mCurrentStagingBufferIndex = (mCurrentStagingBufferIndex + 1) % mStagingBuffers.size();
+		// Copy from the external staging buffer if one is provided, otherwise from the current internal staging buffer
+		VkBuffer source_buffer = mExternalStagingBuffer;
+		VkDeviceSize source_offset = mExternalStagingOffset;
+		bool external = source_buffer != VK_NULL_HANDLE;
+		if (!external)
+		{
+			assert(mCurrentStagingBufferIndex != -1);
+			assert(mStagingBuffers[mCurrentStagingBufferIndex].mAllocation != VK_NULL_HANDLE);
+			source_buffer = mStagingBuffers[mCurrentStagingBufferIndex].mBuffer;
+			source_offset = 0;
+		}
 		
 		VkAccessFlags srcMask = 0;
 		VkAccessFlags dstMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -460,11 +593,19 @@ namespace nap
 			srcStage,	dstStage,
 			0,			mMipLevels);
 		
-		// Copy staging buffer to image
-		copyBufferToImage(commandBuffer, buffer.mBuffer, mImageData.mTextureImage, mDescriptor.mWidth, mDescriptor.mHeight);
+		// Copy staging buffer to image, compressed textures copy all mip levels at once
+		if (isCompressed())
+		{
+			vkCmdCopyBufferToImage(commandBuffer, source_buffer, mImageData.mTextureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
+				static_cast<uint32>(mCompressedRegions.size()), mCompressedRegions.data());
+		}
+		else
+		{
+			copyBufferToImage(commandBuffer, source_buffer, source_offset, mImageData.mTextureImage, mDescriptor.mWidth, mDescriptor.mHeight);
+		}
 		
 		// Generate mip maps, if we do that we don't have to transition the image layout anymore, this is handled by createMipmaps.
-		if (mMipLevels > 1)
+		if (mMipLevels > 1 && !isCompressed())
 		{
 			createMipmaps(commandBuffer, mImageData.mTextureImage, mFormat, mDescriptor.mWidth, mDescriptor.mHeight, mMipLevels);
 		}
@@ -474,12 +615,26 @@ namespace nap
 				VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,	VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
 				VK_ACCESS_TRANSFER_WRITE_BIT,			VK_ACCESS_SHADER_READ_BIT,
 				VK_PIPELINE_STAGE_TRANSFER_BIT,			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-				0,										1);
+				0,										mMipLevels);
 		}
 
 		// We store the last image layout, which is used as input for a subsequent upload
 		mImageData.mCurrentLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
+		// The owner of an external staging buffer is notified when the GPU has finished this frame, the internal staging buffers are left untouched.
+		if (external)
+		{
+			std::function<void()> upload_finished = mExternalUploadFinished;
+			mExternalStagingBuffer = VK_NULL_HANDLE;
+			mExternalUploadFinished = nullptr;
+			if (upload_finished)
+				mRenderService->queueFrameCompletedCallback(upload_finished);
+			return;
+		}
+
+		BufferData& buffer = mStagingBuffers[mCurrentStagingBufferIndex];
+		mCurrentStagingBufferIndex = (mCurrentStagingBufferIndex + 1) % mStagingBuffers.size();
+
 		// Destroy staging buffer when usage is static
 		// This queues the vulkan staging resource for destruction, executed by the render service at the appropriate time.
 		// Explicitly release the handle, so it's not deleted twice.
@@ -531,34 +686,80 @@ namespace nap
 		// We can only upload when the texture usage is dynamic, OR this is the first upload for a static texture
 		assert(mUsage == ETextureUsage::DynamicWrite || mImageData.mCurrentLayout == VK_IMAGE_LAYOUT_UNDEFINED);
 		assert(mDescriptor.mWidth == width && mDescriptor.mHeight == height);
+		assert(!isCompressed());
 
 		// We use a staging buffer that is guaranteed to be free
 		assert(mCurrentStagingBufferIndex != -1);
 		BufferData& buffer = mStagingBuffers[mCurrentStagingBufferIndex];
 
+		// Uploading from the internal staging buffer replaces a pending upload from an external buffer
+		releaseExternalStagingBuffer();
+
 		// Update the staging buffer using the Bitmap contents
 		VmaAllocator vulkan_allocator = mRenderService->getVulkanAllocator();
 
 		// Map memory and copy contents, note for this to work on OSX the VK_MEMORY_PROPERTY_HOST_COHERENT_BIT is required!
-		void* mapped_memory = nullptr;
-		VkResult result = vmaMapMemory(vulkan_allocator, buffer.mAllocation, &mapped_memory);
-		assert(result == VK_SUCCESS);
+		// Staging buffers of dynamic textures are persistently mapped, others are only mapped while copying.
+		void* mapped_memory = buffer.mAllocationInfo.pMappedData;
+		bool persistent = mapped_memory != nullptr;
+		if (!persistent)
+		{
+			VkResult result = vmaMapMemory(vulkan_allocator, buffer.mAllocation, &mapped_memory);
+			assert(result == VK_SUCCESS);
+		}
 		copyImageData((const uint8_t*)data, pitch, channels, (uint8_t*)mapped_memory, mDescriptor.getPitch(), mDescriptor.mChannels, mDescriptor.mWidth, mDescriptor.mHeight);
-		vmaUnmapMemory(vulkan_allocator, buffer.mAllocation);
+		if (!persistent)
+			vmaUnmapMemory(vulkan_allocator, buffer.mAllocation);
+
+		// Notify the RenderService that it should upload the texture contents during rendering
+		mRenderService->requestTextureUpload(*this);
+	}
+
+
+	void Texture2D::update(VkBuffer buffer, VkDeviceSize offset, const std::function<void()>& uploadFinished)
+	{
+		// We can only upload when the texture usage is dynamic, OR this is the first upload for a static texture
+		assert(mUsage == ETextureUsage::DynamicWrite || mImageData.mCurrentLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+		assert(buffer != VK_NULL_HANDLE);
+		assert(!isCompressed());
+
+		// A pending upload that hasn't been recorded yet never reads from its buffer, so it can be released immediately
+		releaseExternalStagingBuffer();
+		mExternalStagingBuffer = buffer;
+		mExternalStagingOffset = offset;
+		mExternalUploadFinished = uploadFinished;
 
 		// Notify the RenderService that it should upload the texture contents during rendering
 		mRenderService->requestTextureUpload(*this);
 	}
 
 
+	void Texture2D::releaseExternalStagingBuffer()
+	{
+		std::function<void()> upload_finished = mExternalUploadFinished;
+		mExternalStagingBuffer = VK_NULL_HANDLE;
+		mExternalStagingOffset = 0;
+		mExternalUploadFinished = nullptr;
+		if (upload_finished)
+			upload_finished();
+	}
+
+
 	void Texture2D::asyncGetData(Bitmap& bitmap)
 	{
- 		assert(!mReadCallbacks[mRenderService->getCurrentFrameIndex()]);
- 		mReadCallbacks[mRenderService->getCurrentFrameIndex()] = [this, &bitmap](const void* data, size_t sizeInBytes)
+ 		asyncGetData([this, &bitmap](const void* data, size_t sizeInBytes)
 		{
  			bitmap.initFromDescriptor(mDescriptor);
  			memcpy(bitmap.getData(), data, sizeInBytes);
- 		};
+ 		});
+	}
+
+
+	void Texture2D::asyncGetData(const std::function<void(const void* data, size_t sizeInBytes)>& copyFunction)
+	{
+		assert(mUsage == ETextureUsage::DynamicRead);
+ 		assert(!mReadCallbacks[mRenderService->getCurrentFrameIndex()]);
+ 		mReadCallbacks[mRenderService->getCurrentFrameIndex()] = copyFunction;
  		mRenderService->requestTextureDownload(*this);	
 	}
 
@@ -22,6 +22,7 @@ namespace nap
 	class Bitmap;
 	class RenderService;
 	class Core;
+	struct CompressedTextureData;
 
 	/**
 	 * Flag that determines how the texture is used at runtime.
@@ -43,6 +44,7 @@ namespace nap
 	class NAPAPI Texture2D : public Resource
 	{
 		friend class RenderService;
+		friend class MaterialInstance;
 		RTTI_ENABLE(Resource)
 	public:
 		Texture2D(Core& core);
@@ -83,6 +85,21 @@ namespace nap
 		 */
 		bool init(const SurfaceDescriptor& descriptor, bool generateMipMaps, void* initialData, VkImageUsageFlags requiredFlags, utility::ErrorState& errorState);
 
+		/**
+		 * Creates a block compressed texture on the GPU and immediately requests a content upload of all mip levels.
+		 * The blocks are uploaded as is, there is no decoding on the CPU. Requires texture usage to be 'Static'.
+		 * The descriptor of the texture is 8 bit RGBA (R for BC4), in the color space of the data, but can't be used to read back the texture.
+		 * @param data the compressed image, including all mip levels to upload.
+		 * @param errorState contains the error if the texture can't be initialized.
+		 * @return if the texture initialized successfully.
+		 */
+		bool init(const CompressedTextureData& data, utility::ErrorState& errorState);
+
+		/**
+		 * @return if the texture is block compressed
+		 */
+		bool isCompressed() const							{ return !mCompressedRegions.empty(); }
+
 		/**
 		 * @return size of the texture in texels.
 		 */
@@ -122,6 +139,19 @@ namespace nap
 		 */
 		void update(const void* data, const SurfaceDescriptor& surfaceDescriptor);
 
+		/**
+		 * Uploads the contents of a staging buffer that is owned by the caller, without copying the data on the CPU.
+		 * Use this when the texel data is already written into host visible memory, for example by a decode thread.
+		 * The buffer must contain tightly packed texel data that matches the texture description, starting at the given offset.
+		 * The buffer can not be modified until 'uploadFinished' is called, which happens on the main thread once the GPU has finished reading from it,
+		 * or immediately when the request is replaced by another call to update() before the upload took place.
+		 * Note that you can only update the contents of a texture once if 'Usage' is 'DynamicRead' or 'Static'.
+		 * @param buffer host visible staging buffer created with VK_BUFFER_USAGE_TRANSFER_SRC_BIT.
+		 * @param offset offset in bytes of the texel data within the buffer.
+		 * @param uploadFinished called when the buffer is no longer used by this texture, can be empty.
+		 */
+		void update(VkBuffer buffer, VkDeviceSize offset, const std::function<void()>& uploadFinished);
+
 		/**
 		 * @return Vulkan texture format
 		 */
@@ -149,6 +179,15 @@ namespace nap
 		 */
 		void asyncGetData(Bitmap& bitmap);
 
+		/**
+		 * Starts a transfer of texture data from GPU to CPU.
+		 * This is a non blocking call. When the transfer completes, the copy function is called with the texture data.
+		 * The data is only valid for the duration of the call, copy it when required later.
+		 * Note that the texture usage must be 'DynamicRead' and a download can only be started once per frame.
+		 * @param copyFunction called on the main thread with the texture data when the transfer completes.
+		 */
+		void asyncGetData(const std::function<void(const void* data, size_t sizeInBytes)>& copyFunction);
+
 		ETextureUsage mUsage = ETextureUsage::Static;		///< Property: 'Usage' If this texture is updated frequently or considered static.
 
 	private:
@@ -171,11 +210,30 @@ namespace nap
         using Resource::init;
 
 	protected:
+		/**
+		 * Destroys the GPU image and staging buffers when they are no longer in use by the GPU, and cancels pending requests.
+		 * The texture can be initialized again afterwards, used by textures that change resolution at runtime.
+		 * Material instances pick up the new image view of a re-initialized texture the next time they are updated.
+		 */
+		void release();
+
+		/**
+		 * Returns if the texture was bound to a material instance since the last call, and resets the flag.
+		 * Used to find textures that are no longer in use.
+		 * @return if the texture was bound since the last call
+		 */
+		bool checkAndResetBound();
+
 		RenderService*						mRenderService = nullptr;
 
 	private:
 		using TextureReadCallback = std::function<void(void* data, size_t sizeInBytes)>;
 
+		/**
+		 * Notifies the owner of a pending external staging buffer that it is no longer used and clears the request.
+		 */
+		void releaseExternalStagingBuffer();
+
 		ImageData							mImageData;							///< 2D Texture vulkan image buffers
 		std::vector<BufferData>				mStagingBuffers;					///< All vulkan staging buffers, 1 when static or using dynamic read, no. of frames in flight when dynamic write.
 		int									mCurrentStagingBufferIndex = -1;	///< Currently used staging buffer
@@ -184,5 +242,10 @@ namespace nap
 		VkFormat							mFormat = VK_FORMAT_UNDEFINED;		///< Vulkan texture format
 		std::vector<TextureReadCallback>	mReadCallbacks;						///< Number of callbacks based on number of frames in flight
 		uint32								mMipLevels = 1;						///< Total number of generated mip-maps
+		VkBuffer							mExternalStagingBuffer = VK_NULL_HANDLE;	///< Staging buffer owned by the client to upload from, null when uploading from the internal staging buffers
+		VkDeviceSize						mExternalStagingOffset = 0;			///< Offset of the texel data in the external staging buffer
+		std::function<void()>				mExternalUploadFinished;			///< Called when the GPU has finished reading from the external staging buffer
+		mutable bool						mBound = false;						///< Set by material instances when the texture is bound, see checkAndResetBound()
+		std::vector<VkBufferImageCopy>		mCompressedRegions;					///< Staging buffer region of every mip level of a block compressed texture, empty when not compressed
 	};
 }
\ No newline at end of file
@@ -0,0 +1,337 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "texturestreamer.h"
+#include "streamingimage.h"
+#include "bitmap.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <algorithm>
+
+namespace nap
+{
+	TextureStreamer::TextureStreamer(uint64 gpuBudget, uint64 hostBudget, uint64 uploadBudget, int threadCount) :
+		mGPUBudget(gpuBudget),
+		mHostBudget(hostBudget),
+		mUploadBudget(uploadBudget)
+	{
+		int count = std::max(1, threadCount);
+		for (int i = 0; i < count; i++)
+			mThreads.emplace_back(&TextureStreamer::decodeThread, this);
+	}
+
+
+	TextureStreamer::~TextureStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mCondition.notify_all();
+		for (auto& thread : mThreads)
+			thread.join();
+
+		// Images that outlive the streamer should not remove themselves
+		for (auto& it : mEntries)
+			it.second.mImage->mStreamer = nullptr;
+	}
+
+
+	void TextureStreamer::add(StreamingImage& image)
+	{
+		uint64 id = mNextID++;
+		image.mStreamID = id;
+
+		Entry& entry = mEntries[id];
+		entry.mImage = &image;
+		entry.mLastUsedFrame = mFrame;
+		queueJob(id, entry, image.mTailLevel);
+	}
+
+
+	void TextureStreamer::remove(StreamingImage& image)
+	{
+		auto it = mEntries.find(image.mStreamID);
+		if (it == mEntries.end())
+			return;
+
+		if (image.mLevel >= 0)
+			mGPUMemoryUsage -= image.getLevelSizeInBytes(image.mLevel);
+		mEntries.erase(it);
+
+		// Discard queued jobs, results that are being decoded are dropped in update()
+		uint64 id = image.mStreamID;
+		auto discard = [this, id](std::deque<Job>& jobs)
+		{
+			for (auto job = jobs.begin(); job != jobs.end();)
+			{
+				if (job->mID != id)
+				{
+					++job;
+					continue;
+				}
+				mHostMemoryUsage -= job->mSizeInBytes;
+				job = jobs.erase(job);
+			}
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			discard(mTailJobs);
+			discard(mLevelJobs);
+		}
+
+		for (auto result = mDecoded.begin(); result != mDecoded.end();)
+		{
+			if (result->mJob.mID != id)
+			{
+				++result;
+				continue;
+			}
+			mHostMemoryUsage -= result->mJob.mSizeInBytes;
+			result = mDecoded.erase(result);
+		}
+
+		image.mStreamer = nullptr;
+		image.mStreamID = 0;
+	}
+
+
+	void TextureStreamer::update()
+	{
+		mFrame++;
+
+		// Mark images that were bound since the last update
+		for (auto& it : mEntries)
+		{
+			if (it.second.mImage->checkAndResetBound())
+				it.second.mLastUsedFrame = mFrame;
+		}
+
+		// Collect decoded levels
+		std::vector<Result> results;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			results.swap(mResults);
+		}
+
+		for (auto& result : results)
+		{
+			auto it = mEntries.find(result.mJob.mID);
+			if (it == mEntries.end())
+			{
+				mHostMemoryUsage -= result.mJob.mSizeInBytes;
+				continue;
+			}
+
+			Entry& entry = it->second;
+			StreamingImage& image = *entry.mImage;
+			if (result.mBitmap == nullptr)
+			{
+				nap::Logger::warn("%s: unable to stream image: %s", image.mID.c_str(), result.mError.c_str());
+				mHostMemoryUsage -= result.mJob.mSizeInBytes;
+				entry.mPendingLevel = -1;
+				entry.mFailed = true;
+				continue;
+			}
+
+			// The tail is kept in memory and shown immediately
+			if (result.mJob.mLevel == image.mTailLevel)
+			{
+				mHostMemoryUsage -= result.mJob.mSizeInBytes;
+				entry.mPendingLevel = -1;
+				image.mTail = std::move(result.mBitmap);
+				if (image.mLevel < 0)
+					setLevel(entry, image.mTailLevel, *image.mTail);
+				continue;
+			}
+			mDecoded.emplace_back(std::move(result));
+		}
+
+		// Upload decoded levels within the upload budget, at least one level is uploaded every frame
+		uint64 uploaded = 0;
+		while (!mDecoded.empty() && (uploaded == 0 || uploaded < mUploadBudget))
+		{
+			Result result = std::move(mDecoded.front());
+			mDecoded.pop_front();
+			mHostMemoryUsage -= result.mJob.mSizeInBytes;
+
+			auto it = mEntries.find(result.mJob.mID);
+			if (it == mEntries.end())
+				continue;
+
+			Entry& entry = it->second;
+			entry.mPendingLevel = -1;
+			if (entry.mImage->mLevel >= 0 && result.mJob.mLevel >= entry.mImage->mLevel)
+				continue;
+
+			if (upload(entry, result))
+				uploaded += entry.mImage->getLevelSizeInBytes(result.mJob.mLevel);
+		}
+
+		// Find memory that is in use by images that can't be evicted, and memory that is claimed by pending levels
+		uint64 evictable = 0;
+		uint64 claimed = 0;
+		for (auto& it : mEntries)
+		{
+			const Entry& entry = it.second;
+			const StreamingImage& image = *entry.mImage;
+			if (image.mLevel < 0)
+				continue;
+
+			uint64 current = image.getLevelSizeInBytes(image.mLevel);
+			if (entry.mLastUsedFrame < mFrame && image.mLevel < image.mTailLevel)
+				evictable += current - image.getLevelSizeInBytes(image.mTailLevel);
+
+			if (entry.mPendingLevel >= 0 && entry.mPendingLevel < image.mLevel)
+				claimed += image.getLevelSizeInBytes(entry.mPendingLevel) - current;
+		}
+		uint64 pinned = mGPUMemoryUsage > evictable ? mGPUMemoryUsage - evictable : 0;
+
+		// Stream in higher resolution levels of images that are in use
+		for (auto& it : mEntries)
+		{
+			Entry& entry = it.second;
+			StreamingImage& image = *entry.mImage;
+			if (entry.mFailed || entry.mPendingLevel >= 0 || entry.mLastUsedFrame != mFrame || image.mLevel <= 0)
+				continue;
+
+			uint64 current = image.getLevelSizeInBytes(image.mLevel);
+			uint64 used = pinned + claimed;
+			uint64 available = used < mGPUBudget ? mGPUBudget - used : 0;
+
+			// Highest resolution that fits
+			int level = 0;
+			while (level < image.mLevel && image.getLevelSizeInBytes(level) - current > available)
+				level++;
+			if (level == image.mLevel)
+				continue;
+
+			// Never block when nothing is waiting, a single level can exceed the host budget
+			glm::ivec2 size = image.getLevelSize(level);
+			uint64 decoded_size = static_cast<uint64>(size.x) * static_cast<uint64>(size.y) * static_cast<uint64>(image.mBytesPerPixel);
+			if (mHostMemoryUsage > 0 && mHostMemoryUsage + decoded_size > mHostBudget)
+				break;
+
+			claimed += image.getLevelSizeInBytes(level) - current;
+			queueJob(it.first, entry, level);
+		}
+	}
+
+
+	void TextureStreamer::decodeThread()
+	{
+		while (true)
+		{
+			Job job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this]() { return mStop || !mTailJobs.empty() || !mLevelJobs.empty(); });
+				if (mStop)
+					return;
+
+				// Tails first, so every image is visible as soon as possible
+				std::deque<Job>& jobs = !mTailJobs.empty() ? mTailJobs : mLevelJobs;
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+
+			Result result;
+			utility::ErrorState error_state;
+			auto bitmap = std::make_unique<Bitmap>();
+			if (bitmap->initFromFile(job.mPath, job.mMaxSize, error_state))
+				result.mBitmap = std::move(bitmap);
+			else
+				result.mError = error_state.toString();
+			result.mJob = std::move(job);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mResults.emplace_back(std::move(result));
+		}
+	}
+
+
+	void TextureStreamer::queueJob(uint64 id, Entry& entry, int level)
+	{
+		const StreamingImage& image = *entry.mImage;
+		glm::ivec2 size = image.getLevelSize(level);
+
+		Job job;
+		job.mID = id;
+		job.mPath = image.mImagePath;
+		job.mLevel = level;
+		job.mMaxSize = image.getLevelMaxSize(level);
+		job.mSizeInBytes = static_cast<uint64>(size.x) * static_cast<uint64>(size.y) * static_cast<uint64>(image.mBytesPerPixel);
+
+		entry.mPendingLevel = level;
+		mHostMemoryUsage += job.mSizeInBytes;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (level == image.mTailLevel)
+				mTailJobs.emplace_back(std::move(job));
+			else
+				mLevelJobs.emplace_back(std::move(job));
+		}
+		mCondition.notify_one();
+	}
+
+
+	bool TextureStreamer::upload(Entry& entry, Result& result)
+	{
+		const StreamingImage& image = *entry.mImage;
+		uint64 current = image.mLevel >= 0 ? image.getLevelSizeInBytes(image.mLevel) : 0;
+		uint64 required = image.getLevelSizeInBytes(result.mJob.mLevel);
+		if (required > current && !makeAvailable(required - current, entry))
+			return false;
+		return setLevel(entry, result.mJob.mLevel, *result.mBitmap);
+	}
+
+
+	bool TextureStreamer::makeAvailable(uint64 sizeInBytes, const Entry& requester)
+	{
+		if (mGPUMemoryUsage + sizeInBytes <= mGPUBudget)
+			return true;
+
+		// Images that were not used this frame and are above their tail, least recently used first
+		std::vector<Entry*> candidates;
+		for (auto& it : mEntries)
+		{
+			Entry& entry = it.second;
+			const StreamingImage& image = *entry.mImage;
+			if (&entry != &requester && entry.mLastUsedFrame < mFrame && image.mLevel >= 0 && image.mLevel < image.mTailLevel && image.mTail != nullptr)
+				candidates.emplace_back(&entry);
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) { return a->mLastUsedFrame < b->mLastUsedFrame; });
+
+		for (Entry* entry : candidates)
+		{
+			StreamingImage& image = *entry->mImage;
+			setLevel(*entry, image.mTailLevel, *image.mTail);
+			if (mGPUMemoryUsage + sizeInBytes <= mGPUBudget)
+				return true;
+		}
+		return false;
+	}
+
+
+	bool TextureStreamer::setLevel(Entry& entry, int level, Bitmap& bitmap)
+	{
+		StreamingImage& image = *entry.mImage;
+		if (image.mLevel >= 0)
+			mGPUMemoryUsage -= image.getLevelSizeInBytes(image.mLevel);
+
+		utility::ErrorState error_state;
+		if (!image.setLevel(level, bitmap, error_state))
+		{
+			nap::Logger::warn("%s: unable to upload level %d: %s", image.mID.c_str(), level, error_state.toString().c_str());
+			entry.mFailed = true;
+			return false;
+		}
+
+		mGPUMemoryUsage += image.getLevelSizeInBytes(level);
+		return true;
+	}
+}
@@ -0,0 +1,167 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <nap/numeric.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nap
+{
+	// Forward Declares
+	class StreamingImage;
+	class Bitmap;
+
+	/**
+	 * Loads the pixel data of all nap::StreamingImage resources in the background and decides which resolution is resident on the GPU.
+	 * Owned by the nap::RenderService, configured using the 'TextureStreaming' properties of the render service configuration.
+	 *
+	 * Images are decoded on a pool of worker threads. The low resolution tail of every image is loaded first, so every image renders as soon as possible.
+	 * Images that are bound to a material instance are then streamed in at the highest resolution that fits within the GPU memory budget.
+	 * When the budget is exceeded, images that were not used in the last frame are evicted back to their tail, least recently used first.
+	 * The amount of decoded pixel data that is waiting to be uploaded is limited by the host memory budget,
+	 * the number of bytes uploaded every frame is limited by the upload budget.
+	 */
+	class NAPAPI TextureStreamer final
+	{
+	public:
+		/**
+		 * Starts the decode threads.
+		 * @param gpuBudget max number of bytes of GPU memory used by all streaming images
+		 * @param hostBudget max number of bytes of decoded pixel data waiting to be uploaded
+		 * @param uploadBudget max number of bytes uploaded to the GPU every frame, at least one image is uploaded
+		 * @param threadCount number of decode threads
+		 */
+		TextureStreamer(uint64 gpuBudget, uint64 hostBudget, uint64 uploadBudget, int threadCount);
+
+		/**
+		 * Stops the decode threads, pending decode jobs are discarded.
+		 */
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer&) = delete;
+		TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+		/**
+		 * Starts streaming an image, the tail of the image is decoded immediately.
+		 * @param image the image to stream, must be initialized
+		 */
+		void add(StreamingImage& image);
+
+		/**
+		 * Stops streaming an image, pending decode results for the image are discarded.
+		 * @param image the image to remove
+		 */
+		void remove(StreamingImage& image);
+
+		/**
+		 * Uploads decoded images, evicts unused images and schedules new decode jobs.
+		 * Called by the render service every frame, on the main thread.
+		 */
+		void update();
+
+		/**
+		 * @return number of bytes of GPU memory used by all streaming images
+		 */
+		uint64 getGPUMemoryUsage() const					{ return mGPUMemoryUsage; }
+
+		/**
+		 * @return number of bytes of decoded pixel data that is being decoded or waiting to be uploaded
+		 */
+		uint64 getHostMemoryUsage() const					{ return mHostMemoryUsage; }
+
+		/**
+		 * @return max number of bytes of GPU memory used by all streaming images
+		 */
+		uint64 getGPUBudget() const							{ return mGPUBudget; }
+
+	private:
+		/**
+		 * Image that is being streamed
+		 */
+		struct Entry
+		{
+			StreamingImage*			mImage = nullptr;		///< The image
+			uint64					mLastUsedFrame = 0;		///< Last frame the image was bound
+			int						mPendingLevel = -1;		///< Level that is being decoded, -1 = none
+			bool					mFailed = false;		///< If decoding failed, the image is not streamed anymore
+		};
+
+		/**
+		 * Decode request, executed by a decode thread
+		 */
+		struct Job
+		{
+			uint64					mID = 0;				///< ID of the entry
+			std::string				mPath;					///< Image to decode
+			int						mLevel = 0;				///< Level to decode
+			int						mMaxSize = 0;			///< Max width or height of the level
+			uint64					mSizeInBytes = 0;		///< Estimated size of the decoded level
+		};
+
+		/**
+		 * Decoded level, uploaded on the main thread
+		 */
+		struct Result
+		{
+			Job						mJob;					///< The executed job
+			std::unique_ptr<Bitmap>	mBitmap;				///< Decoded pixels, null when decoding failed
+			std::string				mError;					///< Reason decoding failed
+		};
+
+		/**
+		 * Decodes queued jobs until the streamer is destroyed
+		 */
+		void decodeThread();
+
+		/**
+		 * Queues a decode job for the given level of an image
+		 */
+		void queueJob(uint64 id, Entry& entry, int level);
+
+		/**
+		 * Uploads a decoded level of an image, evicting other images when required
+		 * @return if the level is uploaded
+		 */
+		bool upload(Entry& entry, Result& result);
+
+		/**
+		 * Evicts unused images, least recently used first, until the given number of bytes is available
+		 * @return if the bytes are available
+		 */
+		bool makeAvailable(uint64 sizeInBytes, const Entry& requester);
+
+		/**
+		 * Replaces the resident level of an image and updates the memory usage
+		 */
+		bool setLevel(Entry& entry, int level, Bitmap& bitmap);
+
+		uint64						mGPUBudget = 0;				///< Max GPU memory used by all images
+		uint64						mHostBudget = 0;			///< Max decoded data waiting to be uploaded
+		uint64						mUploadBudget = 0;			///< Max bytes uploaded every frame
+		uint64						mGPUMemoryUsage = 0;		///< GPU memory used by all images
+		uint64						mHostMemoryUsage = 0;		///< Decoded data that is being decoded or waiting to be uploaded
+		uint64						mFrame = 0;					///< Number of updates
+		uint64						mNextID = 1;				///< ID of the next added image
+		std::unordered_map<uint64, Entry> mEntries;				///< All streamed images by ID
+		std::deque<Result>			mDecoded;					///< Decoded levels waiting to be uploaded, main thread only
+
+		std::vector<std::thread>	mThreads;					///< Decode threads
+		std::mutex					mMutex;						///< Guards the job queues, results and stop flag
+		std::condition_variable		mCondition;					///< Signalled when a job is queued or the streamer stops
+		std::deque<Job>				mTailJobs;					///< Tail decode jobs, executed first
+		std::deque<Job>				mLevelJobs;					///< Higher resolution decode jobs
+		std::vector<Result>			mResults;					///< Finished jobs
+		bool						mStop = false;				///< If the decode threads should stop
+	};
+}
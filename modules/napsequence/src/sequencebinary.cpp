@@ -0,0 +1,972 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// local includes
+#include "sequencebinary.h"
+#include "sequencetrackcurve.h"
+#include "sequencetrackevent.h"
+#include "sequencetracksegmentcurve.h"
+#include "sequencetracksegmentevent.h"
+#include "sequencetracksegmentindex.h"
+
+// external includes
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace nap
+{
+	namespace sequencebinary
+	{
+		//////////////////////////////////////////////////////////////////////////
+		// File layout
+		//////////////////////////////////////////////////////////////////////////
+
+		// All values are stored little endian, every column starts at a multiple of 8 bytes
+		static constexpr uint32 sequenceVersion = 1;
+		static constexpr uint32 bakedVersion = 1;
+		static constexpr uint32 noString = 0xffffffff;
+
+		/**
+		 * Array of values in the file
+		 */
+		struct Column
+		{
+			uint64 mOffset = 0;		///< Offset in bytes from the start of the file
+			uint64 mCount = 0;		///< Number of values
+		};
+
+		/**
+		 * Track and segment types
+		 */
+		enum class EType : uint32
+		{
+			CurveFloat		= 0,
+			CurveVec2		= 1,
+			CurveVec3		= 2,
+			CurveVec4		= 3,
+			Event			= 4,
+			EventString		= 5,
+			EventFloat		= 6,
+			EventInt		= 7,
+			EventVec2		= 8,
+			EventVec3		= 9
+		};
+
+		/**
+		 * Single track, its segments are stored consecutively
+		 */
+		struct Track
+		{
+			EType	mType = EType::CurveFloat;
+			uint32	mID = noString;
+			uint32	mOutputID = noString;
+			uint32	mFirstSegment = 0;
+			uint32	mSegmentCount = 0;
+			uint32	mReserved = 0;
+			float	mMinimum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float	mMaximum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		};
+
+		/**
+		 * Header of a binary sequence
+		 */
+		struct SequenceHeader
+		{
+			char	mMagic[4] = { 'N', 'S', 'E', 'Q' };
+			uint32	mVersion = sequenceVersion;
+			double	mDuration = 0.0;
+			uint32	mID = noString;
+			uint32	mReserved = 0;
+			Column	mStringOffsets;		///< uint32, one more than the number of strings
+			Column	mChars;				///< char
+			Column	mTracks;			///< Track
+			Column	mSegmentStart;		///< double
+			Column	mSegmentDuration;	///< double
+			Column	mSegmentID;			///< uint32
+			Column	mSegmentType;		///< EType
+			Column	mSegmentFirst;		///< uint32, first curve of curve segments, event value of event segments
+			Column	mCurveID;			///< uint32
+			Column	mCurveType;			///< uint32, ECurveInterp of the segment curve
+			Column	mCurveFirstPoint;	///< uint32
+			Column	mCurvePointCount;	///< uint32
+			Column	mPointTime;			///< float
+			Column	mPointValue;		///< float
+			Column	mPointInTime;		///< float
+			Column	mPointInValue;		///< float
+			Column	mPointOutTime;		///< float
+			Column	mPointOutValue;		///< float
+			Column	mPointInterp;		///< uint8, ECurveInterp
+			Column	mPointAligned;		///< uint8
+			Column	mEventValue;		///< float, 3 per event
+			Column	mEventInteger;		///< int32, int value or string of the event
+			Column	mMarkerTime;		///< double
+			Column	mMarkerID;			///< uint32
+			Column	mMarkerMessage;		///< uint32
+		};
+
+		/**
+		 * Single baked track
+		 */
+		struct BakedTrack
+		{
+			uint32	mID = noString;
+			uint32	mOutputID = noString;
+			uint32	mChannels = 1;
+			uint32	mReserved = 0;
+			uint64	mFirstValue = 0;	///< Index of the first value in the values column
+		};
+
+		/**
+		 * Header of a baked sequence
+		 */
+		struct BakedHeader
+		{
+			char	mMagic[4] = { 'N', 'B', 'A', 'K' };
+			uint32	mVersion = bakedVersion;
+			double	mDuration = 0.0;
+			float	mSampleRate = 0.0f;
+			uint32	mReserved = 0;
+			uint64	mSampleCount = 0;	///< Number of samples of every track
+			Column	mStringOffsets;		///< uint32, one more than the number of strings
+			Column	mChars;				///< char
+			Column	mTracks;			///< BakedTrack
+			Column	mValues;			///< float, interleaved channels, mSampleCount * channels per track
+		};
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// Writing
+		//////////////////////////////////////////////////////////////////////////
+
+		/**
+		 * Collects strings and columns and writes them after the header
+		 */
+		class Writer
+		{
+		public:
+			Writer(size_t headerSize)			{ mData.resize(headerSize); }
+
+			uint32 addString(const std::string& value)
+			{
+				auto it = mStringIndices.find(value);
+				if (it != mStringIndices.end())
+					return it->second;
+
+				uint32 index = static_cast<uint32>(mStringOffsets.size());
+				mStringOffsets.emplace_back(static_cast<uint32>(mChars.size()));
+				mChars.insert(mChars.end(), value.begin(), value.end());
+				mStringIndices.emplace(value, index);
+				return index;
+			}
+
+			template<typename T>
+			Column write(const std::vector<T>& values)
+			{
+				// align to 8 bytes
+				mData.resize((mData.size() + 7) & ~static_cast<size_t>(7));
+
+				Column column;
+				column.mOffset = mData.size();
+				column.mCount = values.size();
+				if (!values.empty())
+				{
+					const uint8* begin = reinterpret_cast<const uint8*>(values.data());
+					mData.insert(mData.end(), begin, begin + values.size() * sizeof(T));
+				}
+				return column;
+			}
+
+			void writeStrings(Column& outOffsets, Column& outChars)
+			{
+				std::vector<uint32> offsets = mStringOffsets;
+				offsets.emplace_back(static_cast<uint32>(mChars.size()));
+				outOffsets = write(offsets);
+				outChars = write(mChars);
+			}
+
+			template<typename H>
+			bool save(const H& header, const std::string& path, utility::ErrorState& errorState)
+			{
+				std::memcpy(mData.data(), &header, sizeof(H));
+				std::ofstream output(path, std::ios::binary | std::ios::out | std::ios::trunc);
+				if (!errorState.check(output.is_open() && output.good(), "Failed to open %s for writing", path.c_str()))
+					return false;
+
+				output.write(reinterpret_cast<const char*>(mData.data()), mData.size());
+				return errorState.check(output.good(), "Failed to write %s", path.c_str());
+			}
+
+		private:
+			std::vector<uint8>							mData;
+			std::vector<uint32>							mStringOffsets;
+			std::vector<char>							mChars;
+			std::unordered_map<std::string, uint32>		mStringIndices;
+		};
+
+
+		/**
+		 * Columns of a sequence, filled track by track
+		 */
+		struct SequenceColumns
+		{
+			std::vector<Track>	mTracks;
+			std::vector<double>	mSegmentStart;
+			std::vector<double>	mSegmentDuration;
+			std::vector<uint32>	mSegmentID;
+			std::vector<EType>	mSegmentType;
+			std::vector<uint32>	mSegmentFirst;
+			std::vector<uint32>	mCurveID;
+			std::vector<uint32>	mCurveType;
+			std::vector<uint32>	mCurveFirstPoint;
+			std::vector<uint32>	mCurvePointCount;
+			std::vector<float>	mPointTime;
+			std::vector<float>	mPointValue;
+			std::vector<float>	mPointInTime;
+			std::vector<float>	mPointInValue;
+			std::vector<float>	mPointOutTime;
+			std::vector<float>	mPointOutValue;
+			std::vector<uint8>	mPointInterp;
+			std::vector<uint8>	mPointAligned;
+			std::vector<float>	mEventValue;
+			std::vector<int32>	mEventInteger;
+			std::vector<double>	mMarkerTime;
+			std::vector<uint32>	mMarkerID;
+			std::vector<uint32>	mMarkerMessage;
+		};
+
+
+		static void toFloats(float value, float* out)				{ out[0] = value; }
+		static void toFloats(const glm::vec2& value, float* out)	{ out[0] = value.x; out[1] = value.y; }
+		static void toFloats(const glm::vec3& value, float* out)	{ out[0] = value.x; out[1] = value.y; out[2] = value.z; }
+		static void toFloats(const glm::vec4& value, float* out)	{ out[0] = value.x; out[1] = value.y; out[2] = value.z; out[3] = value.w; }
+
+		static void fromFloats(const float* in, float& value)		{ value = in[0]; }
+		static void fromFloats(const float* in, glm::vec2& value)	{ value = { in[0], in[1] }; }
+		static void fromFloats(const float* in, glm::vec3& value)	{ value = { in[0], in[1], in[2] }; }
+		static void fromFloats(const float* in, glm::vec4& value)	{ value = { in[0], in[1], in[2], in[3] }; }
+
+
+		template<typename T>
+		static void writeCurveTrack(const SequenceTrackCurve<T>& track, EType type, Writer& writer, SequenceColumns& columns)
+		{
+			Track& record = columns.mTracks.back();
+			record.mType = type;
+			toFloats(track.mMinimum, record.mMinimum);
+			toFloats(track.mMaximum, record.mMaximum);
+
+			for (const auto& segment : track.mSegments)
+			{
+				assert(segment->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentCurve<T>)));
+				const auto& curve_segment = static_cast<const SequenceTrackSegmentCurve<T>&>(*segment);
+				columns.mSegmentType.emplace_back(type);
+				columns.mSegmentFirst.emplace_back(static_cast<uint32>(columns.mCurveID.size()));
+
+				for (int i = 0; i < curve_segment.mCurves.size(); i++)
+				{
+					const auto& curve = *curve_segment.mCurves[i];
+					columns.mCurveID.emplace_back(writer.addString(curve.mID));
+					columns.mCurveType.emplace_back(static_cast<uint32>(i < curve_segment.mCurveTypes.size() ? curve_segment.mCurveTypes[i] : math::ECurveInterp::Bezier));
+					columns.mCurveFirstPoint.emplace_back(static_cast<uint32>(columns.mPointTime.size()));
+					columns.mCurvePointCount.emplace_back(static_cast<uint32>(curve.mPoints.size()));
+					for (const auto& point : curve.mPoints)
+					{
+						columns.mPointTime.emplace_back(point.mPos.mTime);
+						columns.mPointValue.emplace_back(point.mPos.mValue);
+						columns.mPointInTime.emplace_back(point.mInTan.mTime);
+						columns.mPointInValue.emplace_back(point.mInTan.mValue);
+						columns.mPointOutTime.emplace_back(point.mOutTan.mTime);
+						columns.mPointOutValue.emplace_back(point.mOutTan.mValue);
+						columns.mPointInterp.emplace_back(static_cast<uint8>(point.mInterp));
+						columns.mPointAligned.emplace_back(point.mTangentsAligned ? 1 : 0);
+					}
+				}
+			}
+		}
+
+
+		template<typename T>
+		static bool writeEvent(const SequenceTrackSegment& segment, EType type, SequenceColumns& columns)
+		{
+			if (segment.get_type() != RTTI_OF(SequenceTrackSegmentEvent<T>))
+				return false;
+
+			float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			toFloats(static_cast<const SequenceTrackSegmentEvent<T>&>(segment).mValue, values);
+			columns.mSegmentType.emplace_back(type);
+			columns.mSegmentFirst.emplace_back(static_cast<uint32>(columns.mEventInteger.size()));
+			columns.mEventValue.insert(columns.mEventValue.end(), values, values + 3);
+			columns.mEventInteger.emplace_back(0);
+			return true;
+		}
+
+
+		static bool writeEventTrack(const SequenceTrackEvent& track, Writer& writer, SequenceColumns& columns, utility::ErrorState& errorState)
+		{
+			columns.mTracks.back().mType = EType::Event;
+			for (const auto& segment : track.mSegments)
+			{
+				// events without a value in the float columns
+				rtti::TypeInfo type = segment->get_type();
+				if (type == RTTI_OF(SequenceTrackSegmentEventString) || type == RTTI_OF(SequenceTrackSegmentEventInt))
+				{
+					bool is_string = type == RTTI_OF(SequenceTrackSegmentEventString);
+					columns.mSegmentType.emplace_back(is_string ? EType::EventString : EType::EventInt);
+					columns.mSegmentFirst.emplace_back(static_cast<uint32>(columns.mEventInteger.size()));
+					columns.mEventValue.insert(columns.mEventValue.end(), 3, 0.0f);
+					columns.mEventInteger.emplace_back(is_string ?
+						static_cast<int32>(writer.addString(static_cast<const SequenceTrackSegmentEventString&>(*segment).mValue)) :
+						static_cast<int32>(static_cast<const SequenceTrackSegmentEventInt&>(*segment).mValue));
+					continue;
+				}
+
+				if (writeEvent<float>(*segment, EType::EventFloat, columns) ||
+					writeEvent<glm::vec2>(*segment, EType::EventVec2, columns) ||
+					writeEvent<glm::vec3>(*segment, EType::EventVec3, columns))
+					continue;
+
+				errorState.fail("Event segment %s of type %s not supported by the binary format", segment->mID.c_str(), type.get_name().to_string().c_str());
+				return false;
+			}
+			return true;
+		}
+
+
+		bool save(const Sequence& sequence, const std::string& path, utility::ErrorState& errorState)
+		{
+			Writer writer(sizeof(SequenceHeader));
+			SequenceColumns columns;
+			SequenceHeader header;
+			header.mDuration = sequence.mDuration;
+			header.mID = writer.addString(sequence.mID);
+
+			for (const auto& track : sequence.mTracks)
+			{
+				Track record;
+				record.mID = writer.addString(track->mID);
+				record.mOutputID = writer.addString(track->mAssignedOutputID);
+				record.mFirstSegment = static_cast<uint32>(columns.mSegmentStart.size());
+				record.mSegmentCount = static_cast<uint32>(track->mSegments.size());
+				columns.mTracks.emplace_back(record);
+
+				for (const auto& segment : track->mSegments)
+				{
+					columns.mSegmentStart.emplace_back(segment->mStartTime);
+					columns.mSegmentDuration.emplace_back(segment->mDuration);
+					columns.mSegmentID.emplace_back(writer.addString(segment->mID));
+				}
+
+				rtti::TypeInfo type = track->get_type();
+				if (type == RTTI_OF(SequenceTrackCurveFloat))
+					writeCurveTrack(static_cast<const SequenceTrackCurveFloat&>(*track), EType::CurveFloat, writer, columns);
+				else if (type == RTTI_OF(SequenceTrackCurveVec2))
+					writeCurveTrack(static_cast<const SequenceTrackCurveVec2&>(*track), EType::CurveVec2, writer, columns);
+				else if (type == RTTI_OF(SequenceTrackCurveVec3))
+					writeCurveTrack(static_cast<const SequenceTrackCurveVec3&>(*track), EType::CurveVec3, writer, columns);
+				else if (type == RTTI_OF(SequenceTrackCurveVec4))
+					writeCurveTrack(static_cast<const SequenceTrackCurveVec4&>(*track), EType::CurveVec4, writer, columns);
+				else if (type == RTTI_OF(SequenceTrackEvent))
+				{
+					if (!writeEventTrack(static_cast<const SequenceTrackEvent&>(*track), writer, columns, errorState))
+						return false;
+				}
+				else
+				{
+					errorState.fail("Track %s of type %s not supported by the binary format", track->mID.c_str(), type.get_name().to_string().c_str());
+					return false;
+				}
+			}
+
+			for (const auto& marker : sequence.mMarkers)
+			{
+				columns.mMarkerTime.emplace_back(marker->mTime);
+				columns.mMarkerID.emplace_back(writer.addString(marker->mID));
+				columns.mMarkerMessage.emplace_back(writer.addString(marker->mMessage));
+			}
+
+			header.mTracks			= writer.write(columns.mTracks);
+			header.mSegmentStart	= writer.write(columns.mSegmentStart);
+			header.mSegmentDuration	= writer.write(columns.mSegmentDuration);
+			header.mSegmentID		= writer.write(columns.mSegmentID);
+			header.mSegmentType		= writer.write(columns.mSegmentType);
+			header.mSegmentFirst	= writer.write(columns.mSegmentFirst);
+			header.mCurveID			= writer.write(columns.mCurveID);
+			header.mCurveType		= writer.write(columns.mCurveType);
+			header.mCurveFirstPoint	= writer.write(columns.mCurveFirstPoint);
+			header.mCurvePointCount	= writer.write(columns.mCurvePointCount);
+			header.mPointTime		= writer.write(columns.mPointTime);
+			header.mPointValue		= writer.write(columns.mPointValue);
+			header.mPointInTime		= writer.write(columns.mPointInTime);
+			header.mPointInValue	= writer.write(columns.mPointInValue);
+			header.mPointOutTime	= writer.write(columns.mPointOutTime);
+			header.mPointOutValue	= writer.write(columns.mPointOutValue);
+			header.mPointInterp		= writer.write(columns.mPointInterp);
+			header.mPointAligned	= writer.write(columns.mPointAligned);
+			header.mEventValue		= writer.write(columns.mEventValue);
+			header.mEventInteger	= writer.write(columns.mEventInteger);
+			header.mMarkerTime		= writer.write(columns.mMarkerTime);
+			header.mMarkerID		= writer.write(columns.mMarkerID);
+			header.mMarkerMessage	= writer.write(columns.mMarkerMessage);
+			writer.writeStrings(header.mStringOffsets, header.mChars);
+			return writer.save(header, path, errorState);
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// Reading
+		//////////////////////////////////////////////////////////////////////////
+
+		/**
+		 * @param value stored interpolation type
+		 * @return if the value is a valid ECurveInterp
+		 */
+		static bool isCurveInterp(uint32 value)
+		{
+			return value <= static_cast<uint32>(math::ECurveInterp::Stepped);
+		}
+
+
+		/**
+		 * Validated access to the columns of a mapped file
+		 */
+		class Reader
+		{
+		public:
+			Reader(const utility::MemoryMappedFile& file) : mFile(file) { }
+
+			template<typename T>
+			bool get(const Column& column, const T*& outValues, utility::ErrorState& errorState, uint64 minCount = 0)
+			{
+				uint64 size = mFile.getSize();
+				bool valid = column.mOffset % 8 == 0 && column.mOffset <= size && column.mCount >= minCount &&
+					column.mCount <= (size - column.mOffset) / sizeof(T);
+				if (!errorState.check(valid, "Invalid column in binary sequence"))
+					return false;
+
+				outValues = reinterpret_cast<const T*>(mFile.getData() + column.mOffset);
+				return true;
+			}
+
+			bool getStrings(const Column& offsets, const Column& chars, utility::ErrorState& errorState)
+			{
+				if (!get(offsets, mStringOffsets, errorState, 1) || !get(chars, mChars, errorState))
+					return false;
+
+				mStringCount = static_cast<uint32>(offsets.mCount - 1);
+				for (uint32 i = 0; i < mStringCount; i++)
+				{
+					if (!errorState.check(mStringOffsets[i] <= mStringOffsets[i + 1] && mStringOffsets[i + 1] <= chars.mCount, "Invalid string table in binary sequence"))
+						return false;
+				}
+				return true;
+			}
+
+			bool getString(uint32 index, std::string& outValue, utility::ErrorState& errorState) const
+			{
+				if (!errorState.check(index < mStringCount, "Invalid string in binary sequence"))
+					return false;
+
+				outValue.assign(mChars + mStringOffsets[index], mStringOffsets[index + 1] - mStringOffsets[index]);
+				return true;
+			}
+
+		private:
+			const utility::MemoryMappedFile&	mFile;
+			const uint32*						mStringOffsets = nullptr;
+			const char*							mChars = nullptr;
+			uint32								mStringCount = 0;
+		};
+
+
+		/**
+		 * All columns of a mapped binary sequence
+		 */
+		struct SequenceView
+		{
+			const Track*	mTracks = nullptr;
+			const double*	mSegmentStart = nullptr;
+			const double*	mSegmentDuration = nullptr;
+			const uint32*	mSegmentID = nullptr;
+			const EType*	mSegmentType = nullptr;
+			const uint32*	mSegmentFirst = nullptr;
+			const uint32*	mCurveID = nullptr;
+			const uint32*	mCurveType = nullptr;
+			const uint32*	mCurveFirstPoint = nullptr;
+			const uint32*	mCurvePointCount = nullptr;
+			const float*	mPointTime = nullptr;
+			const float*	mPointValue = nullptr;
+			const float*	mPointInTime = nullptr;
+			const float*	mPointInValue = nullptr;
+			const float*	mPointOutTime = nullptr;
+			const float*	mPointOutValue = nullptr;
+			const uint8*	mPointInterp = nullptr;
+			const uint8*	mPointAligned = nullptr;
+			const float*	mEventValue = nullptr;
+			const int32*	mEventInteger = nullptr;
+			const double*	mMarkerTime = nullptr;
+			const uint32*	mMarkerID = nullptr;
+			const uint32*	mMarkerMessage = nullptr;
+			uint64			mCurveCount = 0;
+			uint64			mPointCount = 0;
+			uint64			mEventCount = 0;
+		};
+
+
+		template<typename T>
+		static bool readCurveTrack(const Track& record, const SequenceView& view, Reader& reader, std::vector<std::unique_ptr<rtti::Object>>& outObjects, SequenceTrack*& outTrack, utility::ErrorState& errorState)
+		{
+			auto track = std::make_unique<SequenceTrackCurve<T>>();
+			fromFloats(record.mMinimum, track->mMinimum);
+			fromFloats(record.mMaximum, track->mMaximum);
+
+			int curve_count = SequenceTrackSegmentCurve<T>().getCurveCount();
+			for (uint32 s = record.mFirstSegment; s < record.mFirstSegment + record.mSegmentCount; s++)
+			{
+				uint32 first_curve = view.mSegmentFirst[s];
+				if (!errorState.check(view.mSegmentType[s] == record.mType && first_curve + curve_count <= view.mCurveCount, "Invalid curve segment in binary sequence"))
+					return false;
+
+				auto segment = std::make_unique<SequenceTrackSegmentCurve<T>>();
+				segment->mStartTime = view.mSegmentStart[s];
+				segment->mDuration = view.mSegmentDuration[s];
+				if (!reader.getString(view.mSegmentID[s], segment->mID, errorState))
+					return false;
+
+				for (uint32 c = first_curve; c < first_curve + curve_count; c++)
+				{
+					uint32 first_point = view.mCurveFirstPoint[c];
+					uint32 point_count = view.mCurvePointCount[c];
+					if (!errorState.check(static_cast<uint64>(first_point) + point_count <= view.mPointCount && isCurveInterp(view.mCurveType[c]), "Invalid curve in binary sequence"))
+						return false;
+
+					auto curve = std::make_unique<math::FCurve<float, float>>();
+					if (!reader.getString(view.mCurveID[c], curve->mID, errorState))
+						return false;
+
+					curve->mPoints.resize(point_count);
+					for (uint32 p = 0; p < point_count; p++)
+					{
+						auto& point = curve->mPoints[p];
+						uint32 i = first_point + p;
+						if (!errorState.check(isCurveInterp(view.mPointInterp[i]), "Invalid curve point in binary sequence"))
+							return false;
+
+						point.mPos = { view.mPointTime[i], view.mPointValue[i] };
+						point.mInTan = { view.mPointInTime[i], view.mPointInValue[i] };
+						point.mOutTan = { view.mPointOutTime[i], view.mPointOutValue[i] };
+						point.mInterp = static_cast<math::ECurveInterp>(view.mPointInterp[i]);
+						point.mTangentsAligned = view.mPointAligned[i] != 0;
+					}
+
+					segment->mCurves.emplace_back(curve.get());
+					segment->mCurveTypes.emplace_back(static_cast<math::ECurveInterp>(view.mCurveType[c]));
+					outObjects.emplace_back(std::move(curve));
+				}
+
+				track->mSegments.emplace_back(segment.get());
+				outObjects.emplace_back(std::move(segment));
+			}
+
+			outTrack = track.get();
+			outObjects.emplace_back(std::move(track));
+			return true;
+		}
+
+
+		template<typename T>
+		static std::unique_ptr<SequenceTrackSegment> readEvent(const float* values)
+		{
+			auto segment = std::make_unique<SequenceTrackSegmentEvent<T>>();
+			fromFloats(values, segment->mValue);
+			return std::move(segment);
+		}
+
+
+		static bool readEventTrack(const Track& record, const SequenceView& view, Reader& reader, std::vector<std::unique_ptr<rtti::Object>>& outObjects, SequenceTrack*& outTrack, utility::ErrorState& errorState)
+		{
+			auto track = std::make_unique<SequenceTrackEvent>();
+			for (uint32 s = record.mFirstSegment; s < record.mFirstSegment + record.mSegmentCount; s++)
+			{
+				uint32 event = view.mSegmentFirst[s];
+				if (!errorState.check(event < view.mEventCount, "Invalid event segment in binary sequence"))
+					return false;
+
+				std::unique_ptr<SequenceTrackSegment> segment;
+				const float* values = view.mEventValue + event * 3;
+				switch (view.mSegmentType[s])
+				{
+				case EType::EventString:
+				{
+					auto string_segment = std::make_unique<SequenceTrackSegmentEventString>();
+					if (!reader.getString(static_cast<uint32>(view.mEventInteger[event]), string_segment->mValue, errorState))
+						return false;
+					segment = std::move(string_segment);
+					break;
+				}
+				case EType::EventInt:
+				{
+					auto int_segment = std::make_unique<SequenceTrackSegmentEventInt>();
+					int_segment->mValue = view.mEventInteger[event];
+					segment = std::move(int_segment);
+					break;
+				}
+				case EType::EventFloat:
+					segment = readEvent<float>(values);
+					break;
+				case EType::EventVec2:
+					segment = readEvent<glm::vec2>(values);
+					break;
+				case EType::EventVec3:
+					segment = readEvent<glm::vec3>(values);
+					break;
+				default:
+					errorState.fail("Invalid event segment in binary sequence");
+					return false;
+				}
+
+				segment->mStartTime = view.mSegmentStart[s];
+				segment->mDuration = view.mSegmentDuration[s];
+				if (!reader.getString(view.mSegmentID[s], segment->mID, errorState))
+					return false;
+
+				track->mSegments.emplace_back(segment.get());
+				outObjects.emplace_back(std::move(segment));
+			}
+
+			outTrack = track.get();
+			outObjects.emplace_back(std::move(track));
+			return true;
+		}
+
+
+		bool isBinary(const std::string& path)
+		{
+			std::ifstream input(path, std::ios::binary | std::ios::in);
+			char magic[4] = { 0, 0, 0, 0 };
+			input.read(magic, sizeof(magic));
+			return input.good() && std::memcmp(magic, SequenceHeader().mMagic, sizeof(magic)) == 0;
+		}
+
+
+		Sequence* load(const std::string& path, std::vector<std::unique_ptr<rtti::Object>>& outObjects, utility::ErrorState& errorState)
+		{
+			utility::MemoryMappedFile file;
+			if (!file.open(path, errorState))
+				return nullptr;
+
+			if (!errorState.check(file.getSize() >= sizeof(SequenceHeader), "%s is not a binary sequence", path.c_str()))
+				return nullptr;
+
+			const SequenceHeader& header = *reinterpret_cast<const SequenceHeader*>(file.getData());
+			if (!errorState.check(std::memcmp(header.mMagic, SequenceHeader().mMagic, sizeof(header.mMagic)) == 0, "%s is not a binary sequence", path.c_str()) ||
+				!errorState.check(header.mVersion == sequenceVersion, "%s: unsupported binary sequence version %d", path.c_str(), header.mVersion))
+				return nullptr;
+
+			// map all columns, segment, curve and point columns must be of equal length
+			Reader reader(file);
+			SequenceView view;
+			uint64 segment_count = header.mSegmentStart.mCount;
+			uint64 curve_count = header.mCurveID.mCount;
+			uint64 point_count = header.mPointTime.mCount;
+			uint64 event_count = header.mEventInteger.mCount;
+			uint64 marker_count = header.mMarkerTime.mCount;
+			if (!reader.getStrings(header.mStringOffsets, header.mChars, errorState) ||
+				!reader.get(header.mTracks, view.mTracks, errorState) ||
+				!reader.get(header.mSegmentStart, view.mSegmentStart, errorState) ||
+				!reader.get(header.mSegmentDuration, view.mSegmentDuration, errorState, segment_count) ||
+				!reader.get(header.mSegmentID, view.mSegmentID, errorState, segment_count) ||
+				!reader.get(header.mSegmentType, view.mSegmentType, errorState, segment_count) ||
+				!reader.get(header.mSegmentFirst, view.mSegmentFirst, errorState, segment_count) ||
+				!reader.get(header.mCurveID, view.mCurveID, errorState) ||
+				!reader.get(header.mCurveType, view.mCurveType, errorState, curve_count) ||
+				!reader.get(header.mCurveFirstPoint, view.mCurveFirstPoint, errorState, curve_count) ||
+				!reader.get(header.mCurvePointCount, view.mCurvePointCount, errorState, curve_count) ||
+				!reader.get(header.mPointTime, view.mPointTime, errorState) ||
+				!reader.get(header.mPointValue, view.mPointValue, errorState, point_count) ||
+				!reader.get(header.mPointInTime, view.mPointInTime, errorState, point_count) ||
+				!reader.get(header.mPointInValue, view.mPointInValue, errorState, point_count) ||
+				!reader.get(header.mPointOutTime, view.mPointOutTime, errorState, point_count) ||
+				!reader.get(header.mPointOutValue, view.mPointOutValue, errorState, point_count) ||
+				!reader.get(header.mPointInterp, view.mPointInterp, errorState, point_count) ||
+				!reader.get(header.mPointAligned, view.mPointAligned, errorState, point_count) ||
+				!reader.get(header.mEventInteger, view.mEventInteger, errorState) ||
+				!reader.get(header.mEventValue, view.mEventValue, errorState, event_count * 3) ||
+				!reader.get(header.mMarkerTime, view.mMarkerTime, errorState) ||
+				!reader.get(header.mMarkerID, view.mMarkerID, errorState, marker_count) ||
+				!reader.get(header.mMarkerMessage, view.mMarkerMessage, errorState, marker_count))
+				return nullptr;
+			view.mCurveCount = curve_count;
+			view.mPointCount = point_count;
+			view.mEventCount = event_count;
+
+			auto sequence = std::make_unique<Sequence>();
+			sequence->mDuration = header.mDuration;
+			if (!reader.getString(header.mID, sequence->mID, errorState))
+				return nullptr;
+
+			std::vector<std::unique_ptr<rtti::Object>> objects;
+			for (uint64 t = 0; t < header.mTracks.mCount; t++)
+			{
+				const Track& record = view.mTracks[t];
+				if (!errorState.check(static_cast<uint64>(record.mFirstSegment) + record.mSegmentCount <= segment_count, "Invalid track in binary sequence"))
+					return nullptr;
+
+				SequenceTrack* track = nullptr;
+				bool read = false;
+				switch (record.mType)
+				{
+				case EType::CurveFloat:
+					read = readCurveTrack<float>(record, view, reader, objects, track, errorState);
+					break;
+				case EType::CurveVec2:
+					read = readCurveTrack<glm::vec2>(record, view, reader, objects, track, errorState);
+					break;
+				case EType::CurveVec3:
+					read = readCurveTrack<glm::vec3>(record, view, reader, objects, track, errorState);
+					break;
+				case EType::CurveVec4:
+					read = readCurveTrack<glm::vec4>(record, view, reader, objects, track, errorState);
+					break;
+				case EType::Event:
+					read = readEventTrack(record, view, reader, objects, track, errorState);
+					break;
+				default:
+					errorState.fail("Invalid track in binary sequence");
+					break;
+				}
+
+				if (!read ||
+					!reader.getString(record.mID, track->mID, errorState) ||
+					!reader.getString(record.mOutputID, track->mAssignedOutputID, errorState))
+					return nullptr;
+				sequence->mTracks.emplace_back(track);
+			}
+
+			for (uint64 m = 0; m < marker_count; m++)
+			{
+				auto marker = std::make_unique<SequenceMarker>();
+				marker->mTime = view.mMarkerTime[m];
+				if (!reader.getString(view.mMarkerID[m], marker->mID, errorState) ||
+					!reader.getString(view.mMarkerMessage[m], marker->mMessage, errorState))
+					return nullptr;
+
+				sequence->mMarkers.emplace_back(marker.get());
+				objects.emplace_back(std::move(marker));
+			}
+
+			// hand over ownership
+			Sequence* result = sequence.get();
+			outObjects.emplace_back(std::move(sequence));
+			for (auto& object : objects)
+				outObjects.emplace_back(std::move(object));
+			return result;
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// Baking
+		//////////////////////////////////////////////////////////////////////////
+
+		template<typename T>
+		static void bakeCurveTrack(const SequenceTrackCurve<T>& track, float sampleRate, uint64 sampleCount, std::vector<float>& outValues)
+		{
+			SequenceTrackSegmentIndex index;
+			index.build(track);
+
+			// hold the start value until the first segment
+			T value = track.mMinimum;
+			if (index.getCount() > 0)
+			{
+				const auto& first = static_cast<const SequenceTrackSegmentCurve<T>&>(index.getSegment(0));
+				value = first.getStartValue() * (track.mMaximum - track.mMinimum) + track.mMinimum;
+			}
+
+			float values[4];
+			int channels = SequenceTrackSegmentCurve<T>().getCurveCount();
+			for (uint64 s = 0; s < sampleCount; s++)
+			{
+				double time = static_cast<double>(s) / static_cast<double>(sampleRate);
+				int found = index.find(time);
+				if (found >= 0)
+				{
+					const auto& segment = static_cast<const SequenceTrackSegmentCurve<T>&>(index.getSegment(found));
+					float pos = static_cast<float>((time - segment.mStartTime) / segment.mDuration);
+					value = segment.getValue(pos) * (track.mMaximum - track.mMinimum) + track.mMinimum;
+				}
+
+				toFloats(value, values);
+				outValues.insert(outValues.end(), values, values + channels);
+			}
+		}
+
+
+		bool bake(const Sequence& sequence, float sampleRate, const std::string& path, utility::ErrorState& errorState)
+		{
+			if (!errorState.check(sampleRate > 0.0f, "Sample rate must be greater than 0"))
+				return false;
+
+			Writer writer(sizeof(BakedHeader));
+			BakedHeader header;
+			header.mDuration = sequence.mDuration;
+			header.mSampleRate = sampleRate;
+			header.mSampleCount = static_cast<uint64>(std::ceil(sequence.mDuration * sampleRate)) + 1;
+
+			std::vector<BakedTrack> tracks;
+			std::vector<float> values;
+			for (const auto& track : sequence.mTracks)
+			{
+				BakedTrack record;
+				record.mID = writer.addString(track->mID);
+				record.mOutputID = writer.addString(track->mAssignedOutputID);
+				record.mFirstValue = values.size();
+
+				rtti::TypeInfo type = track->get_type();
+				if (type == RTTI_OF(SequenceTrackCurveFloat))
+				{
+					record.mChannels = 1;
+					bakeCurveTrack(static_cast<const SequenceTrackCurveFloat&>(*track), sampleRate, header.mSampleCount, values);
+				}
+				else if (type == RTTI_OF(SequenceTrackCurveVec2))
+				{
+					record.mChannels = 2;
+					bakeCurveTrack(static_cast<const SequenceTrackCurveVec2&>(*track), sampleRate, header.mSampleCount, values);
+				}
+				else if (type == RTTI_OF(SequenceTrackCurveVec3))
+				{
+					record.mChannels = 3;
+					bakeCurveTrack(static_cast<const SequenceTrackCurveVec3&>(*track), sampleRate, header.mSampleCount, values);
+				}
+				else if (type == RTTI_OF(SequenceTrackCurveVec4))
+				{
+					record.mChannels = 4;
+					bakeCurveTrack(static_cast<const SequenceTrackCurveVec4&>(*track), sampleRate, header.mSampleCount, values);
+				}
+				else
+				{
+					continue;
+				}
+				tracks.emplace_back(record);
+			}
+
+			header.mTracks = writer.write(tracks);
+			header.mValues = writer.write(values);
+			writer.writeStrings(header.mStringOffsets, header.mChars);
+			return writer.save(header, path, errorState);
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////
+		// BakedSequence
+		//////////////////////////////////////////////////////////////////////////
+
+		bool BakedSequence::open(const std::string& path, utility::ErrorState& errorState)
+		{
+			mHeader = nullptr;
+			mTrackIDs.clear();
+			mOutputIDs.clear();
+			if (!mFile.open(path, errorState))
+				return false;
+
+			if (!errorState.check(mFile.getSize() >= sizeof(BakedHeader), "%s is not a baked sequence", path.c_str()))
+				return false;
+
+			const BakedHeader& header = *reinterpret_cast<const BakedHeader*>(mFile.getData());
+			if (!errorState.check(std::memcmp(header.mMagic, BakedHeader().mMagic, sizeof(header.mMagic)) == 0, "%s is not a baked sequence", path.c_str()) ||
+				!errorState.check(header.mVersion == bakedVersion, "%s: unsupported baked sequence version %d", path.c_str(), header.mVersion) ||
+				!errorState.check(header.mSampleRate > 0.0f && header.mSampleCount > 0, "%s: invalid sample rate or count", path.c_str()))
+				return false;
+
+			Reader reader(mFile);
+			if (!reader.getStrings(header.mStringOffsets, header.mChars, errorState) ||
+				!reader.get(header.mTracks, mTracks, errorState) ||
+				!reader.get(header.mValues, mValues, errorState))
+				return false;
+
+			// all samples of all tracks must be in the file
+			mTrackIDs.resize(header.mTracks.mCount);
+			mOutputIDs.resize(header.mTracks.mCount);
+			for (uint64 t = 0; t < header.mTracks.mCount; t++)
+			{
+				const BakedTrack& track = mTracks[t];
+				bool valid = track.mChannels >= 1 && track.mChannels <= 4 && track.mFirstValue <= header.mValues.mCount &&
+					header.mSampleCount <= (header.mValues.mCount - track.mFirstValue) / track.mChannels;
+				if (!errorState.check(valid, "%s: invalid track", path.c_str()) ||
+					!reader.getString(track.mID, mTrackIDs[t], errorState) ||
+					!reader.getString(track.mOutputID, mOutputIDs[t], errorState))
+					return false;
+			}
+
+			mHeader = &header;
+			return true;
+		}
+
+
+		int BakedSequence::getTrackCount() const
+		{
+			return mHeader == nullptr ? 0 : static_cast<int>(mHeader->mTracks.mCount);
+		}
+
+
+		int BakedSequence::findTrack(const std::string& id) const
+		{
+			for (int i = 0; i < getTrackCount(); i++)
+			{
+				if (getTrackID(i) == id)
+					return i;
+			}
+			return -1;
+		}
+
+
+		const std::string& BakedSequence::getTrackID(int track) const
+		{
+			return mTrackIDs[track];
+		}
+
+
+		const std::string& BakedSequence::getAssignedOutputID(int track) const
+		{
+			return mOutputIDs[track];
+		}
+
+
+		int BakedSequence::getChannelCount(int track) const
+		{
+			return static_cast<int>(mTracks[track].mChannels);
+		}
+
+
+		float BakedSequence::getSampleRate() const
+		{
+			return mHeader->mSampleRate;
+		}
+
+
+		double BakedSequence::getDuration() const
+		{
+			return mHeader->mDuration;
+		}
+
+
+		void BakedSequence::evaluate(int track, double time, float* outValues) const
+		{
+			assert(track >= 0 && track < getTrackCount());
+			const BakedTrack& record = mTracks[track];
+
+			// sample before and after time
+			uint64 last = mHeader->mSampleCount - 1;
+			double pos = std::max(time, 0.0) * static_cast<double>(mHeader->mSampleRate);
+			uint64 index = std::min(static_cast<uint64>(pos), last);
+			uint64 next = std::min(index + 1, last);
+			float t = static_cast<float>(std::min(pos - static_cast<double>(index), 1.0));
+
+			const float* a = mValues + record.mFirstValue + index * record.mChannels;
+			const float* b = mValues + record.mFirstValue + next * record.mChannels;
+			for (uint32 c = 0; c < record.mChannels; c++)
+				outValues[c] = a[c] + (b[c] - a[c]) * t;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// internal includes
+#include "sequence.h"
+
+// external includes
+#include <utility/memorymappedfile.h>
+#include <nap/numeric.h>
+
+namespace nap
+{
+	namespace sequencebinary
+	{
+		//////////////////////////////////////////////////////////////////////////
+
+		/**
+		 * File extension of binary sequences
+		 */
+		constexpr const char* extension = "bseq";
+
+		/**
+		 * File extension of baked sequences
+		 */
+		constexpr const char* bakedExtension = "bake";
+
+		/**
+		 * Checks if the file at the given path is a binary sequence, by looking at the first bytes of the file
+		 * @param path path to the file
+		 * @return if the file is a binary sequence
+		 */
+		NAPAPI bool isBinary(const std::string& path);
+
+		/**
+		 * Writes a sequence to disk in the compact binary format.
+		 * Segment times, curve points and event values are stored in columns, one array per field, object ids in a string table.
+		 * Supports curve tracks with 1 to 4 channels and event tracks with string, float, int, vec2 and vec3 events.
+		 * @param sequence the sequence to write
+		 * @param path path to the file
+		 * @param errorState contains the error if the sequence can't be written
+		 * @return if the sequence was written
+		 */
+		NAPAPI bool save(const Sequence& sequence, const std::string& path, utility::ErrorState& errorState);
+
+		/**
+		 * Reads a binary sequence from disk. The file is memory mapped, all objects are created directly from the mapped columns.
+		 * The created objects are not initialized.
+		 * @param path path to the file
+		 * @param outObjects receives the sequence and all objects it links to
+		 * @param errorState contains the error if the sequence can't be read
+		 * @return the sequence, owned by outObjects, nullptr on failure
+		 */
+		NAPAPI Sequence* load(const std::string& path, std::vector<std::unique_ptr<rtti::Object>>& outObjects, utility::ErrorState& errorState);
+
+		/**
+		 * Renders every curve track of a sequence to a stream of samples at a fixed rate and writes the result to disk.
+		 * Samples hold the output value of the track, mapped from minimum to maximum.
+		 * In between segments the last value is held. Event tracks are not baked.
+		 * @param sequence the sequence to bake
+		 * @param sampleRate number of samples per second
+		 * @param path path to the file
+		 * @param errorState contains the error if the sequence can't be baked
+		 * @return if the sequence was baked
+		 */
+		NAPAPI bool bake(const Sequence& sequence, float sampleRate, const std::string& path, utility::ErrorState& errorState);
+
+
+		//////////////////////////////////////////////////////////////////////////
+
+		// forward declares
+		struct BakedHeader;
+		struct BakedTrack;
+
+		/**
+		 * Plays back a sequence baked using sequencebinary::bake().
+		 * The file is memory mapped, evaluating a track is a single linear interpolation in between two samples.
+		 * Suitable for playback on machines that can't afford to evaluate curves.
+		 */
+		class NAPAPI BakedSequence final
+		{
+		public:
+			/**
+			 * Maps the baked sequence at the given path
+			 * @param path path to the file
+			 * @param errorState contains the error if the file isn't a valid baked sequence
+			 * @return if the baked sequence was opened
+			 */
+			bool open(const std::string& path, utility::ErrorState& errorState);
+
+			/**
+			 * @return number of baked curve tracks
+			 */
+			int getTrackCount() const;
+
+			/**
+			 * @param id id of the track
+			 * @return index of the track with the given id, -1 if not found
+			 */
+			int findTrack(const std::string& id) const;
+
+			/**
+			 * @param track index of the track
+			 * @return id of the track
+			 */
+			const std::string& getTrackID(int track) const;
+
+			/**
+			 * @param track index of the track
+			 * @return id of the output the track was assigned to
+			 */
+			const std::string& getAssignedOutputID(int track) const;
+
+			/**
+			 * @param track index of the track
+			 * @return number of values per sample, 1 for float tracks up to 4 for vec4 tracks
+			 */
+			int getChannelCount(int track) const;
+
+			/**
+			 * @return number of samples per second
+			 */
+			float getSampleRate() const;
+
+			/**
+			 * @return duration of the sequence in seconds
+			 */
+			double getDuration() const;
+
+			/**
+			 * Returns the interpolated value of a track at the given time
+			 * @param track index of the track
+			 * @param time time in seconds, clamped to the duration of the sequence
+			 * @param outValues receives getChannelCount() values
+			 */
+			void evaluate(int track, double time, float* outValues) const;
+
+		private:
+			utility::MemoryMappedFile	mFile;
+			const BakedHeader*			mHeader = nullptr;
+			const BakedTrack*			mTracks = nullptr;
+			const float*				mValues = nullptr;
+			std::vector<std::string>	mTrackIDs;				///< id of every track, read from the string table on open
+			std::vector<std::string>	mOutputIDs;				///< assigned output id of every track, read from the string table on open
+		};
+	}
+}
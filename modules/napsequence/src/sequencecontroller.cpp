@@ -145,7 +145,7 @@ namespace nap
 
 	void SequenceController::assignNewObjectID(const std::string& trackID, const std::string& objectID)
 	{
-		performEditAction([this, trackID, objectID]()
+		performEditAction(trackID, [this, trackID, objectID]()
 		{
 			SequenceTrack* track = findTrack(trackID);
 			assert(track != nullptr); // track not found
@@ -154,8 +154,6 @@ namespace nap
 			{
 				track->mAssignedOutputID = objectID;
 			}
-
-			mPlayer.createAdapters();
 		});
 	}
 
@@ -172,11 +170,6 @@ namespace nap
 			{
 				if (track->mID == deleteTrackID)
 				{
-					if (mPlayer.mAdapters.find(track->mID) != mPlayer.mAdapters.end())
-					{
-						mPlayer.mAdapters.erase(track->mID);
-					}
-
 					sequence.mTracks.erase(sequence.mTracks.begin() + index);
 
 					deleteObjectFromSequencePlayer(deleteTrackID);
@@ -191,7 +184,7 @@ namespace nap
 
 	void SequenceController::moveTrackUp(const std::string& trackID)
 	{
-		performEditAction([this, trackID]()
+		performEditAction(trackID, [this, trackID]()
 		{
 			//
 			Sequence& sequence = mPlayer.getSequence();
@@ -218,7 +211,7 @@ namespace nap
 
 	void SequenceController::moveTrackDown(const std::string& trackID)
 	{
-		performEditAction([this, trackID]()
+		performEditAction(trackID, [this, trackID]()
 		{
 			//
 			Sequence& sequence = mPlayer.getSequence();
@@ -265,4 +258,10 @@ namespace nap
 	{
 		mEditor.performEditAction(action);
 	}
+
+
+	void SequenceController::performEditAction(const std::string& trackID, std::function<void()> action)
+	{
+		mEditor.performEditAction(trackID, action);
+	}
 }
\ No newline at end of file
@@ -151,6 +151,13 @@ namespace nap
 		 */
 		void performEditAction(std::function<void()> action);
 
+		/**
+		 * calls perform edit action on editor class, for an action that only edits a single track
+		 * @param trackID the id of the edited track
+		 * @param action the edit action
+		 */
+		void performEditAction(const std::string& trackID, std::function<void()> action);
+
 		// objects owned by sequence player
 		std::vector<std::unique_ptr<rtti::Object>>&	getPlayerOwnedObjects(){ return mPlayer.mReadObjects; };
 
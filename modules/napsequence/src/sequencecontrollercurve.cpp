@@ -37,7 +37,7 @@ namespace nap
 	{
 		double return_duration = duration;
 
-		performEditAction([this, trackID, segmentID, duration, &return_duration]()
+		performEditAction(trackID, [this, trackID, segmentID, duration, &return_duration]()
 		{
 			//
 			SequenceTrack* track = findTrack(trackID);
@@ -125,7 +125,7 @@ namespace nap
 	void SequenceControllerCurve::deleteSegment(const std::string& trackID, const std::string& segmentID)
 	{
 		// pause player thread
-		performEditAction([this, trackID, segmentID]()
+		performEditAction(trackID, [this, trackID, segmentID]()
 		{
 			//
 			Sequence& sequence = getSequence();
@@ -185,7 +185,7 @@ namespace nap
 			{ RTTI_OF(SequenceTrackSegmentCurveVec4), &SequenceControllerCurve::changeCurveType<glm::vec4> },
 		};
 
-		performEditAction([this, trackID, segmentID, type, curveIndex]()
+		performEditAction(trackID, [this, trackID, segmentID, type, curveIndex]()
 		{
 			auto* segment = findSegment(trackID, segmentID);
 			assert(segment != nullptr); // segment not found
@@ -215,7 +215,7 @@ namespace nap
 			};
 
 		//
-		performEditAction([this, trackID, segmentID, newValue, curveIndex, valueType]()
+		performEditAction(trackID, [this, trackID, segmentID, newValue, curveIndex, valueType]()
 		{
 			SequenceTrack* track = findTrack(trackID);
 			assert(track != nullptr); // track not found
@@ -250,7 +250,7 @@ namespace nap
 			};
 
 		//
-		performEditAction([this, trackID, segmentID, pos, curveIndex]()
+		performEditAction(trackID, [this, trackID, segmentID, pos, curveIndex]()
 		{
 			// find segment
 			SequenceTrackSegment* segment = findSegment(trackID, segmentID);
@@ -284,7 +284,7 @@ namespace nap
 				{ RTTI_OF(SequenceTrackSegmentCurveVec4), &SequenceControllerCurve::deleteCurvePoint<glm::vec4> },
 			};
 
-		performEditAction([this, trackID, segmentID, index, curveIndex]()
+		performEditAction(trackID, [this, trackID, segmentID, index, curveIndex]()
 		{
 			// find segment
 			SequenceTrackSegment* segment = findSegment(trackID, segmentID);
@@ -328,7 +328,7 @@ namespace nap
 				{ RTTI_OF(SequenceTrackSegmentCurveVec4), &SequenceControllerCurve::changeLastCurvePoint<glm::vec4> },
 			};
 
-		performEditAction([this, trackID, segmentID, pointIndex, curveIndex, time, value]()
+		performEditAction(trackID, [this, trackID, segmentID, pointIndex, curveIndex, time, value]()
 		{
 			// find segment
 			SequenceTrackSegment* segment = findSegment(trackID, segmentID);
@@ -388,7 +388,7 @@ namespace nap
 				{ RTTI_OF(SequenceTrackSegmentCurveVec4), &SequenceControllerCurve::changeTanPoint<glm::vec4> },
 			};
 
-		performEditAction([this, trackID, segmentID, pointIndex, curveIndex, tanType, time, value]()
+		performEditAction(trackID, [this, trackID, segmentID, pointIndex, curveIndex, tanType, time, value]()
 		{
 			// find segment
 			SequenceTrackSegment* segment = findSegment(trackID, segmentID);
@@ -443,7 +443,7 @@ namespace nap
 	template<>
 	void SequenceControllerCurve::changeMinMaxCurveTrack<float>(const std::string& trackID, float minimum, float maximum)
 	{
-		performEditAction([this, trackID, minimum, maximum]()
+		performEditAction(trackID, [this, trackID, minimum, maximum]()
 		{
 			SequenceTrack* track = findTrack(trackID);
 			assert(track != nullptr); // track not found
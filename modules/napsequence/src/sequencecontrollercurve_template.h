@@ -34,7 +34,7 @@ namespace nap
 
 		SequenceTrackSegment* return_ptr;
 
-		performEditAction([this, trackID, time, &return_ptr]() mutable
+		performEditAction(trackID, [this, trackID, time, &return_ptr]() mutable
 		{
 			auto it = s_curve_count_map.find(RTTI_OF(T));
 			assert(it != s_curve_count_map.end()); // type not found
@@ -471,7 +471,7 @@ namespace nap
 	template<typename T>
 	void SequenceControllerCurve::changeMinMaxCurveTrack(const std::string& trackID, T minimum, T maximum)
 	{
-		performEditAction([this, trackID, minimum, maximum]()
+		performEditAction(trackID, [this, trackID, minimum, maximum]()
 		{
 			SequenceTrack* track = findTrack(trackID);
 			assert(track != nullptr); // track not found
@@ -21,7 +21,7 @@ namespace nap
 	double SequenceControllerEvent::segmentEventStartTimeChange(const std::string& trackID, const std::string& segmentID, float time)
 	{
 		double return_time = time;
-		performEditAction([this, trackID, segmentID, time, &return_time]()
+		performEditAction(trackID, [this, trackID, segmentID, time, &return_time]()
 		{
 			auto* segment = findSegment(trackID, segmentID);
 			assert(segment != nullptr); // segment not found
@@ -55,7 +55,7 @@ namespace nap
 
 	void SequenceControllerEvent::deleteSegment(const std::string& trackID, const std::string& segmentID)
 	{
-		performEditAction([this, trackID, segmentID]()
+		performEditAction(trackID, [this, trackID, segmentID]()
 		{
 			//
 			auto* track = findTrack(trackID);
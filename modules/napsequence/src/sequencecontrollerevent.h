@@ -85,7 +85,7 @@ namespace nap
 	{
 		SequenceTrackSegment* return_ptr = nullptr;
 
-		performEditAction([this, trackID, time, &return_ptr]() mutable
+		performEditAction(trackID, [this, trackID, time, &return_ptr]() mutable
 		{
 			// create new segment & set parameters
 			std::unique_ptr<SEGMENT_TYPE> new_segment = std::make_unique<SEGMENT_TYPE>();
@@ -113,7 +113,7 @@ namespace nap
 	template<typename T>
 	void SequenceControllerEvent::editEventSegment(const std::string& trackID, const std::string& segmentID, const T& value)
 	{
-		performEditAction([this, trackID, segmentID, value]()
+		performEditAction(trackID, [this, trackID, segmentID, value]()
 		{
 			SequenceTrack* track = findTrack(trackID);
 			assert(track != nullptr); // track not found
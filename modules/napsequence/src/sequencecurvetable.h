@@ -0,0 +1,115 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// local includes
+#include "sequencetracksegmentcurve.h"
+
+// external includes
+#include <vector>
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * Lookup table of uniformly sampled values of a curve segment.
+	 * Evaluating a baked segment is a single linear interpolation in between two samples,
+	 * instead of a search for the curve point and a bisection of the bezier curve for every channel.
+	 * Segments that contain stepped curve points can't be baked, interpolation would smooth the steps.
+	 */
+	template<typename T>
+	class SequenceCurveTable final
+	{
+	public:
+		/**
+		 * Bake state of the table
+		 */
+		enum class EState : int
+		{
+			Empty		= 0,		///< Not baked yet
+			Baked		= 1,		///< Baked, evaluate() can be called
+			Unsupported	= 2			///< Segment can't be baked, evaluate the segment instead
+		};
+
+		/**
+		 * Samples the given segment at uniform positions from start to end
+		 * @param segment the segment to sample
+		 * @param resolution number of samples, at least 2
+		 * @return if the segment was baked
+		 */
+		bool bake(const SequenceTrackSegmentCurve<T>& segment, int resolution);
+
+		/**
+		 * Clears the table
+		 */
+		void clear()								{ mSamples.clear(); mState = EState::Empty; }
+
+		/**
+		 * @return the bake state of the table
+		 */
+		EState getState() const						{ return mState; }
+
+		/**
+		 * Returns the interpolated value at the given position, the table must be baked.
+		 * @param pos position in the segment, 0 = start, 1 = end, clamped
+		 * @return interpolated value at the given position
+		 */
+		T evaluate(float pos) const;
+
+	private:
+		std::vector<T>	mSamples;					///< Sampled values
+		float			mScale = 0.0f;				///< Number of sample intervals
+		EState			mState = EState::Empty;		///< Bake state
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// Template definitions
+	//////////////////////////////////////////////////////////////////////////
+
+	template<typename T>
+	bool SequenceCurveTable<T>::bake(const SequenceTrackSegmentCurve<T>& segment, int resolution)
+	{
+		mSamples.clear();
+		for (const auto& curve : segment.mCurves)
+		{
+			for (const auto& point : curve->mPoints)
+			{
+				if (point.mInterp == math::ECurveInterp::Stepped)
+				{
+					mState = EState::Unsupported;
+					return false;
+				}
+			}
+		}
+
+		int count = resolution < 2 ? 2 : resolution;
+		mSamples.resize(count);
+		for (int i = 0; i < count; i++)
+			mSamples[i] = segment.getValue(static_cast<float>(i) / static_cast<float>(count - 1));
+
+		mScale = static_cast<float>(count - 1);
+		mState = EState::Baked;
+		return true;
+	}
+
+
+	template<typename T>
+	T SequenceCurveTable<T>::evaluate(float pos) const
+	{
+		assert(mState == EState::Baked);
+
+		// Position of the sample before pos, the last interval includes the end
+		float x = (pos < 0.0f ? 0.0f : (pos > 1.0f ? 1.0f : pos)) * mScale;
+		int index = static_cast<int>(x);
+		index = index < static_cast<int>(mScale) ? index : static_cast<int>(mScale) - 1;
+
+		// All channels are interpolated at once
+		const T& a = mSamples[index];
+		const T& b = mSamples[index + 1];
+		return a + (b - a) * (x - static_cast<float>(index));
+	}
+}
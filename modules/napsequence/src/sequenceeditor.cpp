@@ -240,4 +240,16 @@ namespace nap
 			mPerformingEditAction = false;
 		}
 	}
+
+
+	void SequenceEditor::performEditAction(const std::string& trackID, std::function<void()> action)
+	{
+		assert(!mPerformingEditAction); // already performing action, only possible when doing an edit action inside another action
+		if (!mPerformingEditAction)
+		{
+			mPerformingEditAction = true;
+			mSequencePlayer->performEditAction(trackID, action);
+			mPerformingEditAction = false;
+		}
+	}
 }
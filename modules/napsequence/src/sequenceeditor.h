@@ -132,6 +132,13 @@ namespace nap
 		 */
 		void performEditAction(std::function<void()> action);
 
+		/**
+		 * performs edit action that only edits a single track when mutex of player is unlocked, is blocking
+		 * @param trackID the id of the edited track
+		 * @param action the edit action
+		 */
+		void performEditAction(const std::string& trackID, std::function<void()> action);
+
 		// make sure we don't perform two edit actions at the same time ( only possible when performing an edit action inside another edit action )
 		// edit actions are performed on player thread but block main thread
 		bool mPerformingEditAction = false;
@@ -5,6 +5,8 @@
 // local includes
 #include "sequenceplayer.h"
 #include "sequenceutils.h"
+#include "sequencebinary.h"
+#include "sequenceservice.h"
 
 // nap include
 #include <nap/logger.h>
@@ -17,11 +19,14 @@
 #include <rtti/jsonreader.h>
 #include <rtti/defaultlinkresolver.h>
 #include <fstream>
+#include <algorithm>
 
-RTTI_BEGIN_CLASS(nap::SequencePlayer)
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequencePlayer)
+RTTI_CONSTRUCTOR(nap::SequenceService&)
 RTTI_PROPERTY("Default Show", &nap::SequencePlayer::mSequenceFileName, nap::rtti::EPropertyMetaData::Default)
 RTTI_PROPERTY("Outputs", &nap::SequencePlayer::mOutputs, nap::rtti::EPropertyMetaData::Embedded)
 RTTI_PROPERTY("Frequency", &nap::SequencePlayer::mFrequency, nap::rtti::EPropertyMetaData::Default)
+RTTI_PROPERTY("Clock", &nap::SequencePlayer::mClock, nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 //////////////////////////////////////////////////////////////////////////
@@ -29,7 +34,14 @@ RTTI_END_CLASS
 
 namespace nap
 {
-	SequencePlayer::SequencePlayer()
+	static bool register_object_creator = SequenceService::registerObjectCreator([](SequenceService* service)->std::unique_ptr<rtti::IObjectCreator>
+	{
+		return std::make_unique<SequencePlayerObjectCreator>(*service);
+	});
+
+
+	SequencePlayer::SequencePlayer(SequenceService& service) :
+		mService(&service)
 	{
 	}
 
@@ -64,11 +76,19 @@ namespace nap
 
 	bool SequencePlayer::start(utility::ErrorState& errorState)
 	{
+		// use a threaded clock at the set frequency when no clock is linked
+		mActiveClock = mClock.get();
+		if (mActiveClock == nullptr)
+		{
+			mDefaultClock = std::make_unique<SequencePlayerThreadedClock>();
+			mDefaultClock->mFrequency = mFrequency;
+			mActiveClock = mDefaultClock.get();
+		}
 
-		// launch player thread
-		mUpdateThreadRunning = true;
-		mBefore = HighResolutionClock::now();
-		mUpdateTask = std::async(std::launch::async, std::bind(&SequencePlayer::onUpdate, this));
+		// start calling the player, replaced adapters are destroyed by the service
+		mService->registerPlayer(*this);
+		mTickStamp = HighResolutionClock::now().time_since_epoch().count();
+		mActiveClock->start(mUpdateSlot);
 
 		return true;
 	}
@@ -76,15 +96,21 @@ namespace nap
 
 	void SequencePlayer::stop()
 	{
-		// stop running thread
-		mUpdateThreadRunning = false;
-		if (mUpdateTask.valid())
+		// stop clock, the player is not called anymore after this
+		if (mActiveClock != nullptr)
 		{
-			mUpdateTask.wait();
+			mActiveClock->stop();
+			mActiveClock = nullptr;
 		}
+		mDefaultClock.reset();
 
-		// clear adapters
-		mAdapters.clear();
+		// clear adapters, the clock released all snapshots
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			publishSnapshot(nullptr);
+			destroyRetiredSnapshots();
+		}
+		mService->removePlayer(*this);
 	}
 
 
@@ -98,15 +124,15 @@ namespace nap
 			if( !was_playing )
 				createAdapters();
 
-			mIsPlaying = true;
 			mIsPaused = false;
+			mIsPlaying = true;
 		}
 		else
 		{
-			destroyAdapters();
-
 			mIsPlaying = false;
 			mIsPaused  = false;
+
+			destroyAdapters();
 		}
 		lock.unlock();
 		playStateChanged(*this, isPlaying);
@@ -115,10 +141,8 @@ namespace nap
 
 	void SequencePlayer::setIsPaused(bool isPaused)
 	{
-		{
-			std::lock_guard<std::mutex> lock(mMutex);
-			mIsPaused = isPaused;
-		}
+		mIsPaused = isPaused;
+		mTickStamp = HighResolutionClock::now().time_since_epoch().count();
 		pauseStateChanged(*this, isPaused);
 	}
 
@@ -133,6 +157,10 @@ namespace nap
 
 		std::string show_path = dir + '/' + name;
 
+		// Write compact binary sequence when requested by extension
+		if (utility::getFileExtension(name) == sequencebinary::extension)
+			return sequencebinary::save(*mSequence, show_path, errorState);
+
 		// Serialize current set of parameters to json
 		rtti::JSONWriter writer;
 		if (!rtti::serializeObjects(rtti::ObjectList{ mSequence }, writer, errorState))
@@ -166,20 +194,29 @@ namespace nap
 
 		std::string timeline_name = utility::getFileNameWithoutExtension(name);
 
-		// 
-		rtti::Factory factory;
-		if (!rtti::deserializeJSONFile(
-			show_path,
-			rtti::EPropertyValidationMode::DisallowMissingProperties,
-			rtti::EPointerPropertyMode::NoRawPointers,
-			factory,
-			result,
-			errorState))
-			return false;
+		if (sequencebinary::isBinary(show_path))
+		{
+			// Binary sequences are created with all links in place
+			if (sequencebinary::load(show_path, result.mReadObjects, errorState) == nullptr)
+				return false;
+		}
+		else
+		{
+			// 
+			rtti::Factory factory;
+			if (!rtti::deserializeJSONFile(
+				show_path,
+				rtti::EPropertyValidationMode::DisallowMissingProperties,
+				rtti::EPointerPropertyMode::NoRawPointers,
+				factory,
+				result,
+				errorState))
+				return false;
 
-		// Resolve links
-		if (!rtti::DefaultLinkResolver::sResolveLinks(result.mReadObjects, result.mUnresolvedPointers, errorState))
-			return false;
+			// Resolve links
+			if (!rtti::DefaultLinkResolver::sResolveLinks(result.mReadObjects, result.mUnresolvedPointers, errorState))
+				return false;
+		}
 
 		// Move ownership of read objects
 		mReadObjects.clear();
@@ -223,25 +260,92 @@ namespace nap
 
 	void SequencePlayer::createAdapters()
 	{
-		// create adapters
-		mAdapters.clear();
+		// create adapters in a new snapshot, the current snapshot keeps playing until the new one is published
+		auto snapshot = std::make_shared<Snapshot>();
+		snapshot->mDuration = mSequence->mDuration;
 		for (auto& track : mSequence->mTracks)
 		{
-			createAdapter(track->mAssignedOutputID, track->mID);
+			createAdapter(*snapshot, track->mAssignedOutputID, track->mID);
 		}
 
-		std::function<void(const std::string&, std::unique_ptr<SequencePlayerAdapter>)> add_adapter_function = [this](const std::string& outputID, std::unique_ptr<SequencePlayerAdapter> adapter)
+		std::function<void(const std::string&, std::unique_ptr<SequencePlayerAdapter>)> add_adapter_function = [&snapshot](const std::string& outputID, std::unique_ptr<SequencePlayerAdapter> adapter)
 		{
-			mAdapters.emplace(outputID, std::move(adapter));
+			snapshot->mAdapters.emplace(outputID, std::move(adapter));
 		};
 
 		adaptersCreated.trigger(add_adapter_function);
+		publishSnapshot(std::move(snapshot));
+	}
+
+
+	void SequencePlayer::updateAdapter(const std::string& trackID)
+	{
+		// nothing to share adapters with
+		std::shared_ptr<Snapshot> current = std::atomic_load(&mSnapshot);
+		if (current == nullptr)
+		{
+			createAdapters();
+			return;
+		}
+
+		// copy the current snapshot, it is never modified because the clock might be playing it
+		auto snapshot = std::make_shared<Snapshot>(*current);
+		snapshot->mDuration = mSequence->mDuration;
+		snapshot->mAdapters.erase(trackID);
+
+		// tracks that aren't assigned to a standard output might be played by a custom adapter,
+		// these are only created together with all other adapters
+		auto track = std::find_if(mSequence->mTracks.begin(), mSequence->mTracks.end(), [&trackID](const auto& a_track)
+		{
+			return a_track->mID == trackID;
+		});
+		if (track != mSequence->mTracks.end() && !(*track)->mAssignedOutputID.empty() &&
+			!createAdapter(*snapshot, (*track)->mAssignedOutputID, trackID))
+		{
+			createAdapters();
+			return;
+		}
+		publishSnapshot(std::move(snapshot));
 	}
 
 
 	void SequencePlayer::destroyAdapters()
 	{
-		mAdapters.clear();
+		publishSnapshot(nullptr);
+	}
+
+
+	void SequencePlayer::publishSnapshot(std::shared_ptr<Snapshot> snapshot)
+	{
+		// the clock can't acquire the previous snapshot anymore, but a tick might still be playing it
+		std::shared_ptr<Snapshot> previous = std::atomic_exchange(&mSnapshot, std::move(snapshot));
+		if (previous != nullptr)
+			mRetiredSnapshots.emplace_back(std::move(previous));
+	}
+
+
+	void SequencePlayer::destroyRetiredSnapshots()
+	{
+		// a snapshot that is only referenced here is released by the clock and can't be acquired again.
+		// adapters unregister from their outputs when destroyed, which must not happen on the clock thread
+		auto it = mRetiredSnapshots.begin();
+		while (it != mRetiredSnapshots.end())
+		{
+			if (it->use_count() > 1)
+			{
+				++it;
+				continue;
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+			it = mRetiredSnapshots.erase(it);
+		}
+	}
+
+
+	void SequencePlayer::update()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		destroyRetiredSnapshots();
 	}
 
 
@@ -265,20 +369,17 @@ namespace nap
 
 	void SequencePlayer::setPlayerTime(double time)
 	{
-		{
-			std::lock_guard<std::mutex> lock(mMutex);
-			mTime = math::clamp<double>(time, 0.0, mSequence->mDuration);
-		}
-		playerTimeChanged(*this, mTime);
+		// picked up by the next tick, a tick in progress doesn't overwrite it
+		double new_time = math::clamp<double>(time, 0.0, mSequence->mDuration);
+		mTime = new_time;
+		mTickStamp = HighResolutionClock::now().time_since_epoch().count();
+		playerTimeChanged(*this, new_time);
 	}
 
 
 	void SequencePlayer::setPlaybackSpeed(float speed)
 	{
-		{
-			std::lock_guard<std::mutex> lock(mMutex);
-			mSpeed	  = speed;
-		}
+		mSpeed = speed;
 		playbackSpeedChanged(*this, speed);
 	}
 
@@ -289,6 +390,28 @@ namespace nap
 	}
 
 
+	double SequencePlayer::getPlayerTimeInterpolated() const
+	{
+		double time = mTime;
+		if (!mIsPlaying || mIsPaused)
+			return time;
+
+		// don't extrapolate further than a single tick, the clock might have stalled or stopped
+		HighResTimeStamp stamp(HighResolutionClock::duration(mTickStamp.load()));
+		double elapsed = std::chrono::duration<double>(HighResolutionClock::now() - stamp).count();
+		elapsed = math::clamp<double>(elapsed, 0.0, mTickInterval);
+
+		double duration = mSequence->mDuration;
+		time += elapsed * static_cast<double>(mSpeed);
+		if (mIsLooping && duration > 0.0)
+		{
+			time = fmod(time, duration);
+			return time < 0.0 ? time + duration : time;
+		}
+		return math::clamp<double>(time, 0.0, duration);
+	}
+
+
 	bool SequencePlayer::getIsPlaying() const
 	{
 		return mIsPlaying;
@@ -303,7 +426,6 @@ namespace nap
 
 	void SequencePlayer::setIsLooping(bool isLooping)
 	{
-		std::lock_guard<std::mutex> lock(mMutex);
 		mIsLooping = isLooping;
 	}
 
@@ -320,61 +442,59 @@ namespace nap
 	}
 
 	
-	void SequencePlayer::onUpdate()
+	void SequencePlayer::onUpdate(double deltaTime)
 	{
-		// Compute sleep time in microseconds 
-		float sleep_time_microf = 1000.0f / static_cast<float>(mFrequency);
-		long  sleep_time_micro = static_cast<long>(sleep_time_microf * 1000.0f);
+		if (!mIsPlaying)
+			return;
 
-		while (mUpdateThreadRunning)
-		{
-			// advance time
-			HighResTimeStamp now = HighResolutionClock::now();
-			double delta_time = std::chrono::duration<double>(now - mBefore).count();
-			mBefore = now;
+		// notify lister, so data model of sequence and data of player can be modified by listeners to this signal
+		preTick.trigger(*this);
 
-			if (mIsPlaying)
+		// adapters of this tick, edits publish a new snapshot and never block the clock.
+		// the snapshot is released before notifying listeners, they are allowed to publish
+		std::shared_ptr<Snapshot> snapshot = std::atomic_load(&mSnapshot);
+		if (snapshot != nullptr)
+		{
+			// advance time, a time set while advancing wins
+			double time = mTime;
+			if (!mIsPaused)
 			{
-				// notify lister, so data model of sequence and data of player can be modified by listeners to this signal
-				preTick.trigger(*this);	
-
-				// Update time and adapters thread safe
+				double duration = snapshot->mDuration;
+				double new_time = time + deltaTime * static_cast<double>(mSpeed.load());
+				if (mIsLooping)
 				{
-					std::lock_guard<std::mutex> lock(mMutex);
-					if (!mIsPaused)
+					if (new_time < 0.0)
 					{
-						mTime += delta_time * (double)mSpeed;
-						if (mIsLooping)
-						{
-							if (mTime < 0.0)
-							{
-								mTime = mSequence->mDuration + mTime;
-							}
-							else if (mTime > mSequence->mDuration)
-							{
-								mTime = fmod(mTime, mSequence->mDuration);
-							}
-						}
-						else
-						{
-							mTime = math::clamp<double>(mTime, 0.0, mSequence->mDuration);
-						}
+						new_time = duration + new_time;
 					}
-
-					// Update adapters
-					for (auto& adapter : mAdapters)
-						adapter.second->tick(mTime);
+					else if (new_time > duration)
+					{
+						new_time = fmod(new_time, duration);
+					}
+				}
+				else
+				{
+					new_time = math::clamp<double>(new_time, 0.0, duration);
 				}
 
-				// Notify listeners
-				postTick.trigger(*this);
+				if (mTime.compare_exchange_strong(time, new_time))
+					time = new_time;
 			}
-			std::this_thread::sleep_for(std::chrono::microseconds(sleep_time_micro));
+			mTickStamp = HighResolutionClock::now().time_since_epoch().count();
+			mTickInterval = deltaTime;
+
+			// Update adapters
+			for (auto& adapter : snapshot->mAdapters)
+				adapter.second->tick(time);
+			snapshot.reset();
 		}
+
+		// Notify listeners
+		postTick.trigger(*this);
 	}
 
 
-	bool SequencePlayer::createAdapter(const std::string& inputID, const std::string& trackID)
+	bool SequencePlayer::createAdapter(Snapshot& snapshot, const std::string& inputID, const std::string& trackID)
 	{
 		// bail if empty output id
 		if (inputID == "")
@@ -399,9 +519,9 @@ namespace nap
 		}
 
 		// erase previous adapter
-		if (mAdapters.find(track->mID) != mAdapters.end())
+		if (snapshot.mAdapters.find(track->mID) != snapshot.mAdapters.end())
 		{
-			mAdapters.erase(track->mID);
+			snapshot.mAdapters.erase(track->mID);
 		}
 
 		SequencePlayerOutput* output = nullptr;
@@ -430,7 +550,7 @@ namespace nap
 			return false;
 		}
 
-		mAdapters.emplace(track->mID, std::move(adapter));
+		snapshot.mAdapters.emplace(track->mID, std::move(adapter));
 
 		return true;
 	}
@@ -440,6 +560,21 @@ namespace nap
 	{
 		std::lock_guard<std::mutex> lock(mMutex);
 		action();
+
+		// publish the edited sequence, adapters copy the tracks they play
+		if (mIsPlaying)
+			createAdapters();
+	}
+
+
+	void SequencePlayer::performEditAction(const std::string& trackID, std::function<void()> action)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		action();
+
+		// only the edited track is copied again
+		if (mIsPlaying)
+			updateAdapter(trackID);
 	}
 
 
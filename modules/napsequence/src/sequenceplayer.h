@@ -8,14 +8,18 @@
 #include "sequence.h"
 #include "sequenceplayeradapter.h"
 #include "sequenceplayeroutput.h"
+#include "sequenceplayerclock.h"
 
 // external includes
 #include <rtti/factory.h>
 #include <nap/device.h>
 #include <nap/signalslot.h>
-#include <future>
+#include <nap/resourceptr.h>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <nap/timer.h>
+#include <nap/numeric.h>
 
 namespace nap
 {
@@ -25,21 +29,29 @@ namespace nap
 
 	/**
 	 * The sequence player is responsible for loading / playing and saving a sequence
-	 * The player dispatches a thread which reads the sequence. Actions for each track of the sequence are handle by SequencePlayerAdapters
+	 * The player is driven by a SequencePlayerClock. Actions for each track of the sequence are handle by SequencePlayerAdapters
 	 * A Sequence can only be edited by a derived class from SequenceController and SequenceEditor
 	 * Sequence Player owns all Sequence objects 
+	 *
+	 * Adapters are published to the clock as an immutable snapshot. After every edit a new snapshot is created on the
+	 * editing thread and swapped in atomically, the clock never waits for the editor.
+	 * Replaced snapshots are destroyed on the main thread by the SequenceService, once the clock released them.
+	 * Adapters copy the track data they need, so the sequence can be edited while a snapshot is played.
+	 * An edit of a single track only recreates the adapter of that track, the other adapters are shared with the previous snapshot.
 	 */
 	class NAPAPI SequencePlayer : public Device
 	{
 		friend class SequenceEditor;
 		friend class SequenceController;
+		friend class SequenceService;
 
 		RTTI_ENABLE(Device)
 	public:
 		/**
 		 * Constructor used by factory
+		 * @param service the sequence service that destroys replaced adapters on the main thread
 		 */
-		SequencePlayer();
+		SequencePlayer(SequenceService& service);
 
 		/**
 		 * Evaluates the data of the player. It loads the linked default sequence. 
@@ -50,7 +62,7 @@ namespace nap
 		bool init(utility::ErrorState& errorState) override;
 
 		/**
-		 * Saves current sequence to disk
+		 * Saves current sequence to disk, as compact binary when the name has the .bseq extension, otherwise as json
 		 * @param name of the sequence
 		 * @param errorState contains error upon failure
 		 * @return true on success
@@ -58,7 +70,7 @@ namespace nap
 		bool save(const std::string& name, utility::ErrorState& errorState);
 
 		/**
-		 * Load a sequence
+		 * Load a sequence, json or compact binary
 		 * @param name of the sequence
 		 * @param errorState contains error upon failure
 		 * @return true on success
@@ -96,10 +108,17 @@ namespace nap
 		void setPlaybackSpeed(float speed);
 
 		/**
-		 * @return the current player time
+		 * @return the current player time, the time of the last tick
 		 */
 		double getPlayerTime() const;
 
+		/**
+		 * Returns the player time extrapolated from the last tick to now, using the playback speed.
+		 * Use this to draw or sync with playback in between ticks, for example when the clock runs at a low rate.
+		 * @return the current player time, interpolated in between ticks
+		 */
+		double getPlayerTimeInterpolated() const;
+
 		/**
 		 * @return gets sequence total duration
 		 */
@@ -126,13 +145,13 @@ namespace nap
 		float getPlaybackSpeed() const;
 
 		/**
-		 * called before deconstruction. This stops the actual player thread. To stop the player but NOT the player thread call setIsPlaying( false )
+		 * called before deconstruction. This stops the clock and removes the player from the service. To stop the player but NOT the clock call setIsPlaying( false )
 		 */
 		virtual void stop() override;
 
 		/**
-		 * starts player thread, called after successfully initialization
-		 * This starts the actual player thread
+		 * starts the clock and registers the player with the service, called after successfully initialization
+		 * The clock calls the player from its own thread or from the main thread, depending on the clock
 		 */
 		virtual bool start(utility::ErrorState& errorState) override;
 
@@ -149,7 +168,8 @@ namespace nap
 		// properties
 		std::string 			mSequenceFileName; ///< Property: 'Default Sequence' linked default Sequence file
 		bool 					mCreateEmptySequenceOnLoadFail = true; ///< Property: 'Create Sequence on Failure' when true, the init will successes upon failure of loading default sequence and create an empty sequence
-		float					mFrequency = 1000.0f; ///< Property: 'Frequency' frequency of player thread
+		float					mFrequency = 1000.0f; ///< Property: 'Frequency' frequency of player thread, when no clock is set
+		ResourcePtr<SequencePlayerClock> mClock; ///< Property: 'Clock' optional clock that drives the player, a threaded clock at 'Frequency' is used when not set
 		std::vector<ResourcePtr<SequencePlayerOutput>> mOutputs;  ///< Property: 'Outputs' linked outputs
 	public:
 		// signals
@@ -185,6 +205,8 @@ namespace nap
 
 		/***
 		 *	preTick Signal is triggered on player thread, before updating the adapters
+		 *	Note: the adapters of this tick are already created, edits made by listeners are played from the next tick.
+		 *	The adapters an edit replaces are destroyed on the main thread, never on the player thread
 		 */
 		Signal<SequencePlayer&> preTick;
 
@@ -197,11 +219,21 @@ namespace nap
 		 * adptersCreated Signal is triggered from main thread, after creating adapters
 		 * This is useful for creating your own custom outputs & adapters for custom  tracks if necessary
 		 * You should do so only when writing your own player extended on SequencePlayer
-		 * It passes a reference to a lambda function that you can call to add an adapter to mAdapters member of
-		 * SequencePlayer
+		 * It passes a reference to a lambda function that you can call to add an adapter to the snapshot that is being created
+		 * Adapters are created again after every edit that isn't limited to a single track, and must copy the data they read from a track
 		 */
 		Signal<std::function<void(const std::string&, std::unique_ptr<SequencePlayerAdapter>)>&> adaptersCreated;
 	private:
+		/**
+		 * Immutable set of adapters, played by the clock.
+		 * The adapters are ticked, the set and the data they copied from the sequence never change.
+		 */
+		struct Snapshot
+		{
+			std::unordered_map<std::string, std::shared_ptr<SequencePlayerAdapter>> mAdapters;	///< adapters by track id, shared between snapshots
+			double mDuration = 0.0;																///< duration of the sequence
+		};
+
 		/**
 		 * returns reference to sequence
 		 */
@@ -210,16 +242,18 @@ namespace nap
 		/**
 		 * createAdapter
 		 * creates an adapter with string objectID for track with trackid. This searches the list of appropriate adapter types for the corresponding track id and creates it if available
+		 * @param snapshot the snapshot to add the adapter to
 		 * @param objectID the id of the adapter object
 		 * @param trackID the id of the track
 		 */
-		bool createAdapter(const std::string& objectID, const std::string& trackID);
+		bool createAdapter(Snapshot& snapshot, const std::string& objectID, const std::string& trackID);
 
 		/**
 		 * onUpdate
-		 * The threaded update function
+		 * Called by the clock, advances time and ticks the adapters of the current snapshot
+		 * @param deltaTime elapsed time in seconds
 		 */
-		void onUpdate();
+		void onUpdate(double deltaTime);
 
 		// read objects from sequence
 		std::vector<std::unique_ptr<rtti::Object>>	mReadObjects;
@@ -228,53 +262,101 @@ namespace nap
 		std::unordered_set<std::string>				mReadObjectIDs;
 	private:
 		/**
-		 * creates adapters for all assigned adapter ids for tracks
-		 * this function gets called by the player when player starts playing
+		 * creates adapters for all assigned adapter ids for tracks and publishes them as a new snapshot
+		 * this function gets called by the player when player starts playing and after every edit
 		 */
 		void createAdapters();
 
+		/**
+		 * recreates the adapter of a single track and publishes it as a new snapshot
+		 * the adapters of all other tracks are shared with the current snapshot
+		 * @param trackID the id of the edited track
+		 */
+		void updateAdapter(const std::string& trackID);
+
 		/**
 		 * destroys all created adapters, gets called on stop
 		 */
 		void destroyAdapters();
 
 		/**
-		 * performs given action when mutex is unlocked, makes sure edit action on sequence are thread safe
+		 * swaps in the given snapshot and retires the previous one, never waits for the clock.
+		 * can be called from any thread, retired snapshots are destroyed on the main thread
+		 * @param snapshot the new snapshot, can be null
+		 */
+		void publishSnapshot(std::shared_ptr<Snapshot> snapshot);
+
+		/**
+		 * destroys all retired snapshots the clock released, must be called on the main thread.
+		 * adapters unregister from their outputs when destroyed, outputs are updated on the main thread
+		 */
+		void destroyRetiredSnapshots();
+
+		/**
+		 * called from the sequence service on the main thread, destroys the retired snapshots the clock released
+		 */
+		void update();
+
+		/**
+		 * performs given action when mutex is unlocked, makes sure edit actions on sequence are serialized
+		 * publishes a new snapshot after the action when playing
 		 * @param action the edit action
 		 */
 		void performEditAction(std::function<void()> action);
 
-		// the update task
-		std::future<void>	mUpdateTask;
+		/**
+		 * performs given action that only edits the given track, makes sure edit actions on sequence are serialized
+		 * publishes a new snapshot after the action when playing, only the adapter of the edited track is recreated
+		 * @param trackID the id of the edited track
+		 * @param action the edit action
+		 */
+		void performEditAction(const std::string& trackID, std::function<void()> action);
 
-		// mutex
+		// mutex, serializes edits, loading and saving. never locked by the clock
 		std::mutex mMutex;
 
+		// service that calls update on the main thread
+		SequenceService* mService = nullptr;
+
 		// raw pointer to loaded sequence
 		Sequence* mSequence = nullptr;
 
-		// true when thread is running
-		bool mUpdateThreadRunning;
-
 		// is playing
-		bool mIsPlaying = false;
+		std::atomic<bool> mIsPlaying = { false };
 
 		// is paused
-		bool mIsPaused = false;
+		std::atomic<bool> mIsPaused = { false };
 
 		// is looping
-		bool mIsLooping = false;
+		std::atomic<bool> mIsLooping = { false };
 
 		// speed
-		float mSpeed = 1.0f;
+		std::atomic<float> mSpeed = { 1.0f };
 
 		// current time
-		double mTime = 0.0;
+		std::atomic<double> mTime = { 0.0 };
+
+		// time stamp of the last tick or seek, in ticks of the high resolution clock
+		std::atomic<int64> mTickStamp = { 0 };
+
+		// elapsed time in seconds in between the last two ticks, limits interpolation
+		std::atomic<double> mTickInterval = { 0.0 };
+
+		// clock used when no clock is set
+		std::unique_ptr<SequencePlayerThreadedClock> mDefaultClock;
 
-		// Used to update sequence time
-		HighResTimeStamp mBefore;
+		// clock that drives the player
+		SequencePlayerClock* mActiveClock = nullptr;
 
-		// list of instantiated adapters
-		std::unordered_map<std::string, std::unique_ptr<SequencePlayerAdapter>> mAdapters;
+		// slot called by the clock
+		Slot<double> mUpdateSlot = { this, &SequencePlayer::onUpdate };
+
+		// adapters played by the clock, only accessed using std::atomic_load and std::atomic_exchange
+		std::shared_ptr<Snapshot> mSnapshot;
+
+		// snapshots replaced while the clock might still play them, destroyed once released. guarded by mMutex
+		std::vector<std::shared_ptr<Snapshot>> mRetiredSnapshots;
 	};
+
+	using SequencePlayerObjectCreator = rtti::ObjectCreator<SequencePlayer, SequenceService>;
 }
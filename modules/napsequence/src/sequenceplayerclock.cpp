@@ -0,0 +1,108 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// local includes
+#include "sequenceplayerclock.h"
+#include "sequenceservice.h"
+
+// external includes
+#include <mathutils.h>
+#include <thread>
+
+RTTI_DEFINE_BASE(nap::SequencePlayerClock)
+
+RTTI_BEGIN_CLASS(nap::SequencePlayerThreadedClock)
+RTTI_PROPERTY("Frequency", &nap::SequencePlayerThreadedClock::mFrequency, nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequencePlayerStandardClock)
+RTTI_CONSTRUCTOR(nap::SequenceService&)
+RTTI_END_CLASS
+
+namespace nap
+{
+	static bool register_object_creator = SequenceService::registerObjectCreator([](SequenceService* service)->std::unique_ptr<rtti::IObjectCreator>
+	{
+		return std::make_unique<SequencePlayerStandardClockObjectCreator>(*service);
+	});
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// SequencePlayerThreadedClock
+	//////////////////////////////////////////////////////////////////////////
+
+	void SequencePlayerThreadedClock::start(Slot<double>& updateSlot)
+	{
+		assert(!mRunning);
+		mSlot = &updateSlot;
+		mRunning = true;
+		mUpdateTask = std::async(std::launch::async, std::bind(&SequencePlayerThreadedClock::onUpdate, this));
+	}
+
+
+	void SequencePlayerThreadedClock::stop()
+	{
+		mRunning = false;
+		if (mUpdateTask.valid())
+		{
+			mUpdateTask.wait();
+		}
+		mSlot = nullptr;
+	}
+
+
+	void SequencePlayerThreadedClock::onUpdate()
+	{
+		auto interval = std::chrono::duration_cast<HighResolutionClock::duration>(
+			std::chrono::duration<double>(1.0 / static_cast<double>(math::max<float>(mFrequency, 1.0f))));
+
+		HighResTimeStamp before = HighResolutionClock::now();
+		HighResTimeStamp deadline = before + interval;
+		while (mRunning)
+		{
+			std::this_thread::sleep_until(deadline);
+
+			// measure elapsed time, sleeping is never exact
+			HighResTimeStamp now = HighResolutionClock::now();
+			double delta_time = std::chrono::duration<double>(now - before).count();
+			before = now;
+			mSlot->trigger(delta_time);
+
+			// skip deadlines that have passed, don't try to catch up after a stall
+			deadline += interval;
+			if (deadline < now)
+				deadline = now + interval;
+		}
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// SequencePlayerStandardClock
+	//////////////////////////////////////////////////////////////////////////
+
+	SequencePlayerStandardClock::SequencePlayerStandardClock(SequenceService& service)
+		: mService(&service)
+	{
+	}
+
+
+	void SequencePlayerStandardClock::start(Slot<double>& updateSlot)
+	{
+		mSlot = &updateSlot;
+		mService->registerClock(*this);
+	}
+
+
+	void SequencePlayerStandardClock::stop()
+	{
+		mService->removeClock(*this);
+		mSlot = nullptr;
+	}
+
+
+	void SequencePlayerStandardClock::update(double deltaTime)
+	{
+		mSlot->trigger(deltaTime);
+	}
+}
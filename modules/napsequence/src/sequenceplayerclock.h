@@ -0,0 +1,110 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// external includes
+#include <nap/resource.h>
+#include <nap/signalslot.h>
+#include <nap/datetime.h>
+#include <rtti/factory.h>
+#include <atomic>
+#include <future>
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+	// forward declares
+	class SequenceService;
+
+	/**
+	 * A SequencePlayerClock drives a SequencePlayer. When started, the clock calls the given update slot with the
+	 * time in seconds that passed since the previous call. The thread the slot is called from depends on the clock.
+	 * A clock drives a single player at a time.
+	 */
+	class NAPAPI SequencePlayerClock : public Resource
+	{
+		RTTI_ENABLE(Resource)
+	public:
+		/**
+		 * Starts calling the update slot, called by the player when it starts
+		 * @param updateSlot slot to call with the elapsed time in seconds
+		 */
+		virtual void start(Slot<double>& updateSlot) = 0;
+
+		/**
+		 * Stops calling the update slot, called by the player when it stops.
+		 * The slot is not called anymore after this function returns.
+		 */
+		virtual void stop() = 0;
+	};
+
+
+	/**
+	 * Calls the update slot from its own thread at a fixed frequency.
+	 * Deadlines are absolute, the time a tick takes doesn't lower the frequency.
+	 * The elapsed time is measured, not derived from the frequency.
+	 */
+	class NAPAPI SequencePlayerThreadedClock : public SequencePlayerClock
+	{
+		RTTI_ENABLE(SequencePlayerClock)
+	public:
+		/**
+		 * Starts the clock thread
+		 * @param updateSlot slot to call with the elapsed time in seconds
+		 */
+		void start(Slot<double>& updateSlot) override;
+
+		/**
+		 * Stops and waits for the clock thread
+		 */
+		void stop() override;
+
+		float mFrequency = 1000.0f;		///< Property: 'Frequency' number of updates per second
+	private:
+		// the threaded update function
+		void onUpdate();
+
+		Slot<double>*		mSlot = nullptr;
+		std::future<void>	mUpdateTask;
+		std::atomic<bool>	mRunning = { false };
+	};
+
+
+	/**
+	 * Calls the update slot from the main thread, when the SequenceService is updated.
+	 * Useful to sync playback with the render frame, the elapsed time is the frame time.
+	 */
+	class NAPAPI SequencePlayerStandardClock : public SequencePlayerClock
+	{
+		friend class SequenceService;
+
+		RTTI_ENABLE(SequencePlayerClock)
+	public:
+		/**
+		 * Constructor
+		 * @param service the sequence service that updates this clock
+		 */
+		SequencePlayerStandardClock(SequenceService& service);
+
+		/**
+		 * Registers with the service
+		 * @param updateSlot slot to call with the elapsed time in seconds
+		 */
+		void start(Slot<double>& updateSlot) override;
+
+		/**
+		 * Removes itself from the service
+		 */
+		void stop() override;
+	private:
+		// called from the sequence service on the main thread
+		void update(double deltaTime);
+
+		SequenceService*	mService = nullptr;
+		Slot<double>*		mSlot = nullptr;
+	};
+
+	using SequencePlayerStandardClockObjectCreator = rtti::ObjectCreator<SequencePlayerStandardClock, SequenceService>;
+}
@@ -17,22 +17,22 @@ namespace nap
 
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterFloat))
 		{
-            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterFloat, float>>(track, curve_output);
+            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterFloat, float>>(track, curve_output, player);
 		}
 
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterLong))
 		{
-            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterLong, long>>(track, curve_output);
+            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterLong, long>>(track, curve_output, player);
 		}
 
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterDouble))
 		{
-            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterDouble, double>>(track, curve_output);
+            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterDouble, double>>(track, curve_output, player);
 		}
 
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterInt))
 		{
-            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterInt, int>>(track, curve_output);
+            return std::make_unique<SequencePlayerCurveAdapter<float, ParameterInt, int>>(track, curve_output, player);
 		}
 
 		assert(false); // no correct parameter type found!
@@ -50,7 +50,7 @@ namespace nap
 		assert(curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterVec2)); // type mismatch
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterVec2))
 		{
-            return std::make_unique<SequencePlayerCurveAdapter<glm::vec2, ParameterVec2, glm::vec2>>(track, curve_output);
+            return std::make_unique<SequencePlayerCurveAdapter<glm::vec2, ParameterVec2, glm::vec2>>(track, curve_output, player);
 		}
 
 		return nullptr;
@@ -67,7 +67,7 @@ namespace nap
 		assert(curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterVec3)); // type mismatch
 		if (curve_output.mParameter.get()->get_type() == RTTI_OF(ParameterVec3))
 		{
-			return std::make_unique<SequencePlayerCurveAdapter<glm::vec3, ParameterVec3, glm::vec3>>(track, curve_output);
+			return std::make_unique<SequencePlayerCurveAdapter<glm::vec3, ParameterVec3, glm::vec3>>(track, curve_output, player);
 		}
 
 		return nullptr;
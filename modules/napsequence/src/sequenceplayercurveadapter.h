@@ -9,9 +9,13 @@
 #include "sequenceplayeradapter.h"
 #include "sequenceplayercurveoutput.h"
 #include "sequencetrackcurve.h"
+#include "sequencetracksegmentindex.h"
+#include "sequencecurvetable.h"
 
 // nap includes
 #include <nap/logger.h>
+#include <rtti/rttiutilities.h>
+#include <utility/triplebuffer.h>
 #include <parametervec.h>
 #include <parameternumeric.h>
 
@@ -33,8 +37,11 @@ namespace nap
 	/**
 	 * Responsible for translating the value read on a curve track, to a parameter
 	 * When the user wants to do this on the main thread, it uses a SequencePlayerCurveOutput as an intermediate class to ensure thread safety,
-	 * SequencePlayerCurveOutput will then call setValue()
+	 * SequencePlayerCurveOutput will then call setValue(). Values are handed over using a lock-free triple buffer.
 	 * otherwise it sets the parameter value directly from the sequence player thread
+	 * The adapter plays a copy of the track, segments and curves, made when the adapter is created.
+	 * The segment at the current time is found using a SequenceTrackSegmentIndex.
+	 * When 'Bake Curves' is enabled on the output, segments are sampled into lookup tables when the adapter is created.
 	 */
 	template<typename CURVE_TYPE, typename PARAMETER_TYPE, typename PARAMETER_VALUE_TYPE>
 	class SequencePlayerCurveAdapter : public SequencePlayerCurveAdapterBase
@@ -44,12 +51,22 @@ namespace nap
 		 * Constructor
 		 * @param track reference to sequence track that holds curve information
 		 * @param output reference to curve output
+		 * @param player the player that creates and ticks this adapter
 		 */
-		SequencePlayerCurveAdapter(const SequenceTrack& track, SequencePlayerCurveOutput& output)
+		SequencePlayerCurveAdapter(const SequenceTrack& track, SequencePlayerCurveOutput& output, const SequencePlayer& player)
 			:	mParameter(static_cast<PARAMETER_TYPE&>(*output.mParameter.get())), mOutput(output)
 		{
 			assert(track.get_type().is_derived_from(RTTI_OF(SequenceTrackCurve<CURVE_TYPE>)));
-			mTrack = static_cast<const SequenceTrackCurve<CURVE_TYPE>*>(&track);
+			copyTrack(static_cast<const SequenceTrackCurve<CURVE_TYPE>&>(track));
+
+			// index segments and bake all curves up front
+			mIndex.build(*mTrack);
+			mTables.resize(mIndex.getCount());
+			if (mOutput.mBakeCurves)
+			{
+				for (int i = 0; i < mIndex.getCount(); i++)
+					mTables[i].bake(getSegment(i), mOutput.mBakeResolution);
+			}
 
 			if (mOutput.mUseMainThread)
 			{
@@ -75,35 +92,67 @@ namespace nap
 		 */
 		virtual void tick(double time) override
 		{
-			for (const auto& segment : mTrack->mSegments)
+			// get the segment we need
+			int index = mIndex.find(time);
+			if (index < 0)
+				return;
+			const SequenceTrackSegmentCurve<CURVE_TYPE>& source = getSegment(index);
+
+			// retrieve the source value, from the baked table if available
+			float pos = static_cast<float>((time - source.mStartTime) / source.mDuration);
+			SequenceCurveTable<CURVE_TYPE>& table = mTables[index];
+			if (mOutput.mBakeCurves && table.getState() == SequenceCurveTable<CURVE_TYPE>::EState::Empty)
+				table.bake(source, mOutput.mBakeResolution);
+
+			CURVE_TYPE source_value = table.getState() == SequenceCurveTable<CURVE_TYPE>::EState::Baked ?
+				table.evaluate(pos) : source.getValue(pos);
+
+			// cast it to a parameter value
+			PARAMETER_VALUE_TYPE value = static_cast<PARAMETER_VALUE_TYPE>(source_value * (mTrack->mMaximum - mTrack->mMinimum) + mTrack->mMinimum);
+
+			// call set or store function
+			(*this.*mSetFunction)(value);
+		}
+	private:
+		/**
+		 * Copies the track, its segments and curves. The copies point to each other, not to the sequence.
+		 * @param track the track to copy
+		 */
+		void copyTrack(const SequenceTrackCurve<CURVE_TYPE>& track)
+		{
+			rtti::Factory factory;
+			mTrack = rtti::cloneObject(track, factory);
+			for (auto& segment : mTrack->mSegments)
 			{
-				if (time >= segment->mStartTime && time < segment->mStartTime + segment->mDuration)
+				assert(segment->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentCurve<CURVE_TYPE>)));
+				auto segment_copy = rtti::cloneObject(static_cast<const SequenceTrackSegmentCurve<CURVE_TYPE>&>(*segment), factory);
+				for (auto& curve : segment_copy->mCurves)
 				{
-					// get the segment we need
-					assert(segment.get()->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentCurve<CURVE_TYPE>)));
-					const SequenceTrackSegmentCurve<CURVE_TYPE>& source = static_cast<const SequenceTrackSegmentCurve<CURVE_TYPE>&>(*segment.get());
-
-					// retrieve the source value
-					CURVE_TYPE source_value = source.getValue((time - source.mStartTime) / source.mDuration);
-					
-					// cast it to a parameter value
-					PARAMETER_VALUE_TYPE value = static_cast<PARAMETER_VALUE_TYPE>(source_value * (mTrack->mMaximum - mTrack->mMinimum) + mTrack->mMinimum);
-
-					// call set or store function
-					(*this.*mSetFunction)(value);
-
-					break;
+					mCurves.emplace_back(rtti::cloneObject(*curve, factory));
+					curve = mCurves.back().get();
 				}
+				segment = segment_copy.get();
+				mSegments.emplace_back(std::move(segment_copy));
 			}
 		}
-	private:
+
+		/**
+		 * @return the segment at the given position in the index
+		 */
+		const SequenceTrackSegmentCurve<CURVE_TYPE>& getSegment(int index) const
+		{
+			const SequenceTrackSegment& segment = mIndex.getSegment(index);
+			assert(segment.get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentCurve<CURVE_TYPE>)));
+			return static_cast<const SequenceTrackSegmentCurve<CURVE_TYPE>&>(segment);
+		}
+
 		/**
-		 * setValue gets called from main thread and sets the parameter value
+		 * setValue gets called from main thread and sets the parameter value, when a new value was stored
 		 */
 		virtual void setValue() override
 		{
-			std::unique_lock<std::mutex> l(mMutex);
-			mParameter.setValue(mStoredValue);
+			if (mBuffer.update())
+				mParameter.setValue(mBuffer.getReadBuffer());
 		}
 
 		/**
@@ -117,20 +166,24 @@ namespace nap
 
 		/**
 		 * Uses SequencePlayerCurveOutput  to set parameter value, value will be set from main thread with function setValue(), thread safe
+		 * Never blocks, the main thread only picks up the latest value
 		 * @param value the value
 		 */
 		void storeParameterValue(PARAMETER_VALUE_TYPE& value)
 		{
-			std::unique_lock<std::mutex> l(mMutex);
-			mStoredValue = value;
+			mBuffer.getWriteBuffer() = value;
+			mBuffer.publish();
 		}
 
-		PARAMETER_TYPE&									mParameter;
-		const SequenceTrackCurve<CURVE_TYPE>*			mTrack;
-		bool											mUseMainThread;
-		SequencePlayerCurveOutput&						mOutput;
-		std::mutex										mMutex;
-		PARAMETER_VALUE_TYPE							mStoredValue;
+		PARAMETER_TYPE&													mParameter;
+		std::unique_ptr<SequenceTrackCurve<CURVE_TYPE>>					mTrack;
+		std::vector<std::unique_ptr<SequenceTrackSegmentCurve<CURVE_TYPE>>>	mSegments;
+		std::vector<std::unique_ptr<math::FCurve<float, float>>>		mCurves;
+		bool															mUseMainThread;
+		SequencePlayerCurveOutput&										mOutput;
+		utility::TripleBuffer<PARAMETER_VALUE_TYPE>						mBuffer;
+		SequenceTrackSegmentIndex										mIndex;
+		std::vector<SequenceCurveTable<CURVE_TYPE>>						mTables;
 
 		void (SequencePlayerCurveAdapter::*mSetFunction)(PARAMETER_VALUE_TYPE& value);
 	};
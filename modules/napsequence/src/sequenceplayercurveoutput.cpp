@@ -12,6 +12,8 @@
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequencePlayerCurveOutput)
 RTTI_PROPERTY("Parameter", &nap::SequencePlayerCurveOutput::mParameter, nap::rtti::EPropertyMetaData::Required)
 RTTI_PROPERTY("Use Main Thread", &nap::SequencePlayerCurveOutput::mUseMainThread, nap::rtti::EPropertyMetaData::Default)
+RTTI_PROPERTY("Bake Curves", &nap::SequencePlayerCurveOutput::mBakeCurves, nap::rtti::EPropertyMetaData::Default)
+RTTI_PROPERTY("Bake Resolution", &nap::SequencePlayerCurveOutput::mBakeResolution, nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 namespace nap
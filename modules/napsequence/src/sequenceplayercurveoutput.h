@@ -31,6 +31,8 @@ namespace nap
 		// properties
 		ResourcePtr<Parameter>	mParameter; 	///< Property: 'Parameter' parameter resource
 		bool					mUseMainThread; ///< Property: 'Use Main Thread' update in main thread or player thread
+		bool					mBakeCurves = false; ///< Property: 'Bake Curves' sample curve segments into lookup tables when loaded, trades accuracy for speed
+		int						mBakeResolution = 256; ///< Property: 'Bake Resolution' number of samples per baked curve segment
 
 		/**
 		 * registers a parameter setter to the output. Parameter setters are called from main thread
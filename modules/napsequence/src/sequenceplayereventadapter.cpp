@@ -23,126 +23,68 @@ namespace nap
 
 
 	SequencePlayerEventAdapter::SequencePlayerEventAdapter(const SequenceTrack& track, SequencePlayerEventOutput& output, const SequencePlayer& player)
-		: mTrack(track), mOutput(output)
+		: mOutput(output)
 	{
-		double time = player.getPlayerTime();
-
-		// mark all events before 'time' as already dispatched
-		assert(mTrack.get_type().is_derived_from(RTTI_OF(SequenceTrackEvent)));
-		const auto& event_track = static_cast<const SequenceTrackEvent&>(mTrack);
+		// create the events up front, the sequence can be edited while this adapter is played
+		assert(track.get_type().is_derived_from(RTTI_OF(SequenceTrackEvent)));
+		const auto& event_track = static_cast<const SequenceTrackEvent&>(track);
 		for (const auto& event_segment : event_track.mSegments)
 		{
 			assert(event_segment.get()->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentEventBase)));
 			SequenceTrackSegmentEventBase& event = static_cast<SequenceTrackSegmentEventBase&>(*event_segment.get());
-			if (time > event.mStartTime)
-			{
-				if (mDispatchedEvents.find(&event) == mDispatchedEvents.end())
-				{
-					mDispatchedEvents.emplace(&event);
-				}
-			}
+			mStartTimes.emplace_back(event.mStartTime);
+			mEvents.emplace_back(event.createEvent());
 		}
+		mDispatched.resize(mEvents.size(), false);
+
+		// mark all events before 'time' as already dispatched
+		mPrevTime = player.getPlayerTime();
+		markDispatched(mPrevTime);
 	}
 
 
-	void SequencePlayerEventAdapter::tick(double time)
+	SequencePlayerEventAdapter::~SequencePlayerEventAdapter()
 	{
-		double deltaTime = time - mPrevTime;
-		mPrevTime = time;
-		if (deltaTime < 0.0)
-		{
-			if (!mPlayingBackwards)
-			{
-				mPlayingBackwards = true;
+		mOutput.retireEvents(std::move(mEvents));
+	}
 
-				//
-				mDispatchedEvents.clear();
 
-				// mark all events after 'time' as already dispatched
-				assert(mTrack.get_type().is_derived_from(RTTI_OF(SequenceTrackEvent)));
-				const auto& event_track = static_cast<const SequenceTrackEvent&>(mTrack);
-				for (const auto& event_segment : event_track.mSegments)
-				{
-					assert(event_segment.get()->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentEventBase)));
-					SequenceTrackSegmentEventBase& event = static_cast<SequenceTrackSegmentEventBase&>(*event_segment.get());
-					if (time < event.mStartTime)
-					{
-						if (mDispatchedEvents.find(&event) == mDispatchedEvents.end())
-						{
-							mDispatchedEvents.emplace(&event);
-						}
-					}
-				}
-			}
-		}
-		else
+	void SequencePlayerEventAdapter::markDispatched(double time)
+	{
+		for (int i = 0; i < mStartTimes.size(); i++)
 		{
-			if (mPlayingBackwards)
-			{
-				mPlayingBackwards = false;
+			mDispatched[i] = mPlayingBackwards ? time < mStartTimes[i] : time > mStartTimes[i];
+		}
+	}
 
-				//
-				mDispatchedEvents.clear();
 
-				// mark all events before 'time' as already dispatched
-				assert(mTrack.get_type().is_derived_from(RTTI_OF(SequenceTrackEvent)));
-				const auto& event_track = static_cast<const SequenceTrackEvent&>(mTrack);
-				for (const auto& event_segment : event_track.mSegments)
-				{
-					assert(event_segment.get()->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentEventBase)));
-					SequenceTrackSegmentEventBase& event = static_cast<SequenceTrackSegmentEventBase&>(*event_segment.get());
-					if (time > event.mStartTime)
-					{
-						if (mDispatchedEvents.find(&event) == mDispatchedEvents.end())
-						{
-							mDispatchedEvents.emplace(&event);
-						}
-					}
-				}
-			}
-		}
+	void SequencePlayerEventAdapter::tick(double time)
+	{
+		double deltaTime = time - mPrevTime;
+		mPrevTime = time;
 
-		assert(mTrack.get_type().is_derived_from(RTTI_OF(SequenceTrackEvent)));
-		const auto& event_track = static_cast<const SequenceTrackEvent&>(mTrack);
-		for (const auto& event_segment : event_track.mSegments)
+		// direction changed, mark all events behind 'time' as already dispatched
+		bool playing_backwards = deltaTime < 0.0;
+		if (playing_backwards != mPlayingBackwards)
 		{
-			assert(event_segment.get()->get_type().is_derived_from(RTTI_OF(SequenceTrackSegmentEventBase)));
-			SequenceTrackSegmentEventBase& event = static_cast<SequenceTrackSegmentEventBase&>(*event_segment.get());
-
-			if ( ( !mPlayingBackwards && time > event.mStartTime ) || (mPlayingBackwards && time < event.mStartTime))
-			{
-				if (mDispatchedEvents.find(&event) == mDispatchedEvents.end())
-				{
-					mOutput.addEvent(event.createEvent());
-					mDispatchedEvents.emplace(&event);
-				}
-			}
-			else if ((!mPlayingBackwards && time < event.mStartTime) || (mPlayingBackwards && time > event.mStartTime))
-			{
-				if (mDispatchedEvents.find(&event) != mDispatchedEvents.end())
-				{
-					mDispatchedEvents.erase(&event);
-				}
-			}
+			mPlayingBackwards = playing_backwards;
+			markDispatched(time);
 		}
 
-		// remove dispatchedEvents that have been deleted
-		for (auto* dispatched_event : mDispatchedEvents)
+		for (int i = 0; i < mStartTimes.size(); i++)
 		{
-			bool found_segment = false;
-			for (const auto& event_segment : event_track.mSegments)
+			double start_time = mStartTimes[i];
+			if ((!mPlayingBackwards && time > start_time) || (mPlayingBackwards && time < start_time))
 			{
-				if (event_segment.get() == dispatched_event)
+				if (!mDispatched[i])
 				{
-					found_segment = true;
-					break;
+					mOutput.addEvent(*mEvents[i]);
+					mDispatched[i] = true;
 				}
 			}
-
-			if (!found_segment)
+			else if ((!mPlayingBackwards && time < start_time) || (mPlayingBackwards && time > start_time))
 			{
-				mDispatchedEvents.erase(dispatched_event);
-				break;
+				mDispatched[i] = false;
 			}
 		}
 	}
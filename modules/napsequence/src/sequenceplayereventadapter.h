@@ -20,6 +20,7 @@ namespace nap
 	/**
 	 * Adapter responsible for handling events from an event track and sync them with the main thread using a
 	 * sequence event receiver intermediate class.
+	 * The adapter creates the events of all segments when it is created, the player thread only queues them.
 	 */
 	class SequencePlayerEventAdapter : public SequencePlayerAdapter
 	{
@@ -33,9 +34,9 @@ namespace nap
 		SequencePlayerEventAdapter(const SequenceTrack& track, SequencePlayerEventOutput& output, const SequencePlayer& player);
 
 		/**
-		 * Destructor
+		 * Destructor, hands the events over to the output, they might still be queued
 		 */
-		virtual ~SequencePlayerEventAdapter() {}
+		virtual ~SequencePlayerEventAdapter();
 
 		/**
 		 * called from sequence player thread
@@ -43,14 +44,23 @@ namespace nap
 		 */
 		virtual void tick(double time);
 	private:
-		// reference to track linked to adapter
-		const SequenceTrack& mTrack;
+		/**
+		 * marks all events before 'time' as dispatched, or after 'time' when playing backwards
+		 * @param time time in sequence player
+		 */
+		void markDispatched(double time);
 
 		// reference to receiver linked to adapter
 		SequencePlayerEventOutput& 	mOutput;
 
-		// list of dispatched events
-		std::unordered_set<SequenceTrackSegmentEventBase*> mDispatchedEvents;
+		// start time of every event segment
+		std::vector<double> mStartTimes;
+
+		// event of every event segment
+		std::vector<SequenceEventPtr> mEvents;
+
+		// dispatch state of every event segment
+		std::vector<bool> mDispatched;
 
 		//
 		bool mPlayingBackwards = false;
@@ -58,4 +68,4 @@ namespace nap
 		//
 		double mPrevTime = 0.0;
 	};
-}
\ No newline at end of file
+}
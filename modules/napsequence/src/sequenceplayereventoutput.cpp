@@ -7,7 +7,10 @@
 #include "sequenceutils.h"
 #include "sequencetrackevent.h"
 
+#include <nap/logger.h>
+
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequencePlayerEventOutput)
+RTTI_PROPERTY("Queue Size", &nap::SequencePlayerEventOutput::mQueueSize, nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 namespace nap
@@ -28,34 +31,43 @@ namespace nap
 		: SequencePlayerOutput(service){}
 
 
-	void SequencePlayerEventOutput::update(double deltaTime)
+	bool SequencePlayerEventOutput::init(utility::ErrorState& errorState)
 	{
-		std::queue<SequenceEventPtr> events;
-		{
-			std::lock_guard<std::mutex> lock(mEventMutex);
+		if (!errorState.check(mQueueSize > 0, "%s: queue size must be greater than 0", mID.c_str()))
+			return false;
 
-			// Swap events
-			events.swap(mEvents);
+		mEvents = std::make_unique<utility::SPSCQueue<const SequenceEventBase*>>(mQueueSize);
+		return SequencePlayerOutput::init(errorState);
+	}
 
-			// Clear current queue
-			std::queue<SequenceEventPtr> empty_queue;
-			mEvents.swap(empty_queue);
-		}
 
+	void SequencePlayerEventOutput::update(double deltaTime)
+	{
 		// Keep forwarding events until the queue runs out
-		while (!(events.empty()))
+		const SequenceEventBase* sequence_event = nullptr;
+		while (mEvents->tryDequeue(sequence_event))
 		{
-			SequenceEventBase& sequence_event = *(events.front());
-			mSignal.trigger(sequence_event);
-
-			events.pop();
+			mSignal.trigger(*sequence_event);
 		}
+
+		// Events of destroyed adapters were queued before the adapter was destroyed, and are dispatched now
+		mRetiredEvents.clear();
+
+		int dropped_count = mDroppedCount.exchange(0);
+		if (dropped_count > 0)
+			nap::Logger::warn("%s: %d events dropped, increase the queue size", mID.c_str(), dropped_count);
+	}
+
+
+	void SequencePlayerEventOutput::addEvent(const SequenceEventBase& event)
+	{
+		if (!mEvents->tryEnqueue(&event))
+			mDroppedCount.fetch_add(1, std::memory_order_relaxed);
 	}
 
 
-	void SequencePlayerEventOutput::addEvent(SequenceEventPtr event)
+	void SequencePlayerEventOutput::retireEvents(std::vector<SequenceEventPtr>&& events)
 	{
-		std::lock_guard<std::mutex> lock(mEventMutex);
-		mEvents.emplace(std::move(event));
+		mRetiredEvents.emplace_back(std::move(events));
 	}
-}
\ No newline at end of file
+}
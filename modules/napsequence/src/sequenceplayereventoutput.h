@@ -13,7 +13,10 @@
 #include <nap/signalslot.h>
 
 // external includes
-#include <queue>
+#include <utility/spscqueue.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace nap
 {
@@ -24,6 +27,10 @@ namespace nap
 
 	/**
 	 * SequencePlayerEventOutput dispatches an event on the timeline
+	 * Events are handed over from the player to the main thread using a bounded, lock-free queue of event pointers.
+	 * The events are created up front by the adapters, dispatching an event never allocates or blocks.
+	 * Events that don't fit in the queue are dropped, a warning is logged when that happens.
+	 * The tracks that are assigned to this output must be played by a single player.
 	 */
 	class NAPAPI SequencePlayerEventOutput : public SequencePlayerOutput
 	{
@@ -37,6 +44,14 @@ namespace nap
 		 */
 		SequencePlayerEventOutput(SequenceService& service);
 
+		/**
+		 * Allocates the event queue and registers with the service
+		 * @param errorState contains any errors
+		 * @return true if succeed
+		 */
+		virtual bool init(utility::ErrorState& errorState) override;
+
+		int mQueueSize = 1024;		///< Property: 'Queue Size' max number of events in flight in between two updates of the main thread
 	public:
 		/**
 		 * Signal will be triggered from main thread
@@ -50,16 +65,26 @@ namespace nap
 		virtual void update(double deltaTime) override ;
 
 		/**
-		 * called from sequence player thread, adds event to queue.
-		 * @param event the event ptr that needs to be dispatched. Receiver takes ownership of the event
+		 * called from sequence player thread, adds event to queue. Never blocks or allocates.
+		 * @param event the event that needs to be dispatched, owned by the adapter, kept alive using retireEvents()
 		 */
-		void addEvent(SequenceEventPtr event);
+		void addEvent(const SequenceEventBase& event);
+
+		/**
+		 * called from main thread when an adapter is destroyed, keeps the events of that adapter alive
+		 * until the queue is drained on the next update
+		 * @param events the events owned by the adapter
+		 */
+		void retireEvents(std::vector<SequenceEventPtr>&& events);
 	private:
-		// the queue of events
-		std::queue<SequenceEventPtr> mEvents;
+		// the queue of events, written by the player thread and read by the main thread
+		std::unique_ptr<utility::SPSCQueue<const SequenceEventBase*>> mEvents;
+
+		// events of destroyed adapters that might still be queued
+		std::vector<std::vector<SequenceEventPtr>> mRetiredEvents;
 
-		// thread mutex
-		std::mutex mEventMutex;
+		// number of events that didn't fit in the queue
+		std::atomic<int> mDroppedCount = { 0 };
 	};
 
 	using SequencePlayerEventInputObjectCreator = rtti::ObjectCreator<SequencePlayerEventOutput, SequenceService>;
@@ -12,6 +12,7 @@
 // Local Includes
 #include "sequenceplayeradapter.h"
 #include "sequenceplayeroutput.h"
+#include "sequenceplayerclock.h"
 #include "sequenceservice.h"
 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequenceService)
@@ -61,6 +62,18 @@ namespace nap
 
 	void SequenceService::update(double deltaTime)
 	{
+		// tick players driven by the main thread first, so outputs pick up the new values this frame
+		for(auto& clock : mClocks)
+		{
+			clock->update(deltaTime);
+		}
+
+		// destroy the adapters edits replaced, before the outputs they unregister from are updated
+		for(auto& player : mPlayers)
+		{
+			player->update();
+		}
+
 		for(auto& output : mOutputs)
 		{
 			output->update(deltaTime);
@@ -95,4 +108,48 @@ namespace nap
 			mOutputs.erase(found_it);
 		}
 	}
-}
\ No newline at end of file
+
+
+	void SequenceService::registerClock(SequencePlayerStandardClock& clock)
+	{
+		auto found_it = std::find(mClocks.begin(), mClocks.end(), &clock);
+		assert(found_it == mClocks.end()); // duplicate entry
+
+		if(found_it == mClocks.end())
+		{
+			mClocks.emplace_back(&clock);
+		}
+	}
+
+
+	void SequenceService::removeClock(SequencePlayerStandardClock& clock)
+	{
+		auto found_it = std::find(mClocks.begin(), mClocks.end(), &clock);
+		if(found_it != mClocks.end())
+		{
+			mClocks.erase(found_it);
+		}
+	}
+
+
+	void SequenceService::registerPlayer(SequencePlayer& player)
+	{
+		auto found_it = std::find(mPlayers.begin(), mPlayers.end(), &player);
+		assert(found_it == mPlayers.end()); // duplicate entry
+
+		if(found_it == mPlayers.end())
+		{
+			mPlayers.emplace_back(&player);
+		}
+	}
+
+
+	void SequenceService::removePlayer(SequencePlayer& player)
+	{
+		auto found_it = std::find(mPlayers.begin(), mPlayers.end(), &player);
+		if(found_it != mPlayers.end())
+		{
+			mPlayers.erase(found_it);
+		}
+	}
+}
@@ -18,6 +18,7 @@ namespace nap
 	//////////////////////////////////////////////////////////////////////////
 	// forward declares
 	class SequenceEventReceiver;
+	class SequencePlayerStandardClock;
 
 	/**
 	 * Main interface for processing sequence outputs
@@ -25,6 +26,8 @@ namespace nap
 	class NAPAPI SequenceService : public Service
 	{
 		friend class SequencePlayerOutput;
+		friend class SequencePlayerStandardClock;
+		friend class SequencePlayer;
 
 		RTTI_ENABLE(Service)
 	public:
@@ -58,7 +61,7 @@ namespace nap
 		virtual bool init(nap::utility::ErrorState& errorState) override;
 
 		/**
-		 * updates any outputs
+		 * updates any standard clocks and outputs, destroys the adapters players replaced
 		 * @param deltaTime deltaTime
 		 */
 		virtual void update(double deltaTime) override;
@@ -75,7 +78,37 @@ namespace nap
 		 */
 		void removeOutput(SequencePlayerOutput& output);
 
+		/**
+		 * registers a standard clock, updated before the outputs
+		 * @param clock reference to clock
+		 */
+		void registerClock(SequencePlayerStandardClock& clock);
+
+		/**
+		 * removes a standard clock
+		 * @param clock reference to clock
+		 */
+		void removeClock(SequencePlayerStandardClock& clock);
+
+		/**
+		 * registers a started player, the adapters it replaces are destroyed on update
+		 * @param player reference to player
+		 */
+		void registerPlayer(SequencePlayer& player);
+
+		/**
+		 * removes a player
+		 * @param player reference to player
+		 */
+		void removePlayer(SequencePlayer& player);
+
 		// vector holding raw pointers to outputs
 		std::vector<SequencePlayerOutput*> mOutputs;
+
+		// vector holding raw pointers to started standard clocks
+		std::vector<SequencePlayerStandardClock*> mClocks;
+
+		// vector holding raw pointers to started players
+		std::vector<SequencePlayer*> mPlayers;
 	};
 }
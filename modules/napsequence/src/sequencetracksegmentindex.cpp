@@ -0,0 +1,80 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "sequencetracksegmentindex.h"
+
+#include <algorithm>
+
+namespace nap
+{
+	void SequenceTrackSegmentIndex::build(const SequenceTrack& track)
+	{
+		mEntries.clear();
+		mEntries.reserve(track.mSegments.size());
+		for (const auto& segment : track.mSegments)
+		{
+			Entry entry;
+			entry.mStart = segment->mStartTime;
+			entry.mEnd = segment->mStartTime + segment->mDuration;
+			entry.mSegment = segment.get();
+			mEntries.emplace_back(entry);
+		}
+
+		// Segments of a track are adjacent and never overlap
+		std::sort(mEntries.begin(), mEntries.end(), [](const Entry& a, const Entry& b)
+		{
+			return a.mStart < b.mStart;
+		});
+		mCursor = 0;
+	}
+
+
+	void SequenceTrackSegmentIndex::clear()
+	{
+		mEntries.clear();
+		mCursor = 0;
+	}
+
+
+	int SequenceTrackSegmentIndex::find(double time)
+	{
+		int count = static_cast<int>(mEntries.size());
+		if (count == 0)
+			return -1;
+
+		// Try the segment found last and the one after it
+		const Entry& current = mEntries[mCursor];
+		if (time >= current.mStart)
+		{
+			if (time < current.mEnd)
+				return mCursor;
+
+			// In between the current and next segment
+			int next = mCursor + 1;
+			if (next == count || time < mEntries[next].mStart)
+				return -1;
+
+			if (time < mEntries[next].mEnd)
+			{
+				mCursor = next;
+				return next;
+			}
+		}
+
+		// Time jumped, find last segment that starts before or at the given time
+		auto it = std::upper_bound(mEntries.begin(), mEntries.end(), time, [](double t, const Entry& entry)
+		{
+			return t < entry.mStart;
+		});
+
+		if (it == mEntries.begin())
+		{
+			mCursor = 0;
+			return -1;
+		}
+
+		mCursor = static_cast<int>(it - mEntries.begin()) - 1;
+		return time < mEntries[mCursor].mEnd ? mCursor : -1;
+	}
+}
@@ -0,0 +1,71 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// local includes
+#include "sequencetrack.h"
+
+// external includes
+#include <nap/numeric.h>
+#include <vector>
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * Finds the segment of a track at a specific time.
+	 * Segments are sorted by start time when the index is built, lookups start at the segment found last (the cursor).
+	 * When time moves forward, as it does during playback, the segment is found in constant time.
+	 * When time jumps, for example after a seek or loop, the segment is found using a binary search.
+	 * The index must be rebuilt when the segments of the track change.
+	 */
+	class NAPAPI SequenceTrackSegmentIndex final
+	{
+	public:
+		/**
+		 * Builds the index for the given track, resets the cursor
+		 * @param track the track to index
+		 */
+		void build(const SequenceTrack& track);
+
+		/**
+		 * Clears the index
+		 */
+		void clear();
+
+		/**
+		 * Returns the position of the segment at the given time, -1 if there is no segment at that time.
+		 * @param time time in seconds
+		 * @return position of the segment in the index, -1 if there is no segment at the given time
+		 */
+		int find(double time);
+
+		/**
+		 * @param index position of the segment in the index
+		 * @return the segment at the given position
+		 */
+		const SequenceTrackSegment& getSegment(int index) const		{ return *mEntries[index].mSegment; }
+
+		/**
+		 * @return number of indexed segments
+		 */
+		int getCount() const										{ return static_cast<int>(mEntries.size()); }
+
+	private:
+		/**
+		 * Time range of a single segment
+		 */
+		struct Entry
+		{
+			double							mStart = 0.0;			///< Start time of the segment
+			double							mEnd = 0.0;				///< End time of the segment, exclusive
+			const SequenceTrackSegment*		mSegment = nullptr;		///< The segment
+		};
+
+		std::vector<Entry>	mEntries;		///< All segments, sorted by start time
+		int					mCursor = 0;	///< Position of the segment found last
+	};
+}
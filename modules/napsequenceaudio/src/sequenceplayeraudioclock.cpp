@@ -0,0 +1,109 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// local includes
+#include "sequenceplayeraudioclock.h"
+
+// nap includes
+#include <sequenceservice.h>
+#include <nap/core.h>
+
+// external includes
+#include <thread>
+
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::SequencePlayerAudioClock)
+RTTI_CONSTRUCTOR(nap::SequenceService&)
+RTTI_END_CLASS
+
+namespace nap
+{
+	static bool register_object_creator = SequenceService::registerObjectCreator([](SequenceService* service)->std::unique_ptr<rtti::IObjectCreator>
+	{
+		return std::make_unique<SequencePlayerAudioClockObjectCreator>(*service);
+	});
+
+
+	SequencePlayerAudioClock::SequencePlayerAudioClock(SequenceService& service)
+		: mService(&service)
+	{
+	}
+
+
+	bool SequencePlayerAudioClock::init(utility::ErrorState& errorState)
+	{
+		// the audio service isn't a dependency of the sequence service, query it when initialized
+		auto* audio_service = mService->getCore().getService<audio::AudioService>();
+		if (!errorState.check(audio_service != nullptr, "%s: audio service not found", mID.c_str()))
+			return false;
+		mNodeManager = &audio_service->getNodeManager();
+
+		// the slot only holds on to the state, it stays valid until the audio thread disconnected it
+		mState = std::make_shared<State>();
+		mState->mSampleRate = static_cast<double>(mNodeManager->getSampleRate());
+		auto state = mState;
+		mAudioSlot = std::make_shared<Slot<audio::DiscreteTimeValue>>([state](audio::DiscreteTimeValue sampleTime)
+		{
+			update(*state, sampleTime);
+		});
+
+		// connect on the audio thread, the signal is emitted from there
+		auto* node_manager = mNodeManager;
+		auto slot = mAudioSlot;
+		mNodeManager->enqueueTask([node_manager, slot]()
+		{
+			node_manager->mUpdateSignal.connect(*slot);
+		});
+		return true;
+	}
+
+
+	void SequencePlayerAudioClock::onDestroy()
+	{
+		if (mNodeManager == nullptr)
+			return;
+
+		// disconnected before the signal is emitted again, the task keeps the slot alive until then
+		auto* node_manager = mNodeManager;
+		auto slot = mAudioSlot;
+		mNodeManager->enqueueTask([node_manager, slot]()
+		{
+			node_manager->mUpdateSignal.disconnect(*slot);
+		});
+		mAudioSlot.reset();
+	}
+
+
+	void SequencePlayerAudioClock::start(Slot<double>& updateSlot)
+	{
+		assert(!mState->mRunning);
+		mState->mUpdateSlot = &updateSlot;
+		mState->mReset = true;
+		mState->mRunning = true;
+	}
+
+
+	void SequencePlayerAudioClock::stop()
+	{
+		// the audio thread either sees the clock stopped, or is in the middle of an update we wait for
+		mState->mRunning = false;
+		while (mState->mInUpdate)
+			std::this_thread::yield();
+	}
+
+
+	void SequencePlayerAudioClock::update(State& state, audio::DiscreteTimeValue sampleTime)
+	{
+		state.mInUpdate = true;
+		if (state.mRunning)
+		{
+			if (state.mReset.exchange(false))
+				state.mSampleTime = sampleTime;
+
+			double delta_time = static_cast<double>(sampleTime - state.mSampleTime) / state.mSampleRate;
+			state.mSampleTime = sampleTime;
+			state.mUpdateSlot->trigger(delta_time);
+		}
+		state.mInUpdate = false;
+	}
+}
@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// nap includes
+#include <sequenceplayerclock.h>
+#include <audio/service/audioservice.h>
+
+// external includes
+#include <atomic>
+#include <memory>
+
+namespace nap
+{
+	//////////////////////////////////////////////////////////////////////////
+	// forward declares
+	class SequenceService;
+
+	/**
+	 * Drives a SequencePlayer from the audio thread, using the sample clock of the audio node manager.
+	 * The player is updated after every internal buffer of audio, the elapsed time is the number of processed samples
+	 * divided by the sample rate. Playback is sample accurate and doesn't drift from the audio.
+	 * Adapters are ticked on the audio thread: curve outputs should use the main thread, event outputs always do.
+	 */
+	class NAPAPI SequencePlayerAudioClock : public SequencePlayerClock
+	{
+		RTTI_ENABLE(SequencePlayerClock)
+	public:
+		/**
+		 * Constructor
+		 * @param service the sequence service
+		 */
+		SequencePlayerAudioClock(SequenceService& service);
+
+		/**
+		 * Connects to the update signal of the audio node manager
+		 * @param errorState contains the error if the audio service is not available
+		 * @return if initialization succeeded
+		 */
+		bool init(utility::ErrorState& errorState) override;
+
+		/**
+		 * Disconnects from the update signal of the audio node manager
+		 */
+		void onDestroy() override;
+
+		/**
+		 * Starts calling the update slot from the audio thread
+		 * @param updateSlot slot to call with the elapsed time in seconds
+		 */
+		void start(Slot<double>& updateSlot) override;
+
+		/**
+		 * Stops calling the update slot, waits for an update in progress on the audio thread
+		 */
+		void stop() override;
+
+	private:
+		/**
+		 * State shared with the audio thread, outlives the clock until the audio thread disconnected
+		 */
+		struct State
+		{
+			std::atomic<bool>			mRunning = { false };		///< if the update slot is called
+			std::atomic<bool>			mInUpdate = { false };		///< true while the audio thread checks mRunning and calls the slot
+			std::atomic<bool>			mReset = { true };			///< restart counting samples
+			Slot<double>*				mUpdateSlot = nullptr;		///< slot of the player
+			audio::DiscreteTimeValue	mSampleTime = 0;			///< sample time of the previous update, audio thread only
+			double						mSampleRate = 44100.0;		///< sample rate of the node manager
+		};
+
+		// called from the audio thread after every internal buffer
+		static void update(State& state, audio::DiscreteTimeValue sampleTime);
+
+		SequenceService*									mService = nullptr;
+		audio::NodeManager*									mNodeManager = nullptr;
+		std::shared_ptr<State>								mState;
+		std::shared_ptr<Slot<audio::DiscreteTimeValue>>		mAudioSlot;
+	};
+
+	using SequencePlayerAudioClockObjectCreator = rtti::ObjectCreator<SequencePlayerAudioClock, SequenceService>;
+}
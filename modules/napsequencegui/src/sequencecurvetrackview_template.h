@@ -170,6 +170,8 @@ namespace nap
 						float end_x = start_x + mState.mWindowSize.x + mState.mWindowPos.x;
 
 						// start drawing at window pos
+						std::vector<float> positions;
+						std::vector<float> x_positions;
 						{
 							long i = 0;
 							for (; i <= point_num; i++)
@@ -178,13 +180,8 @@ namespace nap
 								float x = trackTopLeft.x + previousSegmentX + segmentWidth * p;
 								if (x > start_x)
 								{
-									float value = 1.0f - segment.mCurves[v]->evaluate(p);
-									ImVec2 point =
-										{
-											x,
-											trackTopLeft.y + value * mState.mTrackHeight
-										};
-									curve.emplace_back(point);
+									positions.emplace_back(p);
+									x_positions.emplace_back(x);
 								}
 
 								if (x > end_x)
@@ -193,6 +190,20 @@ namespace nap
 								}
 							}
 						}
+
+						// evaluate all visible points at once
+						std::vector<float> values;
+						segment.mCurves[v]->evaluate(positions, values);
+						curve.reserve(values.size());
+						for (int j = 0; j < values.size(); j++)
+						{
+							ImVec2 point =
+								{
+									x_positions[j],
+									trackTopLeft.y + (1.0f - values[j]) * mState.mTrackHeight
+								};
+							curve.emplace_back(point);
+						}
 					}
 
 					curves.emplace_back(curve);
@@ -809,7 +809,7 @@ namespace nap
 		{
 			mState.mWindowPos.x + mState.mTimelineControllerPos.x - mState.mScroll.x
 				+ mState.mInspectorWidth + 5
-				+ mState.mTimelineWidth * (float)(player.getPlayerTime() / player.getDuration()) - 1,
+				+ mState.mTimelineWidth * (float)(player.getPlayerTimeInterpolated() / player.getDuration()) - 1,
 				mState.mWindowPos.y + mState.mTimelineControllerPos.y + 50.0f - mState.mScroll.y
 		};
 
@@ -116,6 +116,7 @@ this means that all video frames up until time 2 will be dropped.
 
 #include "video.h"
 #include "videoservice.h"
+#include "videodecodescheduler.h"
 #include "rendertarget.h"
 
 // external includes
@@ -126,6 +127,7 @@ this means that all video frames up until time 2 will be dropped.
 #include <string.h>
 #include <iostream>
 #include <limits>
+#include <algorithm>
 #include "nap/logger.h"
 
 extern "C"
@@ -374,14 +376,114 @@ namespace nap
 
 	//////////////////////////////////////////////////////////////////////////
 
+	AVFramePool::~AVFramePool()
+	{
+		for (AVFrame* frame : mFrames)
+			av_frame_free(&frame);
+	}
+
+
+	AVFrame* AVFramePool::acquire()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			if (!mFrames.empty())
+			{
+				AVFrame* frame = mFrames.back();
+				mFrames.pop_back();
+				return frame;
+			}
+		}
+		return av_frame_alloc();
+	}
+
+
+	void AVFramePool::release(AVFrame* frame)
+	{
+		av_frame_unref(frame);
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		mFrames.push_back(frame);
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
+	FrameSlotPool::FrameSlotPool(int slotCount) :
+		mSlotCount(slotCount)
+	{
+		// Hand out the lowest slots first
+		mFreeSlots.reserve(slotCount);
+		for (int slot = slotCount - 1; slot >= 0; --slot)
+			mFreeSlots.push_back(slot);
+	}
+
+
+	int FrameSlotPool::acquire()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mSlotAvailableCondition.wait(lock, [this]() { return !mFreeSlots.empty() || mCancelled; });
+		if (mCancelled)
+			return -1;
+
+		int slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		return slot;
+	}
+
+
+	void FrameSlotPool::release(int slot)
+	{
+		assert(slot >= 0 && slot < mSlotCount);
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			assert(std::find(mFreeSlots.begin(), mFreeSlots.end(), slot) == mFreeSlots.end());
+			mFreeSlots.push_back(slot);
+		}
+		mSlotAvailableCondition.notify_one();
+	}
+
+
+	void FrameSlotPool::cancelAcquire()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCancelled = true;
+		}
+		mSlotAvailableCondition.notify_all();
+	}
+
+
+	void FrameSlotPool::resetAcquire()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mCancelled = false;
+	}
+
+	//////////////////////////////////////////////////////////////////////////
+
 	void Frame::free()
 	{
-		if (isValid())
+		if (mFrame != nullptr)
 		{
-			av_frame_unref(mFrame);
-			av_frame_free(&mFrame);
+			if (mFramePool != nullptr)
+			{
+				mFramePool->release(mFrame);
+			}
+			else
+			{
+				av_frame_unref(mFrame);
+				av_frame_free(&mFrame);
+			}
 			mFrame = nullptr;
 		}
+
+		if (mSlot != -1)
+		{
+			assert(mSlotPool != nullptr);
+			mSlotPool->release(mSlot);
+			mSlot = -1;
+		}
+		mSlotPool = nullptr;
 	}
 
 	//////////////////////////////////////////////////////////////////////////
@@ -433,6 +535,23 @@ namespace nap
 	}
 
 
+	void AVState::setFrameSlotPool(const std::shared_ptr<FrameSlotPool>& slotPool)
+	{
+		// The decode thread may still be exiting after a non blocking stop
+		if (mDecodeThread.joinable())
+			mDecodeThread.join();
+
+		mSlotPool = slotPool;
+	}
+
+
+	void AVState::setMaxFrameQueueSize(int size)
+	{
+		assert(size > 0 && !mDecodeThread.joinable());
+		mMaxFrameQueueSize = size;
+	}
+
+
 	void AVState::close()
 	{
 		if (mCodec != nullptr)
@@ -560,8 +679,7 @@ namespace nap
 		{
 			Frame frame = frameQueue.front();
 			frameQueue.pop();
-			av_frame_unref(frame.mFrame);
-			av_frame_free(&frame.mFrame);
+			frame.free();
 		}
 
 		mFrameQueueRoomAvailableCondition.notify_all();
@@ -641,6 +759,9 @@ namespace nap
 		mFinishedProducingFrames = false;
 
 		mOnClearFrameQueueFunction = onClearFrameQueueFunction;
+		if (mSlotPool != nullptr)
+			mSlotPool->resetAcquire();
+
 		mDecodeThread = std::thread(std::bind(&AVState::decodeThread, this));
 	}
 
@@ -651,6 +772,12 @@ namespace nap
 		mPacketAvailableCondition.notify_all();
 		mFrameQueueRoomAvailableCondition.notify_all();
 		mFrameDataAvailableCondition.notify_all();
+		if (mSlotPool != nullptr)
+			mSlotPool->cancelAcquire();
+
+		if (mVideo->mDecodeScheduler != nullptr)
+			mVideo->mDecodeScheduler->notifyCancelled();
+
 		if (mDecodeThread.joinable() && join)
 			mDecodeThread.join();
 	}
@@ -718,24 +845,63 @@ namespace nap
 
 			mLastFramePTSSecs = new_frame.mPTSSecs;
 
-			// We MOVE the decoded frame to this new frame. It is freed when processed
-			new_frame.mFrame = av_frame_alloc();
+			// We MOVE the decoded frame to this new frame. It is returned to the pool when processed
+			new_frame.mFrame = mFramePool.acquire();
+			new_frame.mFramePool = &mFramePool;
 			av_frame_move_ref(new_frame.mFrame, frame);
 			av_frame_unref(frame);
 
+			// Copy the planes into a slot when the frame is meant for display. Frames in the seek queue are only inspected by the IO thread.
+			// Acquiring a slot blocks until the consumer has released one, which is cancelled when the decode thread exits.
+			bool to_frame_queue = false;
+			{
+				std::unique_lock<std::mutex> lock(mFrameQueueMutex);
+				to_frame_queue = mActiveFrameQueue == &mFrameQueue;
+			}
+			
+			if (to_frame_queue && mSlotPool != nullptr)
+			{
+				new_frame.mSlot = mSlotPool->acquire();
+				if (new_frame.mSlot == -1)
+				{
+					new_frame.free();
+					break;
+				}
+				new_frame.mSlotPool = mSlotPool;
+				mSlotPool->copyFrame(*new_frame.mFrame, new_frame.mSlot);
+			}
+
 			// Push the frame onto the frame queue
 			{
 				std::unique_lock<std::mutex> lock(mFrameQueueMutex);
-				mFrameQueueRoomAvailableCondition.wait(lock, [this]() { return mActiveFrameQueue->size() < 16 || mExitDecodeThreadSignalled; });
+				mFrameQueueRoomAvailableCondition.wait(lock, [this]() { return mActiveFrameQueue->size() < mMaxFrameQueueSize || mExitDecodeThreadSignalled; });
 				if (mExitDecodeThreadSignalled)
 				{
 					new_frame.free();
 					break;
 				}
 
+				VIDEO_DEBUG_LOG("push frame (stream %d): pkt_pos: %d, dts: %d, pts: %d", mStream, new_frame.mFrame->pkt_pos, new_frame.mFrame->pkt_dts, new_frame.mFrame->pkt_pts);
+
+				// The data of a frame that has been copied into a slot is no longer needed, the decoded frame is recycled immediately.
+				// A frame that ends up in the seek queue keeps the decoded frame instead.
+				if (new_frame.mSlot != -1)
+				{
+					if (mActiveFrameQueue == &mFrameQueue)
+					{
+						mFramePool.release(new_frame.mFrame);
+						new_frame.mFrame = nullptr;
+					}
+					else
+					{
+						mSlotPool->release(new_frame.mSlot);
+						new_frame.mSlot = -1;
+						new_frame.mSlotPool = nullptr;
+					}
+				}
+
 				mActiveFrameQueue->push(new_frame);
 				mFrameDataAvailableCondition.notify_all();
-				VIDEO_DEBUG_LOG("push frame (stream %d): pkt_pos: %d, dts: %d, pts: %d", mStream, new_frame.mFrame->pkt_pos, new_frame.mFrame->pkt_dts, new_frame.mFrame->pkt_pts);
 			}
 		}
 
@@ -824,6 +990,12 @@ namespace nap
 		while (true)
 		{
 			int result = AVERROR(EAGAIN);
+
+			// Calls into the codec are made while holding a worker of the decode scheduler, waiting for packets is not
+			VideoDecodeScheduler::Worker receive_worker(mVideo->mDecodeScheduler, mVideo->mDecodePriority, mExitDecodeThreadSignalled);
+			if (!receive_worker.isAcquired())
+				return EDecodeFrameResult::Exit;
+
 			do 
 			{
 				VIDEO_DEBUG_LOG("receive_frame: stream %s", getStream() == 0 ? "video" : "audio");
@@ -857,6 +1029,7 @@ namespace nap
 				// We're not 100% sure why this is (this logic came from ffplay), but perhaps there are certain 
 				// kinds of decoding errors that are non-fatal and will 'resolve' themselves?
 			} while (result != AVERROR(EAGAIN));
+			receive_worker.release();
 
 			AVPacket* packet = popPacket();
 			if (packet == nullptr)
@@ -869,8 +1042,17 @@ namespace nap
 				mFrameFirstPacketDTS = packet->dts;
 
 			// Send packet to decoder, this is used by avcoded_receive frame later
+			VideoDecodeScheduler::Worker send_worker(mVideo->mDecodeScheduler, mVideo->mDecodePriority, mExitDecodeThreadSignalled);
+			if (!send_worker.isAcquired())
+			{
+				if (packet != mEndOfFilePacket.get())
+					av_packet_free(&packet);
+				return EDecodeFrameResult::Exit;
+			}
+
 			result = avcodec_send_packet(mCodecContext, packet);
 			assert(result != AVERROR(EAGAIN));
+			send_worker.release();
 
 			// If the packet is the EOF packet, we shouldn't delte it, it will be destroyed when the AVState is destroyed.
 			if (packet != mEndOfFilePacket.get())
@@ -964,8 +1146,6 @@ namespace nap
 
 	//////////////////////////////////////////////////////////////////////////
 
-	static int sMaxPacketQueueSizeInBytes = 16 * 1024 * 1024;
-
 	Video::Video(const std::string& path) : 
 		mAudioState(*this), 
 		mVideoState(*this),
@@ -1050,9 +1230,10 @@ namespace nap
 		if (!errorState.check(video_stream != nullptr, "No video stream found"))
 			return false;
 
-		// This option causes the codec context to spawn threads internally for decoding, speeding up the decoding process
+		// This option causes the codec context to spawn threads internally for decoding, speeding up the decoding process.
+		// When many videos play at the same time the number of threads is better limited, to prevent the codecs from competing for the same cores.
 		AVDictionary* options = nullptr;
-		av_dict_set(&options, "threads", "auto", 0);
+		av_dict_set(&options, "threads", mCodecThreadCount > 0 ? std::to_string(mCodecThreadCount).c_str() : "auto", 0);
 
 		// We need to set this option to make sure that the decoder transfers ownership from decode buffers to us
 		// when we decode frames. Otherwise, the decoder will reuse buffers, which will then overwrite data already in our queue.
@@ -1070,6 +1251,14 @@ namespace nap
 		mWidth = video_codec_context.width;
 		mHeight = video_codec_context.height;
 		mDuration = static_cast<double>((double)mFormatContext->duration / AV_TIME_BASE);
+
+		// Build or load the keyframe index. Without an index seeking still works, it only searches backwards for the keyframe
+		if (mIndexKeyframes)
+		{
+			utility::ErrorState index_error;
+			if (!mKeyframeIndex.init(mPath, *mFormatContext, mVideoState.getStream(), true, index_error))
+				Logger::warn("%s: unable to index keyframes: %s", mPath.c_str(), index_error.toString().c_str());
+		}
 		return true;
 	}
 
@@ -1086,6 +1275,11 @@ namespace nap
 		mAudioDecodeClockSecs = sClockMax;
 		seek(startTimeSecs);
 
+		// Apply decode settings
+		mDecodePriority = mPriority;
+		mMaxPacketQueueSize = static_cast<uint64_t>(std::max(mPacketQueueSize, 1));
+		mVideoState.setMaxFrameQueueSize(std::max(mFrameQueueSize, 1));
+
 		// It is important that the IOThread is started before the decode thread. The reason is that in startIOThread, we are
 		// initializing synchronization primitives that are used in both IO thread and decode thread 
 		startIOThread();
@@ -1123,6 +1317,7 @@ namespace nap
 		mSeekTarget = -1;
 		mSeekKeyframeTarget = -1;
 		mSeekTargetSecs = seconds;
+		mMasterClockSyncSecs = seconds;
 		setIOThreadState(IOThreadState::SeekRequest);
 	}
 
@@ -1260,13 +1455,17 @@ namespace nap
 
 		mSeekTarget = std::round((seekTargetSecs - stream_start_time) / av_q2d(stream->time_base));
 		mSeekKeyframeTarget = mSeekTarget;
+
+		// When seeking the video stream, the keyframe index tells us where the keyframe is, skipping the iterative search backwards
+		if (&seekState == &mVideoState && !mKeyframeIndex.isEmpty())
+			mSeekKeyframeTarget = mKeyframeIndex.getKeyframe(mKeyframeIndex.find(mSeekTarget)).mDTS;
 	}
 
 
 	bool Video::allocatePacket(uint64_t inPacketSize)
 	{
 		std::unique_lock<std::mutex> lock(mTotalPacketQueueSizeLock);
-		mPacketQueueRoomAvailableCondition.wait(lock, [this, inPacketSize]() { return (mTotalPacketQueueSize + inPacketSize) < sMaxPacketQueueSizeInBytes || mExitIOThreadSignalled; });
+		mPacketQueueRoomAvailableCondition.wait(lock, [this, inPacketSize]() { return (mTotalPacketQueueSize + inPacketSize) < mMaxPacketQueueSize || mExitIOThreadSignalled; });
 		if (mExitIOThreadSignalled)
 			return false;
 
@@ -1592,11 +1791,7 @@ namespace nap
 	{
 		// If there was a previous frame allocated, we have consumed it completely across audio callback and we 
 		// can now destroy it as we're about to decode a new frame.
-		if (mCurrentAudioFrame.mFrame != nullptr)
-		{
-			av_frame_unref(mCurrentAudioFrame.mFrame);
-			av_frame_free(&mCurrentAudioFrame.mFrame);
-		}
+		mCurrentAudioFrame.free();
 
 		mCurrentAudioFrame = mAudioState.popFrame();
 		if (!mCurrentAudioFrame.isValid())
@@ -1758,12 +1953,42 @@ namespace nap
 		// If the video we're playing has an audio stream, we use the audio clock to present frames.
 		// This makes sure that audio/video remain in sync. If there is no audio stream, we use the system clock.
 		double display_clock = audioEnabled() ? mAudioClockSecs : mSystemClockSecs;
-		
+		return popDisplayFrame(display_clock);
+	}
+
+
+	Frame Video::updateSynchronized(double masterClockSecs)
+	{
+		// Bail if we're not in play mode
+		if (!mPlaying)
+			return Frame();
+
+		// If there's nothing to process, return
+		if (mVideoState.isFinished())
+		{
+			stop(true);
+			return Frame();
+		}
+
+		// Synchronize the video time to the master clock after play, seek or loop.
+		// All videos that are started in the same frame receive the same offset, which keeps them frame-locked.
+		double sync_secs = mMasterClockSyncSecs.exchange(sClockMax);
+		if (sync_secs != sClockMax)
+			mMasterClockOffsetSecs = masterClockSecs - sync_secs;
+
+		// The system clock follows the master clock, frames that are late are dropped by tryPopFrame
+		mSystemClockSecs = masterClockSecs - mMasterClockOffsetSecs;
+		return popDisplayFrame(mSystemClockSecs);
+	}
+
+
+	Frame Video::popDisplayFrame(double displayClockSecs)
+	{
 		// Try to get next frame to display (based on display clock)			
-		cur_frame = mVideoState.tryPopFrame(display_clock);
+		Frame cur_frame = mVideoState.tryPopFrame(displayClockSecs);
 
 		// If popped frame is maxxed out, invalidate content
-		if (display_clock == sClockMax)
+		if (displayClockSecs == sClockMax)
 			cur_frame.free();
 		
 		// Return popped frame, make sure to FREE after use!!
@@ -1771,6 +1996,20 @@ namespace nap
 	}
 
 
+	void Video::setFrameSlotPool(const std::shared_ptr<FrameSlotPool>& slotPool)
+	{
+		assert(!mPlaying);
+		mVideoState.setFrameSlotPool(slotPool);
+	}
+
+
+	void Video::setDecodeScheduler(VideoDecodeScheduler* scheduler)
+	{
+		assert(!mPlaying);
+		mDecodeScheduler = scheduler;
+	}
+
+
 	void Video::decodeAudioStream(bool enabled)
 	{
 		mDecodeAudio = enabled;
@@ -10,10 +10,16 @@
 #include <mutex>
 #include <climits>
 #include <cassert>
+#include <memory>
+#include <vector>
 #include <nap/resource.h>
 #include <rtti/factory.h>
 #include <utility/autoresetevent.h>
 #include <nap/signalslot.h>
+#include <atomic>
+
+// Local includes
+#include "videokeyframeindex.h"
 
 struct AVPacket;
 struct AVCodec;
@@ -29,6 +35,7 @@ namespace nap
 {
 	// Forward Declares
 	class Video;
+	class VideoDecodeScheduler;
 	namespace audio
 	{
 		class VideoNode;
@@ -117,17 +124,116 @@ namespace nap
 	};
 
 
+	/**
+	 * Recycles AVFrame objects, so the decode thread doesn't allocate a new AVFrame for every decoded frame.
+	 * Frames are acquired by the decode thread and released when the consumer has processed them. Thread safe.
+	 */
+	class NAPAPI AVFramePool final
+	{
+	public:
+		AVFramePool() = default;
+
+		/**
+		 * Frees all frames in the pool. All acquired frames must have been released.
+		 */
+		~AVFramePool();
+
+		/**
+		 * @return an empty frame from the pool, allocates a new frame when the pool is empty.
+		 */
+		AVFrame* acquire();
+
+		/**
+		 * Unreferences the data of the frame and returns it to the pool.
+		 * @param frame the frame to release, acquired from this pool.
+		 */
+		void release(AVFrame* frame);
+
+	private:
+		std::mutex				mMutex;					///< Guards the list of free frames
+		std::vector<AVFrame*>	mFrames;				///< All frames that are currently not in use
+	};
+
+
+	/**
+	 * Fixed set of preallocated slots that the decode thread copies decoded video frames into.
+	 * When a slot pool is assigned to a video using Video::setFrameSlotPool(), the decode thread acquires a slot for every frame, 
+	 * copies the planes of the frame into it and releases the decoded AVFrame immediately.
+	 * This moves the copy of the frame data from the main thread to the decode thread. 
+	 * The consumer releases the slot when it no longer needs the data, which can be later than processing the frame.
+	 * The decode thread blocks when all slots are in use, the number of slots therefore also limits how far the decoder runs ahead.
+	 * Derived classes implement copyFrame() to copy the planes into the memory of a slot, for example a mapped GPU staging buffer.
+	 */
+	class NAPAPI FrameSlotPool
+	{
+	public:
+		/**
+		 * @param slotCount total number of slots
+		 */
+		FrameSlotPool(int slotCount);
+
+		// Destructor
+		virtual ~FrameSlotPool() = default;
+
+		/**
+		 * Copies the planes of a decoded frame into a slot. Called on the decode thread.
+		 * @param frame the decoded frame
+		 * @param slot the slot to copy the frame into, acquired by the decode thread.
+		 */
+		virtual void copyFrame(const AVFrame& frame, int slot) = 0;
+
+		/**
+		 * Blocks until a slot is available or cancelAcquire() is called.
+		 * @return index of the acquired slot, -1 when cancelled.
+		 */
+		int acquire();
+
+		/**
+		 * Releases a slot, making it available to the decode thread again. Can be called from any thread.
+		 * @param slot the slot to release
+		 */
+		void release(int slot);
+
+		/**
+		 * Unblocks a pending and any subsequent call to acquire(), until resetAcquire() is called.
+		 */
+		void cancelAcquire();
+
+		/**
+		 * Reset the state of the pool so that subsequent calls to acquire() wait normally.
+		 */
+		void resetAcquire();
+
+		/**
+		 * @return total number of slots
+		 */
+		int getSlotCount() const								{ return mSlotCount; }
+
+	private:
+		int						mSlotCount = 0;					///< Total number of slots
+		std::mutex				mMutex;							///< Guards the list of free slots
+		std::condition_variable	mSlotAvailableCondition;		///< Condition describing whether a slot is available or acquiring has been cancelled
+		std::vector<int>		mFreeSlots;						///< All slots that are currently not in use
+		bool					mCancelled = false;				///< If acquiring has been cancelled
+	};
+
+
 	/**
 	 * Frame as pushed in the frame queue.
+	 * A video frame either contains the decoded AVFrame, or the index of the slot that the frame has been copied into. 
+	 * Call free() to release both.
 	 */
 	struct NAPAPI Frame
 	{
-		bool isValid() const { return mFrame != nullptr; }
+		bool isValid() const { return mFrame != nullptr || mSlot != -1; }
 		void free();
 
 		AVFrame*	mFrame = nullptr;		///< Frame as decoded by the decode thread
 		double		mPTSSecs = 0.0;			///< When the frame needs to be displayed (absolute clock time)
 		int			mFirstPacketDTS = 0;	///< First dts that was used to create this frame
+		AVFramePool* mFramePool = nullptr;	///< Pool that mFrame is returned to, freed when null
+		int			mSlot = -1;				///< Slot in mSlotPool that the frame has been copied into, -1 if not copied
+		std::shared_ptr<FrameSlotPool> mSlotPool = nullptr;	///< Pool that owns the slot
 	};
 
 
@@ -317,6 +423,20 @@ namespace nap
 		 */
 		void notifyExitIOThread();
 
+		/**
+		 * Sets the pool of slots that decoded frames are copied into by the decode thread.
+		 * Can only be changed when the decode thread is not running.
+		 * @param slotPool the slot pool, nullptr to pass the decoded AVFrames to the consumer instead.
+		 */
+		void setFrameSlotPool(const std::shared_ptr<FrameSlotPool>& slotPool);
+
+		/**
+		 * Sets the max number of frames the decode thread queues ahead of the consumer.
+		 * Can only be changed when the decode thread is not running.
+		 * @param size max number of queued frames, must be > 0
+		 */
+		void setMaxFrameQueueSize(int size);
+
 		/**
 		 * @return audio or video codec used to decode packets into frames.
 		 */
@@ -356,6 +476,7 @@ namespace nap
 		FrameQueue					mFrameQueue;							///< The frame queue as produced by the decodeThread and consumed by the main thread
 		FrameQueue					mSeekFrameQueue;						///< The frame queue as produced by the decodeThread and consumed by the main thread
 		FrameQueue*					mActiveFrameQueue = &mFrameQueue;		
+		int							mMaxFrameQueueSize = 16;				///< Max number of frames in the active frame queue
 		mutable std::mutex			mFrameQueueMutex;						///< Mutex protection for the frame queue
 		std::condition_variable		mFrameDataAvailableCondition;			///< Condition describing whether there is data in the frame queue to process
 		std::condition_variable		mFrameQueueRoomAvailableCondition;		///< Condition describing whether there is still room in the frame queue to add new frames
@@ -381,6 +502,9 @@ namespace nap
 
 		double						mLastFramePTSSecs = 0.0;				///< The PTS of the last frame in seconds, used to 'guess' the PTS of a new frame if it's unknown.
 		int							mFrameFirstPacketDTS = -INT_MAX;		///< Cached value for the first DTS that was used to produce the current frame
+
+		AVFramePool					mFramePool;								///< Recycles the AVFrames pushed onto the frame queue
+		std::shared_ptr<FrameSlotPool> mSlotPool = nullptr;					///< When set, decoded frames are copied into slots of this pool by the decode thread
 	};
 
 
@@ -443,6 +567,18 @@ namespace nap
 		 */
 		Frame update(double deltaTime);
 
+		/**
+		 * Returns a newly decoded frame if available, an invalid frame otherwise.
+		 * Frames are presented based on the time of a master clock instead of the internal clock of the video,
+		 * use this to keep multiple videos that share the same clock frame-locked. See nap::VideoClock.
+		 * The video time is synchronized to the master clock when playback starts, on seek and when the video loops.
+		 * Frames that are late are dropped, the speed of the video and the audio clock are ignored.
+		 * Always call .free() after processing frame content! This is a non-blocking call.
+		 * @param masterClockSecs current time of the master clock in seconds.
+		 * @return a newly decoded frame if available, an invalid frame otherwise.
+		 */
+		Frame updateSynchronized(double masterClockSecs);
+
 		/**
 		 * Starts playback of the video at the given time in seconds.
 		 * This will spawn the video IO and decode threads in the background.
@@ -507,8 +643,33 @@ namespace nap
 		 */
 		bool audioEnabled() const				{ return hasAudio() && mDecodeAudio; }
 
+		/**
+		 * Sets the pool of slots that decoded video frames are copied into by the decode thread.
+		 * The frames returned by update() then contain a slot index instead of an AVFrame.
+		 * Note that this can only be changed when the video is not playing.
+		 * @param slotPool the slot pool, nullptr to receive the decoded AVFrames instead.
+		 */
+		void setFrameSlotPool(const std::shared_ptr<FrameSlotPool>& slotPool);
+
+		/**
+		 * Sets the scheduler that limits the number of videos that decode at the same time.
+		 * Note that this can only be changed when the video is not playing.
+		 * @param scheduler the scheduler, nullptr to decode without limit.
+		 */
+		void setDecodeScheduler(VideoDecodeScheduler* scheduler);
+
+		/**
+		 * @return the keyframes of the video stream, empty when not indexed.
+		 */
+		const VideoKeyframeIndex& getKeyframeIndex() const		{ return mKeyframeIndex; }
+
 		bool		mLoop = false;				///< If the video needs to loop
 		float		mSpeed = 1.0f;				///< Video playback speed
+		int			mPriority = 0;				///< Decode priority, a higher priority is served first when all workers of the decode scheduler are busy. Applied on play.
+		int			mFrameQueueSize = 16;		///< Max number of decoded video frames queued ahead of presentation. Applied on play.
+		int			mPacketQueueSize = 16 * 1024 * 1024;	///< Max size in bytes of all packets queued ahead of decoding. Applied on play.
+		int			mCodecThreadCount = 0;		///< Number of threads used by the codec, 0 = decided by the codec. Applied on init.
+		bool		mIndexKeyframes = false;		///< If the keyframes are indexed on init, allowing seeks to go directly to the right keyframe. The index is cached next to the video. Applied on init.
         
         nap::Signal<Video&> mDestructedSignal; ///< This signal will be emitted before the Video resource is destructed
 
@@ -633,6 +794,12 @@ namespace nap
 		 */
 		void decodeAudioStream(bool enabled);
 
+		/**
+		 * Pops the frame to display at the given time from the video frame queue.
+		 * @param displayClockSecs the time of the clock that is being displayed.
+		 */
+		Frame popDisplayFrame(double displayClockSecs);
+
 		/**
 		 * Function that needs to be called by the audio system on a fixed frequency to copy the audio data from the audio
 		 * stream into the target buffer.
@@ -654,6 +821,12 @@ namespace nap
 		double					mSystemClockSecs = sClockMax;				///< Clock that we use to synchronize the video to if there is no audio stream
 		double					mAudioDecodeClockSecs = -1;					///< Clock that indicates up to which time the audio thread has decoded frame
 		double					mAudioClockSecs = -1;						///< Clock that indicates the actual time of the *playing* audio
+		double					mMasterClockOffsetSecs = 0.0;				///< Difference between the master clock and the video time, when synchronized to a master clock
+		std::atomic<double>		mMasterClockSyncSecs = { sClockMax };		///< Video time to synchronize to the master clock on the next update, sClockMax if no synchronization is pending
+		VideoDecodeScheduler*	mDecodeScheduler = nullptr;					///< Limits the number of videos that decode at the same time
+		int						mDecodePriority = 0;						///< Decode priority in use by the decode threads
+		uint64_t				mMaxPacketQueueSize = 16 * 1024 * 1024;		///< Max size in bytes of all queued packets in use by the IO thread
+		VideoKeyframeIndex		mKeyframeIndex;								///< Keyframes of the video stream, used to seek
 
 		std::string				mErrorMessage;								///< If an error occurs, this is the string containing error information. If empty, no error occured.
 		
@@ -0,0 +1,43 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videoclock.h"
+#include "videoservice.h"
+
+// nap::videoclock run time class definition
+RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::VideoClock)
+	RTTI_CONSTRUCTOR(nap::VideoService&)
+	RTTI_PROPERTY("Speed",		&nap::VideoClock::mSpeed,			nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+
+namespace nap
+{
+	VideoClock::VideoClock(VideoService& service) :
+		mService(service)
+	{ }
+
+
+	bool VideoClock::start(utility::ErrorState& errorState)
+	{
+		mTime = 0.0;
+		mService.registerVideoClock(*this);
+		return true;
+	}
+
+
+	void VideoClock::stop()
+	{
+		mService.removeVideoClock(*this);
+	}
+
+
+	void VideoClock::update(double deltaTime)
+	{
+		mTime += deltaTime * mSpeed;
+	}
+}
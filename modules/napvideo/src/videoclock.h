@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <nap/device.h>
+#include <rtti/factory.h>
+
+namespace nap
+{
+	// Forward Declares
+	class VideoService;
+
+	/**
+	 * Master clock shared by a group of video players.
+	 * Every video player that links to the same clock presents its frames based on the time of this clock,
+	 * instead of its own clock, keeping all videos in the group frame-locked.
+	 * Frames that are decoded too late are dropped instead of delaying the video.
+	 * Videos that are started in the same frame stay in sync within a single frame.
+	 * The clock is advanced once every frame by the nap::VideoService, before the video players are updated.
+	 * Note that the audio of a video that is synchronized to a master clock is not synchronized to the video.
+	 */
+	class NAPAPI VideoClock : public Device
+	{
+		RTTI_ENABLE(Device)
+	public:
+		/**
+		 * @param service the video service that advances the clock
+		 */
+		VideoClock(VideoService& service);
+
+		/**
+		 * Starts advancing the clock
+		 * @param errorState contains the error if the clock can't be started
+		 * @return if the clock started
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Stops advancing the clock
+		 */
+		virtual void stop() override;
+
+		/**
+		 * @return the time of the clock in seconds since start
+		 */
+		double getTime() const										{ return mTime; }
+
+		/**
+		 * @param speed playback speed of all videos that are synchronized to this clock
+		 */
+		void setSpeed(float speed)									{ mSpeed = speed; }
+
+		/**
+		 * @return playback speed of all videos that are synchronized to this clock
+		 */
+		float getSpeed() const										{ return mSpeed; }
+
+		float mSpeed = 1.0f;										///< Property: 'Speed' playback speed of all videos that are synchronized to this clock
+
+	private:
+		friend class VideoService;
+
+		/**
+		 * Advances the clock, called by the video service
+		 * @param deltaTime time in seconds since the last update
+		 */
+		void update(double deltaTime);
+
+		double			mTime = 0.0;								///< Current time of the clock in seconds
+		VideoService&	mService;									///< Video service that advances this clock
+	};
+
+	// Object creator used for constructing the video clock
+	using VideoClockObjectCreator = rtti::ObjectCreator<VideoClock, VideoService>;
+}
@@ -0,0 +1,86 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videodecodescheduler.h"
+
+// External Includes
+#include <cassert>
+
+namespace nap
+{
+	VideoDecodeScheduler::Worker::Worker(VideoDecodeScheduler* scheduler, int priority, const bool& cancelled) :
+		mScheduler(scheduler)
+	{
+		mAcquired = mScheduler == nullptr || mScheduler->acquire(priority, cancelled);
+	}
+
+
+	VideoDecodeScheduler::Worker::~Worker()
+	{
+		release();
+	}
+
+
+	void VideoDecodeScheduler::Worker::release()
+	{
+		if (mScheduler != nullptr && mAcquired)
+			mScheduler->release();
+		mAcquired = false;
+	}
+
+
+	VideoDecodeScheduler::VideoDecodeScheduler(int workerCount) :
+		mWorkerCount(workerCount),
+		mAvailableCount(workerCount)
+	{
+		assert(workerCount > 0);
+	}
+
+
+	bool VideoDecodeScheduler::acquire(int priority, const bool& cancelled)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		Request request = { -priority, mRequestCount++ };
+		mWaiting.emplace(request);
+		mCondition.wait(lock, [&]()
+		{
+			return cancelled || (mAvailableCount > 0 && *mWaiting.begin() == request);
+		});
+		mWaiting.erase(request);
+
+		// A cancelled request may have been first in line, let the next one check again
+		if (cancelled)
+		{
+			mCondition.notify_all();
+			return false;
+		}
+
+		mAvailableCount--;
+		if (mAvailableCount > 0 && !mWaiting.empty())
+			mCondition.notify_all();
+		return true;
+	}
+
+
+	void VideoDecodeScheduler::release()
+	{
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			assert(mAvailableCount < mWorkerCount);
+			mAvailableCount++;
+		}
+		mCondition.notify_all();
+	}
+
+
+	void VideoDecodeScheduler::notifyCancelled()
+	{
+		// Lock to make sure a thread that is about to wait sees the flag or receives the notification
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+		}
+		mCondition.notify_all();
+	}
+}
@@ -0,0 +1,100 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <nap/numeric.h>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+
+namespace nap
+{
+	/**
+	 * Limits the number of videos that decode at the same time.
+	 * Every video has its own decode thread, but a decode thread has to acquire one of a fixed number of workers before it calls into the codec.
+	 * This keeps the number of cores used for decoding bounded, regardless of how many videos are playing.
+	 * When all workers are busy, waiting decode threads are served in order of priority, and in order of arrival for equal priority.
+	 * Owned by the nap::VideoService, shared by all videos.
+	 */
+	class NAPAPI VideoDecodeScheduler final
+	{
+	public:
+		/**
+		 * Holds a worker for the duration of a scope.
+		 * Check isAcquired() before decoding, acquiring fails when the calling thread is signalled to exit.
+		 */
+		class NAPAPI Worker final
+		{
+		public:
+			/**
+			 * Blocks until a worker is available or 'cancelled' is set.
+			 * @param scheduler the scheduler to acquire a worker from, nullptr to acquire nothing and succeed immediately.
+			 * @param priority decode priority, higher is served first.
+			 * @param cancelled flag that is set when the calling thread should stop waiting.
+			 */
+			Worker(VideoDecodeScheduler* scheduler, int priority, const bool& cancelled);
+
+			// Releases the worker
+			~Worker();
+
+			Worker(const Worker&) = delete;
+			Worker& operator=(const Worker&) = delete;
+
+			/**
+			 * @return if the worker was acquired.
+			 */
+			bool isAcquired() const								{ return mAcquired; }
+
+			/**
+			 * Releases the worker before the end of the scope.
+			 */
+			void release();
+
+		private:
+			VideoDecodeScheduler* mScheduler = nullptr;
+			bool mAcquired = false;
+		};
+
+		/**
+		 * @param workerCount max number of videos that decode at the same time, must be > 0
+		 */
+		VideoDecodeScheduler(int workerCount);
+
+		/**
+		 * Blocks until a worker is available and all waiting threads with a higher priority have been served, or until 'cancelled' is set.
+		 * @param priority decode priority, higher is served first.
+		 * @param cancelled flag that is set when the calling thread should stop waiting, call notifyCancelled() after setting it.
+		 * @return if a worker was acquired, false when cancelled.
+		 */
+		bool acquire(int priority, const bool& cancelled);
+
+		/**
+		 * Makes a worker available again, call once for every successful acquire().
+		 */
+		void release();
+
+		/**
+		 * Wakes up all waiting threads to check their 'cancelled' flag.
+		 */
+		void notifyCancelled();
+
+		/**
+		 * @return max number of videos that decode at the same time
+		 */
+		int getWorkerCount() const								{ return mWorkerCount; }
+
+	private:
+		using Request = std::pair<int, uint64>;					///< Negated priority and arrival order, the first request in the set is served first
+
+		int							mWorkerCount = 0;			///< Total number of workers
+		int							mAvailableCount = 0;		///< Number of workers currently available
+		uint64						mRequestCount = 0;			///< Number of requests made, used to order requests of equal priority
+		std::set<Request>			mWaiting;					///< All requests waiting for a worker
+		std::mutex					mMutex;						///< Guards the workers and waiting requests
+		std::condition_variable		mCondition;					///< Signalled when a worker becomes available or a request is cancelled
+	};
+}
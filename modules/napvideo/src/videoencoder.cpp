@@ -0,0 +1,464 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videoencoder.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <mathutils.h>
+#include <utility/stringutils.h>
+#include <cstring>
+#include <functional>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+	#include <libavutil/opt.h>
+}
+
+namespace nap
+{
+	/**
+	 * Converts an FFmpeg error code to a string
+	 */
+	static std::string sErrorToString(int err)
+	{
+		char error_buf[256];
+		av_strerror(err, error_buf, sizeof(error_buf));
+		return std::string(error_buf);
+	}
+
+
+	/**
+	 * BT.709 limited range RGB to YUV conversion, 8 bit precision.
+	 * The offsets keep the intermediate values positive before shifting.
+	 */
+	static inline uint8 sToY8(int r, int g, int b)		{ return static_cast<uint8>((47 * r + 157 * g + 16 * b + 4224) >> 8); }
+	static inline uint8 sToU8(int r, int g, int b)		{ return static_cast<uint8>((-26 * r - 87 * g + 112 * b + 32896) >> 8); }
+	static inline uint8 sToV8(int r, int g, int b)		{ return static_cast<uint8>((112 * r - 102 * g - 10 * b + 32896) >> 8); }
+
+
+	/**
+	 * BT.709 limited range RGB to YUV conversion, 10 bit precision.
+	 */
+	static inline uint16 sToY10(int r, int g, int b)	{ return static_cast<uint16>((4 * (47 * r + 157 * g + 16 * b) + 16512) >> 8); }
+	static inline uint16 sToU10(int r, int g, int b)	{ return static_cast<uint16>((4 * (-26 * r - 87 * g + 112 * b) + 131200) >> 8); }
+	static inline uint16 sToV10(int r, int g, int b)	{ return static_cast<uint16>((4 * (112 * r - 102 * g - 10 * b) + 131200) >> 8); }
+
+
+	/**
+	 * RGBA8 to YUV 4:2:0, chroma is the average of every 2x2 block
+	 */
+	static void sConvertToYUV420(const uint8* source, int width, int height, AVFrame& target)
+	{
+		int source_pitch = width * 4;
+		for (int y = 0; y < height; y += 2)
+		{
+			const uint8* row_0 = source + y * source_pitch;
+			const uint8* row_1 = row_0 + source_pitch;
+			uint8* y_0 = target.data[0] + y * target.linesize[0];
+			uint8* y_1 = y_0 + target.linesize[0];
+			uint8* u = target.data[1] + (y / 2) * target.linesize[1];
+			uint8* v = target.data[2] + (y / 2) * target.linesize[2];
+			for (int x = 0; x < width; x += 2)
+			{
+				const uint8* p = row_0 + x * 4;
+				const uint8* q = row_1 + x * 4;
+				y_0[x]		= sToY8(p[0], p[1], p[2]);
+				y_0[x + 1]	= sToY8(p[4], p[5], p[6]);
+				y_1[x]		= sToY8(q[0], q[1], q[2]);
+				y_1[x + 1]	= sToY8(q[4], q[5], q[6]);
+
+				int r = (p[0] + p[4] + q[0] + q[4] + 2) >> 2;
+				int g = (p[1] + p[5] + q[1] + q[5] + 2) >> 2;
+				int b = (p[2] + p[6] + q[2] + q[6] + 2) >> 2;
+				u[x / 2] = sToU8(r, g, b);
+				v[x / 2] = sToV8(r, g, b);
+			}
+		}
+	}
+
+
+	/**
+	 * RGBA8 to YUV 4:2:2 10 bit, chroma is the average of every 2x1 block
+	 */
+	static void sConvertToYUV422P10(const uint8* source, int width, int height, AVFrame& target)
+	{
+		int source_pitch = width * 4;
+		for (int y = 0; y < height; y++)
+		{
+			const uint8* row = source + y * source_pitch;
+			uint16* y_row = reinterpret_cast<uint16*>(target.data[0] + y * target.linesize[0]);
+			uint16* u_row = reinterpret_cast<uint16*>(target.data[1] + y * target.linesize[1]);
+			uint16* v_row = reinterpret_cast<uint16*>(target.data[2] + y * target.linesize[2]);
+			for (int x = 0; x < width; x += 2)
+			{
+				const uint8* p = row + x * 4;
+				y_row[x]		= sToY10(p[0], p[1], p[2]);
+				y_row[x + 1]	= sToY10(p[4], p[5], p[6]);
+
+				int r = (p[0] + p[4] + 1) >> 1;
+				int g = (p[1] + p[5] + 1) >> 1;
+				int b = (p[2] + p[6] + 1) >> 1;
+				u_row[x / 2] = sToU10(r, g, b);
+				v_row[x / 2] = sToV10(r, g, b);
+			}
+		}
+	}
+
+
+	/**
+	 * RGBA8 to packed 0RGB, stored as native 32 bit words
+	 */
+	static void sConvertTo0RGB(const uint8* source, int width, int height, AVFrame& target)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			const uint8* row = source + y * width * 4;
+			uint32* target_row = reinterpret_cast<uint32*>(target.data[0] + y * target.linesize[0]);
+			for (int x = 0; x < width; x++)
+			{
+				const uint8* p = row + x * 4;
+				target_row[x] = (static_cast<uint32>(p[0]) << 16) | (static_cast<uint32>(p[1]) << 8) | static_cast<uint32>(p[2]);
+			}
+		}
+	}
+
+
+	//////////////////////////////////////////////////////////////////////////
+	// VideoEncoder
+	//////////////////////////////////////////////////////////////////////////
+
+	VideoEncoder::VideoEncoder(int width, int height, int bufferCount, bool dropFrames) :
+		mWidth(width),
+		mHeight(height),
+		mBufferCount(bufferCount),
+		mDropFrames(dropFrames)
+	{ }
+
+
+	VideoEncoder::~VideoEncoder()
+	{
+		finish();
+		close();
+	}
+
+
+	bool VideoEncoder::init(const std::string& path, EVideoEncoderCodec codec, int frameRate, int bitRate, bool deterministic, utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mWidth > 0 && mHeight > 0 && frameRate > 0 && mBufferCount > 0, "Invalid encoder settings"))
+			return false;
+
+		// Select encoder and the pixel format it is fed with
+		AVCodec* encoder = nullptr;
+		AVPixelFormat pixel_format = AV_PIX_FMT_NONE;
+		switch (codec)
+		{
+		case EVideoEncoderCodec::H264:
+			encoder = avcodec_find_encoder_by_name("libx264");
+			if (encoder == nullptr)
+				encoder = avcodec_find_encoder(AV_CODEC_ID_H264);
+			pixel_format = AV_PIX_FMT_YUV420P;
+			break;
+		case EVideoEncoderCodec::ProRes:
+			encoder = avcodec_find_encoder_by_name("prores_ks");
+			if (encoder == nullptr)
+				encoder = avcodec_find_encoder(AV_CODEC_ID_PRORES);
+			pixel_format = AV_PIX_FMT_YUV422P10LE;
+			break;
+		case EVideoEncoderCodec::FFV1:
+			encoder = avcodec_find_encoder(AV_CODEC_ID_FFV1);
+			pixel_format = AV_PIX_FMT_0RGB32;
+			break;
+		}
+		if (!errorState.check(encoder != nullptr, "Encoder not available"))
+			return false;
+
+		// Chroma subsampling requires an even width, and height for 4:2:0
+		if (!errorState.check(pixel_format == AV_PIX_FMT_0RGB32 || (mWidth % 2 == 0 && (pixel_format != AV_PIX_FMT_YUV420P || mHeight % 2 == 0)), "Frame dimensions must be even: %d x %d", mWidth, mHeight))
+			return false;
+
+		// Create output, the container is derived from the extension
+		int error = avformat_alloc_output_context2(&mFormatContext, nullptr, nullptr, path.c_str());
+		if (!errorState.check(error >= 0 && mFormatContext != nullptr, "Unable to determine container format of '%s': %s", path.c_str(), sErrorToString(error).c_str()))
+			return false;
+
+		mStream = avformat_new_stream(mFormatContext, nullptr);
+		if (!errorState.check(mStream != nullptr, "Unable to create video stream"))
+			return false;
+
+		// Configure encoder
+		mCodecContext = avcodec_alloc_context3(encoder);
+		if (!errorState.check(mCodecContext != nullptr, "Unable to allocate encoder context"))
+			return false;
+
+		mCodecContext->width = mWidth;
+		mCodecContext->height = mHeight;
+		mCodecContext->pix_fmt = pixel_format;
+		mCodecContext->time_base = { 1, frameRate };
+		mCodecContext->framerate = { frameRate, 1 };
+		mCodecContext->gop_size = frameRate;
+		mCodecContext->color_primaries = AVCOL_PRI_BT709;
+		mCodecContext->color_trc = AVCOL_TRC_BT709;
+		mCodecContext->colorspace = pixel_format == AV_PIX_FMT_0RGB32 ? AVCOL_SPC_RGB : AVCOL_SPC_BT709;
+		mCodecContext->color_range = pixel_format == AV_PIX_FMT_0RGB32 ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG;
+		if (bitRate > 0)
+			mCodecContext->bit_rate = static_cast<int64_t>(bitRate) * 1000;
+		else if (codec == EVideoEncoderCodec::H264)
+			av_opt_set(mCodecContext->priv_data, "crf", "18", 0);
+
+		if (codec == EVideoEncoderCodec::ProRes)
+			av_opt_set(mCodecContext->priv_data, "profile", "hq", 0);
+
+		// The same frames must result in the same file, which rules out threaded encoding
+		mCodecContext->thread_count = deterministic ? 1 : 0;
+		if (deterministic)
+		{
+			mCodecContext->flags |= AV_CODEC_FLAG_BITEXACT;
+			mFormatContext->flags |= AVFMT_FLAG_BITEXACT;
+		}
+
+		if (mFormatContext->oformat->flags & AVFMT_GLOBALHEADER)
+			mCodecContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+
+		error = avcodec_open2(mCodecContext, encoder, nullptr);
+		if (!errorState.check(error >= 0, "Unable to open encoder: %s", sErrorToString(error).c_str()))
+			return false;
+
+		error = avcodec_parameters_from_context(mStream->codecpar, mCodecContext);
+		if (!errorState.check(error >= 0, "Unable to copy encoder parameters: %s", sErrorToString(error).c_str()))
+			return false;
+		mStream->time_base = mCodecContext->time_base;
+
+		// Frame in the pixel format of the codec, the frames are converted into
+		mFrame = av_frame_alloc();
+		mFrame->format = pixel_format;
+		mFrame->width = mWidth;
+		mFrame->height = mHeight;
+		error = av_frame_get_buffer(mFrame, 32);
+		if (!errorState.check(error >= 0, "Unable to allocate frame: %s", sErrorToString(error).c_str()))
+			return false;
+		mPacket = av_packet_alloc();
+
+		// Open file and write header
+		if (!(mFormatContext->oformat->flags & AVFMT_NOFILE))
+		{
+			error = avio_open(&mFormatContext->pb, path.c_str(), AVIO_FLAG_WRITE);
+			if (!errorState.check(error >= 0, "Unable to open '%s' for writing: %s", path.c_str(), sErrorToString(error).c_str()))
+				return false;
+		}
+
+		error = avformat_write_header(mFormatContext, nullptr);
+		if (!errorState.check(error >= 0, "Unable to write header: %s", sErrorToString(error).c_str()))
+			return false;
+
+		// Allocate all frame buffers up front, submitting a frame never allocates unless dropping is disabled
+		for (int i = 0; i < mBufferCount; i++)
+		{
+			mFreeFrames.emplace_back(std::make_unique<QueuedFrame>());
+			mFreeFrames.back()->mData.resize(mWidth * mHeight * 4);
+		}
+		mAllocatedFrames = mBufferCount;
+
+		mEncodeThread = std::thread(std::bind(&VideoEncoder::encodeThread, this));
+		return true;
+	}
+
+
+	bool VideoEncoder::submit(const void* data, size_t sizeInBytes, int64 frameIndex)
+	{
+		assert(sizeInBytes == mWidth * mHeight * 4);
+
+		// Take a buffer from the pool, or drop the frame when all buffers are in use
+		std::unique_ptr<QueuedFrame> frame;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mFinishSignalled || mErrorOccurred || !mEncodeThread.joinable())
+				return false;
+
+			mStats.mSubmitted++;
+			if (!mFreeFrames.empty())
+			{
+				frame = std::move(mFreeFrames.back());
+				mFreeFrames.pop_back();
+			}
+			else if (!mDropFrames)
+			{
+				frame = std::make_unique<QueuedFrame>();
+				frame->mData.resize(mWidth * mHeight * 4);
+				mAllocatedFrames++;
+			}
+			else
+			{
+				mStats.mDropped++;
+				return false;
+			}
+		}
+
+		// Copy outside of the lock, the encode thread can continue in the meantime
+		std::memcpy(frame->mData.data(), data, frame->mData.size());
+		frame->mIndex = frameIndex;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mQueue.emplace_back(std::move(frame));
+			mStats.mQueued++;
+			mStats.mPeakQueued = math::max<int>(mStats.mPeakQueued, mStats.mQueued);
+		}
+		mQueueCondition.notify_one();
+		return true;
+	}
+
+
+	void VideoEncoder::finish()
+	{
+		if (!mEncodeThread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mFinishSignalled = true;
+		}
+		mQueueCondition.notify_one();
+		mEncodeThread.join();
+	}
+
+
+	VideoEncoderStats VideoEncoder::getStats() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mStats;
+	}
+
+
+	bool VideoEncoder::hasErrorOccurred() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mErrorOccurred;
+	}
+
+
+	void VideoEncoder::encodeThread()
+	{
+		while (true)
+		{
+			// Wait for a frame, the queue is drained before finishing
+			std::unique_ptr<QueuedFrame> frame;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mQueueCondition.wait(lock, [this]() { return mFinishSignalled || !mQueue.empty(); });
+				if (mQueue.empty())
+					break;
+
+				frame = std::move(mQueue.front());
+				mQueue.pop_front();
+			}
+
+			// Frames are still returned to the pool after an error, but no longer encoded
+			bool encoded = !mErrorOccurred && encodeFrame(*frame);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStats.mQueued--;
+			if (encoded)
+				mStats.mEncoded++;
+			mFreeFrames.emplace_back(std::move(frame));
+		}
+
+		// Flush the encoder and finish the file
+		if (mErrorOccurred)
+			return;
+
+		avcodec_send_frame(mCodecContext, nullptr);
+		if (!writePackets())
+			return;
+
+		int error = av_write_trailer(mFormatContext);
+		if (error < 0)
+			setError(utility::stringFormat("Unable to write trailer: %s", sErrorToString(error).c_str()));
+	}
+
+
+	bool VideoEncoder::encodeFrame(const QueuedFrame& frame)
+	{
+		// The encoder can still reference the previous frame
+		int error = av_frame_make_writable(mFrame);
+		if (error < 0)
+		{
+			setError(utility::stringFormat("Unable to write frame: %s", sErrorToString(error).c_str()));
+			return false;
+		}
+
+		switch (mCodecContext->pix_fmt)
+		{
+		case AV_PIX_FMT_YUV420P:
+			sConvertToYUV420(frame.mData.data(), mWidth, mHeight, *mFrame);
+			break;
+		case AV_PIX_FMT_YUV422P10LE:
+			sConvertToYUV422P10(frame.mData.data(), mWidth, mHeight, *mFrame);
+			break;
+		default:
+			sConvertTo0RGB(frame.mData.data(), mWidth, mHeight, *mFrame);
+			break;
+		}
+		mFrame->pts = frame.mIndex;
+
+		error = avcodec_send_frame(mCodecContext, mFrame);
+		if (error < 0)
+		{
+			setError(utility::stringFormat("Unable to encode frame %d: %s", static_cast<int>(frame.mIndex), sErrorToString(error).c_str()));
+			return false;
+		}
+		return writePackets();
+	}
+
+
+	bool VideoEncoder::writePackets()
+	{
+		int result = 0;
+		while ((result = avcodec_receive_packet(mCodecContext, mPacket)) >= 0)
+		{
+			av_packet_rescale_ts(mPacket, mCodecContext->time_base, mStream->time_base);
+			mPacket->stream_index = mStream->index;
+			result = av_interleaved_write_frame(mFormatContext, mPacket);
+			if (result < 0)
+			{
+				setError(utility::stringFormat("Unable to write packet: %s", sErrorToString(result).c_str()));
+				return false;
+			}
+		}
+
+		if (result != AVERROR(EAGAIN) && result != AVERROR_EOF)
+		{
+			setError(utility::stringFormat("Unable to receive packet: %s", sErrorToString(result).c_str()));
+			return false;
+		}
+		return true;
+	}
+
+
+	void VideoEncoder::setError(const std::string& message)
+	{
+		nap::Logger::error("VideoEncoder: %s", message.c_str());
+		std::lock_guard<std::mutex> lock(mMutex);
+		mErrorOccurred = true;
+	}
+
+
+	void VideoEncoder::close()
+	{
+		av_packet_free(&mPacket);
+		av_frame_free(&mFrame);
+		avcodec_free_context(&mCodecContext);
+		if (mFormatContext != nullptr)
+		{
+			if (mFormatContext->pb != nullptr && !(mFormatContext->oformat->flags & AVFMT_NOFILE))
+				avio_closep(&mFormatContext->pb);
+			avformat_free_context(mFormatContext);
+			mFormatContext = nullptr;
+		}
+		mStream = nullptr;
+	}
+}
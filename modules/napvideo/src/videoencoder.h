@@ -0,0 +1,168 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <utility/errorstate.h>
+#include <nap/numeric.h>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVStream;
+struct AVFrame;
+struct AVPacket;
+
+namespace nap
+{
+	/**
+	 * Codecs supported by the nap::VideoEncoder
+	 */
+	enum class EVideoEncoderCodec : int
+	{
+		H264		= 0,		///< H.264, YUV 4:2:0, lossy
+		ProRes		= 1,		///< Apple ProRes 422 HQ, YUV 4:2:2 10 bit, visually lossless
+		FFV1		= 2			///< FFV1, RGB, lossless
+	};
+
+
+	/**
+	 * Frame statistics of a nap::VideoEncoder
+	 */
+	struct NAPAPI VideoEncoderStats
+	{
+		uint64		mSubmitted = 0;			///< Number of frames submitted for encoding
+		uint64		mEncoded = 0;			///< Number of frames encoded and written to file
+		uint64		mDropped = 0;			///< Number of frames dropped because all frame buffers were in use
+		int			mQueued = 0;			///< Number of frames waiting to be encoded
+		int			mPeakQueued = 0;		///< Max number of frames that were waiting to be encoded at the same time
+	};
+
+
+	/**
+	 * Encodes RGBA8 frames into a video file on a background thread.
+	 * Frames are submitted by copying them into a pool of frame buffers, which is a non blocking operation.
+	 * When all buffers are in use the frame is either dropped, or a new buffer is allocated when dropping is disabled.
+	 * The container format is derived from the extension of the file, for example: .mp4, .mov or .mkv.
+	 * The frame index of a submitted frame is its presentation timestamp, a dropped frame leaves a gap in the video.
+	 * Colors are converted to YUV using BT.709 coefficients, in limited range.
+	 */
+	class NAPAPI VideoEncoder final
+	{
+	public:
+		/**
+		 * @param width width of the frames in pixels
+		 * @param height height of the frames in pixels
+		 * @param bufferCount number of frame buffers that can be waiting to be encoded
+		 * @param dropFrames if frames are dropped when all frame buffers are in use, otherwise more buffers are allocated
+		 */
+		VideoEncoder(int width, int height, int bufferCount, bool dropFrames);
+
+		/**
+		 * Finishes encoding all submitted frames and closes the file.
+		 */
+		~VideoEncoder();
+
+		VideoEncoder(const VideoEncoder&) = delete;
+		VideoEncoder& operator=(const VideoEncoder&) = delete;
+
+		/**
+		 * Creates the file, opens the encoder and starts the encode thread.
+		 * @param path the video file to create, the extension determines the container format.
+		 * @param codec the codec to encode with
+		 * @param frameRate number of frames per second
+		 * @param bitRate target bit rate in kbit/s for lossy codecs, 0 = decided by the encoder
+		 * @param deterministic if the encoder produces the same file for the same frames, encodes single threaded
+		 * @param errorState contains the error if the encoder can't be opened
+		 * @return if the encoder opened
+		 */
+		bool init(const std::string& path, EVideoEncoderCodec codec, int frameRate, int bitRate, bool deterministic, utility::ErrorState& errorState);
+
+		/**
+		 * Copies a frame into a frame buffer and queues it for encoding. Non blocking.
+		 * @param data tightly packed RGBA8 pixel data, width * height * 4 bytes.
+		 * @param frameIndex index of the frame, determines when the frame is displayed.
+		 * @return if the frame is queued, false if the frame is dropped
+		 */
+		bool submit(const void* data, size_t sizeInBytes, int64 frameIndex);
+
+		/**
+		 * Encodes all queued frames, writes the end of the file and closes it.
+		 * Blocks until all frames are encoded. No frames can be submitted afterwards.
+		 */
+		void finish();
+
+		/**
+		 * @return frame statistics
+		 */
+		VideoEncoderStats getStats() const;
+
+		/**
+		 * @return if an error occurred while encoding, the file is closed when this happens
+		 */
+		bool hasErrorOccurred() const;
+
+	private:
+		/**
+		 * Frame waiting to be encoded
+		 */
+		struct QueuedFrame
+		{
+			std::vector<uint8>		mData;					///< RGBA8 pixel data
+			int64					mIndex = 0;				///< Frame index
+		};
+
+		/**
+		 * Encodes queued frames until finish() is called and the queue is empty
+		 */
+		void encodeThread();
+
+		/**
+		 * Converts a frame to the pixel format of the codec and sends it to the encoder
+		 */
+		bool encodeFrame(const QueuedFrame& frame);
+
+		/**
+		 * Writes all packets that are available from the encoder to file
+		 */
+		bool writePackets();
+
+		/**
+		 * Stores the error and logs it, called from the encode thread
+		 */
+		void setError(const std::string& message);
+
+		/**
+		 * Frees the encoder and the format context
+		 */
+		void close();
+
+		int						mWidth = 0;							///< Width of the frames in pixels
+		int						mHeight = 0;						///< Height of the frames in pixels
+		int						mBufferCount = 0;					///< Number of frame buffers in the pool
+		bool					mDropFrames = true;					///< If frames are dropped when all buffers are in use
+		AVFormatContext*		mFormatContext = nullptr;			///< Output file
+		AVCodecContext*			mCodecContext = nullptr;			///< Encoder
+		AVStream*				mStream = nullptr;					///< Video stream in the output file
+		AVFrame*				mFrame = nullptr;					///< Frame in the pixel format of the codec
+		AVPacket*				mPacket = nullptr;					///< Encoded packet
+
+		std::thread				mEncodeThread;						///< Encodes queued frames
+		mutable std::mutex		mMutex;								///< Guards the queue, the pool and the stats
+		std::condition_variable	mQueueCondition;					///< Signalled when a frame is queued or finish is called
+		std::deque<std::unique_ptr<QueuedFrame>> mQueue;			///< Frames waiting to be encoded
+		std::vector<std::unique_ptr<QueuedFrame>> mFreeFrames;		///< Frame buffers that are available
+		int						mAllocatedFrames = 0;				///< Number of frame buffers allocated
+		VideoEncoderStats		mStats;								///< Frame statistics
+		bool					mFinishSignalled = false;			///< If the encode thread should finish
+		bool					mErrorOccurred = false;				///< If an error occurred while encoding
+	};
+}
@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videoframecache.h"
+
+namespace nap
+{
+	VideoFrameCache::VideoFrameCache(uint64_t capacity) :
+		mCapacity(capacity)
+	{ }
+
+
+	void VideoFrameCache::insert(int gop, std::vector<FramePtr>&& frames)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		erase(gop);
+
+		uint64_t size = 0;
+		for (const auto& frame : frames)
+			size += frame->mData.size();
+
+		// Evict the least recently used GOPs until the new GOP fits
+		while (!mUsage.empty() && mSize + size > mCapacity)
+			erase(mUsage.back());
+
+		GOP& entry = mGOPs[gop];
+		entry.mFrames = std::move(frames);
+		entry.mSize = size;
+		mUsage.emplace_front(gop);
+		entry.mUsage = mUsage.begin();
+		mSize += size;
+
+		for (const auto& frame : entry.mFrames)
+			mFrames[frame->mPTSSecs] = { gop, frame };
+	}
+
+
+	VideoFrameCache::FramePtr VideoFrameCache::find(double seconds)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// Find the last frame that starts at or before the given time
+		auto it = mFrames.upper_bound(seconds);
+		if (it == mFrames.begin())
+			return nullptr;
+		--it;
+
+		// The frame is only valid when it is still displayed at the given time, otherwise the frame in between is not cached
+		const FramePtr& frame = it->second.second;
+		if (seconds >= frame->mPTSSecs + frame->mDurationSecs)
+			return nullptr;
+
+		// Mark as most recently used
+		GOP& entry = mGOPs[it->second.first];
+		mUsage.splice(mUsage.begin(), mUsage, entry.mUsage);
+		return frame;
+	}
+
+
+	bool VideoFrameCache::contains(int gop) const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mGOPs.find(gop) != mGOPs.end();
+	}
+
+
+	void VideoFrameCache::clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mGOPs.clear();
+		mUsage.clear();
+		mFrames.clear();
+		mSize = 0;
+	}
+
+
+	uint64_t VideoFrameCache::getSize() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mSize;
+	}
+
+
+	void VideoFrameCache::erase(int gop)
+	{
+		auto found_it = mGOPs.find(gop);
+		if (found_it == mGOPs.end())
+			return;
+
+		GOP& entry = found_it->second;
+		for (const auto& frame : entry.mFrames)
+		{
+			auto frame_it = mFrames.find(frame->mPTSSecs);
+			if (frame_it != mFrames.end() && frame_it->second.first == gop)
+				mFrames.erase(frame_it);
+		}
+
+		mSize -= entry.mSize;
+		mUsage.erase(entry.mUsage);
+		mGOPs.erase(found_it);
+	}
+}
@@ -0,0 +1,104 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace nap
+{
+	/**
+	 * A decoded video frame stored in the nap::VideoFrameCache.
+	 * Contains the Y, U and V plane of the frame, tightly packed, one after the other.
+	 */
+	struct NAPAPI CachedVideoFrame
+	{
+		double					mPTSSecs = 0.0;			///< Presentation time in seconds, relative to the start of the stream
+		double					mDurationSecs = 0.0;	///< Time in seconds the frame is displayed
+		std::vector<uint8_t>	mData;					///< Y, U and V plane
+	};
+
+
+	/**
+	 * Least recently used cache of decoded video frames.
+	 * Frames are stored and evicted per group of pictures (GOP): all frames decoded from a single keyframe up to the next keyframe.
+	 * A GOP is either fully cached or not at all, which is required because decoding a single frame requires decoding all frames before it in the GOP.
+	 * Looking up a frame marks its GOP as most recently used, inserting a GOP evicts the least recently used GOPs until the cache fits its capacity.
+	 * All functions are thread safe.
+	 */
+	class NAPAPI VideoFrameCache final
+	{
+	public:
+		using FramePtr = std::shared_ptr<const CachedVideoFrame>;
+
+		/**
+		 * @param capacity max size in bytes of all cached frames
+		 */
+		VideoFrameCache(uint64_t capacity);
+
+		/**
+		 * Inserts all frames of a GOP, replaces the GOP if it is already cached.
+		 * A GOP that is larger than the capacity of the cache is still inserted, evicting everything else.
+		 * @param gop index of the keyframe the frames are decoded from
+		 * @param frames all frames of the GOP
+		 */
+		void insert(int gop, std::vector<FramePtr>&& frames);
+
+		/**
+		 * Returns the frame that is displayed at the given time, nullptr if that frame is not cached.
+		 * @param seconds presentation time in seconds
+		 * @return the frame that is displayed at the given time, nullptr if not cached
+		 */
+		FramePtr find(double seconds);
+
+		/**
+		 * @param gop index of the keyframe the frames are decoded from
+		 * @return if all frames of the GOP are cached
+		 */
+		bool contains(int gop) const;
+
+		/**
+		 * Removes all frames from the cache
+		 */
+		void clear();
+
+		/**
+		 * @return size in bytes of all cached frames
+		 */
+		uint64_t getSize() const;
+
+		/**
+		 * @return max size in bytes of all cached frames
+		 */
+		uint64_t getCapacity() const								{ return mCapacity; }
+
+	private:
+		/**
+		 * All frames of a single GOP
+		 */
+		struct GOP
+		{
+			std::vector<FramePtr>		mFrames;					///< Frames sorted by presentation time
+			uint64_t					mSize = 0;					///< Size in bytes of all frames
+			std::list<int>::iterator	mUsage;						///< Position in the usage list
+		};
+
+		void erase(int gop);
+
+		uint64_t					mCapacity = 0;					///< Max size in bytes of all cached frames
+		uint64_t					mSize = 0;						///< Size in bytes of all cached frames
+		std::unordered_map<int, GOP> mGOPs;							///< All cached GOPs
+		std::list<int>				mUsage;							///< Cached GOPs, most recently used first
+		std::map<double, std::pair<int, FramePtr>> mFrames;			///< All cached frames and their GOP, by presentation time
+		mutable std::mutex			mMutex;							///< Guards the cache
+	};
+}
@@ -0,0 +1,161 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videokeyframeindex.h"
+
+// External Includes
+#include <utility/fileutils.h>
+#include <algorithm>
+#include <fstream>
+
+extern "C"
+{
+	#include <libavformat/avformat.h>
+}
+
+namespace nap
+{
+	// Identifies a keyframe cache file, the version is increased when the layout changes
+	static const char	sCacheMagic[8]	= { 'N', 'A', 'P', 'K', 'F', 'I', 'D', 'X' };
+	static const uint32_t sCacheVersion	= 1;
+
+
+	VideoKeyframeIndex::VideoKeyframeIndex(std::vector<Keyframe>&& keyframes) :
+		mKeyframes(std::move(keyframes))
+	{
+		sort();
+	}
+
+
+	bool VideoKeyframeIndex::init(const std::string& videoPath, AVFormatContext& formatContext, int stream, bool useCache, utility::ErrorState& errorState)
+	{
+		if (useCache && loadCache(videoPath, stream))
+			return true;
+
+		if (!build(formatContext, stream, errorState))
+			return false;
+
+		if (useCache)
+			saveCache(videoPath, stream);
+		return true;
+	}
+
+
+	int VideoKeyframeIndex::find(int64_t pts) const
+	{
+		auto it = std::upper_bound(mKeyframes.begin(), mKeyframes.end(), pts, [](int64_t value, const Keyframe& keyframe)
+		{
+			return value < keyframe.mPTS;
+		});
+		return it == mKeyframes.begin() ? 0 : static_cast<int>(it - mKeyframes.begin()) - 1;
+	}
+
+
+	std::string VideoKeyframeIndex::getCachePath(const std::string& videoPath)
+	{
+		return utility::appendFileExtension(videoPath, "keyframes");
+	}
+
+
+	bool VideoKeyframeIndex::build(AVFormatContext& formatContext, int stream, utility::ErrorState& errorState)
+	{
+		mKeyframes.clear();
+
+		// Only demux, nothing is decoded
+		AVPacket* packet = av_packet_alloc();
+		int result = 0;
+		while ((result = av_read_frame(&formatContext, packet)) >= 0)
+		{
+			if (packet->stream_index == stream && (packet->flags & AV_PKT_FLAG_KEY) != 0 && (packet->pts != AV_NOPTS_VALUE || packet->dts != AV_NOPTS_VALUE))
+			{
+				Keyframe keyframe;
+				keyframe.mPTS = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+				keyframe.mDTS = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+				mKeyframes.emplace_back(keyframe);
+			}
+			av_packet_unref(packet);
+		}
+		av_packet_free(&packet);
+
+		if (!errorState.check(result == AVERROR_EOF, "Failed to read packets while building keyframe index"))
+		{
+			mKeyframes.clear();
+			return false;
+		}
+
+		// Keyframes are normally stored in presentation order, sort to be certain the index can be searched
+		sort();
+
+		// Rewind
+		if (!mKeyframes.empty())
+			av_seek_frame(&formatContext, stream, mKeyframes.front().mDTS, AVSEEK_FLAG_BACKWARD);
+		return true;
+	}
+
+
+	void VideoKeyframeIndex::sort()
+	{
+		std::stable_sort(mKeyframes.begin(), mKeyframes.end(), [](const Keyframe& a, const Keyframe& b)
+		{
+			return a.mPTS < b.mPTS;
+		});
+	}
+
+
+	bool VideoKeyframeIndex::loadCache(const std::string& videoPath, int stream)
+	{
+		// The cache is only valid for the current version of the video file
+		uint64_t mod_time = 0;
+		if (!utility::getFileModificationTime(videoPath, mod_time))
+			return false;
+
+		std::ifstream file(getCachePath(videoPath), std::ios::binary);
+		if (!file.is_open())
+			return false;
+
+		char magic[sizeof(sCacheMagic)];
+		uint32_t version = 0;
+		uint64_t cached_mod_time = 0;
+		int32_t cached_stream = -1;
+		uint32_t count = 0;
+		file.read(magic, sizeof(magic));
+		file.read(reinterpret_cast<char*>(&version), sizeof(version));
+		file.read(reinterpret_cast<char*>(&cached_mod_time), sizeof(cached_mod_time));
+		file.read(reinterpret_cast<char*>(&cached_stream), sizeof(cached_stream));
+		file.read(reinterpret_cast<char*>(&count), sizeof(count));
+		if (!file || !std::equal(magic, magic + sizeof(magic), sCacheMagic) || version != sCacheVersion || cached_mod_time != mod_time || cached_stream != stream)
+			return false;
+
+		std::vector<Keyframe> keyframes(count);
+		file.read(reinterpret_cast<char*>(keyframes.data()), count * sizeof(Keyframe));
+		if (!file)
+			return false;
+
+		mKeyframes = std::move(keyframes);
+		return true;
+	}
+
+
+	bool VideoKeyframeIndex::saveCache(const std::string& videoPath, int stream) const
+	{
+		uint64_t mod_time = 0;
+		if (!utility::getFileModificationTime(videoPath, mod_time))
+			return false;
+
+		std::ofstream file(getCachePath(videoPath), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		int32_t cached_stream = stream;
+		uint32_t count = static_cast<uint32_t>(mKeyframes.size());
+		file.write(sCacheMagic, sizeof(sCacheMagic));
+		file.write(reinterpret_cast<const char*>(&sCacheVersion), sizeof(sCacheVersion));
+		file.write(reinterpret_cast<const char*>(&mod_time), sizeof(mod_time));
+		file.write(reinterpret_cast<const char*>(&cached_stream), sizeof(cached_stream));
+		file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		file.write(reinterpret_cast<const char*>(mKeyframes.data()), count * sizeof(Keyframe));
+		return static_cast<bool>(file);
+	}
+}
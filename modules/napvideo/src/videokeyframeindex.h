@@ -0,0 +1,110 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <utility/dllexport.h>
+#include <utility/errorstate.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct AVFormatContext;
+
+namespace nap
+{
+	/**
+	 * Location of every keyframe in the video stream of a file.
+	 * Allows seeking directly to the keyframe that precedes a timestamp, instead of searching backwards through the stream.
+	 * Building the index requires reading all packets of the file, which is why the index can be cached to disk next to the video.
+	 * The cache is rebuilt when the video file is modified.
+	 */
+	class NAPAPI VideoKeyframeIndex final
+	{
+	public:
+		/**
+		 * A single keyframe, timestamps are in stream time base units.
+		 */
+		struct Keyframe
+		{
+			int64_t mPTS = 0;				///< Presentation timestamp
+			int64_t mDTS = 0;				///< Decode timestamp, use this to seek
+		};
+
+		VideoKeyframeIndex() = default;
+
+		/**
+		 * Creates an index from keyframes that are already known.
+		 * @param keyframes all keyframes of the stream, sorted by presentation time on construction
+		 */
+		VideoKeyframeIndex(std::vector<Keyframe>&& keyframes);
+
+		/**
+		 * Builds the index by reading all packets of the stream.
+		 * When 'useCache' is set the index is loaded from the cache file of the video instead, if it exists and is up to date,
+		 * and a newly built index is written to the cache file. Failing to write the cache file is not an error.
+		 * Note that the read position of the format context is undefined after building, seek before reading packets.
+		 * @param videoPath path to the video file, the cache file is stored next to it
+		 * @param formatContext opened format context of the video
+		 * @param stream index of the video stream
+		 * @param useCache if the index is loaded from and saved to the cache file next to the video
+		 * @param errorState contains the error if the index can't be built
+		 * @return if the index has been loaded or built
+		 */
+		bool init(const std::string& videoPath, AVFormatContext& formatContext, int stream, bool useCache, utility::ErrorState& errorState);
+
+		/**
+		 * Loads the index from the cache file of the video.
+		 * Fails when the cache file doesn't exist, is corrupt, or when the video file or stream has changed since the cache was written.
+		 * The index is left untouched when loading fails.
+		 * @param videoPath path to the video file
+		 * @param stream index of the video stream
+		 * @return if the index has been loaded
+		 */
+		bool loadCache(const std::string& videoPath, int stream);
+
+		/**
+		 * Writes the index to the cache file of the video.
+		 * @param videoPath path to the video file
+		 * @param stream index of the video stream
+		 * @return if the cache file has been written
+		 */
+		bool saveCache(const std::string& videoPath, int stream) const;
+
+		/**
+		 * @return if there are no keyframes in the index
+		 */
+		bool isEmpty() const										{ return mKeyframes.empty(); }
+
+		/**
+		 * @return number of keyframes
+		 */
+		int getCount() const										{ return static_cast<int>(mKeyframes.size()); }
+
+		/**
+		 * @param index keyframe index
+		 * @return the keyframe at the given index
+		 */
+		const Keyframe& getKeyframe(int index) const				{ return mKeyframes[index]; }
+
+		/**
+		 * @param pts presentation timestamp in stream time base units
+		 * @return index of the last keyframe with a presentation timestamp lower or equal to pts, 0 when pts lies before the first keyframe.
+		 */
+		int find(int64_t pts) const;
+
+		/**
+		 * @param videoPath path to the video file
+		 * @return path of the file the index of the video is cached in
+		 */
+		static std::string getCachePath(const std::string& videoPath);
+
+	private:
+		bool build(AVFormatContext& formatContext, int stream, utility::ErrorState& errorState);
+		void sort();
+
+		std::vector<Keyframe> mKeyframes;							///< All keyframes, sorted by presentation time
+	};
+}
@@ -11,15 +11,23 @@
 // External Includes
 #include <mathutils.h>
 #include <nap/assert.h>
+#include <nap/core.h>
+#include <renderservice.h>
 #include <libavformat/avformat.h>
 
 // nap::videoplayer run time class definition 
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::VideoPlayer)
 	RTTI_CONSTRUCTOR(nap::VideoService&)
-	RTTI_PROPERTY("Loop",		&nap::VideoPlayer::mLoop,			nap::rtti::EPropertyMetaData::Default)
-	RTTI_PROPERTY("VideoFiles",	&nap::VideoPlayer::mVideoFiles,		nap::rtti::EPropertyMetaData::Embedded)
-	RTTI_PROPERTY("VideoIndex",	&nap::VideoPlayer::mVideoIndex,		nap::rtti::EPropertyMetaData::Default)
-	RTTI_PROPERTY("Speed",		&nap::VideoPlayer::mSpeed,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Loop",				&nap::VideoPlayer::mLoop,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("VideoFiles",		&nap::VideoPlayer::mVideoFiles,			nap::rtti::EPropertyMetaData::Embedded)
+	RTTI_PROPERTY("VideoIndex",		&nap::VideoPlayer::mVideoIndex,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Speed",			&nap::VideoPlayer::mSpeed,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Priority",			&nap::VideoPlayer::mPriority,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("FrameQueueSize",	&nap::VideoPlayer::mFrameQueueSize,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PacketQueueSize",	&nap::VideoPlayer::mPacketQueueSize,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Clock",			&nap::VideoPlayer::mClock,				nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("CacheSize",		&nap::VideoPlayer::mCacheSize,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("PingPong",			&nap::VideoPlayer::mPingPong,			nap::rtti::EPropertyMetaData::Default)
 RTTI_END_CLASS
 
 //////////////////////////////////////////////////////////////////////////
@@ -61,9 +69,12 @@ namespace nap
 		if (mVideos[new_idx].get() == mCurrentVideo)
 			return true;
 
-		// Stop playback of current video if available
+		// Stop playback of current video if available, it no longer decodes into our staging buffers
 		if (mCurrentVideo != nullptr)
+		{
 			mCurrentVideo->stop(true);
+			mCurrentVideo->setFrameSlotPool(nullptr);
+		}
 
 		// Update selection
 		mCurrentVideo = mVideos[new_idx].get();
@@ -76,6 +87,9 @@ namespace nap
 		// Copy properties for playback
 		mCurrentVideo->mLoop  = mLoop;
 		mCurrentVideo->mSpeed = mSpeed;
+		mCurrentVideo->mPriority = mPriority;
+		mCurrentVideo->mFrameQueueSize = mFrameQueueSize;
+		mCurrentVideo->mPacketQueueSize = mPacketQueueSize;
 
 		// Check if textures need to be generated, this is the case when there are none,
 		// or when the dimensions have 
@@ -113,9 +127,34 @@ namespace nap
 			if (!mVTexture->init(tex_description, false, Texture2D::EClearMode::FillWithZero, 0, error))
 				return false;
 
+			// Create staging buffers the decode thread copies frames into.
+			// Slots are in use by frames waiting to be displayed and by uploads the GPU hasn't finished yet.
+			RenderService& render_service = *mService.getCore().getService<RenderService>();
+			mStagingPool = std::make_shared<VideoStagingPool>(render_service, render_service.getMaxFramesInFlight() + 4);
+			if (!mStagingPool->init(vid_x, vid_y, error))
+				return false;
+
 			mTexturesCreated = true;
 		}
 
+		// Decode directly into the staging buffers
+		mCurrentVideo->setFrameSlotPool(mStagingPool);
+
+		// Create the decoder that fills the frame cache of this video
+		mScrubber.reset();
+		mCachedFrame = nullptr;
+		mCachedMode = false;
+		mCachedPlaying = false;
+		if (mCacheSize > 0)
+		{
+			mScrubber = std::make_unique<VideoScrubber>(getFile().mPath, static_cast<uint64_t>(mCacheSize) * 1024 * 1024, &mService.getDecodeScheduler(), mCurrentVideo->mPriority);
+			if (!mScrubber->init(mService.getCodecThreadCount(), mService.getIndexKeyframes(), error))
+			{
+				mScrubber.reset();
+				return false;
+			}
+		}
+
 		// Notify listeners
 		VideoChanged(*this);
 		return true;
@@ -149,12 +188,26 @@ namespace nap
 		if (!errorState.check(mVideoFiles.size() > 0, "Playlist is empty"))
 			return false;
 
+		// Ensure queue sizes are valid
+		if (!errorState.check(mFrameQueueSize > 0 && mPacketQueueSize > 0, "%s: Queue sizes must be greater than 0", mID.c_str()))
+			return false;
+
+		// Ping-pong playback is presented from the cache
+		if (!errorState.check(mCacheSize >= 0, "%s: Invalid cache size: %d", mID.c_str(), mCacheSize))
+			return false;
+
+		if (!errorState.check(!mPingPong || mCacheSize > 0, "%s: PingPong requires a CacheSize", mID.c_str()))
+			return false;
+
 		// Create all the unique video objects
 		mVideos.clear();
 		for (const auto& file : mVideoFiles)
 		{
 			// Create video and initialize
 			std::unique_ptr<nap::Video> new_video = std::make_unique<nap::Video>(file->mPath);
+			new_video->mCodecThreadCount = mService.getCodecThreadCount();
+			new_video->mIndexKeyframes = mService.getIndexKeyframes();
+			new_video->setDecodeScheduler(&mService.getDecodeScheduler());
 			if (!new_video->init(errorState))
 			{
 				errorState.fail("%s: Unable to load video for file: %s", mID.c_str(), file->mPath.c_str());
@@ -175,12 +228,81 @@ namespace nap
 
 	void VideoPlayer::play(double mStartTime)
 	{
+		// The video can't play in reverse, ping-pong playback is presented from the cache
+		if (mPingPong && mScrubber != nullptr)
+		{
+			startCached(mStartTime, true, 1);
+			return;
+		}
+
 		// Clear textures and start playback
+		mCachedMode = false;
+		mCachedPlaying = false;
 		clearTextures();
 		getVideo().play(mStartTime);
 	}
 
 
+	void VideoPlayer::playReverse(double startTime)
+	{
+		NAP_ASSERT_MSG(mScrubber != nullptr, "Reverse playback requires a 'CacheSize'");
+		startCached(startTime, true, -1);
+	}
+
+
+	void VideoPlayer::scrub(double seconds)
+	{
+		NAP_ASSERT_MSG(mScrubber != nullptr, "Scrubbing requires a 'CacheSize'");
+		startCached(seconds, false, mCachedDirection);
+	}
+
+
+	void VideoPlayer::stopPlayback()
+	{
+		getVideo().stop(true);
+		mCachedPlaying = false;
+	}
+
+
+	bool VideoPlayer::isPlaying() const
+	{
+		return mCachedMode ? mCachedPlaying : getVideo().isPlaying();
+	}
+
+
+	void VideoPlayer::seek(double seconds)
+	{
+		if (mCachedMode)
+		{
+			double end_time = math::max<double>(mScrubber->getDuration() - mScrubber->getFrameDuration(), 0.0);
+			mCachedTime = math::clamp<double>(seconds, 0.0, end_time);
+			return;
+		}
+		getVideo().seek(seconds);
+	}
+
+
+	double VideoPlayer::getCurrentTime() const
+	{
+		return mCachedMode ? mCachedTime : getVideo().getCurrentTime();
+	}
+
+
+	void VideoPlayer::startCached(double startTime, bool playing, int direction)
+	{
+		// The decode threads of the video are not used when presenting from the cache
+		assert(mScrubber != nullptr);
+		getVideo().stop(true);
+
+		// The last frame starts one frame before the end of the video
+		double end_time = math::max<double>(mScrubber->getDuration() - mScrubber->getFrameDuration(), 0.0);
+		mCachedTime = math::clamp<double>(startTime, 0.0, end_time);
+		mCachedMode = true;
+		mCachedPlaying = playing;
+		mCachedDirection = direction;
+	}
+
+
 	void VideoPlayer::loop(bool value)
 	{
 		mLoop = value;
@@ -201,6 +323,9 @@ namespace nap
 		mService.removeVideoPlayer(*this);
 
 		// Clear all videos
+		mScrubber.reset();
+		mCachedFrame = nullptr;
+		mCachedMode = false;
 		mVideos.clear();
 		mCurrentVideo = nullptr;
 		mCurrentVideoIndex = 0;
@@ -230,13 +355,51 @@ namespace nap
 
 	void VideoPlayer::update(double deltaTime)
 	{
-		// Bail if there's no selection or playback is disabled
-		if (mCurrentVideo == nullptr || !mCurrentVideo->isPlaying())
+		// Bail if there's no selection
+		if (mCurrentVideo == nullptr)
+			return;
+
+		// Present frames from the cache when scrubbing or playing in reverse
+		if (mCachedMode)
+		{
+			updateCached(deltaTime);
+			return;
+		}
+
+		// Bail if playback is disabled
+		if (!mCurrentVideo->isPlaying())
 			return;
 
 		// Get frame and update contents
-		Frame new_frame = mCurrentVideo->update(deltaTime);
-		if (new_frame.isValid())
+		Frame new_frame = mClock != nullptr ?
+			mCurrentVideo->updateSynchronized(mClock->getTime()) :
+			mCurrentVideo->update(deltaTime);
+		if (new_frame.mSlot != -1 && new_frame.mSlotPool == mStagingPool)
+		{
+			// Upload directly from the staging buffer the frame was decoded into.
+			// The slot is released when the GPU has finished the uploads of all planes, the pool can be gone by then if the selection changed.
+			// The callbacks are called on the main thread, either when the upload completed or when it was replaced by a newer frame.
+			assert(mYTexture != nullptr);
+			VkBuffer buffer = mStagingPool->getBuffer(new_frame.mSlot);
+			std::weak_ptr<VideoStagingPool> pool = mStagingPool;
+			int slot = new_frame.mSlot;
+			auto pending_planes = std::make_shared<int>(3);
+			auto plane_finished = [pool, slot, pending_planes]()
+			{
+				if (--(*pending_planes) > 0)
+					return;
+				std::shared_ptr<VideoStagingPool> locked_pool = pool.lock();
+				if (locked_pool != nullptr)
+					locked_pool->release(slot);
+			};
+			mYTexture->update(buffer, mStagingPool->getPlaneOffset(0), plane_finished);
+			mUTexture->update(buffer, mStagingPool->getPlaneOffset(1), plane_finished);
+			mVTexture->update(buffer, mStagingPool->getPlaneOffset(2), plane_finished);
+
+			// Ownership of the slot is passed to the textures
+			new_frame.mSlot = -1;
+		}
+		else if (new_frame.mFrame != nullptr)
 		{
 			// Copy data into texture
 			assert(mYTexture != nullptr);
@@ -248,4 +411,51 @@ namespace nap
 		// Destroy frame that was allocated in the decode thread, after it has been processed
 		new_frame.free();
 	}
-}
\ No newline at end of file
+
+
+	void VideoPlayer::updateCached(double deltaTime)
+	{
+		// Advance the playhead, the last frame starts one frame before the end of the video
+		double end_time = math::max<double>(mScrubber->getDuration() - mScrubber->getFrameDuration(), 0.0);
+		if (mCachedPlaying)
+		{
+			mCachedTime += deltaTime * mSpeed * mCachedDirection;
+			if (mCachedTime < 0.0 || mCachedTime > end_time)
+			{
+				if (!mLoop)
+				{
+					// Stop at the end
+					mCachedPlaying = false;
+				}
+				else if (mPingPong)
+				{
+					// Bounce back and reverse direction
+					mCachedTime = mCachedTime < 0.0 ? -mCachedTime : 2.0 * end_time - mCachedTime;
+					mCachedDirection = -mCachedDirection;
+				}
+				else
+				{
+					// Wrap around
+					mCachedTime = mCachedTime < 0.0 ? mCachedTime + end_time : mCachedTime - end_time;
+				}
+				mCachedTime = math::clamp<double>(mCachedTime, 0.0, end_time);
+			}
+		}
+
+		// Decode the GOP at the playhead and the GOP ahead of it, display the frame at the playhead when it is available
+		mScrubber->request(mCachedTime, mCachedPlaying ? mCachedDirection : 0);
+		VideoFrameCache::FramePtr frame = mScrubber->getFrame(mCachedTime);
+		if (frame == nullptr || frame == mCachedFrame)
+			return;
+
+		// The Y, U and V plane are tightly packed
+		assert(mYTexture != nullptr);
+		const uint8_t* y_data = frame->mData.data();
+		const uint8_t* u_data = y_data + mYTexture->getWidth() * mYTexture->getHeight();
+		const uint8_t* v_data = u_data + mUTexture->getWidth() * mUTexture->getHeight();
+		mYTexture->update(y_data, mYTexture->getWidth(), mYTexture->getHeight(), mYTexture->getWidth(), ESurfaceChannels::R);
+		mUTexture->update(u_data, mUTexture->getWidth(), mUTexture->getHeight(), mUTexture->getWidth(), ESurfaceChannels::R);
+		mVTexture->update(v_data, mVTexture->getWidth(), mVTexture->getHeight(), mVTexture->getWidth(), ESurfaceChannels::R);
+		mCachedFrame = frame;
+	}
+}
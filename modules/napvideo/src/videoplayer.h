@@ -7,6 +7,9 @@
 // Local Includes
 #include "videofile.h"
 #include "video.h"
+#include "videostagingpool.h"
+#include "videoclock.h"
+#include "videoscrubber.h"
 
 // External Includes
 #include <nap/device.h>
@@ -38,6 +41,16 @@ namespace nap
 	 * instead of a set of textures per video. A valid set of textures is always available after a successful call to selectVideo()
 	 * Listen to the VideoChanged signal to get notified about a video change.
 	 *
+	 * Link multiple video players to the same nap::VideoClock to keep them frame-locked.
+	 * The number of videos that decode at the same time is limited by the nap::VideoService, 
+	 * videos with a higher 'Priority' are decoded first when all decode workers are busy.
+	 *
+	 * Set a 'CacheSize' to enable scrubbing, reverse and ping-pong playback: frames are then decoded a group of pictures (GOP) at a time
+	 * into a cache of decoded frames, using the keyframe index of the video to jump directly to the right keyframe.
+	 * Use scrub() to display the frame at any time and playReverse() to play the video backwards. 
+	 * When 'PingPong' and 'Loop' are enabled the video reverses direction at both ends, instead of restarting.
+	 * The cache should be large enough to hold at least two GOPs of decoded frames.
+	 *
 	 * Every video must contain a video stream, the audio stream is optional. 
 	 * Use a nap::VideoAudioComponent to decode and play back the audio of a video.
 	 * Without a nap::VideoAudioComponent no audio is decoded and therefore played back.
@@ -117,16 +130,36 @@ namespace nap
 		 */
 		void play(double startTime = 0.0);
 
+		/**
+		 * Starts reverse playback of the current video at the given offset in seconds.
+		 * Frames are presented from the cache, requires a 'CacheSize' greater than 0.
+		 * @param startTime The offset in seconds to start the video at.
+		 */
+		void playReverse(double startTime);
+
+		/**
+		 * Stops playback and displays the frame at the given time as soon as it is decoded.
+		 * Frames are presented from the cache, requires a 'CacheSize' greater than 0.
+		 * Call this every frame while scrubbing, nearby frames are served from the cache.
+		 * @param seconds the time offset in seconds in the video.
+		 */
+		void scrub(double seconds);
+
 		/**
 		 * Stops playback of the current video.
 		 */
-		void stopPlayback()											{ getVideo().stop(true); }
+		void stopPlayback();
 
 		/**
 		 * Check if the currently loaded video is playing.
 		 * @return If the video is currently playing.
 		 */
-		bool isPlaying() const										{ return getVideo().isPlaying(); }
+		bool isPlaying() const;
+
+		/**
+		 * @return if frames of the current video can be presented from the cache, required for scrubbing and reverse playback
+		 */
+		bool hasCache() const										{ return mScrubber != nullptr; }
 
 		/**
 		 * If the video re-starts after completion.
@@ -154,12 +187,12 @@ namespace nap
 		 * Seeks within the video to the time provided. This can be called while playing.
 		 * @param seconds: the time offset in seconds in the video.
 		 */
-		void seek(double seconds)									{ getVideo().seek(seconds); }
+		void seek(double seconds);
 
 		/**
 		 * @return The current playback position in seconds.
 		 */
-		double getCurrentTime() const								{ return getVideo().getCurrentTime(); }
+		double getCurrentTime() const;
 
 		/**
 		 * @return The duration of the video in seconds.
@@ -226,6 +259,12 @@ namespace nap
 		nap::uint mVideoIndex = 0;								///< Property: 'Index' Selected video index
 		bool mLoop = false;										///< Property: 'Loop' if the selected video loops
 		float mSpeed = 1.0f;									///< Property: 'Speed' video playback speed
+		int mPriority = 0;										///< Property: 'Priority' decode priority, a higher priority is decoded first when all decode workers are busy
+		int mFrameQueueSize = 16;								///< Property: 'FrameQueueSize' max number of decoded frames queued ahead of presentation
+		int mPacketQueueSize = 16 * 1024 * 1024;				///< Property: 'PacketQueueSize' max size in bytes of all packets queued ahead of decoding
+		nap::ResourcePtr<VideoClock> mClock = nullptr;			///< Property: 'Clock' optional master clock, videos that share a clock are frame-locked
+		int mCacheSize = 0;										///< Property: 'CacheSize' size in MB of the decoded frame cache used for scrubbing and reverse playback, 0 = disabled
+		bool mPingPong = false;									///< Property: 'PingPong' if a looping video reverses direction at both ends, requires a 'CacheSize'
 		
 		/**
 		 * Emitted after a successful video switch.
@@ -238,6 +277,16 @@ namespace nap
 		 */
 		void update(double deltaTime);
 
+		/**
+		 * Advances the playhead and presents frames from the cache
+		 */
+		void updateCached(double deltaTime);
+
+		/**
+		 * Starts presenting frames from the cache, stops the video decode threads
+		 */
+		void startCached(double startTime, bool playing, int direction);
+
 		/**
 		 * Clear output textures to black
 		 */
@@ -250,6 +299,13 @@ namespace nap
 		std::unique_ptr<Texture2D> mYTexture;					///< Video YTexture
 		std::unique_ptr<Texture2D> mUTexture;					///< Video UTexture
 		std::unique_ptr<Texture2D> mVTexture;					///< Video VTexture	
+		std::shared_ptr<VideoStagingPool> mStagingPool;			///< Staging buffers the decode thread copies frames into, uploaded from by the textures
+		std::unique_ptr<VideoScrubber> mScrubber;				///< Decodes the current video into the frame cache, nullptr when the cache is disabled
+		VideoFrameCache::FramePtr mCachedFrame = nullptr;		///< Frame from the cache that is displayed
+		bool mCachedMode = false;								///< If frames are presented from the cache instead of the video
+		bool mCachedPlaying = false;							///< If the playhead advances in cached mode
+		int mCachedDirection = 1;								///< Direction of playback in cached mode, -1 = reverse
+		double mCachedTime = 0.0;								///< Playhead in seconds in cached mode
 		VideoService&	mService;								///< Video service that this object is registered with
 	};
 
@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videorecorder.h"
+
+// External Includes
+#include <nap/assert.h>
+
+RTTI_BEGIN_ENUM(nap::EVideoEncoderCodec)
+	RTTI_ENUM_VALUE(nap::EVideoEncoderCodec::H264,		"H264"),
+	RTTI_ENUM_VALUE(nap::EVideoEncoderCodec::ProRes,	"ProRes"),
+	RTTI_ENUM_VALUE(nap::EVideoEncoderCodec::FFV1,		"FFV1")
+RTTI_END_ENUM
+
+// nap::videorecorder run time class definition
+RTTI_BEGIN_CLASS(nap::VideoRecorder)
+	RTTI_PROPERTY("Texture",		&nap::VideoRecorder::mTexture,			nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Path",			&nap::VideoRecorder::mPath,				nap::rtti::EPropertyMetaData::Required)
+	RTTI_PROPERTY("Codec",			&nap::VideoRecorder::mCodec,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("FrameRate",		&nap::VideoRecorder::mFrameRate,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("BitRate",		&nap::VideoRecorder::mBitRate,			nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("BufferCount",	&nap::VideoRecorder::mBufferCount,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("DropFrames",		&nap::VideoRecorder::mDropFrames,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("Deterministic",	&nap::VideoRecorder::mDeterministic,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
+//////////////////////////////////////////////////////////////////////////
+
+
+namespace nap
+{
+	VideoRecorder::~VideoRecorder()
+	{
+		stopRecording();
+	}
+
+
+	bool VideoRecorder::start(utility::ErrorState& errorState)
+	{
+		if (!errorState.check(mTexture->mUsage == ETextureUsage::DynamicRead, "%s: texture usage must be 'DynamicRead'", mID.c_str()))
+			return false;
+
+		if (!errorState.check(mTexture->mFormat == RenderTexture2D::EFormat::RGBA8, "%s: texture format must be 'RGBA8'", mID.c_str()))
+			return false;
+
+		if (!errorState.check(mFrameRate > 0 && mBufferCount > 0, "%s: 'FrameRate' and 'BufferCount' must be greater than 0", mID.c_str()))
+			return false;
+
+		return true;
+	}
+
+
+	void VideoRecorder::stop()
+	{
+		stopRecording();
+	}
+
+
+	bool VideoRecorder::startRecording(utility::ErrorState& errorState)
+	{
+		stopRecording();
+
+		auto encoder = std::make_shared<VideoEncoder>(mTexture->getWidth(), mTexture->getHeight(), mBufferCount, mDropFrames);
+		if (!encoder->init(mPath, mCodec, mFrameRate, mBitRate, mDeterministic, errorState))
+		{
+			errorState.fail("%s: unable to start recording to '%s'", mID.c_str(), mPath.c_str());
+			return false;
+		}
+
+		mEncoder = std::move(encoder);
+		mLastStats = VideoEncoderStats();
+		mFrameIndex = 0;
+		return true;
+	}
+
+
+	void VideoRecorder::stopRecording()
+	{
+		if (mEncoder == nullptr)
+			return;
+
+		// Downloads in flight only hold a weak reference, the encoder finishes here
+		mEncoder->finish();
+		mLastStats = mEncoder->getStats();
+		mEncoder.reset();
+	}
+
+
+	bool VideoRecorder::captureFrame()
+	{
+		if (mEncoder == nullptr)
+			return false;
+
+		// The frame index is assigned now, a frame that is dropped later leaves a gap instead of shifting the frames after it
+		std::weak_ptr<VideoEncoder> encoder = mEncoder;
+		int64 frame_index = mFrameIndex++;
+		mTexture->asyncGetData([encoder, frame_index](const void* data, size_t sizeInBytes)
+		{
+			std::shared_ptr<VideoEncoder> locked_encoder = encoder.lock();
+			if (locked_encoder != nullptr)
+				locked_encoder->submit(data, sizeInBytes, frame_index);
+		});
+		return true;
+	}
+
+
+	VideoEncoderStats VideoRecorder::getStats() const
+	{
+		return mEncoder != nullptr ? mEncoder->getStats() : mLastStats;
+	}
+}
@@ -0,0 +1,99 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "videoencoder.h"
+
+// External Includes
+#include <nap/device.h>
+#include <nap/resourceptr.h>
+#include <rendertexture2d.h>
+
+namespace nap
+{
+	/**
+	 * Records the contents of a render texture to a video file.
+	 *
+	 * Call captureFrame() once every frame, after the texture has been rendered to and before the frame ends.
+	 * The texture is downloaded from the GPU asynchronously, using the staging buffer of the frame in flight,
+	 * and handed to a nap::VideoEncoder that converts and encodes the frame on a background thread.
+	 * The render loop never waits for the encoder: downloaded frames are copied into a pool of 'BufferCount' frame buffers.
+	 * When all buffers are in use, because the encoder can't keep up, the frame is dropped when 'DropFrames' is enabled,
+	 * otherwise the queue grows. Use getStats() to inspect the number of submitted, encoded, dropped and queued frames.
+	 *
+	 * Every captured frame is one frame in the video, at the given 'FrameRate', regardless of the actual frame rate of the application.
+	 * Enable 'Deterministic' to encode single threaded with bit exact output: rendering the same frames,
+	 * for example headless using a software rasterizer, results in the same video file.
+	 *
+	 * The texture 'Usage' must be 'DynamicRead' and the 'Format' RGBA8.
+	 * The container format is derived from the extension of the 'Path': for example .mp4 for H264, .mov for ProRes and .mkv for FFV1.
+	 */
+	class NAPAPI VideoRecorder : public Device
+	{
+		RTTI_ENABLE(Device)
+	public:
+		/**
+		 * Stops recording
+		 */
+		virtual ~VideoRecorder();
+
+		/**
+		 * Validates the texture, does not start recording.
+		 * @param errorState contains the error if the texture can't be recorded
+		 * @return if the recorder started
+		 */
+		virtual bool start(utility::ErrorState& errorState) override;
+
+		/**
+		 * Stops recording, waits until all queued frames are encoded.
+		 */
+		virtual void stop() override;
+
+		/**
+		 * Creates the video file and starts accepting frames.
+		 * @param errorState contains the error if the file or the encoder can't be opened
+		 * @return if recording started
+		 */
+		bool startRecording(utility::ErrorState& errorState);
+
+		/**
+		 * Stops accepting frames, waits until all queued frames are encoded and closes the file.
+		 * Frames that are still being downloaded from the GPU are discarded.
+		 */
+		void stopRecording();
+
+		/**
+		 * @return if the recorder accepts frames
+		 */
+		bool isRecording() const									{ return mEncoder != nullptr; }
+
+		/**
+		 * Starts the download of the texture, the frame is queued for encoding when the download completes.
+		 * Call this at most once per frame, after the texture has been rendered to, while the frame is being rendered.
+		 * @return if a download was started, false if not recording
+		 */
+		bool captureFrame();
+
+		/**
+		 * @return frame statistics of the current or last recording
+		 */
+		VideoEncoderStats getStats() const;
+
+		ResourcePtr<RenderTexture2D>	mTexture;									///< Property: 'Texture' the texture to record, usage must be 'DynamicRead'
+		std::string						mPath;										///< Property: 'Path' the video file to create
+		EVideoEncoderCodec				mCodec = EVideoEncoderCodec::H264;			///< Property: 'Codec' the codec to encode with
+		int								mFrameRate = 60;							///< Property: 'FrameRate' number of frames per second of the video
+		int								mBitRate = 0;								///< Property: 'BitRate' target bit rate in kbit/s for lossy codecs, 0 = decided by the encoder
+		int								mBufferCount = 8;							///< Property: 'BufferCount' number of frames that can wait to be encoded
+		bool							mDropFrames = true;							///< Property: 'DropFrames' if frames are dropped when all buffers are in use, otherwise the queue grows
+		bool							mDeterministic = false;						///< Property: 'Deterministic' if the same frames result in the same file, encodes single threaded
+
+	private:
+		std::shared_ptr<VideoEncoder>	mEncoder = nullptr;							///< Encoder of the current recording, downloads in flight hold a weak reference
+		VideoEncoderStats				mLastStats;									///< Statistics of the last recording
+		int64							mFrameIndex = 0;							///< Index of the next captured frame
+	};
+}
@@ -0,0 +1,282 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videoscrubber.h"
+
+// External Includes
+#include <nap/logger.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+}
+
+namespace nap
+{
+	VideoScrubber::VideoScrubber(const std::string& path, uint64_t cacheCapacity, VideoDecodeScheduler* scheduler, int priority) :
+		mPath(path),
+		mCache(cacheCapacity),
+		mDecodeScheduler(scheduler),
+		mDecodePriority(priority)
+	{ }
+
+
+	VideoScrubber::~VideoScrubber()
+	{
+		if (mDecodeThread.joinable())
+		{
+			{
+				std::lock_guard<std::mutex> lock(mRequestMutex);
+				mExitDecodeThreadSignalled = true;
+			}
+			mRequestCondition.notify_one();
+			if (mDecodeScheduler != nullptr)
+				mDecodeScheduler->notifyCancelled();
+			mDecodeThread.join();
+		}
+
+		avcodec_free_context(&mCodecContext);
+		avformat_close_input(&mFormatContext);
+	}
+
+
+	bool VideoScrubber::init(int codecThreadCount, bool cacheKeyframes, utility::ErrorState& errorState)
+	{
+		// Open file
+		int error = avformat_open_input(&mFormatContext, mPath.c_str(), nullptr, nullptr);
+		if (!errorState.check(error >= 0, "Error opening file '%s'", mPath.c_str()))
+			return false;
+
+		error = avformat_find_stream_info(mFormatContext, nullptr);
+		if (!errorState.check(error >= 0, "Error finding stream info: %s", mPath.c_str()))
+			return false;
+
+		// Select the same video stream as nap::Video, the last one in the file
+		AVStream* video_stream = nullptr;
+		for (int i = 0; i < mFormatContext->nb_streams; ++i)
+		{
+			if (mFormatContext->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+				video_stream = mFormatContext->streams[i];
+		}
+		if (!errorState.check(video_stream != nullptr, "No video stream found"))
+			return false;
+		mStream = video_stream->index;
+
+		// Create decoder
+		AVCodec* codec = avcodec_find_decoder(video_stream->codecpar->codec_id);
+		if (!errorState.check(codec != nullptr, "Unable to find codec for video stream"))
+			return false;
+
+		mCodecContext = avcodec_alloc_context3(codec);
+		if (!errorState.check(avcodec_parameters_to_context(mCodecContext, video_stream->codecpar) >= 0, "Failed to copy codec parameters to decoder context"))
+			return false;
+
+		AVDictionary* options = nullptr;
+		av_dict_set(&options, "threads", codecThreadCount > 0 ? std::to_string(codecThreadCount).c_str() : "auto", 0);
+		error = avcodec_open2(mCodecContext, codec, &options);
+		av_dict_free(&options);
+		if (!errorState.check(error == 0, "Unable to open codec"))
+			return false;
+
+		if (!errorState.check(mCodecContext->pix_fmt == AV_PIX_FMT_YUV420P || mCodecContext->pix_fmt == AV_PIX_FMT_YUVJ420P, "Scrubbing requires a YUV420 video"))
+			return false;
+
+		// Timing information, all timing is relative to the stream start
+		mWidth = mCodecContext->width;
+		mHeight = mCodecContext->height;
+		mTimeBase = av_q2d(video_stream->time_base);
+		mStreamStartTime = video_stream->start_time != AV_NOPTS_VALUE ? video_stream->start_time * mTimeBase : 0.0;
+		AVRational frame_rate = av_guess_frame_rate(mFormatContext, video_stream, nullptr);
+		mFrameDuration = frame_rate.num && frame_rate.den ? av_q2d(AVRational{ frame_rate.den, frame_rate.num }) : 1.0 / 30.0;
+		mDuration = static_cast<double>(mFormatContext->duration) / AV_TIME_BASE;
+
+		// Loading the index is cheap when it has been cached by nap::Video
+		if (!mKeyframeIndex.init(mPath, *mFormatContext, mStream, cacheKeyframes, errorState))
+			return false;
+
+		if (!errorState.check(!mKeyframeIndex.isEmpty(), "No keyframes found in '%s'", mPath.c_str()))
+			return false;
+
+		mDecodeThread = std::thread(std::bind(&VideoScrubber::decodeThread, this));
+		return true;
+	}
+
+
+	void VideoScrubber::request(double seconds, int direction)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mRequestMutex);
+			mRequestSecs = seconds;
+			mRequestDirection = direction;
+			mRequestCount++;
+		}
+		mRequestCondition.notify_one();
+	}
+
+
+	void VideoScrubber::decodeThread()
+	{
+		uint64_t handled_count = 0;
+		while (true)
+		{
+			double request_secs = 0.0;
+			int request_direction = 0;
+			{
+				std::unique_lock<std::mutex> lock(mRequestMutex);
+				mRequestCondition.wait(lock, [&]() { return mExitDecodeThreadSignalled || mRequestCount != handled_count; });
+				if (mExitDecodeThreadSignalled)
+					return;
+
+				handled_count = mRequestCount;
+				request_secs = mRequestSecs;
+				request_direction = mRequestDirection;
+			}
+
+			// Decode the GOP that is displayed first, followed by the GOP ahead in the direction of playback
+			int gop = findGOP(request_secs);
+			int targets[] = { gop, gop + (request_direction < 0 ? -1 : 1) };
+			for (int target : targets)
+			{
+				if (target < 0 || target >= mKeyframeIndex.getCount() || mCache.contains(target))
+					continue;
+
+				// Calls into the codec are made while holding a worker of the decode scheduler
+				{
+					VideoDecodeScheduler::Worker worker(mDecodeScheduler, mDecodePriority, mExitDecodeThreadSignalled);
+					if (!worker.isAcquired())
+						return;
+
+					if (!decodeGOP(target))
+						nap::Logger::warn("%s: Failed to decode GOP %d", mPath.c_str(), target);
+				}
+
+				// Handle a request that moved away from this GOP first
+				std::lock_guard<std::mutex> lock(mRequestMutex);
+				if (mExitDecodeThreadSignalled || findGOP(mRequestSecs) != gop)
+					break;
+			}
+		}
+	}
+
+
+	bool VideoScrubber::decodeGOP(int gop)
+	{
+		const VideoKeyframeIndex::Keyframe& keyframe = mKeyframeIndex.getKeyframe(gop);
+		bool last = gop + 1 >= mKeyframeIndex.getCount();
+		int64_t end_pts = last ? std::numeric_limits<int64_t>::max() : mKeyframeIndex.getKeyframe(gop + 1).mPTS;
+		int64_t end_dts = last ? std::numeric_limits<int64_t>::max() : mKeyframeIndex.getKeyframe(gop + 1).mDTS;
+
+		// Start decoding from the keyframe with an empty decoder
+		avcodec_flush_buffers(mCodecContext);
+		if (av_seek_frame(mFormatContext, mStream, keyframe.mDTS, AVSEEK_FLAG_BACKWARD) < 0)
+			return false;
+
+		std::vector<std::shared_ptr<CachedVideoFrame>> frames;
+		AVPacket* packet = av_packet_alloc();
+		AVFrame* frame = av_frame_alloc();
+		bool started = false;
+		while (av_read_frame(mFormatContext, packet) >= 0)
+		{
+			if (packet->stream_index != mStream)
+			{
+				av_packet_unref(packet);
+				continue;
+			}
+
+			// Skip packets before the keyframe, the demuxer can end up at an earlier keyframe.
+			// Stop at the next keyframe, the packets after it belong to the next GOP.
+			int64_t dts = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+			bool is_keyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+			if (!started)
+			{
+				if (!is_keyframe || dts < keyframe.mDTS)
+				{
+					av_packet_unref(packet);
+					continue;
+				}
+				started = true;
+			}
+			else if (is_keyframe && dts >= end_dts)
+			{
+				av_packet_unref(packet);
+				break;
+			}
+
+			avcodec_send_packet(mCodecContext, packet);
+			av_packet_unref(packet);
+			receiveFrames(*frame, keyframe.mPTS, end_pts, frames);
+		}
+
+		// Drain the decoder
+		avcodec_send_packet(mCodecContext, nullptr);
+		receiveFrames(*frame, keyframe.mPTS, end_pts, frames);
+
+		av_frame_free(&frame);
+		av_packet_free(&packet);
+
+		if (frames.empty())
+			return false;
+
+		// Frames are received in presentation order, but sort to be sure. A frame is displayed until the next frame, the last until the next keyframe.
+		std::sort(frames.begin(), frames.end(), [](const auto& a, const auto& b) { return a->mPTSSecs < b->mPTSSecs; });
+		double end_secs = last ? frames.back()->mPTSSecs + mFrameDuration : end_pts * mTimeBase - mStreamStartTime;
+		for (int i = 0; i < frames.size(); i++)
+		{
+			double next_secs = i + 1 < frames.size() ? frames[i + 1]->mPTSSecs : end_secs;
+			frames[i]->mDurationSecs = next_secs > frames[i]->mPTSSecs ? next_secs - frames[i]->mPTSSecs : mFrameDuration;
+		}
+
+		mCache.insert(gop, std::vector<VideoFrameCache::FramePtr>(frames.begin(), frames.end()));
+		return true;
+	}
+
+
+	void VideoScrubber::receiveFrames(AVFrame& frame, int64_t startPTS, int64_t endPTS, std::vector<std::shared_ptr<CachedVideoFrame>>& frames)
+	{
+		// U and V are half the size of Y, matching the textures of the video player
+		int plane_widths[] = { mWidth, static_cast<int>(mWidth * 0.5f), static_cast<int>(mWidth * 0.5f) };
+		int plane_heights[] = { mHeight, static_cast<int>(mHeight * 0.5f), static_cast<int>(mHeight * 0.5f) };
+
+		while (avcodec_receive_frame(mCodecContext, &frame) >= 0)
+		{
+			// Frames before the keyframe are leading frames of an open GOP that reference the previous GOP, they are part of the previous GOP
+			int64_t pts = frame.best_effort_timestamp;
+			if (pts != AV_NOPTS_VALUE && pts >= startPTS && pts < endPTS)
+			{
+				auto cached_frame = std::make_shared<CachedVideoFrame>();
+				cached_frame->mPTSSecs = pts * mTimeBase - mStreamStartTime;
+				cached_frame->mData.resize(plane_widths[0] * plane_heights[0] + 2 * plane_widths[1] * plane_heights[1]);
+
+				// Copy row by row, the decoded planes are padded
+				uint8_t* target = cached_frame->mData.data();
+				for (int i = 0; i < 3; i++)
+				{
+					const uint8_t* source = frame.data[i];
+					for (int row = 0; row < plane_heights[i]; row++)
+					{
+						std::memcpy(target, source, plane_widths[i]);
+						source += frame.linesize[i];
+						target += plane_widths[i];
+					}
+				}
+				frames.emplace_back(std::move(cached_frame));
+			}
+			av_frame_unref(&frame);
+		}
+	}
+
+
+	int VideoScrubber::findGOP(double seconds) const
+	{
+		int64_t pts = static_cast<int64_t>(std::floor((seconds + mStreamStartTime) / mTimeBase));
+		return mKeyframeIndex.find(pts);
+	}
+}
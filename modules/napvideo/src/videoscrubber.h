@@ -0,0 +1,137 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "videokeyframeindex.h"
+#include "videoframecache.h"
+#include "videodecodescheduler.h"
+
+// External Includes
+#include <utility/dllexport.h>
+#include <utility/errorstate.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+
+namespace nap
+{
+	/**
+	 * Random access decoder for scrubbing and reverse playback of a video.
+	 * Decodes complete groups of pictures (GOP) into a nap::VideoFrameCache on a background thread, using the keyframe index of the video to seek directly to a keyframe.
+	 * Every GOP is decoded while holding a worker of the nap::VideoDecodeScheduler, sharing the decode budget with the videos that are playing.
+	 * Call request() every frame with the time that is displayed and the direction of playback:
+	 * the GOP at that time is decoded first, followed by the next GOP in the direction of playback.
+	 * getFrame() returns the decoded frame at a time if it is available in the cache.
+	 * The cache should be large enough to hold at least two GOPs, otherwise decoded frames are evicted before they are displayed.
+	 * The scrubber opens the video file separately from the nap::Video, the video can be started and stopped independently.
+	 * Only YUV420 video is supported, the frame data contains the Y, U and V plane in the same layout as the textures of the nap::VideoPlayer.
+	 */
+	class NAPAPI VideoScrubber final
+	{
+	public:
+		/**
+		 * @param path the video file on disk
+		 * @param cacheCapacity max size in bytes of all decoded frames in the cache
+		 * @param scheduler limits the number of videos that decode at the same time, nullptr to decode without limit
+		 * @param priority decode priority, a higher priority is served first when all workers of the scheduler are busy
+		 */
+		VideoScrubber(const std::string& path, uint64_t cacheCapacity, VideoDecodeScheduler* scheduler = nullptr, int priority = 0);
+
+		/**
+		 * Stops the decode thread and frees the codec and format context
+		 */
+		~VideoScrubber();
+
+		VideoScrubber(const VideoScrubber&) = delete;
+		VideoScrubber& operator=(const VideoScrubber&) = delete;
+
+		/**
+		 * Opens the video, loads or builds the keyframe index and starts the decode thread.
+		 * @param codecThreadCount number of threads used by the codec, 0 = decided by the codec
+		 * @param cacheKeyframes if the keyframe index is loaded from and saved to the cache file next to the video
+		 * @param errorState contains the error if the video can't be opened
+		 * @return if the scrubber initialized
+		 */
+		bool init(int codecThreadCount, bool cacheKeyframes, utility::ErrorState& errorState);
+
+		/**
+		 * Requests the frame at the given time to be decoded, followed by the GOP ahead in the direction of playback. Non blocking.
+		 * @param seconds the time that is displayed
+		 * @param direction direction of playback, -1 = reverse, 0 or 1 = forward
+		 */
+		void request(double seconds, int direction);
+
+		/**
+		 * @param seconds the time that is displayed
+		 * @return the decoded frame displayed at the given time, nullptr if not decoded yet
+		 */
+		VideoFrameCache::FramePtr getFrame(double seconds)			{ return mCache.find(seconds); }
+
+		/**
+		 * @return the cache the frames are decoded into
+		 */
+		const VideoFrameCache& getCache() const						{ return mCache; }
+
+		/**
+		 * @return duration of the video in seconds
+		 */
+		double getDuration() const									{ return mDuration; }
+
+		/**
+		 * @return duration of a single frame in seconds
+		 */
+		double getFrameDuration() const								{ return mFrameDuration; }
+
+	private:
+		/**
+		 * Decodes the GOP at the requested time and the GOP ahead, until a new request arrives
+		 */
+		void decodeThread();
+
+		/**
+		 * Decodes all frames from a keyframe up to the next keyframe and inserts them into the cache
+		 */
+		bool decodeGOP(int gop);
+
+		/**
+		 * Receives all frames that are available from the decoder and copies the frames that belong to the GOP
+		 */
+		void receiveFrames(AVFrame& frame, int64_t startPTS, int64_t endPTS, std::vector<std::shared_ptr<CachedVideoFrame>>& frames);
+
+		/**
+		 * @return index of the GOP that contains the given time
+		 */
+		int findGOP(double seconds) const;
+
+		std::string				mPath;								///< Path to the video file on disk
+		AVFormatContext*		mFormatContext = nullptr;			///< Format context, only used by the decode thread after init
+		AVCodecContext*			mCodecContext = nullptr;			///< Codec context, only used by the decode thread after init
+		int						mStream = -1;						///< Index of the video stream
+		int						mWidth = 0;							///< Width of the video in pixels
+		int						mHeight = 0;						///< Height of the video in pixels
+		double					mTimeBase = 0.0;					///< Time base of the video stream in seconds
+		double					mStreamStartTime = 0.0;				///< Start time of the video stream in seconds
+		double					mFrameDuration = 0.0;				///< Duration of a single frame in seconds
+		double					mDuration = 0.0;					///< Duration of the video in seconds
+
+		VideoKeyframeIndex		mKeyframeIndex;						///< Keyframes of the video stream
+		VideoFrameCache			mCache;								///< Decoded frames
+		VideoDecodeScheduler*	mDecodeScheduler = nullptr;			///< Limits the number of videos that decode at the same time
+		int						mDecodePriority = 0;				///< Decode priority of the GOPs
+
+		std::thread				mDecodeThread;						///< Decodes requested GOPs
+		std::mutex				mRequestMutex;						///< Guards the request
+		std::condition_variable	mRequestCondition;					///< Signalled when a new request arrives or the thread should exit
+		double					mRequestSecs = 0.0;					///< Requested time in seconds
+		int						mRequestDirection = 0;				///< Requested direction of playback
+		uint64_t				mRequestCount = 0;					///< Number of requests made
+		bool					mExitDecodeThreadSignalled = false;	///< If the decode thread should exit
+	};
+}
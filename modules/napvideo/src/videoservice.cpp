@@ -10,6 +10,7 @@
 #include <renderservice.h>
 #include <nap/core.h>
 #include <mathutils.h>
+#include <thread>
 
 extern "C"
 {
@@ -17,6 +18,12 @@ extern "C"
 	#include <libavformat/avformat.h>
 }
 
+RTTI_BEGIN_CLASS(nap::VideoServiceConfiguration)
+	RTTI_PROPERTY("DecodeWorkers",	&nap::VideoServiceConfiguration::mDecodeWorkers,	nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("CodecThreads",	&nap::VideoServiceConfiguration::mCodecThreads,		nap::rtti::EPropertyMetaData::Default)
+	RTTI_PROPERTY("IndexKeyframes",	&nap::VideoServiceConfiguration::mIndexKeyframes,	nap::rtti::EPropertyMetaData::Default)
+RTTI_END_CLASS
+
 RTTI_BEGIN_CLASS_NO_DEFAULT_CONSTRUCTOR(nap::VideoService)
 	RTTI_CONSTRUCTOR(nap::ServiceConfiguration*)
 RTTI_END_CLASS
@@ -33,12 +40,39 @@ namespace nap
 	{
 		av_register_all();
 		avcodec_register_all();
+
+		// Create the scheduler shared by all videos
+		VideoServiceConfiguration* configuration = getConfiguration<VideoServiceConfiguration>();
+		int worker_count = configuration->mDecodeWorkers;
+		if (worker_count <= 0)
+			worker_count = math::max<int>(std::thread::hardware_concurrency(), 1);
+		mDecodeScheduler = std::make_unique<VideoDecodeScheduler>(worker_count);
+
+		if (!errorState.check(configuration->mCodecThreads >= 0, "Invalid number of codec threads: %d", configuration->mCodecThreads))
+			return false;
+
 		return true;
 	}
 
 
+	int VideoService::getCodecThreadCount() const
+	{
+		return getConfiguration<VideoServiceConfiguration>()->mCodecThreads;
+	}
+
+
+	bool VideoService::getIndexKeyframes() const
+	{
+		return getConfiguration<VideoServiceConfiguration>()->mIndexKeyframes;
+	}
+
+
 	void VideoService::update(double deltaTime)
 	{
+		// Advance the master clocks before the players present their frames
+		for (auto& clock : mVideoClocks)
+			clock->update(deltaTime);
+
 		nap::utility::ErrorState error;
 		for (auto& player : mVideoPlayers)
 			player->update(deltaTime);
@@ -48,6 +82,7 @@ namespace nap
 	void VideoService::registerObjectCreators(rtti::Factory& factory)
 	{
 		factory.addObjectCreator(std::make_unique<VideoPlayerObjectCreator>(*this));
+		factory.addObjectCreator(std::make_unique<VideoClockObjectCreator>(*this));
 	}
 
 
@@ -68,6 +103,20 @@ namespace nap
 	}
 
 
+	void VideoService::registerVideoClock(VideoClock& clock)
+	{
+		mVideoClocks.emplace_back(&clock);
+	}
+
+
+	void VideoService::removeVideoClock(VideoClock& clock)
+	{
+		auto found_it = std::find(mVideoClocks.begin(), mVideoClocks.end(), &clock);
+		assert(found_it != mVideoClocks.end());
+		mVideoClocks.erase(found_it);
+	}
+
+
 	void VideoService::getDependentServices(std::vector<rtti::TypeInfo>& dependencies)
 	{
 		dependencies.emplace_back(RTTI_OF(SceneService));
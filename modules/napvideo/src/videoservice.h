@@ -6,12 +6,32 @@
 
 // Local Includes
 #include "videoplayer.h"
+#include "videoclock.h"
+#include "videodecodescheduler.h"
 
 // External Includes
 #include <nap/service.h>
 
 namespace nap
 {
+	// Forward Declares
+	class VideoService;
+
+	/**
+	 * Configurable video decoding parameters.
+	 * When playing many videos at the same time, limit the number of decode workers and codec threads
+	 * to prevent the decode threads from competing for the same cores.
+	 */
+	class NAPAPI VideoServiceConfiguration : public ServiceConfiguration
+	{
+		RTTI_ENABLE(ServiceConfiguration)
+	public:
+		virtual rtti::TypeInfo getServiceType() override	{ return RTTI_OF(VideoService); }
+		int mDecodeWorkers = 0;								///< Property: 'DecodeWorkers' max number of videos that decode at the same time, 0 = number of hardware threads
+		int mCodecThreads = 0;								///< Property: 'CodecThreads' number of threads used by the codec of every video, 0 = decided by the codec
+		bool mIndexKeyframes = false;						///< Property: 'IndexKeyframes' if the keyframes of every video are indexed on load and cached next to the video file, allowing fast seeking. Off by default, the video directory has to be writable
+	};
+
 	/**
 	 * Initializes the FFMPEG library (libavformat etc.) and registers all the codecs.
 	 * This service also updates all system wide available video players
@@ -19,11 +39,27 @@ namespace nap
 	class NAPAPI VideoService : public Service
 	{
 		friend class VideoPlayer;
+		friend class VideoClock;
 		RTTI_ENABLE(Service)
 	public:
 		// Default constructor
 		VideoService(ServiceConfiguration* configuration);
 
+		/**
+		 * @return the scheduler that limits the number of videos that decode at the same time
+		 */
+		VideoDecodeScheduler& getDecodeScheduler()			{ assert(mDecodeScheduler != nullptr); return *mDecodeScheduler; }
+
+		/**
+		 * @return number of threads used by the codec of every video, 0 = decided by the codec
+		 */
+		int getCodecThreadCount() const;
+
+		/**
+		 * @return if the keyframes of every video are indexed on load
+		 */
+		bool getIndexKeyframes() const;
+
 	protected:
 		// This service depends on render and scene
 		virtual void getDependentServices(std::vector<rtti::TypeInfo>& dependencies) override;
@@ -56,8 +92,20 @@ namespace nap
 		*/
 		void removeVideoPlayer(VideoPlayer& receiver);
 
+		/**
+		 * Registers a video clock with the service
+		 */
+		void registerVideoClock(VideoClock& clock);
+
+		/**
+		 * Removes a video clock from the service
+		 */
+		void removeVideoClock(VideoClock& clock);
+
 	private:
 		std::vector<VideoPlayer*> mVideoPlayers;				///< All registered video players
+		std::vector<VideoClock*> mVideoClocks;					///< All registered video clocks
+		std::unique_ptr<VideoDecodeScheduler> mDecodeScheduler;	///< Limits the number of videos that decode at the same time
 		bool mVideoMaterialInitialized = false;					///< If the video material is properly initialized
 	};
 }
\ No newline at end of file
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Local Includes
+#include "videostagingpool.h"
+
+// External Includes
+#include <renderservice.h>
+#include <cstring>
+
+extern "C"
+{
+	#include <libavutil/frame.h>
+}
+
+namespace nap
+{
+	// Plane offsets are aligned, which satisfies the buffer offset requirements of a buffer to image copy
+	static constexpr VkDeviceSize sPlaneAlignment = 16;
+
+	static VkDeviceSize alignOffset(VkDeviceSize offset)
+	{
+		return (offset + sPlaneAlignment - 1) & ~(sPlaneAlignment - 1);
+	}
+
+
+	VideoStagingPool::VideoStagingPool(RenderService& renderService, int slotCount) :
+		FrameSlotPool(slotCount),
+		mRenderService(&renderService)
+	{ }
+
+
+	VideoStagingPool::~VideoStagingPool()
+	{
+		// The GPU may still be reading from the buffers, destruction is deferred until it is guaranteed they're no longer in use
+		mRenderService->queueVulkanObjectDestructor([buffers = mBuffers](RenderService& renderService)
+		{
+			for (const BufferData& buffer : buffers)
+				destroyBuffer(renderService.getVulkanAllocator(), buffer);
+		});
+	}
+
+
+	bool VideoStagingPool::init(int width, int height, utility::ErrorState& errorState)
+	{
+		// U and V are half the size of Y, matching the dimensions of the textures of the video player
+		mPlanes[0].mWidth  = width;
+		mPlanes[0].mHeight = height;
+		mPlanes[1].mWidth  = mPlanes[2].mWidth  = static_cast<int>(width * 0.5f);
+		mPlanes[1].mHeight = mPlanes[2].mHeight = static_cast<int>(height * 0.5f);
+
+		VkDeviceSize size = 0;
+		for (Plane& plane : mPlanes)
+		{
+			plane.mOffset = alignOffset(size);
+			size = plane.mOffset + plane.mWidth * plane.mHeight;
+		}
+
+		// Create a persistently mapped staging buffer for every slot
+		mBuffers.resize(getSlotCount());
+		for (BufferData& buffer : mBuffers)
+		{
+			if (!createBuffer(mRenderService->getVulkanAllocator(), static_cast<uint32>(size), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT, buffer, errorState))
+			{
+				errorState.fail("Unable to create video staging buffer");
+				return false;
+			}
+		}
+		return true;
+	}
+
+
+	void VideoStagingPool::copyFrame(const AVFrame& frame, int slot)
+	{
+		assert(slot >= 0 && slot < mBuffers.size());
+		uint8_t* buffer = static_cast<uint8_t*>(mBuffers[slot].mAllocationInfo.pMappedData);
+		assert(buffer != nullptr);
+
+		// Copy row by row, the decoded planes are padded
+		for (int i = 0; i < 3; i++)
+		{
+			const Plane& plane = mPlanes[i];
+			const uint8_t* source = frame.data[i];
+			uint8_t* target = buffer + plane.mOffset;
+			for (int row = 0; row < plane.mHeight; row++)
+			{
+				std::memcpy(target, source, plane.mWidth);
+				source += frame.linesize[i];
+				target += plane.mWidth;
+			}
+		}
+	}
+
+
+	VkBuffer VideoStagingPool::getBuffer(int slot) const
+	{
+		assert(slot >= 0 && slot < mBuffers.size());
+		return mBuffers[slot].mBuffer;
+	}
+}
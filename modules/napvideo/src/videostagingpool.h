@@ -0,0 +1,82 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "video.h"
+
+// External Includes
+#include <renderutils.h>
+#include <utility/errorstate.h>
+
+namespace nap
+{
+	// Forward Declares
+	class RenderService;
+
+	/**
+	 * Set of persistently mapped GPU staging buffers that the decode thread of a video copies YUV420 frames into.
+	 * Every slot is a single buffer that holds the Y, U and V plane of a frame, tightly packed, one after the other.
+	 * The textures of the video player upload directly from these buffers, removing the copy of the frame data on the main thread.
+	 * A slot is released by the video player when the GPU has finished uploading the frame from it.
+	 */
+	class NAPAPI VideoStagingPool final : public FrameSlotPool
+	{
+	public:
+		/**
+		 * @param renderService the render service used to create and destroy the buffers
+		 * @param slotCount total number of staging buffers
+		 */
+		VideoStagingPool(RenderService& renderService, int slotCount);
+
+		/**
+		 * Queues the staging buffers for destruction
+		 */
+		~VideoStagingPool() override;
+
+		/**
+		 * Creates the staging buffers for frames of the given size.
+		 * @param width width of the Y plane in pixels
+		 * @param height height of the Y plane in pixels
+		 * @param errorState contains the error if the buffers can't be created
+		 * @return if the buffers have been created
+		 */
+		bool init(int width, int height, utility::ErrorState& errorState);
+
+		/**
+		 * Copies the Y, U and V plane of a decoded frame into the staging buffer of a slot.
+		 * @param frame the decoded YUV420 frame
+		 * @param slot the slot to copy the frame into
+		 */
+		virtual void copyFrame(const AVFrame& frame, int slot) override;
+
+		/**
+		 * @param slot the slot index
+		 * @return the staging buffer of a slot
+		 */
+		VkBuffer getBuffer(int slot) const;
+
+		/**
+		 * @param plane the plane index: 0 = Y, 1 = U, 2 = V
+		 * @return offset in bytes of the plane within the staging buffer of a slot
+		 */
+		VkDeviceSize getPlaneOffset(int plane) const		{ return mPlanes[plane].mOffset; }
+
+	private:
+		/**
+		 * Location and size of a single plane in a staging buffer
+		 */
+		struct Plane
+		{
+			VkDeviceSize	mOffset = 0;		///< Offset in bytes in the staging buffer
+			int				mWidth = 0;			///< Width in pixels
+			int				mHeight = 0;		///< Height in pixels
+		};
+
+		RenderService*				mRenderService = nullptr;	///< Render service that owns the allocator
+		std::vector<BufferData>		mBuffers;					///< Staging buffer for every slot
+		Plane						mPlanes[3];					///< Y, U and V plane layout
+	};
+}
@@ -0,0 +1,66 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <utility/fileutils.h>
+#undef HAVE_LONG_LONG
+#undef HAVE_CONFIG_H
+#include <tclap/CmdLine.h>
+
+/**
+ * Class to parse the commandline and store the parsed output
+ */
+class CommandLine
+{
+public:
+	/**
+	 * Parse the commandline and output a CommandLine object
+	 *
+	 * @param argc Number of arguments on the commandline
+	 * @param argv Array of arguments on the commandline
+	 * @param commandLine The resulting commandline
+	 *
+	 * @return Whether parsing succeeded or not
+	 */
+	static bool parse(int argc, char** argv, CommandLine& commandLine)
+	{
+		using namespace TCLAP;
+		try
+		{
+			std::vector<std::string>		mode_names				= { "binary", "json", "bake" };
+			ValuesConstraint<std::string>	mode_constraint			(mode_names);
+
+			CmdLine							command					("SequenceConverter");
+			ValueArg<std::string>			output_directory		("o", "outdir", "Output directory to write the converted sequences to (absolute or relative path)", true, "", "path_to_output_directory");
+			ValueArg<std::string>			mode					("m", "mode", "Conversion: binary (.bseq), json (.json) or bake (.bake, fixed rate samples of all curve tracks)", false, "binary", &mode_constraint);
+			ValueArg<float>					rate					("r", "rate", "Number of samples per second when baking", false, 60.0f, "samples_per_second");
+			UnlabeledMultiArg<std::string>	files					("files", "List of sequences to convert, json or binary", true, "list_of_sequences");
+
+			command.add(output_directory);
+			command.add(mode);
+			command.add(rate);
+			command.add(files);
+
+			command.parse(argc, argv);
+
+			commandLine.mOutputDirectory = nap::utility::getAbsolutePath(output_directory.getValue());
+			commandLine.mMode = mode.getValue();
+			commandLine.mRate = rate.getValue();
+			commandLine.mFilesToConvert = files.getValue();
+		}
+		catch (ArgException& e)
+		{
+			std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	std::string					mOutputDirectory;
+	std::string					mMode;
+	float						mRate = 60.0f;
+	std::vector<std::string>	mFilesToConvert;
+};
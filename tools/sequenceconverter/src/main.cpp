@@ -0,0 +1,128 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <utility/errorstate.h>
+#include <utility/fileutils.h>
+#include <nap/logger.h>
+#include <rtti/jsonreader.h>
+#include <rtti/jsonwriter.h>
+#include <rtti/defaultlinkresolver.h>
+#include <sequence.h>
+#include <sequencebinary.h>
+#include <fstream>
+
+#include "commandline.h"
+
+using namespace nap;
+
+/**
+ * Loads a json or binary sequence from disk, the returned sequence is owned by outObjects
+ */
+static Sequence* loadSequence(const std::string& path, rtti::OwnedObjectList& outObjects, utility::ErrorState& errorState)
+{
+	Sequence* sequence = nullptr;
+	if (sequencebinary::isBinary(path))
+	{
+		sequence = sequencebinary::load(path, outObjects, errorState);
+		if (sequence == nullptr)
+			return nullptr;
+	}
+	else
+	{
+		rtti::Factory factory;
+		rtti::DeserializeResult result;
+		if (!rtti::deserializeJSONFile(path, rtti::EPropertyValidationMode::DisallowMissingProperties, rtti::EPointerPropertyMode::NoRawPointers, factory, result, errorState))
+			return nullptr;
+
+		if (!rtti::DefaultLinkResolver::sResolveLinks(result.mReadObjects, result.mUnresolvedPointers, errorState))
+			return nullptr;
+
+		for (auto& object : result.mReadObjects)
+		{
+			if (object->get_type().is_derived_from<Sequence>())
+				sequence = static_cast<Sequence*>(object.get());
+			outObjects.emplace_back(std::move(object));
+		}
+
+		if (!errorState.check(sequence != nullptr, "%s doesn't contain a sequence", path.c_str()))
+			return nullptr;
+	}
+
+	// validate
+	for (auto& object : outObjects)
+	{
+		if (!object->init(errorState))
+			return nullptr;
+	}
+	return sequence;
+}
+
+
+/**
+ * Writes a sequence to disk as json
+ */
+static bool saveJSON(const Sequence& sequence, const std::string& path, utility::ErrorState& errorState)
+{
+	rtti::JSONWriter writer;
+	if (!rtti::serializeObjects(rtti::ObjectList{ const_cast<Sequence*>(&sequence) }, writer, errorState))
+		return false;
+
+	std::ofstream output(path, std::ios::binary | std::ios::out | std::ios::trunc);
+	if (!errorState.check(output.is_open() && output.good(), "Failed to open %s for writing", path.c_str()))
+		return false;
+
+	std::string json = writer.GetJSON();
+	output.write(json.data(), json.size());
+	return errorState.check(output.good(), "Failed to write %s", path.c_str());
+}
+
+
+int main(int argc, char* argv[])
+{
+	// Parse commandline
+	CommandLine commandLine;
+	if (!CommandLine::parse(argc, argv, commandLine))
+		return -1;
+	Logger::setLevel(Logger::debugLevel());
+
+	if (!utility::dirExists(commandLine.mOutputDirectory) && !utility::makeDirs(commandLine.mOutputDirectory))
+	{
+		Logger::fatal("Unable to create output directory %s", commandLine.mOutputDirectory.c_str());
+		return -1;
+	}
+
+	std::string extension = "json";
+	if (commandLine.mMode == "binary")		extension = sequencebinary::extension;
+	else if (commandLine.mMode == "bake")	extension = sequencebinary::bakedExtension;
+
+	for (const std::string& file : commandLine.mFilesToConvert)
+	{
+		std::string output = utility::joinPath({ commandLine.mOutputDirectory, utility::getFileNameWithoutExtension(file) + "." + extension });
+		Logger::info("Converting %s to %s", file.c_str(), output.c_str());
+
+		utility::ErrorState error_state;
+		rtti::OwnedObjectList objects;
+		Sequence* sequence = loadSequence(file, objects, error_state);
+		if (sequence == nullptr)
+		{
+			Logger::fatal("\tFailed to load: %s", error_state.toString().c_str());
+			return -1;
+		}
+
+		bool saved = false;
+		if (commandLine.mMode == "binary")
+			saved = sequencebinary::save(*sequence, output, error_state);
+		else if (commandLine.mMode == "bake")
+			saved = sequencebinary::bake(*sequence, commandLine.mRate, output, error_state);
+		else
+			saved = saveJSON(*sequence, output, error_state);
+
+		if (!saved)
+		{
+			Logger::fatal("\tFailed to write: %s", error_state.toString().c_str());
+			return -1;
+		}
+	}
+	return 0;
+}
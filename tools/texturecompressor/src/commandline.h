@@ -0,0 +1,70 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <utility/fileutils.h>
+#undef HAVE_LONG_LONG
+#undef HAVE_CONFIG_H
+#include <tclap/CmdLine.h>
+
+/**
+ * Class to parse the commandline and store the parsed output
+ */
+class CommandLine
+{
+public:
+	/**
+	 * Parse the commandline and output a CommandLine object
+	 *
+	 * @param argc Number of arguments on the commandline
+	 * @param argv Array of arguments on the commandline
+	 * @param commandLine The resulting commandline
+	 *
+	 * @return Whether parsing succeeded or not
+	 */
+	static bool parse(int argc, char** argv, CommandLine& commandLine)
+	{
+		using namespace TCLAP;
+		try
+		{
+			std::vector<std::string>		format_names			= { "bc1", "bc3", "bc4", "bc5", "bc7" };
+			ValuesConstraint<std::string>	format_constraint		(format_names);
+
+			CmdLine							command					("TextureCompressor");
+			ValueArg<std::string>			output_directory		("o", "outdir", "Output directory to write the .ktx2 files to (absolute or relative path)", true, "", "path_to_output_directory");
+			ValueArg<std::string>			format					("f", "format", "Block format: bc1 (RGB), bc3 (RGBA), bc4 (R), bc5 (RG) or bc7 (high quality RGBA)", false, "bc7", &format_constraint);
+			SwitchArg						srgb					("s", "srgb", "Mark the texels as sRGB, the GPU converts them to linear when sampled");
+			SwitchArg						no_mips					("n", "nomips", "Only store the full resolution, don't generate mip levels");
+			UnlabeledMultiArg<std::string>	files					("files", "List of images to compress", true, "list_of_images");
+
+			command.add(output_directory);
+			command.add(format);
+			command.add(srgb);
+			command.add(no_mips);
+			command.add(files);
+
+			command.parse(argc, argv);
+
+			commandLine.mOutputDirectory = nap::utility::getAbsolutePath(output_directory.getValue());
+			commandLine.mFormat = format.getValue();
+			commandLine.mSRGB = srgb.getValue();
+			commandLine.mGenerateMips = !no_mips.getValue();
+			commandLine.mFilesToConvert = files.getValue();
+		}
+		catch (ArgException& e)
+		{
+			std::cerr << "error: " << e.error() << " for arg " << e.argId() << std::endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	std::string					mOutputDirectory;
+	std::string					mFormat;
+	bool						mSRGB = false;
+	bool						mGenerateMips = true;
+	std::vector<std::string>	mFilesToConvert;
+};
@@ -0,0 +1,178 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <utility/errorstate.h>
+#include <utility/fileutils.h>
+#include <nap/logger.h>
+#include <bitmap.h>
+#include <blockcompression.h>
+#include <compressedtexture.h>
+#include <pixelconversion.h>
+#include <algorithm>
+#include <thread>
+
+#include "commandline.h"
+
+using namespace nap;
+
+/**
+ * Loads an 8 bit image from disk as RGBA pixels
+ */
+static bool loadRGBA(const std::string& path, std::vector<uint8>& outPixels, int& outWidth, int& outHeight, utility::ErrorState& errorState)
+{
+	Bitmap bitmap;
+	if (!bitmap.initFromFile(path, errorState))
+		return false;
+
+	if (!errorState.check(bitmap.mSurfaceDescriptor.getDataType() == ESurfaceDataType::BYTE, "only 8 bit images can be compressed"))
+		return false;
+
+	outWidth = bitmap.getWidth();
+	outHeight = bitmap.getHeight();
+	size_t count = static_cast<size_t>(outWidth) * static_cast<size_t>(outHeight);
+	outPixels.resize(count * 4);
+
+	const uint8* source = static_cast<const uint8*>(bitmap.getData());
+	switch (bitmap.mSurfaceDescriptor.getChannels())
+	{
+	case ESurfaceChannels::R:
+		for (size_t i = 0; i < count; i++)
+		{
+			uint8* pixel = &outPixels[i * 4];
+			pixel[0] = pixel[1] = pixel[2] = source[i];
+			pixel[3] = 255;
+		}
+		break;
+	case ESurfaceChannels::BGRA:
+		pixel::swapRB(source, outPixels.data(), count);
+		break;
+	case ESurfaceChannels::RGBA:
+		std::copy(source, source + count * 4, outPixels.begin());
+		break;
+	}
+	return true;
+}
+
+
+/**
+ * Halves the size of an image using a box filter, the last row and column are repeated for odd sizes
+ */
+static void downsample(const std::vector<uint8>& source, int width, int height, std::vector<uint8>& target, int& outWidth, int& outHeight)
+{
+	outWidth = std::max(1, width / 2);
+	outHeight = std::max(1, height / 2);
+	target.resize(static_cast<size_t>(outWidth) * outHeight * 4);
+	for (int y = 0; y < outHeight; y++)
+	{
+		int y0 = std::min(y * 2, height - 1);
+		int y1 = std::min(y * 2 + 1, height - 1);
+		for (int x = 0; x < outWidth; x++)
+		{
+			int x0 = std::min(x * 2, width - 1);
+			int x1 = std::min(x * 2 + 1, width - 1);
+			for (int c = 0; c < 4; c++)
+			{
+				int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c] +
+					source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+				target[(y * outWidth + x) * 4 + c] = static_cast<uint8>((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+
+/**
+ * Compresses an image on all available cores, every thread encodes a band of block rows
+ */
+static void compressLevel(const std::vector<uint8>& pixels, int width, int height, EBlockFormat format, std::vector<uint8>& outBlocks)
+{
+	outBlocks.resize(bc::getCompressedSize(format, width, height));
+	int block_rows = (height + 3) / 4;
+	int thread_count = std::max(1, std::min(block_rows, static_cast<int>(std::thread::hardware_concurrency())));
+	int rows_per_thread = (block_rows + thread_count - 1) / thread_count;
+	size_t row_size = bc::getCompressedSize(format, width, 1);
+
+	std::vector<std::thread> threads;
+	for (int first = 0; first < block_rows; first += rows_per_thread)
+	{
+		int y = first * 4;
+		int rows = std::min(rows_per_thread * 4, height - y);
+		threads.emplace_back([&pixels, &outBlocks, width, format, y, rows, first, row_size]()
+		{
+			bc::compress(pixels.data() + static_cast<size_t>(y) * width * 4, width, rows, width * 4, format, outBlocks.data() + first * row_size);
+		});
+	}
+	for (auto& thread : threads)
+		thread.join();
+}
+
+
+/**
+ * Compresses images into .ktx2 files with BC1, BC3, BC4, BC5 or BC7 blocks, including a full mip chain.
+ * The files can be loaded using a nap::CompressedImageFromFile.
+ * Example: texturecompressor -f bc7 -s -o c:\outdir c:\mydir\albedo.png c:\mydir\mask.jpg
+ */
+int main(int argc, char* argv[])
+{
+	// Parse commandline
+	CommandLine commandLine;
+	if (!CommandLine::parse(argc, argv, commandLine))
+		return -1;
+	Logger::setLevel(Logger::debugLevel());
+
+	EBlockFormat format = EBlockFormat::BC7;
+	if (commandLine.mFormat == "bc1")		format = EBlockFormat::BC1;
+	else if (commandLine.mFormat == "bc3")	format = EBlockFormat::BC3;
+	else if (commandLine.mFormat == "bc4")	format = EBlockFormat::BC4;
+	else if (commandLine.mFormat == "bc5")	format = EBlockFormat::BC5;
+
+	if (!utility::dirExists(commandLine.mOutputDirectory) && !utility::makeDirs(commandLine.mOutputDirectory))
+	{
+		Logger::fatal("Unable to create output directory %s", commandLine.mOutputDirectory.c_str());
+		return -1;
+	}
+
+	for (const std::string& file : commandLine.mFilesToConvert)
+	{
+		std::string output = utility::joinPath({ commandLine.mOutputDirectory, utility::getFileNameWithoutExtension(file) + ".ktx2" });
+		Logger::info("Compressing %s to %s", file.c_str(), output.c_str());
+
+		std::vector<uint8> pixels;
+		int width = 0, height = 0;
+		utility::ErrorState error_state;
+		if (!loadRGBA(file, pixels, width, height, error_state))
+		{
+			Logger::fatal("\tFailed to load: %s", error_state.toString().c_str());
+			return -1;
+		}
+
+		CompressedTextureData data;
+		data.mFormat = format;
+		data.mColorSpace = commandLine.mSRGB ? EColorSpace::sRGB : EColorSpace::Linear;
+		data.mWidth = static_cast<uint32>(width);
+		data.mHeight = static_cast<uint32>(height);
+
+		// Compress every level, the next level is filtered from the uncompressed pixels of the previous one
+		std::vector<uint8> blocks, next;
+		while (true)
+		{
+			compressLevel(pixels, width, height, format, blocks);
+			data.addLevel(blocks.data());
+			if (!commandLine.mGenerateMips || (width == 1 && height == 1))
+				break;
+
+			downsample(pixels, width, height, next, width, height);
+			pixels.swap(next);
+		}
+
+		if (!saveKTX2(output, data, error_state))
+		{
+			Logger::fatal("\tFailed to save: %s", error_state.toString().c_str());
+			return -1;
+		}
+		Logger::info("\t-> %d levels, %d bytes", static_cast<int>(data.mLevels.size()), static_cast<int>(data.mData.size()));
+	}
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+#include "utils/catch.hpp"
+
+#include <audio/utility/convolver.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+
+using namespace nap::audio;
+
+namespace
+{
+	SampleBuffer createNoise(int size, float amplitude, unsigned int seed)
+	{
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> distribution(-amplitude, amplitude);
+		SampleBuffer buffer(size);
+		for (auto& sample : buffer)
+			sample = distribution(generator);
+		return buffer;
+	}
+
+	// Maximum absolute difference between the output and the direct convolution of the input with the impulse response
+	float getConvolutionError(const SampleBuffer& input, const SampleBuffer& impulseResponse, const SampleBuffer& output)
+	{
+		double error = 0;
+		for (auto i = 0; i < int(output.size()); i += 5)
+		{
+			double sum = 0;
+			for (auto j = 0; j < int(impulseResponse.size()) && j <= i; ++j)
+				sum += double(impulseResponse[j]) * input[i - j];
+			error = std::max(error, std::abs(sum - output[i]));
+		}
+		return float(error);
+	}
+}
+
+TEST_CASE("FFT", "[convolution]")
+{
+	FFT fft(1024);
+	auto input = createNoise(1024, 1.f, 1);
+	std::vector<FFT::Complex> spectrum(fft.getBinCount());
+	SampleBuffer output(1024);
+
+	fft.forward(input.data(), spectrum.data());
+
+	// DC bin equals the sum of the samples
+	double sum = 0;
+	for (auto sample : input)
+		sum += sample;
+	REQUIRE(std::abs(spectrum[0].real() - sum) < 1e-3);
+
+	fft.inverse(spectrum.data(), output.data());
+	for (auto i = 0; i < 1024; ++i)
+		REQUIRE(std::abs(output[i] - input[i]) < 1e-5f);
+}
+
+TEST_CASE("Convolver", "[convolution]")
+{
+	auto impulseResponse = createNoise(20000, 0.05f, 2);
+
+	SECTION("Synchronous")
+	{
+		// A block size that is not a power of two, with a partition size cap that produces three stages
+		const int blockSize = 96;
+		Convolver convolver(impulseResponse, blockSize, false, 2048);
+		REQUIRE(convolver.getStageCount() == 3);
+
+		auto input = createNoise(blockSize * 500, 1.f, 3);
+		SampleBuffer output(input.size(), 0.f);
+		for (auto i = 0; i < int(input.size()); i += blockSize)
+			REQUIRE(!convolver.process(&input[i], &output[i]));
+		REQUIRE(getConvolutionError(input, impulseResponse, output) < 1e-4f);
+	}
+
+	SECTION("Background")
+	{
+		// Calculating the background stages right after they have been posted gives the same result
+		const int blockSize = 64;
+		Convolver convolver(impulseResponse, blockSize, true, 2048);
+
+		auto input = createNoise(blockSize * 600, 1.f, 4);
+		SampleBuffer output(input.size(), 0.f);
+		for (auto i = 0; i < int(input.size()); i += blockSize)
+			if (convolver.process(&input[i], &output[i]))
+				REQUIRE(convolver.processBackground());
+		REQUIRE(getConvolutionError(input, impulseResponse, output) < 1e-4f);
+		REQUIRE(convolver.getLateBlockCount() == 0);
+		REQUIRE(convolver.getDroppedPartitionCount() == 0);
+	}
+
+	SECTION("Late background stages")
+	{
+		// Without calculating the background stages the tail is left out and counted as late
+		const int blockSize = 64;
+		Convolver convolver(impulseResponse, blockSize, true, 2048);
+		SampleBuffer input(blockSize, 0.f);
+		SampleBuffer output(blockSize, 0.f);
+		for (auto i = 0; i < 200; ++i)
+			convolver.process(input.data(), output.data());
+		REQUIRE(convolver.getLateBlockCount() > 0);
+		REQUIRE(convolver.getDroppedPartitionCount() > 0);
+	}
+
+	SECTION("Dropped partitions")
+	{
+		// Input that arrives while the background thread is more than two partitions behind is left out,
+		// the stages continue with the partitions that arrive after the background thread caught up
+		const int blockSize = 64;
+		Convolver convolver(impulseResponse, blockSize, true, 2048);
+		auto input = createNoise(blockSize * 600, 1.f, 7);
+		SampleBuffer output(input.size(), 0.f);
+		for (auto i = 0; i < int(input.size()); i += blockSize)
+		{
+			auto posted = convolver.process(&input[i], &output[i]);
+			if (posted && i > blockSize * 300)
+				REQUIRE(convolver.processBackground());
+		}
+		auto dropped = convolver.getDroppedPartitionCount();
+		REQUIRE(dropped > 0);
+
+		SampleBuffer silence(blockSize, 0.f);
+		for (auto i = 0; i < 200; ++i)
+			if (convolver.process(silence.data(), silence.data()))
+				convolver.processBackground();
+		REQUIRE(convolver.getDroppedPartitionCount() == dropped);
+	}
+}
+
+TEST_CASE("Convolver benchmark", "[.][convolution][benchmark]")
+{
+	// Measures the cost of the audio callback for long impulse responses at 48kHz with a block size of 256.
+	// With background processing only the first stage is calculated within process(), the average cost includes all stages.
+	const float sampleRate = 48000.f;
+	const int blockSize = 256;
+	const int blockCount = 2000;
+	auto input = createNoise(blockSize, 1.f, 5);
+	SampleBuffer output(blockSize);
+
+	for (auto seconds : { 2.f, 6.f })
+	{
+		auto impulseResponse = createNoise(int(seconds * sampleRate), 0.01f, 6);
+		for (auto background : { false, true })
+		{
+			Convolver convolver(impulseResponse, blockSize, background);
+			double maximum = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (auto i = 0; i < blockCount; ++i)
+			{
+				auto blockStart = std::chrono::steady_clock::now();
+				convolver.process(input.data(), output.data());
+				maximum = std::max(maximum, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - blockStart).count());
+				if (background)
+					convolver.processBackground();
+			}
+			auto average = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / blockCount;
+			auto period = 1e6 * blockSize / sampleRate;
+
+			WARN("Convolution " << seconds << "s, background " << background << ": average " << average << "us (" << 100.0 * average / period << "%), maximum in process() " << maximum << "us");
+		}
+	}
+}
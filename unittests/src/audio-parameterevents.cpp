@@ -0,0 +1,105 @@
+#include "utils/catch.hpp"
+
+#include <audio/core/audionodemanager.h>
+#include <audio/node/controlnode.h>
+#include <audio/node/gainnode.h>
+#include <audio/node/outputnode.h>
+#include <audio/utility/parametereventqueue.h>
+
+using namespace nap::audio;
+
+namespace
+{
+	ParameterEvent createEvent(DiscreteTimeValue time, ControllerValue value)
+	{
+		ParameterEvent event;
+		event.mTime = time;
+		event.mValue = value;
+		return event;
+	}
+}
+
+TEST_CASE("Parameter event queue", "[audio]")
+{
+	ParameterEventQueue queue(8);
+	REQUIRE(queue.enqueue(createEvent(30, 3.f)));
+	REQUIRE(queue.enqueue(createEvent(10, 1.f)));
+	REQUIRE(queue.enqueue(createEvent(20, 2.f)));
+	REQUIRE(queue.enqueue(createEvent(10, 1.5f)));
+	queue.collect();
+
+	// Events are popped in time order, events of equal time in the order they were enqueued
+	ParameterEvent event;
+	REQUIRE(queue.getSamplesUntilNextEvent(0, 64) == 10);
+	REQUIRE(queue.getSamplesUntilNextEvent(0, 5) == 5);
+	REQUIRE_FALSE(queue.popDueEvent(9, event));
+	REQUIRE(queue.popDueEvent(10, event));
+	REQUIRE(event.mValue == 1.f);
+	REQUIRE(queue.popDueEvent(10, event));
+	REQUIRE(event.mValue == 1.5f);
+	REQUIRE(queue.getSamplesUntilNextEvent(10, 64) == 10);
+
+	// Late events are due immediately
+	REQUIRE(queue.getSamplesUntilNextEvent(40, 64) == 0);
+	REQUIRE(queue.popDueEvent(40, event));
+	REQUIRE(event.mValue == 2.f);
+	REQUIRE(queue.popDueEvent(40, event));
+	REQUIRE(event.mValue == 3.f);
+	REQUIRE_FALSE(queue.popDueEvent(40, event));
+
+	queue.enqueue(createEvent(50, 5.f));
+	queue.collect();
+	queue.clear();
+	REQUIRE(queue.getSamplesUntilNextEvent(0, 64) == 64);
+}
+
+
+TEST_CASE("Sample accurate gain", "[audio]")
+{
+	const int bufferSize = 256;
+
+	DeletionQueue deletionQueue;
+	NodeManager nodeManager(deletionQueue);
+	nodeManager.setSampleRate(48000);
+	nodeManager.setInternalBufferSize(64);
+	nodeManager.setOutputChannelCount(1);
+
+	auto source = nodeManager.makeSafe<ControlNode>(nodeManager);
+	source->setValue(1.f);
+	auto gain = nodeManager.makeSafe<GainNode>(nodeManager, 1.f);
+	auto output = nodeManager.makeSafe<OutputNode>(nodeManager);
+	output->setOutputChannel(0);
+	output->audioInput.connect(gain->audioOutput);
+
+	SampleBuffer left(bufferSize);
+	std::vector<SampleBuffer*> inputBuffers;
+	std::vector<SampleBuffer*> outputBuffers = { &left };
+	auto process = [&]() { nodeManager.process(inputBuffers, outputBuffers, bufferSize); };
+
+	SECTION("Events are applied at the exact sample")
+	{
+		gain->audioInput.connect(source->output);
+		process();
+		REQUIRE(left.back() == Approx(1.f));
+
+		REQUIRE(gain->scheduleGain(0.5f, 0.f, nodeManager.getSampleTime() + 100));
+		process();
+		REQUIRE(left[99] == Approx(1.f));
+		REQUIRE(left[100] == Approx(0.5f));
+		REQUIRE(left.back() == Approx(0.5f));
+	}
+
+	SECTION("Events are applied without input")
+	{
+		// A one millisecond ramp that ends within a buffer without input
+		process();
+		REQUIRE(gain->scheduleGain(0.f, 1.f, nodeManager.getSampleTime() + 10));
+		process();
+		REQUIRE(left.back() == Approx(0.f));
+
+		gain->audioInput.connect(source->output);
+		process();
+		REQUIRE(left.front() == Approx(0.f));
+		REQUIRE(left.back() == Approx(0.f));
+	}
+}
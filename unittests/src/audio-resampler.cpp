@@ -0,0 +1,54 @@
+#include "utils/catch.hpp"
+
+#include <audio/utility/resampler.h>
+
+#include <cmath>
+
+using namespace nap::audio;
+
+namespace
+{
+	SampleBuffer createSine(float frequency, float sampleRate, int size)
+	{
+		SampleBuffer buffer(size);
+		for (auto i = 0; i < size; ++i)
+			buffer[i] = std::sin(2.0 * M_PI * frequency * i / sampleRate);
+		return buffer;
+	}
+
+	// Maximum absolute difference with a sine, skipping the edges where the kernel reads silence
+	float getSineError(const SampleBuffer& buffer, float frequency, float sampleRate)
+	{
+		double error = 0;
+		for (auto i = 1000; i < int(buffer.size()) - 1000; ++i)
+			error = std::max(error, std::abs(buffer[i] - std::sin(2.0 * M_PI * frequency * i / sampleRate)));
+		return float(error);
+	}
+}
+
+TEST_CASE("Resampler", "[resampler]")
+{
+	SECTION("Upsampling")
+	{
+		SampleBuffer output;
+		resample(createSine(1000.f, 44100.f, 44100), output, 44100.f, 48000.f, EResampleQuality::High);
+		REQUIRE(output.size() == 48000);
+		REQUIRE(getSineError(output, 1000.f, 48000.f) < 1e-4f);
+	}
+
+	SECTION("Downsampling")
+	{
+		SampleBuffer output;
+		resample(createSine(1000.f, 48000.f, 48000), output, 48000.f, 44100.f, EResampleQuality::Medium);
+		REQUIRE(output.size() == 44100);
+		REQUIRE(getSineError(output, 1000.f, 44100.f) < 1e-3f);
+	}
+
+	SECTION("Anti-aliasing")
+	{
+		// A tone above the Nyquist frequency of the destination is filtered out instead of being folded back
+		SampleBuffer output;
+		resample(createSine(30000.f, 96000.f, 96000), output, 96000.f, 44100.f, EResampleQuality::High);
+		REQUIRE(getSineError(output, 0.f, 44100.f) < 1e-3f);
+	}
+}
@@ -0,0 +1,139 @@
+#include "utils/catch.hpp"
+
+#include <audio/core/audionodemanager.h>
+#include <audio/node/outputnode.h>
+#include <audio/node/voicepoolnode.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace nap::audio;
+
+namespace
+{
+	const int sampleRate = 48000;
+	const int bufferSize = 1024;
+	const int voiceCount = 256;
+
+	/**
+	 * Stereo voice pool connected to the outputs, playing back a second of DC offset.
+	 * The output level equals the sum of the voice gains.
+	 */
+	struct VoicePoolTest
+	{
+		VoicePoolTest() : nodeManager(deletionQueue)
+		{
+			nodeManager.setSampleRate(sampleRate);
+			nodeManager.setInternalBufferSize(64);
+			nodeManager.setOutputChannelCount(2);
+
+			buffer = nodeManager.makeSafe<MultiSampleBuffer>(1, sampleRate);
+			for (auto& sample : (*buffer)[0])
+				sample = 1.f;
+
+			pool = nodeManager.makeSafe<VoicePoolNode>(nodeManager, voiceCount, 2, 1024);
+			pool->addBuffer(buffer.get());
+
+			for (auto channel = 0; channel < 2; ++channel)
+			{
+				auto output = nodeManager.makeSafe<OutputNode>(nodeManager);
+				output->setOutputChannel(channel);
+				output->audioInput.connect(pool->getOutput(channel));
+				outputs.emplace_back(std::move(output));
+			}
+
+			// Register the nodes on the audio thread
+			process();
+		}
+
+		void process()
+		{
+			std::vector<SampleBuffer*> inputBuffers;
+			std::vector<SampleBuffer*> outputBuffers = { &left, &right };
+			nodeManager.process(inputBuffers, outputBuffers, bufferSize);
+		}
+
+		DeletionQueue deletionQueue;
+		NodeManager nodeManager;
+		SafeOwner<MultiSampleBuffer> buffer;
+		SafeOwner<VoicePoolNode> pool;
+		std::vector<SafeOwner<OutputNode>> outputs;
+		SampleBuffer left = SampleBuffer(bufferSize);
+		SampleBuffer right = SampleBuffer(bufferSize);
+	};
+}
+
+
+TEST_CASE("Voice pool", "[audio]")
+{
+	VoicePoolTest test;
+	auto& pool = test.pool;
+	auto& left = test.left;
+	auto& right = test.right;
+	auto process = [&]() { test.process(); };
+	REQUIRE(pool->getActiveVoiceCount() == 0);
+
+	nap::uint64 handle = 1;
+
+	SECTION("Trigger and release")
+	{
+		REQUIRE(pool->trigger(handle, 0, 0.5f, 1.f, 0, 0.f));
+		process();
+		REQUIRE(pool->getActiveVoiceCount() == 1);
+		REQUIRE(left.back() == Approx(0.5f));
+		REQUIRE(right.back() == Approx(0.5f));
+
+		REQUIRE(pool->release(handle, 0.f));
+		process();
+		REQUIRE(pool->getActiveVoiceCount() == 0);
+		REQUIRE(left.back() == Approx(0.f));
+	}
+
+	SECTION("Stealing")
+	{
+		for (auto i = 0; i < voiceCount + 10; ++i)
+			REQUIRE(pool->trigger(handle++, 0, 1.f, 1.f, 0, 0.f));
+		process();
+		REQUIRE(pool->getActiveVoiceCount() == voiceCount);
+		REQUIRE(pool->getStolenVoiceCount() == 10);
+		REQUIRE(left.back() == Approx(float(voiceCount)));
+
+		// A stolen voice fades out before the new trigger fades in, without a jump in the output
+		REQUIRE(pool->trigger(handle++, 0, 1.f, 1.f, 0, 2.f));
+		process();
+		REQUIRE(pool->getStolenVoiceCount() == 11);
+		auto maximumStep = 0.f;
+		for (auto i = 1; i < bufferSize; ++i)
+			maximumStep = std::max(maximumStep, std::abs(left[i] - left[i - 1]));
+		REQUIRE(maximumStep < 0.05f);
+		REQUIRE(left.back() == Approx(float(voiceCount)));
+	}
+}
+
+
+TEST_CASE("Voice pool benchmark", "[.][audio][benchmark]")
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	VoicePoolTest test;
+	nap::uint64 handle = 1;
+
+	// Cost of a trigger on the calling thread
+	auto start = Clock::now();
+	for (auto i = 0; i < voiceCount; ++i)
+		test.pool->trigger(handle++, 0, 1.f / voiceCount, 1.f, 0, 2.f);
+	auto triggerTime = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / voiceCount;
+
+	// Cost of rendering all voices on the audio thread
+	const int callbackCount = 40;
+	start = Clock::now();
+	for (auto i = 0; i < callbackCount; ++i)
+		test.process();
+	auto renderTime = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / callbackCount;
+	auto callbackDuration = 1000000.0 * bufferSize / sampleRate;
+
+	REQUIRE(test.pool->getActiveVoiceCount() == voiceCount);
+	WARN("Voice pool: " << triggerTime << " us per trigger, latency <= " << 1000.0 * 64 / sampleRate
+		<< " ms, " << 100.0 * renderTime / callbackDuration << "% DSP load at " << voiceCount << " voices");
+}
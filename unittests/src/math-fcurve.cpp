@@ -0,0 +1,165 @@
+#include "utils/catch.hpp"
+
+#include <fcurve.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+using namespace nap::math;
+
+namespace
+{
+	/**
+	 * Reference evaluation of a single bezier segment: bisection on the time component in double precision
+	 */
+	double evaluateReference(const FloatFCurvePoint& curr, const FloatFCurvePoint& next, double x)
+	{
+		double ax = curr.mPos.mTime, ay = curr.mPos.mValue;
+		double bx = ax + curr.mOutTan.mTime, by = ay + curr.mOutTan.mValue;
+		double dx = next.mPos.mTime, dy = next.mPos.mValue;
+		double cx = dx + next.mInTan.mTime, cy = dy + next.mInTan.mValue;
+
+		auto time_at = [&](double t)
+		{
+			double u = 1.0 - t;
+			return ax * u * u * u + 3.0 * bx * u * u * t + 3.0 * cx * u * t * t + dx * t * t * t;
+		};
+
+		double lower = 0.0, upper = 1.0, t = 0.5;
+		for (int i = 0; i < 100; i++)
+		{
+			t = (lower + upper) * 0.5;
+			if (time_at(t) < x)
+				lower = t;
+			else
+				upper = t;
+		}
+
+		double u = 1.0 - t;
+		return ay * u * u * u + 3.0 * by * u * u * t + 3.0 * cy * u * t * t + dy * t * t * t;
+	}
+
+
+	/**
+	 * Random curve with monotonic bezier segments, tangents never exceed a third of the segment
+	 */
+	void createCurve(FloatFCurve& curve, int pointCount, std::mt19937& generator)
+	{
+		std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+		std::vector<float> spacing(pointCount + 1);
+		for (auto& s : spacing)
+			s = 0.05f + distribution(generator);
+
+		curve.mPoints.clear();
+		float time = 0.0f;
+		for (int i = 0; i < pointCount; i++)
+		{
+			time += spacing[i];
+			float in_tan = 0.001f + distribution(generator) * 0.3f * spacing[i];
+			float out_tan = 0.001f + distribution(generator) * 0.3f * spacing[i + 1];
+			curve.mPoints.emplace_back(FloatFComplex(time, distribution(generator)),
+				FloatFComplex(-in_tan, (distribution(generator) - 0.5f) * in_tan),
+				FloatFComplex(out_tan, (distribution(generator) - 0.5f) * out_tan));
+		}
+		curve.invalidate();
+	}
+}
+
+
+TEST_CASE("FCurve evaluation", "[fcurve]")
+{
+	std::mt19937 generator(11);
+	FloatFCurve curve;
+
+	SECTION("Bezier matches reference")
+	{
+		for (int c = 0; c < 100; c++)
+		{
+			createCurve(curve, 6, generator);
+			const auto& points = curve.mPoints;
+			for (int i = 0; i < static_cast<int>(points.size()) - 1; i++)
+			{
+				for (float f = 0.0f; f < 1.0f; f += 0.05f)
+				{
+					float x = points[i].mPos.mTime + f * (points[i + 1].mPos.mTime - points[i].mPos.mTime);
+					double expected = evaluateReference(points[i], points[i + 1], x);
+					REQUIRE(curve.evaluate(x) == Approx(expected).margin(0.005));
+				}
+			}
+		}
+	}
+
+	SECTION("Default curve")
+	{
+		FloatFCurve default_curve;
+		REQUIRE(default_curve.evaluate(-1.0f) == Approx(0.0f));
+		REQUIRE(default_curve.evaluate(0.5f) == Approx(0.5f).margin(0.001));
+		REQUIRE(default_curve.evaluate(2.0f) == Approx(1.0f));
+		REQUIRE(default_curve.evaluate(0.25f) < 0.25f);
+		REQUIRE(default_curve.evaluate(0.75f) > 0.75f);
+	}
+
+	SECTION("Batched matches single")
+	{
+		createCurve(curve, 8, generator);
+		std::vector<float> times;
+		float end = curve.mPoints.back().mPos.mTime + 0.5f;
+		for (float t = -0.5f; t < end; t += 0.01f)
+			times.emplace_back(t);
+
+		// Ascending and in random order
+		for (int pass = 0; pass < 2; pass++)
+		{
+			std::vector<float> values;
+			curve.evaluate(times, values);
+			REQUIRE(values.size() == times.size());
+			for (int i = 0; i < static_cast<int>(times.size()); i++)
+				REQUIRE(values[i] == Approx(curve.evaluate(times[i])));
+			std::shuffle(times.begin(), times.end(), generator);
+		}
+	}
+
+	SECTION("Linear and stepped")
+	{
+		createCurve(curve, 3, generator);
+		const auto& points = curve.mPoints;
+		curve.mPoints[0].mInterp = ECurveInterp::Linear;
+		curve.mPoints[1].mInterp = ECurveInterp::Stepped;
+
+		float x = (points[0].mPos.mTime + points[1].mPos.mTime) * 0.5f;
+		REQUIRE(curve.evaluate(x) == Approx((points[0].mPos.mValue + points[1].mPos.mValue) * 0.5f));
+
+		x = (points[1].mPos.mTime + points[2].mPos.mTime) * 0.5f;
+		REQUIRE(curve.evaluate(x) == Approx(points[1].mPos.mValue));
+	}
+}
+
+
+TEST_CASE("FCurve evaluation benchmark", "[.][fcurve][benchmark]")
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	std::mt19937 generator(11);
+	FloatFCurve curve;
+	createCurve(curve, 8, generator);
+	const int count = 100000;
+	float start_time = curve.mPoints.front().mPos.mTime;
+	float duration = curve.mPoints.back().mPos.mTime - start_time;
+	std::vector<float> times(count);
+	for (int i = 0; i < count; i++)
+		times[i] = start_time + duration * static_cast<float>(i) / count;
+
+	std::vector<float> values(count);
+	auto start = Clock::now();
+	for (int i = 0; i < count; i++)
+		values[i] = curve.evaluate(times[i]);
+	auto single_time = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+	start = Clock::now();
+	curve.evaluate(times.data(), values.data(), count);
+	auto batch_time = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / count;
+
+	WARN("FCurve: " << single_time << " ns per evaluation, " << batch_time << " ns per batched evaluation");
+}
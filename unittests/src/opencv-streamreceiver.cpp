@@ -0,0 +1,207 @@
+#include "utils/catch.hpp"
+
+#include <cvstreamreceiver.h>
+#include <videoencoder.h>
+#include <utility/errorstate.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+}
+
+using namespace nap;
+
+namespace
+{
+	const int width = 64;
+	const int height = 48;
+	const int frameRate = 25;
+	const int frameCount = 25;
+
+	// RGBA8 frame with a different color for every frame index
+	std::vector<uint8> createFrame(int64 index)
+	{
+		std::vector<uint8> pixels(width * height * 4);
+		for (int i = 0; i < width * height; i++)
+		{
+			uint8* pixel = &pixels[i * 4];
+			pixel[0] = static_cast<uint8>(index * 10);
+			pixel[1] = static_cast<uint8>(255 - index * 10);
+			pixel[2] = static_cast<uint8>(i % width);
+			pixel[3] = 255;
+		}
+		return pixels;
+	}
+
+	// Encodes a lossless file that serves as stand-in for a live stream
+	void encode(const std::string& path)
+	{
+		VideoEncoder encoder(width, height, frameCount, true);
+		utility::ErrorState error_state;
+		REQUIRE(encoder.init(path, EVideoEncoderCodec::FFV1, frameRate, 0, true, error_state));
+		for (int64 index = 0; index < frameCount; index++)
+		{
+			std::vector<uint8> frame = createFrame(index);
+			REQUIRE(encoder.submit(frame.data(), frame.size(), index));
+		}
+		encoder.finish();
+		REQUIRE_FALSE(encoder.hasErrorOccurred());
+	}
+
+	// Frame index derived from the presentation time
+	int64 getIndex(const CVStreamFrame& frame)
+	{
+		return static_cast<int64>(std::round(frame.mTimestamp * frameRate));
+	}
+
+	// If the received BGR image matches the frame that was encoded
+	bool matches(const CVStreamFrame& frame)
+	{
+		if (frame.mImage.cols != width || frame.mImage.rows != height || frame.mImage.type() != CV_8UC3)
+			return false;
+
+		std::vector<uint8> expected = createFrame(getIndex(frame));
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				const uint8* pixel = &expected[(y * width + x) * 4];
+				const cv::Vec3b& bgr = frame.mImage.at<cv::Vec3b>(y, x);
+				if (bgr[0] != pixel[2] || bgr[1] != pixel[1] || bgr[2] != pixel[0])
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// Polls the condition until it holds or the timeout in milliseconds expires
+	bool waitFor(const std::function<bool()>& condition, int timeout)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+		while (!condition())
+		{
+			if (std::chrono::steady_clock::now() >= deadline)
+				return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return true;
+	}
+}
+
+
+TEST_CASE("Stream receiver", "[opencv]")
+{
+	// Normally done by the video service on init
+	av_register_all();
+	avcodec_register_all();
+
+	const std::string path = "stream_receiver_test.mkv";
+	encode(path);
+
+	// Reconnecting is postponed, unless tested, so the buffer only holds frames of the first pass
+	CVStreamSettings settings;
+	settings.mLink = path;
+	settings.mReconnectDelay = 60000.0f;
+	settings.mMaxReconnectDelay = 60000.0f;
+	CVStreamReceiver receiver;
+
+	SECTION("paced input is released in order")
+	{
+		settings.mPaceInput = true;
+		settings.mSkipToLatest = false;
+		receiver.start(settings);
+
+		std::vector<CVStreamFrame> frames(frameCount);
+		for (int i = 0; i < frameCount; i++)
+		{
+			REQUIRE(receiver.pop(frames[i], 2000.0f));
+			REQUIRE(getIndex(frames[i]) == i);
+			REQUIRE(matches(frames[i]));
+		}
+		REQUIRE(receiver.getWidth() == width);
+		REQUIRE(receiver.getHeight() == height);
+
+		// Frames arrive at the rate of the file
+		double elapsed = std::chrono::duration<double>(frames.back().mReceiveTime - frames.front().mReceiveTime).count();
+		double duration = frames.back().mTimestamp - frames.front().mTimestamp;
+		REQUIRE(duration == Approx(static_cast<double>(frameCount - 1) / frameRate).epsilon(0.01));
+		REQUIRE(elapsed >= duration * 0.9);
+		REQUIRE(receiver.getStatistics().mDropped == 0);
+	}
+
+	SECTION("jitter buffer drops the oldest frames")
+	{
+		settings.mBufferSize = 3;
+		settings.mSkipToLatest = false;
+		receiver.start(settings);
+		REQUIRE(waitFor([&]() { return receiver.getStatistics().mReceived == frameCount; }, 5000));
+
+		CVStreamStatistics statistics = receiver.getStatistics();
+		REQUIRE(statistics.mBuffered == 3);
+		REQUIRE(statistics.mDropped == frameCount - 3);
+
+		CVStreamFrame frame;
+		for (int i = frameCount - 3; i < frameCount; i++)
+		{
+			REQUIRE(receiver.pop(frame, 1000.0f));
+			REQUIRE(getIndex(frame) == i);
+			REQUIRE(matches(frame));
+		}
+		REQUIRE_FALSE(receiver.pop(frame, 50.0f));
+	}
+
+	SECTION("skip to latest releases the most recent frame")
+	{
+		settings.mBufferSize = frameCount;
+		settings.mSkipToLatest = true;
+		receiver.start(settings);
+		REQUIRE(waitFor([&]() { return receiver.getStatistics().mReceived == frameCount; }, 5000));
+		REQUIRE(receiver.getStatistics().mBuffered == frameCount);
+
+		CVStreamFrame frame;
+		REQUIRE(receiver.pop(frame, 1000.0f));
+		REQUIRE(getIndex(frame) == frameCount - 1);
+		REQUIRE(matches(frame));
+
+		CVStreamStatistics statistics = receiver.getStatistics();
+		REQUIRE(statistics.mBuffered == 0);
+		REQUIRE(statistics.mDropped == frameCount - 1);
+	}
+
+	SECTION("reconnects after the source closes")
+	{
+		// Source is not available yet
+		std::remove(path.c_str());
+		settings.mReconnectDelay = 10.0f;
+		settings.mMaxReconnectDelay = 50.0f;
+		settings.mSkipToLatest = false;
+		settings.mBufferSize = frameCount;
+		receiver.start(settings);
+		REQUIRE(waitFor([&]() { return receiver.getStatistics().mReconnects >= 2; }, 5000));
+		REQUIRE_FALSE(receiver.isConnected());
+		REQUIRE_FALSE(receiver.getLastError().empty());
+		REQUIRE(receiver.getStatistics().mReceived == 0);
+
+		// Source becomes available and closes at the end of the file, after which it is opened again
+		encode(path);
+		REQUIRE(waitFor([&]() { return receiver.getStatistics().mReceived >= frameCount * 2; }, 5000));
+		REQUIRE(receiver.getStatistics().mReconnects >= 3);
+
+		// Frames of the reopened file are released
+		CVStreamFrame frame;
+		REQUIRE(receiver.pop(frame, 1000.0f));
+		REQUIRE(getIndex(frame) < frameCount);
+		REQUIRE(matches(frame));
+	}
+
+	receiver.stop();
+	std::remove(path.c_str());
+}
@@ -0,0 +1,101 @@
+#include "utils/catch.hpp"
+
+#include <oscaddresstrie.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace nap;
+
+TEST_CASE("OSC address patterns", "[osc]")
+{
+	OSCAddressTrie trie;
+	trie.add("/mixer/fader", 0);
+	trie.add("/mixer/*/level", 1);
+	trie.add("/channel/[1-3]/mute", 2);
+	trie.add("/channel/[!1-3]/mute", 3);
+	trie.add("/{left,right}/?x", 4);
+	trie.add("/a*b*c", 5);
+
+	using Matches = std::vector<int>;
+	SECTION("literals match the start of an address")
+	{
+		REQUIRE(trie.match("/mixer/fader") == Matches({ 0 }));
+		REQUIRE(trie.match("/mixer/fader/1") == Matches({ 0 }));
+		REQUIRE(trie.match("/mixer/faders") == Matches({ 0 }));
+		REQUIRE(trie.match("/mixer/fade").empty());
+		REQUIRE(trie.match("").empty());
+	}
+
+	SECTION("wildcards don't match the separator")
+	{
+		REQUIRE(trie.match("/mixer/one/level") == Matches({ 1 }));
+		REQUIRE(trie.match("/mixer//level") == Matches({ 1 }));
+		REQUIRE(trie.match("/mixer/one/two/level").empty());
+		REQUIRE(trie.match("/aXbYc") == Matches({ 5 }));
+		REQUIRE(trie.match("/abc") == Matches({ 5 }));
+		REQUIRE(trie.match("/ab/c").empty());
+	}
+
+	SECTION("character sets and alternatives")
+	{
+		REQUIRE(trie.match("/channel/2/mute") == Matches({ 2 }));
+		REQUIRE(trie.match("/channel/4/mute") == Matches({ 3 }));
+		REQUIRE(trie.match("/channel//mute").empty());
+		REQUIRE(trie.match("/left/ax") == Matches({ 4 }));
+		REQUIRE(trie.match("/right/bx") == Matches({ 4 }));
+		REQUIRE(trie.match("/center/ax").empty());
+	}
+
+	SECTION("subscribers are listed once, sorted")
+	{
+		trie.add("", 7);
+		trie.add("/mixer", 6);
+		trie.add("/mixer/f*", 6);
+		REQUIRE(trie.match("/mixer/fader") == Matches({ 0, 6, 7 }));
+		REQUIRE(trie.match("/other") == Matches({ 7 }));
+	}
+
+	// Matching an address caches its states, matching it again reuses them
+	trie.match("/mixer/fader");
+	int state_count = trie.getStateCount();
+	trie.match("/mixer/fader");
+	REQUIRE(trie.getStateCount() == state_count);
+	trie.clear();
+	REQUIRE(trie.match("/mixer/fader").empty());
+}
+
+
+TEST_CASE("OSC address pattern benchmark", "[.][osc][benchmark]")
+{
+	// Routes addresses against 1000 filters, after the states are cached
+	OSCAddressTrie trie;
+	for (int i = 0; i < 1000; i++)
+		trie.add("/scene/" + std::to_string(i) + "/{position,rotation}/[xyz]", i);
+	trie.add("/scene/*/color", 1000);
+
+	std::vector<std::string> addresses;
+	for (int i = 0; i < 1000; i += 7)
+	{
+		addresses.emplace_back("/scene/" + std::to_string(i) + "/position/x");
+		addresses.emplace_back("/scene/" + std::to_string(i) + "/color");
+	}
+
+	// Warm up the cached states
+	for (const auto& address : addresses)
+		trie.match(address);
+
+	const int iterations = 100;
+	size_t matches = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+	{
+		for (const auto& address : addresses)
+			matches += trie.match(address).size();
+	}
+	auto average = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (iterations * addresses.size());
+
+	WARN("OSC routing against 1001 patterns: " << average << "ns per address, " << trie.getStateCount() << " states");
+	REQUIRE(matches == iterations * addresses.size());
+}
@@ -0,0 +1,133 @@
+#include "utils/catch.hpp"
+
+#include <oscevent.h>
+#include <oscreceiver.h>
+#include <oscservice.h>
+#include <osc/OscOutboundPacketStream.h>
+#include <ip/UdpSocket.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace nap;
+
+namespace
+{
+	// Exposes the update of the service, called by core in an application
+	class TestOSCService : public OSCService
+	{
+	public:
+		TestOSCService() : OSCService(nullptr) { }
+		using OSCService::update;
+	};
+}
+
+
+TEST_CASE("OSC event reuse", "[osc]")
+{
+	const char* long_string = "a string that does not fit in the small string buffer";
+	const char blob[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	OSCEvent event("/first");
+	event.reserve(4, 32);
+	event.addValue<float>(1.0f);
+	event.addString(long_string);
+	event.addBlob(blob, sizeof(blob));
+	REQUIRE(event.getCount() == 3);
+	REQUIRE(event[0].asFloat() == 1.0f);
+	REQUIRE(event[1].asString() == long_string);
+	REQUIRE(event[2].get<OSCBlob>()->mSize == sizeof(blob));
+	REQUIRE(std::memcmp(event[2].get<OSCBlob>()->mData, blob, sizeof(blob)) == 0);
+
+	// Cleared arguments are reused in the same order, including the memory of their values
+	const OSCArgument* first = event.getArgument(0);
+	const OSCArgument* second = event.getArgument(1);
+	const char* string_data = event[1].asString().data();
+	event.clear();
+	REQUIRE(event.getCount() == 0);
+
+	event.setAddress("/second/address");
+	event.addValue<int>(5);
+	event.addString("short");
+	REQUIRE(event.getAddress() == "/second/address");
+	REQUIRE(event.getCount() == 2);
+	REQUIRE(event.getArgument(0) == first);
+	REQUIRE(event.getArgument(1) == second);
+	REQUIRE(event[0].asInt() == 5);
+	REQUIRE(event[1].asString() == "short");
+	REQUIRE(event[1].asString().data() == string_data);
+
+	int count = 0;
+	for (const auto& argument : event.getArguments())
+		count += argument->hasValue() ? 1 : 0;
+	REQUIRE(count == 2);
+}
+
+
+TEST_CASE("OSC receive benchmark", "[.][osc][benchmark]")
+{
+	// Sends messages from a local UDP load generator at increasing rates for half a second each,
+	// while the main thread dispatches at 60 frames per second. A rate is sustained when every message is dispatched.
+	const int port = 7931;
+	const double duration = 0.5;
+
+	TestOSCService service;
+	OSCReceiver receiver(service);
+	receiver.mID = "BenchmarkReceiver";
+	receiver.mPort = port;
+	receiver.mQueueSize = 8192;
+
+	utility::ErrorState error_state;
+	REQUIRE(receiver.start(error_state));
+
+	UdpTransmitSocket socket(IpEndpointName("127.0.0.1", port));
+	char buffer[256];
+	osc::OutboundPacketStream packet(buffer, sizeof(buffer));
+	packet << osc::BeginMessage("/benchmark/mixer/fader") << 0.5f << static_cast<osc::int32>(3) << "channel" << osc::EndMessage;
+
+	int sustained_rate = 0;
+	for (int rate : { 10000, 25000, 50000, 100000, 200000, 400000, 800000 })
+	{
+		uint64 received_start = receiver.getReceivedCount();
+		uint64 dropped_start = receiver.getDroppedCount();
+
+		// Send a slice of the messages every millisecond
+		int sent = 0;
+		std::thread generator([&]()
+		{
+			auto start = std::chrono::steady_clock::now();
+			int slices = static_cast<int>(duration * 1000.0);
+			for (int slice = 1; slice <= slices; slice++)
+			{
+				int target = static_cast<int>(static_cast<double>(rate) * slice / 1000.0);
+				for (; sent < target; sent++)
+					socket.Send(packet.Data(), packet.Size());
+				std::this_thread::sleep_until(start + std::chrono::milliseconds(slice));
+			}
+		});
+
+		// Dispatch every frame until the generator is done, then drain what is in flight
+		auto start = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - start < std::chrono::duration<double>(duration + 0.1))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(16));
+			service.update(1.0 / 60.0);
+		}
+		generator.join();
+		service.update(1.0 / 60.0);
+
+		uint64 received = receiver.getReceivedCount() - received_start;
+		uint64 dropped = receiver.getDroppedCount() - dropped_start;
+		uint64 dispatched = received - dropped;
+		WARN("OSC " << rate << " msg/s: sent " << sent << ", received " << received << ", dropped from pool " << dropped << ", dispatched " << dispatched);
+
+		if (dispatched < static_cast<uint64>(sent))
+			break;
+		sustained_rate = rate;
+	}
+	receiver.stop();
+
+	WARN("OSC max sustained message rate: " << sustained_rate << " msg/s");
+	REQUIRE(sustained_rate > 0);
+}
@@ -0,0 +1,111 @@
+#include "utils/catch.hpp"
+
+#include <parameterblendengine.h>
+#include <parameternumeric.h>
+#include <parametervec.h>
+#include <parametercolor.h>
+#include <mathutils.h>
+
+#include <memory>
+#include <vector>
+
+using namespace nap;
+
+TEST_CASE("Parameter blend engine", "[parameter]")
+{
+	// Odd count exercises the scalar tail of the kernels
+	const int count = 37;
+	std::vector<std::unique_ptr<ParameterFloat>> sources;
+	std::vector<std::unique_ptr<ParameterFloat>> targets;
+	int signal_count = 0;
+
+	ParameterBlendEngine engine;
+	for (int i = 0; i < count; i++)
+	{
+		sources.emplace_back(std::make_unique<ParameterFloat>());
+		targets.emplace_back(std::make_unique<ParameterFloat>());
+		sources.back()->setRange(0.0f, 10.0f);
+		sources.back()->mValue = static_cast<float>(i % 5);
+		targets.back()->mValue = static_cast<float>(i % 11);
+		sources.back()->valueChanged.connect([&signal_count](float) { signal_count++; });
+		REQUIRE(engine.add(*sources.back()) == i);
+	}
+
+	ParameterVec3 vec;
+	vec.mClamp = true;
+	vec.setRange(0.0f, 1.0f);
+	vec.mValue = { 0.0f, 0.5f, 1.0f };
+	ParameterVec3 vec_target;
+	vec_target.mValue = { 1.0f, 0.5f, 4.0f };
+	int vec_index = engine.add(vec);
+
+	ParameterRGBAColor8 color;
+	color.mValue = { 0, 100, 200, 255 };
+	ParameterRGBAColor8 color_target;
+	color_target.mValue = { 255, 100, 0, 255 };
+	int color_index = engine.add(color);
+
+	ParameterDouble number;
+	number.setRange(-100.0, 100.0);
+	number.mValue = -50.0;
+	ParameterDouble number_target;
+	number_target.mValue = 50.0;
+	int number_index = engine.add(number);
+
+	ParameterBool unsupported;
+	REQUIRE_FALSE(ParameterBlendEngine::supports(unsupported.get_type()));
+	REQUIRE(engine.add(unsupported) == -1);
+	REQUIRE(engine.getCount() == count + 3);
+
+	// Parameters without target are left alone
+	for (int i = 0; i < count; i += 2)
+		engine.setTarget(i, targets[i].get());
+	engine.setTarget(vec_index, &vec_target);
+	engine.setTarget(color_index, &color_target);
+	engine.setTarget(number_index, &number_target);
+
+	SECTION("Blend")
+	{
+		std::vector<Parameter*> changed;
+		engine.blend(0.5f, EParameterBlendNotification::Parameter, changed);
+		for (int i = 0; i < count; i++)
+		{
+			float source = static_cast<float>(i % 5);
+			float expected = (i % 2 == 0) ? math::lerp<float>(source, static_cast<float>(i % 11), 0.5f) : source;
+			REQUIRE(sources[i]->mValue == Approx(math::clamp(expected, 0.0f, 10.0f)));
+		}
+		REQUIRE(vec.mValue.x == Approx(0.5f));
+		REQUIRE(vec.mValue.y == Approx(0.5f));
+		REQUIRE(vec.mValue.z == Approx(1.0f));
+		REQUIRE(color.mValue.getRed() == 127);
+		REQUIRE(color.mValue.getGreen() == 100);
+		REQUIRE(color.mValue.getBlue() == 100);
+		REQUIRE(number.mValue == Approx(0.0));
+
+		// Only parameters whose value changed are reported
+		REQUIRE(signal_count == static_cast<int>(changed.size()) - 3);
+		for (auto* parameter : changed)
+			REQUIRE(parameter != &unsupported);
+
+		// Lands exactly on the target
+		changed.clear();
+		engine.blend(1.0f, EParameterBlendNotification::Parameter, changed);
+		for (int i = 0; i < count; i += 2)
+			REQUIRE(sources[i]->mValue == targets[i]->mValue);
+		REQUIRE(number.mValue == number_target.mValue);
+
+		// Nothing changes when blending to the same value again
+		changed.clear();
+		engine.blend(1.0f, EParameterBlendNotification::Parameter, changed);
+		REQUIRE(changed.empty());
+	}
+
+	SECTION("Group notification")
+	{
+		std::vector<Parameter*> changed;
+		engine.blend(1.0f, EParameterBlendNotification::Group, changed);
+		REQUIRE(signal_count == 0);
+		REQUIRE_FALSE(changed.empty());
+		REQUIRE(number.mValue == number_target.mValue);
+	}
+}
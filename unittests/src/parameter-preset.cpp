@@ -0,0 +1,74 @@
+#include "utils/catch.hpp"
+
+#include <parameterpreset.h>
+#include <parameternumeric.h>
+#include <rtti/jsonwriter.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace nap;
+
+TEST_CASE("Parameter preset", "[parameter]")
+{
+	// root group with a parameter and a child group
+	ParameterFloat speed;
+	speed.mID = "speed";
+	speed.setRange(0.0f, 10.0f);
+	ParameterInt count;
+	count.mID = "count";
+	count.setRange(0, 100);
+	ParameterGroup child;
+	child.mID = "child";
+	child.mParameters.emplace_back(&count);
+	ParameterGroup root;
+	root.mID = "root";
+	root.mParameters.emplace_back(&speed);
+	root.mChildren.emplace_back(&child);
+
+	// write preset
+	const std::string path = "parameter_preset_test.json";
+	speed.setValue(4.0f);
+	count.setValue(42);
+	{
+		utility::ErrorState error_state;
+		rtti::JSONWriter writer;
+		REQUIRE(rtti::serializeObjects({ &root }, writer, error_state));
+		std::ofstream output(path, std::ios::binary | std::ios::out);
+		std::string json = writer.GetJSON();
+		output.write(json.data(), json.size());
+	}
+	speed.setValue(1.0f);
+	count.setValue(7);
+
+	rtti::Factory factory;
+	utility::ErrorState error_state;
+	ParameterPreset preset;
+	REQUIRE(preset.compile(root, path, factory, error_state));
+	std::remove(path.c_str());
+	REQUIRE(preset.getGroupID() == root.mID);
+	REQUIRE(preset.getGroup() == &root);
+	REQUIRE(preset.getBindings().size() == 2);
+
+	// values are bound to the parameters, not looked up
+	const Parameter* speed_value = preset.findValue(speed);
+	REQUIRE(speed_value != nullptr);
+	REQUIRE(speed_value != &speed);
+	REQUIRE(static_cast<const ParameterFloat*>(speed_value)->mValue == 4.0f);
+	REQUIRE(preset.findValue(count) != nullptr);
+
+	int changed = 0;
+	speed.valueChanged.connect([&changed](float) { changed++; });
+	preset.apply();
+	REQUIRE(speed.mValue == 4.0f);
+	REQUIRE(count.mValue == 42);
+	REQUIRE(changed == 1);
+
+	// a preset that fails to compile keeps its bindings
+	REQUIRE_FALSE(preset.compile(root, "parameter_preset_missing.json", factory, error_state));
+	REQUIRE(preset.getBindings().size() == 2);
+	REQUIRE(preset.getGroup() == &root);
+
+	preset.clear();
+	REQUIRE(preset.getGroup() == nullptr);
+}
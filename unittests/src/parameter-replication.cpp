@@ -0,0 +1,425 @@
+#include "utils/catch.hpp"
+
+#include <parameterjournal.h>
+#include <parameterreplicationformat.h>
+#include <parameterreplicationservice.h>
+#include <parameterreplicator.h>
+#include <parameternumeric.h>
+#include <parametervec.h>
+#include <parametercolor.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace nap;
+
+// Group with a nested child, as loaded by two processes
+struct ReplicatedGroup
+{
+	ReplicatedGroup(int count)
+	{
+		root.mID = "root";
+		child.mID = "child";
+		for (int i = 0; i < count; i++)
+		{
+			floats.emplace_back(std::make_unique<ParameterFloat>());
+			floats.back()->mID = "float" + std::to_string(i);
+			floats.back()->mValue = 0.0f;
+			floats.back()->setRange(-1000.0f, 1000.0f);
+			root.mParameters.emplace_back(floats.back().get());
+		}
+		color.mID = "color";
+		position.mID = "position";
+		position.mValue = { 0.0f, 0.0f, 0.0f };
+		child.mParameters.emplace_back(&color);
+		child.mParameters.emplace_back(&position);
+		root.mChildren.emplace_back(&child);
+	}
+
+	std::vector<std::unique_ptr<ParameterFloat>> floats;
+	ParameterRGBAColor8 color;
+	ParameterVec3 position;
+	ParameterGroup child;
+	ParameterGroup root;
+};
+
+
+struct LoopbackTransport;
+
+// In memory network, a packet sent by a transport is received by all other transports
+struct LoopbackNetwork
+{
+	std::vector<LoopbackTransport*> transports;
+	std::vector<ParameterPacketHeader> sent;							// Headers of all packets sent, including dropped packets
+	std::function<bool(const ParameterPacketHeader&)> drop;			// Drops packets when it returns true
+};
+
+
+struct LoopbackTransport : public Resource, public IParameterReplicationTransport
+{
+	LoopbackTransport(LoopbackNetwork& network) : mNetwork(network)		{ network.transports.emplace_back(this); }
+
+	bool sendPacket(const uint8* data, size_t length, utility::ErrorState& errorState) override
+	{
+		ParameterPacketHeader header;
+		REQUIRE(header.read(data, length));
+		mNetwork.sent.emplace_back(header);
+		if (mNetwork.drop != nullptr && mNetwork.drop(header))
+			return true;
+
+		for (auto& transport : mNetwork.transports)
+		{
+			if (transport != this)
+				transport->mQueue.push(data, length);
+		}
+		return true;
+	}
+
+	bool receivePacket(std::vector<uint8>& outPacket) override		{ return mQueue.pop(outPacket); }
+
+	LoopbackNetwork& mNetwork;
+	ParameterPacketQueue mQueue;
+};
+
+
+// Runs the replicators of both processes
+struct LoopbackService : public ParameterReplicationService
+{
+	LoopbackService() : ParameterReplicationService(nullptr)		{ }
+
+	// Receives on update and sends on post update, a single frame of all processes
+	void frame()
+	{
+		update(1.0 / 60.0);
+		postUpdate(1.0 / 60.0);
+	}
+
+	std::unique_ptr<ParameterReplicator> createReplicator(ParameterGroup& group, LoopbackTransport& transport, EParameterReplicationRole role)
+	{
+		auto replicator = std::make_unique<ParameterReplicator>(*this);
+		replicator->mID = role == EParameterReplicationRole::Sender ? "sender" : "receiver";
+		replicator->mGroup = &group;
+		replicator->mTransport = &transport;
+		replicator->mRole = role;
+		replicator->mJournalSize = 4;
+		replicator->mMaxPacketSize = 256;
+		replicator->mSnapshotInterval = 0.0f;
+		replicator->mRequestInterval = 0.0f;
+
+		utility::ErrorState error_state;
+		REQUIRE(replicator->init(error_state));
+		REQUIRE(replicator->start(error_state));
+		return replicator;
+	}
+};
+
+
+static bool isEqual(const ReplicatedGroup& a, const ReplicatedGroup& b)
+{
+	for (size_t i = 0; i < a.floats.size(); i++)
+	{
+		if (a.floats[i]->mValue != b.floats[i]->mValue)
+			return false;
+	}
+	return a.color.mValue == b.color.mValue && a.position.mValue == b.position.mValue;
+}
+
+
+static bool isSent(const LoopbackNetwork& network, size_t from, EParameterPacket kind)
+{
+	for (size_t i = from; i < network.sent.size(); i++)
+	{
+		if (network.sent[i].mKind == kind)
+			return true;
+	}
+	return false;
+}
+
+
+TEST_CASE("Parameter journal", "[parameter]")
+{
+	ParameterJournal journal;
+	journal.init(4, 8);
+
+	journal.record(1, 5);
+	journal.record(1, 2);
+	journal.record(2, 5);
+	std::vector<int> indices;
+	REQUIRE(journal.collect(0, indices));
+	REQUIRE(indices == std::vector<int>({ 2, 5 }));
+	REQUIRE(journal.collect(1, indices));
+	REQUIRE(indices == std::vector<int>({ 5 }));
+	REQUIRE(journal.collect(2, indices));
+	REQUIRE(indices.empty());
+
+	// Overwrites sequence 1, a peer at 0 needs a snapshot
+	journal.record(3, 7);
+	journal.record(4, 1);
+	REQUIRE(journal.getCount() == 4);
+	REQUIRE_FALSE(journal.collect(0, indices));
+	REQUIRE(journal.collect(1, indices));
+	REQUIRE(indices == std::vector<int>({ 1, 5, 7 }));
+
+	// Sequence numbers wrap around
+	REQUIRE(isSequenceNewer(0, 0xFFFFFFFF));
+	REQUIRE_FALSE(isSequenceNewer(0xFFFFFFFF, 0));
+}
+
+
+TEST_CASE("Parameter replication format", "[parameter]")
+{
+	const int count = 300;
+	ReplicatedGroup sender(count);
+	ReplicatedGroup receiver(count);
+
+	utility::ErrorState error_state;
+	ParameterReplicationLayout sender_layout;
+	ParameterReplicationLayout receiver_layout;
+	REQUIRE(sender_layout.init(sender.root, error_state));
+	REQUIRE(receiver_layout.init(receiver.root, error_state));
+	REQUIRE(sender_layout.getCount() == count + 2);
+	REQUIRE(sender_layout.getHash() == receiver_layout.getHash());
+
+	// Different structure, different hash
+	ReplicatedGroup other(count - 1);
+	ParameterReplicationLayout other_layout;
+	REQUIRE(other_layout.init(other.root, error_state));
+	REQUIRE(other_layout.getHash() != sender_layout.getHash());
+
+	// Only changed parameters are collected
+	std::vector<int> changed;
+	sender_layout.collectChanges(changed);
+	REQUIRE(changed.empty());
+	for (int i = 0; i < count; i += 3)
+		sender.floats[i]->setValue(static_cast<float>(i + 1));
+	sender.color.setValue(RGBAColor8(10, 20, 30, 40));
+	sender.position.setValue({ 1.0f, 2.0f, 3.0f });
+	sender_layout.collectChanges(changed);
+	REQUIRE(changed.size() == count / 3 + 2);
+	REQUIRE(changed.front() == 0);
+	REQUIRE(changed.back() == count + 1);
+
+	// Small packets force a split, every packet decodes on its own
+	ParameterPacketWriter writer;
+	writer.init(128);
+	writer.write(sender_layout, changed);
+	REQUIRE(writer.getPacketCount() > 1);
+
+	int signal_count = 0;
+	receiver.floats[3]->valueChanged.connect([&signal_count](float) { signal_count++; });
+	for (size_t i = 0; i < writer.getPacketCount(); i++)
+	{
+		ParameterPacketHeader header;
+		header.mKind = EParameterPacket::Delta;
+		header.mLayout = sender_layout.getHash();
+		header.mSequence = static_cast<uint32>(i + 1);
+		const std::vector<uint8>& packet = writer.finish(i, header);
+		REQUIRE(packet.size() <= 128);
+
+		ParameterPacketHeader received;
+		REQUIRE(received.read(packet.data(), packet.size()));
+		REQUIRE(received.mSequence == header.mSequence);
+		REQUIRE(received.mPart == i);
+		REQUIRE(received.mPartCount == writer.getPacketCount());
+		REQUIRE(receiver_layout.apply(packet.data() + ParameterPacketHeader::size, packet.size() - ParameterPacketHeader::size, received.mCount, error_state));
+	}
+
+	for (int i = 0; i < count; i++)
+		REQUIRE(receiver.floats[i]->mValue == sender.floats[i]->mValue);
+	REQUIRE(receiver.color.mValue == sender.color.mValue);
+	REQUIRE(receiver.position.mValue == sender.position.mValue);
+	REQUIRE(signal_count == 1);
+
+	// Applied values are not reported as local changes
+	receiver_layout.collectChanges(changed);
+	REQUIRE(changed.empty());
+
+	// Truncated packets are rejected without applying anything
+	std::vector<int> all = { 0, 1, 2 };
+	writer.write(sender_layout, all);
+	sender.floats[0]->setValue(500.0f);
+	const std::vector<uint8>& packet = writer.finish(0, ParameterPacketHeader());
+	REQUIRE_FALSE(receiver_layout.apply(packet.data() + ParameterPacketHeader::size, packet.size() - ParameterPacketHeader::size - 1, 3, error_state));
+	REQUIRE(receiver.floats[0]->mValue == 1.0f);
+}
+
+
+TEST_CASE("Parameter replicator", "[parameter]")
+{
+	LoopbackNetwork network;
+	LoopbackTransport sender_transport(network);
+	LoopbackTransport receiver_transport(network);
+	LoopbackService service;
+
+	// The receiver is out of date, snapshots don't fit a single packet
+	const int count = 100;
+	ReplicatedGroup sender_group(count);
+	ReplicatedGroup receiver_group(count);
+	for (int i = 0; i < count; i++)
+		sender_group.floats[i]->setValue(static_cast<float>(i));
+	sender_group.position.setValue({ 1.0f, 2.0f, 3.0f });
+
+	auto sender = service.createReplicator(sender_group.root, sender_transport, EParameterReplicationRole::Sender);
+	auto receiver = service.createReplicator(receiver_group.root, receiver_transport, EParameterReplicationRole::Receiver);
+	auto synchronize = [&]()
+	{
+		for (int i = 0; i < 10 && !(receiver->isSynchronized() && receiver->getSequence() == sender->getSequence()); i++)
+			service.frame();
+		return receiver->isSynchronized() && receiver->getSequence() == sender->getSequence();
+	};
+
+	// Late joiner asks for a snapshot
+	REQUIRE_FALSE(receiver->isSynchronized());
+	REQUIRE(synchronize());
+	REQUIRE(isEqual(sender_group, receiver_group));
+	REQUIRE(isSent(network, 0, EParameterPacket::Snapshot));
+
+	SECTION("deltas")
+	{
+		size_t sent = network.sent.size();
+		sender_group.floats[5]->setValue(50.0f);
+		sender_group.color.setValue(RGBAColor8(1, 2, 3, 4));
+		service.frame();
+		service.frame();
+		REQUIRE(receiver->isSynchronized());
+		REQUIRE(receiver->getSequence() == sender->getSequence());
+		REQUIRE(isEqual(sender_group, receiver_group));
+		REQUIRE(network.sent.size() == sent + 1);
+		REQUIRE(network.sent.back().mKind == EParameterPacket::Delta);
+	}
+
+	SECTION("lost delta is resynchronized from the journal")
+	{
+		bool dropped = false;
+		network.drop = [&dropped](const ParameterPacketHeader& header)
+		{
+			if (dropped || header.mKind != EParameterPacket::Delta)
+				return false;
+			dropped = true;
+			return true;
+		};
+		sender_group.floats[6]->setValue(60.0f);
+		service.frame();
+
+		// The next delta is applied, the gap is detected
+		size_t sent = network.sent.size();
+		sender_group.floats[7]->setValue(70.0f);
+		service.frame();
+		service.frame();
+		REQUIRE(receiver_group.floats[7]->mValue == 70.0f);
+		REQUIRE(receiver_group.floats[6]->mValue != 60.0f);
+		REQUIRE(dropped);
+		network.drop = nullptr;
+		REQUIRE_FALSE(receiver->isSynchronized());
+
+		REQUIRE(synchronize());
+		REQUIRE(isEqual(sender_group, receiver_group));
+		REQUIRE(isSent(network, sent, EParameterPacket::Resync));
+		REQUIRE_FALSE(isSent(network, sent, EParameterPacket::Snapshot));
+	}
+
+	SECTION("gap larger than the journal is resynchronized with a snapshot")
+	{
+		network.drop = [](const ParameterPacketHeader& header) { return header.mKind == EParameterPacket::Delta; };
+		for (int i = 0; i < 6; i++)
+		{
+			sender_group.floats[i]->setValue(100.0f + i);
+			service.frame();
+		}
+		network.drop = nullptr;
+
+		size_t sent = network.sent.size();
+		sender_group.floats[10]->setValue(10.5f);
+		REQUIRE(synchronize());
+		REQUIRE(isEqual(sender_group, receiver_group));
+		REQUIRE(isSent(network, sent, EParameterPacket::Snapshot));
+	}
+
+	SECTION("snapshot is only complete with all parts")
+	{
+		// A second receiver joins, the second part of its first snapshot is lost
+		ReplicatedGroup late_group(count);
+		LoopbackTransport late_transport(network);
+		bool dropped = false;
+		network.drop = [&dropped](const ParameterPacketHeader& header)
+		{
+			if (dropped || header.mKind != EParameterPacket::Snapshot || header.mPart != 1)
+				return false;
+			dropped = true;
+			return true;
+		};
+		auto late = service.createReplicator(late_group.root, late_transport, EParameterReplicationRole::Receiver);
+		service.frame();
+		service.frame();
+		REQUIRE(dropped);
+		network.drop = nullptr;
+		REQUIRE_FALSE(late->isSynchronized());
+
+		for (int i = 0; i < 10 && !late->isSynchronized(); i++)
+			service.frame();
+		REQUIRE(late->isSynchronized());
+		REQUIRE(isEqual(sender_group, late_group));
+		late->stop();
+		network.transports.pop_back();
+	}
+
+	SECTION("restarted sender starts a new session")
+	{
+		utility::ErrorState error_state;
+		sender->stop();
+		REQUIRE(sender->start(error_state));
+		REQUIRE(sender->getSequence() == 0);
+
+		// The first delta of the new session resets the receiver, which asks for a snapshot
+		sender_group.floats[8]->setValue(80.0f);
+		service.frame();
+		service.frame();
+		REQUIRE(receiver_group.floats[8]->mValue == 80.0f);
+		REQUIRE_FALSE(receiver->isSynchronized());
+		REQUIRE(synchronize());
+		REQUIRE(isEqual(sender_group, receiver_group));
+	}
+
+	sender->stop();
+	receiver->stop();
+}
+
+
+TEST_CASE("Parameter replicators share a transport", "[parameter]")
+{
+	LoopbackNetwork network;
+	LoopbackTransport sender_transport(network);
+	LoopbackTransport receiver_transport(network);
+	LoopbackService service;
+
+	// Two groups with a different layout, replicated over the same transports
+	ReplicatedGroup sender_a(10), receiver_a(10);
+	ReplicatedGroup sender_b(20), receiver_b(20);
+	auto sender_replicator_a = service.createReplicator(sender_a.root, sender_transport, EParameterReplicationRole::Sender);
+	auto sender_replicator_b = service.createReplicator(sender_b.root, sender_transport, EParameterReplicationRole::Sender);
+	auto receiver_replicator_a = service.createReplicator(receiver_a.root, receiver_transport, EParameterReplicationRole::Receiver);
+	auto receiver_replicator_b = service.createReplicator(receiver_b.root, receiver_transport, EParameterReplicationRole::Receiver);
+	REQUIRE(sender_replicator_a->getLayout().getHash() != sender_replicator_b->getLayout().getHash());
+
+	for (int i = 0; i < 10; i++)
+	{
+		sender_a.floats[i]->setValue(static_cast<float>(i));
+		sender_b.floats[i * 2]->setValue(static_cast<float>(-i));
+		service.frame();
+	}
+	service.frame();
+
+	// Every receiver got all packets of its group
+	REQUIRE(receiver_replicator_a->isSynchronized());
+	REQUIRE(receiver_replicator_b->isSynchronized());
+	REQUIRE(receiver_replicator_a->getSequence() == sender_replicator_a->getSequence());
+	REQUIRE(receiver_replicator_b->getSequence() == sender_replicator_b->getSequence());
+	REQUIRE(isEqual(sender_a, receiver_a));
+	REQUIRE(isEqual(sender_b, receiver_b));
+
+	sender_replicator_a->stop();
+	sender_replicator_b->stop();
+	receiver_replicator_a->stop();
+	receiver_replicator_b->stop();
+}
@@ -0,0 +1,179 @@
+#include "utils/catch.hpp"
+
+#include <blockcompression.h>
+#include <compressedtexture.h>
+#include <utility/fileutils.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+using namespace nap;
+
+namespace
+{
+	const EBlockFormat formats[] = { EBlockFormat::BC1, EBlockFormat::BC1A, EBlockFormat::BC3, EBlockFormat::BC4, EBlockFormat::BC5, EBlockFormat::BC7 };
+
+	// Smooth gradients with a different direction per channel
+	std::vector<uint8> createGradient(int width, int height)
+	{
+		std::vector<uint8> pixels(width * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				uint8* pixel = &pixels[(y * width + x) * 4];
+				pixel[0] = static_cast<uint8>(x * 255 / width);
+				pixel[1] = static_cast<uint8>(y * 255 / height);
+				pixel[2] = static_cast<uint8>((x + y) * 255 / (width + height));
+				pixel[3] = static_cast<uint8>(255 - x * 255 / width);
+			}
+		}
+		return pixels;
+	}
+
+	// Writes raw bytes to a file
+	void writeBinary(const std::string& path, const std::string& contents)
+	{
+		std::ofstream out(path, std::ios::binary);
+		out.write(contents.data(), contents.size());
+	}
+
+	// Overwrites a value at the given byte offset
+	template<typename T>
+	void patch(std::string& file, size_t offset, T value)
+	{
+		std::memcpy(&file[offset], &value, sizeof(T));
+	}
+
+	// Channels that are stored by a format
+	int getChannelCount(EBlockFormat format)
+	{
+		switch (format)
+		{
+		case EBlockFormat::BC4:		return 1;
+		case EBlockFormat::BC5:		return 2;
+		case EBlockFormat::BC1:
+		case EBlockFormat::BC1A:	return 3;
+		default:					return 4;
+		}
+	}
+}
+
+TEST_CASE("Block compression", "[blockcompression]")
+{
+	// Odd sizes exercise partial blocks at the edges
+	const int width = 67;
+	const int height = 35;
+	auto pixels = createGradient(width, height);
+
+	for (auto format : formats)
+	{
+		REQUIRE(bc::getCompressedSize(format, width, height) == 17 * 9 * bc::getBlockSize(format));
+
+		std::vector<uint8> blocks(bc::getCompressedSize(format, width, height));
+		bc::compress(pixels.data(), width, height, width * 4, format, blocks.data());
+
+		std::vector<uint8> decoded(width * height * 4);
+		REQUIRE(bc::decompress(blocks.data(), width, height, format, decoded.data(), width * 4));
+
+		// Smooth gradients compress with a small error
+		int channels = getChannelCount(format);
+		for (int c = 0; c < channels; c++)
+		{
+			int total_error = 0;
+			for (int i = 0; i < width * height; i++)
+				total_error += std::abs(decoded[i * 4 + c] - pixels[i * 4 + c]);
+			REQUIRE(total_error / (width * height) <= 4);
+		}
+
+		// Solid blocks are exact in every format except for 565 quantization
+		std::vector<uint8> solid(16 * 4, 200);
+		uint8 solid_block[16];
+		uint8 solid_decoded[16 * 4];
+		bc::compress(solid.data(), 4, 4, 16, format, solid_block);
+		REQUIRE(bc::decompress(solid_block, 4, 4, format, solid_decoded, 16));
+		for (int c = 0; c < channels; c++)
+			REQUIRE(std::abs(solid_decoded[c] - 200) <= 4);
+	}
+}
+
+TEST_CASE("KTX2 round trip", "[blockcompression]")
+{
+	CompressedTextureData data;
+	data.mFormat = EBlockFormat::BC7;
+	data.mColorSpace = EColorSpace::sRGB;
+	data.mWidth = 21;
+	data.mHeight = 10;
+
+	// Full mip chain: 21x10, 10x5, 5x2, 2x1, 1x1
+	for (int level = 0; level < 5; level++)
+	{
+		int width = std::max(1, 21 >> level);
+		int height = std::max(1, 10 >> level);
+		auto pixels = createGradient(width, height);
+		std::vector<uint8> blocks(bc::getCompressedSize(data.mFormat, width, height));
+		bc::compress(pixels.data(), width, height, width * 4, data.mFormat, blocks.data());
+		data.addLevel(blocks.data());
+	}
+	REQUIRE(data.mLevels.back().mWidth == 1);
+	REQUIRE(data.mLevels.back().mHeight == 1);
+
+	const std::string path = "blockcompression-roundtrip.ktx2";
+	utility::ErrorState error;
+	REQUIRE(saveKTX2(path, data, error));
+
+	CompressedTextureData loaded;
+	bool success = loadCompressedTexture(path, loaded, error);
+	utility::deleteFile(path);
+	REQUIRE(success);
+
+	REQUIRE(loaded.mFormat == data.mFormat);
+	REQUIRE(loaded.mColorSpace == data.mColorSpace);
+	REQUIRE(loaded.mWidth == data.mWidth);
+	REQUIRE(loaded.mHeight == data.mHeight);
+	REQUIRE(loaded.mLevels.size() == data.mLevels.size());
+	REQUIRE(loaded.mData == data.mData);
+
+	// Files that are not compressed are rejected
+	REQUIRE_FALSE(loadCompressedTexture("blockcompression-missing.ktx2", loaded, error));
+}
+
+TEST_CASE("KTX2 corrupt header", "[blockcompression]")
+{
+	CompressedTextureData data;
+	data.mFormat = EBlockFormat::BC1;
+	data.mColorSpace = EColorSpace::Linear;
+	data.mWidth = 8;
+	data.mHeight = 8;
+	std::vector<uint8> blocks(bc::getCompressedSize(data.mFormat, 8, 8), 0);
+	data.addLevel(blocks.data());
+
+	const std::string path = "blockcompression-corrupt.ktx2";
+	utility::ErrorState error;
+	REQUIRE(saveKTX2(path, data, error));
+
+	std::string file;
+	REQUIRE(utility::readFileToString(path, file, error));
+	CompressedTextureData loaded;
+
+	SECTION("Level count exceeds mip chain")
+	{
+		// An 8x8 image has at most 4 levels, more would shift the size out of range
+		patch<uint32>(file, 40, 40);
+		writeBinary(path, file);
+		REQUIRE_FALSE(loadCompressedTexture(path, loaded, error));
+	}
+
+	SECTION("Level offset wraps around")
+	{
+		// Offset + length overflows to a value within the file
+		patch<uint64>(file, 80, std::numeric_limits<uint64>::max() - 7);
+		writeBinary(path, file);
+		REQUIRE_FALSE(loadCompressedTexture(path, loaded, error));
+	}
+
+	utility::deleteFile(path);
+}
@@ -0,0 +1,285 @@
+#include "utils/catch.hpp"
+
+#include <pixelconversion.h>
+#include <copyimagedata.h>
+
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace nap;
+using namespace nap::pixel;
+
+namespace
+{
+	const EInstructionSet instructionSets[] = { EInstructionSet::Scalar, EInstructionSet::SSE2, EInstructionSet::SSSE3, EInstructionSet::AVX2, EInstructionSet::NEON };
+
+	const char* getName(EInstructionSet instructionSet)
+	{
+		switch (instructionSet)
+		{
+		case EInstructionSet::SSE2:		return "SSE2";
+		case EInstructionSet::SSSE3:	return "SSSE3";
+		case EInstructionSet::AVX2:		return "AVX2";
+		case EInstructionSet::NEON:		return "NEON";
+		default:						return "Scalar";
+		}
+	}
+
+	template<typename T>
+	std::vector<T> createNoise(size_t count, unsigned int seed)
+	{
+		std::mt19937 generator(seed);
+		std::vector<T> values(count);
+		for (auto& value : values)
+			value = static_cast<T>(generator());
+		return values;
+	}
+
+	std::vector<float> createFloatNoise(size_t count, unsigned int seed)
+	{
+		// Includes values outside of the 0-1 range to test clamping
+		std::mt19937 generator(seed);
+		std::uniform_real_distribution<float> distribution(-0.25f, 1.25f);
+		std::vector<float> values(count);
+		for (auto& value : values)
+			value = distribution(generator);
+		return values;
+	}
+
+	// Runs the test for every instruction set that is supported, restores the default afterwards
+	void forEachInstructionSet(const std::function<void(EInstructionSet)>& test)
+	{
+		EInstructionSet selected = getInstructionSet();
+		for (auto instructionSet : instructionSets)
+		{
+			if (setInstructionSet(instructionSet))
+				test(instructionSet);
+		}
+		setInstructionSet(selected);
+	}
+}
+
+TEST_CASE("Pixel channel conversion", "[pixelconversion]")
+{
+	// Odd counts exercise the scalar remainder of the vectorized kernels
+	for (size_t count : { 0, 1, 5, 6, 9, 10, 17, 33, 1001 })
+	{
+		auto rgb = createNoise<uint8>(count * 3, 1);
+		auto rgba = createNoise<uint8>(count * 4, 2);
+
+		forEachInstructionSet([&](EInstructionSet instructionSet)
+		{
+			Info(getName(instructionSet) << ", " << count << " pixels");
+			std::vector<uint8> with_alpha(count * 4);
+			addAlpha(rgb.data(), with_alpha.data(), count, 7);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(with_alpha[i * 4 + 0] == rgb[i * 3 + 0]);
+				REQUIRE(with_alpha[i * 4 + 1] == rgb[i * 3 + 1]);
+				REQUIRE(with_alpha[i * 4 + 2] == rgb[i * 3 + 2]);
+				REQUIRE(with_alpha[i * 4 + 3] == 7);
+			}
+
+			addAlphaSwapRB(rgb.data(), with_alpha.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(with_alpha[i * 4 + 0] == rgb[i * 3 + 2]);
+				REQUIRE(with_alpha[i * 4 + 2] == rgb[i * 3 + 0]);
+				REQUIRE(with_alpha[i * 4 + 3] == 255);
+			}
+
+			std::vector<uint8> without_alpha(count * 3);
+			removeAlpha(rgba.data(), without_alpha.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(without_alpha[i * 3 + 0] == rgba[i * 4 + 0]);
+				REQUIRE(without_alpha[i * 3 + 1] == rgba[i * 4 + 1]);
+				REQUIRE(without_alpha[i * 3 + 2] == rgba[i * 4 + 2]);
+			}
+
+			removeAlphaSwapRB(rgba.data(), without_alpha.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(without_alpha[i * 3 + 0] == rgba[i * 4 + 2]);
+				REQUIRE(without_alpha[i * 3 + 2] == rgba[i * 4 + 0]);
+			}
+
+			// In place
+			std::vector<uint8> swapped = rgba;
+			swapRB(swapped.data(), swapped.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				REQUIRE(swapped[i * 4 + 0] == rgba[i * 4 + 2]);
+				REQUIRE(swapped[i * 4 + 1] == rgba[i * 4 + 1]);
+				REQUIRE(swapped[i * 4 + 2] == rgba[i * 4 + 0]);
+				REQUIRE(swapped[i * 4 + 3] == rgba[i * 4 + 3]);
+			}
+		});
+	}
+}
+
+TEST_CASE("Pixel depth conversion", "[pixelconversion]")
+{
+	const size_t count = 1003;
+	auto bytes = createNoise<uint8>(count, 3);
+	auto shorts = createNoise<uint16>(count, 4);
+	auto floats = createFloatNoise(count, 5);
+
+	// Every instruction set must produce the exact same result as the scalar implementation
+	setInstructionSet(EInstructionSet::Scalar);
+	std::vector<uint16> bytes_to_shorts(count), floats_to_shorts(count);
+	std::vector<uint8> shorts_to_bytes(count), floats_to_bytes(count);
+	std::vector<float> bytes_to_floats(count), shorts_to_floats(count);
+	convert(bytes.data(), bytes_to_shorts.data(), count);
+	convert(shorts.data(), shorts_to_bytes.data(), count);
+	convert(bytes.data(), bytes_to_floats.data(), count);
+	convert(floats.data(), floats_to_bytes.data(), count);
+	convert(shorts.data(), shorts_to_floats.data(), count);
+	convert(floats.data(), floats_to_shorts.data(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		REQUIRE(bytes_to_shorts[i] == bytes[i] * 257);
+		REQUIRE(shorts_to_bytes[i] == static_cast<uint8>((shorts[i] + 128) / 257));
+		REQUIRE(bytes_to_floats[i] == Approx(bytes[i] / 255.0f));
+		REQUIRE(shorts_to_floats[i] == Approx(shorts[i] / 65535.0f));
+	}
+
+	forEachInstructionSet([&](EInstructionSet instructionSet)
+	{
+		Info(getName(instructionSet));
+		std::vector<uint16> result_shorts(count);
+		std::vector<uint8> result_bytes(count);
+		std::vector<float> result_floats(count);
+
+		convert(bytes.data(), result_shorts.data(), count);
+		REQUIRE(result_shorts == bytes_to_shorts);
+		convert(floats.data(), result_shorts.data(), count);
+		REQUIRE(result_shorts == floats_to_shorts);
+		convert(shorts.data(), result_bytes.data(), count);
+		REQUIRE(result_bytes == shorts_to_bytes);
+		convert(floats.data(), result_bytes.data(), count);
+		REQUIRE(result_bytes == floats_to_bytes);
+		convert(bytes.data(), result_floats.data(), count);
+		REQUIRE(result_floats == bytes_to_floats);
+		convert(shorts.data(), result_floats.data(), count);
+		REQUIRE(result_floats == shorts_to_floats);
+	});
+}
+
+TEST_CASE("YUV to RGBA conversion", "[pixelconversion]")
+{
+	// Odd width and height, the chroma planes are rounded up
+	const int width = 37;
+	const int height = 5;
+	const int uv_width = (width + 1) / 2;
+	const int uv_height = (height + 1) / 2;
+	auto y = createNoise<uint8>(width * height, 6);
+	auto u = createNoise<uint8>(uv_width * uv_height, 7);
+	auto v = createNoise<uint8>(uv_width * uv_height, 8);
+
+	setInstructionSet(EInstructionSet::Scalar);
+	std::vector<uint8> expected(width * height * 4);
+	yuv420ToRGBA(y.data(), width, u.data(), v.data(), uv_width, expected.data(), width * 4, width, height);
+
+	forEachInstructionSet([&](EInstructionSet instructionSet)
+	{
+		Info(getName(instructionSet));
+		std::vector<uint8> result(width * height * 4);
+		yuv420ToRGBA(y.data(), width, u.data(), v.data(), uv_width, result.data(), width * 4, width, height);
+		REQUIRE(result == expected);
+
+		// Limited range black and white
+		uint8 white[8] = { 235, 235, 235, 235, 235, 235, 235, 235 };
+		uint8 black[8] = { 16, 16, 16, 16, 16, 16, 16, 16 };
+		uint8 chroma[4] = { 128, 128, 128, 128 };
+		uint8 pixels[32];
+		yuv420ToRGBA(white, 8, chroma, chroma, 4, pixels, 32, 8, 1);
+		for (auto value : pixels)
+			REQUIRE(value == 255);
+		yuv420ToRGBA(black, 8, chroma, chroma, 4, pixels, 32, 8, 1);
+		for (int i = 0; i < 32; i++)
+			REQUIRE(pixels[i] == (i % 4 == 3 ? 255 : 0));
+	});
+}
+
+TEST_CASE("Image copy", "[pixelconversion]")
+{
+	const int width = 9;
+	const int height = 3;
+	const unsigned int source_pitch = width * 4;
+	const unsigned int target_pitch = width * 4;
+	auto source = createNoise<uint8>(source_pitch * height, 15);
+	std::vector<uint8> target(target_pitch * height);
+
+	// Channels are copied as they are, unless swapping is requested
+	copyImageData(source.data(), source_pitch, ESurfaceChannels::BGRA, target.data(), target_pitch, ESurfaceChannels::RGBA, width, height);
+	for (int y = 0; y < height; y++)
+		for (unsigned int x = 0; x < target_pitch; x++)
+			REQUIRE(target[y * target_pitch + x] == source[y * source_pitch + x]);
+
+	copyImageData(source.data(), source_pitch, ESurfaceChannels::BGRA, target.data(), target_pitch, ESurfaceChannels::RGBA, width, height, true);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const uint8* source_pixel = &source[y * source_pitch + x * 4];
+			const uint8* target_pixel = &target[y * target_pitch + x * 4];
+			REQUIRE(target_pixel[0] == source_pixel[2]);
+			REQUIRE(target_pixel[1] == source_pixel[1]);
+			REQUIRE(target_pixel[2] == source_pixel[0]);
+			REQUIRE(target_pixel[3] == source_pixel[3]);
+		}
+	}
+}
+
+TEST_CASE("Pixel conversion benchmark", "[.][pixelconversion][benchmark]")
+{
+	// Converts a full HD frame with every supported instruction set
+	const size_t pixels = 1920 * 1080;
+	const int iterations = 20;
+	auto rgb = createNoise<uint8>(pixels * 3, 9);
+	auto rgba = createNoise<uint8>(pixels * 4, 10);
+	auto shorts = createNoise<uint16>(pixels * 4, 11);
+	auto floats = createFloatNoise(pixels * 4, 12);
+	auto y = createNoise<uint8>(pixels, 13);
+	auto uv = createNoise<uint8>(pixels / 4, 14);
+	std::vector<uint8> target_bytes(pixels * 4);
+	std::vector<uint16> target_shorts(pixels * 4);
+	std::vector<float> target_floats(pixels * 4);
+
+	std::vector<std::pair<const char*, std::function<void()>>> conversions =
+	{
+		{ "RGB to RGBA",	[&]() { addAlpha(rgb.data(), target_bytes.data(), pixels); } },
+		{ "RGB to BGRA",	[&]() { addAlphaSwapRB(rgb.data(), target_bytes.data(), pixels); } },
+		{ "RGBA to RGB",	[&]() { removeAlpha(rgba.data(), target_bytes.data(), pixels); } },
+		{ "RGBA to BGR",	[&]() { removeAlphaSwapRB(rgba.data(), target_bytes.data(), pixels); } },
+		{ "RGBA to BGRA",	[&]() { swapRB(rgba.data(), target_bytes.data(), pixels); } },
+		{ "8 to 16 bit",	[&]() { convert(rgba.data(), target_shorts.data(), pixels * 4); } },
+		{ "16 to 8 bit",	[&]() { convert(shorts.data(), target_bytes.data(), pixels * 4); } },
+		{ "8 bit to float",	[&]() { convert(rgba.data(), target_floats.data(), pixels * 4); } },
+		{ "float to 8 bit",	[&]() { convert(floats.data(), target_bytes.data(), pixels * 4); } },
+		{ "16 bit to float",[&]() { convert(shorts.data(), target_floats.data(), pixels * 4); } },
+		{ "float to 16 bit",[&]() { convert(floats.data(), target_shorts.data(), pixels * 4); } },
+		{ "YUV420 to RGBA",	[&]() { yuv420ToRGBA(y.data(), 1920, uv.data(), uv.data(), 960, target_bytes.data(), 1920 * 4, 1920, 1080); } }
+	};
+
+	for (auto& conversion : conversions)
+	{
+		double scalar_time = 0;
+		forEachInstructionSet([&](EInstructionSet instructionSet)
+		{
+			conversion.second();
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; i++)
+				conversion.second();
+			double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+			if (instructionSet == EInstructionSet::Scalar)
+				scalar_time = time;
+
+			WARN(conversion.first << ", " << getName(instructionSet) << ": " << time << "ms per frame, " << scalar_time / time << "x scalar");
+		});
+	}
+}
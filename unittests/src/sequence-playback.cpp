@@ -0,0 +1,358 @@
+#include "utils/catch.hpp"
+
+#include <sequencetrackcurve.h>
+#include <sequencetracksegmentindex.h>
+#include <sequencecurvetable.h>
+#include <sequenceplayerclock.h>
+#include <sequencebinary.h>
+#include <sequencetrackevent.h>
+#include <sequencetracksegmentevent.h>
+#include <sequenceplayer.h>
+#include <sequenceplayercurveadapter.h>
+#include <sequenceplayercurveoutput.h>
+#include <sequenceservice.h>
+#include <parameternumeric.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace nap;
+
+namespace
+{
+	/**
+	 * Float curve track with adjacent segments of one second, every segment is an ease in / out bezier
+	 */
+	struct TestTrack
+	{
+		TestTrack(int segmentCount)
+		{
+			for (int i = 0; i < segmentCount; i++)
+			{
+				mCurves.emplace_back(std::make_unique<math::FloatFCurve>());
+				mSegments.emplace_back(std::make_unique<SequenceTrackSegmentCurveFloat>());
+				auto& segment = *mSegments.back();
+				segment.mStartTime = static_cast<double>(i);
+				segment.mDuration = 1.0;
+				segment.mCurves.emplace_back(mCurves.back().get());
+				segment.mCurveTypes.emplace_back(math::ECurveInterp::Bezier);
+				mTrack.mSegments.emplace_back(&segment);
+			}
+		}
+
+		// Reference lookup, scans all segments
+		int find(double time) const
+		{
+			for (int i = 0; i < static_cast<int>(mTrack.mSegments.size()); i++)
+			{
+				const auto& segment = mTrack.mSegments[i];
+				if (time >= segment->mStartTime && time < segment->mStartTime + segment->mDuration)
+					return i;
+			}
+			return -1;
+		}
+
+		std::vector<std::unique_ptr<math::FloatFCurve>> mCurves;
+		std::vector<std::unique_ptr<SequenceTrackSegmentCurveFloat>> mSegments;
+		SequenceTrackCurveFloat mTrack;
+	};
+}
+
+
+TEST_CASE("Sequence segment index", "[sequence]")
+{
+	const int segmentCount = 64;
+	TestTrack track(segmentCount);
+
+	SequenceTrackSegmentIndex index;
+	index.build(track.mTrack);
+	REQUIRE(index.getCount() == segmentCount);
+
+	SECTION("Forward playback")
+	{
+		for (double time = -1.0; time < segmentCount + 1.0; time += 0.001)
+		{
+			int expected = track.find(time);
+			int found = index.find(time);
+			REQUIRE((found < 0) == (expected < 0));
+			if (found >= 0)
+				REQUIRE(&index.getSegment(found) == track.mSegments[expected].get());
+		}
+	}
+
+	SECTION("Seek")
+	{
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<double> distribution(-2.0, segmentCount + 2.0);
+		for (int i = 0; i < 10000; i++)
+		{
+			double time = distribution(generator);
+			int expected = track.find(time);
+			int found = index.find(time);
+			REQUIRE((found < 0) == (expected < 0));
+			if (found >= 0)
+				REQUIRE(&index.getSegment(found) == track.mSegments[expected].get());
+		}
+	}
+
+	SECTION("Gaps and unsorted segments")
+	{
+		// Remove every other segment and reverse order
+		std::vector<ResourcePtr<SequenceTrackSegment>> segments;
+		for (int i = segmentCount - 1; i >= 0; i -= 2)
+			segments.emplace_back(track.mSegments[i].get());
+		track.mTrack.mSegments = segments;
+		index.build(track.mTrack);
+
+		for (double time = 0.0; time < segmentCount; time += 0.01)
+		{
+			int expected = track.find(time);
+			int found = index.find(time);
+			REQUIRE((found < 0) == (expected < 0));
+			if (found >= 0)
+				REQUIRE(&index.getSegment(found) == track.mTrack.mSegments[expected].get());
+		}
+	}
+
+	SECTION("Empty")
+	{
+		index.clear();
+		REQUIRE(index.find(0.5) == -1);
+	}
+}
+
+
+TEST_CASE("Sequence curve table", "[sequence]")
+{
+	TestTrack track(1);
+	auto& segment = *track.mSegments[0];
+
+	SequenceCurveTable<float> table;
+	REQUIRE(table.getState() == SequenceCurveTable<float>::EState::Empty);
+
+	SECTION("Bezier")
+	{
+		REQUIRE(table.bake(segment, 256));
+		REQUIRE(table.getState() == SequenceCurveTable<float>::EState::Baked);
+		REQUIRE(table.evaluate(0.0f) == Approx(segment.getStartValue()));
+		REQUIRE(table.evaluate(1.0f) == Approx(segment.getEndValue()));
+		REQUIRE(table.evaluate(2.0f) == Approx(segment.getEndValue()));
+		for (float pos = 0.0f; pos <= 1.0f; pos += 0.0037f)
+			REQUIRE(table.evaluate(pos) == Approx(segment.getValue(pos)).epsilon(0.001));
+	}
+
+	SECTION("Stepped")
+	{
+		track.mCurves[0]->mPoints[0].mInterp = math::ECurveInterp::Stepped;
+		REQUIRE_FALSE(table.bake(segment, 256));
+		REQUIRE(table.getState() == SequenceCurveTable<float>::EState::Unsupported);
+	}
+}
+
+
+TEST_CASE("Sequence threaded clock", "[sequence]")
+{
+	std::atomic<int> tick_count = { 0 };
+	std::atomic<double> elapsed = { 0.0 };
+	Slot<double> update_slot([&](double deltaTime)
+	{
+		elapsed = elapsed + deltaTime;
+		tick_count++;
+	});
+
+	SequencePlayerThreadedClock clock;
+	clock.mFrequency = 200.0f;
+	auto start = std::chrono::high_resolution_clock::now();
+	clock.start(update_slot);
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	clock.stop();
+	double duration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// elapsed time is measured, the sum of all ticks never exceeds the time the clock ran
+	REQUIRE(tick_count > 0);
+	REQUIRE(elapsed <= duration);
+	REQUIRE(elapsed > 0.0);
+
+	// no ticks after stop
+	int stopped_count = tick_count;
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	REQUIRE(tick_count == stopped_count);
+}
+
+
+TEST_CASE("Sequence binary format", "[sequence]")
+{
+	TestTrack track(4);
+	track.mTrack.mID = "curve_track";
+	track.mTrack.mAssignedOutputID = "curve_output";
+	track.mTrack.mMinimum = -2.0f;
+	track.mTrack.mMaximum = 2.0f;
+	for (int i = 0; i < track.mSegments.size(); i++)
+	{
+		track.mSegments[i]->mID = "segment_" + std::to_string(i);
+		track.mCurves[i]->mID = "curve_" + std::to_string(i);
+		track.mCurves[i]->mPoints[1].mPos.mValue = static_cast<float>(i) * 0.25f;
+	}
+
+	SequenceTrackSegmentEventString event;
+	event.mID = "event";
+	event.mStartTime = 1.5;
+	event.mValue = "hello";
+	SequenceTrackEvent event_track;
+	event_track.mID = "event_track";
+	event_track.mSegments.emplace_back(&event);
+
+	Sequence sequence;
+	sequence.mID = "sequence";
+	sequence.mDuration = 4.0;
+	sequence.mTracks.emplace_back(&track.mTrack);
+	sequence.mTracks.emplace_back(&event_track);
+
+	SECTION("Round trip")
+	{
+		const std::string path = "sequence_binary_test.bseq";
+		utility::ErrorState error_state;
+		REQUIRE(sequencebinary::save(sequence, path, error_state));
+		REQUIRE(sequencebinary::isBinary(path));
+
+		std::vector<std::unique_ptr<rtti::Object>> objects;
+		Sequence* loaded = sequencebinary::load(path, objects, error_state);
+		std::remove(path.c_str());
+		REQUIRE(loaded != nullptr);
+		REQUIRE(loaded->mID == sequence.mID);
+		REQUIRE(loaded->mDuration == sequence.mDuration);
+		REQUIRE(loaded->mTracks.size() == 2);
+
+		REQUIRE(loaded->mTracks[0]->get_type() == RTTI_OF(SequenceTrackCurveFloat));
+		const auto& curve_track = static_cast<const SequenceTrackCurveFloat&>(*loaded->mTracks[0]);
+		REQUIRE(curve_track.mID == track.mTrack.mID);
+		REQUIRE(curve_track.mAssignedOutputID == track.mTrack.mAssignedOutputID);
+		REQUIRE(curve_track.mMinimum == track.mTrack.mMinimum);
+		REQUIRE(curve_track.mMaximum == track.mTrack.mMaximum);
+		REQUIRE(curve_track.mSegments.size() == track.mSegments.size());
+		for (int i = 0; i < track.mSegments.size(); i++)
+		{
+			const auto& segment = static_cast<const SequenceTrackSegmentCurveFloat&>(*curve_track.mSegments[i]);
+			REQUIRE(segment.mID == track.mSegments[i]->mID);
+			REQUIRE(segment.mStartTime == track.mSegments[i]->mStartTime);
+			REQUIRE(segment.mCurves[0]->mID == track.mCurves[i]->mID);
+			for (float pos = 0.0f; pos <= 1.0f; pos += 0.1f)
+				REQUIRE(segment.getValue(pos) == track.mSegments[i]->getValue(pos));
+		}
+
+		REQUIRE(loaded->mTracks[1]->get_type() == RTTI_OF(SequenceTrackEvent));
+		REQUIRE(loaded->mTracks[1]->mSegments.size() == 1);
+		const auto& loaded_event = static_cast<const SequenceTrackSegmentEventString&>(*loaded->mTracks[1]->mSegments[0]);
+		REQUIRE(loaded_event.mValue == event.mValue);
+		REQUIRE(loaded_event.mStartTime == event.mStartTime);
+	}
+
+	SECTION("Bake")
+	{
+		const std::string path = "sequence_binary_test.bake";
+		utility::ErrorState error_state;
+		REQUIRE(sequencebinary::bake(sequence, 100.0f, path, error_state));
+
+		// unmapped before the file is removed
+		auto baked_ptr = std::make_unique<sequencebinary::BakedSequence>();
+		auto& baked = *baked_ptr;
+		REQUIRE(baked.open(path, error_state));
+		REQUIRE(baked.getTrackCount() == 1);
+		int index = baked.findTrack(track.mTrack.mID);
+		REQUIRE(index == 0);
+		REQUIRE(baked.getAssignedOutputID(index) == track.mTrack.mAssignedOutputID);
+		REQUIRE(baked.getChannelCount(index) == 1);
+
+		// samples match the curves, in between samples is a linear approximation
+		for (int s = 0; s < 400; s++)
+		{
+			double time = static_cast<double>(s) / 100.0;
+			const auto& segment = *track.mSegments[s / 100];
+			float expected = segment.getValue(static_cast<float>(time - segment.mStartTime)) * 4.0f - 2.0f;
+			float value = 0.0f;
+			baked.evaluate(index, time, &value);
+			REQUIRE(value == Approx(expected).margin(0.0001));
+		}
+		baked_ptr.reset();
+		std::remove(path.c_str());
+	}
+}
+
+
+TEST_CASE("Sequence playback benchmark", "[.][sequence][benchmark]")
+{
+	using Clock = std::chrono::high_resolution_clock;
+
+	// Cost of a single player tick: every curve adapter finds its segment and sets its parameter.
+	// Time advances at 1000 Hz, the rate of the player thread
+	const int tickCount = 1000;
+	const int trackCounts[] = { 10, 100 };
+	const int segmentCounts[] = { 10, 100, 1000 };
+
+	SequenceService service(nullptr);
+	SequencePlayer player(service);
+	ParameterFloat parameter;
+	for (int track_count : trackCounts)
+	{
+		for (int segment_count : segmentCounts)
+		{
+			TestTrack track(segment_count);
+
+			// Adapters set the parameter from the player thread, with and without baked curves
+			auto create_adapters = [&](SequencePlayerCurveOutput& output, bool bake)
+			{
+				output.mParameter = &parameter;
+				output.mUseMainThread = false;
+				output.mBakeCurves = bake;
+				std::vector<std::unique_ptr<SequencePlayerAdapter>> adapters;
+				for (int i = 0; i < track_count; i++)
+					adapters.emplace_back(SequencePlayerAdapter::invokeFactory(RTTI_OF(SequenceTrackCurveFloat), track.mTrack, output, player));
+				return adapters;
+			};
+			SequencePlayerCurveOutput output(service);
+			SequencePlayerCurveOutput baked_output(service);
+			auto adapters = create_adapters(output, false);
+			auto baked_adapters = create_adapters(baked_output, true);
+
+			// Start in the last segment, worst case for a scan
+			double start_time = segment_count - 1.0;
+			auto tick_adapters = [&](std::vector<std::unique_ptr<SequencePlayerAdapter>>& tickAdapters)
+			{
+				auto start = Clock::now();
+				for (int tick = 0; tick < tickCount; tick++)
+				{
+					double time = start_time + tick * 0.001;
+					for (auto& adapter : tickAdapters)
+						adapter->tick(time);
+				}
+				return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / tickCount;
+			};
+
+			// Reference: scan all segments and evaluate the curve
+			float sum = 0.0f;
+			auto start = Clock::now();
+			for (int tick = 0; tick < tickCount; tick++)
+			{
+				double time = start_time + tick * 0.001;
+				for (int i = 0; i < track_count; i++)
+				{
+					int found = track.find(time);
+					const auto& segment = *track.mSegments[found];
+					sum += segment.getValue(static_cast<float>(time - segment.mStartTime));
+				}
+			}
+			auto scan_time = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / tickCount;
+			auto index_time = tick_adapters(adapters);
+			auto baked_time = tick_adapters(baked_adapters);
+
+			REQUIRE(sum > 0.0f);
+			WARN("Sequence playback: " << track_count << " tracks, " << segment_count << " segments: "
+				<< scan_time << " us per tick scanned, " << index_time << " us per tick indexed, " << baked_time << " us per tick indexed and baked");
+		}
+	}
+}
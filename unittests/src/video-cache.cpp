@@ -0,0 +1,143 @@
+#include "utils/catch.hpp"
+
+#include <videokeyframeindex.h>
+#include <videoframecache.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace nap;
+
+namespace
+{
+	VideoFrameCache::FramePtr createFrame(double seconds, double duration, size_t size)
+	{
+		auto frame = std::make_shared<CachedVideoFrame>();
+		frame->mPTSSecs = seconds;
+		frame->mDurationSecs = duration;
+		frame->mData.resize(size);
+		return frame;
+	}
+
+	// GOP of 'count' frames of 1 second and 100 bytes, starting at 'seconds'
+	std::vector<VideoFrameCache::FramePtr> createGOP(double seconds, int count)
+	{
+		std::vector<VideoFrameCache::FramePtr> frames;
+		for (int i = 0; i < count; i++)
+			frames.emplace_back(createFrame(seconds + i, 1.0, 100));
+		return frames;
+	}
+}
+
+
+TEST_CASE("Video keyframe index", "[video]")
+{
+	// Keyframes are sorted on construction
+	VideoKeyframeIndex index({ { 200, 190 }, { 0, -10 }, { 100, 90 } });
+	REQUIRE(index.getCount() == 3);
+	REQUIRE(index.getKeyframe(0).mPTS == 0);
+	REQUIRE(index.getKeyframe(1).mDTS == 90);
+
+	SECTION("find")
+	{
+		REQUIRE(index.find(-5) == 0);
+		REQUIRE(index.find(0) == 0);
+		REQUIRE(index.find(99) == 0);
+		REQUIRE(index.find(100) == 1);
+		REQUIRE(index.find(150) == 1);
+		REQUIRE(index.find(1000) == 2);
+		REQUIRE(VideoKeyframeIndex().find(10) == 0);
+	}
+
+	SECTION("cache")
+	{
+		const std::string video_path = "video_keyframe_index_test.mp4";
+		const std::string cache_path = VideoKeyframeIndex::getCachePath(video_path);
+		{
+			std::ofstream video(video_path, std::ios::binary | std::ios::out);
+			video << "not a video";
+		}
+
+		// Nothing to load without the video or the cache file
+		VideoKeyframeIndex loaded;
+		REQUIRE_FALSE(loaded.loadCache("video_keyframe_index_missing.mp4", 0));
+		REQUIRE_FALSE(loaded.loadCache(video_path, 0));
+		REQUIRE(index.saveCache(video_path, 0));
+
+		// The cache belongs to a single stream
+		REQUIRE_FALSE(loaded.loadCache(video_path, 1));
+		REQUIRE(loaded.isEmpty());
+		REQUIRE(loaded.loadCache(video_path, 0));
+		REQUIRE(loaded.getCount() == index.getCount());
+		for (int i = 0; i < index.getCount(); i++)
+		{
+			REQUIRE(loaded.getKeyframe(i).mPTS == index.getKeyframe(i).mPTS);
+			REQUIRE(loaded.getKeyframe(i).mDTS == index.getKeyframe(i).mDTS);
+		}
+
+		// A truncated cache file is rejected
+		{
+			std::ofstream cache(cache_path, std::ios::binary | std::ios::out | std::ios::trunc);
+			cache << "NAPKFIDX";
+		}
+		VideoKeyframeIndex truncated;
+		REQUIRE_FALSE(truncated.loadCache(video_path, 0));
+
+		std::remove(cache_path.c_str());
+		std::remove(video_path.c_str());
+	}
+}
+
+
+TEST_CASE("Video frame cache", "[video]")
+{
+	// Room for two GOPs of 4 frames
+	VideoFrameCache cache(800);
+	cache.insert(0, createGOP(0.0, 4));
+	cache.insert(1, createGOP(4.0, 4));
+	REQUIRE(cache.getSize() == 800);
+	REQUIRE(cache.contains(0));
+	REQUIRE(cache.contains(1));
+
+	SECTION("find")
+	{
+		REQUIRE(cache.find(-1.0) == nullptr);
+		REQUIRE(cache.find(0.0)->mPTSSecs == 0.0);
+		REQUIRE(cache.find(2.5)->mPTSSecs == 2.0);
+		REQUIRE(cache.find(7.9)->mPTSSecs == 7.0);
+		REQUIRE(cache.find(8.0) == nullptr);
+	}
+
+	SECTION("least recently used GOP is evicted")
+	{
+		// Looking up a frame of the first GOP makes the second one the least recently used
+		REQUIRE(cache.find(1.0) != nullptr);
+		cache.insert(2, createGOP(8.0, 4));
+		REQUIRE(cache.contains(0));
+		REQUIRE_FALSE(cache.contains(1));
+		REQUIRE(cache.contains(2));
+		REQUIRE(cache.find(5.0) == nullptr);
+		REQUIRE(cache.getSize() == 800);
+	}
+
+	SECTION("GOPs are replaced")
+	{
+		cache.insert(1, createGOP(4.0, 2));
+		REQUIRE(cache.getSize() == 600);
+		REQUIRE(cache.find(5.5) != nullptr);
+		REQUIRE(cache.find(6.5) == nullptr);
+	}
+
+	SECTION("GOPs larger than the capacity are inserted")
+	{
+		cache.insert(2, createGOP(8.0, 10));
+		REQUIRE_FALSE(cache.contains(0));
+		REQUIRE_FALSE(cache.contains(1));
+		REQUIRE(cache.contains(2));
+		REQUIRE(cache.getSize() == 1000);
+
+		cache.clear();
+		REQUIRE(cache.getSize() == 0);
+		REQUIRE(cache.find(8.0) == nullptr);
+	}
+}
@@ -0,0 +1,181 @@
+#include "utils/catch.hpp"
+
+#include <videoencoder.h>
+#include <utility/errorstate.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C"
+{
+	#include <libavcodec/avcodec.h>
+	#include <libavformat/avformat.h>
+}
+
+using namespace nap;
+
+namespace
+{
+	const int width = 64;
+	const int height = 48;
+	const int frameRate = 25;
+
+	// RGBA8 frame with a different gradient for every frame index
+	std::vector<uint8> createFrame(int64 index)
+	{
+		std::vector<uint8> pixels(width * height * 4);
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				uint8* pixel = &pixels[(y * width + x) * 4];
+				pixel[0] = static_cast<uint8>(x * 4 + index * 16);
+				pixel[1] = static_cast<uint8>(y * 5 + index * 8);
+				pixel[2] = static_cast<uint8>(x + y + index * 32);
+				pixel[3] = 255;
+			}
+		}
+		return pixels;
+	}
+
+	// Encodes the frames with the given indices, lossless and deterministic
+	void encode(const std::string& path, const std::vector<int64>& indices)
+	{
+		VideoEncoder encoder(width, height, static_cast<int>(indices.size()), true);
+		utility::ErrorState error_state;
+		REQUIRE(encoder.init(path, EVideoEncoderCodec::FFV1, frameRate, 0, true, error_state));
+		for (int64 index : indices)
+		{
+			std::vector<uint8> frame = createFrame(index);
+			REQUIRE(encoder.submit(frame.data(), frame.size(), index));
+		}
+		encoder.finish();
+
+		VideoEncoderStats stats = encoder.getStats();
+		REQUIRE_FALSE(encoder.hasErrorOccurred());
+		REQUIRE(stats.mSubmitted == indices.size());
+		REQUIRE(stats.mEncoded == indices.size());
+		REQUIRE(stats.mDropped == 0);
+		REQUIRE(stats.mQueued == 0);
+	}
+
+	// Decodes all frames of the file, returns the frame index of every frame and if its pixels match the frame that was encoded
+	void decode(const std::string& path, std::vector<int64>& outIndices, std::vector<bool>& outMatches)
+	{
+		AVFormatContext* format_context = nullptr;
+		REQUIRE(avformat_open_input(&format_context, path.c_str(), nullptr, nullptr) == 0);
+		REQUIRE(avformat_find_stream_info(format_context, nullptr) >= 0);
+		int stream = av_find_best_stream(format_context, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+		REQUIRE(stream >= 0);
+		AVStream* video_stream = format_context->streams[stream];
+
+		AVCodec* codec = avcodec_find_decoder(video_stream->codecpar->codec_id);
+		REQUIRE(codec != nullptr);
+		AVCodecContext* codec_context = avcodec_alloc_context3(codec);
+		REQUIRE(avcodec_parameters_to_context(codec_context, video_stream->codecpar) >= 0);
+		codec_context->thread_count = 1;
+		REQUIRE(avcodec_open2(codec_context, codec, nullptr) == 0);
+
+		AVPacket* packet = av_packet_alloc();
+		AVFrame* frame = av_frame_alloc();
+		auto receive = [&]()
+		{
+			while (avcodec_receive_frame(codec_context, frame) >= 0)
+			{
+				double seconds = frame->best_effort_timestamp * av_q2d(video_stream->time_base);
+				int64 index = static_cast<int64>(std::round(seconds * frameRate));
+				outIndices.emplace_back(index);
+
+				// The lossless codec stores native 0RGB words
+				bool match = frame->format == AV_PIX_FMT_0RGB32 && frame->width == width && frame->height == height;
+				std::vector<uint8> expected = createFrame(index);
+				for (int y = 0; y < height && match; y++)
+				{
+					const uint32* row = reinterpret_cast<const uint32*>(frame->data[0] + y * frame->linesize[0]);
+					for (int x = 0; x < width && match; x++)
+					{
+						const uint8* pixel = &expected[(y * width + x) * 4];
+						uint32 rgb = (static_cast<uint32>(pixel[0]) << 16) | (static_cast<uint32>(pixel[1]) << 8) | pixel[2];
+						match = (row[x] & 0xFFFFFF) == rgb;
+					}
+				}
+				outMatches.push_back(match);
+				av_frame_unref(frame);
+			}
+		};
+
+		while (av_read_frame(format_context, packet) >= 0)
+		{
+			if (packet->stream_index == stream)
+				avcodec_send_packet(codec_context, packet);
+			av_packet_unref(packet);
+			receive();
+		}
+		avcodec_send_packet(codec_context, nullptr);
+		receive();
+
+		av_frame_free(&frame);
+		av_packet_free(&packet);
+		avcodec_free_context(&codec_context);
+		avformat_close_input(&format_context);
+	}
+
+	std::vector<char> readFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+}
+
+
+TEST_CASE("Video encoder round trip", "[video]")
+{
+	// Normally done by the video service on init
+	av_register_all();
+	avcodec_register_all();
+
+	const std::string path = "video_encoder_test.mkv";
+
+	SECTION("frames are decoded unchanged")
+	{
+		std::vector<int64> encoded = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		encode(path, encoded);
+
+		std::vector<int64> decoded;
+		std::vector<bool> matches;
+		decode(path, decoded, matches);
+		REQUIRE(decoded == encoded);
+		for (bool match : matches)
+			REQUIRE(match);
+	}
+
+	SECTION("frame indices are timestamps")
+	{
+		// A frame that is dropped while recording leaves a gap
+		std::vector<int64> encoded = { 0, 1, 2, 5, 6 };
+		encode(path, encoded);
+
+		std::vector<int64> decoded;
+		std::vector<bool> matches;
+		decode(path, decoded, matches);
+		REQUIRE(decoded == encoded);
+		for (bool match : matches)
+			REQUIRE(match);
+	}
+
+	SECTION("deterministic encoding")
+	{
+		std::vector<int64> encoded = { 0, 1, 2, 3 };
+		encode(path, encoded);
+		std::vector<char> first = readFile(path);
+		encode(path, encoded);
+		std::vector<char> second = readFile(path);
+		REQUIRE_FALSE(first.empty());
+		REQUIRE(first == second);
+	}
+
+	std::remove(path.c_str());
+}
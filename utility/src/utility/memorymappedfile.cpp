@@ -0,0 +1,124 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "memorymappedfile.h"
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace nap
+{
+	namespace utility
+	{
+		MemoryMappedFile::~MemoryMappedFile()
+		{
+			close();
+		}
+
+
+#ifdef _WIN32
+		bool MemoryMappedFile::open(const std::string& path, ErrorState& errorState)
+		{
+			close();
+
+			HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (!errorState.check(file != INVALID_HANDLE_VALUE, "Unable to open %s", path.c_str()))
+				return false;
+			mFileHandle = file;
+
+			LARGE_INTEGER size;
+			if (!errorState.check(GetFileSizeEx(file, &size) != 0, "Unable to get size of %s", path.c_str()))
+			{
+				close();
+				return false;
+			}
+			mSize = static_cast<size_t>(size.QuadPart);
+
+			// Empty files can't be mapped
+			if (mSize == 0)
+				return true;
+
+			mMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!errorState.check(mMappingHandle != nullptr, "Unable to map %s", path.c_str()))
+			{
+				close();
+				return false;
+			}
+
+			mData = static_cast<const uint8_t*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+			if (!errorState.check(mData != nullptr, "Unable to map %s", path.c_str()))
+			{
+				close();
+				return false;
+			}
+			return true;
+		}
+
+
+		void MemoryMappedFile::close()
+		{
+			if (mData != nullptr)
+				UnmapViewOfFile(mData);
+			if (mMappingHandle != nullptr)
+				CloseHandle(mMappingHandle);
+			if (mFileHandle != nullptr)
+				CloseHandle(mFileHandle);
+
+			mData = nullptr;
+			mSize = 0;
+			mMappingHandle = nullptr;
+			mFileHandle = nullptr;
+		}
+#else
+		bool MemoryMappedFile::open(const std::string& path, ErrorState& errorState)
+		{
+			close();
+
+			int file = ::open(path.c_str(), O_RDONLY);
+			if (!errorState.check(file >= 0, "Unable to open %s", path.c_str()))
+				return false;
+
+			struct stat info;
+			if (!errorState.check(fstat(file, &info) == 0, "Unable to get size of %s", path.c_str()))
+			{
+				::close(file);
+				return false;
+			}
+
+			// Empty files can't be mapped
+			if (info.st_size == 0)
+			{
+				::close(file);
+				return true;
+			}
+
+			// The mapping stays valid after the file is closed
+			void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			::close(file);
+			if (!errorState.check(data != MAP_FAILED, "Unable to map %s", path.c_str()))
+				return false;
+
+			mData = static_cast<const uint8_t*>(data);
+			mSize = static_cast<size_t>(info.st_size);
+			return true;
+		}
+
+
+		void MemoryMappedFile::close()
+		{
+			if (mData != nullptr)
+				munmap(const_cast<uint8_t*>(mData), mSize);
+
+			mData = nullptr;
+			mSize = 0;
+		}
+#endif
+	}
+}
@@ -0,0 +1,63 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// Local Includes
+#include "errorstate.h"
+
+// External Includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nap
+{
+	namespace utility
+	{
+		/**
+		 * Maps a file read-only into memory. Pages are loaded by the operating system when accessed,
+		 * opening a large file is instant and only the parts that are read occupy memory.
+		 * The mapping is released when the object is destroyed or close() is called.
+		 */
+		class MemoryMappedFile final
+		{
+		public:
+			MemoryMappedFile() = default;
+			~MemoryMappedFile();
+
+			MemoryMappedFile(const MemoryMappedFile&) = delete;
+			MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+			/**
+			 * Maps the file at the given path, closes the currently mapped file
+			 * @param path path to the file
+			 * @param errorState contains the error if the file can't be mapped
+			 * @return if the file is mapped
+			 */
+			bool open(const std::string& path, ErrorState& errorState);
+
+			/**
+			 * Releases the mapping
+			 */
+			void close();
+
+			/**
+			 * @return start of the mapped file, nullptr when no file is mapped
+			 */
+			const uint8_t* getData() const				{ return mData; }
+
+			/**
+			 * @return size of the mapped file in bytes
+			 */
+			size_t getSize() const						{ return mSize; }
+
+		private:
+			const uint8_t*	mData = nullptr;
+			size_t			mSize = 0;
+			void*			mFileHandle = nullptr;		///< Windows only: file handle
+			void*			mMappingHandle = nullptr;	///< Windows only: file mapping handle
+		};
+	}
+}
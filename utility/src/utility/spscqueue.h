@@ -0,0 +1,143 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace nap
+{
+	namespace utility
+	{
+		/**
+		 * Bounded, lock-free single producer single consumer queue.
+		 * All storage is allocated on construction: enqueueing and dequeueing never allocate and never block.
+		 * Exactly one thread is allowed to enqueue and exactly one (other) thread is allowed to dequeue at any time.
+		 * This makes the queue suitable to hand over data to and from realtime threads, for example the audio thread.
+		 * The capacity is rounded up to the next power of two.
+		 */
+		template<typename T>
+		class SPSCQueue final
+		{
+		public:
+			/**
+			 * @param capacity the minimum number of items that can be held by the queue at the same time.
+			 */
+			SPSCQueue(std::size_t capacity)
+			{
+				std::size_t size = 2;
+				while (size < capacity + 1)
+					size <<= 1;
+				mItems.resize(size);
+				mMask = size - 1;
+			}
+
+			SPSCQueue(const SPSCQueue&) = delete;
+			SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+			/**
+			 * Copies an item to the back of the queue. Call from the producer thread only.
+			 * @param item the item to enqueue
+			 * @return false if the queue is full, in which case the item is not enqueued.
+			 */
+			bool tryEnqueue(const T& item)
+			{
+				auto tail = mTail.load(std::memory_order_relaxed);
+				auto next = (tail + 1) & mMask;
+				if (next == mHead.load(std::memory_order_acquire))
+					return false;
+				mItems[tail] = item;
+				mTail.store(next, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * Moves an item to the back of the queue. Call from the producer thread only.
+			 * @param item the item to enqueue
+			 * @return false if the queue is full, in which case the item is left untouched.
+			 */
+			bool tryEnqueue(T&& item)
+			{
+				auto tail = mTail.load(std::memory_order_relaxed);
+				auto next = (tail + 1) & mMask;
+				if (next == mHead.load(std::memory_order_acquire))
+					return false;
+				mItems[tail] = std::move(item);
+				mTail.store(next, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * Moves the item at the front of the queue into the given item. Call from the consumer thread only.
+			 * @param item receives the dequeued item
+			 * @return false if the queue is empty
+			 */
+			bool tryDequeue(T& item)
+			{
+				auto head = mHead.load(std::memory_order_relaxed);
+				if (head == mTail.load(std::memory_order_acquire))
+					return false;
+				item = std::move(mItems[head]);
+				mHead.store((head + 1) & mMask, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * @return pointer to the item at the front of the queue without dequeuing it, nullptr if the queue is empty.
+			 * Call from the consumer thread only.
+			 */
+			T* peek()
+			{
+				auto head = mHead.load(std::memory_order_relaxed);
+				if (head == mTail.load(std::memory_order_acquire))
+					return nullptr;
+				return &mItems[head];
+			}
+
+			/**
+			 * Removes the item at the front of the queue, use after peek(). Call from the consumer thread only.
+			 * @return false if the queue is empty
+			 */
+			bool pop()
+			{
+				auto head = mHead.load(std::memory_order_relaxed);
+				if (head == mTail.load(std::memory_order_acquire))
+					return false;
+				mHead.store((head + 1) & mMask, std::memory_order_release);
+				return true;
+			}
+
+			/**
+			 * @return the number of items in the queue. Only an approximation when called while the other thread is active.
+			 */
+			std::size_t getSize() const
+			{
+				auto head = mHead.load(std::memory_order_acquire);
+				auto tail = mTail.load(std::memory_order_acquire);
+				return (tail - head) & mMask;
+			}
+
+			/**
+			 * @return if the queue is empty. Only an approximation when called while the other thread is active.
+			 */
+			bool isEmpty() const											{ return getSize() == 0; }
+
+			/**
+			 * @return the maximum number of items the queue can hold.
+			 */
+			std::size_t getCapacity() const									{ return mMask; }
+
+		private:
+			std::vector<T> mItems;											///< Preallocated ring of items
+			std::size_t mMask = 0;											///< Ring size - 1, used to wrap indices
+			std::atomic<std::size_t> mHead = { 0 };							///< Index of the next item to dequeue, written by the consumer
+			char mPadding[64];												///< Keeps head and tail on separate cache lines
+			std::atomic<std::size_t> mTail = { 0 };							///< Index of the next free slot, written by the producer
+		};
+	}
+}
@@ -0,0 +1,83 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+// External Includes
+#include <atomic>
+
+namespace nap
+{
+	namespace utility
+	{
+		/**
+		 * Lock-free triple buffer to publish the latest version of a value from one writer thread to one reader thread.
+		 * The writer fills the back buffer and publishes it, the reader acquires the most recently published buffer.
+		 * Neither side ever blocks or allocates, intermediate versions are dropped when the writer is faster than the reader.
+		 * Useful to hand over snapshots of state from a realtime thread to the main thread or vice versa.
+		 * Exactly one thread is allowed to write and exactly one (other) thread is allowed to read at any time.
+		 */
+		template<typename T>
+		class TripleBuffer final
+		{
+		public:
+			TripleBuffer() = default;
+
+			/**
+			 * Initializes all three buffers with the same value, for example to preallocate storage.
+			 * @param value initial value of all buffers
+			 */
+			TripleBuffer(const T& value)
+			{
+				for (auto& buffer : mBuffers)
+					buffer = value;
+			}
+
+			TripleBuffer(const TripleBuffer&) = delete;
+			TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+			/**
+			 * @return the buffer to write the next version into. Call from the writer thread only.
+			 */
+			T& getWriteBuffer()												{ return mBuffers[mWrite]; }
+
+			/**
+			 * Publishes the write buffer, making it available to the reader. Call from the writer thread only.
+			 * After publishing, getWriteBuffer() returns a different buffer that contains an older version.
+			 */
+			void publish()
+			{
+				mWrite = mMiddle.exchange(mWrite | dirtyFlag, std::memory_order_acq_rel) & indexMask;
+			}
+
+			/**
+			 * Acquires the most recently published buffer, if a new one has been published since the last call.
+			 * Call from the reader thread only.
+			 * @return true if a new version has been acquired
+			 */
+			bool update()
+			{
+				if ((mMiddle.load(std::memory_order_relaxed) & dirtyFlag) == 0)
+					return false;
+				mRead = mMiddle.exchange(mRead, std::memory_order_acq_rel) & indexMask;
+				return true;
+			}
+
+			/**
+			 * @return the buffer that was acquired by the last call to update(). Call from the reader thread only.
+			 */
+			const T& getReadBuffer() const									{ return mBuffers[mRead]; }
+
+		private:
+			static constexpr int dirtyFlag = 4;
+			static constexpr int indexMask = 3;
+
+			T mBuffers[3];
+			int mWrite = 0;													///< Index of the buffer owned by the writer
+			char mPadding[64];												///< Keeps writer and reader state on separate cache lines
+			std::atomic<int> mMiddle = { 1 };								///< Index of the buffer in flight, with the dirty flag set when it holds an unread version
+			int mRead = 2;													///< Index of the buffer owned by the reader
+		};
+	}
+}